@@ -64,7 +64,9 @@
 #include <stdio.h>
 #endif
 #include <math.h>
+#include <string.h>
 #include "fsl_debug_console.h"
+#include "myFormat.h"
 
 #if (defined(FSL_FEATURE_SOC_UART_COUNT) && (FSL_FEATURE_SOC_UART_COUNT > 0)) || \
     (defined(FSL_FEATURE_SOC_IUART_COUNT) && (FSL_FEATURE_SOC_IUART_COUNT > 0))
@@ -73,6 +75,9 @@
 
 #if defined(FSL_FEATURE_SOC_LPSCI_COUNT) && (FSL_FEATURE_SOC_LPSCI_COUNT > 0)
 #include "fsl_lpsci.h"
+#if DEBUG_CONSOLE_ASYNC
+#include "myConsole.h"
+#endif /* DEBUG_CONSOLE_ASYNC */
 #endif /* FSL_FEATURE_SOC_LPSCI_COUNT */
 
 #if defined(FSL_FEATURE_SOC_LPUART_COUNT) && (FSL_FEATURE_SOC_LPUART_COUNT > 0)
@@ -219,8 +224,10 @@ static debug_console_state_t s_debugConsole = {.type = DEBUG_CONSOLE_DEVICE_TYPE
 #if SDK_DEBUGCONSOLE
 static int DbgConsole_PrintfFormattedData(PUTCHAR_FUNC func_ptr, const char *fmt, va_list ap);
 static int DbgConsole_ScanfFormattedData(const char *line_ptr, char *format, va_list args_ptr);
-double modf(double input_dbl, double *intpart_ptr);
 #endif /* SDK_DEBUGCONSOLE */
+#if defined(FSL_FEATURE_SOC_LPSCI_COUNT) && (FSL_FEATURE_SOC_LPSCI_COUNT > 0) && DEBUG_CONSOLE_ASYNC
+static void DbgConsole_AsyncPutChar(UART0_Type *base, const uint8_t *buffer, size_t length);
+#endif /* DEBUG_CONSOLE_ASYNC */
 
 /*******************************************************************************
  * Code
@@ -228,6 +235,15 @@ double modf(double input_dbl, double *intpart_ptr);
 
 /*************Code for DbgConsole Init, Deinit, Printf, Scanf *******************************/
 
+#if defined(FSL_FEATURE_SOC_LPSCI_COUNT) && (FSL_FEATURE_SOC_LPSCI_COUNT > 0) && DEBUG_CONSOLE_ASYNC
+/* Queues the characters through myConsole, whose interrupt sends them to the LPSCI. */
+static void DbgConsole_AsyncPutChar(UART0_Type *base, const uint8_t *buffer, size_t length)
+{
+    (void)base;
+    (void)myConsole_Write(buffer, length);
+}
+#endif /* DEBUG_CONSOLE_ASYNC */
+
 /* See fsl_debug_console.h for documentation of this function. */
 status_t DbgConsole_Init(uint32_t baseAddr, uint32_t baudRate, uint8_t device, uint32_t clkSrcFreq)
 {
@@ -273,7 +289,11 @@ status_t DbgConsole_Init(uint32_t baseAddr, uint32_t baudRate, uint8_t device, u
             LPSCI_EnableTx(s_debugConsole.base, true);
             LPSCI_EnableRx(s_debugConsole.base, true);
             /* Set the function pointer for send and receive for this kind of device. */
+#if DEBUG_CONSOLE_ASYNC
+            s_debugConsole.ops.tx_union.LPSCI_PutChar = DbgConsole_AsyncPutChar;
+#else
             s_debugConsole.ops.tx_union.LPSCI_PutChar = LPSCI_WriteBlocking;
+#endif /* DEBUG_CONSOLE_ASYNC */
             s_debugConsole.ops.rx_union.LPSCI_GetChar = LPSCI_ReadBlocking;
         }
         break;
@@ -350,6 +370,10 @@ status_t DbgConsole_Deinit(void)
 #endif /* FSL_FEATURE_SOC_UART_COUNT */
 #if defined(FSL_FEATURE_SOC_LPSCI_COUNT) && (FSL_FEATURE_SOC_LPSCI_COUNT > 0)
         case DEBUG_CONSOLE_DEVICE_TYPE_LPSCI:
+#if DEBUG_CONSOLE_ASYNC
+            /* Send what is still queued before the module goes down. */
+            myConsole_Flush();
+#endif /* DEBUG_CONSOLE_ASYNC */
             /* Disable LPSCI module. */
             LPSCI_Deinit(s_debugConsole.base);
             break;
@@ -544,108 +568,49 @@ static void DbgConsole_PrintfPaddingCharacter(
 static int32_t DbgConsole_ConvertRadixNumToString(char *numstr, void *nump, int32_t neg, int32_t radix, bool use_caps)
 {
 #if PRINTF_ADVANCED_ENABLE
-    int64_t a;
-    int64_t b;
-    int64_t c;
-
     uint64_t ua;
-    uint64_t ub;
-    uint64_t uc;
-#else
-    int32_t a;
-    int32_t b;
-    int32_t c;
-
-    uint32_t ua;
-    uint32_t ub;
-    uint32_t uc;
-#endif /* PRINTF_ADVANCED_ENABLE */
-
-    int32_t nlen;
-    char *nstrp;
-
-    nlen = 0;
-    nstrp = numstr;
-    *nstrp++ = '\0';
 
     if (neg)
     {
-#if PRINTF_ADVANCED_ENABLE
-        a = *(int64_t *)nump;
-#else
-        a = *(int32_t *)nump;
-#endif /* PRINTF_ADVANCED_ENABLE */
-        if (a == 0)
-        {
-            *nstrp = '0';
-            ++nlen;
-            return nlen;
-        }
-        while (a != 0)
-        {
-#if PRINTF_ADVANCED_ENABLE
-            b = (int64_t)a / (int64_t)radix;
-            c = (int64_t)a - ((int64_t)b * (int64_t)radix);
-            if (c < 0)
-            {
-                uc = (uint64_t)c;
-                c = (int64_t)(~uc) + 1 + '0';
-            }
-#else
-            b = a / radix;
-            c = a - (b * radix);
-            if (c < 0)
-            {
-                uc = (uint32_t)c;
-                c = (uint32_t)(~uc) + 1 + '0';
-            }
-#endif /* PRINTF_ADVANCED_ENABLE */
-            else
-            {
-                c = c + '0';
-            }
-            a = b;
-            *nstrp++ = (char)c;
-            ++nlen;
-        }
+        int64_t a = *(int64_t *)nump;
+        ua = (a < 0) ? (0U - (uint64_t)a) : (uint64_t)a;
     }
     else
     {
-#if PRINTF_ADVANCED_ENABLE
         ua = *(uint64_t *)nump;
+    }
 #else
+    uint32_t ua;
+
+    if (neg)
+    {
+        int32_t a = *(int32_t *)nump;
+        ua = (a < 0) ? (0U - (uint32_t)a) : (uint32_t)a;
+    }
+    else
+    {
         ua = *(uint32_t *)nump;
+    }
 #endif /* PRINTF_ADVANCED_ENABLE */
-        if (ua == 0)
-        {
-            *nstrp = '0';
-            ++nlen;
-            return nlen;
-        }
-        while (ua != 0)
-        {
+
+    /* The digits go least significant first after a terminator, as they are printed backwards. */
+    *numstr++ = '\0';
+
+    switch (radix)
+    {
+        case 16:
+            return (int32_t)myFormat_Pow2(ua, 4U, use_caps, numstr);
+        case 8:
+            return (int32_t)myFormat_Pow2(ua, 3U, use_caps, numstr);
+        case 2:
+            return (int32_t)myFormat_Pow2(ua, 1U, use_caps, numstr);
+        default:
 #if PRINTF_ADVANCED_ENABLE
-            ub = (uint64_t)ua / (uint64_t)radix;
-            uc = (uint64_t)ua - ((uint64_t)ub * (uint64_t)radix);
+            return (int32_t)myFormat_Dec64(ua, numstr);
 #else
-            ub = ua / (uint32_t)radix;
-            uc = ua - (ub * (uint32_t)radix);
+            return (int32_t)myFormat_Dec(ua, numstr);
 #endif /* PRINTF_ADVANCED_ENABLE */
-
-            if (uc < 10)
-            {
-                uc = uc + '0';
-            }
-            else
-            {
-                uc = uc - 10 + (use_caps ? 'A' : 'a');
-            }
-            ua = ub;
-            *nstrp++ = (char)uc;
-            ++nlen;
-        }
     }
-    return nlen;
 }
 
 #if PRINTF_FLOAT_ENABLE
@@ -664,99 +629,21 @@ static int32_t DbgConsole_ConvertFloatRadixNumToString(char *numstr,
                                                        int32_t radix,
                                                        uint32_t precision_width)
 {
-    int32_t a;
-    int32_t b;
-    int32_t c;
-    int32_t i;
-    uint32_t uc;
-    double fa;
-    double dc;
-    double fb;
-    double r;
-    double fractpart;
-    double intpart;
-
-    int32_t nlen;
-    char *nstrp;
-    nlen = 0;
-    nstrp = numstr;
-    *nstrp++ = '\0';
-    r = *(double *)nump;
-    if (!r)
-    {
-        *nstrp = '0';
-        ++nlen;
-        return nlen;
-    }
-    fractpart = modf((double)r, (double *)&intpart);
-    /* Process fractional part. */
-    for (i = 0; i < (int32_t)precision_width; i++)
-    {
-        fractpart *= radix;
-    }
-    if (r >= 0)
-    {
-        fa = fractpart + (double)0.5;
-        if (fa >= pow(10, precision_width))
-        {
-            intpart++;
-        }
-    }
-    else
-    {
-        fa = fractpart - (double)0.5;
-        if (fa <= -pow(10, precision_width))
-        {
-            intpart--;
-        }
-    }
-    for (i = 0; i < (int32_t)precision_width; i++)
-    {
-        fb = fa / (int32_t)radix;
-        dc = (fa - (int64_t)fb * (int32_t)radix);
-        c = (int32_t)dc;
-        if (c < 0)
-        {
-            uc = (uint32_t)c;
-            c = (int32_t)(~uc) + 1 + '0';
-        }
-        else
-        {
-            c = c + '0';
-        }
-        fa = fb;
-        *nstrp++ = (char)c;
-        ++nlen;
-    }
-    *nstrp++ = (char)'.';
-    ++nlen;
-    a = (int32_t)intpart;
-    if (a == 0)
-    {
-        *nstrp++ = '0';
-        ++nlen;
-    }
-    else
+    uint64_t bits;
+
+    /* Only decimal is ever asked for, and the number is taken from its bits, with no double math. */
+    (void)radix;
+    memcpy(&bits, nump, sizeof(bits));
+    *numstr++ = '\0';
+
+    /* Zero, of either sign, is printed as a lone digit. */
+    if ((bits << 1) == 0U)
     {
-        while (a != 0)
-        {
-            b = (int32_t)a / (int32_t)radix;
-            c = (int32_t)a - ((int32_t)b * (int32_t)radix);
-            if (c < 0)
-            {
-                uc = (uint32_t)c;
-                c = (int32_t)(~uc) + 1 + '0';
-            }
-            else
-            {
-                c = c + '0';
-            }
-            a = b;
-            *nstrp++ = (char)c;
-            ++nlen;
-        }
+        *numstr = '0';
+        return 1;
     }
-    return nlen;
+
+    return (int32_t)myFormat_Fixed(*(double *)nump, precision_width, numstr);
 }
 #endif /* PRINTF_FLOAT_ENABLE */
 
@@ -84,6 +84,11 @@
 #define SCANF_ADVANCED_ENABLE 0U
 #endif /* SCANF_ADVANCED_ENABLE */
 
+/*! @brief Definition to queue the LPSCI output through myConsole, instead of waiting for the wire. */
+#ifndef DEBUG_CONSOLE_ASYNC
+#define DEBUG_CONSOLE_ASYNC 0U
+#endif /* DEBUG_CONSOLE_ASYNC */
+
 #if SDK_DEBUGCONSOLE /* Select printf, scanf, putchar, getchar of SDK version. */
 #define PRINTF DbgConsole_Printf
 #define SCANF DbgConsole_Scanf
@@ -0,0 +1,83 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file myIrq.c
+ * @brief Source file for the interrupt masking driver, host builds.
+ *
+ * The host has no interrupts, but threads may stand for them. So masking
+ *  takes a process-wide lock, which is recursive just as masking can be
+ *  nested.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "myIrq.h"
+
+#include <pthread.h>
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static void myIrq_InitLock(void);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static pthread_once_t myIrq_Once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t myIrq_Mutex;
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES
+ ******************************************************************************/
+/**
+ * @brief Masks all the interrupts, which takes the lock on the host.
+ * @return Always zero, as the lock keeps its own nesting count.
+ */
+uint32_t myIrq_Lock(void)
+{
+  pthread_once(&myIrq_Once, myIrq_InitLock);
+  pthread_mutex_lock(&myIrq_Mutex);
+  return 0;
+}
+
+/**
+ * @brief Restores the interrupt mask, which releases the lock on the host.
+ * @param state Value returned by the matching myIrq_Lock call.
+ */
+void myIrq_Unlock(uint32_t state)
+{
+  (void) state;
+  pthread_mutex_unlock(&myIrq_Mutex);
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static void myIrq_InitLock(void)
+{
+  pthread_mutexattr_t attr;
+
+  pthread_mutexattr_init(&attr);
+  pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+  pthread_mutex_init(&myIrq_Mutex, &attr);
+  pthread_mutexattr_destroy(&attr);
+}
@@ -0,0 +1,99 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file myTime.c
+ * @brief Source file for the system time driver, host builds.
+ *
+ * This file backs the system time with the monotonic clock of the host, so
+ *  that the logic that depends on it can be built and run natively. That
+ *  clock is already lock-free and safe to read from any thread.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "myTime.h"
+
+#include <time.h>
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define DRIVER_TIME_US_PER_SECOND                                      (1000000)
+#define DRIVER_TIME_NS_PER_US                                             (1000)
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static uint64_t myTime_ReadHostUs(void);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static uint64_t myTime_StartUs = 0;
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES
+ ******************************************************************************/
+/**
+ * @brief Initialization routine for the system time. It should be called once,
+ *          after the clocks are configured, since the clock frequency is
+ *          captured here.
+ */
+void myTime_Init(void)
+{
+  myTime_StartUs = myTime_ReadHostUs();
+}
+
+/**
+ * @brief Gets the current system time.
+ *
+ * It is lock-free: interrupts are never disabled, so it can be called from
+ *  any context, including interrupt routines.
+ *
+ * @return Time, in us, since myTime_Init was called.
+ */
+uint64_t myTime_Now(void)
+{
+  return myTime_ReadHostUs() - myTime_StartUs;
+}
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES - TEST PURPOSES
+ ******************************************************************************/
+#ifdef TEST
+/**
+ * @brief Resets driver's internal logic and its variables.
+ */
+void myTime_Reset(void)
+{
+  myTime_StartUs = 0;
+}
+#endif
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static uint64_t myTime_ReadHostUs(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return ((uint64_t)now.tv_sec * DRIVER_TIME_US_PER_SECOND) + ((uint64_t)now.tv_nsec / DRIVER_TIME_NS_PER_US);
+}
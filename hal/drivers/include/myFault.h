@@ -0,0 +1,40 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file myFault.h
+ * @brief Header file for the fault drivers.
+ *
+ * This header provides the routines for fault drivers.
+ *  A fault driver handles failed assertions and the fault exceptions of the
+ *    core. Either way, it writes a crash record with what it can capture and
+ *    then hangs or, if the project asks for it, resets the core right away.
+ *  Failed assertions reach it through myCrash_Assert, which is declared by
+ *    the crash record helper and defined by the driver, so that the helpers
+ *    never depend on the drivers.
+ */
+
+#ifndef MY_FAULT_H
+#define MY_FAULT_H
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "myDefs.h"
+#include "myCrash.h"
+
+#endif
@@ -21,6 +21,11 @@
  * This header provides the types and routines for gpio drivers.
  *  A gpio driver provides routines for using pins for digital input or
  *    digital output operations.
+ *  Pins can also be handled as groups within a port, which are written with
+ *    a single store and read with a single load, no matter how many pins the
+ *    group has.
+ *  Input pins can also call back the client on edges or levels, from the
+ *    interrupt context, so that they do not have to be polled.
  */
 
 #ifndef MY_GPIO_H
@@ -62,8 +67,29 @@ typedef enum
   myGpioPull_Dw,
 } myGpioPull_t;
 
+/**
+ * @brief Type used by the driver to represent what triggers the interrupt of
+ *          an input pin.
+ *
+ * Level triggers keep firing for as long as the level is held, so their
+ *  callbacks are expected to remove the cause. Not all the devices support
+ *  them, in which case the pin initialization fails.
+ */
+typedef enum
+{
+  myGpioIrq_None = 0,
+  myGpioIrq_Rise,
+  myGpioIrq_Fall,
+  myGpioIrq_Both,
+  myGpioIrq_Low,
+  myGpioIrq_High,
+} myGpioIrq_t;
+
 /**
  * @brief Structure containing all the info needed to initialize a gpio pin.
+ *
+ * The interrupt fields are only used by input pins. Leaving them zeroed
+ *  initializes a pin without interrupt.
  */
 typedef struct
 {
@@ -71,6 +97,8 @@ typedef struct
   uint8_t pin;
   myGpioDir_t direction;
   myGpioPull_t pull;
+  myGpioIrq_t irq;
+  myCbk_t cbk;
 } myGpioPars_t;
 
 /**
@@ -79,6 +107,24 @@ typedef struct
  */
 typedef struct myGpioPinStruct_t * myGpioPin_t;
 
+/**
+ * @brief Structure containing all the info needed to initialize a group of
+ *          gpio pins, which must all belong to the same port.
+ */
+typedef struct
+{
+  uint8_t port;
+  uint32_t mask;
+  myGpioDir_t direction;
+  myGpioPull_t pull;
+} myGpioPortPars_t;
+
+/**
+ * @brief Typedef declaring a forward declared struct that represents
+ *          a group of gpio pins within a port.
+ */
+typedef struct myGpioPortStruct_t * myGpioPort_t;
+
 /*******************************************************************************
  *  PUBLIC FUNCTIONS / ROUTINES
  ******************************************************************************/
@@ -87,7 +133,8 @@ typedef struct myGpioPinStruct_t * myGpioPin_t;
  * @param pin If successful, it will be written with the data required to use
  *              this pin in the future.
  * @param pars Structure containing all the data required to initialize this
- *              pin.
+ *              pin. If it sets an interrupt trigger, its callback is called
+ *              from the interrupt context whenever the pin triggers.
  * @return Success / Failure
  */
 myRet_t myGpio_Init(myGpioPin_t * pin, myGpioPars_t * pars);
@@ -107,6 +154,70 @@ myGpioLvl_t myGpio_Get(myGpioPin_t pin);
  */
 myRet_t myGpio_Set(myGpioPin_t pin, myGpioLvl_t lvl);
 
+/**
+ * @brief Toggles the level of an output pin.
+ * @param pin Info about the pin to toggle.
+ * @return Success / Failure
+ */
+myRet_t myGpio_Toggle(myGpioPin_t pin);
+
+/**
+ * @brief Initialization routine for a group of gpio pins.
+ * @param port If successful, it will be written with the data required to use
+ *              this group in the future.
+ * @param pars Structure containing all the data required to initialize this
+ *              group. Its mask has a bit set for each pin of the group, in
+ *              the same position as the pin is in the port.
+ * @return Success / Failure
+ */
+myRet_t myGpio_InitPort(myGpioPort_t * port, myGpioPortPars_t * pars);
+
+/**
+ * @brief Gets the levels of all the pins of a group, with a single read of
+ *          the port.
+ * @param port Info about the group to get the levels from.
+ * @return Levels of the pins, one bit per pin as in the mask of the group,
+ *          and zero for the pins out of it. If routine fails, it returns zero.
+ */
+uint32_t myGpio_GetPort(myGpioPort_t port);
+
+/**
+ * @brief Sets some output pins of a group to high level at once, with no
+ *          read-modify-write. Pins out of the group are left untouched.
+ * @param port Info about the group the pins belong to.
+ * @param mask One bit set for each pin to set, as in the mask of the group.
+ * @return Success / Failure
+ */
+myRet_t myGpio_SetMask(myGpioPort_t port, uint32_t mask);
+
+/**
+ * @brief Sets some output pins of a group to low level at once, with no
+ *          read-modify-write. Pins out of the group are left untouched.
+ * @param port Info about the group the pins belong to.
+ * @param mask One bit set for each pin to clear, as in the mask of the group.
+ * @return Success / Failure
+ */
+myRet_t myGpio_ClearMask(myGpioPort_t port, uint32_t mask);
+
+/**
+ * @brief Toggles the level of some output pins of a group at once. Pins out
+ *          of the group are left untouched.
+ * @param port Info about the group the pins belong to.
+ * @param mask One bit set for each pin to toggle, as in the mask of the group.
+ * @return Success / Failure
+ */
+myRet_t myGpio_ToggleMask(myGpioPort_t port, uint32_t mask);
+
+/**
+ * @brief Writes the levels of all the output pins of a group. Pins out of the
+ *          group are left untouched.
+ * @param port Info about the group to write.
+ * @param value Levels of the pins, one bit per pin as in the mask of the
+ *          group.
+ * @return Success / Failure
+ */
+myRet_t myGpio_WritePort(myGpioPort_t port, uint32_t value);
+
 /*******************************************************************************
  *  PUBLIC FUNCTIONS / ROUTINES - TEST PURPOSES
  ******************************************************************************/
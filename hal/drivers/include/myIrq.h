@@ -0,0 +1,55 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file myIrq.h
+ * @brief Header file for the interrupt masking drivers.
+ *
+ * This header provides the routines for interrupt masking drivers.
+ *  An interrupt masking driver keeps all the interrupts from running for a
+ *    short section of code, so that it runs at once from the point of view
+ *    of any of them.
+ */
+
+#ifndef MY_IRQ_H
+#define MY_IRQ_H
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "myDefs.h"
+
+/*******************************************************************************
+ *  PUBLIC DEFINITIONS
+ ******************************************************************************/
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES
+ ******************************************************************************/
+/**
+ * @brief Masks all the interrupts. It can be called from any context,
+ *          including interrupt routines and sections that are already masked.
+ * @return State of the mask before the call, to be handed to myIrq_Unlock.
+ */
+uint32_t myIrq_Lock(void);
+
+/**
+ * @brief Restores the interrupt mask to what it was before myIrq_Lock.
+ * @param state Value returned by the matching myIrq_Lock call.
+ */
+void myIrq_Unlock(uint32_t state);
+
+#endif
@@ -0,0 +1,62 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file myPower.h
+ * @brief Header file for power management drivers.
+ *
+ * This header provides the routines for power drivers.
+ *  A power driver provides routines for putting the core to sleep whenever
+ *    there is nothing to do, and for waking it up when there is.
+ */
+
+#ifndef MY_POWER_H
+#define MY_POWER_H
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "myDefs.h"
+
+/*******************************************************************************
+ *  PUBLIC DEFINITIONS
+ ******************************************************************************/
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES
+ ******************************************************************************/
+/**
+ * @brief Starts an idle period by masking all the interrupts, so that the
+ *          decision to sleep can be made without them changing what it was
+ *          based on. Interrupts still wake the core from myPower_Sleep.
+ */
+void myPower_IdleEnter(void);
+
+/**
+ * @brief Puts the core to sleep until an interrupt is pending. It should be
+ *          called between myPower_IdleEnter and myPower_IdleExit, so the
+ *          interrupt that wakes the core only runs after the latter.
+ */
+void myPower_Sleep(void);
+
+/**
+ * @brief Finishes an idle period by unmasking the interrupts, letting the
+ *          pending ones run.
+ */
+void myPower_IdleExit(void);
+
+#endif
@@ -0,0 +1,70 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file myTime.h
+ * @brief Header file for the system time drivers.
+ *
+ * This header provides the routines for time drivers.
+ *  A time driver keeps a single monotonic clock, in microseconds, that starts
+ *    at zero on initialization and never wraps in practice (2^64 us is more
+ *    than half a million years).
+ */
+
+#ifndef MY_TIME_H
+#define MY_TIME_H
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "myDefs.h"
+
+/*******************************************************************************
+ *  PUBLIC DEFINITIONS
+ ******************************************************************************/
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES
+ ******************************************************************************/
+/**
+ * @brief Initialization routine for the system time. It should be called once,
+ *          after the clocks are configured, since the clock frequency is
+ *          captured here.
+ */
+void myTime_Init(void);
+
+/**
+ * @brief Gets the current system time.
+ *
+ * It is lock-free: interrupts are never disabled, so it can be called from
+ *  any context, including interrupt routines.
+ *
+ * @return Time, in us, since myTime_Init was called.
+ */
+uint64_t myTime_Now(void);
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES - TEST PURPOSES
+ ******************************************************************************/
+#ifdef TEST
+/**
+ * @brief Resets driver's internal logic and its variables.
+ */
+void myTime_Reset(void);
+#endif
+
+#endif
@@ -30,26 +30,97 @@
  *  INCLUDES
  ******************************************************************************/
 #include "myDefs.h"
+#include "myRing.h"
 
 /*******************************************************************************
  *  PUBLIC DEFINITIONS
  ******************************************************************************/
 /**
  * @brief Type used by the driver to determine a timer's operating mode.
+ *
+ * A periodic timer calls its callback once every period, and each period is
+ *  counted from the ideal end of the previous one, so they never drift. A
+ *  one-shot timer calls its callback once and then stops. A free-running
+ *  timer never expires and just counts the time since it was started, which
+ *  can be read with myTimer_GetElapsed. A PWM timer drives an output pin
+ *  with a duty cycle set by myTimer_SetDuty, all in hardware, so it never
+ *  raises an interrupt nor calls back. A capture timer has the hardware
+ *  latch its counter on the edges of an input pin, and pushes each of those
+ *  timestamps into a ring buffer, to be drained in batches.
  */
 typedef enum
 {
   myTimerMode_Periodic = 0,
+  myTimerMode_OneShot,
+  myTimerMode_FreeRunning,
+  myTimerMode_Pwm,
+  myTimerMode_Capture,
 } myTimerMode_t;
 
+/**
+ * @brief Type used by the driver to determine which resource backs a timer.
+ *
+ * A dedicated timer owns a whole hardware timer peripheral. A virtual timer
+ *  is a software timer that shares, with all the other virtual timers, a
+ *  single hardware timer that drives a timing wheel with a 1 ms tick. There
+ *  are only a few dedicated timers, but many virtual ones.
+ *
+ * Some devices have other counters that can back a periodic, one-shot or
+ *  free-running timer, which leaves their hardware timers free for channel
+ *  timers. Those resources fail to initialize on devices that lack them:
+ *  - myTimerRes_Pit: a channel of a periodic interrupt timer, which counts
+ *    the bus clock down through 32 bits. Free-running timers chain two of
+ *    them into a single 64-bit counter, so they take the whole PIT.
+ *  - myTimerRes_SysTick: the core's SysTick, shared with the system time, so
+ *    only periodic timers with periods of up to 2^24 core clock counts.
+ *    Periods are rounded down to whole counts, and the callback runs from
+ *    an interrupt with the highest priority.
+ */
+typedef enum
+{
+  myTimerRes_Dedicated = 0,
+  myTimerRes_Virtual,
+  myTimerRes_Pit,
+  myTimerRes_SysTick,
+} myTimerRes_t;
+
+/**
+ * @brief Type used by the driver to determine which edges a capture timer
+ *          latches its counter on.
+ */
+typedef enum
+{
+  myTimerEdge_Rise = 0,
+  myTimerEdge_Fall,
+  myTimerEdge_Both,
+} myTimerEdge_t;
+
 /**
  * @brief Structure containing all the info needed to initialize a timer.
+ *
+ * The channel is only used by PWM and capture timers, and it is one of the
+ *  myDriverTimerCh_t values of the device. Each channel belongs to a given
+ *  hardware timer, which the timer takes as a whole, so it must not be taken
+ *  already.
+ *
+ * The edge and the ring are only used by capture timers. The ring holds
+ *  uint32_t items, each one the timestamp of an edge, and the timer is its
+ *  only producer.
  */
 typedef struct
 {
   myTimerMode_t mode;
+  myTimerRes_t resource;
+  uint8_t channel;
+  myTimerEdge_t edge;
+  myRing_t * ring;
 } myTimerPars_t;
 
+/**
+ * @brief Duty cycle that keeps a PWM output always active.
+ */
+#define MY_TIMER_DUTY_MAX                                                 0xFFFF
+
 /**
  * @brief Typedef declaring a forward declared struct that represents
  *          a timer.
@@ -72,13 +143,105 @@ myRet_t myTimer_Init(myTimer_t * timer, myTimerPars_t * pars);
 /**
  * @brief Starts the time counting operation for a timer.
  * @param timer Timer to start the operation
- * @param period Time, in ms, to count
- * @param cbk Callback to be called when timer expires
+ * @param period Time, in ms, to count. Ignored by free-running and capture
+ *          timers. For PWM timers, it is the period of the output.
+ * @param cbk Callback to be called when timer expires. Ignored by
+ *          free-running and PWM timers. For capture timers, it is optional
+ *          and called when a timestamp is pushed into an empty ring, so that
+ *          the consumer is only woken up once for each batch.
  * @return Success / Failure. If successful, timer will start and callback
- *          will eventually be called.
+ *          will eventually be called. Periodic and one-shot timers fail
+ *          without a period or a callback, and PWM timers without a period.
+ *          Timers also fail if the period is beyond what their resource can
+ *          count: dedicated timers take it in 32 bits at their largest
+ *          prescaler, PIT timers in the 32 bits of a channel and the SysTick
+ *          timer in a single wrap. PWM timers fail if the period does not fit
+ *          a single overflow of their hardware. Each driver tells the limits
+ *          of its device.
  */
 myRet_t myTimer_Start(myTimer_t timer, uint32_t period, myCbk_t cbk);
 
+/**
+ * @brief Stops the time counting operation for a timer.
+ * @param timer Timer to stop the operation
+ * @return Success / Failure. If successful, callback won't be called anymore
+ *          until the timer is started again.
+ */
+myRet_t myTimer_Stop(myTimer_t timer);
+
+/**
+ * @brief Sets the duty cycle of a PWM timer. It can be called whether the
+ *          timer is running or not.
+ *
+ * The new duty cycle is buffered by the hardware and takes effect at the end
+ *  of the current period, so the output never has a period with a mix of the
+ *  old and new duty cycles.
+ *
+ * @param timer PWM timer to set
+ * @param duty Share of the period that the output is active, from zero, for
+ *          never, up to MY_TIMER_DUTY_MAX, for always.
+ * @return Success / Failure. Fails if the timer is not a PWM one.
+ */
+myRet_t myTimer_SetDuty(myTimer_t timer, uint16_t duty);
+
+/**
+ * @brief Gets the time elapsed since a free-running timer was started.
+ * @param timer Free-running timer to read
+ * @return Time, in ms, since the timer was started. Zero if the timer is not
+ *          a free-running one.
+ */
+uint32_t myTimer_GetElapsed(myTimer_t timer);
+
+/**
+ * @brief Gets the rate of the timestamps of a capture timer.
+ *
+ * Timestamps are the counts of the hardware timer at full resolution,
+ *  extended to 32 bits with its overflows, so they wrap around at 2^32. The
+ *  time between two edges is the difference of their timestamps over the
+ *  rate, as long as it is shorter than a wrap around.
+ *
+ * @param timer Capture timer to read
+ * @return Counts per second of the timestamps since the timer was last
+ *          started. Zero if it is not a started capture timer.
+ */
+uint32_t myTimer_GetCaptureHz(myTimer_t timer);
+
+/**
+ * @brief Refreshes the clock settings that the driver keeps. Should be called
+ *          whenever the clock configuration changes.
+ *
+ * Every running timer carries on with the new settings. Periodic and PWM
+ *  timers are restarted with their period, one-shot timers with the time they
+ *  had left, and free-running timers keep counting from the time they had
+ *  elapsed. Capture timers keep their timestamps, which just count at the new
+ *  rate from then on.
+ */
+void myTimer_ClockUpdate(void);
+
+/**
+ * @brief Stops the tick of the virtual timers for as long as none of them
+ *          needs it, so that the system can sleep through it. It should be
+ *          called with interrupts masked, right before going to sleep.
+ *
+ * A single wakeup is programmed for the next tick with any work to do, and
+ *  myTimer_IdleExit must be called right after waking up, whatever woke the
+ *  system, before interrupts are unmasked.
+ *
+ * @return Time, in us, until the programmed wakeup. Zero if the tick is
+ *          needed too soon to be stopped, or if there are no virtual timers.
+ */
+uint32_t myTimer_IdleEnter(void);
+
+/**
+ * @brief Brings back the tick of the virtual timers after the system woke up,
+ *          catching them up with the time that was slept. It should be
+ *          called before interrupts are unmasked.
+ *
+ * The ticks that were skipped are accounted exactly, so the virtual timers
+ *  keep expiring at the same times as if the tick had never stopped.
+ */
+void myTimer_IdleExit(void);
+
 /*******************************************************************************
  *  PUBLIC FUNCTIONS / ROUTINES - TEST PURPOSES
  ******************************************************************************/
@@ -0,0 +1,274 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file myConsole.c
+ * @brief Source file for the asynchronous debug console, KL25
+ *          microcontrollers.
+ *
+ * Writes copy the bytes into the client's buffer and enable the transmit
+ *  data register empty interrupt of the LPSCI. That interrupt then sends one
+ *  byte each time the register frees up, and disables itself once the buffer
+ *  is empty. The buffer is only touched with interrupts masked, by writers
+ *  and by the interrupt alike, so any of them may take bytes out of it: that
+ *  is how overwriting drops the oldest bytes, and how a blocked write makes
+ *  room when the interrupt cannot run.
+ *
+ * Nothing here waits for the wire, except for the blocking policy when the
+ *  buffer is full, flushing, and writes made before the initialization. Even
+ *  then, the waiting is done with interrupts unmasked.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "myConsole.h"
+#include "myIrq.h"
+
+#include "fsl_common.h"
+#include "fsl_lpsci.h"
+
+#include "myAssert.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define DRIVER_CONSOLE_UART                                                UART0
+#define DRIVER_CONSOLE_IRQN                                           UART0_IRQn
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static uint32_t getQueued(void);
+static void waitForTransmitter(void);
+static void sendOldest(void);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static uint8_t * myConsole_Buffer = NULL;
+static uint32_t myConsole_Mask = 0;
+static uint32_t myConsole_Head = 0;
+static uint32_t myConsole_Tail = 0;
+static myConsoleFull_t myConsole_Full = myConsoleFull_Drop;
+static volatile uint32_t myConsole_Lost = 0;
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES
+ ******************************************************************************/
+/**
+ * @brief Initialization routine for the console. Until it is called, writes
+ *          are sent right away, waiting for the wire.
+ * @param pars Structure containing all the data required to initialize the
+ *          console.
+ * @return Success / Failure
+ */
+myRet_t myConsole_Init(myConsolePars_t * pars)
+{
+  myRet_t result = myRet_Fail;
+
+  if((pars != NULL) && (pars->buffer != NULL) && (pars->size != 0) && ((pars->size & (pars->size - 1)) == 0))
+  {
+    myASSERT(pars->full <= myConsoleFull_Overwrite);
+
+    myConsole_Full = pars->full;
+    myConsole_Lost = 0;
+    myConsole_Head = 0;
+    myConsole_Tail = 0;
+    myConsole_Mask = pars->size - 1;
+    myConsole_Buffer = pars->buffer;
+
+    EnableIRQ(DRIVER_CONSOLE_IRQN);
+    result = myRet_OK;
+  }
+
+  return result;
+}
+
+/**
+ * @brief Writes bytes to the console. It can be called from any context,
+ *          including interrupt routines, as interrupts are masked while the
+ *          bytes are copied.
+ * @param data Bytes to write.
+ * @param length Amount of bytes to write.
+ * @return Amount of bytes that were queued or sent. It is only lower than
+ *          length when bytes were dropped.
+ */
+uint32_t myConsole_Write(const uint8_t * data, uint32_t length)
+{
+  uint32_t written = 0;
+  uint32_t irqState;
+  bool dropping = false;
+
+  if((data != NULL) && (length != 0) && (myConsole_Buffer == NULL))
+  {
+    LPSCI_WriteBlocking(DRIVER_CONSOLE_UART, data, length);
+    written = length;
+  }
+  else if((data != NULL) && (length != 0))
+  {
+    irqState = myIrq_Lock();
+
+    while((written < length) && !dropping)
+    {
+      if(getQueued() <= myConsole_Mask)
+      {
+        myConsole_Buffer[myConsole_Head & myConsole_Mask] = data[written];
+        myConsole_Head++;
+        written++;
+      }
+      else if(myConsole_Full == myConsoleFull_Overwrite)
+      {
+        myConsole_Tail++;
+        myConsole_Lost++;
+      }
+      else if(myConsole_Full == myConsoleFull_Block)
+      {
+        /* Wait for the transmitter with interrupts unmasked, so that the rest*/
+        /*  of the system keeps running and the interrupt can make room. If it*/
+        /*  did not, as when the caller had them masked, the oldest byte is   */
+        /*  sent from here.                                                   */
+        LPSCI_EnableInterrupts(DRIVER_CONSOLE_UART, kLPSCI_TxDataRegEmptyInterruptEnable);
+        myIrq_Unlock(irqState);
+        waitForTransmitter();
+        irqState = myIrq_Lock();
+
+        if(getQueued() > myConsole_Mask) { sendOldest(); }
+      }
+      else
+      {
+        myConsole_Lost += length - written;
+        dropping = true;
+      }
+    }
+
+    if(getQueued() > 0)
+    {
+      LPSCI_EnableInterrupts(DRIVER_CONSOLE_UART, kLPSCI_TxDataRegEmptyInterruptEnable);
+    }
+
+    myIrq_Unlock(irqState);
+  }
+
+  return written;
+}
+
+/**
+ * @brief Sends everything that is queued, waiting for the wire. Meant for
+ *          when the output must be out before going on, such as before a
+ *          reset or before the LPSCI is shut down.
+ */
+void myConsole_Flush(void)
+{
+  uint32_t irqState;
+
+  if(myConsole_Buffer != NULL)
+  {
+    irqState = myIrq_Lock();
+
+    /* As with blocked writes, the wire is waited for with interrupts         */
+    /*  unmasked, and each byte is sent with them masked.                     */
+    while(getQueued() > 0)
+    {
+      myIrq_Unlock(irqState);
+      waitForTransmitter();
+      irqState = myIrq_Lock();
+
+      sendOldest();
+    }
+
+    LPSCI_DisableInterrupts(DRIVER_CONSOLE_UART, kLPSCI_TxDataRegEmptyInterruptEnable);
+    myIrq_Unlock(irqState);
+
+    /* Wait as well for the last byte to leave the shift register.            */
+    while((LPSCI_GetStatusFlags(DRIVER_CONSOLE_UART) & kLPSCI_TransmissionCompleteFlag) == 0) { }
+  }
+}
+
+/**
+ * @brief Gets how many bytes were lost because the buffer was full.
+ * @return Amount of bytes dropped or overwritten since initialization.
+ */
+uint32_t myConsole_GetLost(void)
+{
+  return myConsole_Lost;
+}
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES - TEST PURPOSES
+ ******************************************************************************/
+#ifdef TEST
+/**
+ * @brief Resets console's internal logic and its variables.
+ */
+void myConsole_Reset(void)
+{
+  myConsole_Buffer = NULL;
+  myConsole_Mask = 0;
+  myConsole_Head = 0;
+  myConsole_Tail = 0;
+  myConsole_Full = myConsoleFull_Drop;
+  myConsole_Lost = 0;
+}
+#endif
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static uint32_t getQueued(void)
+{
+  return myConsole_Head - myConsole_Tail;
+}
+
+static void waitForTransmitter(void)
+{
+  while((LPSCI_GetStatusFlags(DRIVER_CONSOLE_UART) & kLPSCI_TxDataRegEmptyFlag) == 0) { }
+}
+
+/* Must be called with interrupts masked. Sends nothing if the transmitter    */
+/*  is still busy.                                                            */
+static void sendOldest(void)
+{
+  if((getQueued() > 0) && ((LPSCI_GetStatusFlags(DRIVER_CONSOLE_UART) & kLPSCI_TxDataRegEmptyFlag) != 0))
+  {
+    LPSCI_WriteByte(DRIVER_CONSOLE_UART, myConsole_Buffer[myConsole_Tail & myConsole_Mask]);
+    myConsole_Tail++;
+  }
+}
+
+/*******************************************************************************
+ *  INTERRUPT ROUTINES
+ ******************************************************************************/
+void UART0_IRQHandler(void)
+{
+  uint32_t irqState;
+
+  /* Writers may run in interrupts of higher priority, so the buffer is only  */
+  /*  touched with every interrupt masked.                                    */
+  irqState = myIrq_Lock();
+
+  if(getQueued() > 0)
+  {
+    sendOldest();
+  }
+  else
+  {
+    LPSCI_DisableInterrupts(DRIVER_CONSOLE_UART, kLPSCI_TxDataRegEmptyInterruptEnable);
+  }
+
+  myIrq_Unlock(irqState);
+}
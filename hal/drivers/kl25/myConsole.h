@@ -0,0 +1,119 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file myConsole.h
+ * @brief Header file for the asynchronous debug console, KL25
+ *          microcontrollers.
+ *
+ * This header provides the routines for a console that sends its output
+ *  through the LPSCI without waiting for it. Writes only copy the bytes into
+ *  a buffer, and the LPSCI interrupt sends them as the transmitter gets
+ *  free, so printing a line takes us instead of the ms that the wire takes.
+ *
+ * The SDK debug console uses it when DEBUG_CONSOLE_ASYNC is set, so that
+ *  PRINTF is queued as well. The LPSCI itself is set up by DbgConsole_Init.
+ */
+
+#ifndef MY_CONSOLE_H
+#define MY_CONSOLE_H
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "myDefs.h"
+
+/*******************************************************************************
+ *  PUBLIC DEFINITIONS
+ ******************************************************************************/
+/**
+ * @brief Type used by the console to determine what a write does when the
+ *          buffer is full.
+ *
+ * Dropping loses the newest bytes, and overwriting loses the oldest ones.
+ *  Either way the write never waits, and the lost bytes are counted. Blocking
+ *  loses nothing: the write waits, with interrupts unmasked, until the rest
+ *  fits, which takes as long as the wire does.
+ */
+typedef enum
+{
+  myConsoleFull_Drop = 0,
+  myConsoleFull_Block,
+  myConsoleFull_Overwrite,
+} myConsoleFull_t;
+
+/**
+ * @brief Structure containing all the info needed to initialize the console.
+ *
+ * The buffer holds the bytes to send, and belongs to the console from then
+ *  on. Its size, a power of two, sets how long a burst of output can be
+ *  before the policy kicks in.
+ */
+typedef struct
+{
+  uint8_t * buffer;
+  uint32_t size;
+  myConsoleFull_t full;
+} myConsolePars_t;
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES
+ ******************************************************************************/
+/**
+ * @brief Initialization routine for the console. Until it is called, writes
+ *          are sent right away, waiting for the wire.
+ * @param pars Structure containing all the data required to initialize the
+ *          console.
+ * @return Success / Failure
+ */
+myRet_t myConsole_Init(myConsolePars_t * pars);
+
+/**
+ * @brief Writes bytes to the console. It can be called from any context,
+ *          including interrupt routines, as interrupts are masked while the
+ *          bytes are copied.
+ * @param data Bytes to write.
+ * @param length Amount of bytes to write.
+ * @return Amount of bytes that were queued or sent. It is only lower than
+ *          length when bytes were dropped.
+ */
+uint32_t myConsole_Write(const uint8_t * data, uint32_t length);
+
+/**
+ * @brief Sends everything that is queued, waiting for the wire. Meant for
+ *          when the output must be out before going on, such as before a
+ *          reset or before the LPSCI is shut down.
+ */
+void myConsole_Flush(void);
+
+/**
+ * @brief Gets how many bytes were lost because the buffer was full.
+ * @return Amount of bytes dropped or overwritten since initialization.
+ */
+uint32_t myConsole_GetLost(void);
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES - TEST PURPOSES
+ ******************************************************************************/
+#ifdef TEST
+/**
+ * @brief Resets console's internal logic and its variables.
+ */
+void myConsole_Reset(void);
+#endif
+
+#endif
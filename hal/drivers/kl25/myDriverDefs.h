@@ -84,4 +84,21 @@ typedef enum
   myDriverPin_31,
 } myDriverPin_t;
 
+/**
+ * @brief Type that names the channels that PWM and capture timers can use,
+ *          each one as its TPM, channel and pin. The first three are the
+ *          red, green and blue LEDs of the FRDM-KL25Z board.
+ */
+typedef enum
+{
+  myDriverTimerCh_TPM2_CH0_PTB18 = 0,
+  myDriverTimerCh_TPM2_CH1_PTB19,
+  myDriverTimerCh_TPM0_CH1_PTD1,
+  myDriverTimerCh_TPM0_CH0_PTD0,
+  myDriverTimerCh_TPM0_CH2_PTD2,
+  myDriverTimerCh_TPM0_CH3_PTD3,
+  myDriverTimerCh_TPM1_CH0_PTA12,
+  myDriverTimerCh_TPM1_CH1_PTA13,
+} myDriverTimerCh_t;
+
 #endif
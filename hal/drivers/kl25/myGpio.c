@@ -19,12 +19,23 @@
  * @brief Source file for general purpose input output operations.
  *
  * This file implements the Gpio driver for KL25 devices.
+ *
+ * Pins are accessed either through the peripheral bridge or, if the project
+ *  sets DRIVER_GPIO_USE_FGPIO, through the single-cycle FGPIO alias, whose
+ *  registers are written directly.
+ *
+ * Input pins of PORTA and PORTD can also interrupt. Each of these ports has
+ *  a single vector shared by all its pins, whose routine finds the pins that
+ *  fired from the port flags, and calls their callbacks from a table indexed
+ *  by pin. Finding each pin takes a constant time, no matter how many pins
+ *  the port has.
  */
 
 /*******************************************************************************
  *  INCLUDES
  ******************************************************************************/
 #include "myGpio.h"
+#include "myGpioFast.h"
 #include "myDriverDefs.h"
 #include "projConfig.h"
 
@@ -42,24 +53,56 @@
 /* The structure below holds all the items related to a gpio pin instance.    */
 typedef struct
 {
-  GPIO_Type * GPIO;
+  myGpioFastRegs_t * GPIO;
   uint32_t pin;
 } myGpioPinStruct_t;
 
+/* The structure below holds all the items related to a group of gpio pins.   */
+typedef struct
+{
+  myGpioFastRegs_t * GPIO;
+  uint32_t mask;
+} myGpioPortStruct_t;
+
 /* Set below the maximum amount of pins that the driver can handle.           */
 #ifndef DRIVER_GPIO_PIN_AMOUNT
   #define DRIVER_GPIO_PIN_AMOUNT                                               4
 #endif
 
+/* Set below the maximum amount of pin groups that the driver can handle.     */
+#ifndef DRIVER_GPIO_PORT_AMOUNT
+  #define DRIVER_GPIO_PORT_AMOUNT                                              2
+#endif
+
+/* The structure below holds all the items related to an interrupting port.   */
+typedef struct
+{
+  PORT_Type * PORT;
+  IRQn_Type irqn;
+  myCbk_t cbks[myDriverPin_31 + 1];
+} myGpioIrqStruct_t;
+
+/* Set below the registers through which the pins are accessed.               */
+#if DRIVER_GPIO_USE_FGPIO
+  #define MY_GPIO_BASE_PTRS                                      FGPIO_BASE_PTRS
+#else
+  #define MY_GPIO_BASE_PTRS                                       GPIO_BASE_PTRS
+#endif
+
 /*******************************************************************************
  *  PRIVATE PROTOTYPES
  ******************************************************************************/
 static bool parsAreValid(myGpioPars_t * pars);
+static bool portParsAreValid(myGpioPortPars_t * pars);
+static void configurePin(uint8_t port, uint32_t pin, myGpioDir_t direction, myGpioPull_t pull);
+static myGpioIrqStruct_t * getIrqStruct(uint8_t port);
+static void configureIrq(uint8_t port, uint32_t pin, myGpioIrq_t irq, myCbk_t cbk);
+static void dispatchIrq(myGpioIrqStruct_t * strc);
 
 /*******************************************************************************
  *  PRIVATE VARIABLES
  ******************************************************************************/
-static GPIO_Type * const myGpio_GPIOs[] = GPIO_BASE_PTRS;
+static myGpioFastRegs_t * const myGpio_GPIOs[] = MY_GPIO_BASE_PTRS;
 static PORT_Type * const myGpio_PORTs[] = PORT_BASE_PTRS;
 static const uint32_t myGpio_GPIOCnt = MY_ARRAY_SIZE(myGpio_GPIOs);
 
@@ -68,6 +111,12 @@ static const clock_ip_name_t myGpio_Clocks[] = { kCLOCK_PortA, kCLOCK_PortB, kCL
 static myGpioPinStruct_t myGpio_Struct[DRIVER_GPIO_PIN_AMOUNT];
 static uint32_t myGpio_NextPin = 0;
 
+static myGpioPortStruct_t myGpio_PortStruct[DRIVER_GPIO_PORT_AMOUNT];
+static uint32_t myGpio_NextPort = 0;
+
+static myGpioIrqStruct_t myGpio_IrqA = { .PORT = PORTA, .irqn = PORTA_IRQn };
+static myGpioIrqStruct_t myGpio_IrqD = { .PORT = PORTD, .irqn = PORTD_IRQn };
+
 /*******************************************************************************
  *  PUBLIC FUNCTIONS / ROUTINES
  ******************************************************************************/
@@ -88,6 +137,7 @@ myRet_t myGpio_Init(myGpioPin_t * pin, myGpioPars_t * pars)
     myASSERT(pars->port < myGpio_GPIOCnt);
     myASSERT(pars->pin <= myDriverPin_31);
     myASSERT(pars->direction <= myGpioDir_Outp);
+    myASSERT(pars->irq <= myGpioIrq_High);
 
     if(parsAreValid(pars))
     {
@@ -97,52 +147,13 @@ myRet_t myGpio_Init(myGpioPin_t * pin, myGpioPars_t * pars)
       if(thisGpio >= DRIVER_GPIO_PIN_AMOUNT) { myGpio_NextPin--; }
       else
       {
-        GPIO_Type * const periph = myGpio_GPIOs[pars->port];
-        PORT_Type * const port = myGpio_PORTs[pars->port];
-        clock_ip_name_t clock = myGpio_Clocks[pars->port];
         myGpioPinStruct_t * strc = &myGpio_Struct[thisGpio];
 
-        strc->GPIO = periph;
+        strc->GPIO = myGpio_GPIOs[pars->port];
         strc->pin = pars->pin;
 
-        /* First initialize the GPIO settings.                                */
-        {
-          gpio_pin_config_t gpioCfg;
-
-          CLOCK_EnableClock(clock);
-
-          if(pars->direction == myGpioDir_Inpt) { gpioCfg.pinDirection = kGPIO_DigitalInput;  }
-          else                                  { gpioCfg.pinDirection = kGPIO_DigitalOutput; }
-          gpioCfg.outputLogic = 0;
-
-          GPIO_PinInit(periph, strc->pin, &gpioCfg);
-        }
-
-        /* Now initializes the PORT settings.                                 */
-        {
-          port_pin_config_t portCfg;
-
-          if(pars->direction == myGpioDir_Inpt)
-          {
-            switch(pars->pull)
-            {
-              case myGpioPull_Dw: { portCfg.pullSelect = kPORT_PullDown;    } break;
-              case myGpioPull_Up: { portCfg.pullSelect = kPORT_PullUp;      } break;
-              default:            { portCfg.pullSelect = kPORT_PullDisable; } break;
-            }
-          }
-          else
-          {
-            portCfg.pullSelect = kPORT_PullDisable;
-          }
-
-          portCfg.slewRate = kPORT_SlowSlewRate;
-          portCfg.passiveFilterEnable = kPORT_PassiveFilterDisable;
-          portCfg.driveStrength = kPORT_LowDriveStrength;
-          portCfg.mux = kPORT_MuxAsGpio;
-
-          PORT_SetPinConfig(port, strc->pin, &portCfg);
-        }
+        configurePin(pars->port, strc->pin, pars->direction, pars->pull);
+        if(pars->irq != myGpioIrq_None) { configureIrq(pars->port, strc->pin, pars->irq, pars->cbk); }
 
         /* Init is complete.                                                  */
         *pin = (myGpioPin_t) strc;
@@ -169,7 +180,11 @@ myGpioLvl_t myGpio_Get(myGpioPin_t pin)
 
   if(strc != NULL)
   {
+#if DRIVER_GPIO_USE_FGPIO
+    value = (strc->GPIO->PDIR >> strc->pin) & 1UL;
+#else
     value = GPIO_ReadPinInput(strc->GPIO, strc->pin);
+#endif
     if(value != 0) { lvl = myGpioLvl_Hi; }
   }
 
@@ -196,7 +211,193 @@ myRet_t myGpio_Set(myGpioPin_t pin, myGpioLvl_t lvl)
     if(lvl == myGpioLvl_Lo) { output = 0; }
     else                    { output = 1; }
 
+#if DRIVER_GPIO_USE_FGPIO
+    if(output == 0) { strc->GPIO->PCOR = (1UL << strc->pin); }
+    else            { strc->GPIO->PSOR = (1UL << strc->pin); }
+#else
     GPIO_WritePinOutput(strc->GPIO, strc->pin, output);
+#endif
+    result = myRet_OK;
+  }
+
+  return result;
+}
+
+/**
+ * @brief Toggles the level of an output pin.
+ * @param pin Info about the pin to toggle.
+ * @return Success / Failure
+ */
+myRet_t myGpio_Toggle(myGpioPin_t pin)
+{
+  myGpioPinStruct_t * strc = (myGpioPinStruct_t *) pin;
+  myRet_t result = myRet_Fail;
+
+  myASSERT(strc != NULL);
+
+  if(strc != NULL)
+  {
+#if DRIVER_GPIO_USE_FGPIO
+    strc->GPIO->PTOR = (1UL << strc->pin);
+#else
+    GPIO_TogglePinsOutput(strc->GPIO, (1UL << strc->pin));
+#endif
+    result = myRet_OK;
+  }
+
+  return result;
+}
+
+/**
+ * @brief Initialization routine for a group of gpio pins.
+ * @param port If successful, it will be written with the data required to use
+ *              this group in the future.
+ * @param pars Structure containing all the data required to initialize this
+ *              group.
+ * @return Success / Failure
+ */
+myRet_t myGpio_InitPort(myGpioPort_t * port, myGpioPortPars_t * pars)
+{
+  myRet_t result = myRet_Fail;
+
+  if((port != NULL) && (pars != NULL))
+  {
+    myASSERT(pars->port < myGpio_GPIOCnt);
+    myASSERT(pars->mask != 0);
+    myASSERT(pars->direction <= myGpioDir_Outp);
+
+    if(portParsAreValid(pars))
+    {
+      const uint32_t thisPort = myGpio_NextPort++;
+      myASSERT(thisPort < DRIVER_GPIO_PORT_AMOUNT);
+
+      if(thisPort >= DRIVER_GPIO_PORT_AMOUNT) { myGpio_NextPort--; }
+      else
+      {
+        myGpioPortStruct_t * strc = &myGpio_PortStruct[thisPort];
+        uint32_t pin;
+
+        strc->GPIO = myGpio_GPIOs[pars->port];
+        strc->mask = pars->mask;
+
+        for(pin = myDriverPin_00; pin <= myDriverPin_31; pin++)
+        {
+          if((pars->mask & (1UL << pin)) != 0) { configurePin(pars->port, pin, pars->direction, pars->pull); }
+        }
+
+        /* Init is complete.                                                  */
+        *port = (myGpioPort_t) strc;
+        result = myRet_OK;
+      }
+    }
+  }
+
+  return result;
+}
+
+/**
+ * @brief Gets the levels of all the pins of a group.
+ * @param port Info about the group to get the levels from.
+ * @return Levels of the pins. If routine fails, it returns zero.
+ */
+uint32_t myGpio_GetPort(myGpioPort_t port)
+{
+  myGpioPortStruct_t * strc = (myGpioPortStruct_t *) port;
+  uint32_t value = 0;
+
+  myASSERT(strc != NULL);
+
+  if(strc != NULL) { value = strc->GPIO->PDIR & strc->mask; }
+
+  return value;
+}
+
+/**
+ * @brief Sets some output pins of a group to high level at once.
+ * @param port Info about the group the pins belong to.
+ * @param mask One bit set for each pin to set.
+ * @return Success / Failure
+ */
+myRet_t myGpio_SetMask(myGpioPort_t port, uint32_t mask)
+{
+  myGpioPortStruct_t * strc = (myGpioPortStruct_t *) port;
+  myRet_t result = myRet_Fail;
+
+  myASSERT(strc != NULL);
+
+  if(strc != NULL)
+  {
+    strc->GPIO->PSOR = mask & strc->mask;
+    result = myRet_OK;
+  }
+
+  return result;
+}
+
+/**
+ * @brief Sets some output pins of a group to low level at once.
+ * @param port Info about the group the pins belong to.
+ * @param mask One bit set for each pin to clear.
+ * @return Success / Failure
+ */
+myRet_t myGpio_ClearMask(myGpioPort_t port, uint32_t mask)
+{
+  myGpioPortStruct_t * strc = (myGpioPortStruct_t *) port;
+  myRet_t result = myRet_Fail;
+
+  myASSERT(strc != NULL);
+
+  if(strc != NULL)
+  {
+    strc->GPIO->PCOR = mask & strc->mask;
+    result = myRet_OK;
+  }
+
+  return result;
+}
+
+/**
+ * @brief Toggles the level of some output pins of a group at once.
+ * @param port Info about the group the pins belong to.
+ * @param mask One bit set for each pin to toggle.
+ * @return Success / Failure
+ */
+myRet_t myGpio_ToggleMask(myGpioPort_t port, uint32_t mask)
+{
+  myGpioPortStruct_t * strc = (myGpioPortStruct_t *) port;
+  myRet_t result = myRet_Fail;
+
+  myASSERT(strc != NULL);
+
+  if(strc != NULL)
+  {
+    strc->GPIO->PTOR = mask & strc->mask;
+    result = myRet_OK;
+  }
+
+  return result;
+}
+
+/**
+ * @brief Writes the levels of all the output pins of a group.
+ * @param port Info about the group to write.
+ * @param value Levels of the pins, one bit per pin.
+ * @return Success / Failure
+ */
+myRet_t myGpio_WritePort(myGpioPort_t port, uint32_t value)
+{
+  myGpioPortStruct_t * strc = (myGpioPortStruct_t *) port;
+  myRet_t result = myRet_Fail;
+
+  myASSERT(strc != NULL);
+
+  if(strc != NULL)
+  {
+    /* KL25 has no register that sets and clears pins at once, so the high    */
+    /*  pins are set first and the low ones cleared right after. Each store   */
+    /*  is still atomic, and leaves the other pins of the port alone.         */
+    strc->GPIO->PSOR = value & strc->mask;
+    strc->GPIO->PCOR = ~value & strc->mask;
     result = myRet_OK;
   }
 
@@ -212,7 +413,16 @@ myRet_t myGpio_Set(myGpioPin_t pin, myGpioLvl_t lvl)
  */
 void myGpio_Reset(void)
 {
+  uint32_t pin;
+
   myGpio_NextPin = 0;
+  myGpio_NextPort = 0;
+
+  for(pin = myDriverPin_00; pin <= myDriverPin_31; pin++)
+  {
+    myGpio_IrqA.cbks[pin] = NULL;
+    myGpio_IrqD.cbks[pin] = NULL;
+  }
 }
 #endif
 
@@ -224,6 +434,34 @@ static bool parsAreValid(myGpioPars_t * pars)
   bool areValid;
 
   if( (pars->port < myGpio_GPIOCnt) && (pars->pin <= myDriverPin_31) &&
+      (pars->direction <= myGpioDir_Outp) && (pars->pull <= myGpioPull_Dw) &&
+      (pars->irq <= myGpioIrq_High) )
+  {
+    areValid = true;
+  }
+  else
+  {
+    areValid = false;
+  }
+
+  /* Interrupts are only taken from input pins, of the ports that have them.  */
+  if(areValid && (pars->irq != myGpioIrq_None))
+  {
+    if( (pars->direction != myGpioDir_Inpt) || (pars->cbk == NULL) ||
+        (getIrqStruct(pars->port) == NULL) )
+    {
+      areValid = false;
+    }
+  }
+
+  return areValid;
+}
+
+static bool portParsAreValid(myGpioPortPars_t * pars)
+{
+  bool areValid;
+
+  if( (pars->port < myGpio_GPIOCnt) && (pars->mask != 0) &&
       (pars->direction <= myGpioDir_Outp) && (pars->pull <= myGpioPull_Dw) )
   {
     areValid = true;
@@ -235,3 +473,118 @@ static bool parsAreValid(myGpioPars_t * pars)
 
   return areValid;
 }
+
+static void configurePin(uint8_t port, uint32_t pin, myGpioDir_t direction, myGpioPull_t pull)
+{
+  /* First initialize the GPIO settings.                                      */
+  {
+    gpio_pin_config_t gpioCfg;
+
+    CLOCK_EnableClock(myGpio_Clocks[port]);
+
+    if(direction == myGpioDir_Inpt) { gpioCfg.pinDirection = kGPIO_DigitalInput;  }
+    else                            { gpioCfg.pinDirection = kGPIO_DigitalOutput; }
+    gpioCfg.outputLogic = 0;
+
+#if DRIVER_GPIO_USE_FGPIO
+    FGPIO_PinInit(myGpio_GPIOs[port], pin, &gpioCfg);
+#else
+    GPIO_PinInit(myGpio_GPIOs[port], pin, &gpioCfg);
+#endif
+  }
+
+  /* Now initializes the PORT settings.                                       */
+  {
+    port_pin_config_t portCfg;
+
+    if(direction == myGpioDir_Inpt)
+    {
+      switch(pull)
+      {
+        case myGpioPull_Dw: { portCfg.pullSelect = kPORT_PullDown;    } break;
+        case myGpioPull_Up: { portCfg.pullSelect = kPORT_PullUp;      } break;
+        default:            { portCfg.pullSelect = kPORT_PullDisable; } break;
+      }
+    }
+    else
+    {
+      portCfg.pullSelect = kPORT_PullDisable;
+    }
+
+    portCfg.slewRate = kPORT_SlowSlewRate;
+    portCfg.passiveFilterEnable = kPORT_PassiveFilterDisable;
+    portCfg.driveStrength = kPORT_LowDriveStrength;
+    portCfg.mux = kPORT_MuxAsGpio;
+
+    PORT_SetPinConfig(myGpio_PORTs[port], pin, &portCfg);
+  }
+}
+
+static myGpioIrqStruct_t * getIrqStruct(uint8_t port)
+{
+  myGpioIrqStruct_t * strc;
+
+  switch(port)
+  {
+    case myDriverPort_PTA: { strc = &myGpio_IrqA; } break;
+    case myDriverPort_PTD: { strc = &myGpio_IrqD; } break;
+    default:               { strc = NULL;         } break;
+  }
+
+  return strc;
+}
+
+static void configureIrq(uint8_t port, uint32_t pin, myGpioIrq_t irq, myCbk_t cbk)
+{
+  myGpioIrqStruct_t * strc = getIrqStruct(port);
+  port_interrupt_t config;
+
+  switch(irq)
+  {
+    case myGpioIrq_Rise: { config = kPORT_InterruptRisingEdge;  } break;
+    case myGpioIrq_Fall: { config = kPORT_InterruptFallingEdge; } break;
+    case myGpioIrq_Both: { config = kPORT_InterruptEitherEdge;  } break;
+    case myGpioIrq_Low:  { config = kPORT_InterruptLogicZero;   } break;
+    default:             { config = kPORT_InterruptLogicOne;    } break;
+  }
+
+  /* The callback is in place before the pin can fire, so that the routine    */
+  /*  never finds a flag without its callback.                                */
+  strc->cbks[pin] = cbk;
+
+  PORT_ClearPinsInterruptFlags(strc->PORT, (1UL << pin));
+  PORT_SetPinInterruptConfig(strc->PORT, pin, config);
+  EnableIRQ(strc->irqn);
+}
+
+static void dispatchIrq(myGpioIrqStruct_t * strc)
+{
+  uint32_t flags = PORT_GetPinsInterruptFlags(strc->PORT);
+  uint32_t pin;
+
+  /* All the flags read are cleared at once, before calling anyone back, so   */
+  /*  that an edge coming while the callbacks run fires the routine again.    */
+  PORT_ClearPinsInterruptFlags(strc->PORT, flags);
+
+  /* Only the pins that fired are visited, highest first.                     */
+  while(flags != 0)
+  {
+    pin = MY_HIGHEST_BIT(flags);
+    flags &= ~(1UL << pin);
+
+    if(strc->cbks[pin] != NULL) { strc->cbks[pin](); }
+  }
+}
+
+/*******************************************************************************
+ *  INTERRUPT ROUTINES
+ ******************************************************************************/
+void PORTA_IRQHandler(void)
+{
+  dispatchIrq(&myGpio_IrqA);
+}
+
+void PORTD_IRQHandler(void)
+{
+  dispatchIrq(&myGpio_IrqD);
+}
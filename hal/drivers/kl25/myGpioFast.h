@@ -0,0 +1,149 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file myGpioFast.h
+ * @brief Header file for the compile-time resolved gpio fast path of KL25
+ *          devices.
+ *
+ * The routines below are inlined wherever they are called, and take the port
+ *  and the pin as constants, so the compiler resolves the register address
+ *  and the pin mask while building. Setting, clearing or toggling a pin then
+ *  comes down to a single store, with no call, no handle and no checks.
+ *  They are meant for hot paths, such as bit-banging, while myGpio_Init and
+ *  the handle based routines remain for everything else.
+ *
+ * The pin must have been initialized with myGpio_Init beforehand. Passing a
+ *  port or a pin that is not a constant still works, but loses the point.
+ *
+ * With DRIVER_GPIO_USE_FGPIO set, these routines and the driver itself reach
+ *  the pins through the IOPORT alias of the gpio registers (FGPIO), which
+ *  the core accesses in a single cycle, instead of through the peripheral
+ *  bridge, which takes a few wait states on each access.
+ */
+
+#ifndef MY_GPIO_FAST_H
+#define MY_GPIO_FAST_H
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "myGpio.h"
+#include "myDriverDefs.h"
+#include "projConfig.h"
+
+#include "fsl_gpio.h"
+
+/*******************************************************************************
+ *  PUBLIC DEFINITIONS
+ ******************************************************************************/
+/* Set below whether the pins are accessed through the FGPIO alias.           */
+#ifndef DRIVER_GPIO_USE_FGPIO
+  #define DRIVER_GPIO_USE_FGPIO                                                0
+#endif
+
+/* Both aliases have the same register layout, only their addresses differ.   */
+#if DRIVER_GPIO_USE_FGPIO
+  typedef FGPIO_Type myGpioFastRegs_t;
+  #define MY_GPIO_FAST_REGS(PORT)                                    FGPIO##PORT
+#else
+  typedef GPIO_Type myGpioFastRegs_t;
+  #define MY_GPIO_FAST_REGS(PORT)                                     GPIO##PORT
+#endif
+
+/* Forces the routines below to be inlined, even when optimizations are off.  */
+#define MY_GPIO_FAST_INLINE         static inline __attribute__((always_inline))
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES
+ ******************************************************************************/
+/**
+ * @brief Gets the registers of a port. Being inlined with a constant port,
+ *          the switch below is resolved while building.
+ * @param port Port to get the registers of.
+ * @return Registers of the port.
+ */
+MY_GPIO_FAST_INLINE myGpioFastRegs_t * myGpioFast_Base(myDriverPort_t port)
+{
+  myGpioFastRegs_t * base;
+
+  switch(port)
+  {
+    case myDriverPort_PTA: { base = MY_GPIO_FAST_REGS(A); } break;
+    case myDriverPort_PTB: { base = MY_GPIO_FAST_REGS(B); } break;
+    case myDriverPort_PTC: { base = MY_GPIO_FAST_REGS(C); } break;
+    case myDriverPort_PTD: { base = MY_GPIO_FAST_REGS(D); } break;
+    default:               { base = MY_GPIO_FAST_REGS(E); } break;
+  }
+
+  return base;
+}
+
+/**
+ * @brief Sets an output pin to high level, with a single store to PSOR.
+ * @param port Port of the pin.
+ * @param pin Pin to set.
+ */
+MY_GPIO_FAST_INLINE void myGpioFast_Set(myDriverPort_t port, myDriverPin_t pin)
+{
+  myGpioFast_Base(port)->PSOR = (1UL << pin);
+}
+
+/**
+ * @brief Sets an output pin to low level, with a single store to PCOR.
+ * @param port Port of the pin.
+ * @param pin Pin to clear.
+ */
+MY_GPIO_FAST_INLINE void myGpioFast_Clear(myDriverPort_t port, myDriverPin_t pin)
+{
+  myGpioFast_Base(port)->PCOR = (1UL << pin);
+}
+
+/**
+ * @brief Toggles the level of an output pin, with a single store to PTOR.
+ * @param port Port of the pin.
+ * @param pin Pin to toggle.
+ */
+MY_GPIO_FAST_INLINE void myGpioFast_Toggle(myDriverPort_t port, myDriverPin_t pin)
+{
+  myGpioFast_Base(port)->PTOR = (1UL << pin);
+}
+
+/**
+ * @brief Sets the level of an output pin. With a constant level, it is the
+ *          same as myGpioFast_Set or myGpioFast_Clear.
+ * @param port Port of the pin.
+ * @param pin Pin to write.
+ * @param lvl Level to set the pin to.
+ */
+MY_GPIO_FAST_INLINE void myGpioFast_Write(myDriverPort_t port, myDriverPin_t pin, myGpioLvl_t lvl)
+{
+  if(lvl == myGpioLvl_Lo) { myGpioFast_Clear(port, pin); }
+  else                    { myGpioFast_Set(port, pin);   }
+}
+
+/**
+ * @brief Gets the level of a pin, with a single load from PDIR.
+ * @param port Port of the pin.
+ * @param pin Pin to get the level from.
+ * @return Current level.
+ */
+MY_GPIO_FAST_INLINE myGpioLvl_t myGpioFast_Get(myDriverPort_t port, myDriverPin_t pin)
+{
+  return ((myGpioFast_Base(port)->PDIR >> pin) & 1UL) ? myGpioLvl_Hi : myGpioLvl_Lo;
+}
+
+#endif
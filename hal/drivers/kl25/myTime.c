@@ -0,0 +1,223 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file myTime.c
+ * @brief Source file for the system time driver, KL25 microcontrollers.
+ *
+ * The time is kept by the SysTick, which counts the core clock down along its
+ *  24 bits, and by its interrupt, which extends it in software by adding the
+ *  length of each wrap to a 64-bit base. Wraps are not a whole amount of us,
+ *  so their lengths are taken from a period accumulator and the base never
+ *  drifts.
+ *
+ * Readers never disable interrupts. Instead, the interrupt bumps a sequence
+ *  counter on each wrap, and a reader simply starts over if the counter
+ *  changed while it was reading. The SysTick has the highest priority, so it
+ *  is never preempted by a reader: readers that run on top of it (or with
+ *  interrupts masked) see a pending wrap and account for it themselves.
+ *
+ * The timer driver may set shorter wraps through myTime_SetTick, to use the
+ *  SysTick interrupt as a periodic timer. The time goes on all the same, as
+ *  each wrap just adds its own length to the base.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "myTime.h"
+#include "myTime_Tick.h"
+#include "projConfig.h"
+
+#include "fsl_clock.h"
+#include "fsl_common.h"
+
+#include "myPeriod.h"
+
+#include "myAssert.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define DRIVER_TIME_US_PER_SECOND                                      (1000000)
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static volatile uint32_t myTime_Seq = 0;
+static volatile uint64_t myTime_BaseUs = 0;
+static volatile uint32_t myTime_WrapUs = 0;
+static myPeriod_t myTime_Wrap;
+static uint64_t myTime_UsPerCount = 0;
+static volatile uint32_t myTime_WrapCounts = MY_TIME_TICK_MAX_COUNTS;
+static uint32_t myTime_ClockHz = 0;
+static myCbk_t myTime_TickCbk = NULL;
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES
+ ******************************************************************************/
+/**
+ * @brief Initialization routine for the system time. It should be called once,
+ *          after the clocks are configured, since the clock frequency is
+ *          captured here.
+ */
+void myTime_Init(void)
+{
+  const uint32_t clock = CLOCK_GetCoreSysClkFreq();
+
+  /* The fixed-point conversion in myTime_Now needs a count to be no longer   */
+  /*  than a us, and no shorter than 1/256 us.                                */
+  myASSERT((clock >= DRIVER_TIME_US_PER_SECOND) && (clock <= (DRIVER_TIME_US_PER_SECOND << 8)));
+
+  SysTick->CTRL = 0;
+
+  /* This is the only division: from here on, counts are turned into us with  */
+  /*  a 32.32 fixed-point multiplication. It is rounded up so that whole us   */
+  /*  come out exact, and what it adds stays below 1/256 us over a wrap.      */
+  myTime_UsPerCount = (((uint64_t)DRIVER_TIME_US_PER_SECOND << 32) + clock - 1) / clock;
+  myTime_ClockHz = clock;
+  myTime_WrapCounts = MY_TIME_TICK_MAX_COUNTS;
+  myTime_TickCbk = NULL;
+  myPeriod_Init(&myTime_Wrap, (uint64_t)MY_TIME_TICK_MAX_COUNTS * DRIVER_TIME_US_PER_SECOND, clock);
+  myTime_BaseUs = 0;
+  myTime_WrapUs = myPeriod_Next(&myTime_Wrap);
+  myTime_Seq++;
+
+  NVIC_SetPriority(SysTick_IRQn, 0);
+  SysTick->LOAD = MY_TIME_TICK_MAX_COUNTS - 1;
+  SysTick->VAL = 0;
+  SCB->ICSR = SCB_ICSR_PENDSTCLR_Msk;
+  SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk;
+}
+
+/**
+ * @brief Gets the current system time.
+ *
+ * It is lock-free: interrupts are never disabled, so it can be called from
+ *  any context, including interrupt routines.
+ *
+ * @return Time, in us, since myTime_Init was called.
+ */
+uint64_t myTime_Now(void)
+{
+  uint64_t result;
+  uint32_t seq, counts, wrap;
+
+  do
+  {
+    seq = myTime_Seq;
+    result = myTime_BaseUs;
+    wrap = myTime_WrapCounts;
+    counts = SysTick->VAL;
+
+    /* The counter may have wrapped without its interrupt being handled yet,  */
+    /*  either because it is about to be or because it can't preempt us. Then */
+    /*  the wrap is added here, and the counter is read again to be sure that */
+    /*  it is the one after the wrap.                                         */
+    if((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) != 0)
+    {
+      result += myTime_WrapUs;
+      counts = SysTick->VAL;
+    }
+  } while(seq != myTime_Seq);
+
+  /* The counter goes down and wraps when it reaches zero, so that is where   */
+  /*  each wrap starts. A count is at least 1/256 us below 256 MHz, so even   */
+  /*  the last one of a wrap never reaches the us where the next wrap starts  */
+  /*  and the time can't go back.                                             */
+  counts = (counts == 0) ? 0 : (wrap - counts);
+  result += ((uint64_t)counts * myTime_UsPerCount) >> 32;
+
+  return result;
+}
+
+/**
+ * @brief Sets the length of the SysTick wraps, and a callback for them.
+ * @param counts Length of each wrap, in core clock counts, up to
+ *          MY_TIME_TICK_MAX_COUNTS. Zero brings back the default one.
+ * @param cbk Callback to be called on each wrap. NULL for none.
+ */
+void myTime_SetTick(uint32_t counts, myCbk_t cbk)
+{
+  uint32_t primask;
+  uint64_t now;
+
+  if(counts == 0) { counts = MY_TIME_TICK_MAX_COUNTS; }
+  myASSERT(counts <= MY_TIME_TICK_MAX_COUNTS);
+
+  /* The SysTick is stopped while the time is read, so that the wrap that is  */
+  /*  cut short ends right there, and the new ones start from that time. What */
+  /*  is below a us is dropped, which is all that this costs to the time.     */
+  primask = DisableGlobalIRQ();
+  SysTick->CTRL = 0;
+  now = myTime_Now();
+  SCB->ICSR = SCB_ICSR_PENDSTCLR_Msk;
+
+  myPeriod_Init(&myTime_Wrap, (uint64_t)counts * DRIVER_TIME_US_PER_SECOND, myTime_ClockHz);
+  myTime_BaseUs = now;
+  myTime_WrapCounts = counts;
+  myTime_WrapUs = myPeriod_Next(&myTime_Wrap);
+  myTime_TickCbk = cbk;
+  myTime_Seq++;
+
+  SysTick->LOAD = counts - 1;
+  SysTick->VAL = 0;
+  SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk;
+  EnableGlobalIRQ(primask);
+}
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES - TEST PURPOSES
+ ******************************************************************************/
+#ifdef TEST
+/**
+ * @brief Resets driver's internal logic and its variables.
+ */
+void myTime_Reset(void)
+{
+  myTime_Seq = 0;
+  myTime_BaseUs = 0;
+  myTime_WrapUs = 0;
+  myTime_Wrap = (myPeriod_t) { 0 };
+  myTime_UsPerCount = 0;
+  myTime_WrapCounts = MY_TIME_TICK_MAX_COUNTS;
+  myTime_ClockHz = 0;
+  myTime_TickCbk = NULL;
+}
+#endif
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+
+/*******************************************************************************
+ *  INTERRUPT ROUTINES
+ ******************************************************************************/
+void SysTick_Handler(void)
+{
+  /* Readers can't preempt this routine, so the sequence only needs to change */
+  /*  once for them to notice that they were preempted by it.                 */
+  myTime_BaseUs += myTime_WrapUs;
+  myTime_WrapUs = myPeriod_Next(&myTime_Wrap);
+  myTime_Seq++;
+
+  if(myTime_TickCbk != NULL) { myTime_TickCbk(); }
+}
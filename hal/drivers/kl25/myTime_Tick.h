@@ -0,0 +1,61 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file myTime_Tick.h
+ * @brief Header file for KL25 time driver submodule for sharing the SysTick.
+ *
+ * The SysTick keeps the system time, so it can't be handed over to anything
+ *  else. Still, the length of its wraps is free, so the routine below lets
+ *  the timer driver pick one of its own and be called back on each wrap.
+ */
+
+#ifndef MY_TIME_TICK_H
+#define MY_TIME_TICK_H
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "myDefs.h"
+
+/*******************************************************************************
+ *  PUBLIC DEFINITIONS
+ ******************************************************************************/
+/**
+ * @brief Longest wrap that the SysTick can count, in core clock counts. It is
+ *          also the one that the system time uses by default.
+ */
+#define MY_TIME_TICK_MAX_COUNTS                                      (1UL << 24)
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES
+ ******************************************************************************/
+/**
+ * @brief Sets the length of the SysTick wraps, and a callback for them.
+ *
+ * The system time goes on from where it was, through the new wraps. The
+ *  wrap that was running is cut short, so the callback is first called one
+ *  whole wrap after this routine. It runs from the SysTick interrupt, which
+ *  has the highest priority.
+ *
+ * @param counts Length of each wrap, in core clock counts, up to
+ *          MY_TIME_TICK_MAX_COUNTS. Zero brings back the default one.
+ * @param cbk Callback to be called on each wrap. NULL for none.
+ */
+void myTime_SetTick(uint32_t counts, myCbk_t cbk);
+
+#endif
@@ -28,9 +28,17 @@
 #include "projConfig.h"
 
 #include "fsl_tpm.h"
+#include "fsl_pit.h"
+#include "fsl_port.h"
 #include "fsl_clock.h"
 #include "fsl_common.h"
 #include "myTimer_TPM.h"
+#include "myTime_Tick.h"
+#include "myDriverDefs.h"
+
+#include "myWheel.h"
+#include "myPeriod.h"
+#include "mySplit.h"
 
 #include "myAssert.h"
 #include "myMacros.h"
@@ -41,8 +49,29 @@
 /* The structure below holds all the items related to a timer instance.       */
 typedef struct
 {
+  myTimerRes_t resource;
+  myTimerMode_t mode;
   TPM_Type * TPM;
+  IRQn_Type IRQ;
   myCbk_t cbk;
+  myPeriod_t period;
+  mySplit_t split;
+  tpm_clock_prescale_t prescale;
+  uint32_t periodMs;
+  uint32_t clockHz;
+  bool running;
+  uint32_t baseMs;
+  volatile uint32_t overflows;
+  uint32_t doneCounts;
+  uint32_t segment;
+  uint32_t nextSegment;
+  myWheelNode_t node;
+  uint32_t startTick;
+  tpm_chnl_t chnl;
+  pit_chnl_t pitChnl;
+  uint32_t counts;
+  uint16_t duty;
+  myRing_t * ring;
 } myTimerStruct_t;
 
 /* The enumeration below lists all the TPMs that are available to use.        */
@@ -54,12 +83,93 @@ typedef enum
   myTimer_TPM_Count, /* Not an item! For counting only.                       */
 } myTimerTPMs_t;
 
+/* The enumeration below lists the PIT channels that are available to use.    */
+/*  Channel 1 can be chained to channel 0, for a single 64-bit counter.       */
+typedef enum
+{
+  myTimer_PIT0 = 0,
+  myTimer_PIT1,
+  myTimer_PIT_Count, /* Not an item! For counting only.                       */
+} myTimerPITs_t;
+
+/* The structure below holds where each timer channel is: its TPM and         */
+/*  channel, and the pin that the channel is routed to.                       */
+typedef struct
+{
+  myTimerTPMs_t TPM;
+  tpm_chnl_t chnl;
+  myDriverPort_t port;
+  myDriverPin_t pin;
+  port_mux_t mux;
+} myTimerChannel_t;
+
 #define TPM_CLK_SEL_OSCERCLK_CLK                                              2U  /* TPM clock select: OSCERCLK clock */
 
+/* The TPM prescaler divides the clock by 2^PS. Each period is counted with   */
+/*  the smallest one that fits it, for the best resolution. Free-running      */
+/*  timers always use the largest one, so that they overflow less often.      */
+#define DRIVER_TIMER_MAX_PRESCALE                       kTPM_Prescale_Divide_128
+
+/* TPM counters are 16 bits wide.                                             */
+#define DRIVER_TIMER_MAX_COUNTS                                          0x10000
+
+/* Limit of period (ms) * clock (Hz) that a timer can be started with.        */
+#define DRIVER_TIMER_MAX_PERIOD          ((1000ULL << DRIVER_TIMER_MAX_PRESCALE) << 32)
+
+/* Set below the maximum amount of virtual timers that the driver can handle. */
+/*  All of them share a single TPM, which is taken at the first virtual init. */
+#ifndef DRIVER_TIMER_VIRTUAL_AMOUNT
+  #define DRIVER_TIMER_VIRTUAL_AMOUNT                                         16
+#endif
+
+/* Period, in ms, of the tick that drives the virtual timers.                 */
+#define DRIVER_TIMER_WHEEL_TICK_MS                                             1
+
+/* Limit of the time, in clock cycles * 1000, that the tick can be stopped    */
+/*  for. It is the longest that fits a single overflow of the TPM.            */
+#define DRIVER_TIMER_IDLE_MAX       (((DRIVER_TIMER_MAX_COUNTS - 1ULL) << DRIVER_TIMER_MAX_PRESCALE) * 1000)
+
+/* Limit of period (ms) * clock (Hz) that a PIT timer can be started with, as */
+/*  the counts of its period must fit the 32 bits of a channel.               */
+#define DRIVER_TIMER_PIT_MAX_PERIOD                              (1000ULL << 32)
+
+/* Limit of period (ms) * clock (Hz) that the SysTick timer can be started    */
+/*  with, as the counts of its period must fit a single wrap.                 */
+#define DRIVER_TIMER_SYSTICK_MAX_PERIOD (1000ULL * (MY_TIME_TICK_MAX_COUNTS + 1))
+
 /*******************************************************************************
  *  PRIVATE PROTOTYPES
  ******************************************************************************/
+static myRet_t myTimer_InitDedicated(myTimer_t * timer, myTimerMode_t mode);
+static myRet_t myTimer_InitVirtual(myTimer_t * timer, myTimerMode_t mode);
+static myRet_t myTimer_InitPwm(myTimer_t * timer, uint8_t channel);
+static myRet_t myTimer_InitCapture(myTimer_t * timer, myTimerPars_t * pars);
+static myRet_t myTimer_InitPit(myTimer_t * timer, myTimerMode_t mode);
+static myRet_t myTimer_InitSysTick(myTimer_t * timer, myTimerMode_t mode);
+static myTimerStruct_t * myTimer_Take(myTimerTPMs_t thisTPM, myTimerMode_t mode);
+static myTimerStruct_t * myTimer_TakeChannel(uint8_t channel, myTimerMode_t mode);
+static myRet_t myTimer_StartDedicated(myTimerStruct_t * strc, uint32_t period);
+static myRet_t myTimer_StartPwm(myTimerStruct_t * strc, uint32_t period);
+static myRet_t myTimer_StartCapture(myTimerStruct_t * strc, myCbk_t cbk);
+static myRet_t myTimer_StartPit(myTimerStruct_t * strc, uint32_t period);
+static myRet_t myTimer_StartSysTick(myTimerStruct_t * strc, uint32_t period);
+static uint32_t myTimer_GetDutyCounts(myTimerStruct_t * strc);
+static void myTimer_StartIdle(myTimerStruct_t * strc, myTimerMode_t mode, uint64_t cycles);
+static void myTimer_Program(myTimerStruct_t * strc);
+static void myTimer_SetPeriod(myTimerStruct_t * strc, uint32_t period);
+static void myTimer_SetPrescale(myTimerStruct_t * strc);
+static void myTimer_Restart(myTimerStruct_t * strc);
+static uint32_t myTimer_GetLeft(myTimerStruct_t * strc);
+static void myTimer_CatchUp(uint32_t ticks);
+static void myTimer_IdleWake(void);
+static uint32_t myTimer_GetElapsedDedicated(myTimerStruct_t * strc);
+static uint32_t myTimer_GetElapsedPit(myTimerStruct_t * strc);
+static void myTimer_UpdateScale(void);
+static void myTimer_UpdatePitScale(void);
+static void myTimer_UpdateSysTickScale(void);
+static bool myTimer_Capture(myTimerStruct_t * strc);
 static void myTimer_Interrupt(myTimerTPMs_t source);
+static void myTimer_PitInterrupt(myTimerPITs_t source);
 
 /*******************************************************************************
  *  PRIVATE VARIABLES
@@ -69,7 +179,70 @@ static const uint32_t myTimer_TPMCnt = MY_ARRAY_SIZE(myTimer_TPMs);
 static const IRQn_Type myTimer_IRQs[] = TPM_IRQS;
 
 static myTimerStruct_t myTimer_Struct[myTimer_TPM_Count];
-static myTimerTPMs_t myTimer_NextTPM = myTimer_TPM0;
+static uint32_t myTimer_Taken = 0;
+
+static PORT_Type * const myTimer_PORTs[] = PORT_BASE_PTRS;
+static const clock_ip_name_t myTimer_PortClocks[] = { kCLOCK_PortA, kCLOCK_PortB, kCLOCK_PortC, kCLOCK_PortD, kCLOCK_PortE };
+
+static const myTimerChannel_t myTimer_Channels[] =
+{
+  [myDriverTimerCh_TPM2_CH0_PTB18] = { myTimer_TPM2, kTPM_Chnl_0, myDriverPort_PTB, myDriverPin_18, kPORT_MuxAlt3 },
+  [myDriverTimerCh_TPM2_CH1_PTB19] = { myTimer_TPM2, kTPM_Chnl_1, myDriverPort_PTB, myDriverPin_19, kPORT_MuxAlt3 },
+  [myDriverTimerCh_TPM0_CH1_PTD1]  = { myTimer_TPM0, kTPM_Chnl_1, myDriverPort_PTD, myDriverPin_01, kPORT_MuxAlt4 },
+  [myDriverTimerCh_TPM0_CH0_PTD0]  = { myTimer_TPM0, kTPM_Chnl_0, myDriverPort_PTD, myDriverPin_00, kPORT_MuxAlt4 },
+  [myDriverTimerCh_TPM0_CH2_PTD2]  = { myTimer_TPM0, kTPM_Chnl_2, myDriverPort_PTD, myDriverPin_02, kPORT_MuxAlt4 },
+  [myDriverTimerCh_TPM0_CH3_PTD3]  = { myTimer_TPM0, kTPM_Chnl_3, myDriverPort_PTD, myDriverPin_03, kPORT_MuxAlt4 },
+  [myDriverTimerCh_TPM1_CH0_PTA12] = { myTimer_TPM1, kTPM_Chnl_0, myDriverPort_PTA, myDriverPin_12, kPORT_MuxAlt3 },
+  [myDriverTimerCh_TPM1_CH1_PTA13] = { myTimer_TPM1, kTPM_Chnl_1, myDriverPort_PTA, myDriverPin_13, kPORT_MuxAlt3 },
+};
+static const uint32_t myTimer_ChannelCnt = MY_ARRAY_SIZE(myTimer_Channels);
+
+static const tpm_input_capture_edge_t myTimer_Edges[] =
+{
+  [myTimerEdge_Rise] = kTPM_RisingEdge,
+  [myTimerEdge_Fall] = kTPM_FallingEdge,
+  [myTimerEdge_Both] = kTPM_RiseAndFallEdge,
+};
+
+static myTimerStruct_t myTimer_VirtualStruct[DRIVER_TIMER_VIRTUAL_AMOUNT];
+static uint32_t myTimer_NextVirtual = 0;
+static myTimerStruct_t * myTimer_WheelTimer = NULL;
+
+/* PIT channels and the SysTick are handed out like the TPMs, one timer each, */
+/*  but they count other clocks: the bus clock and the core clock. Their      */
+/*  scales are only kept while they are taken.                                */
+static myTimerStruct_t myTimer_PitStruct[myTimer_PIT_Count];
+static uint32_t myTimer_PitTaken = 0;
+static uint32_t myTimer_PitHz = 0;
+static myPeriodScale_t myTimer_PitScale;
+
+static myTimerStruct_t myTimer_SysTickStruct;
+static bool myTimer_SysTickTaken = false;
+static uint32_t myTimer_CoreHz = 0;
+static myPeriodScale_t myTimer_CoreScale;
+
+/* While idle, the wheel timer stops ticking and counts the whole sleep at    */
+/*  once. The times below are in clock cycles * 1000, the unit that periods   */
+/*  are set up with, and they are measured from the start of the tick that    */
+/*  was running when the system went idle.                                    */
+static bool myTimer_Idle = false;
+static uint64_t myTimer_IdleElapsed;
+static uint64_t myTimer_IdleSleep;
+
+/* Cached scales from ms to TPM counts, undivided and at the largest          */
+/*  prescaler, so that starting a timer takes no division, as the M0+ core    */
+/*  has no hardware divider. They are refreshed at init and on clock updates, */
+/*  unless DRIVER_TIMER_CLOCK_HZ is set to a fixed OSCERCLK frequency, in     */
+/*  which case they are computed at compile time.                             */
+#ifdef DRIVER_TIMER_CLOCK_HZ
+static const uint32_t myTimer_ClockHz = DRIVER_TIMER_CLOCK_HZ;
+static const myPeriodScale_t myTimer_Scale = MY_PERIOD_SCALE(DRIVER_TIMER_CLOCK_HZ, 1000);
+static const myPeriodScale_t myTimer_MaxScale = MY_PERIOD_SCALE(DRIVER_TIMER_CLOCK_HZ, 1000 << DRIVER_TIMER_MAX_PRESCALE);
+#else
+static uint32_t myTimer_ClockHz = 0;
+static myPeriodScale_t myTimer_Scale;
+static myPeriodScale_t myTimer_MaxScale;
+#endif
 
 /*******************************************************************************
  *  PUBLIC FUNCTIONS / ROUTINES
@@ -88,38 +261,31 @@ myRet_t myTimer_Init(myTimer_t * timer, myTimerPars_t * pars)
 
   if((timer != NULL) && (pars != NULL))
   {
-    /* Only periodic mode is currently supported.                             */
-    myASSERT(pars->mode == myTimerMode_Periodic);
+    const myTimerMode_t mode = pars->mode;
 
-    if(pars->mode == myTimerMode_Periodic)
-    {
-      /* Proceed with initialization only if there is a TPM available.        */
-      const myTimerTPMs_t thisTPM = myTimer_NextTPM++;
+    myASSERT((mode == myTimerMode_Periodic) || (mode == myTimerMode_OneShot) || (mode == myTimerMode_FreeRunning) || (mode == myTimerMode_Pwm) || (mode == myTimerMode_Capture));
+    myASSERT((pars->resource == myTimerRes_Dedicated) || (pars->resource == myTimerRes_Virtual) || (pars->resource == myTimerRes_Pit) || (pars->resource == myTimerRes_SysTick));
 
-      myASSERT(myTimer_TPMCnt == myTimer_TPM_Count);
-      myASSERT(thisTPM < myTimer_TPMCnt);
-
-      if(thisTPM >= myTimer_TPMCnt) { myTimer_NextTPM--; }
-      else
+    /* PWM and capture timers use a channel of the TPM itself, so they are    */
+    /*  always dedicated ones.                                                */
+    if((mode == myTimerMode_Pwm) || (mode == myTimerMode_Capture))
+    {
+      myASSERT(pars->resource == myTimerRes_Dedicated);
+      if(pars->resource == myTimerRes_Dedicated)
       {
-        TPM_Type * const periph = myTimer_TPMs[thisTPM];
-        myTimerStruct_t * strc = &myTimer_Struct[thisTPM];
-        const IRQn_Type irq = myTimer_IRQs[thisTPM];
-        tpm_config_t config;
-
-        strc->TPM = periph;
-        strc->cbk = NULL;
-
-        TPM_GetDefaultConfig(&config);
-        config.prescale = kTPM_Prescale_Divide_128;
-        config.enableStopOnOverflow = false;
-        CLOCK_SetTpmClock(TPM_CLK_SEL_OSCERCLK_CLK);
-        TPM_Init(periph, &config);
-        TPM_EnableInterrupts(periph, kTPM_TimeOverflowInterruptEnable);
-        EnableIRQ(irq);
-
-        *timer = (myTimer_t) strc;
-        result = myRet_OK;
+        if(mode == myTimerMode_Pwm) { result = myTimer_InitPwm(timer, pars->channel); }
+        else                        { result = myTimer_InitCapture(timer, pars);     }
+      }
+    }
+    else if((mode == myTimerMode_Periodic) || (mode == myTimerMode_OneShot) || (mode == myTimerMode_FreeRunning))
+    {
+      switch(pars->resource)
+      {
+        case myTimerRes_Dedicated: { result = myTimer_InitDedicated(timer, mode); } break;
+        case myTimerRes_Virtual:   { result = myTimer_InitVirtual(timer, mode);   } break;
+        case myTimerRes_Pit:       { result = myTimer_InitPit(timer, mode);       } break;
+        case myTimerRes_SysTick:   { result = myTimer_InitSysTick(timer, mode);   } break;
+        default:                   {                                              } break;
       }
     }
   }
@@ -130,28 +296,120 @@ myRet_t myTimer_Init(myTimer_t * timer, myTimerPars_t * pars)
 /**
  * @brief Starts the time counting operation for a timer.
  * @param timer Timer to start the operation
- * @param period Time, in ms, to count
- * @param cbk Callback to be called when timer expires
+ * @param period Time, in ms, to count. Ignored by free-running and capture
+ *          timers. For PWM timers, it is the period of the output.
+ * @param cbk Callback to be called when timer expires. Ignored by
+ *          free-running and PWM timers. For capture timers, it is optional
+ *          and called when a timestamp is pushed into an empty ring, so that
+ *          the consumer is only woken up once for each batch.
  * @return Success / Failure. If successful, timer will start and callback
- *          will eventually be called.
+ *          will eventually be called. Periodic and one-shot timers fail
+ *          without a period or a callback, and PWM timers without a period.
+ *          Dedicated timers fail if the period is beyond what their
+ *          hardware can count, which is over 3 hours. PIT timers fail if it
+ *          does not fit 32 bits of the bus clock, which is over 170 s, and
+ *          the SysTick timer fails if it does not fit 24 bits of the core
+ *          clock, which is over 340 ms. PWM timers fail if the period does
+ *          not fit a single overflow of their hardware, which is over 170 ms.
  */
 myRet_t myTimer_Start(myTimer_t timer, uint32_t period, myCbk_t cbk)
 {
   myRet_t result = myRet_Fail;
+  myTimerStruct_t * strc = (myTimerStruct_t *) timer;
 
-  if((timer != NULL) && (period != 0) && (cbk != NULL))
+  if((strc != NULL) && (strc->mode == myTimerMode_Pwm))
+  {
+    if(period != 0) { result = myTimer_StartPwm(strc, period); }
+  }
+  else if((strc != NULL) && (strc->mode == myTimerMode_Capture))
+  {
+    result = myTimer_StartCapture(strc, cbk);
+  }
+  else if((strc != NULL) && ((strc->mode == myTimerMode_FreeRunning) || ((period != 0) && (cbk != NULL))))
+  {
+    if(strc->resource == myTimerRes_Virtual)
+    {
+      /* The wheel is only touched by the tick interrupt, so masking it is    */
+      /*  enough to keep it consistent while the timer is scheduled.          */
+      const uint32_t ticks = period / DRIVER_TIMER_WHEEL_TICK_MS;
+
+      DisableIRQ(myTimer_WheelTimer->IRQ);
+      switch(strc->mode)
+      {
+        case myTimerMode_Periodic:    { myWheel_Start(&strc->node, ticks, ticks, cbk); } break;
+        case myTimerMode_OneShot:     { myWheel_Start(&strc->node, ticks, 0, cbk);     } break;
+        case myTimerMode_FreeRunning: { strc->startTick = myWheel_GetTicks();         } break;
+        default:                      {                                               } break;
+      }
+      EnableIRQ(myTimer_WheelTimer->IRQ);
+
+      result = myRet_OK;
+    }
+    else
+    {
+      strc->cbk = (strc->mode == myTimerMode_FreeRunning) ? NULL : cbk;
+      switch(strc->resource)
+      {
+        case myTimerRes_Pit:     { result = myTimer_StartPit(strc, period);       } break;
+        case myTimerRes_SysTick: { result = myTimer_StartSysTick(strc, period);   } break;
+        default:                 { result = myTimer_StartDedicated(strc, period); } break;
+      }
+    }
+  }
+
+  return result;
+}
+
+/**
+ * @brief Stops the time counting operation for a timer.
+ * @param timer Timer to stop the operation
+ * @return Success / Failure. If successful, callback won't be called anymore
+ *          until the timer is started again.
+ */
+myRet_t myTimer_Stop(myTimer_t timer)
+{
+  myRet_t result = myRet_Fail;
+
+  if(timer != NULL)
   {
-    const uint32_t freq = CLOCK_GetOsc0ErClkFreq() / 128;
-    const uint32_t counts = MSEC_TO_COUNT(period, freq);
     myTimerStruct_t * strc = (myTimerStruct_t *) timer;
-    TPM_Type * const periph = strc->TPM;
 
-    strc->cbk = cbk;
+    if(strc->resource == myTimerRes_Virtual)
+    {
+      DisableIRQ(myTimer_WheelTimer->IRQ);
+      myWheel_Stop(&strc->node);
+      EnableIRQ(myTimer_WheelTimer->IRQ);
+    }
+    else if(strc->resource == myTimerRes_Pit)
+    {
+      /* A free-running timer counts with both channels, chained together.    */
+      PIT_StopTimer(PIT, strc->pitChnl);
+      if(strc->mode == myTimerMode_FreeRunning) { PIT_StopTimer(PIT, kPIT_Chnl_1); }
+      strc->periodMs = 0;
+      strc->running = false;
+    }
+    else if(strc->resource == myTimerRes_SysTick)
+    {
+      /* The SysTick can't stop, as it keeps the system time. It just goes    */
+      /*  back to its default wraps, with no callback.                        */
+      myTime_SetTick(0, NULL);
+      strc->periodMs = 0;
+      strc->running = false;
+    }
+    else
+    {
+      TPM_StopTimer(strc->TPM);
+      strc->periodMs = 0;
+      strc->running = false;
 
-    TPM_StopTimer(periph);
-    TPM_ClearCounter(periph);
-    TPM_SetTimerPeriod(periph, counts);
-    TPM_StartTimer(periph, kTPM_SystemClock);
+      /* A stopped TPM still latches edges, so the interrupt of a capture     */
+      /*  timer is masked too, and nothing else is pushed into its ring.      */
+      if(strc->mode == myTimerMode_Capture)
+      {
+        DisableIRQ(strc->IRQ);
+        strc->clockHz = 0;
+      }
+    }
 
     result = myRet_OK;
   }
@@ -159,6 +417,224 @@ myRet_t myTimer_Start(myTimer_t timer, uint32_t period, myCbk_t cbk)
   return result;
 }
 
+/**
+ * @brief Sets the duty cycle of a PWM timer. It can be called whether the
+ *          timer is running or not.
+ *
+ * In edge-aligned PWM mode the TPM buffers the channel value, and only loads
+ *  it when the counter wraps around, so the new duty cycle starts with the
+ *  next period. While the TPM is stopped it is loaded right away.
+ *
+ * @param timer PWM timer to set
+ * @param duty Share of the period that the output is active, from zero, for
+ *          never, up to MY_TIMER_DUTY_MAX, for always.
+ * @return Success / Failure. Fails if the timer is not a PWM one.
+ */
+myRet_t myTimer_SetDuty(myTimer_t timer, uint16_t duty)
+{
+  myRet_t result = myRet_Fail;
+  myTimerStruct_t * strc = (myTimerStruct_t *) timer;
+
+  if((strc != NULL) && (strc->mode == myTimerMode_Pwm))
+  {
+    strc->duty = duty;
+    if(strc->periodMs != 0)
+    {
+      TPM_SetChannelValue(strc->TPM, strc->chnl, myTimer_GetDutyCounts(strc));
+    }
+
+    result = myRet_OK;
+  }
+
+  return result;
+}
+
+/**
+ * @brief Gets the time elapsed since a free-running timer was started.
+ * @param timer Free-running timer to read
+ * @return Time, in ms, since the timer was started. Zero if the timer is not
+ *          a free-running one.
+ */
+uint32_t myTimer_GetElapsed(myTimer_t timer)
+{
+  uint32_t elapsed = 0;
+  myTimerStruct_t * strc = (myTimerStruct_t *) timer;
+
+  myASSERT(strc != NULL);
+
+  if((strc != NULL) && (strc->mode == myTimerMode_FreeRunning))
+  {
+    /* Wheel ticks are 1 ms long and the tick count is read atomically.       */
+    switch(strc->resource)
+    {
+      case myTimerRes_Virtual: { elapsed = myWheel_GetTicks() - strc->startTick; } break;
+      case myTimerRes_Pit:     { elapsed = myTimer_GetElapsedPit(strc);          } break;
+      default:                 { elapsed = myTimer_GetElapsedDedicated(strc);    } break;
+    }
+  }
+
+  return elapsed;
+}
+
+/**
+ * @brief Gets the rate of the timestamps of a capture timer.
+ *
+ * Timestamps are the counts of the hardware timer at full resolution,
+ *  extended to 32 bits with its overflows, so they wrap around at 2^32. The
+ *  time between two edges is the difference of their timestamps over the
+ *  rate, as long as it is shorter than a wrap around.
+ *
+ * @param timer Capture timer to read
+ * @return Counts per second of the timestamps since the timer was last
+ *          started. Zero if it is not a started capture timer.
+ */
+uint32_t myTimer_GetCaptureHz(myTimer_t timer)
+{
+  uint32_t rate = 0;
+  myTimerStruct_t * strc = (myTimerStruct_t *) timer;
+
+  myASSERT(strc != NULL);
+
+  if((strc != NULL) && (strc->mode == myTimerMode_Capture)) { rate = strc->clockHz; }
+
+  return rate;
+}
+
+/**
+ * @brief Refreshes the clock settings that the driver keeps. Should be called
+ *          whenever the clock configuration changes.
+ *
+ * Every running timer carries on with the new settings. Periodic and PWM
+ *  timers are restarted with their period, one-shot timers with the time they
+ *  had left, and free-running timers keep counting from the time they had
+ *  elapsed. Capture timers keep their timestamps, which just count at the new
+ *  rate from then on.
+ */
+void myTimer_ClockUpdate(void)
+{
+  myTimerTPMs_t thisTPM;
+  myTimerPITs_t thisPIT;
+
+  myTimer_UpdateScale();
+
+  /* The new clock may need another prescaler, which can only be changed      */
+  /*  with the TPM stopped, so running timers are restarted.                  */
+  for(thisTPM = myTimer_TPM0; thisTPM < myTimer_TPM_Count; thisTPM++)
+  {
+    myTimerStruct_t * const strc = &myTimer_Struct[thisTPM];
+
+    if(((myTimer_Taken & (1UL << thisTPM)) != 0) && strc->running) { myTimer_Restart(strc); }
+  }
+
+  /* PIT channels and the SysTick have no prescaler, but their periods are    */
+  /*  counted in another amount of counts now, so they are restarted too.     */
+  if(myTimer_PitTaken != 0)
+  {
+    myTimer_UpdatePitScale();
+
+    for(thisPIT = myTimer_PIT0; thisPIT < myTimer_PIT_Count; thisPIT++)
+    {
+      myTimerStruct_t * const strc = &myTimer_PitStruct[thisPIT];
+
+      if(((myTimer_PitTaken & (1UL << thisPIT)) != 0) && strc->running) { myTimer_Restart(strc); }
+    }
+  }
+
+  if(myTimer_SysTickTaken)
+  {
+    myTimer_UpdateSysTickScale();
+    if(myTimer_SysTickStruct.running) { myTimer_StartSysTick(&myTimer_SysTickStruct, myTimer_SysTickStruct.periodMs); }
+  }
+}
+
+/**
+ * @brief Stops the tick of the virtual timers for as long as none of them
+ *          needs it. It should be called with interrupts masked.
+ * @return Time, in us, until the programmed wakeup. Zero if the tick was not
+ *          stopped.
+ */
+uint32_t myTimer_IdleEnter(void)
+{
+  myTimerStruct_t * const strc = myTimer_WheelTimer;
+  uint32_t sleepUs = 0;
+
+  /* The tick only stops if the next one has nothing to do. A realignment     */
+  /*  that is still pending from the last idle period must run first, too.    */
+  if((strc != NULL) && !myTimer_Idle)
+  {
+    const uint64_t tick = (uint64_t)DRIVER_TIMER_WHEEL_TICK_MS * strc->clockHz;
+    uint64_t ticks = myWheel_GetNextEvent();
+
+    if(ticks > 1)
+    {
+      /* The TPM is stopped before it is read, so that no tick can be lost    */
+      /*  in between. If one is already pending, it is served first.          */
+      TPM_StopTimer(strc->TPM);
+      if((TPM_GetStatusFlags(strc->TPM) & kTPM_TimeOverflowFlag) != 0)
+      {
+        TPM_StartTimer(strc->TPM, kTPM_SystemClock);
+      }
+      else
+      {
+        if(ticks > (DRIVER_TIMER_IDLE_MAX / tick)) { ticks = DRIVER_TIMER_IDLE_MAX / tick; }
+        myTimer_IdleElapsed = ((uint64_t)TPM_GetCurrentTimerCount(strc->TPM) << strc->prescale) * 1000;
+        myTimer_IdleSleep = (ticks * tick) - myTimer_IdleElapsed;
+        myTimer_Idle = true;
+
+        /* The sleep is counted as a periodic timer, so that the counter      */
+        /*  keeps going after it ends, until the system is up to read it.     */
+        strc->cbk = NULL;
+        myTimer_StartIdle(strc, myTimerMode_Periodic, myTimer_IdleSleep);
+        sleepUs = (uint32_t)((myTimer_IdleSleep * 1000) / strc->clockHz);
+      }
+    }
+  }
+
+  return sleepUs;
+}
+
+/**
+ * @brief Brings back the tick of the virtual timers after the system woke up.
+ *          It should be called before interrupts are unmasked.
+ */
+void myTimer_IdleExit(void)
+{
+  myTimerStruct_t * const strc = myTimer_WheelTimer;
+
+  if((strc != NULL) && myTimer_Idle && (strc->mode == myTimerMode_Periodic))
+  {
+    const uint64_t tick = (uint64_t)DRIVER_TIMER_WHEEL_TICK_MS * strc->clockHz;
+    uint64_t elapsed = myTimer_IdleElapsed;
+    uint64_t rest;
+    uint32_t ticks;
+
+    /* The sleep may have ended already, or the system may have been woken    */
+    /*  up earlier by something else. If the counter wrapped around, the      */
+    /*  whole sleep went by before what it counts now.                        */
+    TPM_StopTimer(strc->TPM);
+    if((TPM_GetStatusFlags(strc->TPM) & kTPM_TimeOverflowFlag) != 0)
+    {
+      elapsed += myTimer_IdleSleep;
+    }
+    elapsed += ((uint64_t)TPM_GetCurrentTimerCount(strc->TPM) << strc->prescale) * 1000;
+
+    /* The ticks that went by are caught up at once, and the TPM is set to    */
+    /*  expire at the next tick boundary, where the regular tick restarts.    */
+    /*  A boundary closer than a single count is left for the next tick.      */
+    ticks = (uint32_t)(elapsed / tick);
+    rest = ((ticks + 1) * tick) - elapsed;
+    if(rest < 1000)
+    {
+      ticks++;
+      rest += tick;
+    }
+
+    strc->cbk = myTimer_IdleWake;
+    myTimer_StartIdle(strc, myTimerMode_OneShot, rest);
+    myTimer_CatchUp(ticks);
+  }
+}
+
 /*******************************************************************************
  *  PUBLIC FUNCTIONS / ROUTINES - TEST PURPOSES
  ******************************************************************************/
@@ -168,19 +644,829 @@ myRet_t myTimer_Start(myTimer_t timer, uint32_t period, myCbk_t cbk)
  */
 void myTimer_Reset(void)
 {
-  myTimer_NextTPM = myTimer_TPM0;
+  myTimer_Taken = 0;
+  myTimer_NextVirtual = 0;
+  myTimer_WheelTimer = NULL;
+  myTimer_Idle = false;
+  myTimer_PitTaken = 0;
+  myTimer_SysTickTaken = false;
+  myWheel_Reset();
 }
 #endif
 
 /*******************************************************************************
  *  PRIVATE FUNCTIONS / ROUTINES
  ******************************************************************************/
+static myRet_t myTimer_InitDedicated(myTimer_t * timer, myTimerMode_t mode)
+{
+  myRet_t result = myRet_Fail;
+  myTimerTPMs_t thisTPM = myTimer_TPM0;
+
+  myASSERT(myTimer_TPMCnt == myTimer_TPM_Count);
+
+  /* Proceed with initialization only if there is a TPM available. They are   */
+  /*  taken in order, skipping the ones that channel timers took already.     */
+  while((thisTPM < myTimer_TPM_Count) && ((myTimer_Taken & (1UL << thisTPM)) != 0)) { thisTPM++; }
+
+  myASSERT(thisTPM < myTimer_TPM_Count);
+
+  if(thisTPM < myTimer_TPM_Count)
+  {
+    myTimerStruct_t * strc = myTimer_Take(thisTPM, mode);
+
+    TPM_EnableInterrupts(strc->TPM, kTPM_TimeOverflowInterruptEnable);
+    EnableIRQ(strc->IRQ);
+
+    *timer = (myTimer_t) strc;
+    result = myRet_OK;
+  }
+
+  return result;
+}
+
+static myRet_t myTimer_InitVirtual(myTimer_t * timer, myTimerMode_t mode)
+{
+  myRet_t result = myRet_Fail;
+
+  /* The first virtual timer takes a TPM to be the wheel's tick source.       */
+  if(myTimer_WheelTimer == NULL)
+  {
+    myTimer_t wheelTimer;
+
+    if(myTimer_InitDedicated(&wheelTimer, myTimerMode_Periodic) == myRet_OK)
+    {
+      myTimer_WheelTimer = (myTimerStruct_t *) wheelTimer;
+      myTimer_WheelTimer->cbk = myWheel_Tick;
+      myTimer_StartDedicated(myTimer_WheelTimer, DRIVER_TIMER_WHEEL_TICK_MS);
+    }
+  }
+
+  if(myTimer_WheelTimer != NULL)
+  {
+    /* Proceed with initialization only if there is a virtual timer left.     */
+    const uint32_t thisVirtual = myTimer_NextVirtual++;
+
+    myASSERT(thisVirtual < DRIVER_TIMER_VIRTUAL_AMOUNT);
+
+    if(thisVirtual >= DRIVER_TIMER_VIRTUAL_AMOUNT) { myTimer_NextVirtual--; }
+    else
+    {
+      myTimerStruct_t * strc = &myTimer_VirtualStruct[thisVirtual];
+
+      strc->resource = myTimerRes_Virtual;
+      strc->mode = mode;
+      strc->node = (myWheelNode_t) { 0 };
+
+      *timer = (myTimer_t) strc;
+      result = myRet_OK;
+    }
+  }
+
+  return result;
+}
+
+static myRet_t myTimer_InitPwm(myTimer_t * timer, uint8_t channel)
+{
+  myRet_t result = myRet_Fail;
+  myTimerStruct_t * strc = myTimer_TakeChannel(channel, myTimerMode_Pwm);
+
+  if(strc != NULL)
+  {
+    strc->duty = 0;
+
+    /* The channel is set up as an edge-aligned, high-true PWM, which starts  */
+    /*  each period with the output active until the counter reaches the      */
+    /*  channel value. The TPM raises no interrupt in this mode.              */
+    TPM_SetChannelPwm(strc->TPM, strc->chnl);
+    TPM_SetChannelValue(strc->TPM, strc->chnl, 0);
+
+    *timer = (myTimer_t) strc;
+    result = myRet_OK;
+  }
+
+  return result;
+}
+
+static myRet_t myTimer_InitCapture(myTimer_t * timer, myTimerPars_t * pars)
+{
+  myRet_t result = myRet_Fail;
+  myTimerStruct_t * strc = NULL;
+
+  myASSERT(pars->ring != NULL);
+  myASSERT(pars->edge < MY_ARRAY_SIZE(myTimer_Edges));
+
+  if((pars->ring != NULL) && (pars->edge < MY_ARRAY_SIZE(myTimer_Edges)))
+  {
+    strc = myTimer_TakeChannel(pars->channel, myTimerMode_Capture);
+  }
+
+  if(strc != NULL)
+  {
+    strc->ring = pars->ring;
+
+    /* The channel latches the counter into its value at each edge, and both  */
+    /*  the edges and the overflows interrupt, so that the timestamps can     */
+    /*  count the overflows too. The interrupt is only unmasked at start.     */
+    TPM_SetupInputCapture(strc->TPM, strc->chnl, myTimer_Edges[pars->edge]);
+    TPM_EnableInterrupts(strc->TPM, ((uint32_t)kTPM_Chnl0InterruptEnable << strc->chnl) | kTPM_TimeOverflowInterruptEnable);
+
+    *timer = (myTimer_t) strc;
+    result = myRet_OK;
+  }
+
+  return result;
+}
+
+static myRet_t myTimer_InitPit(myTimer_t * timer, myTimerMode_t mode)
+{
+  myRet_t result = myRet_Fail;
+  myTimerPITs_t thisPIT = myTimer_PIT0;
+  uint32_t taken;
+
+  /* Free-running timers chain both channels, so they need the whole PIT.     */
+  /*  Other timers take the first channel that is free.                       */
+  if(mode == myTimerMode_FreeRunning)
+  {
+    taken = (1UL << myTimer_PIT_Count) - 1;
+    if(myTimer_PitTaken != 0) { thisPIT = myTimer_PIT_Count; }
+  }
+  else
+  {
+    while((thisPIT < myTimer_PIT_Count) && ((myTimer_PitTaken & (1UL << thisPIT)) != 0)) { thisPIT++; }
+    taken = 1UL << thisPIT;
+  }
+
+  myASSERT(thisPIT < myTimer_PIT_Count);
+
+  if(thisPIT < myTimer_PIT_Count)
+  {
+    myTimerStruct_t * strc = &myTimer_PitStruct[thisPIT];
+
+    /* The PIT is set up by the first timer that takes any of its channels.   */
+    if(myTimer_PitTaken == 0)
+    {
+      pit_config_t config;
+
+      PIT_GetDefaultConfig(&config);
+      PIT_Init(PIT, &config);
+      myTimer_UpdatePitScale();
+    }
+    myTimer_PitTaken |= taken;
+
+    strc->resource = myTimerRes_Pit;
+    strc->mode = mode;
+    strc->pitChnl = (pit_chnl_t) thisPIT;
+    strc->cbk = NULL;
+    strc->periodMs = 0;
+    strc->clockHz = 0;
+    strc->running = false;
+
+    /* Channel 1 counts the wraps of channel 0 when they are chained, so a    */
+    /*  free-running timer counts through 64 bits and never interrupts.       */
+    if(mode == myTimerMode_FreeRunning)
+    {
+      PIT_SetTimerChainMode(PIT, kPIT_Chnl_1, true);
+    }
+    else
+    {
+      PIT_EnableInterrupts(PIT, strc->pitChnl, kPIT_TimerInterruptEnable);
+      EnableIRQ(PIT_IRQn);
+    }
+
+    *timer = (myTimer_t) strc;
+    result = myRet_OK;
+  }
+
+  return result;
+}
+
+static myRet_t myTimer_InitSysTick(myTimer_t * timer, myTimerMode_t mode)
+{
+  myRet_t result = myRet_Fail;
+
+  /* The SysTick keeps the system time, so it never stops and it only wraps   */
+  /*  periodically. That makes a single periodic timer out of it.             */
+  myASSERT(mode == myTimerMode_Periodic);
+  myASSERT(!myTimer_SysTickTaken);
+
+  if((mode == myTimerMode_Periodic) && !myTimer_SysTickTaken)
+  {
+    myTimerStruct_t * strc = &myTimer_SysTickStruct;
+
+    myTimer_SysTickTaken = true;
+
+    strc->resource = myTimerRes_SysTick;
+    strc->mode = mode;
+    strc->cbk = NULL;
+    strc->periodMs = 0;
+    strc->clockHz = 0;
+    strc->running = false;
+    myTimer_UpdateSysTickScale();
+
+    *timer = (myTimer_t) strc;
+    result = myRet_OK;
+  }
+
+  return result;
+}
+
+static myTimerStruct_t * myTimer_Take(myTimerTPMs_t thisTPM, myTimerMode_t mode)
+{
+  TPM_Type * const periph = myTimer_TPMs[thisTPM];
+  myTimerStruct_t * strc = &myTimer_Struct[thisTPM];
+  tpm_config_t config;
+
+  myTimer_Taken |= (1UL << thisTPM);
+
+  strc->resource = myTimerRes_Dedicated;
+  strc->mode = mode;
+  strc->TPM = periph;
+  strc->IRQ = myTimer_IRQs[thisTPM];
+  strc->cbk = NULL;
+  strc->periodMs = 0;
+  strc->clockHz = 0;
+  strc->running = false;
+
+  TPM_GetDefaultConfig(&config);
+  config.prescale = DRIVER_TIMER_MAX_PRESCALE;
+  CLOCK_SetTpmClock(TPM_CLK_SEL_OSCERCLK_CLK);
+  myTimer_UpdateScale();
+  TPM_Init(periph, &config);
+
+  return strc;
+}
+
+static myTimerStruct_t * myTimer_TakeChannel(uint8_t channel, myTimerMode_t mode)
+{
+  myTimerStruct_t * strc = NULL;
+
+  myASSERT(channel < myTimer_ChannelCnt);
+
+  /* Proceed only if the TPM of the channel is available. Its pin is routed   */
+  /*  to the TPM, which either drives it or reads it, depending on the mode.  */
+  if((channel < myTimer_ChannelCnt) && ((myTimer_Taken & (1UL << myTimer_Channels[channel].TPM)) == 0))
+  {
+    const myTimerChannel_t * const chnl = &myTimer_Channels[channel];
+    port_pin_config_t portCfg;
+
+    strc = myTimer_Take(chnl->TPM, mode);
+    strc->chnl = chnl->chnl;
+
+    CLOCK_EnableClock(myTimer_PortClocks[chnl->port]);
+    portCfg.pullSelect = kPORT_PullDisable;
+    portCfg.slewRate = kPORT_SlowSlewRate;
+    portCfg.passiveFilterEnable = kPORT_PassiveFilterDisable;
+    portCfg.driveStrength = kPORT_LowDriveStrength;
+    portCfg.mux = chnl->mux;
+    PORT_SetPinConfig(myTimer_PORTs[chnl->port], chnl->pin, &portCfg);
+  }
+
+  return strc;
+}
+
+static myRet_t myTimer_StartDedicated(myTimerStruct_t * strc, uint32_t period)
+{
+  myRet_t result = myRet_Fail;
+
+  /* Even at the largest prescaler, the counts of a period must fit in 32     */
+  /*  bits. That is over three hours with the fastest OSCERCLK.               */
+  if((strc->mode == myTimerMode_FreeRunning) || (((uint64_t)period * myTimer_ClockHz) < DRIVER_TIMER_MAX_PERIOD))
+  {
+    /* The interrupt is masked so that it doesn't use the period while it is  */
+    /*  set up, and the TPM is stopped so that it doesn't overflow meanwhile. */
+    DisableIRQ(strc->IRQ);
+    TPM_StopTimer(strc->TPM);
+    TPM_ClearStatusFlags(strc->TPM, kTPM_TimeOverflowFlag);
+    strc->periodMs = period;
+    strc->clockHz = myTimer_ClockHz;
+    strc->running = true;
+    strc->baseMs = 0;
+    strc->overflows = 0;
+
+    if(strc->mode == myTimerMode_FreeRunning) { strc->prescale = DRIVER_TIMER_MAX_PRESCALE; }
+    else                                      { myTimer_SetPeriod(strc, period);            }
+
+    myTimer_Program(strc);
+    EnableIRQ(strc->IRQ);
+
+    result = myRet_OK;
+  }
+
+  return result;
+}
+
+static myRet_t myTimer_StartPwm(myTimerStruct_t * strc, uint32_t period)
+{
+  myRet_t result = myRet_Fail;
+
+  /* The whole period must fit a single overflow, as the output can't be      */
+  /*  split into several of them. The fraction of a count that it may have    */
+  /*  is dropped, as only the duty cycle matters for an output like this.     */
+  /*  MOD must also be below 0xFFFF, so that a channel value above it keeps   */
+  /*  the output always active.                                               */
+  if(((uint64_t)period * myTimer_ClockHz) < (1000ULL << 32))
+  {
+    myTimer_SetPeriod(strc, period);
+    strc->counts = myPeriod_GetWhole(&strc->period);
+
+    if(strc->counts < DRIVER_TIMER_MAX_COUNTS)
+    {
+      TPM_StopTimer(strc->TPM);
+      strc->periodMs = period;
+      strc->clockHz = myTimer_ClockHz;
+      strc->running = true;
+
+      TPM_ClearCounter(strc->TPM);
+      TPM_SetPrescaler(strc->TPM, strc->prescale);
+      TPM_SetTimerPeriod(strc->TPM, strc->counts - 1);
+      TPM_SetChannelValue(strc->TPM, strc->chnl, myTimer_GetDutyCounts(strc));
+      TPM_StartTimer(strc->TPM, kTPM_SystemClock);
+
+      result = myRet_OK;
+    }
+  }
+
+  return result;
+}
+
+static myRet_t myTimer_StartCapture(myTimerStruct_t * strc, myCbk_t cbk)
+{
+  /* Capture timers count at the full clock, through the whole 16 bits of     */
+  /*  the TPM, so that each overflow is just the upper half of a timestamp.   */
+  /*  Anything left pending from a previous run is dropped.                   */
+  DisableIRQ(strc->IRQ);
+  TPM_StopTimer(strc->TPM);
+  TPM_ClearStatusFlags(strc->TPM, ((uint32_t)kTPM_Chnl0Flag << strc->chnl) | kTPM_TimeOverflowFlag);
+  NVIC_ClearPendingIRQ(strc->IRQ);
+  strc->cbk = cbk;
+  strc->clockHz = myTimer_ClockHz;
+  strc->running = true;
+  strc->prescale = kTPM_Prescale_Divide_1;
+  strc->overflows = 0;
+
+  TPM_ClearCounter(strc->TPM);
+  TPM_SetPrescaler(strc->TPM, strc->prescale);
+  TPM_SetTimerPeriod(strc->TPM, DRIVER_TIMER_MAX_COUNTS - 1);
+  TPM_StartTimer(strc->TPM, kTPM_SystemClock);
+  EnableIRQ(strc->IRQ);
+
+  return myRet_OK;
+}
+
+static myRet_t myTimer_StartPit(myTimerStruct_t * strc, uint32_t period)
+{
+  myRet_t result = myRet_Fail;
+
+  if(strc->mode == myTimerMode_FreeRunning)
+  {
+    /* Both channels count down from all ones, and channel 1 only counts the  */
+    /*  wraps of channel 0, so the pair takes 2^64 counts to wrap around.     */
+    /*  Stopping and starting a channel reloads it. Channel 1 starts first,   */
+    /*  so that it is already counting when channel 0 starts.                 */
+    PIT_StopTimer(PIT, kPIT_Chnl_0);
+    PIT_StopTimer(PIT, kPIT_Chnl_1);
+    PIT_SetTimerPeriod(PIT, kPIT_Chnl_0, UINT32_MAX);
+    PIT_SetTimerPeriod(PIT, kPIT_Chnl_1, UINT32_MAX);
+    strc->periodMs = period;
+    strc->clockHz = myTimer_PitHz;
+    strc->running = true;
+    strc->baseMs = 0;
+    PIT_StartTimer(PIT, kPIT_Chnl_1);
+    PIT_StartTimer(PIT, kPIT_Chnl_0);
+
+    result = myRet_OK;
+  }
+  else if(((uint64_t)period * myTimer_PitHz) < DRIVER_TIMER_PIT_MAX_PERIOD)
+  {
+    /* The channel is 32 bits wide, so the whole period is counted at once,   */
+    /*  with no prescaler nor overflows. It counts down from LDVAL to zero,   */
+    /*  so LDVAL is one less than the counts. The first write takes effect    */
+    /*  right away as the channel is stopped. Once it runs, LDVAL is only     */
+    /*  loaded at the next reload, so the next period is always queued, as    */
+    /*  the accumulator may make it one count longer. The interrupt, shared   */
+    /*  by both channels, is masked meanwhile.                                */
+    DisableIRQ(PIT_IRQn);
+    PIT_StopTimer(PIT, strc->pitChnl);
+    PIT_ClearStatusFlags(PIT, strc->pitChnl, kPIT_TimerFlag);
+    strc->periodMs = period;
+    strc->clockHz = myTimer_PitHz;
+    strc->running = true;
+    strc->baseMs = 0;
+
+    myPeriod_InitScaled(&strc->period, &myTimer_PitScale, period);
+    myASSERT(myPeriod_GetWhole(&strc->period) != 0);
+
+    PIT_SetTimerPeriod(PIT, strc->pitChnl, myPeriod_Next(&strc->period) - 1);
+    PIT_StartTimer(PIT, strc->pitChnl);
+    if(strc->mode == myTimerMode_Periodic)
+    {
+      PIT_SetTimerPeriod(PIT, strc->pitChnl, myPeriod_Next(&strc->period) - 1);
+    }
+    EnableIRQ(PIT_IRQn);
+
+    result = myRet_OK;
+  }
+
+  return result;
+}
+
+static myRet_t myTimer_StartSysTick(myTimerStruct_t * strc, uint32_t period)
+{
+  myRet_t result = myRet_Fail;
+
+  /* The period is just the length of the SysTick wraps, and the callback is  */
+  /*  called by the time driver on each of them. A wrap is a whole amount of  */
+  /*  counts, so the fraction of a count that the period may have is dropped. */
+  if(((uint64_t)period * myTimer_CoreHz) < DRIVER_TIMER_SYSTICK_MAX_PERIOD)
+  {
+    myPeriod_InitScaled(&strc->period, &myTimer_CoreScale, period);
+    strc->counts = myPeriod_GetWhole(&strc->period);
+    myASSERT(strc->counts != 0);
+
+    strc->periodMs = period;
+    strc->clockHz = myTimer_CoreHz;
+    strc->running = true;
+    myTime_SetTick(strc->counts, strc->cbk);
+
+    result = myRet_OK;
+  }
+
+  return result;
+}
+
+static uint32_t myTimer_GetDutyCounts(myTimerStruct_t * strc)
+{
+  /* The output is active while the counter is below the channel value, so    */
+  /*  the full duty cycle takes the whole period, which is above MOD.         */
+  uint32_t counts = strc->counts;
+
+  if(strc->duty != MY_TIMER_DUTY_MAX) { counts = ((uint32_t)strc->duty * counts) >> 16; }
+
+  return counts;
+}
+
+static void myTimer_StartIdle(myTimerStruct_t * strc, myTimerMode_t mode, uint64_t cycles)
+{
+  /* Same as starting the timer, but the period is given in clock cycles      */
+  /*  * 1000 instead of ms, and any interrupt left pending by the tick is     */
+  /*  dropped, as it would be taken for the end of this period.               */
+  DisableIRQ(strc->IRQ);
+  TPM_StopTimer(strc->TPM);
+  TPM_ClearStatusFlags(strc->TPM, kTPM_TimeOverflowFlag);
+  NVIC_ClearPendingIRQ(strc->IRQ);
+  strc->mode = mode;
+  strc->running = true;
+  strc->overflows = 0;
+
+  myPeriod_Init(&strc->period, cycles, 1000);
+  myTimer_SetPrescale(strc);
+  myTimer_Program(strc);
+  EnableIRQ(strc->IRQ);
+}
+
+static void myTimer_Program(myTimerStruct_t * strc)
+{
+  TPM_Type * const periph = strc->TPM;
+  bool stopOnOverflow = false;
+  uint32_t counts;
+
+  /* Free-running timers just let the counter wrap around. Otherwise, the     */
+  /*  period is split into as many overflows as needed, and a one-shot timer  */
+  /*  that fits in a single one is stopped by the TPM itself.                 */
+  if(strc->mode == myTimerMode_FreeRunning)
+  {
+    counts = DRIVER_TIMER_MAX_COUNTS;
+  }
+  else
+  {
+    mySplit_Init(&strc->split, DRIVER_TIMER_MAX_COUNTS);
+    counts = mySplit_Next(&strc->split, &strc->period);
+    strc->doneCounts = 0;
+    strc->segment = counts;
+    strc->nextSegment = 0;
+    stopOnOverflow = (strc->mode == myTimerMode_OneShot) && !mySplit_IsPending(&strc->split);
+  }
+
+  /* The TPM counts from zero up to MOD, so MOD is one less than the          */
+  /*  counts. The first write takes effect right away as the TPM is           */
+  /*  stopped. Once it runs, MOD is buffered and only loaded at the next      */
+  /*  overflow, so the segment after the current one is always queued, if     */
+  /*  there is one.                                                           */
+  TPM_ClearCounter(periph);
+  TPM_SetPrescaler(periph, strc->prescale);
+  TPM_SetStopOnOverflow(periph, stopOnOverflow);
+  TPM_SetTimerPeriod(periph, counts - 1);
+  TPM_StartTimer(periph, kTPM_SystemClock);
+
+  if((strc->mode == myTimerMode_Periodic) || ((strc->mode == myTimerMode_OneShot) && mySplit_IsPending(&strc->split)))
+  {
+    counts = mySplit_Next(&strc->split, &strc->period);
+    TPM_SetTimerPeriod(periph, counts - 1);
+    strc->nextSegment = counts;
+  }
+}
+
+static void myTimer_SetPeriod(myTimerStruct_t * strc, uint32_t period)
+{
+  /* The period lasts period * clockHz / (1000 * 2^PS) counts, which is       */
+  /*  seldom a whole number. The accumulator spreads the fraction over the    */
+  /*  periods so that they add up to the exact time. If the undivided counts  */
+  /*  fit in 32 bits, the smallest prescaler that fits the TPM is taken.      */
+  /*  Otherwise the period is way beyond the TPM anyway, so it is set up      */
+  /*  right away at the largest prescaler, to be split into overflows.        */
+  if(((uint64_t)period * myTimer_ClockHz) < (1000ULL << 32))
+  {
+    myPeriod_InitScaled(&strc->period, &myTimer_Scale, period);
+    myTimer_SetPrescale(strc);
+  }
+  else
+  {
+    myPeriod_InitScaled(&strc->period, &myTimer_MaxScale, period);
+    strc->prescale = DRIVER_TIMER_MAX_PRESCALE;
+  }
+
+  myASSERT(myPeriod_GetWhole(&strc->period) != 0);
+}
+
+static void myTimer_SetPrescale(myTimerStruct_t * strc)
+{
+  const uint32_t whole = myPeriod_GetWhole(&strc->period);
+  tpm_clock_prescale_t prescale = kTPM_Prescale_Divide_1;
+
+  while((prescale < DRIVER_TIMER_MAX_PRESCALE) && ((whole >> prescale) >= DRIVER_TIMER_MAX_COUNTS)) { prescale++; }
+  myPeriod_Prescale(&strc->period, prescale);
+  strc->prescale = prescale;
+}
+
+static uint32_t myTimer_GetElapsedDedicated(myTimerStruct_t * strc)
+{
+  uint32_t overflows, count;
+  uint64_t counts;
+
+  /* The overflow interrupt is masked so that the overflow count and the TPM  */
+  /*  counter are read together. If the TPM overflowed in the meantime, its   */
+  /*  interrupt is still pending and the counter is read again past it.       */
+  DisableIRQ(strc->IRQ);
+  overflows = strc->overflows;
+  count = TPM_GetCurrentTimerCount(strc->TPM);
+  if((TPM_GetStatusFlags(strc->TPM) & kTPM_TimeOverflowFlag) != 0)
+  {
+    overflows++;
+    count = TPM_GetCurrentTimerCount(strc->TPM);
+  }
+  EnableIRQ(strc->IRQ);
+
+  counts = ((uint64_t)overflows * DRIVER_TIMER_MAX_COUNTS) + count;
+  return strc->baseMs + (uint32_t)(((counts * 1000) << strc->prescale) / strc->clockHz);
+}
+
+static uint32_t myTimer_GetElapsedPit(myTimerStruct_t * strc)
+{
+  /* The chained channels count down together from all ones. The SDK reads    */
+  /*  the upper half first, which latches the lower half with it.             */
+  const uint64_t counts = UINT64_MAX - PIT_GetLifetimeTimerCount(PIT);
+
+  return strc->baseMs + (uint32_t)((counts * 1000) / strc->clockHz);
+}
+
+static void myTimer_Restart(myTimerStruct_t * strc)
+{
+  myRet_t (* const start)(myTimerStruct_t *, uint32_t) = (strc->resource == myTimerRes_Pit) ? myTimer_StartPit : myTimer_StartDedicated;
+  uint32_t time;
+
+  /* The time that one-shot and free-running timers counted so far is read    */
+  /*  with the clock they were started with, before they are restarted. A     */
+  /*  one-shot timer with no time left has its interrupt pending already.     */
+  /*  Capture timers have no period, so only the rate of their timestamps     */
+  /*  changes.                                                                */
+  switch(strc->mode)
+  {
+    case myTimerMode_OneShot:
+    {
+      time = myTimer_GetLeft(strc);
+      if(time != 0) { start(strc, time); }
+    } break;
+
+    case myTimerMode_FreeRunning:
+    {
+      time = myTimer_GetElapsed((myTimer_t) strc);
+      start(strc, strc->periodMs);
+      strc->baseMs = time;
+    } break;
+
+    case myTimerMode_Capture: { strc->clockHz = myTimer_ClockHz;          } break;
+    case myTimerMode_Pwm:     { myTimer_StartPwm(strc, strc->periodMs);   } break;
+    default:                  { start(strc, strc->periodMs);              } break;
+  }
+}
+
+static uint32_t myTimer_GetLeft(myTimerStruct_t * strc)
+{
+  uint64_t elapsed;
+  uint32_t left = 0;
+
+  if(strc->resource == myTimerRes_Pit)
+  {
+    /* The channel counts down to zero, so its counter is the time left,      */
+    /*  rounded up so that the timer never expires early.                     */
+    DisableIRQ(PIT_IRQn);
+    if((PIT_GetStatusFlags(PIT, strc->pitChnl) & kPIT_TimerFlag) == 0)
+    {
+      elapsed = (uint64_t)PIT_GetCurrentTimerCount(PIT, strc->pitChnl) * 1000;
+      left = (uint32_t)((elapsed + strc->clockHz - 1) / strc->clockHz);
+      if(left == 0) { left = 1; }
+    }
+    EnableIRQ(PIT_IRQn);
+  }
+  else
+  {
+    /* The TPM counts up through the segments of the period, so the time      */
+    /*  left is what is not counted yet. If the last segment overflowed, the  */
+    /*  interrupt is pending and the timer has no time left.                  */
+    DisableIRQ(strc->IRQ);
+    elapsed = (uint64_t)strc->doneCounts + TPM_GetCurrentTimerCount(strc->TPM);
+    if((TPM_GetStatusFlags(strc->TPM) & kTPM_TimeOverflowFlag) != 0)
+    {
+      elapsed = (strc->nextSegment == 0) ? UINT64_MAX : ((uint64_t)strc->doneCounts + strc->segment + TPM_GetCurrentTimerCount(strc->TPM));
+    }
+    EnableIRQ(strc->IRQ);
+
+    if(elapsed != UINT64_MAX)
+    {
+      elapsed = ((elapsed * 1000) << strc->prescale) / strc->clockHz;
+      left = (elapsed < strc->periodMs) ? (strc->periodMs - (uint32_t)elapsed) : 1;
+    }
+  }
+
+  return left;
+}
+
+static void myTimer_CatchUp(uint32_t ticks)
+{
+  /* Ticks with nothing to do are skipped at once, the others are run, as     */
+  /*  their callbacks may start timers that change what comes next.           */
+  while(ticks > 0)
+  {
+    const uint32_t next = myWheel_GetNextEvent();
+
+    if(next > ticks)
+    {
+      myWheel_Skip(ticks);
+      ticks = 0;
+    }
+    else
+    {
+      myWheel_Skip(next - 1);
+      myWheel_Tick();
+      ticks -= next;
+    }
+  }
+}
+
+static void myTimer_IdleWake(void)
+{
+  myTimerStruct_t * const strc = myTimer_WheelTimer;
+
+  /* The TPM is back at a tick boundary, so the regular tick restarts from    */
+  /*  here, and this boundary is the tick that was due.                       */
+  strc->mode = myTimerMode_Periodic;
+  strc->cbk = myWheel_Tick;
+  myTimer_StartDedicated(strc, DRIVER_TIMER_WHEEL_TICK_MS);
+  myTimer_Idle = false;
+  myWheel_Tick();
+}
+
+static void myTimer_UpdateScale(void)
+{
+#ifndef DRIVER_TIMER_CLOCK_HZ
+  myTimer_ClockHz = CLOCK_GetOsc0ErClkFreq();
+  myASSERT(myTimer_ClockHz != 0);
+  myPeriod_InitScale(&myTimer_Scale, myTimer_ClockHz, 1000);
+  myPeriod_InitScale(&myTimer_MaxScale, myTimer_ClockHz, 1000 << DRIVER_TIMER_MAX_PRESCALE);
+#endif
+}
+
+static void myTimer_UpdatePitScale(void)
+{
+  myTimer_PitHz = CLOCK_GetBusClkFreq();
+  myASSERT(myTimer_PitHz != 0);
+  myPeriod_InitScale(&myTimer_PitScale, myTimer_PitHz, 1000);
+}
+
+static void myTimer_UpdateSysTickScale(void)
+{
+  myTimer_CoreHz = CLOCK_GetCoreSysClkFreq();
+  myASSERT(myTimer_CoreHz != 0);
+  myPeriod_InitScale(&myTimer_CoreScale, myTimer_CoreHz, 1000);
+}
+
+static bool myTimer_Capture(myTimerStruct_t * strc)
+{
+  const uint32_t chnlFlag = (uint32_t)kTPM_Chnl0Flag << strc->chnl;
+  const uint32_t flags = TPM_GetStatusFlags(strc->TPM) & (chnlFlag | kTPM_TimeOverflowFlag);
+  bool wasEmpty = false;
+
+  /* The value is read before its flag is cleared, so that an edge that comes */
+  /*  in between raises the interrupt again instead of being lost.            */
+  if((flags & chnlFlag) != 0)
+  {
+    const uint32_t value = TPM_GetChannelValue(strc->TPM, strc->chnl);
+    uint32_t overflows = strc->overflows;
+    uint32_t stamp;
+
+    /* If an overflow is pending too, the edge may have come before or after  */
+    /*  it. The interrupt is never late by half a wrap around, so a value in  */
+    /*  the lower half of the counter comes after it, and the upper half      */
+    /*  before it.                                                            */
+    if(((flags & kTPM_TimeOverflowFlag) != 0) && (value < (DRIVER_TIMER_MAX_COUNTS / 2))) { overflows++; }
+    stamp = (overflows << 16) | value;
+
+    /* The consumer is only called back when the ring was empty, as it drains */
+    /*  every item that is there. Edges that find the ring full are dropped.  */
+    wasEmpty = (myRing_GetCount(strc->ring) == 0);
+    if(myRing_Push(strc->ring, &stamp) != myRet_OK) { wasEmpty = false; }
+  }
+
+  if((flags & kTPM_TimeOverflowFlag) != 0) { strc->overflows++; }
+  TPM_ClearStatusFlags(strc->TPM, flags);
+
+  return wasEmpty;
+}
+
 static void myTimer_Interrupt(myTimerTPMs_t source)
 {
   myTimerStruct_t * strc = &myTimer_Struct[source];
   const myCbk_t cbk = strc->cbk;
+  bool expired = false;
 
-  TPM_ClearStatusFlags(strc->TPM, kTPM_TimeOverflowFlag);
+  /* Capture timers handle their own flags, as they interrupt on their        */
+  /*  channel too, and need to tell it apart from the overflow.               */
+  if(strc->mode == myTimerMode_Capture) { expired = myTimer_Capture(strc); }
+  else                                  { TPM_ClearStatusFlags(strc->TPM, kTPM_TimeOverflowFlag); }
+
+  /* Periods split into several overflows only expire at the last one. The    */
+  /*  next segment is queued as soon as the current one starts.               */
+  switch(strc->mode)
+  {
+    case myTimerMode_Periodic:
+    {
+      expired = mySplit_Expired(&strc->split);
+      TPM_SetTimerPeriod(strc->TPM, mySplit_Next(&strc->split, &strc->period) - 1);
+    } break;
+
+    case myTimerMode_OneShot:
+    {
+      /* Only one-shot timers that fit in a single overflow are stopped by    */
+      /*  the TPM itself. Longer ones are stopped here. The counts of the     */
+      /*  segments are kept, so that a clock update can tell the time left.   */
+      expired = mySplit_Expired(&strc->split);
+      if(expired)
+      {
+        TPM_StopTimer(strc->TPM);
+        strc->running = false;
+      }
+      else
+      {
+        strc->doneCounts += strc->segment;
+        strc->segment = strc->nextSegment;
+        strc->nextSegment = 0;
+        if(mySplit_IsPending(&strc->split))
+        {
+          strc->nextSegment = mySplit_Next(&strc->split, &strc->period);
+          TPM_SetTimerPeriod(strc->TPM, strc->nextSegment - 1);
+        }
+      }
+    } break;
+
+    case myTimerMode_FreeRunning:
+    {
+      strc->overflows++;
+    } break;
+
+    default:
+    {
+    } break;
+  }
+
+  if(expired && (cbk != NULL)) { cbk(); }
+}
+
+static void myTimer_PitInterrupt(myTimerPITs_t source)
+{
+  myTimerStruct_t * strc = &myTimer_PitStruct[source];
+  const myCbk_t cbk = strc->cbk;
+
+  PIT_ClearStatusFlags(PIT, strc->pitChnl, kPIT_TimerFlag);
+
+  /* The channel has just reloaded the period that was queued, so the one     */
+  /*  after it is queued now. One-shot timers are stopped before they count   */
+  /*  a second period.                                                        */
+  switch(strc->mode)
+  {
+    case myTimerMode_Periodic: { PIT_SetTimerPeriod(PIT, strc->pitChnl, myPeriod_Next(&strc->period) - 1); } break;
+    case myTimerMode_OneShot:  { PIT_StopTimer(PIT, strc->pitChnl); strc->running = false;                 } break;
+    default:                   {                                                                           } break;
+  }
 
   if(cbk != NULL) { cbk(); }
 }
@@ -202,3 +1488,18 @@ void TPM2_IRQHandler(void)
 {
   myTimer_Interrupt(myTimer_TPM2);
 }
+
+void PIT_IRQHandler(void)
+{
+  myTimerPITs_t thisPIT;
+
+  /* Both channels share this interrupt, so each one that expired is served.  */
+  /*  Free-running timers take the whole PIT but never enable it.             */
+  for(thisPIT = myTimer_PIT0; thisPIT < myTimer_PIT_Count; thisPIT++)
+  {
+    if(((myTimer_PitTaken & (1UL << thisPIT)) != 0) && ((PIT_GetStatusFlags(PIT, (pit_chnl_t) thisPIT) & kPIT_TimerFlag) != 0))
+    {
+      myTimer_PitInterrupt(thisPIT);
+    }
+  }
+}
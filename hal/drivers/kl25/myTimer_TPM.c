@@ -53,6 +53,77 @@ void TPM_ClearCounter(TPM_Type * base)
   base->CNT = 0;
 }
 
+/**
+ * @brief Sets the prescaler of a TPM. It should only be changed while the
+ *          TPM is stopped.
+ * @param base Base address of the TPM peripheral.
+ * @param prescale Prescaler to divide the TPM clock by.
+ */
+void TPM_SetPrescaler(TPM_Type * base, tpm_clock_prescale_t prescale)
+{
+  myASSERT(base != NULL);
+
+  /* TOF is cleared by writing one to it, so it is written back as zero.      */
+  base->SC = (base->SC & ~(TPM_SC_PS_MASK | TPM_SC_TOF_MASK)) | TPM_SC_PS(prescale);
+}
+
+/**
+ * @brief Sets whether a TPM should stop counting once it overflows.
+ * @param base Base address of the TPM peripheral.
+ * @param enable True to stop at the overflow, false to keep counting.
+ */
+void TPM_SetStopOnOverflow(TPM_Type * base, bool enable)
+{
+  myASSERT(base != NULL);
+
+  if(enable) { base->CONF |= TPM_CONF_CSOO_MASK;  }
+  else       { base->CONF &= ~TPM_CONF_CSOO_MASK; }
+}
+
+/**
+ * @brief Sets a TPM channel as an edge-aligned, high-true PWM output.
+ * @param base Base address of the TPM peripheral.
+ * @param chnl Channel to set.
+ */
+void TPM_SetChannelPwm(TPM_Type * base, tpm_chnl_t chnl)
+{
+  myASSERT(base != NULL);
+
+  /* The channel mode can only be changed once the channel is disabled, and   */
+  /*  the TPM takes a few of its clock cycles to acknowledge each write.      */
+  base->CONTROLS[chnl].CnSC = 0;
+  while(base->CONTROLS[chnl].CnSC != 0) { }
+
+  base->CONTROLS[chnl].CnSC = TPM_CnSC_MSB_MASK | TPM_CnSC_ELSB_MASK;
+  while((base->CONTROLS[chnl].CnSC & (TPM_CnSC_MSB_MASK | TPM_CnSC_ELSB_MASK)) == 0) { }
+}
+
+/**
+ * @brief Sets the value of a TPM channel. While the TPM runs in PWM mode, it
+ *          is only loaded when the counter wraps around.
+ * @param base Base address of the TPM peripheral.
+ * @param chnl Channel to set.
+ * @param value Value to compare the counter against.
+ */
+void TPM_SetChannelValue(TPM_Type * base, tpm_chnl_t chnl, uint32_t value)
+{
+  myASSERT(base != NULL);
+  base->CONTROLS[chnl].CnV = value;
+}
+
+/**
+ * @brief Gets the value of a TPM channel. While the channel is set for input
+ *          capture, it is the counter value latched at the last edge.
+ * @param base Base address of the TPM peripheral.
+ * @param chnl Channel to read.
+ * @return Channel value.
+ */
+uint32_t TPM_GetChannelValue(TPM_Type * base, tpm_chnl_t chnl)
+{
+  myASSERT(base != NULL);
+  return base->CONTROLS[chnl].CnV;
+}
+
 /*******************************************************************************
  *  PRIVATE FUNCTIONS / ROUTINES
  ******************************************************************************/
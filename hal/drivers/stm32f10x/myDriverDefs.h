@@ -68,4 +68,21 @@ typedef enum
   myDriverPin_15,
 } myDriverPin_t;
 
+/**
+ * @brief Type that names the channels that PWM and capture timers can use,
+ *          each one as its TIM, channel and pin, with the default pin
+ *          mapping.
+ */
+typedef enum
+{
+  myDriverTimerCh_TIM3_CH1_PA6 = 0,
+  myDriverTimerCh_TIM3_CH2_PA7,
+  myDriverTimerCh_TIM3_CH3_PB0,
+  myDriverTimerCh_TIM3_CH4_PB1,
+  myDriverTimerCh_TIM4_CH1_PB6,
+  myDriverTimerCh_TIM4_CH2_PB7,
+  myDriverTimerCh_TIM4_CH3_PB8,
+  myDriverTimerCh_TIM4_CH4_PB9,
+} myDriverTimerCh_t;
+
 #endif
@@ -0,0 +1,147 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file myFault.c
+ * @brief Source file for the fault driver, STM32F10x microcontrollers.
+ *
+ * The handlers of all the fault exceptions of the M3 are defined here, so
+ *  they are not generated in stm32f1xx_it.c. All of them share an entry that
+ *  finds the registers stacked by the core on whichever stack was in use,
+ *  which is told by bit 2 of EXC_RETURN, before any C code can push anything
+ *  else. The fault itself is told by IPSR.
+ *
+ * The status of the record is the CFSR, which tells the reason of the
+ *  configurable faults (MemManage, BusFault and UsageFault) and of those that
+ *  were escalated to a HardFault.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "myFault.h"
+#include "projConfig.h"
+
+#include "stm32f1xx_hal.h"
+
+#include "myCrash.h"
+#include "myTime.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+/* Set below whether a crash resets the core instead of hanging it, which     */
+/*  keeps it stopped where it crashed for the debugger to look at.            */
+#ifndef DRIVER_FAULT_RESET
+  #define DRIVER_FAULT_RESET                                                   0
+#endif
+
+/* Bits of IPSR with the number of the active exception.                      */
+#define DRIVER_FAULT_IPSR_MASK                                            0x1FFU
+#define DRIVER_FAULT_US_PER_MS                                            (1000)
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static void myFault_Entry(void) __attribute__((naked));
+static void myFault_Handle(const myCrashFrame_t * frame) __attribute__((used, noreturn));
+static void myFault_Halt(void) __attribute__((noreturn));
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES
+ ******************************************************************************/
+/**
+ * @brief Handles a failed assertion, for myASSERT. It never returns.
+ * @param fileId Identifier of the file of the assertion.
+ * @param line Line of the assertion.
+ * @param lr Return address of the routine where the assertion failed.
+ */
+void myCrash_Assert(uint32_t fileId, uint32_t line, void * lr)
+{
+  myCrashFrame_t frame = { 0 };
+
+  __disable_irq();
+
+  /* The return address of this call is right after the failed assertion.     */
+  frame.pc = (uint32_t)(uintptr_t)__builtin_return_address(0);
+  frame.lr = (uint32_t)(uintptr_t)lr;
+  myCrash_Save(myCrashCause_Assert, &frame, fileId, line, 0, (uint32_t)(myTime_Now() / DRIVER_FAULT_US_PER_MS));
+
+  myFault_Halt();
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+/**
+ * @brief Entry of the fault exceptions. It hands the registers stacked by the
+ *          core to myFault_Handle, which never returns.
+ */
+static void myFault_Entry(void)
+{
+  __asm volatile
+  (
+    "  movs r0, #4          \n"
+    "  mov  r1, lr          \n"
+    "  tst  r0, r1          \n"
+    "  beq  1f              \n"
+    "  mrs  r0, psp         \n"
+    "  b    2f              \n"
+    "1:                     \n"
+    "  mrs  r0, msp         \n"
+    "2:                     \n"
+    "  bl   myFault_Handle  \n"
+  );
+}
+
+/**
+ * @brief Writes the record of a fault, then hangs or resets.
+ * @param frame Registers stacked by the core when it took the fault.
+ */
+static void myFault_Handle(const myCrashFrame_t * frame)
+{
+  myCrashCause_t cause = (myCrashCause_t)(__get_IPSR() & DRIVER_FAULT_IPSR_MASK);
+
+  myCrash_Save(cause, frame, 0, 0, SCB->CFSR, (uint32_t)(myTime_Now() / DRIVER_FAULT_US_PER_MS));
+
+  myFault_Halt();
+}
+
+/**
+ * @brief Stops the program after a crash, either by hanging or by resetting
+ *          the core, as set by DRIVER_FAULT_RESET.
+ */
+static void myFault_Halt(void)
+{
+#if DRIVER_FAULT_RESET == 1
+  NVIC_SystemReset();
+#else
+  while(1) { }
+#endif
+}
+
+/*******************************************************************************
+ *  INTERRUPT ROUTINES
+ ******************************************************************************/
+void HardFault_Handler(void) __attribute__((alias("myFault_Entry")));
+void MemManage_Handler(void) __attribute__((alias("myFault_Entry")));
+void BusFault_Handler(void) __attribute__((alias("myFault_Entry")));
+void UsageFault_Handler(void) __attribute__((alias("myFault_Entry")));
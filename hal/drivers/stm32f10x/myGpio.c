@@ -19,6 +19,19 @@
  * @brief Source file for general purpose input output operations.
  *
  * This file implements the Gpio driver for STM32F10x devices.
+ *
+ * If the project sets DRIVER_GPIO_USE_BITBAND, single pins are accessed
+ *  through the bit-band alias of their bits in IDR and ODR instead of the
+ *  HAL. Each alias address is computed once, at initialization, so that
+ *  reading or writing a pin takes a single load or store, which no interrupt
+ *  can split.
+ *
+ * Input pins can also interrupt, through the EXTI line of the same number.
+ *  Lines 5 to 9 and 10 to 15 share a vector each, whose routine finds the
+ *  lines that fired from the pending register, and calls their callbacks
+ *  from a table indexed by line. Finding each line takes a constant time, no
+ *  matter how many lines share the vector. EXTI only detects edges, so level
+ *  triggers are not supported.
  */
 
 /*******************************************************************************
@@ -30,26 +43,64 @@
 
 #include "stm32f1xx_hal.h"
 
+#include "myMacros.h"
 #include "myAssert.h"
 
 /*******************************************************************************
  *  PRIVATE DEFINITIONS
  ******************************************************************************/
+/* Set below whether single pins are accessed through their bit-band alias.   */
+#ifndef DRIVER_GPIO_USE_BITBAND
+  #define DRIVER_GPIO_USE_BITBAND                                              0
+#endif
+
 /* The structure below holds all the items related to a gpio pin instance.    */
 typedef struct
 {
   GPIO_TypeDef * GPIO;
   uint16_t pinMask;
+#if DRIVER_GPIO_USE_BITBAND
+  volatile uint32_t * idrBit;
+  volatile uint32_t * odrBit;
+#endif
 } myGpioPinStruct_t;
 
+/* The structure below holds all the items related to a group of gpio pins.   */
+typedef struct
+{
+  GPIO_TypeDef * GPIO;
+  uint16_t mask;
+} myGpioPortStruct_t;
+
 /* Set below the maximum amount of pins that the driver can handle.           */
 #ifndef DRIVER_GPIO_PIN_AMOUNT
   #define DRIVER_GPIO_PIN_AMOUNT                                               4
 #endif
 
+/* Set below the maximum amount of pin groups that the driver can handle.     */
+#ifndef DRIVER_GPIO_PORT_AMOUNT
+  #define DRIVER_GPIO_PORT_AMOUNT                                              2
+#endif
+
+/* BSRR sets the pins written to its lower half, and resets the ones written  */
+/*  to its upper half, all in a single store.                                 */
+#define MY_GPIO_BSRR(SET, RESET)       (((uint32_t)(RESET) << 16) | (uint16_t)(SET))
+
+/* Each bit of the peripheral region has a word of its own in the bit-band    */
+/*  region: reading it gets the bit, and writing it sets or resets the bit.   */
+#define MY_GPIO_BITBAND(REG, BIT)                                              \
+  ((volatile uint32_t *)(PERIPH_BB_BASE + (((uintptr_t)&(REG) - PERIPH_BASE) * 32) + ((BIT) * 4)))
+
+/* Set below the EXTI lines served by each of the vectors that share lines.   */
+#define MY_GPIO_EXTI9_5_LINES                                           (0x03E0)
+#define MY_GPIO_EXTI15_10_LINES                                         (0xFC00)
+
 /*******************************************************************************
  *  PRIVATE PROTOTYPES
  ******************************************************************************/
+static bool irqParsAreValid(myGpioPars_t * pars);
+static void configurePins(uint8_t port, uint16_t mask, myGpioDir_t direction, myGpioPull_t pull, myGpioIrq_t irq);
+static void dispatchIrq(uint32_t lines);
 
 /*******************************************************************************
  *  PRIVATE VARIABLES
@@ -60,6 +111,15 @@ static const uint32_t myGpio_GPIOCnt = sizeof(myGpio_GPIOs) / sizeof(myGpio_GPIO
 static myGpioPinStruct_t myGpio_Struct[DRIVER_GPIO_PIN_AMOUNT];
 static uint32_t myGpio_NextPin = 0;
 
+static myGpioPortStruct_t myGpio_PortStruct[DRIVER_GPIO_PORT_AMOUNT];
+static uint32_t myGpio_NextPort = 0;
+
+static const IRQn_Type myGpio_ExtiIRQns[] = { EXTI0_IRQn, EXTI1_IRQn, EXTI2_IRQn, EXTI3_IRQn, EXTI4_IRQn,
+                                              EXTI9_5_IRQn, EXTI9_5_IRQn, EXTI9_5_IRQn, EXTI9_5_IRQn, EXTI9_5_IRQn,
+                                              EXTI15_10_IRQn, EXTI15_10_IRQn, EXTI15_10_IRQn, EXTI15_10_IRQn,
+                                              EXTI15_10_IRQn, EXTI15_10_IRQn };
+static myCbk_t myGpio_ExtiCbks[myDriverPin_15 + 1];
+
 /*******************************************************************************
  *  PUBLIC FUNCTIONS / ROUTINES
  ******************************************************************************/
@@ -81,8 +141,10 @@ myRet_t myGpio_Init(myGpioPin_t * pin, myGpioPars_t * pars)
     myASSERT(pars->pin <= myDriverPin_15);
     myASSERT(pars->direction <= myGpioDir_Outp);
     myASSERT(pars->pull <= myGpioPull_Dw);
+    myASSERT(pars->irq <= myGpioIrq_High);
 
-    if((pars->port < myGpio_GPIOCnt) && (pars->pin <= myDriverPin_15) && (pars->direction <= myGpioDir_Outp) && (pars->pull <= myGpioPull_Dw))
+    if((pars->port < myGpio_GPIOCnt) && (pars->pin <= myDriverPin_15) && (pars->direction <= myGpioDir_Outp) && (pars->pull <= myGpioPull_Dw) &&
+       irqParsAreValid(pars))
     {
       const uint32_t thisGpio = myGpio_NextPin++;
       myASSERT(thisGpio < DRIVER_GPIO_PIN_AMOUNT);
@@ -90,46 +152,27 @@ myRet_t myGpio_Init(myGpioPin_t * pin, myGpioPars_t * pars)
       if(thisGpio >= DRIVER_GPIO_PIN_AMOUNT) { myGpio_NextPin--; }
       else
       {
-        GPIO_TypeDef * const periph = myGpio_GPIOs[pars->port];
         myGpioPinStruct_t * strc = &myGpio_Struct[thisGpio];
-        GPIO_InitTypeDef gpioCfg;
 
-        strc->GPIO = periph;
+        strc->GPIO = myGpio_GPIOs[pars->port];
         strc->pinMask = (0x01 << pars->pin);
+#if DRIVER_GPIO_USE_BITBAND
+        strc->idrBit = MY_GPIO_BITBAND(strc->GPIO->IDR, pars->pin);
+        strc->odrBit = MY_GPIO_BITBAND(strc->GPIO->ODR, pars->pin);
+#endif
 
-        gpioCfg.Pin = strc->pinMask;
-        gpioCfg.Speed = GPIO_SPEED_FREQ_LOW;
+        /* The callback is in place before the line can fire, so that the     */
+        /*  routine never finds a pending line without its callback.          */
+        if(pars->irq != myGpioIrq_None) { myGpio_ExtiCbks[pars->pin] = pars->cbk; }
 
-        if(pars->direction == myGpioDir_Outp)
-        {
-          gpioCfg.Mode = GPIO_MODE_OUTPUT_PP;
-          gpioCfg.Pull = GPIO_NOPULL;
-        }
-        else
-        {
-          gpioCfg.Mode = GPIO_MODE_INPUT;
-
-          switch(pars->pull)
-          {
-            case myGpioPull_Dw: { gpioCfg.Pull = GPIO_PULLDOWN;    } break;
-            case myGpioPull_Up: { gpioCfg.Pull = GPIO_PULLUP;      } break;
-            default:            { gpioCfg.Pull = GPIO_NOPULL;      } break;
-          }
-        }
+        configurePins(pars->port, strc->pinMask, pars->direction, pars->pull, pars->irq);
 
-        /* Enable the clock for the required port and initialize this pin.    */
-        switch(pars->port)
+        if(pars->irq != myGpioIrq_None)
         {
-          case myDriverPort_PA:  { __HAL_RCC_GPIOA_CLK_ENABLE(); } break;
-          case myDriverPort_PB:  { __HAL_RCC_GPIOB_CLK_ENABLE(); } break;
-          case myDriverPort_PC:  { __HAL_RCC_GPIOC_CLK_ENABLE(); } break;
-          case myDriverPort_PD:  { __HAL_RCC_GPIOD_CLK_ENABLE(); } break;
-          case myDriverPort_PE:  { __HAL_RCC_GPIOE_CLK_ENABLE(); } break;
-          default:               { myASSERT(false);              } break;
+          __HAL_GPIO_EXTI_CLEAR_IT(strc->pinMask);
+          HAL_NVIC_EnableIRQ(myGpio_ExtiIRQns[pars->pin]);
         }
 
-        HAL_GPIO_Init(periph, &gpioCfg);
-
         /* Init is complete.                                                  */
         *pin = (myGpioPin_t) strc;
         result = myRet_OK;
@@ -153,12 +196,17 @@ myGpioLvl_t myGpio_Get(myGpioPin_t pin)
   if(pin != NULL)
   {
     myGpioPinStruct_t * strc = (myGpioPinStruct_t *) pin;
+#if DRIVER_GPIO_USE_BITBAND
+    if(*strc->idrBit == 0) { lvl = myGpioLvl_Lo; }
+    else                   { lvl = myGpioLvl_Hi; }
+#else
     GPIO_PinState state;
 
     state = HAL_GPIO_ReadPin(strc->GPIO, strc->pinMask);
 
     if(state == GPIO_PIN_RESET) { lvl = myGpioLvl_Lo; }
     else                        { lvl = myGpioLvl_Hi; }
+#endif
   }
 
   return lvl;
@@ -179,12 +227,200 @@ myRet_t myGpio_Set(myGpioPin_t pin, myGpioLvl_t lvl)
   if(pin != NULL)
   {
     myGpioPinStruct_t * strc = (myGpioPinStruct_t *) pin;
+#if DRIVER_GPIO_USE_BITBAND
+    *strc->odrBit = (lvl == myGpioLvl_Lo) ? 0 : 1;
+#else
     GPIO_PinState state;
 
     if(lvl == myGpioLvl_Lo) { state = GPIO_PIN_RESET; }
     else                    { state = GPIO_PIN_SET;   }
 
     HAL_GPIO_WritePin(strc->GPIO, strc->pinMask, state);
+#endif
+    result = myRet_OK;
+  }
+
+  return result;
+}
+
+/**
+ * @brief Toggles the level of an output pin.
+ * @param pin Info about the pin to toggle.
+ * @return Success / Failure
+ */
+myRet_t myGpio_Toggle(myGpioPin_t pin)
+{
+  myRet_t result = myRet_Fail;
+  myASSERT(pin != NULL);
+
+  if(pin != NULL)
+  {
+    myGpioPinStruct_t * strc = (myGpioPinStruct_t *) pin;
+#if DRIVER_GPIO_USE_BITBAND
+    /* The alias reads back the current level of the pin in ODR, and writing  */
+    /*  the other one touches no other bit, so only this pin could be changed */
+    /*  by an interrupt between the load and the store.                       */
+    *strc->odrBit ^= 1;
+#else
+    HAL_GPIO_TogglePin(strc->GPIO, strc->pinMask);
+#endif
+    result = myRet_OK;
+  }
+
+  return result;
+}
+
+/**
+ * @brief Initialization routine for a group of gpio pins.
+ * @param port If successful, it will be written with the data required to use
+ *              this group in the future.
+ * @param pars Structure containing all the data required to initialize this
+ *              group.
+ * @return Success / Failure
+ */
+myRet_t myGpio_InitPort(myGpioPort_t * port, myGpioPortPars_t * pars)
+{
+  myRet_t result = myRet_Fail;
+
+  if((port != NULL) && (pars != NULL))
+  {
+    myASSERT(pars->port < myGpio_GPIOCnt);
+    myASSERT((pars->mask != 0) && (pars->mask <= GPIO_PIN_All));
+    myASSERT(pars->direction <= myGpioDir_Outp);
+    myASSERT(pars->pull <= myGpioPull_Dw);
+
+    if((pars->port < myGpio_GPIOCnt) && (pars->mask != 0) && (pars->mask <= GPIO_PIN_All) && (pars->direction <= myGpioDir_Outp) && (pars->pull <= myGpioPull_Dw))
+    {
+      const uint32_t thisPort = myGpio_NextPort++;
+      myASSERT(thisPort < DRIVER_GPIO_PORT_AMOUNT);
+
+      if(thisPort >= DRIVER_GPIO_PORT_AMOUNT) { myGpio_NextPort--; }
+      else
+      {
+        myGpioPortStruct_t * strc = &myGpio_PortStruct[thisPort];
+
+        strc->GPIO = myGpio_GPIOs[pars->port];
+        strc->mask = (uint16_t) pars->mask;
+
+        configurePins(pars->port, strc->mask, pars->direction, pars->pull, myGpioIrq_None);
+
+        /* Init is complete.                                                  */
+        *port = (myGpioPort_t) strc;
+        result = myRet_OK;
+      }
+    }
+  }
+
+  return result;
+}
+
+/**
+ * @brief Gets the levels of all the pins of a group.
+ * @param port Info about the group to get the levels from.
+ * @return Levels of the pins. If routine fails, it returns zero.
+ */
+uint32_t myGpio_GetPort(myGpioPort_t port)
+{
+  uint32_t value = 0;
+  myASSERT(port != NULL);
+
+  if(port != NULL)
+  {
+    myGpioPortStruct_t * strc = (myGpioPortStruct_t *) port;
+
+    value = strc->GPIO->IDR & strc->mask;
+  }
+
+  return value;
+}
+
+/**
+ * @brief Sets some output pins of a group to high level at once.
+ * @param port Info about the group the pins belong to.
+ * @param mask One bit set for each pin to set.
+ * @return Success / Failure
+ */
+myRet_t myGpio_SetMask(myGpioPort_t port, uint32_t mask)
+{
+  myRet_t result = myRet_Fail;
+  myASSERT(port != NULL);
+
+  if(port != NULL)
+  {
+    myGpioPortStruct_t * strc = (myGpioPortStruct_t *) port;
+
+    strc->GPIO->BSRR = MY_GPIO_BSRR(mask & strc->mask, 0);
+    result = myRet_OK;
+  }
+
+  return result;
+}
+
+/**
+ * @brief Sets some output pins of a group to low level at once.
+ * @param port Info about the group the pins belong to.
+ * @param mask One bit set for each pin to clear.
+ * @return Success / Failure
+ */
+myRet_t myGpio_ClearMask(myGpioPort_t port, uint32_t mask)
+{
+  myRet_t result = myRet_Fail;
+  myASSERT(port != NULL);
+
+  if(port != NULL)
+  {
+    myGpioPortStruct_t * strc = (myGpioPortStruct_t *) port;
+
+    strc->GPIO->BRR = mask & strc->mask;
+    result = myRet_OK;
+  }
+
+  return result;
+}
+
+/**
+ * @brief Toggles the level of some output pins of a group at once.
+ * @param port Info about the group the pins belong to.
+ * @param mask One bit set for each pin to toggle.
+ * @return Success / Failure
+ */
+myRet_t myGpio_ToggleMask(myGpioPort_t port, uint32_t mask)
+{
+  myRet_t result = myRet_Fail;
+  myASSERT(port != NULL);
+
+  if(port != NULL)
+  {
+    myGpioPortStruct_t * strc = (myGpioPortStruct_t *) port;
+    const uint32_t toggle = mask & strc->mask;
+    const uint32_t odr = strc->GPIO->ODR;
+
+    /* STM32F10x has no toggle register, so the current output levels are     */
+    /*  read and the toggled ones written back through BSRR. That store only  */
+    /*  touches the toggled pins, so the others may change meanwhile.         */
+    strc->GPIO->BSRR = MY_GPIO_BSRR(~odr & toggle, odr & toggle);
+    result = myRet_OK;
+  }
+
+  return result;
+}
+
+/**
+ * @brief Writes the levels of all the output pins of a group.
+ * @param port Info about the group to write.
+ * @param value Levels of the pins, one bit per pin.
+ * @return Success / Failure
+ */
+myRet_t myGpio_WritePort(myGpioPort_t port, uint32_t value)
+{
+  myRet_t result = myRet_Fail;
+  myASSERT(port != NULL);
+
+  if(port != NULL)
+  {
+    myGpioPortStruct_t * strc = (myGpioPortStruct_t *) port;
+
+    strc->GPIO->BSRR = MY_GPIO_BSRR(value & strc->mask, ~value & strc->mask);
     result = myRet_OK;
   }
 
@@ -200,10 +436,135 @@ myRet_t myGpio_Set(myGpioPin_t pin, myGpioLvl_t lvl)
  */
 void myGpio_Reset(void)
 {
+  uint32_t line;
+
   myGpio_NextPin = 0;
+  myGpio_NextPort = 0;
+
+  for(line = myDriverPin_00; line <= myDriverPin_15; line++) { myGpio_ExtiCbks[line] = NULL; }
 }
 #endif
 
 /*******************************************************************************
  *  PRIVATE FUNCTIONS / ROUTINES
  ******************************************************************************/
+static bool irqParsAreValid(myGpioPars_t * pars)
+{
+  bool areValid = true;
+
+  /* Interrupts are only taken from input pins, and on edges. Each line is    */
+  /*  shared by the pins of that number of all ports, so only one of them can */
+  /*  interrupt.                                                              */
+  if(pars->irq != myGpioIrq_None)
+  {
+    if( (pars->direction != myGpioDir_Inpt) || (pars->cbk == NULL) ||
+        (pars->irq > myGpioIrq_Both) || (pars->pin > myDriverPin_15) ||
+        (myGpio_ExtiCbks[pars->pin] != NULL) )
+    {
+      areValid = false;
+    }
+  }
+
+  return areValid;
+}
+
+static void configurePins(uint8_t port, uint16_t mask, myGpioDir_t direction, myGpioPull_t pull, myGpioIrq_t irq)
+{
+  GPIO_InitTypeDef gpioCfg;
+
+  gpioCfg.Pin = mask;
+  gpioCfg.Speed = GPIO_SPEED_FREQ_LOW;
+
+  if(direction == myGpioDir_Outp)
+  {
+    gpioCfg.Mode = GPIO_MODE_OUTPUT_PP;
+    gpioCfg.Pull = GPIO_NOPULL;
+  }
+  else
+  {
+    switch(irq)
+    {
+      case myGpioIrq_Rise: { gpioCfg.Mode = GPIO_MODE_IT_RISING;         } break;
+      case myGpioIrq_Fall: { gpioCfg.Mode = GPIO_MODE_IT_FALLING;        } break;
+      case myGpioIrq_Both: { gpioCfg.Mode = GPIO_MODE_IT_RISING_FALLING; } break;
+      default:             { gpioCfg.Mode = GPIO_MODE_INPUT;             } break;
+    }
+
+    switch(pull)
+    {
+      case myGpioPull_Dw: { gpioCfg.Pull = GPIO_PULLDOWN;    } break;
+      case myGpioPull_Up: { gpioCfg.Pull = GPIO_PULLUP;      } break;
+      default:            { gpioCfg.Pull = GPIO_NOPULL;      } break;
+    }
+  }
+
+  /* Enable the clock for the required port and initialize these pins.        */
+  switch(port)
+  {
+    case myDriverPort_PA:  { __HAL_RCC_GPIOA_CLK_ENABLE(); } break;
+    case myDriverPort_PB:  { __HAL_RCC_GPIOB_CLK_ENABLE(); } break;
+    case myDriverPort_PC:  { __HAL_RCC_GPIOC_CLK_ENABLE(); } break;
+    case myDriverPort_PD:  { __HAL_RCC_GPIOD_CLK_ENABLE(); } break;
+    case myDriverPort_PE:  { __HAL_RCC_GPIOE_CLK_ENABLE(); } break;
+    default:               { myASSERT(false);              } break;
+  }
+
+  HAL_GPIO_Init(myGpio_GPIOs[port], &gpioCfg);
+}
+
+static void dispatchIrq(uint32_t lines)
+{
+  uint32_t pending = __HAL_GPIO_EXTI_GET_IT(lines);
+  uint32_t line;
+
+  /* All the lines read are cleared at once, before calling anyone back, so   */
+  /*  that an edge coming while the callbacks run fires the routine again.    */
+  __HAL_GPIO_EXTI_CLEAR_IT(pending);
+
+  /* Only the lines that fired are visited, highest first.                    */
+  while(pending != 0)
+  {
+    line = MY_HIGHEST_BIT(pending);
+    pending &= ~(1UL << line);
+
+    if(myGpio_ExtiCbks[line] != NULL) { myGpio_ExtiCbks[line](); }
+  }
+}
+
+/*******************************************************************************
+ *  INTERRUPT ROUTINES
+ ******************************************************************************/
+void EXTI0_IRQHandler(void)
+{
+  dispatchIrq(GPIO_PIN_0);
+}
+
+void EXTI1_IRQHandler(void)
+{
+  dispatchIrq(GPIO_PIN_1);
+}
+
+void EXTI2_IRQHandler(void)
+{
+  dispatchIrq(GPIO_PIN_2);
+}
+
+void EXTI3_IRQHandler(void)
+{
+  dispatchIrq(GPIO_PIN_3);
+}
+
+void EXTI4_IRQHandler(void)
+{
+  dispatchIrq(GPIO_PIN_4);
+}
+
+void EXTI9_5_IRQHandler(void)
+{
+  dispatchIrq(MY_GPIO_EXTI9_5_LINES);
+}
+
+void EXTI15_10_IRQHandler(void)
+{
+  dispatchIrq(MY_GPIO_EXTI15_10_LINES);
+}
@@ -0,0 +1,134 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file myGpioFast.h
+ * @brief Header file for the compile-time resolved gpio fast path of
+ *          STM32F10x devices.
+ *
+ * The routines below are inlined wherever they are called, and take the port
+ *  and the pin as constants, so the compiler resolves the register address
+ *  and the pin mask while building. Setting or clearing a pin then comes
+ *  down to a single store, with no call, no handle and no checks. Toggling
+ *  takes a load and a store, as STM32F10x has no toggle register.
+ *  They are meant for hot paths, such as bit-banging, while myGpio_Init and
+ *  the handle based routines remain for everything else.
+ *
+ * The pin must have been initialized with myGpio_Init beforehand. Passing a
+ *  port or a pin that is not a constant still works, but loses the point.
+ */
+
+#ifndef MY_GPIO_FAST_H
+#define MY_GPIO_FAST_H
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "myGpio.h"
+#include "myDriverDefs.h"
+
+#include "stm32f1xx_hal.h"
+
+/*******************************************************************************
+ *  PUBLIC DEFINITIONS
+ ******************************************************************************/
+/* Forces the routines below to be inlined, even when optimizations are off.  */
+#define MY_GPIO_FAST_INLINE         static inline __attribute__((always_inline))
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES
+ ******************************************************************************/
+/**
+ * @brief Gets the registers of a port. Being inlined with a constant port,
+ *          the switch below is resolved while building.
+ * @param port Port to get the registers of.
+ * @return Registers of the port.
+ */
+MY_GPIO_FAST_INLINE GPIO_TypeDef * myGpioFast_Base(myDriverPort_t port)
+{
+  GPIO_TypeDef * base;
+
+  switch(port)
+  {
+    case myDriverPort_PA: { base = GPIOA; } break;
+    case myDriverPort_PB: { base = GPIOB; } break;
+    case myDriverPort_PC: { base = GPIOC; } break;
+    case myDriverPort_PD: { base = GPIOD; } break;
+    default:              { base = GPIOE; } break;
+  }
+
+  return base;
+}
+
+/**
+ * @brief Sets an output pin to high level, with a single store to BSRR.
+ * @param port Port of the pin.
+ * @param pin Pin to set.
+ */
+MY_GPIO_FAST_INLINE void myGpioFast_Set(myDriverPort_t port, myDriverPin_t pin)
+{
+  myGpioFast_Base(port)->BSRR = (1UL << pin);
+}
+
+/**
+ * @brief Sets an output pin to low level, with a single store to BRR.
+ * @param port Port of the pin.
+ * @param pin Pin to clear.
+ */
+MY_GPIO_FAST_INLINE void myGpioFast_Clear(myDriverPort_t port, myDriverPin_t pin)
+{
+  myGpioFast_Base(port)->BRR = (1UL << pin);
+}
+
+/**
+ * @brief Toggles the level of an output pin. The current level is read from
+ *          ODR, and the other one written through BSRR in a single store, so
+ *          the other pins of the port are left alone.
+ * @param port Port of the pin.
+ * @param pin Pin to toggle.
+ */
+MY_GPIO_FAST_INLINE void myGpioFast_Toggle(myDriverPort_t port, myDriverPin_t pin)
+{
+  GPIO_TypeDef * const base = myGpioFast_Base(port);
+
+  base->BSRR = (1UL << pin) << (((base->ODR >> pin) & 1UL) << 4);
+}
+
+/**
+ * @brief Sets the level of an output pin. With a constant level, it is the
+ *          same as myGpioFast_Set or myGpioFast_Clear.
+ * @param port Port of the pin.
+ * @param pin Pin to write.
+ * @param lvl Level to set the pin to.
+ */
+MY_GPIO_FAST_INLINE void myGpioFast_Write(myDriverPort_t port, myDriverPin_t pin, myGpioLvl_t lvl)
+{
+  if(lvl == myGpioLvl_Lo) { myGpioFast_Clear(port, pin); }
+  else                    { myGpioFast_Set(port, pin);   }
+}
+
+/**
+ * @brief Gets the level of a pin, with a single load from IDR.
+ * @param port Port of the pin.
+ * @param pin Pin to get the level from.
+ * @return Current level.
+ */
+MY_GPIO_FAST_INLINE myGpioLvl_t myGpioFast_Get(myDriverPort_t port, myDriverPin_t pin)
+{
+  return ((myGpioFast_Base(port)->IDR >> pin) & 1UL) ? myGpioLvl_Hi : myGpioLvl_Lo;
+}
+
+#endif
@@ -0,0 +1,72 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file myIrq.c
+ * @brief Source file for the interrupt masking driver, STM32F10x
+ *          microcontrollers.
+ *
+ * Interrupts are masked through PRIMASK, which is saved and restored so that
+ *  masked sections can be nested.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "myIrq.h"
+#include "projConfig.h"
+
+#include "stm32f1xx_hal.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES
+ ******************************************************************************/
+/**
+ * @brief Masks all the interrupts.
+ * @return State of the mask before the call, to be handed to myIrq_Unlock.
+ */
+uint32_t myIrq_Lock(void)
+{
+  const uint32_t state = __get_PRIMASK();
+
+  __disable_irq();
+  return state;
+}
+
+/**
+ * @brief Restores the interrupt mask to what it was before myIrq_Lock.
+ * @param state Value returned by the matching myIrq_Lock call.
+ */
+void myIrq_Unlock(uint32_t state)
+{
+  __set_PRIMASK(state);
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
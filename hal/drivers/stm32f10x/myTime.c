@@ -0,0 +1,172 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file myTime.c
+ * @brief Source file for the system time driver, STM32F10x microcontrollers.
+ *
+ * The time is kept by the SysTick, which counts the core clock down along its
+ *  24 bits, and by its interrupt, which extends it in software by adding the
+ *  length of each wrap to a 64-bit base. Wraps are not a whole amount of us,
+ *  so their lengths are taken from a period accumulator and the base never
+ *  drifts.
+ *
+ * Readers never disable interrupts. Instead, the interrupt bumps a sequence
+ *  counter on each wrap, and a reader simply starts over if the counter
+ *  changed while it was reading. The SysTick has the highest priority, so it
+ *  is never preempted by a reader: readers that run on top of it (or with
+ *  interrupts masked) see a pending wrap and account for it themselves.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "myTime.h"
+#include "projConfig.h"
+
+#include "stm32f1xx_hal.h"
+
+#include "myPeriod.h"
+
+#include "myAssert.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define DRIVER_TIME_WRAP_COUNTS                                      (1UL << 24)
+#define DRIVER_TIME_COUNTS_MASK                    (DRIVER_TIME_WRAP_COUNTS - 1)
+#define DRIVER_TIME_US_PER_SECOND                                      (1000000)
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static volatile uint32_t myTime_Seq = 0;
+static volatile uint64_t myTime_BaseUs = 0;
+static volatile uint32_t myTime_WrapUs = 0;
+static myPeriod_t myTime_Wrap;
+static uint64_t myTime_UsPerCount = 0;
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES
+ ******************************************************************************/
+/**
+ * @brief Initialization routine for the system time. It should be called once,
+ *          after the clocks are configured, since the clock frequency is
+ *          captured here.
+ */
+void myTime_Init(void)
+{
+  const uint32_t clock = HAL_RCC_GetHCLKFreq();
+
+  /* The fixed-point conversion in myTime_Now needs a count to be no longer   */
+  /*  than a us, and no shorter than 1/256 us.                                */
+  myASSERT((clock >= DRIVER_TIME_US_PER_SECOND) && (clock <= (DRIVER_TIME_US_PER_SECOND << 8)));
+
+  SysTick->CTRL = 0;
+
+  /* This is the only division: from here on, counts are turned into us with  */
+  /*  a 32.32 fixed-point multiplication. It is rounded up so that whole us   */
+  /*  come out exact, and what it adds stays below 1/256 us over a wrap.      */
+  myTime_UsPerCount = (((uint64_t)DRIVER_TIME_US_PER_SECOND << 32) + clock - 1) / clock;
+  myPeriod_Init(&myTime_Wrap, (uint64_t)DRIVER_TIME_WRAP_COUNTS * DRIVER_TIME_US_PER_SECOND, clock);
+  myTime_BaseUs = 0;
+  myTime_WrapUs = myPeriod_Next(&myTime_Wrap);
+  myTime_Seq++;
+
+  HAL_NVIC_SetPriority(SysTick_IRQn, 0, 0);
+  SysTick->LOAD = DRIVER_TIME_WRAP_COUNTS - 1;
+  SysTick->VAL = 0;
+  SCB->ICSR = SCB_ICSR_PENDSTCLR_Msk;
+  SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk;
+}
+
+/**
+ * @brief Gets the current system time.
+ *
+ * It is lock-free: interrupts are never disabled, so it can be called from
+ *  any context, including interrupt routines.
+ *
+ * @return Time, in us, since myTime_Init was called.
+ */
+uint64_t myTime_Now(void)
+{
+  uint64_t result;
+  uint32_t seq, counts;
+
+  do
+  {
+    seq = myTime_Seq;
+    result = myTime_BaseUs;
+    counts = SysTick->VAL;
+
+    /* The counter may have wrapped without its interrupt being handled yet,  */
+    /*  either because it is about to be or because it can't preempt us. Then */
+    /*  the wrap is added here, and the counter is read again to be sure that */
+    /*  it is the one after the wrap.                                         */
+    if((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) != 0)
+    {
+      result += myTime_WrapUs;
+      counts = SysTick->VAL;
+    }
+  } while(seq != myTime_Seq);
+
+  /* The counter goes down and wraps when it reaches zero, so that is where   */
+  /*  each wrap starts. A count is at least 1/256 us below 256 MHz, so even   */
+  /*  the last one of a wrap never reaches the us where the next wrap starts  */
+  /*  and the time can't go back.                                             */
+  counts = (DRIVER_TIME_WRAP_COUNTS - counts) & DRIVER_TIME_COUNTS_MASK;
+  result += ((uint64_t)counts * myTime_UsPerCount) >> 32;
+
+  return result;
+}
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES - TEST PURPOSES
+ ******************************************************************************/
+#ifdef TEST
+/**
+ * @brief Resets driver's internal logic and its variables.
+ */
+void myTime_Reset(void)
+{
+  myTime_Seq = 0;
+  myTime_BaseUs = 0;
+  myTime_WrapUs = 0;
+  myTime_Wrap = (myPeriod_t) { 0 };
+  myTime_UsPerCount = 0;
+}
+#endif
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+
+/*******************************************************************************
+ *  INTERRUPT ROUTINES
+ ******************************************************************************/
+void SysTick_Handler(void)
+{
+  /* Readers can't preempt this routine, so the sequence only needs to change */
+  /*  once for them to notice that they were preempted by it.                 */
+  myTime_BaseUs += myTime_WrapUs;
+  myTime_WrapUs = myPeriod_Next(&myTime_Wrap);
+  myTime_Seq++;
+}
@@ -28,6 +28,11 @@
 #include "projConfig.h"
 
 #include "stm32f1xx_hal.h"
+#include "myDriverDefs.h"
+
+#include "myWheel.h"
+#include "myPeriod.h"
+#include "mySplit.h"
 
 #include "myAssert.h"
 
@@ -37,37 +42,179 @@
 /* The structure below holds all the items related to a timer instance.       */
 typedef struct
 {
+  myTimerRes_t resource;
+  myTimerMode_t mode;
   TIM_HandleTypeDef * handle;
+  IRQn_Type IRQ;
+  bool configured;
   myCbk_t cbk;
+  myPeriod_t period;
+  mySplit_t split;
+  uint32_t prescaler;
+  uint32_t periodMs;
+  uint32_t clockHz;
+  bool running;
+  uint32_t baseMs;
+  volatile uint32_t overflows;
+  uint32_t doneCounts;
+  uint32_t segment;
+  uint32_t nextSegment;
+  myWheelNode_t node;
+  uint32_t startTick;
+  uint32_t channel;
+  uint32_t counts;
+  uint16_t duty;
+  myTimerEdge_t edge;
+  myRing_t * ring;
+  bool capturing;
 } myTimerStruct_t;
 
-/* The enumeration below lists all the TPMs that are available to use.        */
+/* Set below if TIM1 and TIM2 should also be used by the driver. TIM1 isn't   */
+/*  used by default as it is an advanced timer, better kept for PWM, and TIM2 */
+/*  is the HAL time base on the board. To use it, move the time base first.   */
+#ifndef DRIVER_TIMER_USE_TIM1
+  #define DRIVER_TIMER_USE_TIM1                                                0
+#endif
+
+#ifndef DRIVER_TIMER_USE_TIM2
+  #define DRIVER_TIMER_USE_TIM2                                                0
+#endif
+
+/* The enumeration below lists all the TIMs that are available to use.        */
 typedef enum
 {
   myTimer_TIM3 = 0,
   myTimer_TIM4,
+#if DRIVER_TIMER_USE_TIM1
+  myTimer_TIM1,
+#endif
+#if DRIVER_TIMER_USE_TIM2
+  myTimer_TIM2,
+#endif
   myTimer_TIM_Count, /* Not an item! For counting only.                       */
 } myTimerTIMs_t;
 
-/* Set below the prescaler value that the peripherals will be set to use.     */
-#define DRIVER_TIMER_PRESCALER                                            (1024)
+/* The structure below holds where each timer channel is: its TIM and         */
+/*  channel, and its pin with the default pin mapping.                        */
+typedef struct
+{
+  myTimerTIMs_t TIM;
+  uint32_t channel;
+  myDriverPort_t port;
+  uint16_t pin;
+} myTimerChannel_t;
+
+/* TIM counters and prescalers are 16 bits wide.                              */
+#define DRIVER_TIMER_MAX_COUNTS                                          0x10000
+#define DRIVER_TIMER_MAX_PRESCALER                                       0x10000
+
+/* Each period is counted with the smallest prescaler that fits it, for the   */
+/*  best resolution. Free-running timers use the one below instead.           */
+#define DRIVER_TIMER_FREE_PRESCALER                                       (1024)
+
+/* Limit of period (ms) * clock (Hz) that a timer can be started with.        */
+#define DRIVER_TIMER_MAX_PERIOD         ((1000ULL * DRIVER_TIMER_MAX_PRESCALER) << 32)
+
+/* Set below the maximum amount of virtual timers that the driver can handle. */
+/*  All of them share a single TIM, which is taken at the first virtual init. */
+#ifndef DRIVER_TIMER_VIRTUAL_AMOUNT
+  #define DRIVER_TIMER_VIRTUAL_AMOUNT                                         16
+#endif
+
+/* Period, in ms, of the tick that drives the virtual timers.                 */
+#define DRIVER_TIMER_WHEEL_TICK_MS                                             1
+
+/* Limit of the time, in clock cycles * 1000, that the tick can be stopped    */
+/*  for. It is the longest that fits a single overflow of the TIM.            */
+#define DRIVER_TIMER_IDLE_MAX     (((1ULL * DRIVER_TIMER_MAX_COUNTS * DRIVER_TIMER_MAX_PRESCALER) - 1) * 1000)
 
 /*******************************************************************************
  *  PRIVATE PROTOTYPES
  ******************************************************************************/
+static myRet_t myTimer_InitDedicated(myTimer_t * timer, myTimerMode_t mode);
+static myRet_t myTimer_InitVirtual(myTimer_t * timer, myTimerMode_t mode);
+static myRet_t myTimer_InitPwm(myTimer_t * timer, uint8_t channel);
+static myRet_t myTimer_InitCapture(myTimer_t * timer, myTimerPars_t * pars);
+static myTimerStruct_t * myTimer_Take(myTimerTIMs_t thisTIM, myTimerMode_t mode);
+static myTimerStruct_t * myTimer_TakeChannel(uint8_t channel, myTimerMode_t mode, uint32_t pinMode);
+static myRet_t myTimer_StartDedicated(myTimerStruct_t * strc, uint32_t period);
+static myRet_t myTimer_StartPwm(myTimerStruct_t * strc, uint32_t period);
+static myRet_t myTimer_StartCapture(myTimerStruct_t * strc, myCbk_t cbk);
+static uint32_t myTimer_GetDutyCounts(myTimerStruct_t * strc);
+static void myTimer_StartIdle(myTimerStruct_t * strc, myTimerMode_t mode, uint64_t cycles);
+static myRet_t myTimer_Program(myTimerStruct_t * strc);
+static void myTimer_SetPeriod(myTimerStruct_t * strc, uint64_t cycles);
+static myRet_t myTimer_StartHAL(myTimerStruct_t * strc, uint32_t counts, bool onePulse);
+static void myTimer_StartFast(myTimerStruct_t * strc, uint32_t counts, bool onePulse);
+static uint32_t myTimer_GetElapsedDedicated(myTimerStruct_t * strc);
+static uint32_t myTimer_GetClockHz(myTimerTIMs_t thisTIM);
+static void myTimer_Interrupt(myTimerTIMs_t thisTIM);
+static void myTimer_Expired(myTimerStruct_t * strc);
+static void myTimer_Capture(myTimerStruct_t * strc);
+static void myTimer_Restart(myTimerStruct_t * strc, uint32_t clockHz);
+static uint32_t myTimer_GetLeft(myTimerStruct_t * strc);
+static void myTimer_CatchUp(uint32_t ticks);
+static void myTimer_IdleWake(void);
 
 /*******************************************************************************
  *  PRIVATE VARIABLES
  ******************************************************************************/
-static TIM_TypeDef * const myTimer_TIMs[] = {TIM3, TIM4};
-static const IRQn_Type myTimer_IRQs[] = { TIM3_IRQn, TIM4_IRQn };
+static TIM_TypeDef * const myTimer_TIMs[] =
+{
+  TIM3,
+  TIM4,
+#if DRIVER_TIMER_USE_TIM1
+  TIM1,
+#endif
+#if DRIVER_TIMER_USE_TIM2
+  TIM2,
+#endif
+};
+
+static const IRQn_Type myTimer_IRQs[] =
+{
+  TIM3_IRQn,
+  TIM4_IRQn,
+#if DRIVER_TIMER_USE_TIM1
+  TIM1_UP_IRQn,
+#endif
+#if DRIVER_TIMER_USE_TIM2
+  TIM2_IRQn,
+#endif
+};
+
 static const uint32_t myTimer_TIMCnt = sizeof(myTimer_TIMs) / sizeof(myTimer_TIMs[0]);
 
 static TIM_HandleTypeDef myTimer_handle[myTimer_TIM_Count];
 static myTimerStruct_t myTimer_Struct[myTimer_TIM_Count];
-static myTimerTIMs_t myTimer_NextTIM = myTimer_TIM3;
+static uint32_t myTimer_Taken = 0;
+
+static GPIO_TypeDef * const myTimer_GPIOs[] = { GPIOA, GPIOB, GPIOC, GPIOD, GPIOE };
+
+static const myTimerChannel_t myTimer_Channels[] =
+{
+  [myDriverTimerCh_TIM3_CH1_PA6] = { myTimer_TIM3, TIM_CHANNEL_1, myDriverPort_PA, GPIO_PIN_6 },
+  [myDriverTimerCh_TIM3_CH2_PA7] = { myTimer_TIM3, TIM_CHANNEL_2, myDriverPort_PA, GPIO_PIN_7 },
+  [myDriverTimerCh_TIM3_CH3_PB0] = { myTimer_TIM3, TIM_CHANNEL_3, myDriverPort_PB, GPIO_PIN_0 },
+  [myDriverTimerCh_TIM3_CH4_PB1] = { myTimer_TIM3, TIM_CHANNEL_4, myDriverPort_PB, GPIO_PIN_1 },
+  [myDriverTimerCh_TIM4_CH1_PB6] = { myTimer_TIM4, TIM_CHANNEL_1, myDriverPort_PB, GPIO_PIN_6 },
+  [myDriverTimerCh_TIM4_CH2_PB7] = { myTimer_TIM4, TIM_CHANNEL_2, myDriverPort_PB, GPIO_PIN_7 },
+  [myDriverTimerCh_TIM4_CH3_PB8] = { myTimer_TIM4, TIM_CHANNEL_3, myDriverPort_PB, GPIO_PIN_8 },
+  [myDriverTimerCh_TIM4_CH4_PB9] = { myTimer_TIM4, TIM_CHANNEL_4, myDriverPort_PB, GPIO_PIN_9 },
+};
+static const uint32_t myTimer_ChannelCnt = sizeof(myTimer_Channels) / sizeof(myTimer_Channels[0]);
+
+static myTimerStruct_t myTimer_VirtualStruct[DRIVER_TIMER_VIRTUAL_AMOUNT];
+static uint32_t myTimer_NextVirtual = 0;
+static myTimerStruct_t * myTimer_WheelTimer = NULL;
 
-static uint32_t myTimer_MaxMs;
+/* While idle, the wheel timer stops ticking and counts the whole sleep at    */
+/*  once. The times below are in clock cycles * 1000, the unit that periods   */
+/*  are set up with, and they are measured from the start of the tick that    */
+/*  was running when the system went idle.                                    */
+static bool myTimer_Idle = false;
+static uint64_t myTimer_IdleElapsed;
+static uint64_t myTimer_IdleSleep;
 
 /*******************************************************************************
  *  PUBLIC FUNCTIONS / ROUTINES
@@ -86,105 +233,342 @@ myRet_t myTimer_Init(myTimer_t * timer, myTimerPars_t * pars)
 
   if((timer != NULL) && (pars != NULL))
   {
-    myASSERT(pars->mode == myTimerMode_Periodic);
+    const myTimerMode_t mode = pars->mode;
 
-    if(pars->mode == myTimerMode_Periodic)
+    myASSERT((mode == myTimerMode_Periodic) || (mode == myTimerMode_OneShot) || (mode == myTimerMode_FreeRunning) || (mode == myTimerMode_Pwm) || (mode == myTimerMode_Capture));
+    myASSERT((pars->resource == myTimerRes_Dedicated) || (pars->resource == myTimerRes_Virtual));
+
+    /* PWM and capture timers use a channel of the TIM itself, so they are    */
+    /*  always dedicated ones.                                                */
+    if((mode == myTimerMode_Pwm) || (mode == myTimerMode_Capture))
     {
-      /* Proceed with initialization only if there is a TIM available.          */
-      const myTimerTIMs_t thisTIM = myTimer_NextTIM++;
+      myASSERT(pars->resource == myTimerRes_Dedicated);
+      if(pars->resource == myTimerRes_Dedicated)
+      {
+        if(mode == myTimerMode_Pwm) { result = myTimer_InitPwm(timer, pars->channel); }
+        else                        { result = myTimer_InitCapture(timer, pars);     }
+      }
+    }
+    else if((mode == myTimerMode_Periodic) || (mode == myTimerMode_OneShot) || (mode == myTimerMode_FreeRunning))
+    {
+      switch(pars->resource)
+      {
+        case myTimerRes_Dedicated: { result = myTimer_InitDedicated(timer, mode); } break;
+        case myTimerRes_Virtual:   { result = myTimer_InitVirtual(timer, mode);   } break;
+        default:                   {                                              } break;
+      }
+    }
+  }
 
-      myASSERT(myTimer_TIMCnt == myTimer_TIM_Count);
-      myASSERT(thisTIM < myTimer_TIMCnt);
+  return result;
+}
 
-      if(thisTIM >= myTimer_TIMCnt) { myTimer_NextTIM--; }
-      else
+/**
+ * @brief Starts the time counting operation for a timer.
+ * @param timer Timer to start the operation
+ * @param period Time, in ms, to count. Ignored by free-running and capture
+ *          timers. For PWM timers, it is the period of the output.
+ * @param cbk Callback to be called when timer expires. Ignored by
+ *          free-running and PWM timers. For capture timers, it is optional
+ *          and called when a timestamp is pushed into an empty ring, so that
+ *          the consumer is only woken up once for each batch.
+ * @return Success / Failure. If successful, timer will start and callback
+ *          will eventually be called. Periodic and one-shot timers fail
+ *          without a period or a callback, and PWM timers without a period.
+ *          Dedicated timers fail if the period is beyond what their hardware
+ *          can count, which is over 45 days with a 72 MHz TIM clock. PWM
+ *          timers fail if the period does not fit a single overflow of their
+ *          hardware, which is over 59 s. Timers also fail if the HAL fails to
+ *          set up their TIM.
+ */
+myRet_t myTimer_Start(myTimer_t timer, uint32_t period, myCbk_t cbk)
+{
+  myRet_t result = myRet_Fail;
+  myTimerStruct_t * strc = (myTimerStruct_t *) timer;
+
+  if((strc != NULL) && (strc->mode == myTimerMode_Pwm))
+  {
+    if(period != 0) { result = myTimer_StartPwm(strc, period); }
+  }
+  else if((strc != NULL) && (strc->mode == myTimerMode_Capture))
+  {
+    result = myTimer_StartCapture(strc, cbk);
+  }
+  else if((strc != NULL) && ((strc->mode == myTimerMode_FreeRunning) || ((period != 0) && (cbk != NULL))))
+  {
+    if(strc->resource == myTimerRes_Virtual)
+    {
+      /* The wheel is only touched by the tick interrupt, so masking it is    */
+      /*  enough to keep it consistent while the timer is scheduled.          */
+      const uint32_t ticks = period / DRIVER_TIMER_WHEEL_TICK_MS;
+
+      HAL_NVIC_DisableIRQ(myTimer_WheelTimer->IRQ);
+      switch(strc->mode)
       {
-        TIM_TypeDef * const periph = myTimer_TIMs[thisTIM];
-        const IRQn_Type IRQ = myTimer_IRQs[thisTIM];
-        myTimerStruct_t * const strc = &myTimer_Struct[thisTIM];
-        TIM_HandleTypeDef * const handle = &myTimer_handle[thisTIM];
-        const uint32_t freq = HAL_RCC_GetPCLK1Freq();
+        case myTimerMode_Periodic:    { myWheel_Start(&strc->node, ticks, ticks, cbk); } break;
+        case myTimerMode_OneShot:     { myWheel_Start(&strc->node, ticks, 0, cbk);     } break;
+        case myTimerMode_FreeRunning: { strc->startTick = myWheel_GetTicks();         } break;
+        default:                      {                                               } break;
+      }
+      HAL_NVIC_EnableIRQ(myTimer_WheelTimer->IRQ);
 
-        strc->handle = handle;
-        strc->cbk = NULL;
+      result = myRet_OK;
+    }
+    else
+    {
+      strc->cbk = (strc->mode == myTimerMode_FreeRunning) ? NULL : cbk;
+      result = myTimer_StartDedicated(strc, period);
+    }
+  }
 
-        /* Calculate the maximum period that the TIM will be able to count.   */
-        myASSERT(freq != 0);
-        myTimer_MaxMs = (uint32_t)(((uint64_t)0x10000 * DRIVER_TIMER_PRESCALER * 1000) / freq);
-
-        /* Prepare fields. Peripheral is not set now but when client requests */
-        /*  to start it, which will be later.                                 */
-        handle->Instance = periph;
-        handle->Init.CounterMode = TIM_COUNTERMODE_UP;
-        handle->Init.Prescaler = DRIVER_TIMER_PRESCALER;
-        handle->Init.ClockDivision = 0;
-        handle->Init.RepetitionCounter = 0;
-        handle->Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE;
-
-        /* Enable the required clock and interrupt.                           */
-        switch(thisTIM)
-        {
-          case myTimer_TIM3: { __HAL_RCC_TIM3_CLK_ENABLE(); } break;
-          case myTimer_TIM4: { __HAL_RCC_TIM4_CLK_ENABLE(); } break;
-          default:           { myASSERT(false);             } break;
-        }
+  return result;
+}
+
+/**
+ * @brief Stops the time counting operation for a timer.
+ * @param timer Timer to stop the operation
+ * @return Success / Failure. If successful, callback won't be called anymore
+ *          until the timer is started again.
+ */
+myRet_t myTimer_Stop(myTimer_t timer)
+{
+  myRet_t result = myRet_Fail;
 
-        HAL_NVIC_SetPriority(IRQ, 15, 0);
-        HAL_NVIC_EnableIRQ(IRQ);
+  if(timer != NULL)
+  {
+    myTimerStruct_t * strc = (myTimerStruct_t *) timer;
 
-        /* Initialization is complete.                                        */
-        *timer = (myTimer_t) strc;
-        result = myRet_OK;
+    if(strc->resource == myTimerRes_Virtual)
+    {
+      HAL_NVIC_DisableIRQ(myTimer_WheelTimer->IRQ);
+      myWheel_Stop(&strc->node);
+      HAL_NVIC_EnableIRQ(myTimer_WheelTimer->IRQ);
+    }
+    else
+    {
+      if(strc->mode == myTimerMode_Pwm)
+      {
+        HAL_TIM_PWM_Stop(strc->handle, strc->channel);
       }
+      else if(strc->mode == myTimerMode_Capture)
+      {
+        /* The interrupt is masked first, so that nothing else is pushed into */
+        /*  the ring once this returns.                                       */
+        HAL_NVIC_DisableIRQ(strc->IRQ);
+        HAL_TIM_IC_Stop_IT(strc->handle, strc->channel);
+        __HAL_TIM_DISABLE_IT(strc->handle, TIM_IT_UPDATE);
+        strc->capturing = false;
+      }
+      else
+      {
+        HAL_TIM_Base_Stop_IT(strc->handle);
+      }
+      strc->periodMs = 0;
+      strc->running = false;
     }
+
+    result = myRet_OK;
   }
 
   return result;
 }
 
 /**
- * @brief Starts the time counting operation for a timer.
- * @param timer Timer to start the operation
- * @param period Time, in ms, to count
- * @param cbk Callback to be called when timer expires
- * @return Success / Failure. If successful, timer will start and callback
- *          will eventually be called.
+ * @brief Sets the duty cycle of a PWM timer. It can be called whether the
+ *          timer is running or not.
+ *
+ * The compare register is preloaded, so the TIM only loads the new value at
+ *  the update event, which starts the next period.
+ *
+ * @param timer PWM timer to set
+ * @param duty Share of the period that the output is active, from zero, for
+ *          never, up to MY_TIMER_DUTY_MAX, for always.
+ * @return Success / Failure. Fails if the timer is not a PWM one.
  */
-myRet_t myTimer_Start(myTimer_t timer, uint32_t period, myCbk_t cbk)
+myRet_t myTimer_SetDuty(myTimer_t timer, uint16_t duty)
 {
   myRet_t result = myRet_Fail;
+  myTimerStruct_t * strc = (myTimerStruct_t *) timer;
+
+  if((strc != NULL) && (strc->mode == myTimerMode_Pwm))
+  {
+    strc->duty = duty;
+    if(strc->periodMs != 0)
+    {
+      __HAL_TIM_SET_COMPARE(strc->handle, strc->channel, myTimer_GetDutyCounts(strc));
+    }
+
+    result = myRet_OK;
+  }
+
+  return result;
+}
 
-  myASSERT(period < myTimer_MaxMs);
+/**
+ * @brief Gets the time elapsed since a free-running timer was started.
+ * @param timer Free-running timer to read
+ * @return Time, in ms, since the timer was started. Zero if the timer is not
+ *          a free-running one.
+ */
+uint32_t myTimer_GetElapsed(myTimer_t timer)
+{
+  uint32_t elapsed = 0;
+  myTimerStruct_t * strc = (myTimerStruct_t *) timer;
+
+  myASSERT(strc != NULL);
 
-  if((timer != NULL) && (period != 0) && (cbk != NULL))
+  if((strc != NULL) && (strc->mode == myTimerMode_FreeRunning))
   {
-    myTimerStruct_t * strc = (myTimerStruct_t *) timer;
-    TIM_HandleTypeDef * handle = strc->handle;
-    HAL_StatusTypeDef status;
-    uint32_t counter;
+    /* Wheel ticks are 1 ms long and the tick count is read atomically.       */
+    if(strc->resource == myTimerRes_Virtual) { elapsed = myWheel_GetTicks() - strc->startTick; }
+    else                                     { elapsed = myTimer_GetElapsedDedicated(strc);   }
+  }
 
-    strc->cbk = cbk;
+  return elapsed;
+}
 
-    /* Calculate the counter value to be set in the peripheral and put it.    */
-    counter = (0x10000 * period) / myTimer_MaxMs;
-    handle->Init.Period = counter - 1;
+/**
+ * @brief Gets the rate of the timestamps of a capture timer.
+ *
+ * Timestamps are the counts of the hardware timer at full resolution,
+ *  extended to 32 bits with its overflows, so they wrap around at 2^32. The
+ *  time between two edges is the difference of their timestamps over the
+ *  rate, as long as it is shorter than a wrap around.
+ *
+ * @param timer Capture timer to read
+ * @return Counts per second of the timestamps since the timer was last
+ *          started. Zero if it is not a started capture timer.
+ */
+uint32_t myTimer_GetCaptureHz(myTimer_t timer)
+{
+  uint32_t rate = 0;
+  myTimerStruct_t * strc = (myTimerStruct_t *) timer;
 
-    /* Make sure that peripheral is stopped, then (re)init it and start it.   */
-    HAL_TIM_Base_Stop_IT(handle);
+  myASSERT(strc != NULL);
 
-    status = HAL_TIM_Base_Init(handle);
-    myASSERT(status == HAL_OK);
+  if((strc != NULL) && (strc->mode == myTimerMode_Capture) && strc->capturing) { rate = strc->clockHz; }
 
-    if(status == HAL_OK)
+  return rate;
+}
+
+/**
+ * @brief Refreshes the clock settings that the driver keeps. Should be called
+ *          whenever the clock configuration changes.
+ *
+ * Every running timer carries on with the new settings. Periodic and PWM
+ *  timers are restarted with their period, one-shot timers with the time they
+ *  had left, and free-running timers keep counting from the time they had
+ *  elapsed. Capture timers keep their timestamps, which just count at the new
+ *  rate from then on.
+ */
+void myTimer_ClockUpdate(void)
+{
+  myTimerTIMs_t thisTIM;
+
+  /* The new clock may need another prescaler, so running timers are          */
+  /*  restarted.                                                              */
+  for(thisTIM = myTimer_TIM3; thisTIM < myTimer_TIM_Count; thisTIM++)
+  {
+    myTimerStruct_t * const strc = &myTimer_Struct[thisTIM];
+
+    if((myTimer_Taken & (1UL << thisTIM)) != 0)
     {
-      status = HAL_TIM_Base_Start_IT(handle);
-      myASSERT(status == HAL_OK);
+      const uint32_t clockHz = myTimer_GetClockHz(thisTIM);
 
-      if(status == HAL_OK) { result = myRet_OK; }
+      if(strc->running) { myTimer_Restart(strc, clockHz); }
+      else              { strc->clockHz = clockHz;        }
     }
   }
+}
 
-  return result;
+/**
+ * @brief Stops the tick of the virtual timers for as long as none of them
+ *          needs it. It should be called with interrupts masked.
+ * @return Time, in us, until the programmed wakeup. Zero if the tick was not
+ *          stopped.
+ */
+uint32_t myTimer_IdleEnter(void)
+{
+  myTimerStruct_t * const strc = myTimer_WheelTimer;
+  uint32_t sleepUs = 0;
+
+  /* The tick only stops if the next one has nothing to do. A realignment     */
+  /*  that is still pending from the last idle period must run first, too.    */
+  if((strc != NULL) && !myTimer_Idle)
+  {
+    TIM_HandleTypeDef * const handle = strc->handle;
+    const uint64_t tick = (uint64_t)DRIVER_TIMER_WHEEL_TICK_MS * strc->clockHz;
+    uint64_t ticks = myWheel_GetNextEvent();
+
+    if(ticks > 1)
+    {
+      /* The TIM is stopped before it is read, so that no tick can be lost    */
+      /*  in between. If one is already pending, it is served first.          */
+      handle->Instance->CR1 &= ~TIM_CR1_CEN;
+      if(__HAL_TIM_GET_FLAG(handle, TIM_FLAG_UPDATE))
+      {
+        handle->Instance->CR1 |= TIM_CR1_CEN;
+      }
+      else
+      {
+        if(ticks > (DRIVER_TIMER_IDLE_MAX / tick)) { ticks = DRIVER_TIMER_IDLE_MAX / tick; }
+        myTimer_IdleElapsed = (uint64_t)__HAL_TIM_GET_COUNTER(handle) * strc->prescaler * 1000;
+        myTimer_IdleSleep = (ticks * tick) - myTimer_IdleElapsed;
+        myTimer_Idle = true;
+
+        /* The sleep is counted as a periodic timer, so that the counter      */
+        /*  keeps going after it ends, until the system is up to read it.     */
+        strc->cbk = NULL;
+        myTimer_StartIdle(strc, myTimerMode_Periodic, myTimer_IdleSleep);
+        sleepUs = (uint32_t)((myTimer_IdleSleep * 1000) / strc->clockHz);
+      }
+    }
+  }
+
+  return sleepUs;
+}
+
+/**
+ * @brief Brings back the tick of the virtual timers after the system woke up.
+ *          It should be called before interrupts are unmasked.
+ */
+void myTimer_IdleExit(void)
+{
+  myTimerStruct_t * const strc = myTimer_WheelTimer;
+
+  if((strc != NULL) && myTimer_Idle && (strc->mode == myTimerMode_Periodic))
+  {
+    TIM_HandleTypeDef * const handle = strc->handle;
+    const uint64_t tick = (uint64_t)DRIVER_TIMER_WHEEL_TICK_MS * strc->clockHz;
+    uint64_t elapsed = myTimer_IdleElapsed;
+    uint64_t rest;
+    uint32_t ticks;
+
+    /* The sleep may have ended already, or the system may have been woken    */
+    /*  up earlier by something else. If the counter wrapped around, the      */
+    /*  whole sleep went by before what it counts now.                        */
+    handle->Instance->CR1 &= ~TIM_CR1_CEN;
+    if(__HAL_TIM_GET_FLAG(handle, TIM_FLAG_UPDATE))
+    {
+      elapsed += myTimer_IdleSleep;
+    }
+    elapsed += (uint64_t)__HAL_TIM_GET_COUNTER(handle) * strc->prescaler * 1000;
+
+    /* The ticks that went by are caught up at once, and the TIM is set to    */
+    /*  expire at the next tick boundary, where the regular tick restarts.    */
+    /*  A boundary closer than a single count is left for the next tick.      */
+    ticks = (uint32_t)(elapsed / tick);
+    rest = ((ticks + 1) * tick) - elapsed;
+    if(rest < 1000)
+    {
+      ticks++;
+      rest += tick;
+    }
+
+    strc->cbk = myTimer_IdleWake;
+    myTimer_StartIdle(strc, myTimerMode_OneShot, rest);
+    myTimer_CatchUp(ticks);
+  }
 }
 
 /*******************************************************************************
@@ -196,32 +580,756 @@ myRet_t myTimer_Start(myTimer_t timer, uint32_t period, myCbk_t cbk)
  */
 void myTimer_Reset(void)
 {
-  myTimer_NextTIM = myTimer_TIM3;
+  myTimer_Taken = 0;
+  myTimer_NextVirtual = 0;
+  myTimer_WheelTimer = NULL;
+  myTimer_Idle = false;
+  myWheel_Reset();
 }
 #endif
 
 /*******************************************************************************
- *  CALLBACK ROUTINES
+ *  PRIVATE FUNCTIONS / ROUTINES
  ******************************************************************************/
-void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
+static myRet_t myTimer_InitDedicated(myTimer_t * timer, myTimerMode_t mode)
 {
-  myTimerTIMs_t thisTIM;
-  bool foundTIM = false;
+  myRet_t result = myRet_Fail;
+  myTimerTIMs_t thisTIM = myTimer_TIM3;
+
+  myASSERT(myTimer_TIMCnt == myTimer_TIM_Count);
+
+  /* Proceed with initialization only if there is a TIM available. They are   */
+  /*  taken in order, skipping the ones that channel timers took already.     */
+  while((thisTIM < myTimer_TIM_Count) && ((myTimer_Taken & (1UL << thisTIM)) != 0)) { thisTIM++; }
+
+  myASSERT(thisTIM < myTimer_TIM_Count);
+
+  if(thisTIM < myTimer_TIM_Count)
+  {
+    myTimerStruct_t * const strc = myTimer_Take(thisTIM, mode);
+
+    HAL_NVIC_SetPriority(strc->IRQ, 15, 0);
+    HAL_NVIC_EnableIRQ(strc->IRQ);
+
+    /* Initialization is complete.                                            */
+    *timer = (myTimer_t) strc;
+    result = myRet_OK;
+  }
+
+  return result;
+}
+
+static myRet_t myTimer_InitVirtual(myTimer_t * timer, myTimerMode_t mode)
+{
+  myRet_t result = myRet_Fail;
+
+  /* The first virtual timer takes a TIM to be the wheel's tick source.       */
+  if(myTimer_WheelTimer == NULL)
+  {
+    myTimer_t wheelTimer;
+
+    if(myTimer_InitDedicated(&wheelTimer, myTimerMode_Periodic) == myRet_OK)
+    {
+      myTimerStruct_t * const strc = (myTimerStruct_t *) wheelTimer;
+
+      strc->cbk = myWheel_Tick;
+      if(myTimer_StartDedicated(strc, DRIVER_TIMER_WHEEL_TICK_MS) == myRet_OK)
+      {
+        myTimer_WheelTimer = strc;
+      }
+    }
+  }
+
+  if(myTimer_WheelTimer != NULL)
+  {
+    /* Proceed with initialization only if there is a virtual timer left.     */
+    const uint32_t thisVirtual = myTimer_NextVirtual++;
+
+    myASSERT(thisVirtual < DRIVER_TIMER_VIRTUAL_AMOUNT);
+
+    if(thisVirtual >= DRIVER_TIMER_VIRTUAL_AMOUNT) { myTimer_NextVirtual--; }
+    else
+    {
+      myTimerStruct_t * strc = &myTimer_VirtualStruct[thisVirtual];
+
+      strc->resource = myTimerRes_Virtual;
+      strc->mode = mode;
+      strc->node = (myWheelNode_t) { 0 };
+
+      *timer = (myTimer_t) strc;
+      result = myRet_OK;
+    }
+  }
+
+  return result;
+}
+
+static myRet_t myTimer_InitPwm(myTimer_t * timer, uint8_t channel)
+{
+  myRet_t result = myRet_Fail;
+
+  /* The pin is handed to the TIM as an alternate function output. The TIM    */
+  /*  raises no interrupt in PWM mode, so its IRQ is left disabled.           */
+  myTimerStruct_t * const strc = myTimer_TakeChannel(channel, myTimerMode_Pwm, GPIO_MODE_AF_PP);
+
+  if(strc != NULL)
+  {
+    strc->duty = 0;
+
+    *timer = (myTimer_t) strc;
+    result = myRet_OK;
+  }
+
+  return result;
+}
+
+static myRet_t myTimer_InitCapture(myTimer_t * timer, myTimerPars_t * pars)
+{
+  myRet_t result = myRet_Fail;
+  myTimerStruct_t * strc = NULL;
+
+  myASSERT(pars->ring != NULL);
+  myASSERT(pars->edge <= myTimerEdge_Both);
+
+  /* The TIM reads the pin as a floating input, which needs no remapping.     */
+  if((pars->ring != NULL) && (pars->edge <= myTimerEdge_Both))
+  {
+    strc = myTimer_TakeChannel(pars->channel, myTimerMode_Capture, GPIO_MODE_INPUT);
+  }
+
+  if(strc != NULL)
+  {
+    strc->ring = pars->ring;
+    strc->edge = pars->edge;
+    strc->capturing = false;
+
+    /* The interrupt is only unmasked at start, so that nothing is pushed     */
+    /*  into the ring before that.                                            */
+    HAL_NVIC_SetPriority(strc->IRQ, 15, 0);
+
+    *timer = (myTimer_t) strc;
+    result = myRet_OK;
+  }
+
+  return result;
+}
+
+static myTimerStruct_t * myTimer_Take(myTimerTIMs_t thisTIM, myTimerMode_t mode)
+{
+  TIM_TypeDef * const periph = myTimer_TIMs[thisTIM];
+  myTimerStruct_t * const strc = &myTimer_Struct[thisTIM];
+  TIM_HandleTypeDef * const handle = &myTimer_handle[thisTIM];
+
+  myTimer_Taken |= (1UL << thisTIM);
+
+  strc->resource = myTimerRes_Dedicated;
+  strc->mode = mode;
+  strc->handle = handle;
+  strc->IRQ = myTimer_IRQs[thisTIM];
+  strc->configured = false;
+  strc->cbk = NULL;
+  strc->periodMs = 0;
+  strc->running = false;
+  strc->prescaler = DRIVER_TIMER_FREE_PRESCALER;
+
+  /* Prepare fields. Peripheral is not set now but when client requests       */
+  /*  to start it, which will be later.                                       */
+  handle->Instance = periph;
+  handle->Init.CounterMode = TIM_COUNTERMODE_UP;
+  handle->Init.Prescaler = DRIVER_TIMER_FREE_PRESCALER - 1;
+  handle->Init.ClockDivision = 0;
+  handle->Init.RepetitionCounter = 0;
+  handle->Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE;
+
+  /* Enable the required clock.                                               */
+  switch(thisTIM)
+  {
+    case myTimer_TIM3: { __HAL_RCC_TIM3_CLK_ENABLE(); } break;
+    case myTimer_TIM4: { __HAL_RCC_TIM4_CLK_ENABLE(); } break;
+#if DRIVER_TIMER_USE_TIM1
+    case myTimer_TIM1: { __HAL_RCC_TIM1_CLK_ENABLE(); } break;
+#endif
+#if DRIVER_TIMER_USE_TIM2
+    case myTimer_TIM2: { __HAL_RCC_TIM2_CLK_ENABLE(); } break;
+#endif
+    default:           { myASSERT(false);             } break;
+  }
+
+  strc->clockHz = myTimer_GetClockHz(thisTIM);
+
+  return strc;
+}
+
+static myTimerStruct_t * myTimer_TakeChannel(uint8_t channel, myTimerMode_t mode, uint32_t pinMode)
+{
+  myTimerStruct_t * strc = NULL;
 
-  for(thisTIM = 0; thisTIM < myTimer_TIM_Count; thisTIM++)
+  myASSERT(channel < myTimer_ChannelCnt);
+
+  /* Proceed only if the TIM of the channel is available.                     */
+  if((channel < myTimer_ChannelCnt) && ((myTimer_Taken & (1UL << myTimer_Channels[channel].TIM)) == 0))
   {
-    if(&myTimer_handle[thisTIM] == htim)
+    const myTimerChannel_t * const chnl = &myTimer_Channels[channel];
+    GPIO_InitTypeDef gpioCfg;
+
+    strc = myTimer_Take(chnl->TIM, mode);
+    strc->channel = chnl->channel;
+
+    switch(chnl->port)
     {
-      myTimerStruct_t * strc = &myTimer_Struct[thisTIM];
-      const myCbk_t cbk = strc->cbk;
+      case myDriverPort_PA: { __HAL_RCC_GPIOA_CLK_ENABLE(); } break;
+      case myDriverPort_PB: { __HAL_RCC_GPIOB_CLK_ENABLE(); } break;
+      default:              { myASSERT(false);              } break;
+    }
+
+    gpioCfg.Pin = chnl->pin;
+    gpioCfg.Mode = pinMode;
+    gpioCfg.Pull = GPIO_NOPULL;
+    gpioCfg.Speed = GPIO_SPEED_FREQ_LOW;
+    HAL_GPIO_Init(myTimer_GPIOs[chnl->port], &gpioCfg);
+  }
+
+  return strc;
+}
+
+static myRet_t myTimer_StartDedicated(myTimerStruct_t * strc, uint32_t period)
+{
+  myRet_t result = myRet_Fail;
+
+  /* Even at the largest prescaler, the counts of a period must fit in 32     */
+  /*  bits. That is over 45 days with the fastest TIM clock.                  */
+  if((strc->mode == myTimerMode_FreeRunning) || (((uint64_t)period * strc->clockHz) < DRIVER_TIMER_MAX_PERIOD))
+  {
+    /* The interrupt is masked so that it doesn't use the period while it is  */
+    /*  set up.                                                               */
+    HAL_NVIC_DisableIRQ(strc->IRQ);
+    strc->periodMs = period;
+    strc->running = true;
+    strc->baseMs = 0;
+    strc->overflows = 0;
+
+    if(strc->mode == myTimerMode_FreeRunning) { strc->prescaler = DRIVER_TIMER_FREE_PRESCALER;            }
+    else                                      { myTimer_SetPeriod(strc, (uint64_t)period * strc->clockHz); }
+
+    result = myTimer_Program(strc);
+    HAL_NVIC_EnableIRQ(strc->IRQ);
+  }
+
+  return result;
+}
+
+static myRet_t myTimer_StartPwm(myTimerStruct_t * strc, uint32_t period)
+{
+  myRet_t result = myRet_Fail;
+  const uint64_t cycles = (uint64_t)period * strc->clockHz;
+  TIM_HandleTypeDef * const handle = strc->handle;
+
+  /* The whole period must fit a single overflow, as the output can't be      */
+  /*  split into several of them. The fraction of a count that it may have    */
+  /*  is dropped, as only the duty cycle matters for an output like this. As  */
+  /*  the smallest prescaler that fits is taken, ARR is always below 0xFFFF,  */
+  /*  so a compare value above it can keep the output always active.          */
+  if(cycles < (1000ULL * DRIVER_TIMER_MAX_COUNTS * DRIVER_TIMER_MAX_PRESCALER))
+  {
+    TIM_OC_InitTypeDef ocCfg = { 0 };
+    HAL_StatusTypeDef status;
+
+    myTimer_SetPeriod(strc, cycles);
+    strc->counts = myPeriod_GetWhole(&strc->period);
+    strc->periodMs = period;
+    handle->Init.Prescaler = strc->prescaler - 1;
+    handle->Init.Period = strc->counts - 1;
+
+    /* The channel is set up as PWM mode 1, which starts each period with the */
+    /*  output active until the counter reaches the compare value. The HAL    */
+    /*  sets the compare register as preloaded.                               */
+    ocCfg.OCMode = TIM_OCMODE_PWM1;
+    ocCfg.Pulse = myTimer_GetDutyCounts(strc);
+    ocCfg.OCPolarity = TIM_OCPOLARITY_HIGH;
+    ocCfg.OCFastMode = TIM_OCFAST_DISABLE;
+
+    HAL_TIM_PWM_Stop(handle, strc->channel);
+    status = HAL_TIM_PWM_Init(handle);
+    if(status == HAL_OK) { status = HAL_TIM_PWM_ConfigChannel(handle, &ocCfg, strc->channel); }
+    if(status == HAL_OK) { status = HAL_TIM_PWM_Start(handle, strc->channel);                 }
+    myASSERT(status == HAL_OK);
+
+    if(status == HAL_OK) { result = myRet_OK;  }
+    else                 { strc->periodMs = 0; }
+    strc->running = (status == HAL_OK);
+  }
+
+  return result;
+}
+
+static myRet_t myTimer_StartCapture(myTimerStruct_t * strc, myCbk_t cbk)
+{
+  myRet_t result = myRet_Fail;
+  TIM_HandleTypeDef * const handle = strc->handle;
+  TIM_IC_InitTypeDef icCfg = { 0 };
+  HAL_StatusTypeDef status;
+
+  /* Capture timers count at the full clock, through the whole 16 bits of     */
+  /*  the TIM, so that each overflow is just the upper half of a timestamp.   */
+  HAL_NVIC_DisableIRQ(strc->IRQ);
+  HAL_TIM_IC_Stop_IT(handle, strc->channel);
+  strc->cbk = cbk;
+  strc->overflows = 0;
+  strc->prescaler = 1;
+  handle->Init.Prescaler = 0;
+  handle->Init.Period = DRIVER_TIMER_MAX_COUNTS - 1;
+
+  /* F1 TIMs can't capture both edges at once, so those timers start on the   */
+  /*  rising one and flip the polarity after each capture.                    */
+  icCfg.ICPolarity = (strc->edge == myTimerEdge_Fall) ? TIM_ICPOLARITY_FALLING : TIM_ICPOLARITY_RISING;
+  icCfg.ICSelection = TIM_ICSELECTION_DIRECTTI;
+  icCfg.ICPrescaler = TIM_ICPSC_DIV1;
+  icCfg.ICFilter = 0;
+
+  status = HAL_TIM_IC_Init(handle);
+  if(status == HAL_OK) { status = HAL_TIM_IC_ConfigChannel(handle, &icCfg, strc->channel); }
+  if(status == HAL_OK)
+  {
+    /* The init forces an update event, which raises the update flag, so it   */
+    /*  is dropped with anything else left from a previous run. Overflows     */
+    /*  interrupt along with the edges, so that the timestamps count them.    */
+    __HAL_TIM_CLEAR_FLAG(handle, TIM_FLAG_UPDATE | (TIM_SR_CC1IF << (strc->channel >> 2)));
+    __HAL_TIM_ENABLE_IT(handle, TIM_IT_UPDATE);
+    status = HAL_TIM_IC_Start_IT(handle, strc->channel);
+  }
+  myASSERT(status == HAL_OK);
 
-      foundTIM = true;
-      if(cbk != NULL) { cbk(); }
-      break;
+  if(status == HAL_OK)
+  {
+    strc->capturing = true;
+    strc->running = true;
+    HAL_NVIC_EnableIRQ(strc->IRQ);
+    result = myRet_OK;
+  }
+
+  return result;
+}
+
+static uint32_t myTimer_GetDutyCounts(myTimerStruct_t * strc)
+{
+  /* The output is active while the counter is below the compare value, so    */
+  /*  the full duty cycle takes the whole period, which is above ARR.         */
+  uint32_t counts = strc->counts;
+
+  if(strc->duty != MY_TIMER_DUTY_MAX) { counts = ((uint32_t)strc->duty * counts) >> 16; }
+
+  return counts;
+}
+
+static void myTimer_StartIdle(myTimerStruct_t * strc, myTimerMode_t mode, uint64_t cycles)
+{
+  /* Same as starting the timer, but the period is given in clock cycles      */
+  /*  * 1000 instead of ms, and any interrupt left pending by the tick is     */
+  /*  dropped, as it would be taken for the end of this period.               */
+  HAL_NVIC_DisableIRQ(strc->IRQ);
+  strc->handle->Instance->CR1 &= ~TIM_CR1_CEN;
+  __HAL_TIM_CLEAR_FLAG(strc->handle, TIM_FLAG_UPDATE);
+  HAL_NVIC_ClearPendingIRQ(strc->IRQ);
+  strc->mode = mode;
+  strc->running = true;
+  strc->overflows = 0;
+
+  myTimer_SetPeriod(strc, cycles);
+  myTimer_Program(strc);
+  HAL_NVIC_EnableIRQ(strc->IRQ);
+}
+
+static myRet_t myTimer_Program(myTimerStruct_t * strc)
+{
+  myRet_t result = myRet_OK;
+  bool onePulse = false;
+  uint32_t counts;
+
+  /* Free-running timers just let the counter wrap around. Otherwise, the     */
+  /*  period is split into as many overflows as needed, and a one-shot timer  */
+  /*  that fits in a single one is stopped by the TIM itself.                 */
+  if(strc->mode == myTimerMode_FreeRunning)
+  {
+    counts = DRIVER_TIMER_MAX_COUNTS;
+  }
+  else
+  {
+    mySplit_Init(&strc->split, DRIVER_TIMER_MAX_COUNTS);
+    counts = mySplit_Next(&strc->split, &strc->period);
+    strc->doneCounts = 0;
+    strc->segment = counts;
+    strc->nextSegment = 0;
+    onePulse = (strc->mode == myTimerMode_OneShot) && !mySplit_IsPending(&strc->split);
+  }
+
+  /* The whole HAL init is only needed once. After that, restarting the TIM   */
+  /*  with another period is just a matter of a few register writes.          */
+  if(strc->configured) { myTimer_StartFast(strc, counts, onePulse);          }
+  else                 { result = myTimer_StartHAL(strc, counts, onePulse); }
+
+  /* ARR is preloaded and only gets active at the next update event, so the   */
+  /*  segment after the current one is always queued, if there is one.        */
+  if((result == myRet_OK) && ((strc->mode == myTimerMode_Periodic) || ((strc->mode == myTimerMode_OneShot) && mySplit_IsPending(&strc->split))))
+  {
+    counts = mySplit_Next(&strc->split, &strc->period);
+    __HAL_TIM_SET_AUTORELOAD(strc->handle, counts - 1);
+    strc->nextSegment = counts;
+  }
+
+  return result;
+}
+
+static void myTimer_SetPeriod(myTimerStruct_t * strc, uint64_t cycles)
+{
+  const uint64_t wraps = cycles / (1000ULL * DRIVER_TIMER_MAX_COUNTS);
+
+  /* The period lasts cycles / (1000 * prescaler) counts, where cycles is the */
+  /*  period in ms times clockHz, which is seldom a whole number. The         */
+  /*  accumulator spreads the fraction over the periods so that they add up   */
+  /*  to the exact time. The smallest prescaler that fits the TIM is one more */
+  /*  than the times the undivided counts wrap around it. Longer periods take */
+  /*  the largest one, to be split.                                           */
+  strc->prescaler = (wraps < DRIVER_TIMER_MAX_PRESCALER) ? ((uint32_t)wraps + 1) : DRIVER_TIMER_MAX_PRESCALER;
+  myPeriod_Init(&strc->period, cycles, 1000 * strc->prescaler);
+  myASSERT(myPeriod_GetWhole(&strc->period) != 0);
+}
+
+static myRet_t myTimer_StartHAL(myTimerStruct_t * strc, uint32_t counts, bool onePulse)
+{
+  myRet_t result = myRet_Fail;
+  TIM_HandleTypeDef * handle = strc->handle;
+  HAL_StatusTypeDef status;
+
+  /* The TIM counts from zero up to ARR, so ARR is one less than the counts.  */
+  handle->Init.Prescaler = strc->prescaler - 1;
+  handle->Init.Period = counts - 1;
+
+  /* Make sure that peripheral is stopped, then (re)init it and start it.     */
+  HAL_TIM_Base_Stop_IT(handle);
+
+  status = HAL_TIM_Base_Init(handle);
+  myASSERT(status == HAL_OK);
+
+  if(status == HAL_OK)
+  {
+    /* One-shot timers that fit a single overflow are stopped by the TIM      */
+    /*  itself at the update event. Also, from now on only overflows raise    */
+    /*  the update flag, so that the update events forced by the fast path    */
+    /*  don't call the callback.                                              */
+    if(onePulse) { handle->Instance->CR1 |= TIM_CR1_OPM;  }
+    else         { handle->Instance->CR1 &= ~TIM_CR1_OPM; }
+    handle->Instance->CR1 |= TIM_CR1_URS;
+
+    /* The init forces an update event to load the prescaler, which raises    */
+    /*  the update flag. It is cleared so that the callback isn't called at   */
+    /*  once when the interrupt gets enabled.                                 */
+    __HAL_TIM_CLEAR_FLAG(handle, TIM_FLAG_UPDATE);
+
+    status = HAL_TIM_Base_Start_IT(handle);
+    myASSERT(status == HAL_OK);
+
+    if(status == HAL_OK)
+    {
+      strc->configured = true;
+      result = myRet_OK;
     }
   }
 
-  myASSERT(foundTIM);
+  return result;
+}
+
+static void myTimer_StartFast(myTimerStruct_t * strc, uint32_t counts, bool onePulse)
+{
+  TIM_HandleTypeDef * const handle = strc->handle;
+  TIM_TypeDef * const TIM = handle->Instance;
+
+  /* With the counter stopped, the new period and prescaler are written to    */
+  /*  the preload registers and an update event moves them to the shadow      */
+  /*  ones and clears the counter at once, so the TIM never counts with a mix */
+  /*  of the old and new settings. As URS is set, that update event doesn't   */
+  /*  raise the update flag; any flag left from before the stop is cleared.   */
+  TIM->CR1 &= ~(TIM_CR1_CEN | TIM_CR1_OPM);
+  TIM->PSC = strc->prescaler - 1;
+  TIM->ARR = counts - 1;
+  TIM->EGR = TIM_EGR_UG;
+  TIM->SR = ~TIM_SR_UIF;
+  TIM->DIER |= TIM_DIER_UIE;
+  TIM->CR1 |= (onePulse ? TIM_CR1_OPM : 0) | TIM_CR1_CEN;
+
+  handle->Init.Prescaler = strc->prescaler - 1;
+  handle->Init.Period = counts - 1;
+}
+
+static uint32_t myTimer_GetElapsedDedicated(myTimerStruct_t * strc)
+{
+  TIM_HandleTypeDef * const handle = strc->handle;
+  uint32_t overflows, count;
+  uint64_t counts;
+
+  /* The update interrupt is masked so that the overflow count and the TIM    */
+  /*  counter are read together. If the TIM overflowed in the meantime, its   */
+  /*  interrupt is still pending and the counter is read again past it.       */
+  HAL_NVIC_DisableIRQ(strc->IRQ);
+  overflows = strc->overflows;
+  count = __HAL_TIM_GET_COUNTER(handle);
+  if(__HAL_TIM_GET_FLAG(handle, TIM_FLAG_UPDATE))
+  {
+    overflows++;
+    count = __HAL_TIM_GET_COUNTER(handle);
+  }
+  HAL_NVIC_EnableIRQ(strc->IRQ);
+
+  counts = ((uint64_t)overflows * DRIVER_TIMER_MAX_COUNTS) + count;
+  return strc->baseMs + (uint32_t)((counts * 1000 * strc->prescaler) / strc->clockHz);
+}
+
+static uint32_t myTimer_GetClockHz(myTimerTIMs_t thisTIM)
+{
+  uint32_t freq;
+
+  /* TIM1 sits on APB2, while the other ones sit on APB1.                     */
+  switch(thisTIM)
+  {
+#if DRIVER_TIMER_USE_TIM1
+    case myTimer_TIM1: { freq = HAL_RCC_GetPCLK2Freq(); } break;
+#endif
+    default:           { freq = HAL_RCC_GetPCLK1Freq(); } break;
+  }
+
+  myASSERT(freq != 0);
+  return freq;
+}
+
+static void myTimer_Interrupt(myTimerTIMs_t thisTIM)
+{
+  TIM_HandleTypeDef * const handle = &myTimer_handle[thisTIM];
+
+  /* Only capture timers enable another interrupt than the update one, so the */
+  /*  others only check that flag. Writing zero to it leaves all the other    */
+  /*  flags untouched.                                                        */
+  if(myTimer_Struct[thisTIM].mode == myTimerMode_Capture)
+  {
+    myTimer_Capture(&myTimer_Struct[thisTIM]);
+  }
+  else if(__HAL_TIM_GET_FLAG(handle, TIM_FLAG_UPDATE))
+  {
+    __HAL_TIM_CLEAR_FLAG(handle, TIM_FLAG_UPDATE);
+    myTimer_Expired(&myTimer_Struct[thisTIM]);
+  }
+}
+
+static void myTimer_Expired(myTimerStruct_t * strc)
+{
+  const myCbk_t cbk = strc->cbk;
+  bool expired = false;
+
+  /* Periods split into several overflows only expire at the last one. The    */
+  /*  next segment is queued as soon as the current one starts.               */
+  switch(strc->mode)
+  {
+    case myTimerMode_Periodic:
+    {
+      uint32_t counts;
+
+      /* The HAL macro uses its argument twice, so it is computed first.      */
+      expired = mySplit_Expired(&strc->split);
+      counts = mySplit_Next(&strc->split, &strc->period);
+      __HAL_TIM_SET_AUTORELOAD(strc->handle, counts - 1);
+    } break;
+
+    case myTimerMode_OneShot:
+    {
+      /* Only one-shot timers that fit in a single overflow are stopped by    */
+      /*  the TIM itself. Longer ones are stopped here. The counts of the     */
+      /*  segments are kept, so that a clock update can tell the time left.   */
+      expired = mySplit_Expired(&strc->split);
+      if(expired)
+      {
+        strc->handle->Instance->CR1 &= ~TIM_CR1_CEN;
+        strc->running = false;
+      }
+      else
+      {
+        strc->doneCounts += strc->segment;
+        strc->segment = strc->nextSegment;
+        strc->nextSegment = 0;
+        if(mySplit_IsPending(&strc->split))
+        {
+          strc->nextSegment = mySplit_Next(&strc->split, &strc->period);
+          __HAL_TIM_SET_AUTORELOAD(strc->handle, strc->nextSegment - 1);
+        }
+      }
+    } break;
+
+    case myTimerMode_FreeRunning:
+    {
+      strc->overflows++;
+    } break;
+
+    default:
+    {
+    } break;
+  }
+
+  if(expired && (cbk != NULL)) { cbk(); }
+}
+
+static void myTimer_Capture(myTimerStruct_t * strc)
+{
+  TIM_HandleTypeDef * const handle = strc->handle;
+  const uint32_t chnlFlag = TIM_SR_CC1IF << (strc->channel >> 2);
+  const uint32_t flags = handle->Instance->SR & (chnlFlag | TIM_SR_UIF);
+  bool wasEmpty = false;
+
+  /* Reading the captured value clears its flag, so only the update flag is   */
+  /*  cleared by hand, and an edge that comes meanwhile is never lost.        */
+  if((flags & chnlFlag) != 0)
+  {
+    const uint32_t value = __HAL_TIM_GET_COMPARE(handle, strc->channel);
+    uint32_t overflows = strc->overflows;
+    uint32_t stamp;
+
+    /* If an overflow is pending too, the edge may have come before or after  */
+    /*  it. The interrupt is never late by half a wrap around, so a value in  */
+    /*  the lower half of the counter comes after it, and the upper half      */
+    /*  before it.                                                            */
+    if(((flags & TIM_SR_UIF) != 0) && (value < (DRIVER_TIMER_MAX_COUNTS / 2))) { overflows++; }
+    stamp = (overflows << 16) | value;
+
+    /* The consumer is only called back when the ring was empty, as it drains */
+    /*  every item that is there. Edges that find the ring full are dropped.  */
+    wasEmpty = (myRing_GetCount(strc->ring) == 0);
+    if(myRing_Push(strc->ring, &stamp) != myRet_OK) { wasEmpty = false; }
+
+    /* An edge that comes before the polarity is flipped is missed, so pulses */
+    /*  must be longer than the interrupt latency when capturing both edges.  */
+    if(strc->edge == myTimerEdge_Both) { handle->Instance->CCER ^= (TIM_CCER_CC1P << strc->channel); }
+  }
+
+  if((flags & TIM_SR_UIF) != 0)
+  {
+    strc->overflows++;
+    __HAL_TIM_CLEAR_FLAG(handle, TIM_FLAG_UPDATE);
+  }
+
+  if(wasEmpty && (strc->cbk != NULL)) { strc->cbk(); }
+}
+
+static void myTimer_Restart(myTimerStruct_t * strc, uint32_t clockHz)
+{
+  uint32_t time = 0;
+
+  /* The time that one-shot and free-running timers counted so far is read    */
+  /*  with the clock they were started with, before it is refreshed.          */
+  if(strc->mode == myTimerMode_OneShot)          { time = myTimer_GetLeft(strc);                 }
+  else if(strc->mode == myTimerMode_FreeRunning) { time = myTimer_GetElapsed((myTimer_t) strc); }
+  strc->clockHz = clockHz;
+
+  /* A one-shot timer with no time left has its interrupt pending already.    */
+  /*  Capture timers have no period, so only the rate of their timestamps     */
+  /*  changes.                                                                */
+  switch(strc->mode)
+  {
+    case myTimerMode_Periodic: { myTimer_StartDedicated(strc, strc->periodMs);          } break;
+    case myTimerMode_OneShot:  { if(time != 0) { myTimer_StartDedicated(strc, time); } } break;
+    case myTimerMode_Pwm:      { myTimer_StartPwm(strc, strc->periodMs);                } break;
+
+    case myTimerMode_FreeRunning:
+    {
+      myTimer_StartDedicated(strc, strc->periodMs);
+      strc->baseMs = time;
+    } break;
+
+    default:
+    {
+    } break;
+  }
+}
+
+static uint32_t myTimer_GetLeft(myTimerStruct_t * strc)
+{
+  TIM_HandleTypeDef * const handle = strc->handle;
+  uint64_t elapsed;
+  uint32_t left = 0;
+
+  /* The TIM counts up through the segments of the period, so the time left   */
+  /*  is what is not counted yet. If the last segment overflowed, the         */
+  /*  interrupt is pending and the timer has no time left.                    */
+  HAL_NVIC_DisableIRQ(strc->IRQ);
+  elapsed = (uint64_t)strc->doneCounts + __HAL_TIM_GET_COUNTER(handle);
+  if(__HAL_TIM_GET_FLAG(handle, TIM_FLAG_UPDATE))
+  {
+    elapsed = (strc->nextSegment == 0) ? UINT64_MAX : ((uint64_t)strc->doneCounts + strc->segment + __HAL_TIM_GET_COUNTER(handle));
+  }
+  HAL_NVIC_EnableIRQ(strc->IRQ);
+
+  if(elapsed != UINT64_MAX)
+  {
+    elapsed = (elapsed * 1000 * strc->prescaler) / strc->clockHz;
+    left = (elapsed < strc->periodMs) ? (strc->periodMs - (uint32_t)elapsed) : 1;
+  }
+
+  return left;
+}
+
+static void myTimer_CatchUp(uint32_t ticks)
+{
+  /* Ticks with nothing to do are skipped at once, the others are run, as     */
+  /*  their callbacks may start timers that change what comes next.           */
+  while(ticks > 0)
+  {
+    const uint32_t next = myWheel_GetNextEvent();
+
+    if(next > ticks)
+    {
+      myWheel_Skip(ticks);
+      ticks = 0;
+    }
+    else
+    {
+      myWheel_Skip(next - 1);
+      myWheel_Tick();
+      ticks -= next;
+    }
+  }
+}
+
+static void myTimer_IdleWake(void)
+{
+  myTimerStruct_t * const strc = myTimer_WheelTimer;
+
+  /* The TIM is back at a tick boundary, so the regular tick restarts from    */
+  /*  here, and this boundary is the tick that was due.                       */
+  strc->mode = myTimerMode_Periodic;
+  strc->cbk = myWheel_Tick;
+  myTimer_StartDedicated(strc, DRIVER_TIMER_WHEEL_TICK_MS);
+  myTimer_Idle = false;
+  myWheel_Tick();
+}
+
+/*******************************************************************************
+ *  CALLBACK ROUTINES
+ ******************************************************************************/
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
+{
+  /* The driver's TIMs don't go through the HAL interrupt logic, so this is   */
+  /*  only reached if someone else hands one of its handles to the HAL. Even  */
+  /*  so, the timer is found from the handle's position, without any search. */
+  if((htim >= &myTimer_handle[0]) && (htim < &myTimer_handle[myTimer_TIM_Count]))
+  {
+    myTimer_Expired(&myTimer_Struct[htim - &myTimer_handle[0]]);
+  }
+#if !DRIVER_TIMER_USE_TIM2
+  else if(htim->Instance == TIM2)
+  {
+    /* TIM2 is the HAL time base and its interrupt goes through the HAL.      */
+    HAL_IncTick();
+  }
+#endif
+  else
+  {
+    myASSERT(false);
+  }
 }
 
 /*******************************************************************************
@@ -229,10 +1337,24 @@ void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
  ******************************************************************************/
 void TIM3_IRQHandler(void)
 {
-  HAL_TIM_IRQHandler(&myTimer_handle[myTimer_TIM3]);
+  myTimer_Interrupt(myTimer_TIM3);
 }
 
 void TIM4_IRQHandler(void)
 {
-  HAL_TIM_IRQHandler(&myTimer_handle[myTimer_TIM4]);
+  myTimer_Interrupt(myTimer_TIM4);
 }
+
+#if DRIVER_TIMER_USE_TIM1
+void TIM1_UP_IRQHandler(void)
+{
+  myTimer_Interrupt(myTimer_TIM1);
+}
+#endif
+
+#if DRIVER_TIMER_USE_TIM2
+void TIM2_IRQHandler(void)
+{
+  myTimer_Interrupt(myTimer_TIM2);
+}
+#endif
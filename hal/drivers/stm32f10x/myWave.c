@@ -0,0 +1,390 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file myWave.c
+ * @brief Source file for the gpio waveform engine.
+ *
+ * This file implements the waveform engine for STM32F10x devices.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "myWave.h"
+#include "myDriverDefs.h"
+#include "projConfig.h"
+
+#include "stm32f1xx_hal.h"
+
+#include "myAssert.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+/* Set below which TIM plays the waveforms. TIM1 is the default one, as the   */
+/*  timer driver leaves it alone unless told otherwise. Each TIM requests its */
+/*  update DMA on a fixed channel of DMA1.                                    */
+#ifndef DRIVER_WAVE_TIM
+  #define DRIVER_WAVE_TIM                                                      1
+#endif
+
+#if DRIVER_WAVE_TIM == 1
+  #define MY_WAVE_TIM                                                       TIM1
+  #define MY_WAVE_TIM_CLK_ENABLE()                   __HAL_RCC_TIM1_CLK_ENABLE()
+  #define MY_WAVE_TIM_CLOCK_HZ()                          HAL_RCC_GetPCLK2Freq()
+  #define MY_WAVE_DMA                                              DMA1_Channel5
+  #define MY_WAVE_DMA_IRQn                                    DMA1_Channel5_IRQn
+  #define MY_WAVE_DMA_IRQHandler                        DMA1_Channel5_IRQHandler
+#elif DRIVER_WAVE_TIM == 2
+  #define MY_WAVE_TIM                                                       TIM2
+  #define MY_WAVE_TIM_CLK_ENABLE()                   __HAL_RCC_TIM2_CLK_ENABLE()
+  #define MY_WAVE_TIM_CLOCK_HZ()                          HAL_RCC_GetPCLK1Freq()
+  #define MY_WAVE_DMA                                              DMA1_Channel2
+  #define MY_WAVE_DMA_IRQn                                    DMA1_Channel2_IRQn
+  #define MY_WAVE_DMA_IRQHandler                        DMA1_Channel2_IRQHandler
+#elif DRIVER_WAVE_TIM == 3
+  #define MY_WAVE_TIM                                                       TIM3
+  #define MY_WAVE_TIM_CLK_ENABLE()                   __HAL_RCC_TIM3_CLK_ENABLE()
+  #define MY_WAVE_TIM_CLOCK_HZ()                          HAL_RCC_GetPCLK1Freq()
+  #define MY_WAVE_DMA                                              DMA1_Channel3
+  #define MY_WAVE_DMA_IRQn                                    DMA1_Channel3_IRQn
+  #define MY_WAVE_DMA_IRQHandler                        DMA1_Channel3_IRQHandler
+#elif DRIVER_WAVE_TIM == 4
+  #define MY_WAVE_TIM                                                       TIM4
+  #define MY_WAVE_TIM_CLK_ENABLE()                   __HAL_RCC_TIM4_CLK_ENABLE()
+  #define MY_WAVE_TIM_CLOCK_HZ()                          HAL_RCC_GetPCLK1Freq()
+  #define MY_WAVE_DMA                                              DMA1_Channel7
+  #define MY_WAVE_DMA_IRQn                                    DMA1_Channel7_IRQn
+  #define MY_WAVE_DMA_IRQHandler                        DMA1_Channel7_IRQHandler
+#else
+  #error "DRIVER_WAVE_TIM must be 1, 2, 3 or 4."
+#endif
+
+/* TIM counters and prescalers are 16 bits wide, and so is the DMA counter.   */
+#define MY_WAVE_MAX_COUNTS                                               0x10000
+#define MY_WAVE_MAX_PRESCALER                                            0x10000
+#define MY_WAVE_MAX_STEPS                                                 0xFFFF
+
+/* BSRR sets the pins written to its lower half, and resets the ones written  */
+/*  to its upper half, all in a single store.                                 */
+#define MY_WAVE_BSRR(SET, RESET)       (((uint32_t)(RESET) << 16) | (uint16_t)(SET))
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static myRet_t myWave_SetStep(uint32_t stepUs);
+static myRet_t myWave_StartDMA(const uint32_t * buf, uint32_t len, myWavePars_t * pars);
+static myRet_t myWave_StartTIM(void);
+static void myWave_StopTIM(void);
+static void myWave_HalfDone(DMA_HandleTypeDef * hdma);
+static void myWave_Done(DMA_HandleTypeDef * hdma);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static GPIO_TypeDef * const myWave_GPIOs[] = { GPIOA, GPIOB, GPIOC, GPIOD, GPIOE };
+static const uint32_t myWave_GPIOCnt = sizeof(myWave_GPIOs) / sizeof(myWave_GPIOs[0]);
+
+static TIM_HandleTypeDef myWave_TimHandle;
+static DMA_HandleTypeDef myWave_DmaHandle;
+
+static volatile bool myWave_Running = false;
+static bool myWave_Circular;
+static myCbk_t myWave_HalfCbk;
+static myCbk_t myWave_DoneCbk;
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES
+ ******************************************************************************/
+/**
+ * @brief Writes a sequence into a buffer, so that the pins in the mask take
+ *          the given levels, one step after the other.
+ * @param buf Buffer to write.
+ * @param len Amount of steps, both of the buffer and of the levels.
+ * @param mask Pins, within the port, that the sequence drives.
+ * @param levels Level of the port at each step, one bit per pin.
+ */
+void myWave_Sequence(uint32_t * buf, uint32_t len, uint32_t mask, const uint16_t * levels)
+{
+  const uint32_t keep = ~MY_WAVE_BSRR(mask, mask);
+  uint32_t step;
+
+  myASSERT((buf != NULL) && (levels != NULL));
+
+  if((buf != NULL) && (levels != NULL))
+  {
+    for(step = 0; step < len; step++)
+    {
+      buf[step] = (buf[step] & keep) | MY_WAVE_BSRR(levels[step] & mask, ~levels[step] & mask);
+    }
+  }
+}
+
+/**
+ * @brief Writes a pulse into a buffer, so that the pins in the mask are high
+ *          for some steps and low for the rest of it.
+ * @param buf Buffer to write.
+ * @param len Amount of steps of the buffer.
+ * @param mask Pins, within the port, that the pulse drives.
+ * @param start Step at which the pins go high.
+ * @param width Amount of steps that the pins stay high.
+ */
+void myWave_Pulse(uint32_t * buf, uint32_t len, uint32_t mask, uint32_t start, uint32_t width)
+{
+  const uint32_t keep = ~MY_WAVE_BSRR(mask, mask);
+  const uint32_t high = MY_WAVE_BSRR(mask, 0);
+  const uint32_t low = MY_WAVE_BSRR(0, mask);
+  uint32_t step;
+
+  myASSERT(buf != NULL);
+  myASSERT((start < len) && (width <= len));
+
+  if((buf != NULL) && (start < len) && (width <= len))
+  {
+    /* Steps are counted from the start of the pulse, wrapping around the end */
+    /*  of the buffer, so that the high ones are the first width of them.     */
+    for(step = 0; step < len; step++)
+    {
+      const uint32_t fromStart = (step >= start) ? (step - start) : (step + len - start);
+
+      buf[step] = (buf[step] & keep) | ((fromStart < width) ? high : low);
+    }
+  }
+}
+
+/**
+ * @brief Starts playing a waveform, stopping the one being played, if any.
+ * @param buf Buffer to play.
+ * @param len Amount of steps of the buffer.
+ * @param pars Structure containing all the data required to play it.
+ * @return Success / Failure
+ */
+myRet_t myWave_Start(const uint32_t * buf, uint32_t len, myWavePars_t * pars)
+{
+  myRet_t result = myRet_Fail;
+
+  if((buf != NULL) && (pars != NULL))
+  {
+    myASSERT(pars->port < myWave_GPIOCnt);
+    myASSERT((len > 0) && (len <= MY_WAVE_MAX_STEPS));
+
+    if((pars->port < myWave_GPIOCnt) && (len > 0) && (len <= MY_WAVE_MAX_STEPS))
+    {
+      myWave_Stop();
+
+      __HAL_RCC_DMA1_CLK_ENABLE();
+      MY_WAVE_TIM_CLK_ENABLE();
+
+      if(myWave_SetStep(pars->stepUs) == myRet_OK)
+      {
+        /* The DMA is armed first, so that it is ready for the first request. */
+        if(myWave_StartDMA(buf, len, pars) == myRet_OK)
+        {
+          result = myWave_StartTIM();
+        }
+      }
+
+      if(result != myRet_OK) { myWave_Stop(); }
+    }
+  }
+
+  return result;
+}
+
+/**
+ * @brief Stops the waveform being played. The pins keep their last levels.
+ */
+void myWave_Stop(void)
+{
+  if(myWave_Running)
+  {
+    myWave_StopTIM();
+    HAL_DMA_Abort(&myWave_DmaHandle);
+  }
+}
+
+/**
+ * @brief Tells if a waveform is being played.
+ * @return True if it is, false otherwise.
+ */
+bool myWave_IsRunning(void)
+{
+  return myWave_Running;
+}
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES - TEST PURPOSES
+ ******************************************************************************/
+#ifdef TEST
+/**
+ * @brief Resets engine's internal logic and its variables.
+ */
+void myWave_Reset(void)
+{
+  myWave_TimHandle = (TIM_HandleTypeDef) { 0 };
+  myWave_DmaHandle = (DMA_HandleTypeDef) { 0 };
+  myWave_Running = false;
+  myWave_Circular = false;
+  myWave_HalfCbk = NULL;
+  myWave_DoneCbk = NULL;
+}
+#endif
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static myRet_t myWave_SetStep(uint32_t stepUs)
+{
+  myRet_t result = myRet_Fail;
+  const uint64_t cycles = ((uint64_t)MY_WAVE_TIM_CLOCK_HZ() * stepUs) / 1000000;
+
+  /* The smallest prescaler that fits the step is taken, for the best         */
+  /*  resolution. Steps shorter than a clock cycle can't be counted at all.   */
+  myASSERT((cycles > 0) && (cycles <= ((uint64_t)MY_WAVE_MAX_COUNTS * MY_WAVE_MAX_PRESCALER)));
+
+  if((cycles > 0) && (cycles <= ((uint64_t)MY_WAVE_MAX_COUNTS * MY_WAVE_MAX_PRESCALER)))
+  {
+    const uint32_t prescaler = (uint32_t)((cycles - 1) / MY_WAVE_MAX_COUNTS) + 1;
+
+    /* The TIM counts from zero up to ARR, so ARR is one less than counts.    */
+    myWave_TimHandle.Instance = MY_WAVE_TIM;
+    myWave_TimHandle.Init.Prescaler = prescaler - 1;
+    myWave_TimHandle.Init.Period = (uint32_t)(cycles / prescaler) - 1;
+    myWave_TimHandle.Init.CounterMode = TIM_COUNTERMODE_UP;
+    myWave_TimHandle.Init.ClockDivision = 0;
+    myWave_TimHandle.Init.RepetitionCounter = 0;
+    myWave_TimHandle.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE;
+
+    result = myRet_OK;
+  }
+
+  return result;
+}
+
+static myRet_t myWave_StartDMA(const uint32_t * buf, uint32_t len, myWavePars_t * pars)
+{
+  myRet_t result = myRet_Fail;
+  HAL_StatusTypeDef status;
+
+  /* Each request moves the next word of the buffer to the same register.     */
+  myWave_DmaHandle.Instance = MY_WAVE_DMA;
+  myWave_DmaHandle.Init.Direction = DMA_MEMORY_TO_PERIPH;
+  myWave_DmaHandle.Init.PeriphInc = DMA_PINC_DISABLE;
+  myWave_DmaHandle.Init.MemInc = DMA_MINC_ENABLE;
+  myWave_DmaHandle.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+  myWave_DmaHandle.Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
+  myWave_DmaHandle.Init.Mode = pars->circular ? DMA_CIRCULAR : DMA_NORMAL;
+  myWave_DmaHandle.Init.Priority = DMA_PRIORITY_HIGH;
+
+  status = HAL_DMA_Init(&myWave_DmaHandle);
+  myASSERT(status == HAL_OK);
+
+  if(status == HAL_OK)
+  {
+    const uint32_t src = (uint32_t)(uintptr_t)buf;
+    const uint32_t dst = (uint32_t)(uintptr_t)&myWave_GPIOs[pars->port]->BSRR;
+
+    myWave_Circular = pars->circular;
+    myWave_HalfCbk = pars->halfCbk;
+    myWave_DoneCbk = pars->doneCbk;
+
+    /* The HAL only enables the half transfer interrupt if there is a         */
+    /*  callback for it. A waveform that is not circular always takes the     */
+    /*  complete one, to stop the TIM once the buffer has been played.        */
+    myWave_DmaHandle.XferHalfCpltCallback = (pars->halfCbk != NULL) ? myWave_HalfDone : NULL;
+    myWave_DmaHandle.XferCpltCallback = ((pars->doneCbk != NULL) || !pars->circular) ? myWave_Done : NULL;
+
+    if((myWave_DmaHandle.XferHalfCpltCallback != NULL) || (myWave_DmaHandle.XferCpltCallback != NULL))
+    {
+      HAL_NVIC_SetPriority(MY_WAVE_DMA_IRQn, 15, 0);
+      HAL_NVIC_EnableIRQ(MY_WAVE_DMA_IRQn);
+      status = HAL_DMA_Start_IT(&myWave_DmaHandle, src, dst, len);
+    }
+    else
+    {
+      status = HAL_DMA_Start(&myWave_DmaHandle, src, dst, len);
+    }
+    myASSERT(status == HAL_OK);
+
+    if(status == HAL_OK)
+    {
+      /* From now on, the waveform has to be stopped on failures.             */
+      myWave_Running = true;
+      result = myRet_OK;
+    }
+  }
+
+  return result;
+}
+
+static myRet_t myWave_StartTIM(void)
+{
+  myRet_t result = myRet_Fail;
+  HAL_StatusTypeDef status;
+
+  /* The HAL routines that start a TIM with DMA point the DMA to the TIM's    */
+  /*  own registers, so the update request is enabled by hand instead. It is  */
+  /*  done after the init, as the init forces an update event.                */
+  status = HAL_TIM_Base_Init(&myWave_TimHandle);
+  myASSERT(status == HAL_OK);
+
+  if(status == HAL_OK)
+  {
+    __HAL_TIM_ENABLE_DMA(&myWave_TimHandle, TIM_DMA_UPDATE);
+
+    status = HAL_TIM_Base_Start(&myWave_TimHandle);
+    myASSERT(status == HAL_OK);
+
+    if(status == HAL_OK) { result = myRet_OK; }
+  }
+
+  return result;
+}
+
+static void myWave_StopTIM(void)
+{
+  HAL_TIM_Base_Stop(&myWave_TimHandle);
+  __HAL_TIM_DISABLE_DMA(&myWave_TimHandle, TIM_DMA_UPDATE);
+  HAL_NVIC_DisableIRQ(MY_WAVE_DMA_IRQn);
+  myWave_Running = false;
+}
+
+static void myWave_HalfDone(DMA_HandleTypeDef * hdma)
+{
+  (void)hdma;
+
+  if(myWave_HalfCbk != NULL) { myWave_HalfCbk(); }
+}
+
+static void myWave_Done(DMA_HandleTypeDef * hdma)
+{
+  (void)hdma;
+
+  /* The DMA stops by itself at the end of a buffer that is not circular, so  */
+  /*  only the TIM is left to stop.                                           */
+  if(!myWave_Circular) { myWave_StopTIM(); }
+
+  if(myWave_DoneCbk != NULL) { myWave_DoneCbk(); }
+}
+
+/*******************************************************************************
+ *  INTERRUPT ROUTINES
+ ******************************************************************************/
+void MY_WAVE_DMA_IRQHandler(void)
+{
+  HAL_DMA_IRQHandler(&myWave_DmaHandle);
+}
@@ -0,0 +1,123 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file myWave.h
+ * @brief Header file for the gpio waveform engine of STM32F10x devices.
+ *
+ * The engine streams a buffer of BSRR words to a gpio port, one word per
+ *  step, with a TIM update event triggering a DMA transfer at each step. Once
+ *  started, the pattern plays with no CPU and no interrupt at all. Only the
+ *  optional half and complete buffer callbacks raise interrupts, so that the
+ *  client can refill one half of the buffer while the other one plays.
+ *
+ * Each word sets the pins in its lower half, and resets the ones in its upper
+ *  half, leaving all the other pins of the port alone. The routines below
+ *  build blink, PWM-like and sequence patterns into such buffers, and they
+ *  can be combined in the same buffer, as long as each one handles its own
+ *  pins. The pins must have been initialized as outputs with myGpio_Init.
+ *
+ * There is a single engine, running on the TIM set by DRIVER_WAVE_TIM, which
+ *  must not be used by the timer driver.
+ */
+
+#ifndef MY_WAVE_H
+#define MY_WAVE_H
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "myDefs.h"
+
+/*******************************************************************************
+ *  PUBLIC DEFINITIONS
+ ******************************************************************************/
+/**
+ * @brief Structure containing all the info needed to start a waveform.
+ *
+ * Leaving the callbacks NULL plays a circular waveform with no interrupt.
+ *  A waveform that is not circular stops by itself after its last step.
+ */
+typedef struct
+{
+  uint8_t port;
+  uint32_t stepUs;
+  bool circular;
+  myCbk_t halfCbk;
+  myCbk_t doneCbk;
+} myWavePars_t;
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES
+ ******************************************************************************/
+/**
+ * @brief Writes a sequence into a buffer, so that the pins in the mask take
+ *          the given levels, one step after the other.
+ * @param buf Buffer to write. The words are only changed for the pins in the
+ *          mask, so the other pins keep the patterns already built for them.
+ * @param len Amount of steps, both of the buffer and of the levels.
+ * @param mask Pins, within the port, that the sequence drives.
+ * @param levels Level of the port at each step, one bit per pin.
+ */
+void myWave_Sequence(uint32_t * buf, uint32_t len, uint32_t mask, const uint16_t * levels);
+
+/**
+ * @brief Writes a pulse into a buffer, so that the pins in the mask are high
+ *          for some steps and low for the rest of it. Played in a circular
+ *          buffer, it is a blink, or a PWM-like output when the steps are
+ *          short enough.
+ * @param buf Buffer to write. The words are only changed for the pins in the
+ *          mask, so the other pins keep the patterns already built for them.
+ * @param len Amount of steps of the buffer.
+ * @param mask Pins, within the port, that the pulse drives.
+ * @param start Step at which the pins go high. Must be lower than len.
+ * @param width Amount of steps that the pins stay high, wrapping around the
+ *          end of the buffer. Must not be higher than len.
+ */
+void myWave_Pulse(uint32_t * buf, uint32_t len, uint32_t mask, uint32_t start, uint32_t width);
+
+/**
+ * @brief Starts playing a waveform, stopping the one being played, if any.
+ * @param buf Buffer to play. It is read by the DMA while playing, so it must
+ *          stay valid until the waveform is stopped.
+ * @param len Amount of steps of the buffer, from 1 up to 65535.
+ * @param pars Structure containing all the data required to play it.
+ * @return Success / Failure
+ */
+myRet_t myWave_Start(const uint32_t * buf, uint32_t len, myWavePars_t * pars);
+
+/**
+ * @brief Stops the waveform being played. The pins keep their last levels.
+ */
+void myWave_Stop(void);
+
+/**
+ * @brief Tells if a waveform is being played.
+ * @return True if it is, false otherwise.
+ */
+bool myWave_IsRunning(void);
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES - TEST PURPOSES
+ ******************************************************************************/
+#ifdef TEST
+/**
+ * @brief Resets engine's internal logic and its variables.
+ */
+void myWave_Reset(void);
+#endif
+
+#endif
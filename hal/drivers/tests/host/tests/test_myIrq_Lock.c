@@ -0,0 +1,99 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file test_myIrq_Lock.c
+ * @brief Test file for testing interrupt masking logic, operation when
+ *          sections are masked and unmasked.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+
+#include "myIrq.h"
+
+#include <pthread.h>
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static void * lockingThread(void * arg);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static volatile bool threadLocked;
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  threadLocked = false;
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief Masked sections should nest without blocking themselves.
+ */
+void test_IfLockedTwiceThenItDoesNotBlock(void)
+{
+  const uint32_t outer = myIrq_Lock();
+  const uint32_t inner = myIrq_Lock();
+
+  myIrq_Unlock(inner);
+  myIrq_Unlock(outer);
+}
+
+/**
+ * @brief Another thread, standing for an interrupt, should only get in once
+ *          the section is unmasked.
+ */
+void test_IfLockedThenOtherThreadsWait(void)
+{
+  const uint32_t state = myIrq_Lock();
+  pthread_t thread;
+
+  pthread_create(&thread, NULL, lockingThread, NULL);
+  TEST_ASSERT_FALSE(threadLocked);
+
+  myIrq_Unlock(state);
+  pthread_join(thread, NULL);
+  TEST_ASSERT_TRUE(threadLocked);
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static void * lockingThread(void * arg)
+{
+  const uint32_t state = myIrq_Lock();
+
+  (void) arg;
+  threadLocked = true;
+  myIrq_Unlock(state);
+  return NULL;
+}
@@ -0,0 +1,110 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file test_myTime_Now.c
+ * @brief Test file for testing time driver logic, reading the system time
+ *          from the monotonic clock of the host.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+
+#include "myTime.h"
+
+#include <time.h>
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_SLEEP_US                                                    (20000)
+#define TEST_READS                                                      (100000)
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static void sleepUs(uint32_t us);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  myTime_Reset();
+  myTime_Init();
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief Time should start close to zero on initialization.
+ */
+void test_TimeStartsAtZero(void)
+{
+  TEST_ASSERT_TRUE(myTime_Now() < TEST_SLEEP_US);
+}
+
+/**
+ * @brief Time should never go back between consecutive reads.
+ */
+void test_TimeIsMonotonic(void)
+{
+  uint64_t previous = myTime_Now();
+  uint64_t now;
+  uint32_t reads;
+
+  for(reads = 0; reads < TEST_READS; reads++)
+  {
+    now = myTime_Now();
+    TEST_ASSERT_TRUE(now >= previous);
+    previous = now;
+  }
+}
+
+/**
+ * @brief Time should advance at least as much as the host slept.
+ */
+void test_TimeFollowsTheHostClock(void)
+{
+  const uint64_t before = myTime_Now();
+
+  sleepUs(TEST_SLEEP_US);
+
+  TEST_ASSERT_TRUE(myTime_Now() - before >= TEST_SLEEP_US);
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static void sleepUs(uint32_t us)
+{
+  const struct timespec request = { .tv_sec = 0, .tv_nsec = (long)us * 1000 };
+
+  nanosleep(&request, NULL);
+}
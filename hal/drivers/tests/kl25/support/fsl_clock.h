@@ -95,4 +95,18 @@ void CLOCK_SetTpmClock(uint32_t src);
  */
 uint32_t CLOCK_GetOsc0ErClkFreq(void);
 
+/*!
+ * @brief Return the frequency of the core and system clocks.
+ *
+ * @return Clock frequency in Hz.
+ */
+uint32_t CLOCK_GetCoreSysClkFreq(void);
+
+/*!
+ * @brief Return the frequency of the bus clock.
+ *
+ * @return Clock frequency in Hz.
+ */
+uint32_t CLOCK_GetBusClkFreq(void);
+
 #endif /* _FSL_CLOCK_H_ */
@@ -88,6 +88,50 @@ typedef enum IRQn
   PORTD_IRQn                   = 31                /**< PORTD Pin detect */
 } IRQn_Type;
 
+/** SysTick and SCB - Register Layout Typedefs, from the CMSIS core header.   */
+typedef struct
+{
+  volatile uint32_t CTRL;
+  volatile uint32_t LOAD;
+  volatile uint32_t VAL;
+  volatile uint32_t CALIB;
+} SysTick_Type;
+
+typedef struct
+{
+  volatile uint32_t CPUID;
+  volatile uint32_t ICSR;
+  volatile uint32_t VTOR;
+  volatile uint32_t AIRCR;
+  volatile uint32_t SCR;
+  volatile uint32_t CCR;
+} SCB_Type;
+
+/** SysTick and SCB fake registers, so that logic can access them.            */
+extern SysTick_Type SysTick_Regs;
+extern SCB_Type SCB_Regs;
+
+#define SysTick                                                  (&SysTick_Regs)
+#define SCB                                                          (&SCB_Regs)
+
+/** SysTick and SCB Register bits                                             */
+#define SysTick_CTRL_ENABLE_Msk                                        (1U << 0)
+#define SysTick_CTRL_TICKINT_Msk                                       (1U << 1)
+#define SysTick_CTRL_CLKSOURCE_Msk                                     (1U << 2)
+#define SysTick_CTRL_COUNTFLAG_Msk                                    (1U << 16)
+#define SCB_ICSR_PENDSTCLR_Msk                                        (1U << 25)
+#define SCB_ICSR_PENDSTSET_Msk                                        (1U << 26)
+
+/*! @brief Type used for all status and error return values. */
+typedef int32_t status_t;
+
+/*! @brief Generic status return codes. */
+enum _generic_status
+{
+  kStatus_Success = 0,
+  kStatus_Fail = 1,
+};
+
 /*! Macro to convert a millisecond period to raw count value */
 #define MSEC_TO_COUNT(ms, clockFreqInHz) (uint64_t)((uint64_t)ms * clockFreqInHz / 1000U)
 
@@ -106,11 +150,54 @@ typedef enum IRQn
  */
 void EnableIRQ(IRQn_Type interrupt);
 
+/*!
+ * @brief Disable specific interrupt.
+ *
+ * Disable the interrupt not routed from intmux.
+ *
+ * @param interrupt The IRQ number.
+ */
+void DisableIRQ(IRQn_Type interrupt);
+
+/*!
+ * @brief Set the priority of an interrupt, from the CMSIS core.
+ *
+ * @param IRQn The IRQ number.
+ * @param priority Priority to set, zero being the highest.
+ */
+void NVIC_SetPriority(IRQn_Type IRQn, uint32_t priority);
+
+/*!
+ * @brief Clear the pending state of an interrupt, from the CMSIS core.
+ *
+ * @param IRQn The IRQ number.
+ */
+void NVIC_ClearPendingIRQ(IRQn_Type IRQn);
+
+/*!
+ * @brief Disable the global IRQ.
+ *
+ * @return Current primask value.
+ */
+uint32_t DisableGlobalIRQ(void);
+
+/*!
+ * @brief Enable the global IRQ, restoring the primask.
+ *
+ * @param primask Value of primask register to be restored.
+ */
+void EnableGlobalIRQ(uint32_t primask);
+
 /*******************************************************************************
  * EXTERNAL INTERRUPT HANDLERS
  ******************************************************************************/
 extern void TPM0_IRQHandler(void);
 extern void TPM1_IRQHandler(void);
 extern void TPM2_IRQHandler(void);
+extern void PIT_IRQHandler(void);
+extern void UART0_IRQHandler(void);
+extern void PORTA_IRQHandler(void);
+extern void PORTD_IRQHandler(void);
+extern void SysTick_Handler(void);
 
 #endif /* _FSL_COMMON_H_ */
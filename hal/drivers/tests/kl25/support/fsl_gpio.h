@@ -44,18 +44,59 @@
  ******************************************************************************/
 
 /** GPIO - Register Layout Typedef                                            */
-typedef void * GPIO_Type;
-
-/** GPIO Peripherals' fake addresses                                          */
-#define GPIOA                                           ((GPIO_Type) 0x0000000A)
-#define GPIOB                                           ((GPIO_Type) 0x0000000B)
-#define GPIOC                                           ((GPIO_Type) 0x0000000C)
-#define GPIOD                                           ((GPIO_Type) 0x0000000D)
-#define GPIOE                                           ((GPIO_Type) 0x0000000E)
+typedef struct
+{
+  volatile uint32_t PDOR;
+  volatile uint32_t PSOR;
+  volatile uint32_t PCOR;
+  volatile uint32_t PTOR;
+  volatile uint32_t PDIR;
+  volatile uint32_t PDDR;
+} GPIO_Type;
+
+/** GPIO Peripherals' fake registers, so that logic can access them.          */
+extern GPIO_Type GPIOA_Regs;
+extern GPIO_Type GPIOB_Regs;
+extern GPIO_Type GPIOC_Regs;
+extern GPIO_Type GPIOD_Regs;
+extern GPIO_Type GPIOE_Regs;
+
+#define GPIOA                                                      (&GPIOA_Regs)
+#define GPIOB                                                      (&GPIOB_Regs)
+#define GPIOC                                                      (&GPIOC_Regs)
+#define GPIOD                                                      (&GPIOD_Regs)
+#define GPIOE                                                      (&GPIOE_Regs)
 
 /** Array initializer of GPIO peripheral base pointers                        */
 #define GPIO_BASE_PTRS                     { GPIOA, GPIOB, GPIOC, GPIOD, GPIOE }
 
+/** FGPIO - Register Layout Typedef                                           */
+typedef struct
+{
+  volatile uint32_t PDOR;
+  volatile uint32_t PSOR;
+  volatile uint32_t PCOR;
+  volatile uint32_t PTOR;
+  volatile uint32_t PDIR;
+  volatile uint32_t PDDR;
+} FGPIO_Type;
+
+/** FGPIO Peripherals' fake registers, so that logic can access them.         */
+extern FGPIO_Type FGPIOA_Regs;
+extern FGPIO_Type FGPIOB_Regs;
+extern FGPIO_Type FGPIOC_Regs;
+extern FGPIO_Type FGPIOD_Regs;
+extern FGPIO_Type FGPIOE_Regs;
+
+#define FGPIOA                                                    (&FGPIOA_Regs)
+#define FGPIOB                                                    (&FGPIOB_Regs)
+#define FGPIOC                                                    (&FGPIOC_Regs)
+#define FGPIOD                                                    (&FGPIOD_Regs)
+#define FGPIOE                                                    (&FGPIOE_Regs)
+
+/** Array initializer of FGPIO peripheral base pointers                       */
+#define FGPIO_BASE_PTRS               { FGPIOA, FGPIOB, FGPIOC, FGPIOD, FGPIOE }
+
 /** @brief GPIO direction definition */
 typedef enum _gpio_pin_direction
 {
@@ -94,6 +135,14 @@ extern "C" {
  */
 void GPIO_PinInit(GPIO_Type *base, uint32_t pin, const gpio_pin_config_t *config);
 
+/**
+ * @brief Initializes a FGPIO pin used by the board.
+ * @param base   FGPIO peripheral base pointer (FGPIOA, FGPIOB, FGPIOC, and so on.)
+ * @param pin    FGPIO port pin number
+ * @param config FGPIO pin configuration pointer
+ */
+void FGPIO_PinInit(FGPIO_Type *base, uint32_t pin, const gpio_pin_config_t *config);
+
 /**
  * @brief Sets the output level of the multiple GPIO pins to the logic 1 or 0.
  * @param base    GPIO peripheral base pointer (GPIOA, GPIOB, GPIOC, and so on.)
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2015, Freescale Semiconductor, Inc.
+ * Copyright 2016-2017 NXP
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * o Redistributions of source code must retain the above copyright notice, this list
+ *   of conditions and the following disclaimer.
+ *
+ * o Redistributions in binary form must reproduce the above copyright notice, this
+ *   list of conditions and the following disclaimer in the documentation and/or
+ *   other materials provided with the distribution.
+ *
+ * o Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file fsl_lpsci.h
+ * @brief Header file for mocking the fsl_lpsci sdk module.
+ */
+
+#ifndef _FSL_LPSCI_H_
+#define _FSL_LPSCI_H_
+
+#include "myDefs.h"
+#include "fsl_common.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+/** UART0 - Register Layout Typedef                                           */
+typedef void * UART0_Type;
+
+/** UART0 Peripheral's fake address                                           */
+#define UART0                                          ((UART0_Type) 0x123456A0)
+
+/*!
+ * @brief LPSCI interrupt configuration structure, default settings all
+ *          disabled.
+ */
+enum _lpsci_interrupt_enable_t
+{
+    kLPSCI_TxDataRegEmptyInterruptEnable = (0x80U << 8),   /*!< Transmit data register empty interrupt. */
+    kLPSCI_TransmissionCompleteInterruptEnable = (0x40U << 8), /*!< Transmission complete interrupt. */
+    kLPSCI_RxDataRegFullInterruptEnable = (0x20U << 8),    /*!< Receiver data register full interrupt. */
+};
+
+/*!
+ * @brief LPSCI status flags.
+ */
+enum _lpsci_status_flags
+{
+    kLPSCI_TxDataRegEmptyFlag = 0x80U,         /*!< Tx data register empty flag, sets when Tx buffer is empty */
+    kLPSCI_TransmissionCompleteFlag = 0x40U,   /*!< Transmission complete flag, sets when transmission activity complete */
+    kLPSCI_RxDataRegFullFlag = 0x20U,          /*!< Rx data register full flag, sets when the receive data buffer is full */
+};
+
+/*******************************************************************************
+ * API
+ ******************************************************************************/
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*!
+ * @brief Gets LPSCI status flags.
+ *
+ * @param base LPSCI peripheral base address.
+ * @return LPSCI status flags which are ORed by the enumerators in the
+ *          _lpsci_status_flags.
+ */
+uint32_t LPSCI_GetStatusFlags(UART0_Type *base);
+
+/*!
+ * @brief Enables an LPSCI interrupt according to a provided mask.
+ *
+ * @param base LPSCI peripheral base address.
+ * @param mask The interrupts to enable. Logical OR of @ref
+ *          _lpsci_interrupt_enable_t.
+ */
+void LPSCI_EnableInterrupts(UART0_Type *base, uint32_t mask);
+
+/*!
+ * @brief Disables the LPSCI interrupt according to a provided mask.
+ *
+ * @param base LPSCI peripheral base address.
+ * @param mask The interrupts to disable. Logical OR of @ref
+ *          _lpsci_interrupt_enable_t.
+ */
+void LPSCI_DisableInterrupts(UART0_Type *base, uint32_t mask);
+
+/*!
+ * @brief Writes to the TX register.
+ *
+ * This function writes data to the TX register directly. The upper layer must
+ * ensure that the TX register is empty before calling this function.
+ *
+ * @param base LPSCI peripheral base address.
+ * @param data Data write to the TX register.
+ */
+void LPSCI_WriteByte(UART0_Type *base, uint8_t data);
+
+/*!
+ * @brief Writes to the TX register using a blocking method.
+ *
+ * This function polls the TX register, waits for the TX register to be empty
+ * or for the TX FIFO to have room, and then writes data to the TX buffer.
+ *
+ * @param base LPSCI peripheral base address.
+ * @param data Start address of the data to write.
+ * @param length Size of the data to write.
+ */
+void LPSCI_WriteBlocking(UART0_Type *base, const uint8_t *data, size_t length);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* _FSL_LPSCI_H_ */
@@ -0,0 +1,27 @@
+/**
+ * @file fsl_periph.c
+ * @brief Source file holding the fake core registers that the mocked sdk
+ *          modules point their peripheral instances to.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "fsl_common.h"
+#include "fsl_gpio.h"
+
+/*******************************************************************************
+ * FAKE REGISTERS
+ ******************************************************************************/
+SysTick_Type SysTick_Regs;
+SCB_Type SCB_Regs;
+GPIO_Type GPIOA_Regs;
+GPIO_Type GPIOB_Regs;
+GPIO_Type GPIOC_Regs;
+GPIO_Type GPIOD_Regs;
+GPIO_Type GPIOE_Regs;
+FGPIO_Type FGPIOA_Regs;
+FGPIO_Type FGPIOB_Regs;
+FGPIO_Type FGPIOC_Regs;
+FGPIO_Type FGPIOD_Regs;
+FGPIO_Type FGPIOE_Regs;
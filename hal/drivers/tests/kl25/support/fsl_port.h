@@ -120,6 +120,20 @@ typedef enum _port_mux
     kPORT_MuxAlt15 = 15U,           /**< Chip-specific */
 } port_mux_t;
 
+/** @brief Configures the interrupt generation condition. */
+typedef enum _port_interrupt
+{
+    kPORT_InterruptOrDMADisabled = 0x0U, /*!< Interrupt/DMA request is disabled. */
+    kPORT_DMARisingEdge = 0x1U,          /*!< DMA request on rising edge. */
+    kPORT_DMAFallingEdge = 0x2U,         /*!< DMA request on falling edge. */
+    kPORT_DMAEitherEdge = 0x3U,          /*!< DMA request on either edge. */
+    kPORT_InterruptLogicZero = 0x8U,     /*!< Interrupt when logic zero. */
+    kPORT_InterruptRisingEdge = 0x9U,    /*!< Interrupt on rising edge. */
+    kPORT_InterruptFallingEdge = 0xAU,   /*!< Interrupt on falling edge. */
+    kPORT_InterruptEitherEdge = 0xBU,    /*!< Interrupt on either edge. */
+    kPORT_InterruptLogicOne = 0xCU,      /*!< Interrupt when logic one. */
+} port_interrupt_t;
+
 /** @brief Digital filter clock source selection */
 typedef enum _port_digital_filter_clock_source
 {
@@ -160,4 +174,26 @@ typedef struct _port_pin_config
  */
 void PORT_SetPinConfig(PORT_Type *base, uint32_t pin, const port_pin_config_t *config);
 
+/**
+ * @brief Configures the port pin interrupt/DMA request.
+ * @param base   PORT peripheral base pointer.
+ * @param pin    PORT pin number.
+ * @param config PORT pin interrupt configuration.
+ */
+void PORT_SetPinInterruptConfig(PORT_Type *base, uint32_t pin, port_interrupt_t config);
+
+/**
+ * @brief Reads the whole port status flag.
+ * @param base PORT peripheral base pointer.
+ * @return Current port interrupt status flags, one bit per pin.
+ */
+uint32_t PORT_GetPinsInterruptFlags(PORT_Type *base);
+
+/**
+ * @brief Clears the multiple pin interrupt status flag.
+ * @param base PORT peripheral base pointer.
+ * @param mask PORT pin number macro.
+ */
+void PORT_ClearPinsInterruptFlags(PORT_Type *base, uint32_t mask);
+
 #endif /* _FSL_PORT_H_ */
@@ -149,6 +149,14 @@ typedef enum _tpm_clock_prescale
     kTPM_Prescale_Divide_128     /*!< Divide by 128 */
 } tpm_clock_prescale_t;
 
+/*! @brief TPM input capture edge */
+typedef enum _tpm_input_capture_edge
+{
+    kTPM_RisingEdge = (1U << 2),     /*!< Capture on rising edge only */
+    kTPM_FallingEdge = (2U << 2),    /*!< Capture on falling edge only */
+    kTPM_RiseAndFallEdge = (3U << 2) /*!< Capture on rising or falling edge */
+} tpm_input_capture_edge_t;
+
 /*!
  * @brief TPM config structure
  *
@@ -247,6 +255,18 @@ void TPM_Init(TPM_Type *base, const tpm_config_t *config);
  */
 void TPM_GetDefaultConfig(tpm_config_t *config);
 
+/*!
+ * @brief Enables capturing an input signal on the channel using the function parameters.
+ *
+ * When the edge specified in the captureMode argument occurs on the channel, the TPM counter is captured into
+ * the CnV register. The user has to read the CnV register separately to get this value.
+ *
+ * @param base        TPM peripheral base address
+ * @param chnlNumber  The channel number
+ * @param captureMode Specifies which edge to capture
+ */
+void TPM_SetupInputCapture(TPM_Type *base, tpm_chnl_t chnlNumber, tpm_input_capture_edge_t captureMode);
+
 /*!
  * @brief Enables the selected TPM interrupts.
  *
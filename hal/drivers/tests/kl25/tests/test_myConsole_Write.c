@@ -0,0 +1,413 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file test_myConsole_Write.c
+ * @brief Test file for testing the asynchronous console logic, writing and
+ *          draining the buffer through the LPSCI interrupt.
+ *
+ * The LPSCI is faked by a transmitter that takes some status polls to send
+ *  each byte, so the polls made during a write measure how long it waited
+ *  for the wire.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+
+#include "myConsole.h"
+
+#include "mock_myIrq.h"
+#include "mock_fsl_common.h"
+#include "mock_fsl_lpsci.h"
+
+#include <string.h>
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_BUFFER_SIZE                                                    (16)
+#define TEST_WIRE_SIZE                                                     (256)
+#define TEST_POLLS_PER_BYTE                                                  (8)
+#define TEST_IRQ_STATE                                                 (0x5A5AU)
+#define TEST_MESSAGE                                   "Hello from the console!"
+#define TEST_MESSAGE_LENGTH                           (sizeof(TEST_MESSAGE) - 1)
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static void initConsole(myConsoleFull_t full);
+static uint32_t writeString(const char * str);
+static void runInterrupts(void);
+static uint32_t lockFake(void);
+static void unlockFake(uint32_t state);
+static uint32_t getStatusFlagsFake(UART0_Type * base);
+static void enableInterruptsFake(UART0_Type * base, uint32_t mask);
+static void disableInterruptsFake(UART0_Type * base, uint32_t mask);
+static void writeByteFake(UART0_Type * base, uint8_t data);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static uint8_t buffer[TEST_BUFFER_SIZE];
+
+static uint8_t wire[TEST_WIRE_SIZE];
+static uint32_t wireLength;
+static uint32_t busyPolls;
+static uint32_t waitedPolls;
+static uint32_t maskedPolls;
+static bool txIrqEnabled;
+static bool irqMasked;
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  myConsole_Reset();
+
+  RESET_FAKE(myIrq_Lock);
+  RESET_FAKE(myIrq_Unlock);
+  RESET_FAKE(EnableIRQ);
+  RESET_FAKE(LPSCI_GetStatusFlags);
+  RESET_FAKE(LPSCI_EnableInterrupts);
+  RESET_FAKE(LPSCI_DisableInterrupts);
+  RESET_FAKE(LPSCI_WriteByte);
+  RESET_FAKE(LPSCI_WriteBlocking);
+
+  myIrq_Lock_fake.custom_fake = lockFake;
+  myIrq_Unlock_fake.custom_fake = unlockFake;
+  LPSCI_GetStatusFlags_fake.custom_fake = getStatusFlagsFake;
+  LPSCI_EnableInterrupts_fake.custom_fake = enableInterruptsFake;
+  LPSCI_DisableInterrupts_fake.custom_fake = disableInterruptsFake;
+  LPSCI_WriteByte_fake.custom_fake = writeByteFake;
+
+  memset(wire, 0, sizeof(wire));
+  wireLength = 0;
+  busyPolls = 0;
+  waitedPolls = 0;
+  maskedPolls = 0;
+  txIrqEnabled = false;
+  irqMasked = false;
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief Initialization should fail if no parameters or no buffer are given,
+ *          or if the buffer size is not a power of two.
+ */
+void test_IfParsAreInvalidThenInitFails(void)
+{
+  myConsolePars_t pars = { .buffer = NULL, .size = TEST_BUFFER_SIZE, .full = myConsoleFull_Drop };
+
+  TEST_ASSERT_EQUAL(myRet_Fail, myConsole_Init(NULL));
+  TEST_ASSERT_EQUAL(myRet_Fail, myConsole_Init(&pars));
+
+  pars.buffer = buffer;
+  pars.size = 0;
+  TEST_ASSERT_EQUAL(myRet_Fail, myConsole_Init(&pars));
+
+  pars.size = TEST_BUFFER_SIZE - 1;
+  TEST_ASSERT_EQUAL(myRet_Fail, myConsole_Init(&pars));
+}
+
+/**
+ * @brief Initialization should enable the LPSCI interrupt at the NVIC.
+ */
+void test_InitEnablesTheLpsciInterrupt(void)
+{
+  initConsole(myConsoleFull_Drop);
+
+  TEST_ASSERT_CALLED(EnableIRQ);
+  TEST_ASSERT_EQUAL(UART0_IRQn, EnableIRQ_fake.arg0_val);
+}
+
+/**
+ * @brief Before the initialization there is no buffer, so writes should be
+ *          sent right away, waiting for the wire.
+ */
+void test_IfNotInitializedThenWriteIsBlocking(void)
+{
+  TEST_ASSERT_EQUAL(TEST_MESSAGE_LENGTH, writeString(TEST_MESSAGE));
+
+  TEST_ASSERT_CALLED(LPSCI_WriteBlocking);
+  TEST_ASSERT_EQUAL_PTR(UART0, LPSCI_WriteBlocking_fake.arg0_val);
+  TEST_ASSERT_EQUAL(TEST_MESSAGE_LENGTH, LPSCI_WriteBlocking_fake.arg2_val);
+}
+
+/**
+ * @brief A write that fits the buffer should only queue the bytes and enable
+ *          the interrupt, never waiting for the wire nor touching it.
+ */
+void test_WriteQueuesWithoutWaitingForTheWire(void)
+{
+  initConsole(myConsoleFull_Drop);
+
+  TEST_ASSERT_EQUAL(TEST_BUFFER_SIZE, myConsole_Write((const uint8_t *) TEST_MESSAGE, TEST_BUFFER_SIZE));
+
+  TEST_ASSERT_EQUAL(0, waitedPolls);
+  TEST_ASSERT_EQUAL(0, LPSCI_WriteByte_fake.call_count);
+  TEST_ASSERT_EQUAL(0, LPSCI_WriteBlocking_fake.call_count);
+  TEST_ASSERT_TRUE(txIrqEnabled);
+}
+
+/**
+ * @brief Writes should be made with interrupts masked, so that the interrupt
+ *          and other writers cannot run meanwhile, and restore the mask.
+ */
+void test_WriteMasksInterrupts(void)
+{
+  initConsole(myConsoleFull_Drop);
+  writeString(TEST_MESSAGE);
+
+  TEST_ASSERT_CALLED(myIrq_Lock);
+  TEST_ASSERT_CALLED(myIrq_Unlock);
+  TEST_ASSERT_EQUAL_HEX32(TEST_IRQ_STATE, myIrq_Unlock_fake.arg0_val);
+}
+
+/**
+ * @brief Writing nothing should not enable the interrupt.
+ */
+void test_IfNothingIsWrittenThenInterruptIsNotEnabled(void)
+{
+  initConsole(myConsoleFull_Drop);
+
+  TEST_ASSERT_EQUAL(0, myConsole_Write((const uint8_t *) TEST_MESSAGE, 0));
+  TEST_ASSERT_EQUAL(0, myConsole_Write(NULL, TEST_MESSAGE_LENGTH));
+
+  TEST_ASSERT_FALSE(txIrqEnabled);
+}
+
+/**
+ * @brief The interrupt should send the queued bytes in order, and disable
+ *          itself once the buffer is empty.
+ */
+void test_InterruptSendsQueuedBytesInOrder(void)
+{
+  initConsole(myConsoleFull_Drop);
+  writeString("Hello");
+  runInterrupts();
+  writeString(" world");
+  runInterrupts();
+
+  TEST_ASSERT_EQUAL(11, wireLength);
+  TEST_ASSERT_EQUAL_MEMORY("Hello world", wire, 11);
+  TEST_ASSERT_FALSE(txIrqEnabled);
+}
+
+/**
+ * @brief The interrupt should not write anything while the transmitter is
+ *          still busy, nor lose the byte it could not send.
+ */
+void test_IfTransmitterIsBusyThenInterruptDoesNothing(void)
+{
+  initConsole(myConsoleFull_Drop);
+  writeString("ab");
+  UART0_IRQHandler();
+  UART0_IRQHandler();
+
+  TEST_ASSERT_EQUAL(1, wireLength);
+  TEST_ASSERT_TRUE(txIrqEnabled);
+
+  runInterrupts();
+  TEST_ASSERT_EQUAL(2, wireLength);
+  TEST_ASSERT_EQUAL_MEMORY("ab", wire, 2);
+}
+
+/**
+ * @brief The interrupt should mask the others while it touches the buffer,
+ *          as writers may run in interrupts of higher priority.
+ */
+void test_InterruptMasksInterrupts(void)
+{
+  initConsole(myConsoleFull_Drop);
+  writeString("a");
+  RESET_FAKE(myIrq_Lock);
+  RESET_FAKE(myIrq_Unlock);
+  myIrq_Lock_fake.custom_fake = lockFake;
+  myIrq_Unlock_fake.custom_fake = unlockFake;
+
+  UART0_IRQHandler();
+
+  TEST_ASSERT_EQUAL(1, myIrq_Lock_fake.call_count);
+  TEST_ASSERT_EQUAL(1, myIrq_Unlock_fake.call_count);
+  TEST_ASSERT_EQUAL_HEX32(TEST_IRQ_STATE, myIrq_Unlock_fake.arg0_val);
+}
+
+/**
+ * @brief If the buffer is full and the policy is to drop, the newest bytes
+ *          should be lost, counted, and the write should not wait.
+ */
+void test_IfBufferIsFullAndPolicyIsDropThenNewestBytesAreLost(void)
+{
+  initConsole(myConsoleFull_Drop);
+
+  TEST_ASSERT_EQUAL(TEST_BUFFER_SIZE, writeString(TEST_MESSAGE));
+  runInterrupts();
+
+  TEST_ASSERT_EQUAL(0, waitedPolls);
+  TEST_ASSERT_EQUAL(TEST_MESSAGE_LENGTH - TEST_BUFFER_SIZE, myConsole_GetLost());
+  TEST_ASSERT_EQUAL(TEST_BUFFER_SIZE, wireLength);
+  TEST_ASSERT_EQUAL_MEMORY(TEST_MESSAGE, wire, TEST_BUFFER_SIZE);
+}
+
+/**
+ * @brief If the buffer is full and the policy is to overwrite, the oldest
+ *          bytes should be lost, counted, and the write should not wait.
+ */
+void test_IfBufferIsFullAndPolicyIsOverwriteThenOldestBytesAreLost(void)
+{
+  const uint32_t lost = TEST_MESSAGE_LENGTH - TEST_BUFFER_SIZE;
+
+  initConsole(myConsoleFull_Overwrite);
+
+  TEST_ASSERT_EQUAL(TEST_MESSAGE_LENGTH, writeString(TEST_MESSAGE));
+  runInterrupts();
+
+  TEST_ASSERT_EQUAL(0, waitedPolls);
+  TEST_ASSERT_EQUAL(lost, myConsole_GetLost());
+  TEST_ASSERT_EQUAL(TEST_BUFFER_SIZE, wireLength);
+  TEST_ASSERT_EQUAL_MEMORY(&TEST_MESSAGE[lost], wire, TEST_BUFFER_SIZE);
+}
+
+/**
+ * @brief If the buffer is full and the policy is to block, nothing should be
+ *          lost: the write waits for the wire until the rest fits, sending
+ *          bytes itself when the interrupt does not run meanwhile.
+ */
+void test_IfBufferIsFullAndPolicyIsBlockThenNothingIsLost(void)
+{
+  initConsole(myConsoleFull_Block);
+
+  TEST_ASSERT_EQUAL(TEST_MESSAGE_LENGTH, writeString(TEST_MESSAGE));
+  TEST_ASSERT_NOT_EQUAL(0, waitedPolls);
+  TEST_ASSERT_EQUAL(0, maskedPolls);
+  runInterrupts();
+
+  TEST_ASSERT_EQUAL(0, myConsole_GetLost());
+  TEST_ASSERT_EQUAL(TEST_MESSAGE_LENGTH, wireLength);
+  TEST_ASSERT_EQUAL_MEMORY(TEST_MESSAGE, wire, TEST_MESSAGE_LENGTH);
+}
+
+/**
+ * @brief Flushing should send everything that is queued, wait for the wire
+ *          to be done with interrupts unmasked, and leave the interrupt
+ *          disabled.
+ */
+void test_FlushSendsEverythingQueued(void)
+{
+  initConsole(myConsoleFull_Drop);
+  writeString("Hello");
+  myConsole_Flush();
+
+  TEST_ASSERT_EQUAL(5, wireLength);
+  TEST_ASSERT_EQUAL_MEMORY("Hello", wire, 5);
+  TEST_ASSERT_EQUAL(0, busyPolls);
+  TEST_ASSERT_EQUAL(0, maskedPolls);
+  TEST_ASSERT_FALSE(txIrqEnabled);
+}
+
+/**
+ * @brief Writing a line should cost no wire time at all, which is only paid
+ *          by whoever waits for it to be sent, here by flushing.
+ */
+void test_OnlyFlushingWaitsForTheWire(void)
+{
+  initConsole(myConsoleFull_Block);
+  writeString("0123456789ABCDEF");
+  TEST_ASSERT_EQUAL(0, waitedPolls);
+
+  myConsole_Flush();
+  TEST_ASSERT_EQUAL(TEST_BUFFER_SIZE * TEST_POLLS_PER_BYTE, waitedPolls);
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static void initConsole(myConsoleFull_t full)
+{
+  myConsolePars_t pars = { .buffer = buffer, .size = TEST_BUFFER_SIZE, .full = full };
+
+  TEST_ASSERT_EQUAL(myRet_OK, myConsole_Init(&pars));
+}
+
+static uint32_t writeString(const char * str)
+{
+  return myConsole_Write((const uint8_t *) str, strlen(str));
+}
+
+static void runInterrupts(void)
+{
+  uint32_t bound = TEST_WIRE_SIZE * (TEST_POLLS_PER_BYTE + 1);
+
+  while(txIrqEnabled && (bound-- > 0))
+  {
+    busyPolls = 0;
+    UART0_IRQHandler();
+  }
+}
+
+static uint32_t lockFake(void)
+{
+  irqMasked = true;
+  return TEST_IRQ_STATE;
+}
+
+static void unlockFake(uint32_t state)
+{
+  irqMasked = false;
+}
+
+static uint32_t getStatusFlagsFake(UART0_Type * base)
+{
+  if(busyPolls > 0)
+  {
+    busyPolls--;
+    waitedPolls++;
+    if(irqMasked) { maskedPolls++; }
+    return 0;
+  }
+
+  return kLPSCI_TxDataRegEmptyFlag | kLPSCI_TransmissionCompleteFlag;
+}
+
+static void enableInterruptsFake(UART0_Type * base, uint32_t mask)
+{
+  if(mask & kLPSCI_TxDataRegEmptyInterruptEnable) { txIrqEnabled = true; }
+}
+
+static void disableInterruptsFake(UART0_Type * base, uint32_t mask)
+{
+  if(mask & kLPSCI_TxDataRegEmptyInterruptEnable) { txIrqEnabled = false; }
+}
+
+static void writeByteFake(UART0_Type * base, uint8_t data)
+{
+  TEST_ASSERT_EQUAL(0, busyPolls);
+  TEST_ASSERT_LESS_THAN(TEST_WIRE_SIZE, wireLength);
+
+  wire[wireLength++] = data;
+  busyPolls = TEST_POLLS_PER_BYTE;
+}
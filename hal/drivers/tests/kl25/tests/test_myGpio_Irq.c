@@ -0,0 +1,258 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test_myGpio_Irq.c
+ * @brief Test file for testing gpio driver logic, operation when pins are
+ *          initialized with interrupts, and when their ports interrupt.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+
+#include "myGpio.h"
+#include "myDriverDefs.h"
+
+#include "mock_fsl_gpio.h"
+#include "mock_fsl_port.h"
+#include "mock_fsl_clock.h"
+#include "mock_fsl_common.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_MY_GPIO_PIN_A                                        myDriverPin_04
+#define TEST_MY_GPIO_PIN_B                                        myDriverPin_13
+#define TEST_MY_GPIO_PIN_D                                        myDriverPin_04
+
+#define TEST_CALLS_MAX                                                       (8)
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static void callbackA(void);
+static void callbackB(void);
+static void callbackD(void);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static myGpioPin_t pin;
+static myGpioPars_t pars;
+
+static myCbk_t calls[TEST_CALLS_MAX];
+static uint32_t callCount;
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  myGpio_Reset();
+
+  pars = (myGpioPars_t) { myDriverPort_PTA, TEST_MY_GPIO_PIN_A, myGpioDir_Inpt, myGpioPull_Up, myGpioIrq_Fall, callbackA };
+  callCount = 0;
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief Only input pins can interrupt, so initializing an output pin with
+ *          an interrupt should fail.
+ */
+void test_IfPinIsOutputThenInitFails(void)
+{
+  pars.direction = myGpioDir_Outp;
+
+  TEST_ASSERT_EQUAL(myRet_Fail, myGpio_Init(&pin, &pars));
+  TEST_ASSERT_NOT_CALLED(PORT_SetPinInterruptConfig);
+}
+
+/**
+ * @brief An interrupt without a callback is useless, so init should fail.
+ */
+void test_IfCallbackIsNullThenInitFails(void)
+{
+  pars.cbk = NULL;
+
+  TEST_ASSERT_EQUAL(myRet_Fail, myGpio_Init(&pin, &pars));
+  TEST_ASSERT_NOT_CALLED(PORT_SetPinInterruptConfig);
+}
+
+/**
+ * @brief Only PORTA and PORTD have interrupts on KL25, so init should fail
+ *          for pins of the other ports.
+ */
+void test_IfPortCannotInterruptThenInitFails(void)
+{
+  pars.port = myDriverPort_PTB;
+
+  TEST_ASSERT_EQUAL(myRet_Fail, myGpio_Init(&pin, &pars));
+  TEST_ASSERT_NOT_CALLED(PORT_SetPinInterruptConfig);
+}
+
+/**
+ * @brief A pin without interrupt should leave the interrupt settings alone.
+ */
+void test_IfPinHasNoIrqThenInterruptIsNotConfigured(void)
+{
+  pars.irq = myGpioIrq_None;
+  pars.cbk = NULL;
+
+  TEST_ASSERT_EQUAL(myRet_OK, myGpio_Init(&pin, &pars));
+  TEST_ASSERT_NOT_CALLED(PORT_SetPinInterruptConfig);
+  TEST_ASSERT_NOT_CALLED(EnableIRQ);
+}
+
+/**
+ * @brief Init should configure the trigger of the pin and enable the
+ *          interrupt of its port.
+ */
+void test_InitConfiguresPinInterruptAndEnablesPortIrq(void)
+{
+  TEST_ASSERT_EQUAL(myRet_OK, myGpio_Init(&pin, &pars));
+
+  TEST_ASSERT_CALLED(PORT_SetPinInterruptConfig);
+  TEST_ASSERT_EQUAL_PTR(PORTA, PORT_SetPinInterruptConfig_fake.arg0_val);
+  TEST_ASSERT_EQUAL(TEST_MY_GPIO_PIN_A, PORT_SetPinInterruptConfig_fake.arg1_val);
+  TEST_ASSERT_EQUAL(kPORT_InterruptFallingEdge, PORT_SetPinInterruptConfig_fake.arg2_val);
+
+  TEST_ASSERT_CALLED(EnableIRQ);
+  TEST_ASSERT_EQUAL(PORTA_IRQn, EnableIRQ_fake.arg0_val);
+}
+
+/**
+ * @brief Each trigger should be translated to its PORT setting.
+ */
+void test_EachTriggerIsTranslatedToItsPortSetting(void)
+{
+  const myGpioIrq_t irqs[] = { myGpioIrq_Rise, myGpioIrq_Fall, myGpioIrq_Both, myGpioIrq_Low, myGpioIrq_High };
+  const port_interrupt_t configs[] = { kPORT_InterruptRisingEdge, kPORT_InterruptFallingEdge, kPORT_InterruptEitherEdge,
+                                       kPORT_InterruptLogicZero, kPORT_InterruptLogicOne };
+  uint32_t idx;
+
+  for(idx = 0; idx < sizeof(irqs) / sizeof(irqs[0]); idx++)
+  {
+    myGpio_Reset();
+    pars.irq = irqs[idx];
+
+    TEST_ASSERT_EQUAL(myRet_OK, myGpio_Init(&pin, &pars));
+    TEST_ASSERT_EQUAL(configs[idx], PORT_SetPinInterruptConfig_fake.arg2_val);
+  }
+}
+
+/**
+ * @brief The port routine should call back the pin that fired, and clear
+ *          the flags it has read.
+ */
+void test_IfPinFiresThenItsCallbackIsCalled(void)
+{
+  myGpio_Init(&pin, &pars);
+
+  PORT_GetPinsInterruptFlags_fake.return_val = (1UL << TEST_MY_GPIO_PIN_A);
+  PORTA_IRQHandler();
+
+  TEST_ASSERT_EQUAL(1, callCount);
+  TEST_ASSERT_EQUAL_PTR(callbackA, calls[0]);
+
+  TEST_ASSERT_EQUAL_PTR(PORTA, PORT_ClearPinsInterruptFlags_fake.arg0_val);
+  TEST_ASSERT_EQUAL_HEX32(1UL << TEST_MY_GPIO_PIN_A, PORT_ClearPinsInterruptFlags_fake.arg1_val);
+}
+
+/**
+ * @brief If several pins fire together, all of them should be called back
+ *          from a single run of the routine, highest pin first.
+ */
+void test_IfSeveralPinsFireThenAllAreCalledBack(void)
+{
+  myGpio_Init(&pin, &pars);
+  pars.pin = TEST_MY_GPIO_PIN_B;
+  pars.cbk = callbackB;
+  myGpio_Init(&pin, &pars);
+
+  PORT_GetPinsInterruptFlags_fake.return_val = (1UL << TEST_MY_GPIO_PIN_A) | (1UL << TEST_MY_GPIO_PIN_B);
+  PORTA_IRQHandler();
+
+  TEST_ASSERT_EQUAL(2, callCount);
+  TEST_ASSERT_EQUAL_PTR(callbackB, calls[0]);
+  TEST_ASSERT_EQUAL_PTR(callbackA, calls[1]);
+}
+
+/**
+ * @brief Flags of pins without a callback should be cleared, without
+ *          calling anything.
+ */
+void test_IfPinWithoutCallbackFiresThenNothingIsCalled(void)
+{
+  myGpio_Init(&pin, &pars);
+
+  PORT_GetPinsInterruptFlags_fake.return_val = (1UL << myDriverPin_31);
+  PORTA_IRQHandler();
+
+  TEST_ASSERT_EQUAL(0, callCount);
+  TEST_ASSERT_EQUAL_HEX32(1UL << myDriverPin_31, PORT_ClearPinsInterruptFlags_fake.arg1_val);
+}
+
+/**
+ * @brief Each port should have callbacks of its own, even for pins with the
+ *          same number.
+ */
+void test_EachPortCallsBackItsOwnPins(void)
+{
+  myGpio_Init(&pin, &pars);
+  pars.port = myDriverPort_PTD;
+  pars.pin = TEST_MY_GPIO_PIN_D;
+  pars.cbk = callbackD;
+  myGpio_Init(&pin, &pars);
+
+  TEST_ASSERT_EQUAL(PORTD_IRQn, EnableIRQ_fake.arg0_val);
+
+  PORT_GetPinsInterruptFlags_fake.return_val = (1UL << TEST_MY_GPIO_PIN_D);
+  PORTD_IRQHandler();
+
+  TEST_ASSERT_EQUAL(1, callCount);
+  TEST_ASSERT_EQUAL_PTR(callbackD, calls[0]);
+  TEST_ASSERT_EQUAL_PTR(PORTD, PORT_GetPinsInterruptFlags_fake.arg0_val);
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static void callbackA(void)
+{
+  if(callCount < TEST_CALLS_MAX) { calls[callCount] = callbackA; }
+  callCount++;
+}
+
+static void callbackB(void)
+{
+  if(callCount < TEST_CALLS_MAX) { calls[callCount] = callbackB; }
+  callCount++;
+}
+
+static void callbackD(void)
+{
+  if(callCount < TEST_CALLS_MAX) { calls[callCount] = callbackD; }
+  callCount++;
+}
@@ -0,0 +1,171 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test_myGpio_Port.c
+ * @brief Test file for testing gpio driver logic, operation when groups of
+ *          pins are initialized, read and written, checked on the registers.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+
+#include "myGpio.h"
+#include "myDriverDefs.h"
+
+#include "mock_fsl_gpio.h"
+#include "mock_fsl_port.h"
+#include "mock_fsl_clock.h"
+#include "mock_fsl_common.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_MY_GPIO_PORT                                       myDriverPort_PTB
+#define TEST_MY_GPIO_REGS                                             GPIOB_Regs
+#define TEST_MY_GPIO_MASK                                           (0x000F0300)
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static void initializePort(void);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static myGpioPort_t port;
+static myGpioPortPars_t pars;
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  myGpio_Reset();
+  TEST_MY_GPIO_REGS = (GPIO_Type) { 0 };
+  initializePort();
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief A group with no pins, or on a port that does not exist, should not
+ *          be initialized.
+ */
+void test_IfParsAreInvalidThenInitFails(void)
+{
+  myGpioPort_t other;
+  myGpioPortPars_t otherPars = pars;
+
+  otherPars.mask = 0;
+  TEST_ASSERT_EQUAL(myRet_Fail, myGpio_InitPort(&other, &otherPars));
+
+  otherPars = pars;
+  otherPars.port = myDriverPort_PTE + 1;
+  TEST_ASSERT_EQUAL(myRet_Fail, myGpio_InitPort(&other, &otherPars));
+
+  TEST_ASSERT_EQUAL(myRet_Fail, myGpio_InitPort(NULL, &pars));
+  TEST_ASSERT_EQUAL(myRet_Fail, myGpio_InitPort(&other, NULL));
+}
+
+/**
+ * @brief Each pin of the group, and only them, should be configured.
+ */
+void test_InitConfiguresEachPinOfTheGroup(void)
+{
+  TEST_ASSERT_CALLED_TIMES(6, GPIO_PinInit);
+  TEST_ASSERT_CALLED_TIMES(6, PORT_SetPinConfig);
+  TEST_ASSERT_EQUAL_PTR(GPIOB, GPIO_PinInit_fake.arg0_history[0]);
+  TEST_ASSERT_EQUAL(myDriverPin_08, GPIO_PinInit_fake.arg1_history[0]);
+  TEST_ASSERT_EQUAL(myDriverPin_19, GPIO_PinInit_fake.arg1_history[5]);
+}
+
+/**
+ * @brief Setting pins should be a single store to PSOR, restricted to the
+ *          group, with no call into the sdk.
+ */
+void test_SetMaskWritesPSOR(void)
+{
+  TEST_ASSERT_EQUAL(myRet_OK, myGpio_SetMask(port, 0xFFFFFFFF));
+
+  TEST_ASSERT_EQUAL_HEX32(TEST_MY_GPIO_MASK, TEST_MY_GPIO_REGS.PSOR);
+  TEST_ASSERT_EQUAL_HEX32(0, TEST_MY_GPIO_REGS.PDOR);
+  TEST_ASSERT_NOT_CALLED(GPIO_WritePinOutput);
+}
+
+/**
+ * @brief Clearing pins should be a single store to PCOR.
+ */
+void test_ClearMaskWritesPCOR(void)
+{
+  TEST_ASSERT_EQUAL(myRet_OK, myGpio_ClearMask(port, 0x00010100));
+
+  TEST_ASSERT_EQUAL_HEX32(0x00010100, TEST_MY_GPIO_REGS.PCOR);
+  TEST_ASSERT_EQUAL_HEX32(0, TEST_MY_GPIO_REGS.PSOR);
+}
+
+/**
+ * @brief Toggling pins should be a single store to PTOR.
+ */
+void test_ToggleMaskWritesPTOR(void)
+{
+  TEST_ASSERT_EQUAL(myRet_OK, myGpio_ToggleMask(port, 0x00F00300));
+
+  TEST_ASSERT_EQUAL_HEX32(0x00000300, TEST_MY_GPIO_REGS.PTOR);
+}
+
+/**
+ * @brief Writing the group should set its high pins and clear its low ones.
+ */
+void test_WritePortSetsAndClearsTheGroup(void)
+{
+  TEST_ASSERT_EQUAL(myRet_OK, myGpio_WritePort(port, 0x00050200));
+
+  TEST_ASSERT_EQUAL_HEX32(0x00050200, TEST_MY_GPIO_REGS.PSOR);
+  TEST_ASSERT_EQUAL_HEX32(0x000A0100, TEST_MY_GPIO_REGS.PCOR);
+}
+
+/**
+ * @brief Reading the group should be a single load of PDIR, masked.
+ */
+void test_GetPortReadsPDIR(void)
+{
+  TEST_MY_GPIO_REGS.PDIR = 0xFFFA0200;
+
+  TEST_ASSERT_EQUAL_HEX32(0x000A0200, myGpio_GetPort(port));
+  TEST_ASSERT_NOT_CALLED(GPIO_ReadPinInput);
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static void initializePort(void)
+{
+  pars.port = TEST_MY_GPIO_PORT;
+  pars.mask = TEST_MY_GPIO_MASK;
+  pars.direction = myGpioDir_Outp;
+  pars.pull = myGpioPull_No;
+
+  myGpio_InitPort(&port, &pars);
+}
@@ -0,0 +1,90 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test_myGpio_Toggle.c
+ * @brief Test file for testing gpio driver logic, operation when
+ *          myGpio_Toggle is called, after correct initialization.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+
+#include "myGpio.h"
+#include "myDriverDefs.h"
+
+#include "mock_fsl_gpio.h"
+#include "mock_fsl_port.h"
+#include "mock_fsl_clock.h"
+#include "mock_fsl_common.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_MY_GPIO_PORT                                       myDriverPort_PTB
+#define TEST_MY_GPIO_PIN                                          myDriverPin_19
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static myGpioPin_t pin;
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  myGpioPars_t pars = { TEST_MY_GPIO_PORT, TEST_MY_GPIO_PIN, myGpioDir_Outp, myGpioPull_No };
+
+  myGpio_Reset();
+  myGpio_Init(&pin, &pars);
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief Toggling a pin that was not initialized should fail.
+ */
+void test_IfPinIsInvalidThenToggleFails(void)
+{
+  TEST_ASSERT_EQUAL(myRet_Fail, myGpio_Toggle(NULL));
+  TEST_ASSERT_NOT_CALLED(GPIO_TogglePinsOutput);
+}
+
+/**
+ * @brief myGpio_Toggle logic should call GPIO_TogglePinsOutput with the
+ *          correct GPIO pointer and the mask of the pin.
+ */
+void test_LogicCallsGPIOTogglePinsOutput(void)
+{
+  TEST_ASSERT_EQUAL(myRet_OK, myGpio_Toggle(pin));
+
+  TEST_ASSERT_CALLED(GPIO_TogglePinsOutput);
+  TEST_ASSERT_EQUAL_PTR(GPIOB, GPIO_TogglePinsOutput_fake.arg0_val);
+  TEST_ASSERT_EQUAL_HEX32(1U << TEST_MY_GPIO_PIN, GPIO_TogglePinsOutput_fake.arg1_val);
+}
@@ -0,0 +1,74 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file test_myIrq_Lock.c
+ * @brief Test file for testing interrupt masking logic, operation when
+ *          sections are masked and unmasked.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+
+#include "myIrq.h"
+
+#include "mock_fsl_common.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_PRIMASK                                                         (1)
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief Locking should mask the interrupts and hand back the former mask.
+ */
+void test_IfLockedThenInterruptsAreMasked(void)
+{
+  DisableGlobalIRQ_fake.return_val = TEST_PRIMASK;
+
+  TEST_ASSERT_EQUAL(TEST_PRIMASK, myIrq_Lock());
+  TEST_ASSERT_CALLED(DisableGlobalIRQ);
+}
+
+/**
+ * @brief Unlocking should restore the mask that was handed to it, so that
+ *          nested sections don't unmask the outer ones.
+ */
+void test_IfUnlockedThenMaskIsRestored(void)
+{
+  myIrq_Unlock(TEST_PRIMASK);
+
+  TEST_ASSERT_CALLED(EnableGlobalIRQ);
+  TEST_ASSERT_EQUAL(TEST_PRIMASK, EnableGlobalIRQ_fake.arg0_val);
+}
@@ -0,0 +1,85 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file test_myPower_Sleep.c
+ * @brief Test file for testing power driver logic, operation when the core is
+ *          put to sleep.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+
+#include "myPower.h"
+
+#include "mock_fsl_smc.h"
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief Starting an idle period should mask the interrupts as the SMC needs
+ *          before entering a wait mode.
+ */
+void test_IfIdleIsEnteredThenInterruptsAreMasked(void)
+{
+  myPower_IdleEnter();
+
+  TEST_ASSERT_CALLED(SMC_PreEnterWaitModes);
+  TEST_ASSERT_NOT_CALLED(SMC_SetPowerModeWait);
+}
+
+/**
+ * @brief Sleeping should put the core in the WAIT mode, in which the
+ *          peripherals keep running to wake it up.
+ */
+void test_IfCoreSleepsThenWaitModeIsEntered(void)
+{
+  myPower_Sleep();
+
+  TEST_ASSERT_CALLED(SMC_SetPowerModeWait);
+  TEST_ASSERT_EQUAL_PTR(SMC, SMC_SetPowerModeWait_fake.arg0_val);
+}
+
+/**
+ * @brief A whole idle period should unmask the interrupts only after waking
+ *          up.
+ */
+void test_IfIdleIsExitedThenInterruptsAreUnmaskedAfterWaking(void)
+{
+  myPower_IdleEnter();
+  myPower_Sleep();
+  myPower_IdleExit();
+
+  TEST_ASSERT_CALLED_IN_ORDER(0, SMC_PreEnterWaitModes);
+  TEST_ASSERT_CALLED_IN_ORDER(1, SMC_SetPowerModeWait);
+  TEST_ASSERT_CALLED_IN_ORDER(2, SMC_PostExitWaitModes);
+}
@@ -0,0 +1,217 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file test_myTime_Now.c
+ * @brief Test file for testing time driver logic, reading the system time
+ *          through the SysTick and its software extension.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+
+#include "myTime.h"
+#include "myPeriod.h"
+
+#include "mock_fsl_clock.h"
+#include "mock_fsl_common.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_WRAP_COUNTS                                             (1UL << 24)
+#define TEST_CLOCK_HZ                                                 (48000000)
+#define TEST_FLL_CLOCK_HZ                                             (20971520)
+#define TEST_US_PER_WRAP         (TEST_WRAP_COUNTS * 1000000ULL / TEST_CLOCK_HZ)
+#define TEST_COUNTS_PER_US                             (TEST_CLOCK_HZ / 1000000)
+#define TEST_SAMPLES_PER_WRAP                                               (64)
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static void initTime(uint32_t clockHz);
+static void setElapsedCounts(uint32_t counts);
+static void setWrapPending(bool pending);
+static void runWrap(void);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  myTime_Reset();
+  SysTick_Regs = (SysTick_Type) { 0 };
+  SCB_Regs = (SCB_Type) { 0 };
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief On initialization the SysTick should be set to count the core clock
+ *          along its whole 24 bits, interrupting on each wrap with the
+ *          highest priority.
+ */
+void test_SysTickIsSetToCountTheCoreClockOnWholeRange(void)
+{
+  initTime(TEST_CLOCK_HZ);
+
+  TEST_ASSERT_EQUAL_HEX32(TEST_WRAP_COUNTS - 1, SysTick_Regs.LOAD);
+  TEST_ASSERT_EQUAL_HEX32(SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk, SysTick_Regs.CTRL);
+  TEST_ASSERT_CALLED(NVIC_SetPriority);
+  TEST_ASSERT_EQUAL(SysTick_IRQn, NVIC_SetPriority_fake.arg0_val);
+  TEST_ASSERT_EQUAL(0, NVIC_SetPriority_fake.arg1_val);
+}
+
+/**
+ * @brief Time should start at zero on initialization.
+ */
+void test_TimeStartsAtZero(void)
+{
+  initTime(TEST_CLOCK_HZ);
+
+  TEST_ASSERT_EQUAL_UINT64(0, myTime_Now());
+}
+
+/**
+ * @brief Within a wrap, time should follow the counter, rounded down to us.
+ */
+void test_TimeFollowsTheCounterWithinAWrap(void)
+{
+  initTime(TEST_CLOCK_HZ);
+
+  setElapsedCounts(1000 * TEST_COUNTS_PER_US);
+  TEST_ASSERT_EQUAL_UINT64(1000, myTime_Now());
+
+  setElapsedCounts(1000 * TEST_COUNTS_PER_US - 1);
+  TEST_ASSERT_EQUAL_UINT64(999, myTime_Now());
+}
+
+/**
+ * @brief A wrap is not a whole amount of us, but the time should not drift
+ *          from the counts no matter how many wraps happen.
+ */
+void test_WrapsAreAccumulatedWithoutDrift(void)
+{
+  uint32_t wraps;
+
+  initTime(TEST_CLOCK_HZ);
+
+  /* 3 wraps at 48 MHz are exactly 2^20 us, and each one is 349525.33 us.     */
+  for(wraps = 0; wraps < 3000; wraps++)
+  {
+    runWrap();
+    if(wraps == 2) { TEST_ASSERT_EQUAL_UINT64(1048576, myTime_Now()); }
+  }
+
+  TEST_ASSERT_EQUAL_UINT64(1048576000, myTime_Now());
+}
+
+/**
+ * @brief A wrap that happened while its interrupt could not run yet should
+ *          already be counted by the time read.
+ */
+void test_PendingWrapIsCountedBeforeItsInterruptRuns(void)
+{
+  initTime(TEST_CLOCK_HZ);
+
+  setElapsedCounts(TEST_COUNTS_PER_US);
+  setWrapPending(true);
+  TEST_ASSERT_EQUAL_UINT64(TEST_US_PER_WRAP + 1, myTime_Now());
+
+  runWrap();
+  setElapsedCounts(TEST_COUNTS_PER_US);
+  TEST_ASSERT_EQUAL_UINT64(TEST_US_PER_WRAP + 1, myTime_Now());
+}
+
+/**
+ * @brief With a clock that does not divide a us evenly, time should never
+ *          go back, not even around the wraps, and should never be more than
+ *          a us away from the exact time.
+ */
+void test_TimeIsMonotonicAndExactAcrossWraps(void)
+{
+  const uint32_t step = TEST_WRAP_COUNTS / TEST_SAMPLES_PER_WRAP - 1;
+  uint64_t previous = 0;
+  uint64_t now, exact;
+  uint32_t wraps, counts;
+
+  initTime(TEST_FLL_CLOCK_HZ);
+
+  for(wraps = 0; wraps < 100; wraps++)
+  {
+    for(counts = 1; counts < TEST_WRAP_COUNTS; counts += step)
+    {
+      setElapsedCounts(counts);
+      now = myTime_Now();
+      exact = ((uint64_t)wraps * TEST_WRAP_COUNTS + counts) * 1000000 / TEST_FLL_CLOCK_HZ;
+
+      TEST_ASSERT_TRUE(now >= previous);
+      TEST_ASSERT_TRUE((now <= exact + 1) && (now + 1 >= exact));
+      previous = now;
+    }
+
+    /* The counter reaches zero, and its interrupt is only handled later.     */
+    setElapsedCounts(TEST_WRAP_COUNTS - 1);
+    TEST_ASSERT_TRUE(myTime_Now() >= previous);
+    setElapsedCounts(0);
+    setWrapPending(true);
+    TEST_ASSERT_TRUE(myTime_Now() >= previous);
+    previous = myTime_Now();
+    runWrap();
+    TEST_ASSERT_EQUAL_UINT64(previous, myTime_Now());
+  }
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static void initTime(uint32_t clockHz)
+{
+  CLOCK_GetCoreSysClkFreq_fake.return_val = clockHz;
+  myTime_Init();
+}
+
+static void setElapsedCounts(uint32_t counts)
+{
+  /* The SysTick counts down, and a wrap starts when it reaches zero.         */
+  SysTick_Regs.VAL = (TEST_WRAP_COUNTS - counts) & (TEST_WRAP_COUNTS - 1);
+}
+
+static void setWrapPending(bool pending)
+{
+  if(pending) { SCB_Regs.ICSR |= SCB_ICSR_PENDSTSET_Msk;  }
+  else        { SCB_Regs.ICSR &= ~SCB_ICSR_PENDSTSET_Msk; }
+}
+
+static void runWrap(void)
+{
+  setWrapPending(false);
+  setElapsedCounts(0);
+  SysTick_Handler();
+}
@@ -0,0 +1,186 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file test_myTime_Tick.c
+ * @brief Test file for testing time driver logic, sharing the SysTick wraps
+ *          with the timer driver.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+
+#include "myTime.h"
+#include "myTime_Tick.h"
+#include "myPeriod.h"
+
+#include "mock_fsl_clock.h"
+#include "mock_fsl_common.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_WRAP_COUNTS                                             (1UL << 24)
+#define TEST_CLOCK_HZ                                                 (48000000)
+#define TEST_FLL_CLOCK_HZ                                             (20971520)
+#define TEST_COUNTS_PER_US                             (TEST_CLOCK_HZ / 1000000)
+#define TEST_TICK_US                                                      (1000)
+#define TEST_TICK_COUNTS                     (TEST_TICK_US * TEST_COUNTS_PER_US)
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static void initTime(uint32_t clockHz);
+static void setElapsedCounts(uint32_t wrap, uint32_t counts);
+static void runWrap(void);
+static void tickCallback(void);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static uint32_t callbackCallCount;
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  myTime_Reset();
+  SysTick_Regs = (SysTick_Type) { 0 };
+  SCB_Regs = (SCB_Type) { 0 };
+  callbackCallCount = 0;
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief The SysTick should be reloaded with the new wrap length, and keep
+ *          running with its interrupt enabled.
+ */
+void test_SysTickIsSetToTheNewWrapLength(void)
+{
+  initTime(TEST_CLOCK_HZ);
+  myTime_SetTick(TEST_TICK_COUNTS, tickCallback);
+
+  TEST_ASSERT_EQUAL_HEX32(TEST_TICK_COUNTS - 1, SysTick_Regs.LOAD);
+  TEST_ASSERT_EQUAL_HEX32(SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk, SysTick_Regs.CTRL);
+}
+
+/**
+ * @brief The wrap length should be changed with interrupts masked, as the
+ *          SysTick interrupt must not run while it is halfway set.
+ */
+void test_WrapLengthIsChangedWithInterruptsMasked(void)
+{
+  initTime(TEST_CLOCK_HZ);
+  myTime_SetTick(TEST_TICK_COUNTS, tickCallback);
+
+  TEST_ASSERT_CALLED(DisableGlobalIRQ);
+  TEST_ASSERT_CALLED(EnableGlobalIRQ);
+}
+
+/**
+ * @brief The time should go on from where it was when the wrap length
+ *          changed, and then follow the new wraps.
+ */
+void test_TimeGoesOnFromWhereItWas(void)
+{
+  initTime(TEST_CLOCK_HZ);
+
+  setElapsedCounts(TEST_WRAP_COUNTS, 5000 * TEST_COUNTS_PER_US);
+  myTime_SetTick(TEST_TICK_COUNTS, tickCallback);
+  TEST_ASSERT_EQUAL_UINT64(5000, myTime_Now());
+
+  setElapsedCounts(TEST_TICK_COUNTS, 10 * TEST_COUNTS_PER_US);
+  TEST_ASSERT_EQUAL_UINT64(5010, myTime_Now());
+
+  runWrap();
+  TEST_ASSERT_EQUAL_UINT64(5000 + TEST_TICK_US, myTime_Now());
+}
+
+/**
+ * @brief The callback should be called on each wrap, and not anymore once
+ *          the default wraps are back.
+ */
+void test_CallbackIsCalledOnEachWrap(void)
+{
+  initTime(TEST_CLOCK_HZ);
+  myTime_SetTick(TEST_TICK_COUNTS, tickCallback);
+
+  runWrap();
+  runWrap();
+  TEST_ASSERT_EQUAL(2, callbackCallCount);
+
+  myTime_SetTick(0, NULL);
+  runWrap();
+  TEST_ASSERT_EQUAL(2, callbackCallCount);
+  TEST_ASSERT_EQUAL_HEX32(TEST_WRAP_COUNTS - 1, SysTick_Regs.LOAD);
+}
+
+/**
+ * @brief Short wraps that are not a whole amount of us should not make the
+ *          time drift either.
+ */
+void test_ShortWrapsAreAccumulatedWithoutDrift(void)
+{
+  uint32_t wraps;
+
+  /* 32768 counts at 20.97152 MHz are 1562.5 us, so 1001 of them are          */
+  /*  exactly 1564062.5 us.                                                   */
+  initTime(TEST_FLL_CLOCK_HZ);
+  myTime_SetTick(32768, tickCallback);
+
+  for(wraps = 0; wraps < 1001; wraps++) { runWrap(); }
+
+  TEST_ASSERT_EQUAL_UINT64(1564062, myTime_Now());
+  TEST_ASSERT_EQUAL(1001, callbackCallCount);
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static void initTime(uint32_t clockHz)
+{
+  CLOCK_GetCoreSysClkFreq_fake.return_val = clockHz;
+  myTime_Init();
+}
+
+static void setElapsedCounts(uint32_t wrap, uint32_t counts)
+{
+  /* The SysTick counts down, and a wrap starts when it reaches zero.         */
+  SysTick_Regs.VAL = (counts == 0) ? 0 : (wrap - counts);
+}
+
+static void runWrap(void)
+{
+  SCB_Regs.ICSR = 0;
+  SysTick_Regs.VAL = 0;
+  SysTick_Handler();
+}
+
+static void tickCallback(void)
+{
+  callbackCallCount++;
+}
@@ -27,12 +27,19 @@
 #include "myTestDefs.h"
 
 #include "myTimer.h"
+#include "myWheel.h"
+#include "myPeriod.h"
+#include "mySplit.h"
+#include "myRing.h"
 #include "myDriverDefs.h"
 
 #include "mock_fsl_tpm.h"
+#include "mock_fsl_pit.h"
+#include "mock_fsl_port.h"
 #include "mock_fsl_clock.h"
 #include "mock_fsl_common.h"
 #include "mock_myTimer_TPM.h"
+#include "mock_myTime_Tick.h"
 
 /*******************************************************************************
  *  PRIVATE DEFINITIONS
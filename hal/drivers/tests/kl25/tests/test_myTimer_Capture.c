@@ -0,0 +1,282 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file test_myTimer_Capture.c
+ * @brief Test file for testing timer driver logic, operation of capture
+ *          timers.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+
+#include "myTimer.h"
+#include "myWheel.h"
+#include "myPeriod.h"
+#include "mySplit.h"
+#include "myRing.h"
+#include "myDriverDefs.h"
+
+#include "mock_fsl_tpm.h"
+#include "mock_fsl_pit.h"
+#include "mock_fsl_port.h"
+#include "mock_fsl_clock.h"
+#include "mock_fsl_common.h"
+#include "mock_myTimer_TPM.h"
+#include "mock_myTime_Tick.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_CLOCK_FREQ                                                (8000000)
+#define TEST_RING_SIZE                                                       (4)
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static void initCapture(myTimerEdge_t edge);
+static void captureEdge(uint32_t flags, uint32_t value);
+static void timerCallback(void);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static myTimer_t timer = NULL;
+static myRing_t ring;
+static uint32_t storage[TEST_RING_SIZE];
+static uint32_t callbackCallCount;
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  CLOCK_GetOsc0ErClkFreq_fake.return_val = TEST_CLOCK_FREQ;
+  myTimer_Reset();
+  myRing_Init(&ring, storage, sizeof(uint32_t), TEST_RING_SIZE);
+  timer = NULL;
+  callbackCallCount = 0;
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief Capture timers are latched by the TPM itself, so a virtual one
+ *          should not be initialized.
+ */
+void test_IfCaptureTimerIsVirtualThenInitFails(void)
+{
+  myTimerPars_t pars = { .mode = myTimerMode_Capture, .resource = myTimerRes_Virtual, .ring = &ring };
+
+  TEST_ASSERT_EQUAL(myRet_Fail, myTimer_Init(&timer, &pars));
+}
+
+/**
+ * @brief Timestamps have nowhere to go without a ring, so init should fail.
+ */
+void test_IfRingIsMissingThenInitFails(void)
+{
+  myTimerPars_t pars = { .mode = myTimerMode_Capture, .resource = myTimerRes_Dedicated, .channel = myDriverTimerCh_TPM0_CH2_PTD2 };
+
+  TEST_ASSERT_EQUAL(myRet_Fail, myTimer_Init(&timer, &pars));
+  TEST_ASSERT_NOT_CALLED(TPM_Init);
+}
+
+/**
+ * @brief The TPM channel should be set to capture the given edges, with its
+ *          pin routed to it, and interrupt on them as well as on overflows.
+ */
+void test_IfChannelIsValidThenItIsSetForCapture(void)
+{
+  initCapture(myTimerEdge_Both);
+
+  TEST_ASSERT_EQUAL_PTR(TPM0, TPM_SetupInputCapture_fake.arg0_val);
+  TEST_ASSERT_EQUAL(kTPM_Chnl_2, TPM_SetupInputCapture_fake.arg1_val);
+  TEST_ASSERT_EQUAL(kTPM_RiseAndFallEdge, TPM_SetupInputCapture_fake.arg2_val);
+  TEST_ASSERT_EQUAL_PTR(PORTD, PORT_SetPinConfig_fake.arg0_val);
+  TEST_ASSERT_EQUAL(2, PORT_SetPinConfig_fake.arg1_val);
+  TEST_ASSERT_EQUAL_HEX32(kTPM_Chnl2InterruptEnable | kTPM_TimeOverflowInterruptEnable, TPM_EnableInterrupts_fake.arg1_val);
+}
+
+/**
+ * @brief Nothing should be pushed before the timer is started, so its
+ *          interrupt is only unmasked then.
+ */
+void test_IfCaptureTimerIsNotStartedThenInterruptIsMasked(void)
+{
+  initCapture(myTimerEdge_Rise);
+
+  TEST_ASSERT_EQUAL(kTPM_RisingEdge, TPM_SetupInputCapture_fake.arg2_val);
+  TEST_ASSERT_NOT_CALLED(EnableIRQ);
+  TEST_ASSERT_EQUAL(0, myTimer_GetCaptureHz(timer));
+}
+
+/**
+ * @brief Once started, the TPM should count at full resolution through its
+ *          whole 16 bits, and the rate should be the TPM clock.
+ */
+void test_IfCaptureTimerIsStartedThenTPMCountsAtFullResolution(void)
+{
+  initCapture(myTimerEdge_Fall);
+
+  TEST_ASSERT_EQUAL(myRet_OK, myTimer_Start(timer, 0, NULL));
+  TEST_ASSERT_EQUAL(kTPM_Prescale_Divide_1, TPM_SetPrescaler_fake.arg1_val);
+  TEST_ASSERT_EQUAL_HEX32(0xFFFF, TPM_SetTimerPeriod_fake.arg1_val);
+  TEST_ASSERT_CALLED(TPM_StartTimer);
+  TEST_ASSERT_EQUAL(TPM0_IRQn, EnableIRQ_fake.arg0_val);
+  TEST_ASSERT_EQUAL(TEST_CLOCK_FREQ, myTimer_GetCaptureHz(timer));
+}
+
+/**
+ * @brief Each edge should push the latched value into the ring, extended
+ *          with the overflows that came before it.
+ */
+void test_EdgesArePushedWithOverflows(void)
+{
+  uint32_t stamps[2];
+
+  initCapture(myTimerEdge_Rise);
+  myTimer_Start(timer, 0, NULL);
+
+  captureEdge(kTPM_Chnl2Flag, 0x1234);
+  captureEdge(kTPM_TimeOverflowFlag, 0);
+  captureEdge(kTPM_TimeOverflowFlag, 0);
+  captureEdge(kTPM_Chnl2Flag, 0x0010);
+
+  TEST_ASSERT_EQUAL(2, myRing_PopMany(&ring, stamps, 2));
+  TEST_ASSERT_EQUAL_HEX32(0x00001234, stamps[0]);
+  TEST_ASSERT_EQUAL_HEX32(0x00020010, stamps[1]);
+}
+
+/**
+ * @brief If an edge and an overflow are pending together, a latched value in
+ *          the lower half should be taken as after the overflow, and one in
+ *          the upper half as before it.
+ */
+void test_IfOverflowIsPendingWithEdgeThenValueTellsTheirOrder(void)
+{
+  uint32_t stamps[3];
+
+  initCapture(myTimerEdge_Rise);
+  myTimer_Start(timer, 0, NULL);
+
+  captureEdge(kTPM_Chnl2Flag | kTPM_TimeOverflowFlag, 0xFFF0);
+  captureEdge(kTPM_Chnl2Flag | kTPM_TimeOverflowFlag, 0x0008);
+  captureEdge(kTPM_Chnl2Flag, 0x0020);
+
+  TEST_ASSERT_EQUAL(3, myRing_PopMany(&ring, stamps, 3));
+  TEST_ASSERT_EQUAL_HEX32(0x0000FFF0, stamps[0]);
+  TEST_ASSERT_EQUAL_HEX32(0x00020008, stamps[1]);
+  TEST_ASSERT_EQUAL_HEX32(0x00020020, stamps[2]);
+}
+
+/**
+ * @brief The callback should only come when the ring was empty, so that the
+ *          consumer is woken up once for each batch it drains.
+ */
+void test_CallbackIsOnlyCalledWhenRingWasEmpty(void)
+{
+  uint32_t stamps[TEST_RING_SIZE];
+
+  initCapture(myTimerEdge_Rise);
+  myTimer_Start(timer, 0, timerCallback);
+
+  captureEdge(kTPM_Chnl2Flag, 1);
+  captureEdge(kTPM_Chnl2Flag, 2);
+  captureEdge(kTPM_TimeOverflowFlag, 0);
+  TEST_ASSERT_EQUAL(1, callbackCallCount);
+
+  myRing_PopMany(&ring, stamps, TEST_RING_SIZE);
+  captureEdge(kTPM_Chnl2Flag, 3);
+  TEST_ASSERT_EQUAL(2, callbackCallCount);
+}
+
+/**
+ * @brief Edges that find the ring full should be dropped, keeping the ones
+ *          that are already there.
+ */
+void test_IfRingIsFullThenEdgeIsDropped(void)
+{
+  uint32_t stamps[TEST_RING_SIZE + 1];
+  uint32_t idx;
+
+  initCapture(myTimerEdge_Rise);
+  myTimer_Start(timer, 0, NULL);
+
+  for(idx = 0; idx <= TEST_RING_SIZE; idx++) { captureEdge(kTPM_Chnl2Flag, idx); }
+
+  TEST_ASSERT_EQUAL(TEST_RING_SIZE, myRing_PopMany(&ring, stamps, TEST_RING_SIZE + 1));
+  TEST_ASSERT_EQUAL(TEST_RING_SIZE - 1, stamps[TEST_RING_SIZE - 1]);
+}
+
+/**
+ * @brief A stopped capture timer should mask its interrupt, as the TPM still
+ *          latches edges, and no longer report a rate.
+ */
+void test_IfCaptureTimerIsStoppedThenInterruptIsMasked(void)
+{
+  initCapture(myTimerEdge_Rise);
+  myTimer_Start(timer, 0, NULL);
+  RESET_FAKE(DisableIRQ);
+
+  TEST_ASSERT_EQUAL(myRet_OK, myTimer_Stop(timer));
+  TEST_ASSERT_EQUAL(TPM0_IRQn, DisableIRQ_fake.arg0_val);
+  TEST_ASSERT_EQUAL(0, myTimer_GetCaptureHz(timer));
+}
+
+/**
+ * @brief Timers of other modes have no capture rate.
+ */
+void test_IfTimerIsNotCaptureThenRateIsZero(void)
+{
+  myTimerPars_t pars = { .mode = myTimerMode_FreeRunning, .resource = myTimerRes_Dedicated };
+
+  TEST_ASSERT_EQUAL(myRet_OK, myTimer_Init(&timer, &pars));
+  myTimer_Start(timer, 0, NULL);
+
+  TEST_ASSERT_EQUAL(0, myTimer_GetCaptureHz(timer));
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static void initCapture(myTimerEdge_t edge)
+{
+  myTimerPars_t pars = { .mode = myTimerMode_Capture, .resource = myTimerRes_Dedicated, .channel = myDriverTimerCh_TPM0_CH2_PTD2, .edge = edge, .ring = &ring };
+
+  TEST_ASSERT_EQUAL(myRet_OK, myTimer_Init(&timer, &pars));
+}
+
+static void captureEdge(uint32_t flags, uint32_t value)
+{
+  TPM_GetStatusFlags_fake.return_val = flags;
+  TPM_GetChannelValue_fake.return_val = value;
+  TPM0_IRQHandler();
+}
+
+static void timerCallback(void)
+{
+  callbackCallCount++;
+}
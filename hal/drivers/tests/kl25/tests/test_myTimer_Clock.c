@@ -0,0 +1,275 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file test_myTimer_Clock.c
+ * @brief Test file for testing timer driver logic, conversion of periods to
+ *          TPM counts with the cached clock scale.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+#include "myMacros.h"
+
+#include "myTimer.h"
+#include "myWheel.h"
+#include "myPeriod.h"
+#include "mySplit.h"
+#include "myRing.h"
+#include "myDriverDefs.h"
+
+#include "mock_fsl_tpm.h"
+#include "mock_fsl_pit.h"
+#include "mock_fsl_port.h"
+#include "mock_fsl_clock.h"
+#include "mock_fsl_common.h"
+#include "mock_myTimer_TPM.h"
+#include "mock_myTime_Tick.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_MAX_PRESCALE                                                    (7)
+#define TEST_MAX_COUNTS                                                  (65536)
+#define TEST_PERIODS_PER_CASE                                                (8)
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static void initTimer(myTimerMode_t mode);
+static uint32_t maxPeriodMs(uint32_t clockHz);
+static uint32_t expectedPrescale(uint32_t clockHz, uint32_t periodMs);
+static void checkPeriod(uint32_t clockHz, uint32_t periodMs);
+static void checkProgrammed(uint32_t clockHz, uint32_t periodMs, uint32_t periods);
+static void timerCallback(void);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static myTimer_t timer = NULL;
+
+static const uint32_t testClocks[] =
+{
+  8000000,    /* FRDM-KL25Z crystal.                                          */
+  20971520,   /* FLL output.                                                  */
+  48000000,
+  32768,
+  4000000,
+  12345678,
+};
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  myTimer_Reset();
+  timer = NULL;
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief For every clock and every period that fits the TPM, the prescaler
+ *          should be the smallest one that fits, and the counts set should
+ *          be bit-exact with the ones given by dividing the period times the
+ *          clock by 1000 times the prescaler.
+ */
+void test_CountsAreBitExactWithDivision(void)
+{
+  uint32_t idx, periodMs;
+
+  for(idx = 0; idx < MY_ARRAY_SIZE(testClocks); idx++)
+  {
+    const uint32_t clockHz = testClocks[idx];
+
+    CLOCK_GetOsc0ErClkFreq_fake.return_val = clockHz;
+    setUp();
+    initTimer(myTimerMode_Periodic);
+
+    for(periodMs = 1; periodMs <= maxPeriodMs(clockHz); periodMs++)
+    {
+      checkPeriod(clockHz, periodMs);
+    }
+  }
+}
+
+/**
+ * @brief When the clock changes, the driver should read it again on update
+ *          and use it from then on.
+ */
+void test_IfClockIsUpdatedThenNewClockIsUsed(void)
+{
+  CLOCK_GetOsc0ErClkFreq_fake.return_val = testClocks[0];
+  initTimer(myTimerMode_Periodic);
+
+  CLOCK_GetOsc0ErClkFreq_fake.return_val = testClocks[1];
+  myTimer_ClockUpdate();
+
+  checkPeriod(testClocks[1], 100);
+}
+
+/**
+ * @brief When the clock changes, a running periodic timer should be
+ *          restarted with periods based on the new clock.
+ */
+void test_IfClockIsUpdatedThenRunningTimerIsRescaled(void)
+{
+  uint32_t n;
+
+  CLOCK_GetOsc0ErClkFreq_fake.return_val = testClocks[0];
+  initTimer(myTimerMode_Periodic);
+  myTimer_Start(timer, 100, timerCallback);
+
+  CLOCK_GetOsc0ErClkFreq_fake.return_val = testClocks[1];
+  RESET_FAKE(TPM_SetTimerPeriod);
+  RESET_FAKE(TPM_SetPrescaler);
+  myTimer_ClockUpdate();
+
+  for(n = 0; n < TEST_PERIODS_PER_CASE; n++) { TPM0_IRQHandler(); }
+
+  checkProgrammed(testClocks[1], 100, TEST_PERIODS_PER_CASE + 2);
+}
+
+/**
+ * @brief When the clock changes, a running free-running timer should keep the
+ *          time it had counted, and count at the new clock from then on.
+ */
+void test_IfClockIsUpdatedThenFreeRunningTimerKeepsCounting(void)
+{
+  CLOCK_GetOsc0ErClkFreq_fake.return_val = testClocks[0];
+  initTimer(myTimerMode_FreeRunning);
+  myTimer_Start(timer, 0, NULL);
+
+  /* (3 * 65536 + 12345) counts at 62500 Hz is 3343.2 ms.                     */
+  TPM0_IRQHandler();
+  TPM0_IRQHandler();
+  TPM0_IRQHandler();
+  TPM_GetCurrentTimerCount_fake.return_val = 12345;
+
+  CLOCK_GetOsc0ErClkFreq_fake.return_val = testClocks[4];
+  myTimer_ClockUpdate();
+
+  TPM_GetCurrentTimerCount_fake.return_val = 0;
+  TEST_ASSERT_EQUAL(3343, myTimer_GetElapsed(timer));
+
+  /* Then 65536 counts at 31250 Hz is 2097.2 ms more.                         */
+  TPM0_IRQHandler();
+  TEST_ASSERT_EQUAL(3343 + 2097, myTimer_GetElapsed(timer));
+}
+
+/**
+ * @brief When the clock changes, a running one-shot timer should be restarted
+ *          for the time it had left, counted with the new clock.
+ */
+void test_IfClockIsUpdatedThenOneShotTimerCountsTheTimeLeft(void)
+{
+  CLOCK_GetOsc0ErClkFreq_fake.return_val = testClocks[0];
+  initTimer(myTimerMode_OneShot);
+  myTimer_Start(timer, 1000, timerCallback);
+
+  /* 31250 of the 62500 counts at 62500 Hz is half of the period.             */
+  TPM_GetCurrentTimerCount_fake.return_val = 31250;
+
+  CLOCK_GetOsc0ErClkFreq_fake.return_val = testClocks[4];
+  RESET_FAKE(TPM_SetTimerPeriod);
+  RESET_FAKE(TPM_SetPrescaler);
+  myTimer_ClockUpdate();
+
+  checkProgrammed(testClocks[4], 500, 1);
+}
+
+/**
+ * @brief When the clock changes, a one-shot timer that already expired should
+ *          not be started again.
+ */
+void test_IfClockIsUpdatedThenExpiredOneShotTimerIsNotRestarted(void)
+{
+  CLOCK_GetOsc0ErClkFreq_fake.return_val = testClocks[0];
+  initTimer(myTimerMode_OneShot);
+  myTimer_Start(timer, 1000, timerCallback);
+  TPM0_IRQHandler();
+
+  RESET_FAKE(TPM_SetTimerPeriod);
+  myTimer_ClockUpdate();
+
+  TEST_ASSERT_NOT_CALLED(TPM_SetTimerPeriod);
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static void initTimer(myTimerMode_t mode)
+{
+  myTimerPars_t pars = { .mode = mode, .resource = myTimerRes_Dedicated };
+
+  TEST_ASSERT_EQUAL(myRet_OK, myTimer_Init(&timer, &pars));
+}
+
+static uint32_t maxPeriodMs(uint32_t clockHz)
+{
+  /* Longest period whose counts still fit in the TPM at its top prescaler.   */
+  return (uint32_t)(((uint64_t)(TEST_MAX_COUNTS - 1) * (1000 << TEST_MAX_PRESCALE)) / clockHz);
+}
+
+static uint32_t expectedPrescale(uint32_t clockHz, uint32_t periodMs)
+{
+  const uint64_t num = (uint64_t)periodMs * clockHz;
+  uint32_t prescale = 0;
+
+  while((prescale < TEST_MAX_PRESCALE) && ((num / (1000ULL << prescale)) >= TEST_MAX_COUNTS)) { prescale++; }
+
+  return prescale;
+}
+
+static void checkPeriod(uint32_t clockHz, uint32_t periodMs)
+{
+  RESET_FAKE(TPM_SetTimerPeriod);
+  RESET_FAKE(TPM_SetPrescaler);
+  myTimer_Start(timer, periodMs, timerCallback);
+
+  checkProgrammed(clockHz, periodMs, 2);
+}
+
+static void checkProgrammed(uint32_t clockHz, uint32_t periodMs, uint32_t periods)
+{
+  const uint32_t prescale = expectedPrescale(clockHz, periodMs);
+  myPeriod_t expected;
+  uint32_t n;
+
+  TEST_ASSERT_EQUAL(1, TPM_SetPrescaler_fake.call_count);
+  TEST_ASSERT_EQUAL(prescale, TPM_SetPrescaler_fake.arg1_val);
+  TEST_ASSERT_EQUAL(periods, TPM_SetTimerPeriod_fake.call_count);
+
+  myPeriod_Init(&expected, (uint64_t)periodMs * clockHz, 1000 << prescale);
+  for(n = 0; n < periods; n++)
+  {
+    TEST_ASSERT_EQUAL_UINT32(myPeriod_Next(&expected) - 1, TPM_SetTimerPeriod_fake.arg1_history[n]);
+  }
+}
+
+static void timerCallback(void)
+{
+}
@@ -0,0 +1,252 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file test_myTimer_Idle.c
+ * @brief Test file for testing timer driver logic, operation when the tick of
+ *          the virtual timers is stopped while the system is idle.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+
+#include "myTimer.h"
+#include "myWheel.h"
+#include "myPeriod.h"
+#include "mySplit.h"
+#include "myRing.h"
+#include "myDriverDefs.h"
+
+#include "mock_fsl_tpm.h"
+#include "mock_fsl_pit.h"
+#include "mock_fsl_port.h"
+#include "mock_fsl_clock.h"
+#include "mock_fsl_common.h"
+#include "mock_myTimer_TPM.h"
+#include "mock_myTime_Tick.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_CLOCK_FREQ                                                (8000000)
+#define TEST_PERIOD_MS                                                      (10)
+
+/* TPM counts in a tick, at the smallest prescaler.                           */
+#define TEST_TICK_COUNTS                     (MSEC_TO_COUNT(1, TEST_CLOCK_FREQ))
+
+/* Longest time, in ms, that the tick can be stopped for at the test clock.   */
+#define TEST_MAX_IDLE_MS                   ((0xFFFFULL << 7) / TEST_TICK_COUNTS)
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static void prepareMocks(void);
+static void runTicks(uint32_t ticks);
+static void timerCallback(void);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static myTimer_t timer;
+static myTimerPars_t pars;
+static uint32_t callbackCallCount;
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  prepareMocks();
+  callbackCallCount = 0;
+  myTimer_Reset();
+
+  pars.mode = myTimerMode_Periodic;
+  pars.resource = myTimerRes_Virtual;
+  timer = NULL;
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief Without any virtual timer there is no tick to stop.
+ */
+void test_IfThereAreNoVirtualTimersThenTickIsNotStopped(void)
+{
+  TEST_ASSERT_EQUAL(0, myTimer_IdleEnter());
+  TEST_ASSERT_NOT_CALLED(TPM_StopTimer);
+}
+
+/**
+ * @brief If the next tick has work to do, the tick should keep running.
+ */
+void test_IfNextTickIsNeededThenTickIsNotStopped(void)
+{
+  myTimer_Init(&timer, &pars);
+  myTimer_Start(timer, 1, timerCallback);
+  RESET_FAKE(TPM_StopTimer);
+
+  TEST_ASSERT_EQUAL(0, myTimer_IdleEnter());
+  TEST_ASSERT_NOT_CALLED(TPM_StopTimer);
+}
+
+/**
+ * @brief If there is a tick already pending, the tick should keep running so
+ *          that it is served.
+ */
+void test_IfTickIsPendingThenTickIsNotStopped(void)
+{
+  myTimer_Init(&timer, &pars);
+  myTimer_Start(timer, TEST_PERIOD_MS, timerCallback);
+  RESET_FAKE(TPM_StartTimer);
+  TPM_GetStatusFlags_fake.return_val = kTPM_TimeOverflowFlag;
+
+  TEST_ASSERT_EQUAL(0, myTimer_IdleEnter());
+  TEST_ASSERT_CALLED(TPM_StartTimer);
+}
+
+/**
+ * @brief The tick should be stopped until the next expiration, counting the
+ *          part of the current tick that has already elapsed.
+ */
+void test_IfTickIsStoppedThenWakeupIsAtNextExpiration(void)
+{
+  myTimer_Init(&timer, &pars);
+  myTimer_Start(timer, TEST_PERIOD_MS, timerCallback);
+  TPM_GetCurrentTimerCount_fake.return_val = TEST_TICK_COUNTS / 4;
+
+  TEST_ASSERT_EQUAL((TEST_PERIOD_MS * 1000) - 250, myTimer_IdleEnter());
+
+  /* That is 9.75 ms, which needs a prescaler of 2 to fit the TPM.            */
+  TEST_ASSERT_EQUAL(kTPM_Prescale_Divide_2, TPM_SetPrescaler_fake.arg1_val);
+  TEST_ASSERT_EQUAL((TEST_TICK_COUNTS * 39 / 8) - 1, TPM_SetTimerPeriod_fake.arg1_val);
+}
+
+/**
+ * @brief Long waits should be limited to what the TPM can count at once.
+ */
+void test_IfNextExpirationIsTooFarThenWakeupIsLimited(void)
+{
+  myTimer_Init(&timer, &pars);
+  myTimer_Start(timer, 10 * TEST_MAX_IDLE_MS, timerCallback);
+
+  TEST_ASSERT_EQUAL(TEST_MAX_IDLE_MS * 1000, myTimer_IdleEnter());
+  TEST_ASSERT_EQUAL(kTPM_Prescale_Divide_128, TPM_SetPrescaler_fake.arg1_val);
+}
+
+/**
+ * @brief The tick should not be stopped again while it is still realigning
+ *          from the last time.
+ */
+void test_IfTickIsRealigningThenTickIsNotStoppedAgain(void)
+{
+  myTimer_Init(&timer, &pars);
+  myTimer_Start(timer, TEST_PERIOD_MS, timerCallback);
+  myTimer_IdleEnter();
+  myTimer_IdleExit();
+
+  TEST_ASSERT_EQUAL(0, myTimer_IdleEnter());
+}
+
+/**
+ * @brief Waking up at the programmed time should expire the timer, and the
+ *          regular tick should then keep its period.
+ */
+void test_IfWokenUpAtWakeupThenTimerExpires(void)
+{
+  myTimer_Init(&timer, &pars);
+  myTimer_Start(timer, TEST_PERIOD_MS, timerCallback);
+  myTimer_IdleEnter();
+
+  TPM_GetStatusFlags_fake.return_val = kTPM_TimeOverflowFlag;
+  myTimer_IdleExit();
+  TPM_GetStatusFlags_fake.return_val = 0;
+  TEST_ASSERT_EQUAL(1, callbackCallCount);
+
+  /* The first interrupt after waking up is the one at the tick boundary.     */
+  runTicks(TEST_PERIOD_MS - 1);
+  TEST_ASSERT_EQUAL(1, callbackCallCount);
+
+  runTicks(1);
+  TEST_ASSERT_EQUAL(2, callbackCallCount);
+}
+
+/**
+ * @brief Waking up earlier should account the ticks that went by, and set the
+ *          TPM to the next tick boundary.
+ */
+void test_IfWokenUpEarlierThenTimerExpiresOnTime(void)
+{
+  myTimer_Init(&timer, &pars);
+  myTimer_Start(timer, TEST_PERIOD_MS, timerCallback);
+  myTimer_IdleEnter();
+
+  /* The sleep is counted at a prescaler of 2, so this is 3.5 ms.             */
+  TPM_GetCurrentTimerCount_fake.return_val = (TEST_TICK_COUNTS * 7) / 4;
+  myTimer_IdleExit();
+  TEST_ASSERT_EQUAL(0, callbackCallCount);
+  TEST_ASSERT_EQUAL(kTPM_Prescale_Divide_1, TPM_SetPrescaler_fake.arg1_val);
+  TEST_ASSERT_EQUAL((TEST_TICK_COUNTS / 2) - 1, TPM_SetTimerPeriod_fake.arg1_val);
+
+  runTicks(TEST_PERIOD_MS - 4);
+  TEST_ASSERT_EQUAL(0, callbackCallCount);
+
+  runTicks(1);
+  TEST_ASSERT_EQUAL(1, callbackCallCount);
+}
+
+/**
+ * @brief Once realigned, the regular tick should be running again.
+ */
+void test_IfTickIsRealignedThenRegularTickRestarts(void)
+{
+  myTimer_Init(&timer, &pars);
+  myTimer_Start(timer, TEST_PERIOD_MS, timerCallback);
+  myTimer_IdleEnter();
+  myTimer_IdleExit();
+  runTicks(1);
+
+  TEST_ASSERT_EQUAL(kTPM_Prescale_Divide_1, TPM_SetPrescaler_fake.arg1_val);
+  TEST_ASSERT_EQUAL(TEST_TICK_COUNTS - 1, TPM_SetTimerPeriod_fake.arg1_val);
+  TEST_ASSERT_NOT_EQUAL(0, myTimer_IdleEnter());
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static void prepareMocks(void)
+{
+  CLOCK_GetOsc0ErClkFreq_fake.return_val = TEST_CLOCK_FREQ;
+}
+
+static void runTicks(uint32_t ticks)
+{
+  /* The first TPM is the one taken by the wheel.                             */
+  while(ticks-- > 0) { TPM0_IRQHandler(); }
+}
+
+static void timerCallback(void)
+{
+  callbackCallCount++;
+}
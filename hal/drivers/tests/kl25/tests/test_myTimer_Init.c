@@ -27,12 +27,19 @@
 #include "myTestDefs.h"
 
 #include "myTimer.h"
+#include "myWheel.h"
+#include "myPeriod.h"
+#include "mySplit.h"
+#include "myRing.h"
 #include "myDriverDefs.h"
 
 #include "mock_fsl_tpm.h"
+#include "mock_fsl_pit.h"
+#include "mock_fsl_port.h"
 #include "mock_fsl_clock.h"
 #include "mock_fsl_common.h"
 #include "mock_myTimer_TPM.h"
+#include "mock_myTime_Tick.h"
 
 /*******************************************************************************
  *  PRIVATE DEFINITIONS
@@ -88,13 +95,13 @@ void test_IfParsArgIsInvalidThenItFails(void)
 
 /**
  * @brief myTimer_Init logic should return fail if mode selection is not
- *          periodic.
+ *          valid.
  */
-void test_IfModeIsNotPeriodicThenItFails(void)
+void test_IfModeIsInvalidThenItFails(void)
 {
   myRet_t result;
 
-  pars.mode = (myTimerMode_Periodic + 1);
+  pars.mode = (myTimerMode_Capture + 1);
   result = myTimer_Init(&timer, &pars);
 
   TEST_ASSERT_EQUAL(myRet_Fail, result);
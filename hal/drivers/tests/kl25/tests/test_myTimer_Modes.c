@@ -0,0 +1,280 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file test_myTimer_Modes.c
+ * @brief Test file for testing timer driver logic, operation of each of the
+ *          timer modes.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+#include "myMacros.h"
+
+#include "myTimer.h"
+#include "myWheel.h"
+#include "myPeriod.h"
+#include "mySplit.h"
+#include "myRing.h"
+#include "myDriverDefs.h"
+
+#include "mock_fsl_tpm.h"
+#include "mock_fsl_pit.h"
+#include "mock_fsl_port.h"
+#include "mock_fsl_clock.h"
+#include "mock_fsl_common.h"
+#include "mock_myTimer_TPM.h"
+#include "mock_myTime_Tick.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_CLOCK_FREQ                                                (8000000)
+#define TEST_FLL_FREQ                                                 (20971520)
+#define TEST_LONG_RUN_PERIODS                                          (2000000)
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static void prepareMocks(void);
+static void initTimer(myTimerMode_t mode, myTimerRes_t resource);
+static void tpmSetTimerPeriodFake(TPM_Type * base, uint32_t ticks);
+static void timerCallback(void);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static myTimer_t timer = NULL;
+static uint64_t programmedCounts;
+static uint32_t callbackCallCount;
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  prepareMocks();
+  myTimer_Reset();
+  timer = NULL;
+  programmedCounts = 0;
+  callbackCallCount = 0;
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief A period that is not a whole amount of counts should be programmed
+ *          by alternating between the closest amounts, and the TPM's MOD
+ *          should be one less than the counts.
+ */
+void test_IfPeriodIsNotWholeThenMODAlternates(void)
+{
+  /* 1 ms is 20971.52 counts: 20971 for the first period, 20972 for the next. */
+  CLOCK_GetOsc0ErClkFreq_fake.return_val = TEST_FLL_FREQ;
+  initTimer(myTimerMode_Periodic, myTimerRes_Dedicated);
+  myTimer_Start(timer, 1, timerCallback);
+
+  TEST_ASSERT_EQUAL(kTPM_Prescale_Divide_1, TPM_SetPrescaler_fake.arg1_val);
+  TEST_ASSERT_EQUAL(2, TPM_SetTimerPeriod_fake.call_count);
+  TEST_ASSERT_EQUAL(20970, TPM_SetTimerPeriod_fake.arg1_history[0]);
+  TEST_ASSERT_EQUAL(20971, TPM_SetTimerPeriod_fake.arg1_history[1]);
+}
+
+/**
+ * @brief Over millions of periods, a periodic timer should have programmed
+ *          exactly the ideal amount of counts, so no drift is accumulated.
+ */
+void test_PeriodicTimerHasNoCumulativeDrift(void)
+{
+  const uint32_t periodsMs[] = { 1, 7, 1000, 1048 };
+  uint32_t idx, n;
+
+  for(idx = 0; idx < MY_ARRAY_SIZE(periodsMs); idx++)
+  {
+    const uint64_t num = (uint64_t) periodsMs[idx] * TEST_CLOCK_FREQ;
+    uint64_t den;
+
+    setUp();
+    initTimer(myTimerMode_Periodic, myTimerRes_Dedicated);
+    myTimer_Start(timer, periodsMs[idx], timerCallback);
+    den = 1000ULL << TPM_SetPrescaler_fake.arg1_val;
+
+    for(n = 0; n < TEST_LONG_RUN_PERIODS; n++) { TPM0_IRQHandler(); }
+
+    /* Each interrupt queues one more period, on top of the two at start.     */
+    TEST_ASSERT_EQUAL(TEST_LONG_RUN_PERIODS, callbackCallCount);
+    TEST_ASSERT_TRUE(programmedCounts == (((TEST_LONG_RUN_PERIODS + 2) * num) / den));
+  }
+}
+
+/**
+ * @brief A dedicated one-shot timer should have its TPM set to stop at the
+ *          overflow, and no next period should be queued.
+ */
+void test_IfTimerIsOneShotThenTPMStopsOnOverflow(void)
+{
+  initTimer(myTimerMode_OneShot, myTimerRes_Dedicated);
+  myTimer_Start(timer, 10, timerCallback);
+
+  TEST_ASSERT_CALLED(TPM_SetStopOnOverflow);
+  TEST_ASSERT_TRUE(TPM_SetStopOnOverflow_fake.arg1_val);
+  TEST_ASSERT_CALLED(TPM_SetTimerPeriod);
+
+  TPM0_IRQHandler();
+
+  TEST_ASSERT_EQUAL(1, callbackCallCount);
+  TEST_ASSERT_CALLED(TPM_SetTimerPeriod);
+}
+
+/**
+ * @brief A periodic timer should not have its TPM set to stop at overflow.
+ */
+void test_IfTimerIsPeriodicThenTPMDoesNotStopOnOverflow(void)
+{
+  initTimer(myTimerMode_Periodic, myTimerRes_Dedicated);
+  myTimer_Start(timer, 10, timerCallback);
+
+  TEST_ASSERT_CALLED(TPM_SetStopOnOverflow);
+  TEST_ASSERT_FALSE(TPM_SetStopOnOverflow_fake.arg1_val);
+}
+
+/**
+ * @brief A free-running timer can be started without period nor callback,
+ *          and its TPM should count its whole range.
+ */
+void test_IfTimerIsFreeRunningThenItCountsWholeRange(void)
+{
+  initTimer(myTimerMode_FreeRunning, myTimerRes_Dedicated);
+
+  TEST_ASSERT_EQUAL(myRet_OK, myTimer_Start(timer, 0, NULL));
+  TEST_ASSERT_CALLED(TPM_SetTimerPeriod);
+  TEST_ASSERT_EQUAL(0xFFFF, TPM_SetTimerPeriod_fake.arg1_val);
+}
+
+/**
+ * @brief A free-running timer should report the time elapsed from its
+ *          overflows and its current counter value.
+ */
+void test_IfTimerIsFreeRunningThenElapsedTimeIsCounted(void)
+{
+  initTimer(myTimerMode_FreeRunning, myTimerRes_Dedicated);
+  myTimer_Start(timer, 0, NULL);
+
+  TPM0_IRQHandler();
+  TPM0_IRQHandler();
+  TPM0_IRQHandler();
+  TPM_GetCurrentTimerCount_fake.return_val = 12345;
+
+  /* (3 * 65536 + 12345) counts at 62500 Hz is 3343.2 ms.                     */
+  TEST_ASSERT_EQUAL(3343, myTimer_GetElapsed(timer));
+  TEST_ASSERT_EQUAL(0, callbackCallCount);
+}
+
+/**
+ * @brief If the TPM overflowed but its interrupt is still pending, then the
+ *          overflow should be accounted when reading the elapsed time.
+ */
+void test_IfOverflowIsPendingThenElapsedTimeAccountsForIt(void)
+{
+  initTimer(myTimerMode_FreeRunning, myTimerRes_Dedicated);
+  myTimer_Start(timer, 0, NULL);
+
+  TPM_GetStatusFlags_fake.return_val = kTPM_TimeOverflowFlag;
+  TPM_GetCurrentTimerCount_fake.return_val = 0;
+
+  /* 65536 counts at 62500 Hz is 1048.5 ms.                                   */
+  TEST_ASSERT_EQUAL(1048, myTimer_GetElapsed(timer));
+}
+
+/**
+ * @brief Reading the elapsed time of a timer that is not free-running should
+ *          give zero.
+ */
+void test_IfTimerIsNotFreeRunningThenElapsedTimeIsZero(void)
+{
+  initTimer(myTimerMode_Periodic, myTimerRes_Dedicated);
+  myTimer_Start(timer, 10, timerCallback);
+
+  TEST_ASSERT_EQUAL(0, myTimer_GetElapsed(timer));
+}
+
+/**
+ * @brief A virtual one-shot timer should expire only once.
+ */
+void test_IfVirtualTimerIsOneShotThenItExpiresOnce(void)
+{
+  uint32_t tick;
+
+  initTimer(myTimerMode_OneShot, myTimerRes_Virtual);
+  myTimer_Start(timer, 10, timerCallback);
+
+  for(tick = 0; tick < 100; tick++) { TPM0_IRQHandler(); }
+
+  TEST_ASSERT_EQUAL(1, callbackCallCount);
+}
+
+/**
+ * @brief A virtual free-running timer should count the wheel's ticks since it
+ *          was started.
+ */
+void test_IfVirtualTimerIsFreeRunningThenElapsedTimeIsCounted(void)
+{
+  uint32_t tick;
+
+  initTimer(myTimerMode_FreeRunning, myTimerRes_Virtual);
+  for(tick = 0; tick < 10; tick++) { TPM0_IRQHandler(); }
+
+  TEST_ASSERT_EQUAL(myRet_OK, myTimer_Start(timer, 0, NULL));
+  for(tick = 0; tick < 25; tick++) { TPM0_IRQHandler(); }
+
+  TEST_ASSERT_EQUAL(25, myTimer_GetElapsed(timer));
+  TEST_ASSERT_EQUAL(0, callbackCallCount);
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static void prepareMocks(void)
+{
+  CLOCK_GetOsc0ErClkFreq_fake.return_val = TEST_CLOCK_FREQ;
+  TPM_SetTimerPeriod_fake.custom_fake = tpmSetTimerPeriodFake;
+}
+
+static void initTimer(myTimerMode_t mode, myTimerRes_t resource)
+{
+  myTimerPars_t pars = { .mode = mode, .resource = resource };
+
+  TEST_ASSERT_EQUAL(myRet_OK, myTimer_Init(&timer, &pars));
+}
+
+static void tpmSetTimerPeriodFake(TPM_Type * base, uint32_t ticks)
+{
+  programmedCounts += ticks + 1;
+}
+
+static void timerCallback(void)
+{
+  callbackCallCount++;
+}
@@ -0,0 +1,340 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file test_myTimer_Pit.c
+ * @brief Test file for testing timer driver logic, operation of timers that
+ *          are backed by the PIT channels.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+
+#include "myTimer.h"
+#include "myWheel.h"
+#include "myPeriod.h"
+#include "mySplit.h"
+#include "myRing.h"
+#include "myDriverDefs.h"
+
+#include "mock_fsl_tpm.h"
+#include "mock_fsl_pit.h"
+#include "mock_fsl_port.h"
+#include "mock_fsl_clock.h"
+#include "mock_fsl_common.h"
+#include "mock_myTimer_TPM.h"
+#include "mock_myTime_Tick.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_BUS_CLOCK_HZ                                             (24000000)
+#define TEST_FLL_BUS_CLOCK_HZ                                         (20971520)
+#define TEST_PERIOD_MS                                                       (1)
+#define TEST_PERIOD_COUNTS                                               (24000)
+#define TEST_MAX_PERIOD_MS                                              (178956)
+#define TEST_PIT_CHANNELS                                                    (2)
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static myRet_t initTimer(myTimer_t * timer, myTimerMode_t mode);
+static void expireChannel(pit_chnl_t channel);
+static void setTimerPeriodFake(PIT_Type * base, pit_chnl_t channel, uint32_t count);
+static uint32_t getStatusFlagsFake(PIT_Type * base, pit_chnl_t channel);
+static void timerCallback(void);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static myTimer_t timer = NULL;
+static uint32_t callbackCallCount;
+static uint64_t programmedCounts;
+static uint32_t programmedPeriods;
+static uint32_t statusFlags[TEST_PIT_CHANNELS];
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  CLOCK_GetBusClkFreq_fake.return_val = TEST_BUS_CLOCK_HZ;
+  PIT_SetTimerPeriod_fake.custom_fake = setTimerPeriodFake;
+  PIT_GetStatusFlags_fake.custom_fake = getStatusFlagsFake;
+  myTimer_Reset();
+  timer = NULL;
+  callbackCallCount = 0;
+  programmedCounts = 0;
+  programmedPeriods = 0;
+  statusFlags[kPIT_Chnl_0] = 0;
+  statusFlags[kPIT_Chnl_1] = 0;
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief A PIT timer should set up the PIT, once for all its channels, and
+ *          should leave the TPMs alone.
+ */
+void test_PitIsInitializedOnceAndTPMsAreNotTaken(void)
+{
+  myTimer_t other;
+
+  TEST_ASSERT_EQUAL(myRet_OK, initTimer(&timer, myTimerMode_Periodic));
+  TEST_ASSERT_EQUAL(myRet_OK, initTimer(&other, myTimerMode_Periodic));
+
+  TEST_ASSERT_EQUAL(1, PIT_Init_fake.call_count);
+  TEST_ASSERT_NOT_CALLED(TPM_Init);
+}
+
+/**
+ * @brief Periodic and one-shot timers should take one channel each, and
+ *          enable its interrupt, until there are no channels left.
+ */
+void test_EachTimerTakesOneChannelUntilNoneIsLeft(void)
+{
+  myTimer_t other;
+
+  TEST_ASSERT_EQUAL(myRet_OK, initTimer(&timer, myTimerMode_Periodic));
+  TEST_ASSERT_EQUAL(kPIT_Chnl_0, PIT_EnableInterrupts_fake.arg1_val);
+  TEST_ASSERT_EQUAL(myRet_OK, initTimer(&other, myTimerMode_OneShot));
+  TEST_ASSERT_EQUAL(kPIT_Chnl_1, PIT_EnableInterrupts_fake.arg1_val);
+  TEST_ASSERT_EQUAL(PIT_IRQn, EnableIRQ_fake.arg0_val);
+
+  TEST_ASSERT_EQUAL(myRet_Fail, initTimer(&other, myTimerMode_Periodic));
+}
+
+/**
+ * @brief A free-running timer chains both channels, so it should only be
+ *          initialized while the whole PIT is free, and then take it all.
+ */
+void test_FreeRunningTimerTakesTheWholePit(void)
+{
+  myTimer_t other;
+
+  TEST_ASSERT_EQUAL(myRet_OK, initTimer(&timer, myTimerMode_Periodic));
+  TEST_ASSERT_EQUAL(myRet_Fail, initTimer(&other, myTimerMode_FreeRunning));
+
+  myTimer_Reset();
+  RESET_FAKE(PIT_EnableInterrupts);
+  TEST_ASSERT_EQUAL(myRet_OK, initTimer(&timer, myTimerMode_FreeRunning));
+  TEST_ASSERT_CALLED(PIT_SetTimerChainMode);
+  TEST_ASSERT_EQUAL(kPIT_Chnl_1, PIT_SetTimerChainMode_fake.arg1_val);
+  TEST_ASSERT_TRUE(PIT_SetTimerChainMode_fake.arg2_val);
+  TEST_ASSERT_NOT_CALLED(PIT_EnableInterrupts);
+  TEST_ASSERT_EQUAL(myRet_Fail, initTimer(&other, myTimerMode_Periodic));
+}
+
+/**
+ * @brief A started timer should load the counts of its first period, and
+ *          queue the ones of the second period as soon as it runs.
+ */
+void test_StartLoadsFirstPeriodAndQueuesTheNextOne(void)
+{
+  initTimer(&timer, myTimerMode_Periodic);
+  myTimer_Start(timer, TEST_PERIOD_MS, timerCallback);
+
+  TEST_ASSERT_CALLED(PIT_StartTimer);
+  TEST_ASSERT_EQUAL(2, PIT_SetTimerPeriod_fake.call_count);
+  TEST_ASSERT_EQUAL(TEST_PERIOD_COUNTS - 1, PIT_SetTimerPeriod_fake.arg2_history[0]);
+  TEST_ASSERT_EQUAL(TEST_PERIOD_COUNTS - 1, PIT_SetTimerPeriod_fake.arg2_history[1]);
+}
+
+/**
+ * @brief A period should only be started if its counts fit the 32 bits of a
+ *          channel, as the PIT has no prescaler.
+ */
+void test_IfPeriodDoesNotFitAChannelThenStartFails(void)
+{
+  initTimer(&timer, myTimerMode_Periodic);
+
+  TEST_ASSERT_EQUAL(myRet_Fail, myTimer_Start(timer, TEST_MAX_PERIOD_MS + 1, timerCallback));
+  TEST_ASSERT_NOT_CALLED(PIT_StartTimer);
+  TEST_ASSERT_EQUAL(myRet_OK, myTimer_Start(timer, TEST_MAX_PERIOD_MS, timerCallback));
+}
+
+/**
+ * @brief A period that is not a whole amount of counts should have its
+ *          fraction spread over the periods, so that they never drift.
+ */
+void test_PeriodsAreCountedWithoutDrift(void)
+{
+  uint32_t periods;
+
+  /* At 20.97152 MHz, 1000 periods of 1 ms are exactly 20971520 counts.      */
+  CLOCK_GetBusClkFreq_fake.return_val = TEST_FLL_BUS_CLOCK_HZ;
+  initTimer(&timer, myTimerMode_Periodic);
+  myTimer_Start(timer, TEST_PERIOD_MS, timerCallback);
+
+  for(periods = 1; periods < 1000; periods++) { expireChannel(kPIT_Chnl_0); }
+
+  TEST_ASSERT_EQUAL(999, callbackCallCount);
+  TEST_ASSERT_EQUAL(1001, programmedPeriods);
+  TEST_ASSERT_EQUAL_UINT64(TEST_FLL_BUS_CLOCK_HZ, programmedCounts);
+}
+
+/**
+ * @brief When a channel expires, the period after the one it just reloaded
+ *          should be queued, and the callback called.
+ */
+void test_ExpiredChannelQueuesNextPeriodAndCallsBack(void)
+{
+  initTimer(&timer, myTimerMode_Periodic);
+  myTimer_Start(timer, TEST_PERIOD_MS, timerCallback);
+  RESET_FAKE(PIT_SetTimerPeriod);
+  RESET_FAKE(PIT_ClearStatusFlags);
+  RESET_FAKE(PIT_StopTimer);
+
+  expireChannel(kPIT_Chnl_0);
+
+  TEST_ASSERT_EQUAL(1, callbackCallCount);
+  TEST_ASSERT_CALLED(PIT_ClearStatusFlags);
+  TEST_ASSERT_EQUAL(kPIT_Chnl_0, PIT_ClearStatusFlags_fake.arg1_val);
+  TEST_ASSERT_EQUAL(TEST_PERIOD_COUNTS - 1, PIT_SetTimerPeriod_fake.arg2_val);
+  TEST_ASSERT_NOT_CALLED(PIT_StopTimer);
+}
+
+/**
+ * @brief A one-shot timer should be stopped by the interrupt, so that it
+ *          does not count a second period.
+ */
+void test_OneShotTimerIsStoppedWhenItExpires(void)
+{
+  initTimer(&timer, myTimerMode_OneShot);
+  myTimer_Start(timer, TEST_PERIOD_MS, timerCallback);
+
+  TEST_ASSERT_EQUAL(1, PIT_SetTimerPeriod_fake.call_count);
+  RESET_FAKE(PIT_StopTimer);
+
+  expireChannel(kPIT_Chnl_0);
+
+  TEST_ASSERT_EQUAL(1, callbackCallCount);
+  TEST_ASSERT_CALLED(PIT_StopTimer);
+  TEST_ASSERT_EQUAL(kPIT_Chnl_0, PIT_StopTimer_fake.arg1_val);
+}
+
+/**
+ * @brief Both channels share the interrupt, so only the one that expired
+ *          should be served.
+ */
+void test_OnlyTheChannelThatExpiredIsServed(void)
+{
+  myTimer_t other;
+
+  initTimer(&timer, myTimerMode_Periodic);
+  initTimer(&other, myTimerMode_Periodic);
+  myTimer_Start(other, TEST_PERIOD_MS, timerCallback);
+  RESET_FAKE(PIT_ClearStatusFlags);
+
+  expireChannel(kPIT_Chnl_1);
+
+  TEST_ASSERT_EQUAL(1, callbackCallCount);
+  TEST_ASSERT_CALLED(PIT_ClearStatusFlags);
+  TEST_ASSERT_EQUAL(kPIT_Chnl_1, PIT_ClearStatusFlags_fake.arg1_val);
+}
+
+/**
+ * @brief A free-running timer should read the time from the 64-bit count of
+ *          the chained channels, which count down from all ones.
+ */
+void test_FreeRunningTimerReadsTheChainedCount(void)
+{
+  initTimer(&timer, myTimerMode_FreeRunning);
+  myTimer_Start(timer, 0, NULL);
+
+  TEST_ASSERT_EQUAL(UINT32_MAX, PIT_SetTimerPeriod_fake.arg2_history[0]);
+  TEST_ASSERT_EQUAL(UINT32_MAX, PIT_SetTimerPeriod_fake.arg2_history[1]);
+
+  PIT_GetLifetimeTimerCount_fake.return_val = UINT64_MAX - (1500ULL * TEST_PERIOD_COUNTS);
+  TEST_ASSERT_EQUAL(1500, myTimer_GetElapsed(timer));
+
+  /* Way beyond a wrap of a single channel.                                   */
+  PIT_GetLifetimeTimerCount_fake.return_val = UINT64_MAX - (1000000ULL * TEST_PERIOD_COUNTS);
+  TEST_ASSERT_EQUAL(1000000, myTimer_GetElapsed(timer));
+}
+
+/**
+ * @brief Stopping a free-running timer should stop both its channels.
+ */
+void test_StopOfFreeRunningTimerStopsBothChannels(void)
+{
+  initTimer(&timer, myTimerMode_FreeRunning);
+  myTimer_Start(timer, 0, NULL);
+  RESET_FAKE(PIT_StopTimer);
+
+  TEST_ASSERT_EQUAL(myRet_OK, myTimer_Stop(timer));
+  TEST_ASSERT_EQUAL(2, PIT_StopTimer_fake.call_count);
+}
+
+/**
+ * @brief A running periodic timer should be restarted with the counts of
+ *          the new bus clock when the clock changes.
+ */
+void test_ClockUpdateRestartsRunningPeriodicTimer(void)
+{
+  initTimer(&timer, myTimerMode_Periodic);
+  myTimer_Start(timer, TEST_PERIOD_MS, timerCallback);
+
+  CLOCK_GetBusClkFreq_fake.return_val = TEST_BUS_CLOCK_HZ / 2;
+  myTimer_ClockUpdate();
+
+  TEST_ASSERT_EQUAL((TEST_PERIOD_COUNTS / 2) - 1, PIT_SetTimerPeriod_fake.arg2_val);
+  TEST_ASSERT_EQUAL(2, PIT_StartTimer_fake.call_count);
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static myRet_t initTimer(myTimer_t * timer, myTimerMode_t mode)
+{
+  myTimerPars_t pars = { .mode = mode, .resource = myTimerRes_Pit };
+
+  return myTimer_Init(timer, &pars);
+}
+
+static void expireChannel(pit_chnl_t channel)
+{
+  statusFlags[channel] = kPIT_TimerFlag;
+  PIT_IRQHandler();
+  statusFlags[channel] = 0;
+}
+
+static void setTimerPeriodFake(PIT_Type * base, pit_chnl_t channel, uint32_t count)
+{
+  /* Only the first 1000 periods are summed, the one queued after them is     */
+  /*  not counted yet.                                                        */
+  if(programmedPeriods < 1000) { programmedCounts += (uint64_t)count + 1; }
+  programmedPeriods++;
+}
+
+static uint32_t getStatusFlagsFake(PIT_Type * base, pit_chnl_t channel)
+{
+  return statusFlags[channel];
+}
+
+static void timerCallback(void)
+{
+  callbackCallCount++;
+}
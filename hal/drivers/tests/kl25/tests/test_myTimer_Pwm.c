@@ -0,0 +1,289 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file test_myTimer_Pwm.c
+ * @brief Test file for testing timer driver logic, operation of PWM timers.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+
+#include "myTimer.h"
+#include "myWheel.h"
+#include "myPeriod.h"
+#include "mySplit.h"
+#include "myRing.h"
+#include "myDriverDefs.h"
+
+#include "mock_fsl_tpm.h"
+#include "mock_fsl_pit.h"
+#include "mock_fsl_port.h"
+#include "mock_fsl_clock.h"
+#include "mock_fsl_common.h"
+#include "mock_myTimer_TPM.h"
+#include "mock_myTime_Tick.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_CLOCK_FREQ                                                (8000000)
+#define TEST_PERIOD_MS                                                       (1)
+#define TEST_PERIOD_COUNTS                                                (8000)
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static void initPwm(uint8_t channel);
+static void portSetPinConfigFake(PORT_Type * base, uint32_t pin, const port_pin_config_t * config);
+static void timerCallback(void);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static myTimer_t timer = NULL;
+static port_mux_t configuredMux;
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  CLOCK_GetOsc0ErClkFreq_fake.return_val = TEST_CLOCK_FREQ;
+  PORT_SetPinConfig_fake.custom_fake = portSetPinConfigFake;
+  myTimer_Reset();
+  timer = NULL;
+  configuredMux = kPORT_PinDisabledOrAnalog;
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief PWM timers are driven by the TPM itself, so a virtual one should
+ *          not be initialized.
+ */
+void test_IfPwmTimerIsVirtualThenInitFails(void)
+{
+  myTimerPars_t pars = { .mode = myTimerMode_Pwm, .resource = myTimerRes_Virtual };
+
+  TEST_ASSERT_EQUAL(myRet_Fail, myTimer_Init(&timer, &pars));
+}
+
+/**
+ * @brief A channel that the device doesn't have should make init fail.
+ */
+void test_IfOutputIsInvalidThenInitFails(void)
+{
+  myTimerPars_t pars = { .mode = myTimerMode_Pwm, .resource = myTimerRes_Dedicated, .channel = 0xFF };
+
+  TEST_ASSERT_EQUAL(myRet_Fail, myTimer_Init(&timer, &pars));
+}
+
+/**
+ * @brief The TPM channel of the output should be set as PWM, and its pin
+ *          routed to it.
+ */
+void test_IfOutputIsValidThenChannelAndPinAreSet(void)
+{
+  initPwm(myDriverTimerCh_TPM2_CH0_PTB18);
+
+  TEST_ASSERT_EQUAL_PTR(TPM2, TPM_Init_fake.arg0_val);
+  TEST_ASSERT_CALLED(TPM_SetChannelPwm);
+  TEST_ASSERT_EQUAL_PTR(TPM2, TPM_SetChannelPwm_fake.arg0_val);
+  TEST_ASSERT_EQUAL(kTPM_Chnl_0, TPM_SetChannelPwm_fake.arg1_val);
+  TEST_ASSERT_EQUAL(kCLOCK_PortB, CLOCK_EnableClock_fake.arg0_val);
+  TEST_ASSERT_EQUAL_PTR(PORTB, PORT_SetPinConfig_fake.arg0_val);
+  TEST_ASSERT_EQUAL(18, PORT_SetPinConfig_fake.arg1_val);
+  TEST_ASSERT_EQUAL(kPORT_MuxAlt3, configuredMux);
+}
+
+/**
+ * @brief PWM timers never call back, so their TPM interrupt should not be
+ *          enabled.
+ */
+void test_PwmTimerDoesNotEnableInterrupts(void)
+{
+  initPwm(myDriverTimerCh_TPM0_CH1_PTD1);
+  myTimer_Start(timer, TEST_PERIOD_MS, NULL);
+
+  TEST_ASSERT_NOT_CALLED(TPM_EnableInterrupts);
+  TEST_ASSERT_NOT_CALLED(EnableIRQ);
+}
+
+/**
+ * @brief A PWM timer takes its TPM as a whole, so another channel of the same
+ *          TPM should not be initialized.
+ */
+void test_IfOutputTPMIsTakenThenInitFails(void)
+{
+  myTimerPars_t pars = { .mode = myTimerMode_Pwm, .resource = myTimerRes_Dedicated, .channel = myDriverTimerCh_TPM2_CH1_PTB19 };
+
+  initPwm(myDriverTimerCh_TPM2_CH0_PTB18);
+
+  TEST_ASSERT_EQUAL(myRet_Fail, myTimer_Init(&timer, &pars));
+}
+
+/**
+ * @brief Dedicated timers should skip the TPMs that PWM timers took.
+ */
+void test_IfPwmTimerTookTPMThenDedicatedTimerSkipsIt(void)
+{
+  myTimerPars_t pars = { .mode = myTimerMode_Periodic, .resource = myTimerRes_Dedicated };
+
+  initPwm(myDriverTimerCh_TPM0_CH1_PTD1);
+
+  TEST_ASSERT_EQUAL(myRet_OK, myTimer_Init(&timer, &pars));
+  TEST_ASSERT_EQUAL_PTR(TPM1, TPM_Init_fake.arg0_val);
+  TEST_ASSERT_EQUAL(myRet_OK, myTimer_Init(&timer, &pars));
+  TEST_ASSERT_EQUAL_PTR(TPM2, TPM_Init_fake.arg0_val);
+  TEST_ASSERT_EQUAL(myRet_Fail, myTimer_Init(&timer, &pars));
+}
+
+/**
+ * @brief A PWM timer should be started without callback, and its TPM should
+ *          count the whole period in a single overflow.
+ */
+void test_IfPwmTimerIsStartedThenPeriodIsProgrammed(void)
+{
+  initPwm(myDriverTimerCh_TPM2_CH0_PTB18);
+
+  TEST_ASSERT_EQUAL(myRet_OK, myTimer_Start(timer, TEST_PERIOD_MS, NULL));
+  TEST_ASSERT_EQUAL(kTPM_Prescale_Divide_1, TPM_SetPrescaler_fake.arg1_val);
+  TEST_ASSERT_EQUAL(1, TPM_SetTimerPeriod_fake.call_count);
+  TEST_ASSERT_EQUAL(TEST_PERIOD_COUNTS - 1, TPM_SetTimerPeriod_fake.arg1_val);
+  TEST_ASSERT_CALLED(TPM_StartTimer);
+}
+
+/**
+ * @brief A PWM timer with no period should not be started.
+ */
+void test_IfPwmPeriodIsZeroThenStartFails(void)
+{
+  initPwm(myDriverTimerCh_TPM2_CH0_PTB18);
+
+  TEST_ASSERT_EQUAL(myRet_Fail, myTimer_Start(timer, 0, NULL));
+  TEST_ASSERT_NOT_CALLED(TPM_StartTimer);
+}
+
+/**
+ * @brief A PWM period that doesn't fit a single overflow, which is about
+ *          1048 ms at 8 MHz, should not be started.
+ */
+void test_IfPwmPeriodDoesNotFitOverflowThenStartFails(void)
+{
+  initPwm(myDriverTimerCh_TPM2_CH0_PTB18);
+
+  TEST_ASSERT_EQUAL(myRet_OK, myTimer_Start(timer, 1048, NULL));
+  TEST_ASSERT_EQUAL(myRet_Fail, myTimer_Start(timer, 1049, NULL));
+}
+
+/**
+ * @brief The duty cycle should be scaled to the counts of the period, and
+ *          the full one should go above MOD, so that the output never goes
+ *          inactive.
+ */
+void test_DutyIsScaledToPeriodCounts(void)
+{
+  initPwm(myDriverTimerCh_TPM2_CH0_PTB18);
+  myTimer_Start(timer, TEST_PERIOD_MS, NULL);
+
+  myTimer_SetDuty(timer, 0);
+  TEST_ASSERT_EQUAL(0, TPM_SetChannelValue_fake.arg2_val);
+
+  myTimer_SetDuty(timer, 0x8000);
+  TEST_ASSERT_EQUAL(TEST_PERIOD_COUNTS / 2, TPM_SetChannelValue_fake.arg2_val);
+
+  myTimer_SetDuty(timer, MY_TIMER_DUTY_MAX);
+  TEST_ASSERT_EQUAL(TEST_PERIOD_COUNTS, TPM_SetChannelValue_fake.arg2_val);
+  TEST_ASSERT_EQUAL(kTPM_Chnl_0, TPM_SetChannelValue_fake.arg1_val);
+}
+
+/**
+ * @brief A duty cycle set while the timer is stopped should be kept and
+ *          programmed when it starts.
+ */
+void test_IfPwmTimerIsStoppedThenDutyIsSetAtStart(void)
+{
+  initPwm(myDriverTimerCh_TPM2_CH0_PTB18);
+  RESET_FAKE(TPM_SetChannelValue);
+
+  TEST_ASSERT_EQUAL(myRet_OK, myTimer_SetDuty(timer, 0x4000));
+  TEST_ASSERT_NOT_CALLED(TPM_SetChannelValue);
+
+  myTimer_Start(timer, TEST_PERIOD_MS, NULL);
+  TEST_ASSERT_CALLED(TPM_SetChannelValue);
+  TEST_ASSERT_EQUAL(TEST_PERIOD_COUNTS / 4, TPM_SetChannelValue_fake.arg2_val);
+}
+
+/**
+ * @brief Only PWM timers have a duty cycle to set.
+ */
+void test_IfTimerIsNotPwmThenSetDutyFails(void)
+{
+  myTimerPars_t pars = { .mode = myTimerMode_Periodic, .resource = myTimerRes_Dedicated };
+
+  myTimer_Init(&timer, &pars);
+  myTimer_Start(timer, TEST_PERIOD_MS, timerCallback);
+
+  TEST_ASSERT_EQUAL(myRet_Fail, myTimer_SetDuty(timer, 0x8000));
+  TEST_ASSERT_EQUAL(myRet_Fail, myTimer_SetDuty(NULL, 0x8000));
+  TEST_ASSERT_NOT_CALLED(TPM_SetChannelValue);
+}
+
+/**
+ * @brief A running PWM timer should be restarted with the new clock, keeping
+ *          its period and duty cycle.
+ */
+void test_IfClockChangesThenPwmTimerIsRestarted(void)
+{
+  initPwm(myDriverTimerCh_TPM2_CH0_PTB18);
+  myTimer_Start(timer, TEST_PERIOD_MS, NULL);
+  myTimer_SetDuty(timer, 0x8000);
+
+  CLOCK_GetOsc0ErClkFreq_fake.return_val = 2 * TEST_CLOCK_FREQ;
+  myTimer_ClockUpdate();
+
+  TEST_ASSERT_EQUAL((2 * TEST_PERIOD_COUNTS) - 1, TPM_SetTimerPeriod_fake.arg1_val);
+  TEST_ASSERT_EQUAL(TEST_PERIOD_COUNTS, TPM_SetChannelValue_fake.arg2_val);
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static void initPwm(uint8_t channel)
+{
+  myTimerPars_t pars = { .mode = myTimerMode_Pwm, .resource = myTimerRes_Dedicated, .channel = channel };
+
+  TEST_ASSERT_EQUAL(myRet_OK, myTimer_Init(&timer, &pars));
+}
+
+static void portSetPinConfigFake(PORT_Type * base, uint32_t pin, const port_pin_config_t * config)
+{
+  configuredMux = config->mux;
+}
+
+static void timerCallback(void)
+{
+}
@@ -0,0 +1,295 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file test_myTimer_Range.c
+ * @brief Test file for testing timer driver logic, selection of the TPM
+ *          prescaler and split of the periods that don't fit the TPM, over
+ *          the whole range of periods.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+#include "myMacros.h"
+
+#include "myTimer.h"
+#include "myWheel.h"
+#include "myPeriod.h"
+#include "mySplit.h"
+#include "myRing.h"
+#include "myDriverDefs.h"
+
+#include "mock_fsl_tpm.h"
+#include "mock_fsl_pit.h"
+#include "mock_fsl_port.h"
+#include "mock_fsl_clock.h"
+#include "mock_fsl_common.h"
+#include "mock_myTimer_TPM.h"
+#include "mock_myTime_Tick.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_MAX_PRESCALE                                                    (7)
+#define TEST_MAX_COUNTS                                                  (65536)
+#define TEST_LONGEST_PERIOD_MS                                 (10 * 3600 * 1000)
+#define TEST_PERIODS_PER_CASE                                                (3)
+
+/* The structure below models the parts of a TPM that the driver relies on.   */
+/*  MOD is buffered while the TPM runs, and only loaded at the overflow.      */
+typedef struct
+{
+  bool running;
+  bool stopOnOverflow;
+  uint32_t prescale;
+  uint32_t counts;
+  uint32_t bufferedCounts;
+  bool buffered;
+  uint64_t elapsed;
+} testTPM_t;
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static void prepareMocks(void);
+static void initTimer(myTimerMode_t mode);
+static uint32_t longestPeriodMs(uint32_t clockHz);
+static uint32_t expectedPrescale(uint64_t num);
+static uint64_t expectedElapsed(uint64_t num, uint32_t periods);
+static void runOverflow(void);
+static void tpmStopTimerFake(TPM_Type * base);
+static void tpmStartTimerFake(TPM_Type * base, tpm_clock_source_t clockSource);
+static void tpmSetPrescalerFake(TPM_Type * base, tpm_clock_prescale_t prescale);
+static void tpmSetStopOnOverflowFake(TPM_Type * base, bool enable);
+static void tpmSetTimerPeriodFake(TPM_Type * base, uint32_t ticks);
+static void timerCallback(void);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static myTimer_t timer = NULL;
+static testTPM_t tpm;
+static uint32_t callbackCallCount;
+static uint64_t callbackElapsed[TEST_PERIODS_PER_CASE + 1];
+
+static const uint32_t testClocks[] =
+{
+  8000000,    /* FRDM-KL25Z crystal.                                          */
+  48000000,
+  32768,
+};
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  prepareMocks();
+  myTimer_Reset();
+  timer = NULL;
+  tpm = (testTPM_t) { 0 };
+  callbackCallCount = 0;
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief From 1 ms to hours, a periodic timer should count each period with
+ *          the smallest prescaler that fits it, never set the TPM beyond its
+ *          16 bits, and expire exactly at the ideal time of each period.
+ */
+void test_PeriodicTimerIsExactOverWholeRange(void)
+{
+  uint32_t idx, periodMs, n;
+
+  for(idx = 0; idx < MY_ARRAY_SIZE(testClocks); idx++)
+  {
+    const uint32_t clockHz = testClocks[idx];
+
+    for(periodMs = 1; periodMs <= longestPeriodMs(clockHz); periodMs += (periodMs / 3) + 1)
+    {
+      const uint64_t num = (uint64_t)periodMs * clockHz;
+
+      setUp();
+      CLOCK_GetOsc0ErClkFreq_fake.return_val = clockHz;
+      initTimer(myTimerMode_Periodic);
+      TEST_ASSERT_EQUAL(myRet_OK, myTimer_Start(timer, periodMs, timerCallback));
+      TEST_ASSERT_EQUAL(expectedPrescale(num), tpm.prescale);
+      TEST_ASSERT_FALSE(tpm.stopOnOverflow);
+
+      while(callbackCallCount < TEST_PERIODS_PER_CASE) { runOverflow(); }
+
+      for(n = 1; n <= TEST_PERIODS_PER_CASE; n++)
+      {
+        TEST_ASSERT_TRUE(callbackElapsed[n] == expectedElapsed(num, n));
+      }
+    }
+  }
+}
+
+/**
+ * @brief From 1 ms to hours, a one-shot timer should expire once, exactly at
+ *          the ideal time, and leave its TPM stopped.
+ */
+void test_OneShotTimerIsExactOverWholeRange(void)
+{
+  uint32_t idx, periodMs;
+
+  for(idx = 0; idx < MY_ARRAY_SIZE(testClocks); idx++)
+  {
+    const uint32_t clockHz = testClocks[idx];
+
+    for(periodMs = 1; periodMs <= longestPeriodMs(clockHz); periodMs += (periodMs / 3) + 1)
+    {
+      const uint64_t num = (uint64_t)periodMs * clockHz;
+
+      setUp();
+      CLOCK_GetOsc0ErClkFreq_fake.return_val = clockHz;
+      initTimer(myTimerMode_OneShot);
+      TEST_ASSERT_EQUAL(myRet_OK, myTimer_Start(timer, periodMs, timerCallback));
+      TEST_ASSERT_EQUAL(expectedPrescale(num), tpm.prescale);
+
+      while(tpm.running) { runOverflow(); }
+
+      TEST_ASSERT_EQUAL(1, callbackCallCount);
+      TEST_ASSERT_TRUE(callbackElapsed[1] == expectedElapsed(num, 1));
+    }
+  }
+}
+
+/**
+ * @brief A period whose counts don't fit in 32 bits even at the largest
+ *          prescaler should be refused, and the TPM left untouched.
+ */
+void test_IfPeriodIsTooLongThenStartFails(void)
+{
+  const uint32_t clockHz = testClocks[1];
+  const uint32_t longest = longestPeriodMs(clockHz);
+
+  CLOCK_GetOsc0ErClkFreq_fake.return_val = clockHz;
+  initTimer(myTimerMode_Periodic);
+
+  TEST_ASSERT_EQUAL(myRet_Fail, myTimer_Start(timer, longest + 1, timerCallback));
+  TEST_ASSERT_NOT_CALLED(TPM_StartTimer);
+  TEST_ASSERT_EQUAL(myRet_OK, myTimer_Start(timer, longest, timerCallback));
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static void prepareMocks(void)
+{
+  TPM_StopTimer_fake.custom_fake = tpmStopTimerFake;
+  TPM_StartTimer_fake.custom_fake = tpmStartTimerFake;
+  TPM_SetPrescaler_fake.custom_fake = tpmSetPrescalerFake;
+  TPM_SetStopOnOverflow_fake.custom_fake = tpmSetStopOnOverflowFake;
+  TPM_SetTimerPeriod_fake.custom_fake = tpmSetTimerPeriodFake;
+}
+
+static void initTimer(myTimerMode_t mode)
+{
+  myTimerPars_t pars = { .mode = mode, .resource = myTimerRes_Dedicated };
+
+  TEST_ASSERT_EQUAL(myRet_OK, myTimer_Init(&timer, &pars));
+}
+
+static uint32_t longestPeriodMs(uint32_t clockHz)
+{
+  /* The counts of a period must fit in 32 bits at the largest prescaler.     */
+  const uint64_t longest = ((((1000ULL << TEST_MAX_PRESCALE) << 32) - 1) / clockHz);
+
+  return (longest < TEST_LONGEST_PERIOD_MS) ? (uint32_t)longest : TEST_LONGEST_PERIOD_MS;
+}
+
+static uint32_t expectedPrescale(uint64_t num)
+{
+  uint32_t prescale = 0;
+
+  while((prescale < TEST_MAX_PRESCALE) && ((num / (1000ULL << prescale)) >= TEST_MAX_COUNTS)) { prescale++; }
+
+  return prescale;
+}
+
+static uint64_t expectedElapsed(uint64_t num, uint32_t periods)
+{
+  /* Ideal time of the given amount of periods, rounded down to the counts of */
+  /*  the prescaler in use, and given in clock cycles.                        */
+  return ((periods * num) / (1000ULL << tpm.prescale)) << tpm.prescale;
+}
+
+static void runOverflow(void)
+{
+  tpm.elapsed += (uint64_t)tpm.counts << tpm.prescale;
+  if(tpm.buffered)
+  {
+    tpm.counts = tpm.bufferedCounts;
+    tpm.buffered = false;
+  }
+  if(tpm.stopOnOverflow) { tpm.running = false; }
+
+  TPM0_IRQHandler();
+}
+
+static void tpmStopTimerFake(TPM_Type * base)
+{
+  tpm.running = false;
+}
+
+static void tpmStartTimerFake(TPM_Type * base, tpm_clock_source_t clockSource)
+{
+  tpm.running = true;
+}
+
+static void tpmSetPrescalerFake(TPM_Type * base, tpm_clock_prescale_t prescale)
+{
+  TEST_ASSERT_FALSE(tpm.running);
+  tpm.prescale = prescale;
+}
+
+static void tpmSetStopOnOverflowFake(TPM_Type * base, bool enable)
+{
+  tpm.stopOnOverflow = enable;
+}
+
+static void tpmSetTimerPeriodFake(TPM_Type * base, uint32_t ticks)
+{
+  TEST_ASSERT_TRUE(ticks < TEST_MAX_COUNTS);
+
+  if(tpm.running)
+  {
+    tpm.bufferedCounts = ticks + 1;
+    tpm.buffered = true;
+  }
+  else
+  {
+    tpm.counts = ticks + 1;
+  }
+}
+
+static void timerCallback(void)
+{
+  callbackCallCount++;
+  if(callbackCallCount < MY_ARRAY_SIZE(callbackElapsed)) { callbackElapsed[callbackCallCount] = tpm.elapsed; }
+}
@@ -27,12 +27,19 @@
 #include "myTestDefs.h"
 
 #include "myTimer.h"
+#include "myWheel.h"
+#include "myPeriod.h"
+#include "mySplit.h"
+#include "myRing.h"
 #include "myDriverDefs.h"
 
 #include "mock_fsl_tpm.h"
+#include "mock_fsl_pit.h"
+#include "mock_fsl_port.h"
 #include "mock_fsl_clock.h"
 #include "mock_fsl_common.h"
 #include "mock_myTimer_TPM.h"
+#include "mock_myTime_Tick.h"
 
 /*******************************************************************************
  *  PRIVATE DEFINITIONS
@@ -70,12 +77,16 @@ void tearDown(void)
  *  TESTS
  ******************************************************************************/
 /**
- * @brief When a timer is started then logic should get which is the TPMs'
- *          base clock by calling the CLOCK_GetOsc0ErClkFreq routine.
+ * @brief Logic should get which is the TPMs' base clock by calling the
+ *          CLOCK_GetOsc0ErClkFreq routine at init, and not each time a timer
+ *          is started.
  */
-void test_LogicCallsCLOCK_GetOsc0ErClkFreq(void)
+void test_LogicCallsCLOCK_GetOsc0ErClkFreqOnlyAtInit(void)
 {
   TEST_ASSERT_CALLED(CLOCK_GetOsc0ErClkFreq);
+
+  myTimer_Start(timer, TEST_PERIOD_MS, timerCallback);
+  TEST_ASSERT_CALLED(CLOCK_GetOsc0ErClkFreq);
 }
 
 /**
@@ -99,12 +110,13 @@ void test_LogicCallsTPM_ClearCounter(void)
 }
 
 /**
- * @brief When a timer is started then logic should set the counting period
- *          by calling TPM_SetTimerPeriod routine.
+ * @brief When a periodic timer is started then logic should set the counting
+ *          period by calling TPM_SetTimerPeriod routine, once for the first
+ *          period and once more to queue the next one.
  */
 void test_LogicCallsTPM_SetTimerPeriod(void)
 {
-  TEST_ASSERT_CALLED(TPM_SetTimerPeriod);
+  TEST_ASSERT_CALLED_TIMES(2, TPM_SetTimerPeriod);
 }
 
 /**
@@ -0,0 +1,184 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file test_myTimer_SysTick.c
+ * @brief Test file for testing timer driver logic, operation of the timer
+ *          that is backed by the SysTick.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+
+#include "myTimer.h"
+#include "myWheel.h"
+#include "myPeriod.h"
+#include "mySplit.h"
+#include "myRing.h"
+#include "myDriverDefs.h"
+
+#include "mock_fsl_tpm.h"
+#include "mock_fsl_pit.h"
+#include "mock_fsl_port.h"
+#include "mock_fsl_clock.h"
+#include "mock_fsl_common.h"
+#include "mock_myTimer_TPM.h"
+#include "mock_myTime_Tick.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_CORE_CLOCK_HZ                                            (48000000)
+#define TEST_FLL_CORE_CLOCK_HZ                                        (20971520)
+#define TEST_PERIOD_MS                                                      (10)
+#define TEST_PERIOD_COUNTS                                              (480000)
+#define TEST_MAX_PERIOD_MS                                                 (349)
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static myRet_t initTimer(myTimer_t * timer, myTimerMode_t mode);
+static void timerCallback(void);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static myTimer_t timer = NULL;
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  CLOCK_GetCoreSysClkFreq_fake.return_val = TEST_CORE_CLOCK_HZ;
+  myTimer_Reset();
+  timer = NULL;
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief The SysTick only wraps periodically, so it should only back a
+ *          single periodic timer.
+ */
+void test_OnlyASinglePeriodicTimerIsInitialized(void)
+{
+  myTimer_t other;
+
+  TEST_ASSERT_EQUAL(myRet_Fail, initTimer(&timer, myTimerMode_OneShot));
+  TEST_ASSERT_EQUAL(myRet_Fail, initTimer(&timer, myTimerMode_FreeRunning));
+  TEST_ASSERT_EQUAL(myRet_OK, initTimer(&timer, myTimerMode_Periodic));
+  TEST_ASSERT_EQUAL(myRet_Fail, initTimer(&other, myTimerMode_Periodic));
+
+  TEST_ASSERT_NOT_CALLED(TPM_Init);
+  TEST_ASSERT_NOT_CALLED(PIT_Init);
+}
+
+/**
+ * @brief Starting the timer should set the SysTick wraps to the counts of
+ *          the period, with the callback of the timer.
+ */
+void test_StartSetsTheWrapsToThePeriod(void)
+{
+  initTimer(&timer, myTimerMode_Periodic);
+
+  TEST_ASSERT_EQUAL(myRet_OK, myTimer_Start(timer, TEST_PERIOD_MS, timerCallback));
+  TEST_ASSERT_CALLED(myTime_SetTick);
+  TEST_ASSERT_EQUAL(TEST_PERIOD_COUNTS, myTime_SetTick_fake.arg0_val);
+  TEST_ASSERT_EQUAL_PTR(timerCallback, myTime_SetTick_fake.arg1_val);
+}
+
+/**
+ * @brief A wrap is a whole amount of counts, so the fraction of the period
+ *          should be dropped.
+ */
+void test_FractionOfThePeriodIsDropped(void)
+{
+  CLOCK_GetCoreSysClkFreq_fake.return_val = TEST_FLL_CORE_CLOCK_HZ;
+  initTimer(&timer, myTimerMode_Periodic);
+  myTimer_Start(timer, 1, timerCallback);
+
+  TEST_ASSERT_EQUAL(20971, myTime_SetTick_fake.arg0_val);
+}
+
+/**
+ * @brief A period should only be started if it fits a single SysTick wrap.
+ */
+void test_IfPeriodDoesNotFitAWrapThenStartFails(void)
+{
+  initTimer(&timer, myTimerMode_Periodic);
+
+  TEST_ASSERT_EQUAL(myRet_Fail, myTimer_Start(timer, TEST_MAX_PERIOD_MS + 1, timerCallback));
+  TEST_ASSERT_NOT_CALLED(myTime_SetTick);
+  TEST_ASSERT_EQUAL(myRet_OK, myTimer_Start(timer, TEST_MAX_PERIOD_MS, timerCallback));
+}
+
+/**
+ * @brief The SysTick keeps the system time, so stopping the timer should
+ *          only bring back its default wraps, with no callback.
+ */
+void test_StopBringsBackTheDefaultWraps(void)
+{
+  initTimer(&timer, myTimerMode_Periodic);
+  myTimer_Start(timer, TEST_PERIOD_MS, timerCallback);
+
+  TEST_ASSERT_EQUAL(myRet_OK, myTimer_Stop(timer));
+  TEST_ASSERT_EQUAL(0, myTime_SetTick_fake.arg0_val);
+  TEST_ASSERT_EQUAL_PTR(NULL, myTime_SetTick_fake.arg1_val);
+}
+
+/**
+ * @brief A running timer should be restarted with the counts of the new
+ *          core clock when the clock changes, but a stopped one should not.
+ */
+void test_ClockUpdateRestartsRunningTimer(void)
+{
+  initTimer(&timer, myTimerMode_Periodic);
+  myTimer_Start(timer, TEST_PERIOD_MS, timerCallback);
+
+  CLOCK_GetCoreSysClkFreq_fake.return_val = TEST_CORE_CLOCK_HZ / 2;
+  myTimer_ClockUpdate();
+  TEST_ASSERT_EQUAL(TEST_PERIOD_COUNTS / 2, myTime_SetTick_fake.arg0_val);
+  TEST_ASSERT_EQUAL_PTR(timerCallback, myTime_SetTick_fake.arg1_val);
+
+  myTimer_Stop(timer);
+  RESET_FAKE(myTime_SetTick);
+  myTimer_ClockUpdate();
+  TEST_ASSERT_NOT_CALLED(myTime_SetTick);
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static myRet_t initTimer(myTimer_t * timer, myTimerMode_t mode)
+{
+  myTimerPars_t pars = { .mode = mode, .resource = myTimerRes_SysTick };
+
+  return myTimer_Init(timer, &pars);
+}
+
+static void timerCallback(void)
+{
+}
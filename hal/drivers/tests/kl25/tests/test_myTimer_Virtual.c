@@ -0,0 +1,236 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file test_myTimer_Virtual.c
+ * @brief Test file for testing timer driver logic, operation when virtual
+ *          timers are used.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+
+#include "myTimer.h"
+#include "myWheel.h"
+#include "myPeriod.h"
+#include "mySplit.h"
+#include "myRing.h"
+#include "myDriverDefs.h"
+
+#include "mock_fsl_tpm.h"
+#include "mock_fsl_pit.h"
+#include "mock_fsl_port.h"
+#include "mock_fsl_clock.h"
+#include "mock_fsl_common.h"
+#include "mock_myTimer_TPM.h"
+#include "mock_myTime_Tick.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_CLOCK_FREQ                                                (8000000)
+#define TEST_PERIOD_MS                                                      (10)
+
+/* Same as the driver's default amount of virtual timers.                     */
+#define TEST_TIMER_AMOUNT                                                   (16)
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static void prepareMocks(void);
+static void setValidTimerPars(void);
+static void runTicks(uint32_t ticks);
+static void timerCallback(void);
+static void otherTimerCallback(void);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static myTimer_t timers[TEST_TIMER_AMOUNT];
+static myTimerPars_t pars;
+static uint32_t callbackCallCount;
+static uint32_t otherCallbackCallCount;
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  uint32_t idx;
+
+  prepareMocks();
+  setValidTimerPars();
+  callbackCallCount = 0;
+  otherCallbackCallCount = 0;
+  myTimer_Reset();
+
+  for(idx = 0; idx < TEST_TIMER_AMOUNT; idx++)
+  {
+    timers[idx] = NULL;
+    myTimer_Init(&timers[idx], &pars);
+  }
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief All the virtual timers should be initialized successfully.
+ */
+void test_AllVirtualTimersAreInitialized(void)
+{
+  uint32_t idx;
+
+  for(idx = 0; idx < TEST_TIMER_AMOUNT; idx++) { TEST_ASSERT_NOT_NULL(timers[idx]); }
+}
+
+/**
+ * @brief All the virtual timers should share a single TPM, which is started
+ *          to count the wheel's tick.
+ */
+void test_VirtualTimersShareOneTPM(void)
+{
+  TEST_ASSERT_CALLED(TPM_Init);
+  TEST_ASSERT_CALLED(TPM_StartTimer);
+  TEST_ASSERT_EQUAL(kTPM_Prescale_Divide_1, TPM_SetPrescaler_fake.arg1_val);
+  TEST_ASSERT_EQUAL(MSEC_TO_COUNT(1, TEST_CLOCK_FREQ) - 1, TPM_SetTimerPeriod_fake.arg1_val);
+}
+
+/**
+ * @brief The TPMs not used by the virtual timers should still be available
+ *          as dedicated timers.
+ */
+void test_RemainingTPMsAreAvailableAsDedicated(void)
+{
+  myTimer_t dedicated = NULL;
+
+  pars.resource = myTimerRes_Dedicated;
+
+  TEST_ASSERT_EQUAL(myRet_OK, myTimer_Init(&dedicated, &pars));
+  TEST_ASSERT_EQUAL(myRet_OK, myTimer_Init(&dedicated, &pars));
+  TEST_ASSERT_EQUAL(myRet_Fail, myTimer_Init(&dedicated, &pars));
+}
+
+/**
+ * @brief When a virtual timer is started then the tick interrupt should be
+ *          masked while the timer is scheduled, and then enabled again.
+ */
+void test_IfVirtualTimerIsStartedThenTickInterruptIsMaskedMeanwhile(void)
+{
+  RESET_FAKE(DisableIRQ);
+  RESET_FAKE(EnableIRQ);
+
+  myTimer_Start(timers[0], TEST_PERIOD_MS, timerCallback);
+
+  TEST_ASSERT_CALLED(DisableIRQ);
+  TEST_ASSERT_EQUAL(TPM0_IRQn, DisableIRQ_fake.arg0_val);
+  TEST_ASSERT_CALLED(EnableIRQ);
+  TEST_ASSERT_EQUAL(TPM0_IRQn, EnableIRQ_fake.arg0_val);
+}
+
+/**
+ * @brief A started virtual timer should have its callback called once per
+ *          period, counted in ticks of the shared TPM.
+ */
+void test_IfVirtualTimerIsStartedThenCallbackIsCalledEachPeriod(void)
+{
+  myTimer_Start(timers[0], TEST_PERIOD_MS, timerCallback);
+
+  runTicks(TEST_PERIOD_MS - 1);
+  TEST_ASSERT_EQUAL(0, callbackCallCount);
+
+  runTicks(1);
+  TEST_ASSERT_EQUAL(1, callbackCallCount);
+
+  runTicks(TEST_PERIOD_MS * 9);
+  TEST_ASSERT_EQUAL(10, callbackCallCount);
+}
+
+/**
+ * @brief Virtual timers with different periods should not disturb each other.
+ */
+void test_VirtualTimersRunIndependently(void)
+{
+  myTimer_Start(timers[0], TEST_PERIOD_MS, timerCallback);
+  myTimer_Start(timers[TEST_TIMER_AMOUNT - 1], 3 * TEST_PERIOD_MS, otherTimerCallback);
+
+  runTicks(30 * TEST_PERIOD_MS);
+
+  TEST_ASSERT_EQUAL(30, callbackCallCount);
+  TEST_ASSERT_EQUAL(10, otherCallbackCallCount);
+}
+
+/**
+ * @brief A stopped virtual timer should not have its callback called anymore.
+ */
+void test_IfVirtualTimerIsStoppedThenCallbackIsNotCalled(void)
+{
+  myTimer_Start(timers[0], TEST_PERIOD_MS, timerCallback);
+  runTicks(TEST_PERIOD_MS);
+
+  TEST_ASSERT_EQUAL(myRet_OK, myTimer_Stop(timers[0]));
+  runTicks(10 * TEST_PERIOD_MS);
+
+  TEST_ASSERT_EQUAL(1, callbackCallCount);
+}
+
+/**
+ * @brief Once all the virtual timers are taken, initialization should fail.
+ */
+void test_IfNoVirtualTimerIsLeftThenInitFails(void)
+{
+  myTimer_t timer = NULL;
+
+  TEST_ASSERT_EQUAL(myRet_Fail, myTimer_Init(&timer, &pars));
+  TEST_ASSERT_NULL(timer);
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static void prepareMocks(void)
+{
+  CLOCK_GetOsc0ErClkFreq_fake.return_val = TEST_CLOCK_FREQ;
+}
+
+static void setValidTimerPars(void)
+{
+  pars.mode = myTimerMode_Periodic;
+  pars.resource = myTimerRes_Virtual;
+}
+
+static void runTicks(uint32_t ticks)
+{
+  /* The first TPM is the one taken by the wheel.                             */
+  while(ticks-- > 0) { TPM0_IRQHandler(); }
+}
+
+static void timerCallback(void)
+{
+  callbackCallCount++;
+}
+
+static void otherTimerCallback(void)
+{
+  otherCallbackCallCount++;
+}
@@ -0,0 +1,182 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test_myGpio_Fgpio.c
+ * @brief Test file for testing gpio driver logic, operation when the pins are
+ *          accessed through the FGPIO alias. It runs the same operations as
+ *          the tests of the peripheral bridge backend, and checks that they
+ *          end up on the FGPIO registers instead, with the same values.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+
+#include "myGpio.h"
+#include "myGpioFast.h"
+#include "myDriverDefs.h"
+
+#include "mock_fsl_gpio.h"
+#include "mock_fsl_port.h"
+#include "mock_fsl_clock.h"
+#include "mock_fsl_common.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_MY_GPIO_PORT                                       myDriverPort_PTB
+#define TEST_MY_GPIO_PIN                                          myDriverPin_19
+#define TEST_MY_GPIO_PIN_MASK                                         (1U << 19)
+#define TEST_MY_GPIO_PORT_MASK                                      (0x000F0300)
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static void assertBridgeIsUntouched(void);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static myGpioPin_t pin;
+static myGpioPort_t port;
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  myGpioPars_t pinPars = { TEST_MY_GPIO_PORT, TEST_MY_GPIO_PIN, myGpioDir_Outp, myGpioPull_No };
+  myGpioPortPars_t portPars = { TEST_MY_GPIO_PORT, TEST_MY_GPIO_PORT_MASK, myGpioDir_Outp, myGpioPull_No };
+
+  myGpio_Reset();
+  myGpio_Init(&pin, &pinPars);
+  myGpio_InitPort(&port, &portPars);
+  FGPIOB_Regs = (FGPIO_Type) { 0 };
+  GPIOB_Regs = (GPIO_Type) { 0 };
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief Pins should be initialized through the FGPIO alias as well.
+ */
+void test_InitUsesFGPIOPinInit(void)
+{
+  TEST_ASSERT_CALLED_TIMES(7, FGPIO_PinInit);
+  TEST_ASSERT_EQUAL_PTR(FGPIOB, FGPIO_PinInit_fake.arg0_history[0]);
+  TEST_ASSERT_EQUAL(TEST_MY_GPIO_PIN, FGPIO_PinInit_fake.arg1_history[0]);
+  TEST_ASSERT_NOT_CALLED(GPIO_PinInit);
+}
+
+/**
+ * @brief Setting a pin high should store its mask to PSOR, and setting it low
+ *          should store it to PCOR.
+ */
+void test_SetStoresToPSOROrPCOR(void)
+{
+  TEST_ASSERT_EQUAL(myRet_OK, myGpio_Set(pin, myGpioLvl_Hi));
+  TEST_ASSERT_EQUAL_HEX32(TEST_MY_GPIO_PIN_MASK, FGPIOB_Regs.PSOR);
+  TEST_ASSERT_EQUAL_HEX32(0, FGPIOB_Regs.PCOR);
+
+  TEST_ASSERT_EQUAL(myRet_OK, myGpio_Set(pin, myGpioLvl_Lo));
+  TEST_ASSERT_EQUAL_HEX32(TEST_MY_GPIO_PIN_MASK, FGPIOB_Regs.PCOR);
+
+  TEST_ASSERT_NOT_CALLED(GPIO_WritePinOutput);
+  assertBridgeIsUntouched();
+}
+
+/**
+ * @brief Toggling a pin should store its mask to PTOR.
+ */
+void test_ToggleStoresToPTOR(void)
+{
+  TEST_ASSERT_EQUAL(myRet_OK, myGpio_Toggle(pin));
+  TEST_ASSERT_EQUAL_HEX32(TEST_MY_GPIO_PIN_MASK, FGPIOB_Regs.PTOR);
+
+  TEST_ASSERT_NOT_CALLED(GPIO_TogglePinsOutput);
+  assertBridgeIsUntouched();
+}
+
+/**
+ * @brief Getting a pin should read its bit from PDIR.
+ */
+void test_GetReadsPDIR(void)
+{
+  FGPIOB_Regs.PDIR = ~TEST_MY_GPIO_PIN_MASK;
+  TEST_ASSERT_EQUAL(myGpioLvl_Lo, myGpio_Get(pin));
+
+  FGPIOB_Regs.PDIR = TEST_MY_GPIO_PIN_MASK;
+  TEST_ASSERT_EQUAL(myGpioLvl_Hi, myGpio_Get(pin));
+
+  TEST_ASSERT_NOT_CALLED(GPIO_ReadPinInput);
+}
+
+/**
+ * @brief Group operations should store the same values as with the peripheral
+ *          bridge backend.
+ */
+void test_GroupOperationsStoreTheSameValues(void)
+{
+  myGpio_SetMask(port, 0xFFFFFFFF);
+  TEST_ASSERT_EQUAL_HEX32(TEST_MY_GPIO_PORT_MASK, FGPIOB_Regs.PSOR);
+
+  myGpio_ClearMask(port, 0x00010100);
+  TEST_ASSERT_EQUAL_HEX32(0x00010100, FGPIOB_Regs.PCOR);
+
+  myGpio_ToggleMask(port, 0x00F00300);
+  TEST_ASSERT_EQUAL_HEX32(0x00000300, FGPIOB_Regs.PTOR);
+
+  myGpio_WritePort(port, 0x00050200);
+  TEST_ASSERT_EQUAL_HEX32(0x00050200, FGPIOB_Regs.PSOR);
+  TEST_ASSERT_EQUAL_HEX32(0x000A0100, FGPIOB_Regs.PCOR);
+
+  FGPIOB_Regs.PDIR = 0xFFFA0200;
+  TEST_ASSERT_EQUAL_HEX32(0x000A0200, myGpio_GetPort(port));
+
+  assertBridgeIsUntouched();
+}
+
+/**
+ * @brief The fast path should resolve the ports to the FGPIO registers.
+ */
+void test_FastPathUsesFGPIO(void)
+{
+  TEST_ASSERT_EQUAL_PTR(FGPIOA, myGpioFast_Base(myDriverPort_PTA));
+  TEST_ASSERT_EQUAL_PTR(FGPIOE, myGpioFast_Base(myDriverPort_PTE));
+
+  myGpioFast_Toggle(TEST_MY_GPIO_PORT, TEST_MY_GPIO_PIN);
+  TEST_ASSERT_EQUAL_HEX32(TEST_MY_GPIO_PIN_MASK, FGPIOB_Regs.PTOR);
+
+  assertBridgeIsUntouched();
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static void assertBridgeIsUntouched(void)
+{
+  const GPIO_Type untouched = { 0 };
+
+  TEST_ASSERT_EQUAL_MEMORY(&untouched, &GPIOB_Regs, sizeof(GPIO_Type));
+}
@@ -22,4 +22,8 @@
 #ifndef PROJ_CONFIG_H
 #define PROJ_CONFIG_H
 
+/* All the TIMs are handled by the timer driver, so that all get tested.      */
+#define DRIVER_TIMER_USE_TIM1                                                  1
+#define DRIVER_TIMER_USE_TIM2                                                  1
+
 #endif
\ No newline at end of file
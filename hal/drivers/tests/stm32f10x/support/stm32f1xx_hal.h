@@ -16,7 +16,10 @@ extern "C" {
 #include "stm32f1xx_hal_def.h"
 #include "stm32f1xx_hal_rcc.h"
 #include "stm32f1xx_hal_gpio.h"
+#include "stm32f1xx_hal_exti.h"
+#include "stm32f1xx_hal_dma.h"
 #include "stm32f1xx_hal_tim.h"
+#include "stm32f1xx_hal_pwr.h"
 
 /*******************************************************************************
  * DEFINITIONS
@@ -80,18 +83,77 @@ typedef enum
   USBWakeUp_IRQn              = 42,     /*!< USB Device WakeUp from suspend through EXTI Line Interrupt */
 } IRQn_Type;
 
+/** SysTick and SCB - Register Layout Typedefs, from the CMSIS core header.   */
+typedef struct
+{
+  volatile uint32_t CTRL;
+  volatile uint32_t LOAD;
+  volatile uint32_t VAL;
+  volatile uint32_t CALIB;
+} SysTick_Type;
+
+typedef struct
+{
+  volatile uint32_t CPUID;
+  volatile uint32_t ICSR;
+  volatile uint32_t VTOR;
+  volatile uint32_t AIRCR;
+  volatile uint32_t SCR;
+  volatile uint32_t CCR;
+} SCB_Type;
+
+/** SysTick and SCB fake registers, so that logic can access them.            */
+extern SysTick_Type SysTick_Regs;
+extern SCB_Type SCB_Regs;
+
+#define SysTick                                                  (&SysTick_Regs)
+#define SCB                                                          (&SCB_Regs)
+
+/** SysTick and SCB Register bits                                             */
+#define SysTick_CTRL_ENABLE_Msk                                        (1U << 0)
+#define SysTick_CTRL_TICKINT_Msk                                       (1U << 1)
+#define SysTick_CTRL_CLKSOURCE_Msk                                     (1U << 2)
+#define SysTick_CTRL_COUNTFLAG_Msk                                    (1U << 16)
+#define SCB_ICSR_PENDSTCLR_Msk                                        (1U << 25)
+#define SCB_ICSR_PENDSTSET_Msk                                        (1U << 26)
+
 /*******************************************************************************
  * API
  ******************************************************************************/
 void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority);
 void HAL_NVIC_EnableIRQ(IRQn_Type IRQn);
 void HAL_NVIC_DisableIRQ(IRQn_Type IRQn);
+void HAL_NVIC_ClearPendingIRQ(IRQn_Type IRQn);
+
+void HAL_IncTick(void);
+
+void __disable_irq(void);
+void __enable_irq(void);
+uint32_t __get_PRIMASK(void);
+void __set_PRIMASK(uint32_t priMask);
 
 /*******************************************************************************
  * INTERRUPT HANDLERS
  ******************************************************************************/
+extern void TIM1_UP_IRQHandler(void);
+extern void TIM2_IRQHandler(void);
 extern void TIM3_IRQHandler(void);
 extern void TIM4_IRQHandler(void);
+extern void EXTI0_IRQHandler(void);
+extern void EXTI1_IRQHandler(void);
+extern void EXTI2_IRQHandler(void);
+extern void EXTI3_IRQHandler(void);
+extern void EXTI4_IRQHandler(void);
+extern void EXTI9_5_IRQHandler(void);
+extern void EXTI15_10_IRQHandler(void);
+extern void DMA1_Channel1_IRQHandler(void);
+extern void DMA1_Channel2_IRQHandler(void);
+extern void DMA1_Channel3_IRQHandler(void);
+extern void DMA1_Channel4_IRQHandler(void);
+extern void DMA1_Channel5_IRQHandler(void);
+extern void DMA1_Channel6_IRQHandler(void);
+extern void DMA1_Channel7_IRQHandler(void);
+extern void SysTick_Handler(void);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,129 @@
+/**
+ * @file stm32f1xx_hal_dma.h
+ * @brief Header file for mocking the stm32f1xx_hal_dma sdk module.
+ */
+
+#ifndef STM32F1xx_HAL_DMA_H
+#define STM32F1xx_HAL_DMA_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "stm32f1xx_hal_def.h"
+
+/*******************************************************************************
+ * DEFINITIONS
+ ******************************************************************************/
+/** DMA Channel - Register Layout Typedef                                     */
+typedef struct
+{
+  volatile uint32_t CCR;
+  volatile uint32_t CNDTR;
+  volatile uint32_t CPAR;
+  volatile uint32_t CMAR;
+} DMA_Channel_TypeDef;
+
+/** DMA Channels' fake registers, so that logic can access them.              */
+extern DMA_Channel_TypeDef DMA1_Channel1_Regs;
+extern DMA_Channel_TypeDef DMA1_Channel2_Regs;
+extern DMA_Channel_TypeDef DMA1_Channel3_Regs;
+extern DMA_Channel_TypeDef DMA1_Channel4_Regs;
+extern DMA_Channel_TypeDef DMA1_Channel5_Regs;
+extern DMA_Channel_TypeDef DMA1_Channel6_Regs;
+extern DMA_Channel_TypeDef DMA1_Channel7_Regs;
+
+#define DMA1_Channel1                                      (&DMA1_Channel1_Regs)
+#define DMA1_Channel2                                      (&DMA1_Channel2_Regs)
+#define DMA1_Channel3                                      (&DMA1_Channel3_Regs)
+#define DMA1_Channel4                                      (&DMA1_Channel4_Regs)
+#define DMA1_Channel5                                      (&DMA1_Channel5_Regs)
+#define DMA1_Channel6                                      (&DMA1_Channel6_Regs)
+#define DMA1_Channel7                                      (&DMA1_Channel7_Regs)
+
+/** DMA Register bits                                                         */
+#define DMA_CCR_EN                                                     (1U << 0)
+#define DMA_CCR_TCIE                                                   (1U << 1)
+#define DMA_CCR_HTIE                                                   (1U << 2)
+#define DMA_CCR_TEIE                                                   (1U << 3)
+#define DMA_CCR_DIR                                                    (1U << 4)
+#define DMA_CCR_CIRC                                                   (1U << 5)
+#define DMA_CCR_PINC                                                   (1U << 6)
+#define DMA_CCR_MINC                                                   (1U << 7)
+#define DMA_CCR_PSIZE_1                                                (1U << 9)
+#define DMA_CCR_MSIZE_1                                               (1U << 11)
+#define DMA_CCR_PL_0                                                  (1U << 12)
+#define DMA_CCR_PL_1                                                  (1U << 13)
+
+typedef struct
+{
+  uint32_t Direction;           /*!< Specifies if the data will be transferred from memory to peripheral,
+                                     from memory to memory or from peripheral to memory. */
+
+  uint32_t PeriphInc;           /*!< Specifies whether the Peripheral address register should be incremented or not. */
+
+  uint32_t MemInc;              /*!< Specifies whether the memory address register should be incremented or not. */
+
+  uint32_t PeriphDataAlignment; /*!< Specifies the Peripheral data width. */
+
+  uint32_t MemDataAlignment;    /*!< Specifies the Memory data width. */
+
+  uint32_t Mode;                /*!< Specifies the operation mode of the DMAy Channelx. */
+
+  uint32_t Priority;            /*!< Specifies the software priority for the DMAy Channelx. */
+} DMA_InitTypeDef;
+
+typedef struct __DMA_HandleTypeDef
+{
+  DMA_Channel_TypeDef   *Instance;                                                /*!< Register base address             */
+  DMA_InitTypeDef       Init;                                                     /*!< DMA communication parameters      */
+  void                  *Parent;                                                  /*!< Parent object state               */
+  void                  (* XferCpltCallback)(struct __DMA_HandleTypeDef * hdma);     /*!< DMA transfer complete callback    */
+  void                  (* XferHalfCpltCallback)(struct __DMA_HandleTypeDef * hdma); /*!< DMA Half transfer complete callback */
+  void                  (* XferErrorCallback)(struct __DMA_HandleTypeDef * hdma);    /*!< DMA transfer error callback       */
+  void                  (* XferAbortCallback)(struct __DMA_HandleTypeDef * hdma);    /*!< DMA transfer abort callback       */
+} DMA_HandleTypeDef;
+
+#define DMA_PERIPH_TO_MEMORY                                         0x00000000U
+#define DMA_MEMORY_TO_PERIPH                             ((uint32_t)DMA_CCR_DIR)
+
+#define DMA_PINC_ENABLE                                 ((uint32_t)DMA_CCR_PINC)
+#define DMA_PINC_DISABLE                                             0x00000000U
+
+#define DMA_MINC_ENABLE                                 ((uint32_t)DMA_CCR_MINC)
+#define DMA_MINC_DISABLE                                             0x00000000U
+
+#define DMA_PDATAALIGN_WORD                          ((uint32_t)DMA_CCR_PSIZE_1)
+#define DMA_MDATAALIGN_WORD                          ((uint32_t)DMA_CCR_MSIZE_1)
+
+#define DMA_NORMAL                                                   0x00000000U
+#define DMA_CIRCULAR                                    ((uint32_t)DMA_CCR_CIRC)
+
+#define DMA_PRIORITY_LOW                                             0x00000000U
+#define DMA_PRIORITY_MEDIUM                             ((uint32_t)DMA_CCR_PL_0)
+#define DMA_PRIORITY_HIGH                               ((uint32_t)DMA_CCR_PL_1)
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+#define __HAL_DMA_GET_COUNTER(__HANDLE__)        ((__HANDLE__)->Instance->CNDTR)
+
+/*******************************************************************************
+ * API
+ ******************************************************************************/
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma);
+HAL_StatusTypeDef HAL_DMA_DeInit(DMA_HandleTypeDef *hdma);
+HAL_StatusTypeDef HAL_DMA_Start(DMA_HandleTypeDef *hdma, uint32_t SrcAddress, uint32_t DstAddress, uint32_t DataLength);
+HAL_StatusTypeDef HAL_DMA_Start_IT(DMA_HandleTypeDef *hdma, uint32_t SrcAddress, uint32_t DstAddress, uint32_t DataLength);
+HAL_StatusTypeDef HAL_DMA_Abort(DMA_HandleTypeDef *hdma);
+
+void HAL_DMA_IRQHandler(DMA_HandleTypeDef *hdma);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
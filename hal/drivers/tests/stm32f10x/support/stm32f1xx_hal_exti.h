@@ -0,0 +1,42 @@
+/**
+ * @file stm32f1xx_hal_exti.h
+ * @brief Header file for mocking the stm32f1xx_hal_exti sdk module.
+ */
+
+#ifndef STM32F1xx_HAL_EXTI_H
+#define STM32F1xx_HAL_EXTI_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "stm32f1xx_hal_def.h"
+#include "stm32f1xx_hal_gpio.h"
+
+/*******************************************************************************
+ * DEFINITIONS
+ ******************************************************************************/
+/** EXTI - Register Layout Typedef                                            */
+typedef struct
+{
+  volatile uint32_t IMR;
+  volatile uint32_t EMR;
+  volatile uint32_t RTSR;
+  volatile uint32_t FTSR;
+  volatile uint32_t SWIER;
+  volatile uint32_t PR;
+} EXTI_TypeDef;
+
+/** EXTI Peripheral's fake registers, at the same offset as on the device.    */
+#define EXTI_BASE                               (APB2PERIPH_BASE + 0x00000400)
+#define EXTI                                       ((EXTI_TypeDef *) EXTI_BASE)
+#define EXTI_Regs                                                        (*EXTI)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -19,14 +19,45 @@ extern "C" {
  * DEFINITIONS
  ******************************************************************************/
 /** GPIO - Register Layout Typedef                                            */
-typedef void * GPIO_TypeDef;
-
-/** GPIO Peripherals' fake addresses                                          */
-#define GPIOA                                        ((GPIO_TypeDef) 0x0000000A)
-#define GPIOB                                        ((GPIO_TypeDef) 0x0000000B)
-#define GPIOC                                        ((GPIO_TypeDef) 0x0000000C)
-#define GPIOD                                        ((GPIO_TypeDef) 0x0000000D)
-#define GPIOE                                        ((GPIO_TypeDef) 0x0000000E)
+typedef struct
+{
+  volatile uint32_t CRL;
+  volatile uint32_t CRH;
+  volatile uint32_t IDR;
+  volatile uint32_t ODR;
+  volatile uint32_t BSRR;
+  volatile uint32_t BRR;
+  volatile uint32_t LCKR;
+} GPIO_TypeDef;
+
+/** Fake peripheral address space, so that the GPIO registers sit at the same */
+/**  offsets as on the device, and their bit-band aliases can be computed.    */
+#define PERIPH_MEM_SIZE                                                (0x12000)
+extern uint32_t PERIPH_Mem[PERIPH_MEM_SIZE / 4];
+extern uint32_t PERIPH_BB_Mem[PERIPH_MEM_SIZE * 8];
+
+#define PERIPH_BASE                                   ((uintptr_t) PERIPH_Mem)
+#define PERIPH_BB_BASE                             ((uintptr_t) PERIPH_BB_Mem)
+#define APB2PERIPH_BASE                             (PERIPH_BASE + 0x00010000)
+
+#define GPIOA_BASE                              (APB2PERIPH_BASE + 0x00000800)
+#define GPIOB_BASE                              (APB2PERIPH_BASE + 0x00000C00)
+#define GPIOC_BASE                              (APB2PERIPH_BASE + 0x00001000)
+#define GPIOD_BASE                              (APB2PERIPH_BASE + 0x00001400)
+#define GPIOE_BASE                              (APB2PERIPH_BASE + 0x00001800)
+
+/** GPIO Peripherals' fake registers, so that logic can access them.          */
+#define GPIOA                                     ((GPIO_TypeDef *) GPIOA_BASE)
+#define GPIOB                                     ((GPIO_TypeDef *) GPIOB_BASE)
+#define GPIOC                                     ((GPIO_TypeDef *) GPIOC_BASE)
+#define GPIOD                                     ((GPIO_TypeDef *) GPIOD_BASE)
+#define GPIOE                                     ((GPIO_TypeDef *) GPIOE_BASE)
+
+#define GPIOA_Regs                                                      (*GPIOA)
+#define GPIOB_Regs                                                      (*GPIOB)
+#define GPIOC_Regs                                                      (*GPIOC)
+#define GPIOD_Regs                                                      (*GPIOD)
+#define GPIOE_Regs                                                      (*GPIOE)
 
 typedef struct
 {
@@ -94,6 +125,10 @@ typedef enum
 #define  GPIO_PULLUP                                                 0x00000001u  /*!< Pull-up activation                  */
 #define  GPIO_PULLDOWN                                               0x00000002u  /*!< Pull-down activation                */
 
+/** Checks and clears the pending flags of some EXTI lines, one bit per line. */
+#define __HAL_GPIO_EXTI_GET_IT(__EXTI_LINE__)       (EXTI->PR & (__EXTI_LINE__))
+#define __HAL_GPIO_EXTI_CLEAR_IT(__EXTI_LINE__)     (EXTI->PR = (__EXTI_LINE__))
+
 /*******************************************************************************
  * API
  ******************************************************************************/
@@ -0,0 +1,36 @@
+/**
+ * @file stm32f1xx_hal_pwr.h
+ * @brief Header file for mocking the stm32f1xx_hal_pwr sdk module.
+ */
+
+#ifndef __STM32F1xx_HAL_PWR_H
+#define __STM32F1xx_HAL_PWR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "stm32f1xx_hal_def.h"
+
+/*******************************************************************************
+ * DEFINITIONS
+ ******************************************************************************/
+#define PWR_MAINREGULATOR_ON                                         0x00000000U
+#define PWR_LOWPOWERREGULATOR_ON                                     0x00000001U
+
+#define PWR_SLEEPENTRY_WFI                                      ((uint8_t)0x01)
+#define PWR_SLEEPENTRY_WFE                                      ((uint8_t)0x02)
+
+/*******************************************************************************
+ * API
+ ******************************************************************************/
+void HAL_PWR_EnterSLEEPMode(uint32_t Regulator, uint8_t SLEEPEntry);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
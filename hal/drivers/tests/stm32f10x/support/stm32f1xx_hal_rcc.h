@@ -28,10 +28,16 @@ void __HAL_RCC_GPIOC_CLK_ENABLE(void);
 void __HAL_RCC_GPIOD_CLK_ENABLE(void);
 void __HAL_RCC_GPIOE_CLK_ENABLE(void);
 
+void __HAL_RCC_TIM1_CLK_ENABLE(void);
+void __HAL_RCC_TIM2_CLK_ENABLE(void);
 void __HAL_RCC_TIM3_CLK_ENABLE(void);
 void __HAL_RCC_TIM4_CLK_ENABLE(void);
 
+void __HAL_RCC_DMA1_CLK_ENABLE(void);
+
+uint32_t HAL_RCC_GetHCLKFreq(void);
 uint32_t HAL_RCC_GetPCLK1Freq(void);
+uint32_t HAL_RCC_GetPCLK2Freq(void);
 
 #ifdef __cplusplus
 }
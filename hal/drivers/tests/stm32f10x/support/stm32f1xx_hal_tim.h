@@ -19,11 +19,57 @@ extern "C" {
  * DEFINITIONS
  ******************************************************************************/
 /** TIM - Register Layout Typedef                                             */
-typedef void * TIM_TypeDef;
-
-/** TIM Peripherals' fake addresses                                           */
-#define TIM3                                          ((TIM_TypeDef) 0x12345678)
-#define TIM4                                          ((TIM_TypeDef) 0x9ABCDEF0)
+typedef struct
+{
+  volatile uint32_t CR1;
+  volatile uint32_t CR2;
+  volatile uint32_t SMCR;
+  volatile uint32_t DIER;
+  volatile uint32_t SR;
+  volatile uint32_t EGR;
+  volatile uint32_t CCMR1;
+  volatile uint32_t CCMR2;
+  volatile uint32_t CCER;
+  volatile uint32_t CNT;
+  volatile uint32_t PSC;
+  volatile uint32_t ARR;
+  volatile uint32_t RCR;
+  volatile uint32_t CCR1;
+  volatile uint32_t CCR2;
+  volatile uint32_t CCR3;
+  volatile uint32_t CCR4;
+  volatile uint32_t BDTR;
+  volatile uint32_t DCR;
+  volatile uint32_t DMAR;
+  volatile uint32_t OR;
+} TIM_TypeDef;
+
+/** TIM Peripherals' fake registers, so that logic can access them.           */
+extern TIM_TypeDef TIM1_Regs;
+extern TIM_TypeDef TIM2_Regs;
+extern TIM_TypeDef TIM3_Regs;
+extern TIM_TypeDef TIM4_Regs;
+
+#define TIM1                                                        (&TIM1_Regs)
+#define TIM2                                                        (&TIM2_Regs)
+#define TIM3                                                        (&TIM3_Regs)
+#define TIM4                                                        (&TIM4_Regs)
+
+/** TIM Register bits                                                         */
+#define TIM_CR1_CEN                                                   (1U << 0)
+#define TIM_CR1_UDIS                                                  (1U << 1)
+#define TIM_CR1_URS                                                   (1U << 2)
+#define TIM_CR1_OPM                                                   (1U << 3)
+#define TIM_CR1_ARPE                                                  (1U << 7)
+#define TIM_DIER_UIE                                                  (1U << 0)
+#define TIM_DIER_UDE                                                  (1U << 8)
+#define TIM_SR_UIF                                                    (1U << 0)
+#define TIM_SR_CC1IF                                                  (1U << 1)
+#define TIM_SR_CC2IF                                                  (1U << 2)
+#define TIM_SR_CC3IF                                                  (1U << 3)
+#define TIM_SR_CC4IF                                                  (1U << 4)
+#define TIM_CCER_CC1P                                                 (1U << 1)
+#define TIM_EGR_UG                                                    (1U << 0)
 
 typedef struct
 {
@@ -65,6 +111,36 @@ typedef struct
                                  This parameter can be a number between Min_Data = 0x0 and Max_Data = 0xF */
 } TIM_ClockConfigTypeDef;
 
+typedef struct
+{
+  uint32_t OCMode;        /*!< Specifies the TIM mode.
+                               This parameter can be a value of @ref TIM_Output_Compare_and_PWM_modes */
+  uint32_t Pulse;         /*!< Specifies the pulse value to be loaded into the Capture Compare Register.
+                               This parameter can be a number between Min_Data = 0x0000 and Max_Data = 0xFFFF */
+  uint32_t OCPolarity;    /*!< Specifies the output polarity.
+                               This parameter can be a value of @ref TIM_Output_Compare_Polarity */
+  uint32_t OCNPolarity;   /*!< Specifies the complementary output polarity.
+                               This parameter can be a value of @ref TIM_Output_Compare_N_Polarity */
+  uint32_t OCFastMode;    /*!< Specifies the Fast mode state.
+                               This parameter can be a value of @ref TIM_Output_Fast_State */
+  uint32_t OCIdleState;   /*!< Specifies the TIM Output Compare pin state during Idle state.
+                               This parameter can be a value of @ref TIM_Output_Compare_Idle_State */
+  uint32_t OCNIdleState;  /*!< Specifies the TIM Output Compare pin state during Idle state.
+                               This parameter can be a value of @ref TIM_Output_Compare_N_Idle_State */
+} TIM_OC_InitTypeDef;
+
+typedef struct
+{
+  uint32_t ICPolarity;    /*!< Specifies the active edge of the input signal.
+                               This parameter can be a value of @ref TIM_Input_Capture_Polarity */
+  uint32_t ICSelection;   /*!< Specifies the input.
+                               This parameter can be a value of @ref TIM_Input_Capture_Selection */
+  uint32_t ICPrescaler;   /*!< Specifies the Input Capture Prescaler.
+                               This parameter can be a value of @ref TIM_Input_Capture_Prescaler */
+  uint32_t ICFilter;      /*!< Specifies the input capture filter.
+                               This parameter can be a number between Min_Data = 0x0 and Max_Data = 0xF */
+} TIM_IC_InitTypeDef;
+
 typedef enum
 {
   HAL_TIM_STATE_RESET             = 0x00U,    /*!< Peripheral not yet initialized or disabled  */
@@ -89,13 +165,66 @@ typedef struct
 #define TIM_AUTORELOAD_PRELOAD_DISABLE                                         6
 #define TIM_AUTORELOAD_PRELOAD_ENABLE                                          7
 
+#define TIM_CHANNEL_1                                                 0x00000000
+#define TIM_CHANNEL_2                                                 0x00000004
+#define TIM_CHANNEL_3                                                 0x00000008
+#define TIM_CHANNEL_4                                                 0x0000000C
+
+#define TIM_OCMODE_PWM1                                               0x00000060
+#define TIM_OCPOLARITY_HIGH                                           0x00000000
+#define TIM_OCNPOLARITY_HIGH                                          0x00000000
+#define TIM_OCFAST_DISABLE                                            0x00000000
+#define TIM_OCIDLESTATE_RESET                                         0x00000000
+#define TIM_OCNIDLESTATE_RESET                                        0x00000000
+
+#define TIM_ICPOLARITY_RISING                                         0x00000000
+#define TIM_ICPOLARITY_FALLING                                     TIM_CCER_CC1P
+#define TIM_ICSELECTION_DIRECTTI                                      0x00000001
+#define TIM_ICPSC_DIV1                                                0x00000000
+
+#define TIM_FLAG_UPDATE                                               TIM_SR_UIF
+#define TIM_IT_UPDATE                                               TIM_DIER_UIE
+#define TIM_DMA_UPDATE                                              TIM_DIER_UDE
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+#define __HAL_TIM_GET_FLAG(__HANDLE__, __FLAG__)          (((__HANDLE__)->Instance->SR &(__FLAG__)) == (__FLAG__))
+#define __HAL_TIM_CLEAR_FLAG(__HANDLE__, __FLAG__)        ((__HANDLE__)->Instance->SR = ~(__FLAG__))
+#define __HAL_TIM_ENABLE_IT(__HANDLE__, __INTERRUPT__)    ((__HANDLE__)->Instance->DIER |= (__INTERRUPT__))
+#define __HAL_TIM_DISABLE_IT(__HANDLE__, __INTERRUPT__)   ((__HANDLE__)->Instance->DIER &= ~(__INTERRUPT__))
+#define __HAL_TIM_ENABLE_DMA(__HANDLE__, __DMA__)         ((__HANDLE__)->Instance->DIER |= (__DMA__))
+#define __HAL_TIM_DISABLE_DMA(__HANDLE__, __DMA__)        ((__HANDLE__)->Instance->DIER &= ~(__DMA__))
+#define __HAL_TIM_GET_COUNTER(__HANDLE__)                 ((__HANDLE__)->Instance->CNT)
+#define __HAL_TIM_SET_AUTORELOAD(__HANDLE__, __AUTORELOAD__)                   \
+  do{                                                                          \
+    (__HANDLE__)->Instance->ARR = (__AUTORELOAD__);                            \
+    (__HANDLE__)->Init.Period = (__AUTORELOAD__);                              \
+  } while(0)
+#define __HAL_TIM_SET_COMPARE(__HANDLE__, __CHANNEL__, __COMPARE__)            \
+  (*(volatile uint32_t *)(&((__HANDLE__)->Instance->CCR1) + ((__CHANNEL__) >> 2U)) = (__COMPARE__))
+#define __HAL_TIM_GET_COMPARE(__HANDLE__, __CHANNEL__)                         \
+  (*(volatile uint32_t *)(&((__HANDLE__)->Instance->CCR1) + ((__CHANNEL__) >> 2U)))
+
 /*******************************************************************************
  * API
  ******************************************************************************/
 HAL_StatusTypeDef HAL_TIM_Base_Init(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_TIM_Base_Start(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_TIM_Base_Stop(TIM_HandleTypeDef *htim);
 HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef *htim);
 HAL_StatusTypeDef HAL_TIM_Base_Stop_IT(TIM_HandleTypeDef *htim);
 
+HAL_StatusTypeDef HAL_TIM_PWM_Init(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_TIM_PWM_ConfigChannel(TIM_HandleTypeDef *htim, TIM_OC_InitTypeDef *sConfig, uint32_t Channel);
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef *htim, uint32_t Channel);
+HAL_StatusTypeDef HAL_TIM_PWM_Stop(TIM_HandleTypeDef *htim, uint32_t Channel);
+
+HAL_StatusTypeDef HAL_TIM_IC_Init(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_TIM_IC_ConfigChannel(TIM_HandleTypeDef *htim, TIM_IC_InitTypeDef *sConfig, uint32_t Channel);
+HAL_StatusTypeDef HAL_TIM_IC_Start_IT(TIM_HandleTypeDef *htim, uint32_t Channel);
+HAL_StatusTypeDef HAL_TIM_IC_Stop_IT(TIM_HandleTypeDef *htim, uint32_t Channel);
+
 void HAL_TIM_IRQHandler(TIM_HandleTypeDef *htim);
 
 /*******************************************************************************
@@ -0,0 +1,29 @@
+/**
+ * @file stm32f1xx_periph.c
+ * @brief Source file holding the fake peripheral registers that the mocked
+ *          sdk modules point their peripheral instances to.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "stm32f1xx_hal.h"
+
+/*******************************************************************************
+ * FAKE REGISTERS
+ ******************************************************************************/
+TIM_TypeDef TIM1_Regs;
+TIM_TypeDef TIM2_Regs;
+TIM_TypeDef TIM3_Regs;
+TIM_TypeDef TIM4_Regs;
+DMA_Channel_TypeDef DMA1_Channel1_Regs;
+DMA_Channel_TypeDef DMA1_Channel2_Regs;
+DMA_Channel_TypeDef DMA1_Channel3_Regs;
+DMA_Channel_TypeDef DMA1_Channel4_Regs;
+DMA_Channel_TypeDef DMA1_Channel5_Regs;
+DMA_Channel_TypeDef DMA1_Channel6_Regs;
+DMA_Channel_TypeDef DMA1_Channel7_Regs;
+SysTick_Type SysTick_Regs;
+SCB_Type SCB_Regs;
+uint32_t PERIPH_Mem[PERIPH_MEM_SIZE / 4];
+uint32_t PERIPH_BB_Mem[PERIPH_MEM_SIZE * 8];
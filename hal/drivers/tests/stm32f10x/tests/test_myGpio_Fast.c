@@ -0,0 +1,214 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test_myGpio_Fast.c
+ * @brief Test file for testing gpio driver logic, operation of the compile
+ *          time resolved fast path, checked on the registers and on the code
+ *          it compiles into.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+#include "myTestCode.h"
+
+#include "myGpio.h"
+#include "myGpioFast.h"
+#include "myDriverDefs.h"
+
+#include "mock_stm32f1xx_hal.h"
+#include "mock_stm32f1xx_hal_gpio.h"
+#include "mock_stm32f1xx_hal_rcc.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_MY_GPIO_PORT                                        myDriverPort_PB
+#define TEST_MY_GPIO_PIN                                          myDriverPin_09
+#define TEST_MY_GPIO_REGS                                             GPIOB_Regs
+#define TEST_MY_GPIO_MASK                                              (1U << 9)
+
+/* Each probe holds nothing but a single path, and is kept out of line so     */
+/*  that its code can be inspected.                                           */
+#define TEST_PROBE                                     __attribute__((noinline))
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+void probeFastSet(void);
+void probeFastClear(void);
+void probeFastToggle(void);
+myGpioLvl_t probeFastGet(void);
+void probeHandleSet(void);
+
+static void inspect(const char * name, const char * symbol, myTestCode_t * code);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static myGpioPin_t pin;
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  myGpioPars_t pars = { TEST_MY_GPIO_PORT, TEST_MY_GPIO_PIN, myGpioDir_Outp, myGpioPull_No };
+
+  myGpio_Reset();
+  myGpio_Init(&pin, &pars);
+  TEST_MY_GPIO_REGS = (GPIO_TypeDef) { 0 };
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief Each port constant should resolve to the registers of its port.
+ */
+void test_BaseResolvesEachPort(void)
+{
+  TEST_ASSERT_EQUAL_PTR(GPIOA, myGpioFast_Base(myDriverPort_PA));
+  TEST_ASSERT_EQUAL_PTR(GPIOB, myGpioFast_Base(myDriverPort_PB));
+  TEST_ASSERT_EQUAL_PTR(GPIOC, myGpioFast_Base(myDriverPort_PC));
+  TEST_ASSERT_EQUAL_PTR(GPIOD, myGpioFast_Base(myDriverPort_PD));
+  TEST_ASSERT_EQUAL_PTR(GPIOE, myGpioFast_Base(myDriverPort_PE));
+}
+
+/**
+ * @brief Set and clear should each store the pin mask to their own register,
+ *          with no call into the sdk.
+ */
+void test_SetAndClearStoreThePinMask(void)
+{
+  probeFastSet();
+  TEST_ASSERT_EQUAL_HEX32(TEST_MY_GPIO_MASK, TEST_MY_GPIO_REGS.BSRR);
+
+  probeFastClear();
+  TEST_ASSERT_EQUAL_HEX32(TEST_MY_GPIO_MASK, TEST_MY_GPIO_REGS.BRR);
+
+  TEST_ASSERT_EQUAL_HEX32(0, TEST_MY_GPIO_REGS.ODR);
+  TEST_ASSERT_NOT_CALLED(HAL_GPIO_WritePin);
+}
+
+/**
+ * @brief Toggle should set a pin that is low, and reset a pin that is high,
+ *          through BSRR.
+ */
+void test_ToggleStoresTheOtherLevelToBSRR(void)
+{
+  TEST_MY_GPIO_REGS.ODR = ~TEST_MY_GPIO_MASK;
+  probeFastToggle();
+  TEST_ASSERT_EQUAL_HEX32(TEST_MY_GPIO_MASK, TEST_MY_GPIO_REGS.BSRR);
+
+  TEST_MY_GPIO_REGS.ODR = TEST_MY_GPIO_MASK;
+  probeFastToggle();
+  TEST_ASSERT_EQUAL_HEX32(TEST_MY_GPIO_MASK << 16, TEST_MY_GPIO_REGS.BSRR);
+  TEST_ASSERT_NOT_CALLED(HAL_GPIO_TogglePin);
+}
+
+/**
+ * @brief Writing a level should store to the same register as setting or
+ *          clearing the pin.
+ */
+void test_WriteStoresToSetOrClear(void)
+{
+  myGpioFast_Write(TEST_MY_GPIO_PORT, TEST_MY_GPIO_PIN, myGpioLvl_Hi);
+  TEST_ASSERT_EQUAL_HEX32(TEST_MY_GPIO_MASK, TEST_MY_GPIO_REGS.BSRR);
+  TEST_ASSERT_EQUAL_HEX32(0, TEST_MY_GPIO_REGS.BRR);
+
+  myGpioFast_Write(TEST_MY_GPIO_PORT, TEST_MY_GPIO_PIN, myGpioLvl_Lo);
+  TEST_ASSERT_EQUAL_HEX32(TEST_MY_GPIO_MASK, TEST_MY_GPIO_REGS.BRR);
+}
+
+/**
+ * @brief Getting a pin should read its bit from IDR.
+ */
+void test_GetReadsThePinFromIDR(void)
+{
+  TEST_MY_GPIO_REGS.IDR = ~TEST_MY_GPIO_MASK;
+  TEST_ASSERT_EQUAL(myGpioLvl_Lo, probeFastGet());
+
+  TEST_MY_GPIO_REGS.IDR = TEST_MY_GPIO_MASK;
+  TEST_ASSERT_EQUAL(myGpioLvl_Hi, probeFastGet());
+  TEST_ASSERT_NOT_CALLED(HAL_GPIO_ReadPin);
+}
+
+/**
+ * @brief Set and clear should each compile into a single store and a return,
+ *          and toggle should take no call either, while the handle path calls
+ *          into the driver. The counts are for the host, and printed so that
+ *          the paths can be compared.
+ */
+void test_FastPathCompilesIntoASingleStore(void)
+{
+  myTestCode_t set, clear, toggle, get, handle, driver;
+
+  inspect("fast set", "probeFastSet", &set);
+  inspect("fast clear", "probeFastClear", &clear);
+  inspect("fast toggle", "probeFastToggle", &toggle);
+  inspect("fast get", "probeFastGet", &get);
+  inspect("handle set", "probeHandleSet", &handle);
+  inspect("myGpio_Set", "myGpio_Set", &driver);
+
+  TEST_ASSERT_EQUAL(2, set.instructions);
+  TEST_ASSERT_EQUAL(2, clear.instructions);
+  TEST_ASSERT_EQUAL(0, set.calls + clear.calls + toggle.calls + get.calls);
+  TEST_ASSERT_GREATER_THAN(0, handle.calls);
+  TEST_ASSERT_GREATER_THAN(set.instructions, handle.instructions + driver.instructions);
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+TEST_PROBE void probeFastSet(void)
+{
+  myGpioFast_Set(TEST_MY_GPIO_PORT, TEST_MY_GPIO_PIN);
+}
+
+TEST_PROBE void probeFastClear(void)
+{
+  myGpioFast_Clear(TEST_MY_GPIO_PORT, TEST_MY_GPIO_PIN);
+}
+
+TEST_PROBE void probeFastToggle(void)
+{
+  myGpioFast_Toggle(TEST_MY_GPIO_PORT, TEST_MY_GPIO_PIN);
+}
+
+TEST_PROBE myGpioLvl_t probeFastGet(void)
+{
+  return myGpioFast_Get(TEST_MY_GPIO_PORT, TEST_MY_GPIO_PIN);
+}
+
+TEST_PROBE void probeHandleSet(void)
+{
+  myGpio_Set(pin, myGpioLvl_Hi);
+}
+
+static void inspect(const char * name, const char * symbol, myTestCode_t * code)
+{
+  if(myTestCode_Inspect(symbol, code) != myRet_OK) { TEST_IGNORE_MESSAGE("Cannot disassemble the test executable."); }
+
+  printf("%-12s %2u instructions, %u calls\n", name, code->instructions, code->calls);
+}
@@ -0,0 +1,268 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test_myGpio_Irq.c
+ * @brief Test file for testing gpio driver logic, operation when pins are
+ *          initialized with interrupts, and when their EXTI lines fire.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+
+#include "myGpio.h"
+#include "myDriverDefs.h"
+
+#include "mock_stm32f1xx_hal.h"
+#include "mock_stm32f1xx_hal_gpio.h"
+#include "mock_stm32f1xx_hal_rcc.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_MY_GPIO_PORT                                        myDriverPort_PB
+#define TEST_MY_GPIO_PIN_A                                        myDriverPin_05
+#define TEST_MY_GPIO_PIN_B                                        myDriverPin_08
+#define TEST_MY_GPIO_PIN_C                                        myDriverPin_00
+
+#define TEST_CALLS_MAX                                                       (8)
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static void callbackA(void);
+static void callbackB(void);
+static void callbackC(void);
+static void HAL_GPIO_Init_Custom(GPIO_TypeDef * GPIOx, GPIO_InitTypeDef * GPIO_Init);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static myGpioPin_t pin;
+static myGpioPars_t pars;
+static GPIO_InitTypeDef gpioCfg;
+
+static myCbk_t calls[TEST_CALLS_MAX];
+static uint32_t callCount;
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  myGpio_Reset();
+  EXTI_Regs = (EXTI_TypeDef) { 0 };
+
+  pars = (myGpioPars_t) { TEST_MY_GPIO_PORT, TEST_MY_GPIO_PIN_A, myGpioDir_Inpt, myGpioPull_Up, myGpioIrq_Fall, callbackA };
+  callCount = 0;
+
+  HAL_GPIO_Init_fake.custom_fake = HAL_GPIO_Init_Custom;
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief Only input pins can interrupt, so initializing an output pin with
+ *          an interrupt should fail.
+ */
+void test_IfPinIsOutputThenInitFails(void)
+{
+  pars.direction = myGpioDir_Outp;
+
+  TEST_ASSERT_EQUAL(myRet_Fail, myGpio_Init(&pin, &pars));
+  TEST_ASSERT_NOT_CALLED(HAL_GPIO_Init);
+}
+
+/**
+ * @brief An interrupt without a callback is useless, so init should fail.
+ */
+void test_IfCallbackIsNullThenInitFails(void)
+{
+  pars.cbk = NULL;
+
+  TEST_ASSERT_EQUAL(myRet_Fail, myGpio_Init(&pin, &pars));
+  TEST_ASSERT_NOT_CALLED(HAL_GPIO_Init);
+}
+
+/**
+ * @brief EXTI only detects edges, so init should fail for level triggers.
+ */
+void test_IfTriggerIsLevelThenInitFails(void)
+{
+  pars.irq = myGpioIrq_Low;
+  TEST_ASSERT_EQUAL(myRet_Fail, myGpio_Init(&pin, &pars));
+
+  pars.irq = myGpioIrq_High;
+  TEST_ASSERT_EQUAL(myRet_Fail, myGpio_Init(&pin, &pars));
+
+  TEST_ASSERT_NOT_CALLED(HAL_GPIO_Init);
+}
+
+/**
+ * @brief Pins of the same number share their EXTI line, so init should fail
+ *          for a second one that interrupts.
+ */
+void test_IfLineIsTakenThenInitFails(void)
+{
+  TEST_ASSERT_EQUAL(myRet_OK, myGpio_Init(&pin, &pars));
+
+  pars.port = myDriverPort_PC;
+  TEST_ASSERT_EQUAL(myRet_Fail, myGpio_Init(&pin, &pars));
+  TEST_ASSERT_EQUAL(1, HAL_GPIO_Init_fake.call_count);
+}
+
+/**
+ * @brief A pin without interrupt should be initialized as a plain input.
+ */
+void test_IfPinHasNoIrqThenInterruptIsNotConfigured(void)
+{
+  pars.irq = myGpioIrq_None;
+  pars.cbk = NULL;
+
+  TEST_ASSERT_EQUAL(myRet_OK, myGpio_Init(&pin, &pars));
+  TEST_ASSERT_EQUAL_HEX32(GPIO_MODE_INPUT, gpioCfg.Mode);
+  TEST_ASSERT_NOT_CALLED(HAL_NVIC_EnableIRQ);
+}
+
+/**
+ * @brief Init should configure the pin in interrupt mode, clear any stale
+ *          flag of its line and enable the vector that serves it.
+ */
+void test_InitConfiguresPinInterruptAndEnablesLineIrq(void)
+{
+  EXTI_Regs.PR = 0;
+
+  TEST_ASSERT_EQUAL(myRet_OK, myGpio_Init(&pin, &pars));
+
+  TEST_ASSERT_CALLED(HAL_GPIO_Init);
+  TEST_ASSERT_EQUAL_PTR(GPIOB, HAL_GPIO_Init_fake.arg0_val);
+  TEST_ASSERT_EQUAL_HEX32(GPIO_MODE_IT_FALLING, gpioCfg.Mode);
+  TEST_ASSERT_EQUAL_HEX32(GPIO_PULLUP, gpioCfg.Pull);
+  TEST_ASSERT_EQUAL_HEX32(1U << TEST_MY_GPIO_PIN_A, EXTI_Regs.PR);
+
+  TEST_ASSERT_CALLED(HAL_NVIC_EnableIRQ);
+  TEST_ASSERT_EQUAL(EXTI9_5_IRQn, HAL_NVIC_EnableIRQ_fake.arg0_val);
+}
+
+/**
+ * @brief Each edge trigger should be translated to its HAL mode.
+ */
+void test_EachTriggerIsTranslatedToItsHalMode(void)
+{
+  const myGpioIrq_t irqs[] = { myGpioIrq_Rise, myGpioIrq_Fall, myGpioIrq_Both };
+  const uint32_t modes[] = { GPIO_MODE_IT_RISING, GPIO_MODE_IT_FALLING, GPIO_MODE_IT_RISING_FALLING };
+  uint32_t idx;
+
+  for(idx = 0; idx < sizeof(irqs) / sizeof(irqs[0]); idx++)
+  {
+    myGpio_Reset();
+    pars.irq = irqs[idx];
+
+    TEST_ASSERT_EQUAL(myRet_OK, myGpio_Init(&pin, &pars));
+    TEST_ASSERT_EQUAL_HEX32(modes[idx], gpioCfg.Mode);
+  }
+}
+
+/**
+ * @brief The routine should call back the line that fired, and clear it by
+ *          writing its bit to the pending register.
+ */
+void test_IfLineFiresThenItsCallbackIsCalled(void)
+{
+  myGpio_Init(&pin, &pars);
+
+  EXTI_Regs.PR = (1U << TEST_MY_GPIO_PIN_A);
+  EXTI9_5_IRQHandler();
+
+  TEST_ASSERT_EQUAL(1, callCount);
+  TEST_ASSERT_EQUAL_PTR(callbackA, calls[0]);
+  TEST_ASSERT_EQUAL_HEX32(1U << TEST_MY_GPIO_PIN_A, EXTI_Regs.PR);
+}
+
+/**
+ * @brief If several lines of a shared vector fire together, all of them
+ *          should be called back from a single run, highest line first.
+ */
+void test_IfSeveralLinesFireThenAllAreCalledBack(void)
+{
+  myGpio_Init(&pin, &pars);
+  pars.pin = TEST_MY_GPIO_PIN_B;
+  pars.cbk = callbackB;
+  myGpio_Init(&pin, &pars);
+
+  EXTI_Regs.PR = (1U << TEST_MY_GPIO_PIN_A) | (1U << TEST_MY_GPIO_PIN_B);
+  EXTI9_5_IRQHandler();
+
+  TEST_ASSERT_EQUAL(2, callCount);
+  TEST_ASSERT_EQUAL_PTR(callbackB, calls[0]);
+  TEST_ASSERT_EQUAL_PTR(callbackA, calls[1]);
+}
+
+/**
+ * @brief A routine should only serve its own lines, leaving the pending
+ *          lines of the other vectors for them.
+ */
+void test_EachVectorServesOnlyItsOwnLines(void)
+{
+  myGpio_Init(&pin, &pars);
+  pars.pin = TEST_MY_GPIO_PIN_C;
+  pars.cbk = callbackC;
+  myGpio_Init(&pin, &pars);
+
+  TEST_ASSERT_EQUAL(EXTI0_IRQn, HAL_NVIC_EnableIRQ_fake.arg0_val);
+
+  EXTI_Regs.PR = (1U << TEST_MY_GPIO_PIN_A) | (1U << TEST_MY_GPIO_PIN_C);
+  EXTI0_IRQHandler();
+
+  TEST_ASSERT_EQUAL(1, callCount);
+  TEST_ASSERT_EQUAL_PTR(callbackC, calls[0]);
+  TEST_ASSERT_EQUAL_HEX32(1U << TEST_MY_GPIO_PIN_C, EXTI_Regs.PR);
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static void HAL_GPIO_Init_Custom(GPIO_TypeDef * GPIOx, GPIO_InitTypeDef * GPIO_Init)
+{
+  (void) GPIOx;
+  gpioCfg = *GPIO_Init;
+}
+
+static void callbackA(void)
+{
+  if(callCount < TEST_CALLS_MAX) { calls[callCount] = callbackA; }
+  callCount++;
+}
+
+static void callbackB(void)
+{
+  if(callCount < TEST_CALLS_MAX) { calls[callCount] = callbackB; }
+  callCount++;
+}
+
+static void callbackC(void)
+{
+  if(callCount < TEST_CALLS_MAX) { calls[callCount] = callbackC; }
+  callCount++;
+}
@@ -0,0 +1,174 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test_myGpio_Port.c
+ * @brief Test file for testing gpio driver logic, operation when groups of
+ *          pins are initialized, read and written, checked on the registers.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+
+#include "myGpio.h"
+#include "myDriverDefs.h"
+
+#include "mock_stm32f1xx_hal.h"
+#include "mock_stm32f1xx_hal_gpio.h"
+#include "mock_stm32f1xx_hal_rcc.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_MY_GPIO_PORT                                        myDriverPort_PB
+#define TEST_MY_GPIO_REGS                                             GPIOB_Regs
+#define TEST_MY_GPIO_MASK                                               (0xF300)
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static void initializePort(void);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static myGpioPort_t port;
+static myGpioPortPars_t pars;
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  myGpio_Reset();
+  TEST_MY_GPIO_REGS = (GPIO_TypeDef) { 0 };
+  initializePort();
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief A group with no pins, with pins the port does not have, or on a port
+ *          that does not exist, should not be initialized.
+ */
+void test_IfParsAreInvalidThenInitFails(void)
+{
+  myGpioPort_t other;
+  myGpioPortPars_t otherPars = pars;
+
+  otherPars.mask = 0;
+  TEST_ASSERT_EQUAL(myRet_Fail, myGpio_InitPort(&other, &otherPars));
+
+  otherPars.mask = 0x10000;
+  TEST_ASSERT_EQUAL(myRet_Fail, myGpio_InitPort(&other, &otherPars));
+
+  otherPars = pars;
+  otherPars.port = myDriverPort_PE + 1;
+  TEST_ASSERT_EQUAL(myRet_Fail, myGpio_InitPort(&other, &otherPars));
+
+  TEST_ASSERT_EQUAL(myRet_Fail, myGpio_InitPort(NULL, &pars));
+  TEST_ASSERT_EQUAL(myRet_Fail, myGpio_InitPort(&other, NULL));
+}
+
+/**
+ * @brief All the pins of the group should be configured by a single call.
+ */
+void test_InitConfiguresAllPinsAtOnce(void)
+{
+  TEST_ASSERT_CALLED_TIMES(1, HAL_GPIO_Init);
+  TEST_ASSERT_EQUAL_PTR(GPIOB, HAL_GPIO_Init_fake.arg0_val);
+}
+
+/**
+ * @brief Setting pins should be a single store to the lower half of BSRR,
+ *          restricted to the group, with no call into the sdk.
+ */
+void test_SetMaskWritesBSRR(void)
+{
+  TEST_ASSERT_EQUAL(myRet_OK, myGpio_SetMask(port, 0xFFFFFFFF));
+
+  TEST_ASSERT_EQUAL_HEX32(TEST_MY_GPIO_MASK, TEST_MY_GPIO_REGS.BSRR);
+  TEST_ASSERT_EQUAL_HEX32(0, TEST_MY_GPIO_REGS.ODR);
+  TEST_ASSERT_NOT_CALLED(HAL_GPIO_WritePin);
+}
+
+/**
+ * @brief Clearing pins should be a single store to BRR.
+ */
+void test_ClearMaskWritesBRR(void)
+{
+  TEST_ASSERT_EQUAL(myRet_OK, myGpio_ClearMask(port, 0x1100));
+
+  TEST_ASSERT_EQUAL_HEX32(0x1100, TEST_MY_GPIO_REGS.BRR);
+  TEST_ASSERT_EQUAL_HEX32(0, TEST_MY_GPIO_REGS.BSRR);
+}
+
+/**
+ * @brief Toggling pins should set the ones that are low and reset the ones
+ *          that are high, in a single store to BSRR.
+ */
+void test_ToggleMaskWritesBSRRFromODR(void)
+{
+  TEST_MY_GPIO_REGS.ODR = 0x5100;
+
+  TEST_ASSERT_EQUAL(myRet_OK, myGpio_ToggleMask(port, 0x03F0));
+
+  TEST_ASSERT_EQUAL_HEX32(0x01000200, TEST_MY_GPIO_REGS.BSRR);
+  TEST_ASSERT_NOT_CALLED(HAL_GPIO_TogglePin);
+}
+
+/**
+ * @brief Writing the group should set its high pins and reset its low ones,
+ *          in a single store to BSRR.
+ */
+void test_WritePortSetsAndResetsTheGroup(void)
+{
+  TEST_ASSERT_EQUAL(myRet_OK, myGpio_WritePort(port, 0x5200));
+
+  TEST_ASSERT_EQUAL_HEX32(0xA1005200, TEST_MY_GPIO_REGS.BSRR);
+}
+
+/**
+ * @brief Reading the group should be a single load of IDR, masked.
+ */
+void test_GetPortReadsIDR(void)
+{
+  TEST_MY_GPIO_REGS.IDR = 0xA2FF;
+
+  TEST_ASSERT_EQUAL_HEX32(0xA200, myGpio_GetPort(port));
+  TEST_ASSERT_NOT_CALLED(HAL_GPIO_ReadPin);
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static void initializePort(void)
+{
+  pars.port = TEST_MY_GPIO_PORT;
+  pars.mask = TEST_MY_GPIO_MASK;
+  pars.direction = myGpioDir_Outp;
+  pars.pull = myGpioPull_No;
+
+  myGpio_InitPort(&port, &pars);
+}
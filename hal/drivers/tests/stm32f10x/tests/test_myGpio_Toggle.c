@@ -0,0 +1,105 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test_myGpio_Toggle.c
+ * @brief Test file for testing gpio driver logic, operation when
+ *          myGpio_Toggle is called, after correct initialization.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+#include "myTestCode.h"
+
+#include "myGpio.h"
+#include "myDriverDefs.h"
+
+#include "mock_stm32f1xx_hal.h"
+#include "mock_stm32f1xx_hal_gpio.h"
+#include "mock_stm32f1xx_hal_rcc.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_MY_GPIO_PORT                                        myDriverPort_PB
+#define TEST_MY_GPIO_PIN                                          myDriverPin_09
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static myGpioPin_t pin;
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  myGpioPars_t pars = { TEST_MY_GPIO_PORT, TEST_MY_GPIO_PIN, myGpioDir_Outp, myGpioPull_No };
+
+  myGpio_Reset();
+  myGpio_Init(&pin, &pars);
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief Toggling a pin that was not initialized should fail.
+ */
+void test_IfPinIsInvalidThenToggleFails(void)
+{
+  TEST_ASSERT_EQUAL(myRet_Fail, myGpio_Toggle(NULL));
+  TEST_ASSERT_NOT_CALLED(HAL_GPIO_TogglePin);
+}
+
+/**
+ * @brief myGpio_Toggle logic should call HAL_GPIO_TogglePin with the correct
+ *          GPIO pointer and the mask of the pin.
+ */
+void test_LogicCallsHALGPIOTogglePin(void)
+{
+  TEST_ASSERT_EQUAL(myRet_OK, myGpio_Toggle(pin));
+
+  TEST_ASSERT_CALLED(HAL_GPIO_TogglePin);
+  TEST_ASSERT_EQUAL_PTR(GPIOB, HAL_GPIO_TogglePin_fake.arg0_val);
+  TEST_ASSERT_EQUAL_HEX16(1U << TEST_MY_GPIO_PIN, HAL_GPIO_TogglePin_fake.arg1_val);
+}
+
+/**
+ * @brief Measures the code of a toggle through the HAL, to compare with the
+ *          bit-band backend. The HAL routine itself is faked on the host, so
+ *          its own instructions come on top of the ones printed.
+ */
+void test_BenchmarkToggle(void)
+{
+  myTestCode_t code;
+
+  if(myTestCode_Inspect("myGpio_Toggle", &code) != myRet_OK) { TEST_IGNORE_MESSAGE("Cannot disassemble the test executable."); }
+
+  printf("myGpio_Toggle over HAL: %u instructions, %u calls\n", code.instructions, code.calls);
+  TEST_ASSERT_EQUAL(1, code.calls);
+}
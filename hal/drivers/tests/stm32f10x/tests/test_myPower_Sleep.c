@@ -0,0 +1,86 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file test_myPower_Sleep.c
+ * @brief Test file for testing power driver logic, operation when the core is
+ *          put to sleep.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+
+#include "myPower.h"
+
+#include "mock_stm32f1xx_hal.h"
+#include "mock_stm32f1xx_hal_pwr.h"
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief Starting an idle period should mask the interrupts.
+ */
+void test_IfIdleIsEnteredThenInterruptsAreMasked(void)
+{
+  myPower_IdleEnter();
+
+  TEST_ASSERT_CALLED(__disable_irq);
+  TEST_ASSERT_NOT_CALLED(HAL_PWR_EnterSLEEPMode);
+}
+
+/**
+ * @brief Sleeping should put the core in the SLEEP mode through WFI, which
+ *          wakes up even on interrupts that are masked.
+ */
+void test_IfCoreSleepsThenSleepModeIsEnteredWithWFI(void)
+{
+  myPower_Sleep();
+
+  TEST_ASSERT_CALLED(HAL_PWR_EnterSLEEPMode);
+  TEST_ASSERT_EQUAL(PWR_MAINREGULATOR_ON, HAL_PWR_EnterSLEEPMode_fake.arg0_val);
+  TEST_ASSERT_EQUAL(PWR_SLEEPENTRY_WFI, HAL_PWR_EnterSLEEPMode_fake.arg1_val);
+}
+
+/**
+ * @brief A whole idle period should unmask the interrupts only after waking
+ *          up.
+ */
+void test_IfIdleIsExitedThenInterruptsAreUnmaskedAfterWaking(void)
+{
+  myPower_IdleEnter();
+  myPower_Sleep();
+  myPower_IdleExit();
+
+  TEST_ASSERT_CALLED_IN_ORDER(0, __disable_irq);
+  TEST_ASSERT_CALLED_IN_ORDER(1, HAL_PWR_EnterSLEEPMode);
+  TEST_ASSERT_CALLED_IN_ORDER(2, __enable_irq);
+}
@@ -27,11 +27,16 @@
 #include "myTestDefs.h"
 
 #include "myTimer.h"
+#include "myWheel.h"
+#include "myPeriod.h"
+#include "mySplit.h"
+#include "myRing.h"
 #include "myDriverDefs.h"
 
 #include "mock_stm32f1xx_hal.h"
 #include "mock_stm32f1xx_hal_tim.h"
 #include "mock_stm32f1xx_hal_rcc.h"
+#include "mock_stm32f1xx_hal_gpio.h"
 
 /*******************************************************************************
  *  PRIVATE DEFINITIONS
@@ -73,23 +78,29 @@ void tearDown(void)
  *  TESTS
  ******************************************************************************/
 /**
- * @brief When the TIM3 interrupt is triggered then driver should call the HAL's
- *          IRQ Handler logic
+ * @brief When the TIM3 interrupt is triggered by an update then driver should
+ *          call the user callback routine once, without going through the
+ *          HAL's IRQ Handler logic.
  */
-void test_IfTIM3InterruptIsCalledThenHAL_TIM_IRQHandlerIsCalled(void)
+void test_IfTIM3InterruptIsCalledThenLogicCallsUserCallbackOnce(void)
 {
+  TIM3_Regs.SR |= TIM_SR_UIF;
   TIM3_IRQHandler();
-  TEST_ASSERT_CALLED(HAL_TIM_IRQHandler);
+
+  TEST_ASSERT_EQUAL(1, callbackCallCount);
+  TEST_ASSERT_NOT_CALLED(HAL_TIM_IRQHandler);
 }
 
 /**
- * @brief When the TIM4 interrupt is triggered then driver should call the HAL's
- *          IRQ Handler logic
+ * @brief When the TIM interrupt is triggered without an update then driver
+ *          should not call the user callback routine.
  */
-void test_IfTIM4InterruptIsCalledThenHAL_TIM_IRQHandlerIsCalled(void)
+void test_IfTIM3InterruptIsCalledWithoutUpdateThenUserCallbackIsNotCalled(void)
 {
-  TIM4_IRQHandler();
-  TEST_ASSERT_CALLED(HAL_TIM_IRQHandler);
+  TIM3_Regs.SR &= ~TIM_SR_UIF;
+  TIM3_IRQHandler();
+
+  TEST_ASSERT_EQUAL(0, callbackCallCount);
 }
 
 /**
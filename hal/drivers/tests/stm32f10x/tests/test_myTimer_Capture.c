@@ -0,0 +1,310 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file test_myTimer_Capture.c
+ * @brief Test file for testing timer driver logic, operation of capture
+ *          timers.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+
+#include "myTimer.h"
+#include "myWheel.h"
+#include "myPeriod.h"
+#include "mySplit.h"
+#include "myRing.h"
+#include "myDriverDefs.h"
+
+#include "mock_stm32f1xx_hal.h"
+#include "mock_stm32f1xx_hal_tim.h"
+#include "mock_stm32f1xx_hal_rcc.h"
+#include "mock_stm32f1xx_hal_gpio.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_CLOCK_FREQ                                               (36000000)
+#define TEST_RING_SIZE                                                       (4)
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static void initCapture(myTimerEdge_t edge);
+static void captureEdge(uint32_t flags, uint32_t value);
+static void gpioInitFake(GPIO_TypeDef * GPIOx, GPIO_InitTypeDef * GPIO_Init);
+static HAL_StatusTypeDef configChannelFake(TIM_HandleTypeDef * htim, TIM_IC_InitTypeDef * sConfig, uint32_t Channel);
+static void timerCallback(void);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static myTimer_t timer = NULL;
+static myRing_t ring;
+static uint32_t storage[TEST_RING_SIZE];
+static uint32_t callbackCallCount;
+static GPIO_InitTypeDef gpioCfg;
+static TIM_IC_InitTypeDef icCfg;
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  HAL_RCC_GetPCLK1Freq_fake.return_val = TEST_CLOCK_FREQ;
+  HAL_GPIO_Init_fake.custom_fake = gpioInitFake;
+  HAL_TIM_IC_ConfigChannel_fake.custom_fake = configChannelFake;
+  myTimer_Reset();
+  myRing_Init(&ring, storage, sizeof(uint32_t), TEST_RING_SIZE);
+  timer = NULL;
+  callbackCallCount = 0;
+  gpioCfg = (GPIO_InitTypeDef) { 0 };
+  icCfg = (TIM_IC_InitTypeDef) { 0 };
+  TIM3_Regs = (TIM_TypeDef) { 0 };
+  TIM4_Regs = (TIM_TypeDef) { 0 };
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief Capture timers are latched by the TIM itself, so a virtual one
+ *          should not be initialized.
+ */
+void test_IfCaptureTimerIsVirtualThenInitFails(void)
+{
+  myTimerPars_t pars = { .mode = myTimerMode_Capture, .resource = myTimerRes_Virtual, .ring = &ring };
+
+  TEST_ASSERT_EQUAL(myRet_Fail, myTimer_Init(&timer, &pars));
+}
+
+/**
+ * @brief Timestamps have nowhere to go without a ring, so init should fail.
+ */
+void test_IfRingIsMissingThenInitFails(void)
+{
+  myTimerPars_t pars = { .mode = myTimerMode_Capture, .resource = myTimerRes_Dedicated, .channel = myDriverTimerCh_TIM4_CH2_PB7 };
+
+  TEST_ASSERT_EQUAL(myRet_Fail, myTimer_Init(&timer, &pars));
+  TEST_ASSERT_NOT_CALLED(HAL_GPIO_Init);
+}
+
+/**
+ * @brief The pin of the channel should be read as a floating input, and the
+ *          interrupt left masked until the timer is started.
+ */
+void test_IfChannelIsValidThenPinIsInput(void)
+{
+  initCapture(myTimerEdge_Rise);
+
+  TEST_ASSERT_EQUAL_PTR(GPIOB, HAL_GPIO_Init_fake.arg0_val);
+  TEST_ASSERT_EQUAL(GPIO_PIN_7, gpioCfg.Pin);
+  TEST_ASSERT_EQUAL(GPIO_MODE_INPUT, gpioCfg.Mode);
+  TEST_ASSERT_NOT_CALLED(HAL_NVIC_EnableIRQ);
+  TEST_ASSERT_EQUAL(0, myTimer_GetCaptureHz(timer));
+}
+
+/**
+ * @brief Once started, the TIM should count at full resolution through its
+ *          whole 16 bits, capture the given edge, and interrupt on it as well
+ *          as on overflows.
+ */
+void test_IfCaptureTimerIsStartedThenTIMCountsAtFullResolution(void)
+{
+  initCapture(myTimerEdge_Fall);
+
+  TEST_ASSERT_EQUAL(myRet_OK, myTimer_Start(timer, 0, NULL));
+  TEST_ASSERT_EQUAL(0, HAL_TIM_IC_Init_fake.arg0_val->Init.Prescaler);
+  TEST_ASSERT_EQUAL_HEX32(0xFFFF, HAL_TIM_IC_Init_fake.arg0_val->Init.Period);
+  TEST_ASSERT_EQUAL(TIM_ICPOLARITY_FALLING, icCfg.ICPolarity);
+  TEST_ASSERT_EQUAL(TIM_ICSELECTION_DIRECTTI, icCfg.ICSelection);
+  TEST_ASSERT_EQUAL(TIM_CHANNEL_2, HAL_TIM_IC_Start_IT_fake.arg1_val);
+  TEST_ASSERT_EQUAL_HEX32(TIM_DIER_UIE, TIM4_Regs.DIER & TIM_DIER_UIE);
+  TEST_ASSERT_EQUAL(TIM4_IRQn, HAL_NVIC_EnableIRQ_fake.arg0_val);
+  TEST_ASSERT_EQUAL(TEST_CLOCK_FREQ, myTimer_GetCaptureHz(timer));
+}
+
+/**
+ * @brief Each edge should push the latched value into the ring, extended
+ *          with the overflows that came before it.
+ */
+void test_EdgesArePushedWithOverflows(void)
+{
+  uint32_t stamps[2];
+
+  initCapture(myTimerEdge_Rise);
+  myTimer_Start(timer, 0, NULL);
+
+  captureEdge(TIM_SR_CC2IF, 0x1234);
+  captureEdge(TIM_SR_UIF, 0);
+  captureEdge(TIM_SR_UIF, 0);
+  captureEdge(TIM_SR_CC2IF, 0x0010);
+
+  TEST_ASSERT_EQUAL(2, myRing_PopMany(&ring, stamps, 2));
+  TEST_ASSERT_EQUAL_HEX32(0x00001234, stamps[0]);
+  TEST_ASSERT_EQUAL_HEX32(0x00020010, stamps[1]);
+}
+
+/**
+ * @brief If an edge and an overflow are pending together, a latched value in
+ *          the lower half should be taken as after the overflow, and one in
+ *          the upper half as before it.
+ */
+void test_IfOverflowIsPendingWithEdgeThenValueTellsTheirOrder(void)
+{
+  uint32_t stamps[3];
+
+  initCapture(myTimerEdge_Rise);
+  myTimer_Start(timer, 0, NULL);
+
+  captureEdge(TIM_SR_CC2IF | TIM_SR_UIF, 0xFFF0);
+  captureEdge(TIM_SR_CC2IF | TIM_SR_UIF, 0x0008);
+  captureEdge(TIM_SR_CC2IF, 0x0020);
+
+  TEST_ASSERT_EQUAL(3, myRing_PopMany(&ring, stamps, 3));
+  TEST_ASSERT_EQUAL_HEX32(0x0000FFF0, stamps[0]);
+  TEST_ASSERT_EQUAL_HEX32(0x00020008, stamps[1]);
+  TEST_ASSERT_EQUAL_HEX32(0x00020020, stamps[2]);
+}
+
+/**
+ * @brief Only the update flag should be cleared by hand, as reading the
+ *          captured value clears the channel one.
+ */
+void test_OnlyUpdateFlagIsCleared(void)
+{
+  initCapture(myTimerEdge_Rise);
+  myTimer_Start(timer, 0, NULL);
+
+  captureEdge(TIM_SR_CC2IF | TIM_SR_UIF, 0x0100);
+
+  TEST_ASSERT_EQUAL_HEX32(~TIM_SR_UIF, TIM4_Regs.SR);
+}
+
+/**
+ * @brief The TIM can't capture both edges at once, so the polarity should
+ *          be flipped after each capture.
+ */
+void test_IfBothEdgesAreCapturedThenPolarityIsFlipped(void)
+{
+  initCapture(myTimerEdge_Both);
+  myTimer_Start(timer, 0, NULL);
+  TEST_ASSERT_EQUAL(TIM_ICPOLARITY_RISING, icCfg.ICPolarity);
+
+  captureEdge(TIM_SR_CC2IF, 0x0100);
+  TEST_ASSERT_EQUAL_HEX32(TIM_CCER_CC1P << TIM_CHANNEL_2, TIM4_Regs.CCER);
+
+  captureEdge(TIM_SR_CC2IF, 0x0200);
+  TEST_ASSERT_EQUAL_HEX32(0, TIM4_Regs.CCER);
+}
+
+/**
+ * @brief The callback should only come when the ring was empty, so that the
+ *          consumer is woken up once for each batch it drains.
+ */
+void test_CallbackIsOnlyCalledWhenRingWasEmpty(void)
+{
+  uint32_t stamps[TEST_RING_SIZE];
+
+  initCapture(myTimerEdge_Rise);
+  myTimer_Start(timer, 0, timerCallback);
+
+  captureEdge(TIM_SR_CC2IF, 1);
+  captureEdge(TIM_SR_CC2IF, 2);
+  captureEdge(TIM_SR_UIF, 0);
+  TEST_ASSERT_EQUAL(1, callbackCallCount);
+
+  myRing_PopMany(&ring, stamps, TEST_RING_SIZE);
+  captureEdge(TIM_SR_CC2IF, 3);
+  TEST_ASSERT_EQUAL(2, callbackCallCount);
+}
+
+/**
+ * @brief Edges that find the ring full should be dropped, keeping the ones
+ *          that are already there.
+ */
+void test_IfRingIsFullThenEdgeIsDropped(void)
+{
+  uint32_t stamps[TEST_RING_SIZE + 1];
+  uint32_t idx;
+
+  initCapture(myTimerEdge_Rise);
+  myTimer_Start(timer, 0, NULL);
+
+  for(idx = 0; idx <= TEST_RING_SIZE; idx++) { captureEdge(TIM_SR_CC2IF, idx); }
+
+  TEST_ASSERT_EQUAL(TEST_RING_SIZE, myRing_PopMany(&ring, stamps, TEST_RING_SIZE + 1));
+  TEST_ASSERT_EQUAL(TEST_RING_SIZE - 1, stamps[TEST_RING_SIZE - 1]);
+}
+
+/**
+ * @brief A stopped capture timer should mask its interrupt, stop capturing
+ *          and no longer report a rate.
+ */
+void test_IfCaptureTimerIsStoppedThenInterruptIsMasked(void)
+{
+  initCapture(myTimerEdge_Rise);
+  myTimer_Start(timer, 0, NULL);
+  RESET_FAKE(HAL_NVIC_DisableIRQ);
+  RESET_FAKE(HAL_TIM_IC_Stop_IT);
+
+  TEST_ASSERT_EQUAL(myRet_OK, myTimer_Stop(timer));
+  TEST_ASSERT_EQUAL(TIM4_IRQn, HAL_NVIC_DisableIRQ_fake.arg0_val);
+  TEST_ASSERT_CALLED(HAL_TIM_IC_Stop_IT);
+  TEST_ASSERT_EQUAL(0, myTimer_GetCaptureHz(timer));
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static void initCapture(myTimerEdge_t edge)
+{
+  myTimerPars_t pars = { .mode = myTimerMode_Capture, .resource = myTimerRes_Dedicated, .channel = myDriverTimerCh_TIM4_CH2_PB7, .edge = edge, .ring = &ring };
+
+  TEST_ASSERT_EQUAL(myRet_OK, myTimer_Init(&timer, &pars));
+}
+
+static void captureEdge(uint32_t flags, uint32_t value)
+{
+  TIM4_Regs.SR = flags;
+  TIM4_Regs.CCR2 = value;
+  TIM4_IRQHandler();
+}
+
+static void gpioInitFake(GPIO_TypeDef * GPIOx, GPIO_InitTypeDef * GPIO_Init)
+{
+  gpioCfg = *GPIO_Init;
+}
+
+static HAL_StatusTypeDef configChannelFake(TIM_HandleTypeDef * htim, TIM_IC_InitTypeDef * sConfig, uint32_t Channel)
+{
+  icCfg = *sConfig;
+  return HAL_OK;
+}
+
+static void timerCallback(void)
+{
+  callbackCallCount++;
+}
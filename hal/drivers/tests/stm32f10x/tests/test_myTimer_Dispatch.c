@@ -0,0 +1,278 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file test_myTimer_Dispatch.c
+ * @brief Test file for testing timer driver logic, dispatch of each TIM
+ *          interrupt to the timer that owns it.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include <stdio.h>
+#include <time.h>
+
+#include "unity.h"
+#include "myTestDefs.h"
+#include "myMacros.h"
+
+#include "myTimer.h"
+#include "myWheel.h"
+#include "myPeriod.h"
+#include "mySplit.h"
+#include "myRing.h"
+#include "myDriverDefs.h"
+
+#include "mock_stm32f1xx_hal.h"
+#include "mock_stm32f1xx_hal_tim.h"
+#include "mock_stm32f1xx_hal_rcc.h"
+#include "mock_stm32f1xx_hal_gpio.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_CLOCK_FREQ                                               (36000000)
+#define TEST_PERIOD_MS                                                      (10)
+#define TEST_BENCH_IRQS                                                (1000000)
+
+/* Host time budget for a whole interrupt, user callback included. It is far  */
+/*  above what the dispatch takes, but way below what a search through the    */
+/*  HAL's interrupt logic would, so it catches the ISR getting heavier.       */
+#define TEST_ISR_BUDGET_NS                                                 (100)
+
+/* Order in which the driver hands the TIMs out.                              */
+#define TEST_TIM_COUNT                                                       (4)
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static void prepareMocks(void);
+static void initAllTimers(void);
+static double benchIRQ(uint32_t thisTIM);
+static void timer0Callback(void);
+static void timer1Callback(void);
+static void timer2Callback(void);
+static void timer3Callback(void);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static myTimer_t timers[TEST_TIM_COUNT];
+static uint32_t callbackCallCount[TEST_TIM_COUNT];
+
+static TIM_TypeDef * const testTIMs[TEST_TIM_COUNT] =
+{
+  TIM3, TIM4, TIM1, TIM2,
+};
+
+static void (* const testIRQHandlers[TEST_TIM_COUNT])(void) =
+{
+  TIM3_IRQHandler, TIM4_IRQHandler, TIM1_UP_IRQHandler, TIM2_IRQHandler,
+};
+
+static const myCbk_t testCallbacks[TEST_TIM_COUNT] =
+{
+  timer0Callback, timer1Callback, timer2Callback, timer3Callback,
+};
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  uint32_t idx;
+
+  prepareMocks();
+  myTimer_Reset();
+
+  for(idx = 0; idx < TEST_TIM_COUNT; idx++)
+  {
+    *testTIMs[idx] = (TIM_TypeDef) { 0 };
+    timers[idx] = NULL;
+    callbackCallCount[idx] = 0;
+  }
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief TIM1 is on APB2, so its clock should be taken from there.
+ */
+void test_IfTIM1IsUsedThenItsClockIsTakenFromAPB2(void)
+{
+  initAllTimers();
+
+  TEST_ASSERT_CALLED(HAL_RCC_GetPCLK2Freq);
+  TEST_ASSERT_CALLED(__HAL_RCC_TIM1_CLK_ENABLE);
+  TEST_ASSERT_CALLED(__HAL_RCC_TIM2_CLK_ENABLE);
+}
+
+/**
+ * @brief Each TIM interrupt should call the callback of the timer that owns
+ *          that TIM, and only that one.
+ */
+void test_EachInterruptCallsItsOwnCallback(void)
+{
+  uint32_t idx, other;
+
+  initAllTimers();
+
+  for(idx = 0; idx < TEST_TIM_COUNT; idx++)
+  {
+    testTIMs[idx]->SR |= TIM_SR_UIF;
+    testIRQHandlers[idx]();
+
+    for(other = 0; other < TEST_TIM_COUNT; other++)
+    {
+      TEST_ASSERT_EQUAL((other <= idx) ? 1 : 0, callbackCallCount[other]);
+    }
+  }
+}
+
+/**
+ * @brief The interrupt should not go through the HAL's interrupt logic.
+ */
+void test_InterruptDoesNotCallHAL(void)
+{
+  uint32_t idx;
+
+  initAllTimers();
+
+  for(idx = 0; idx < TEST_TIM_COUNT; idx++)
+  {
+    testTIMs[idx]->SR |= TIM_SR_UIF;
+    testIRQHandlers[idx]();
+  }
+
+  TEST_ASSERT_NOT_CALLED(HAL_TIM_IRQHandler);
+}
+
+/**
+ * @brief The interrupt should clear only the update flag. As the TIM flags are
+ *          cleared by writing zero, every other bit should be written as one.
+ */
+void test_InterruptClearsOnlyTheUpdateFlag(void)
+{
+  initAllTimers();
+
+  TIM3_Regs.SR = TIM_SR_UIF | TIM_SR_CC1IF;
+  TIM3_IRQHandler();
+
+  TEST_ASSERT_EQUAL_HEX32(~TIM_SR_UIF, TIM3_Regs.SR);
+}
+
+/**
+ * @brief The HAL's period elapsed callback should still reach the owner of
+ *          the handle, in case the HAL is ever given one.
+ */
+void test_IfHALCallbackIsCalledThenOwnerCallbackIsCalled(void)
+{
+  initAllTimers();
+
+  HAL_TIM_PeriodElapsedCallback(HAL_TIM_Base_Start_IT_fake.arg0_history[TEST_TIM_COUNT - 1]);
+
+  TEST_ASSERT_EQUAL(1, callbackCallCount[TEST_TIM_COUNT - 1]);
+}
+
+/**
+ * @brief The interrupt should fit in the budget, and take the same time no
+ *          matter which TIM it belongs to.
+ */
+void test_InterruptFitsCycleBudget(void)
+{
+  double ns[TEST_TIM_COUNT];
+  uint32_t idx;
+
+  initAllTimers();
+
+  for(idx = 0; idx < TEST_TIM_COUNT; idx++)
+  {
+    ns[idx] = benchIRQ(idx);
+    printf("TIM IRQ %u: %.1f ns\n", (unsigned) idx, ns[idx]);
+  }
+
+  for(idx = 0; idx < TEST_TIM_COUNT; idx++)
+  {
+    TEST_ASSERT_TRUE(ns[idx] < TEST_ISR_BUDGET_NS);
+  }
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static void prepareMocks(void)
+{
+  HAL_RCC_GetPCLK1Freq_fake.return_val = TEST_CLOCK_FREQ;
+  HAL_RCC_GetPCLK2Freq_fake.return_val = 2 * TEST_CLOCK_FREQ;
+}
+
+static void initAllTimers(void)
+{
+  myTimerPars_t pars = { .mode = myTimerMode_Periodic, .resource = myTimerRes_Dedicated };
+  uint32_t idx;
+
+  for(idx = 0; idx < TEST_TIM_COUNT; idx++)
+  {
+    TEST_ASSERT_EQUAL(myRet_OK, myTimer_Init(&timers[idx], &pars));
+    TEST_ASSERT_EQUAL(myRet_OK, myTimer_Start(timers[idx], TEST_PERIOD_MS, testCallbacks[idx]));
+  }
+}
+
+static double benchIRQ(uint32_t thisTIM)
+{
+  TIM_TypeDef * const TIM = testTIMs[thisTIM];
+  void (* const handler)(void) = testIRQHandlers[thisTIM];
+  struct timespec t0, t1;
+  uint32_t n;
+
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  for(n = 0; n < TEST_BENCH_IRQS; n++)
+  {
+    TIM->SR = TIM_SR_UIF;
+    handler();
+  }
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+
+  TEST_ASSERT_EQUAL(TEST_BENCH_IRQS, callbackCallCount[thisTIM]);
+  return ((t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec)) / TEST_BENCH_IRQS;
+}
+
+static void timer0Callback(void)
+{
+  callbackCallCount[0]++;
+}
+
+static void timer1Callback(void)
+{
+  callbackCallCount[1]++;
+}
+
+static void timer2Callback(void)
+{
+  callbackCallCount[2]++;
+}
+
+static void timer3Callback(void)
+{
+  callbackCallCount[3]++;
+}
@@ -0,0 +1,281 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file test_myTimer_FastStart.c
+ * @brief Test file for testing timer driver logic, restarting a timer through
+ *          the register-level path instead of the HAL initialization.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include <stdio.h>
+#include <time.h>
+
+#include "unity.h"
+#include "myTestDefs.h"
+
+#include "myTimer.h"
+#include "myWheel.h"
+#include "myPeriod.h"
+#include "mySplit.h"
+#include "myRing.h"
+#include "myDriverDefs.h"
+
+#include "mock_stm32f1xx_hal.h"
+#include "mock_stm32f1xx_hal_tim.h"
+#include "mock_stm32f1xx_hal_rcc.h"
+#include "mock_stm32f1xx_hal_gpio.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_CLOCK_FREQ                                               (36000000)
+#define TEST_PRESCALER(MS)          ((((MS) * (TEST_CLOCK_FREQ / 1000)) >> 16) + 1)
+#define TEST_PERIOD_MS                                                      (10)
+#define TEST_BENCH_STARTS                                              (1000000)
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static void prepareMocks(void);
+static void initTimer(myTimerMode_t mode);
+static uint32_t countHALCalls(void);
+static double benchStarts(bool fastPath);
+static double benchReinit(void);
+static HAL_StatusTypeDef halTimBaseInitFake(TIM_HandleTypeDef * htim);
+static HAL_StatusTypeDef halTimBaseStartITFake(TIM_HandleTypeDef * htim);
+static HAL_StatusTypeDef halTimBaseStopITFake(TIM_HandleTypeDef * htim);
+static void timerCallback(void);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static myTimer_t timer = NULL;
+static uint32_t callbackCallCount;
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  prepareMocks();
+  myTimer_Reset();
+  TIM3_Regs = (TIM_TypeDef) { 0 };
+  timer = NULL;
+  callbackCallCount = 0;
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief The first start should configure the TIM through the HAL.
+ */
+void test_IfTimerIsStartedForTheFirstTimeThenHALIsUsed(void)
+{
+  initTimer(myTimerMode_Periodic);
+  myTimer_Start(timer, TEST_PERIOD_MS, timerCallback);
+
+  TEST_ASSERT_CALLED(HAL_TIM_Base_Init);
+  TEST_ASSERT_CALLED(HAL_TIM_Base_Start_IT);
+  TEST_ASSERT_BITS_HIGH(TIM_CR1_URS, TIM3_Regs.CR1);
+}
+
+/**
+ * @brief Once configured, restarting a timer should not go through the HAL.
+ */
+void test_IfTimerIsRestartedThenHALIsNotUsed(void)
+{
+  initTimer(myTimerMode_Periodic);
+  myTimer_Start(timer, TEST_PERIOD_MS, timerCallback);
+  prepareMocks();
+
+  TEST_ASSERT_EQUAL(myRet_OK, myTimer_Start(timer, 2 * TEST_PERIOD_MS, timerCallback));
+  TEST_ASSERT_EQUAL(0, countHALCalls());
+}
+
+/**
+ * @brief The register-level restart should leave the TIM running with the
+ *          new period and prescaler loaded by an update event, and without
+ *          any pending update flag.
+ */
+void test_IfTimerIsRestartedThenRegistersAreSet(void)
+{
+  const uint32_t counts = (2 * TEST_PERIOD_MS * (TEST_CLOCK_FREQ / 1000)) / TEST_PRESCALER(2 * TEST_PERIOD_MS);
+
+  initTimer(myTimerMode_Periodic);
+  myTimer_Start(timer, TEST_PERIOD_MS, timerCallback);
+  TIM3_Regs.SR |= TIM_SR_UIF;
+  TIM3_Regs.EGR = 0;
+
+  myTimer_Start(timer, 2 * TEST_PERIOD_MS, timerCallback);
+
+  TEST_ASSERT_EQUAL(TEST_PRESCALER(2 * TEST_PERIOD_MS) - 1, TIM3_Regs.PSC);
+  TEST_ASSERT_UINT32_WITHIN(1, counts - 1, TIM3_Regs.ARR);
+  TEST_ASSERT_BITS_HIGH(TIM_EGR_UG, TIM3_Regs.EGR);
+  TEST_ASSERT_BITS_HIGH(TIM_CR1_CEN | TIM_CR1_URS | TIM_CR1_ARPE, TIM3_Regs.CR1);
+  TEST_ASSERT_BITS_HIGH(TIM_DIER_UIE, TIM3_Regs.DIER);
+  TEST_ASSERT_BITS_LOW(TIM_SR_UIF, TIM3_Regs.SR);
+}
+
+/**
+ * @brief A restarted one-shot timer should still be stopped by the TIM
+ *          itself at the update event.
+ */
+void test_IfOneShotTimerIsRestartedThenItStillStopsOnUpdate(void)
+{
+  initTimer(myTimerMode_OneShot);
+  myTimer_Start(timer, TEST_PERIOD_MS, timerCallback);
+  myTimer_Start(timer, TEST_PERIOD_MS, timerCallback);
+
+  TEST_ASSERT_CALLED(HAL_TIM_Base_Init);
+  TEST_ASSERT_BITS_HIGH(TIM_CR1_OPM | TIM_CR1_CEN, TIM3_Regs.CR1);
+}
+
+/**
+ * @brief A restarted periodic timer should keep calling its callback at
+ *          each update.
+ */
+void test_IfTimerIsRestartedThenCallbackIsStillCalled(void)
+{
+  initTimer(myTimerMode_Periodic);
+  myTimer_Start(timer, TEST_PERIOD_MS, timerCallback);
+  myTimer_Start(timer, TEST_PERIOD_MS, timerCallback);
+
+  HAL_TIM_PeriodElapsedCallback(HAL_TIM_Base_Start_IT_fake.arg0_val);
+
+  TEST_ASSERT_EQUAL(1, callbackCallCount);
+}
+
+/**
+ * @brief Compares the cost of restarting a timer through the HAL against the
+ *          register-level path, with the HAL fakes writing the same registers
+ *          as the real HAL does. Host timings only give a rough idea of the
+ *          difference on target, so the results are just printed.
+ */
+void test_BenchmarkRestartPaths(void)
+{
+  const double halNs = benchStarts(false) - benchReinit();
+  const double fastNs = benchStarts(true);
+
+  printf("myTimer_Start: HAL path %.1f ns/call, register path %.1f ns/call\n",
+         halNs, fastNs);
+  TEST_ASSERT_TRUE(fastNs > 0.0);
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static void prepareMocks(void)
+{
+  RESET_FAKE(HAL_TIM_Base_Init);
+  RESET_FAKE(HAL_TIM_Base_Start_IT);
+  RESET_FAKE(HAL_TIM_Base_Stop_IT);
+  HAL_RCC_GetPCLK1Freq_fake.return_val = TEST_CLOCK_FREQ;
+  HAL_TIM_Base_Init_fake.custom_fake = halTimBaseInitFake;
+  HAL_TIM_Base_Start_IT_fake.custom_fake = halTimBaseStartITFake;
+  HAL_TIM_Base_Stop_IT_fake.custom_fake = halTimBaseStopITFake;
+}
+
+static void initTimer(myTimerMode_t mode)
+{
+  myTimerPars_t pars = { .mode = mode, .resource = myTimerRes_Dedicated };
+
+  TEST_ASSERT_EQUAL(myRet_OK, myTimer_Init(&timer, &pars));
+}
+
+static uint32_t countHALCalls(void)
+{
+  return HAL_TIM_Base_Init_fake.call_count
+       + HAL_TIM_Base_Start_IT_fake.call_count
+       + HAL_TIM_Base_Stop_IT_fake.call_count;
+}
+
+static double benchStarts(bool fastPath)
+{
+  struct timespec t0, t1;
+  uint32_t n;
+
+  setUp();
+  initTimer(myTimerMode_Periodic);
+  myTimer_Start(timer, TEST_PERIOD_MS, timerCallback);
+
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  for(n = 0; n < TEST_BENCH_STARTS; n++)
+  {
+    /* Forgetting the configuration forces the driver into the HAL path.      */
+    if(!fastPath) { myTimer_Reset(); initTimer(myTimerMode_Periodic); }
+    myTimer_Start(timer, TEST_PERIOD_MS + (n & 7), timerCallback);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+
+  return ((t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec)) / TEST_BENCH_STARTS;
+}
+
+static double benchReinit(void)
+{
+  struct timespec t0, t1;
+  uint32_t n;
+
+  /* Cost of forgetting the configuration, to be taken out of the HAL path.   */
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  for(n = 0; n < TEST_BENCH_STARTS; n++) { myTimer_Reset(); initTimer(myTimerMode_Periodic); }
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+
+  return ((t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec)) / TEST_BENCH_STARTS;
+}
+
+static HAL_StatusTypeDef halTimBaseInitFake(TIM_HandleTypeDef * htim)
+{
+  /* Just as the HAL, write the whole base configuration and then force an    */
+  /*  update event to load it, which raises the update flag.                  */
+  TIM_TypeDef * const TIM = htim->Instance;
+
+  TIM->CR1 &= ~TIM_CR1_ARPE;
+  if(htim->Init.AutoReloadPreload == TIM_AUTORELOAD_PRELOAD_ENABLE) { TIM->CR1 |= TIM_CR1_ARPE; }
+  TIM->ARR = htim->Init.Period;
+  TIM->PSC = htim->Init.Prescaler;
+  TIM->RCR = htim->Init.RepetitionCounter;
+  TIM->EGR = TIM_EGR_UG;
+  TIM->SR |= TIM_SR_UIF;
+  return HAL_OK;
+}
+
+static HAL_StatusTypeDef halTimBaseStartITFake(TIM_HandleTypeDef * htim)
+{
+  htim->Instance->DIER |= TIM_DIER_UIE;
+  htim->Instance->CR1 |= TIM_CR1_CEN;
+  return HAL_OK;
+}
+
+static HAL_StatusTypeDef halTimBaseStopITFake(TIM_HandleTypeDef * htim)
+{
+  htim->Instance->DIER &= ~TIM_DIER_UIE;
+  htim->Instance->CR1 &= ~TIM_CR1_CEN;
+  return HAL_OK;
+}
+
+static void timerCallback(void)
+{
+  callbackCallCount++;
+}
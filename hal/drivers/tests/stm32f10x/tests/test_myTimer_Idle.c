@@ -0,0 +1,266 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file test_myTimer_Idle.c
+ * @brief Test file for testing timer driver logic, operation when the tick of
+ *          the virtual timers is stopped while the system is idle.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+
+#include "myTimer.h"
+#include "myWheel.h"
+#include "myPeriod.h"
+#include "mySplit.h"
+#include "myRing.h"
+#include "myDriverDefs.h"
+
+#include "mock_stm32f1xx_hal.h"
+#include "mock_stm32f1xx_hal_tim.h"
+#include "mock_stm32f1xx_hal_rcc.h"
+#include "mock_stm32f1xx_hal_gpio.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_CLOCK_FREQ                                               (36000000)
+#define TEST_PERIOD_MS                                                      (10)
+
+/* TIM counts in a tick, at the smallest prescaler.                           */
+#define TEST_TICK_COUNTS                                (TEST_CLOCK_FREQ / 1000)
+
+/* Longest time, in ms, that the tick can be stopped for at the test clock.   */
+#define TEST_MAX_IDLE_MS                      (0xFFFFFFFFULL / TEST_TICK_COUNTS)
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static void prepareMocks(void);
+static void initTimer(void);
+static void runTicks(uint32_t ticks);
+static void timerCallback(void);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static myTimer_t timer;
+static TIM_HandleTypeDef * wheelHandle;
+static uint32_t callbackCallCount;
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  prepareMocks();
+  callbackCallCount = 0;
+  myTimer_Reset();
+  TIM3_Regs = (TIM_TypeDef) { 0 };
+  timer = NULL;
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief Without any virtual timer there is no tick to stop.
+ */
+void test_IfThereAreNoVirtualTimersThenTickIsNotStopped(void)
+{
+  TEST_ASSERT_EQUAL(0, myTimer_IdleEnter());
+}
+
+/**
+ * @brief If the next tick has work to do, the tick should keep running.
+ */
+void test_IfNextTickIsNeededThenTickIsNotStopped(void)
+{
+  initTimer();
+  myTimer_Start(timer, 1, timerCallback);
+
+  TEST_ASSERT_EQUAL(0, myTimer_IdleEnter());
+  TEST_ASSERT_EQUAL(TEST_TICK_COUNTS - 1, TIM3_Regs.ARR);
+  TEST_ASSERT_NOT_CALLED(HAL_NVIC_ClearPendingIRQ);
+}
+
+/**
+ * @brief If there is a tick already pending, the tick should keep running so
+ *          that it is served.
+ */
+void test_IfTickIsPendingThenTickIsNotStopped(void)
+{
+  initTimer();
+  myTimer_Start(timer, TEST_PERIOD_MS, timerCallback);
+  TIM3_Regs.SR |= TIM_SR_UIF;
+
+  TEST_ASSERT_EQUAL(0, myTimer_IdleEnter());
+  TEST_ASSERT_BITS_HIGH(TIM_CR1_CEN, TIM3_Regs.CR1);
+  TEST_ASSERT_BITS_HIGH(TIM_SR_UIF, TIM3_Regs.SR);
+}
+
+/**
+ * @brief The tick should be stopped until the next expiration, counting the
+ *          part of the current tick that has already elapsed, and a tick that
+ *          was about to be served should be dropped.
+ */
+void test_IfTickIsStoppedThenWakeupIsAtNextExpiration(void)
+{
+  initTimer();
+  myTimer_Start(timer, TEST_PERIOD_MS, timerCallback);
+  TIM3_Regs.CNT = TEST_TICK_COUNTS / 4;
+
+  TEST_ASSERT_EQUAL((TEST_PERIOD_MS * 1000) - 250, myTimer_IdleEnter());
+
+  /* That is 9.75 ms, which needs a prescaler of 6 to fit the TIM.            */
+  TEST_ASSERT_EQUAL(6 - 1, TIM3_Regs.PSC);
+  TEST_ASSERT_EQUAL((TEST_TICK_COUNTS * 39 / 24) - 1, TIM3_Regs.ARR);
+  TEST_ASSERT_BITS_LOW(TIM_CR1_OPM, TIM3_Regs.CR1);
+  TEST_ASSERT_CALLED(HAL_NVIC_ClearPendingIRQ);
+}
+
+/**
+ * @brief Long waits should be limited to what the TIM can count at once.
+ */
+void test_IfNextExpirationIsTooFarThenWakeupIsLimited(void)
+{
+  initTimer();
+  myTimer_Start(timer, 10 * TEST_MAX_IDLE_MS, timerCallback);
+
+  TEST_ASSERT_EQUAL(TEST_MAX_IDLE_MS * 1000, myTimer_IdleEnter());
+  TEST_ASSERT_EQUAL(0xFFFF, TIM3_Regs.PSC);
+}
+
+/**
+ * @brief The tick should not be stopped again while it is still realigning
+ *          from the last time.
+ */
+void test_IfTickIsRealigningThenTickIsNotStoppedAgain(void)
+{
+  initTimer();
+  myTimer_Start(timer, TEST_PERIOD_MS, timerCallback);
+  myTimer_IdleEnter();
+  myTimer_IdleExit();
+
+  TEST_ASSERT_EQUAL(0, myTimer_IdleEnter());
+}
+
+/**
+ * @brief Waking up at the programmed time should expire the timer, and the
+ *          regular tick should then keep its period.
+ */
+void test_IfWokenUpAtWakeupThenTimerExpires(void)
+{
+  initTimer();
+  myTimer_Start(timer, TEST_PERIOD_MS, timerCallback);
+  myTimer_IdleEnter();
+
+  TIM3_Regs.SR |= TIM_SR_UIF;
+  myTimer_IdleExit();
+  TEST_ASSERT_EQUAL(1, callbackCallCount);
+
+  /* The first interrupt after waking up is the one at the tick boundary.     */
+  runTicks(TEST_PERIOD_MS - 1);
+  TEST_ASSERT_EQUAL(1, callbackCallCount);
+
+  runTicks(1);
+  TEST_ASSERT_EQUAL(2, callbackCallCount);
+}
+
+/**
+ * @brief Waking up earlier should account the ticks that went by, and set the
+ *          TIM to the next tick boundary.
+ */
+void test_IfWokenUpEarlierThenTimerExpiresOnTime(void)
+{
+  initTimer();
+  myTimer_Start(timer, TEST_PERIOD_MS, timerCallback);
+  myTimer_IdleEnter();
+
+  /* The sleep is counted at a prescaler of 6, so this is 3.5 ms.             */
+  TIM3_Regs.CNT = (TEST_TICK_COUNTS * 7) / 12;
+  myTimer_IdleExit();
+  TEST_ASSERT_EQUAL(0, callbackCallCount);
+  TEST_ASSERT_EQUAL(0, TIM3_Regs.PSC);
+  TEST_ASSERT_EQUAL((TEST_TICK_COUNTS / 2) - 1, TIM3_Regs.ARR);
+  TEST_ASSERT_BITS_HIGH(TIM_CR1_OPM, TIM3_Regs.CR1);
+
+  runTicks(TEST_PERIOD_MS - 4);
+  TEST_ASSERT_EQUAL(0, callbackCallCount);
+
+  runTicks(1);
+  TEST_ASSERT_EQUAL(1, callbackCallCount);
+}
+
+/**
+ * @brief Once realigned, the regular tick should be running again.
+ */
+void test_IfTickIsRealignedThenRegularTickRestarts(void)
+{
+  initTimer();
+  myTimer_Start(timer, TEST_PERIOD_MS, timerCallback);
+  myTimer_IdleEnter();
+  myTimer_IdleExit();
+  runTicks(1);
+
+  TEST_ASSERT_EQUAL(0, TIM3_Regs.PSC);
+  TEST_ASSERT_EQUAL(TEST_TICK_COUNTS - 1, TIM3_Regs.ARR);
+  TEST_ASSERT_BITS_LOW(TIM_CR1_OPM, TIM3_Regs.CR1);
+  TEST_ASSERT_NOT_EQUAL(0, myTimer_IdleEnter());
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static void prepareMocks(void)
+{
+  HAL_RCC_GetPCLK1Freq_fake.return_val = TEST_CLOCK_FREQ;
+}
+
+static void initTimer(void)
+{
+  myTimerPars_t pars = { .mode = myTimerMode_Periodic, .resource = myTimerRes_Virtual };
+
+  myTimer_Init(&timer, &pars);
+
+  /* The wheel's tick is counted by the handle that was started at the first  */
+  /*  virtual timer initialization.                                           */
+  wheelHandle = HAL_TIM_Base_Start_IT_fake.arg0_val;
+}
+
+static void runTicks(uint32_t ticks)
+{
+  /* Ticks are raised as the TIM would, as the driver checks the flag.        */
+  while(ticks-- > 0)
+  {
+    TIM3_Regs.SR |= TIM_SR_UIF;
+    TIM3_IRQHandler();
+  }
+}
+
+static void timerCallback(void)
+{
+  callbackCallCount++;
+}
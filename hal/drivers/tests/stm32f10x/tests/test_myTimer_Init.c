@@ -27,11 +27,16 @@
 #include "myTestDefs.h"
 
 #include "myTimer.h"
+#include "myWheel.h"
+#include "myPeriod.h"
+#include "mySplit.h"
+#include "myRing.h"
 #include "myDriverDefs.h"
 
 #include "mock_stm32f1xx_hal.h"
 #include "mock_stm32f1xx_hal_tim.h"
 #include "mock_stm32f1xx_hal_rcc.h"
+#include "mock_stm32f1xx_hal_gpio.h"
 
 /*******************************************************************************
  *  PRIVATE DEFINITIONS
@@ -89,18 +94,31 @@ void test_IfParsArgIsInvalidThenItFails(void)
 
 /**
  * @brief myTimer_Init logic should return fail if mode selection is not
- *          periodic.
+ *          valid.
  */
-void test_IfModeIsNotPeriodicThenItFails(void)
+void test_IfModeIsInvalidThenItFails(void)
 {
   myRet_t result;
 
-  pars.mode = (myTimerMode_Periodic + 1);
+  pars.mode = (myTimerMode_Capture + 1);
   result = myTimer_Init(&timer, &pars);
 
   TEST_ASSERT_EQUAL(myRet_Fail, result);
 }
 
+/**
+ * @brief myTimer_Init logic should return fail if the resource is one that
+ *          STM32 devices lack.
+ */
+void test_IfResourceIsMissingThenItFails(void)
+{
+  pars.resource = myTimerRes_Pit;
+  TEST_ASSERT_EQUAL(myRet_Fail, myTimer_Init(&timer, &pars));
+
+  pars.resource = myTimerRes_SysTick;
+  TEST_ASSERT_EQUAL(myRet_Fail, myTimer_Init(&timer, &pars));
+}
+
 /**
  * @brief When parameters are valid myTimer_Init logic should get which is
  *          the TIMs' base clock by calling HAL_RCC_GetPCLK1Freq.
@@ -166,4 +184,5 @@ static void prepareMocks(void)
 static void setValidTimerPars(void)
 {
   pars.mode = myTimerMode_Periodic;
+  pars.resource = myTimerRes_Dedicated;
 }
@@ -0,0 +1,385 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file test_myTimer_Modes.c
+ * @brief Test file for testing timer driver logic, operation of each of the
+ *          timer modes.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+#include "myMacros.h"
+
+#include "myTimer.h"
+#include "myWheel.h"
+#include "myPeriod.h"
+#include "mySplit.h"
+#include "myRing.h"
+#include "myDriverDefs.h"
+
+#include "mock_stm32f1xx_hal.h"
+#include "mock_stm32f1xx_hal_tim.h"
+#include "mock_stm32f1xx_hal_rcc.h"
+#include "mock_stm32f1xx_hal_gpio.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_CLOCK_FREQ                                               (36000000)
+#define TEST_LONG_RUN_PERIODS                                          (2000000)
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static void prepareMocks(void);
+static void initTimer(myTimerMode_t mode, myTimerRes_t resource);
+static HAL_StatusTypeDef halTimBaseInitFake(TIM_HandleTypeDef * htim);
+static HAL_StatusTypeDef halTimBaseStartITFake(TIM_HandleTypeDef * htim);
+static void timerCallback(void);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static myTimer_t timer = NULL;
+static TIM_Base_InitTypeDef lastInit;
+static bool updateFlagAtStart;
+static uint32_t callbackCallCount;
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  prepareMocks();
+  myTimer_Reset();
+  TIM3_Regs = (TIM_TypeDef) { 0 };
+  timer = NULL;
+  lastInit = (TIM_Base_InitTypeDef) { 0 };
+  updateFlagAtStart = false;
+  callbackCallCount = 0;
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief The TIM prescaler should be the smallest division that fits the
+ *          period in the TIM. As the TIM prescaler register divides the clock
+ *          by its value plus one, it should be set to one less than that.
+ */
+void test_PrescalerIsSmallestThatFitsThePeriod(void)
+{
+  /* 10 ms is 360000 counts, which only fits in 16 bits if divided by 6.      */
+  initTimer(myTimerMode_Periodic, myTimerRes_Dedicated);
+  myTimer_Start(timer, 10, timerCallback);
+
+  TEST_ASSERT_EQUAL(6 - 1, lastInit.Prescaler);
+  TEST_ASSERT_EQUAL(60000 - 1, lastInit.Period);
+}
+
+/**
+ * @brief The update flag raised by the initialization should be cleared
+ *          before the interrupt is enabled, so the callback isn't called at
+ *          once.
+ */
+void test_UpdateFlagIsClearedBeforeStarting(void)
+{
+  initTimer(myTimerMode_Periodic, myTimerRes_Dedicated);
+  myTimer_Start(timer, 10, timerCallback);
+
+  TEST_ASSERT_CALLED(HAL_TIM_Base_Start_IT);
+  TEST_ASSERT_FALSE(updateFlagAtStart);
+}
+
+/**
+ * @brief Over millions of periods, a periodic timer should have programmed
+ *          exactly the ideal amount of counts, so no drift is accumulated.
+ */
+void test_PeriodicTimerHasNoCumulativeDrift(void)
+{
+  const uint32_t periodsMs[] = { 1, 7, 1000, 60000 };
+  uint32_t idx, n;
+
+  for(idx = 0; idx < MY_ARRAY_SIZE(periodsMs); idx++)
+  {
+    const uint64_t num = (uint64_t) periodsMs[idx] * TEST_CLOCK_FREQ;
+    TIM_HandleTypeDef * handle;
+    uint64_t programmedCounts, den;
+
+    setUp();
+    initTimer(myTimerMode_Periodic, myTimerRes_Dedicated);
+    myTimer_Start(timer, periodsMs[idx], timerCallback);
+    handle = HAL_TIM_Base_Start_IT_fake.arg0_val;
+    den = 1000ULL * (lastInit.Prescaler + 1);
+
+    /* The first period is set by the init, the next ones are queued in ARR.  */
+    programmedCounts = (lastInit.Period + 1) + (TIM3_Regs.ARR + 1);
+    for(n = 0; n < TEST_LONG_RUN_PERIODS; n++)
+    {
+      HAL_TIM_PeriodElapsedCallback(handle);
+      programmedCounts += TIM3_Regs.ARR + 1;
+    }
+
+    TEST_ASSERT_EQUAL(TEST_LONG_RUN_PERIODS, callbackCallCount);
+    TEST_ASSERT_TRUE(programmedCounts == (((TEST_LONG_RUN_PERIODS + 2) * num) / den));
+  }
+}
+
+/**
+ * @brief A dedicated one-shot timer should have its TIM set to stop at the
+ *          update event, and no next period should be queued.
+ */
+void test_IfTimerIsOneShotThenTIMStopsOnUpdate(void)
+{
+  TIM_HandleTypeDef * handle;
+
+  initTimer(myTimerMode_OneShot, myTimerRes_Dedicated);
+  myTimer_Start(timer, 10, timerCallback);
+  handle = HAL_TIM_Base_Start_IT_fake.arg0_val;
+
+  TEST_ASSERT_BITS_HIGH(TIM_CR1_OPM, TIM3_Regs.CR1);
+  TEST_ASSERT_EQUAL(0, TIM3_Regs.ARR);
+
+  HAL_TIM_PeriodElapsedCallback(handle);
+
+  TEST_ASSERT_EQUAL(1, callbackCallCount);
+  TEST_ASSERT_EQUAL(0, TIM3_Regs.ARR);
+}
+
+/**
+ * @brief A free-running timer can be started without period nor callback,
+ *          and its TIM should count its whole range.
+ */
+void test_IfTimerIsFreeRunningThenItCountsWholeRange(void)
+{
+  initTimer(myTimerMode_FreeRunning, myTimerRes_Dedicated);
+
+  TEST_ASSERT_EQUAL(myRet_OK, myTimer_Start(timer, 0, NULL));
+  TEST_ASSERT_EQUAL(0xFFFF, lastInit.Period);
+}
+
+/**
+ * @brief A free-running timer should report the time elapsed from its
+ *          overflows and its current counter value.
+ */
+void test_IfTimerIsFreeRunningThenElapsedTimeIsCounted(void)
+{
+  TIM_HandleTypeDef * handle;
+
+  initTimer(myTimerMode_FreeRunning, myTimerRes_Dedicated);
+  myTimer_Start(timer, 0, NULL);
+  handle = HAL_TIM_Base_Start_IT_fake.arg0_val;
+
+  HAL_TIM_PeriodElapsedCallback(handle);
+  HAL_TIM_PeriodElapsedCallback(handle);
+  HAL_TIM_PeriodElapsedCallback(handle);
+  TIM3_Regs.CNT = 12345;
+
+  /* (3 * 65536 + 12345) counts at 35156.25 Hz is 5943.7 ms.                  */
+  TEST_ASSERT_EQUAL(5943, myTimer_GetElapsed(timer));
+  TEST_ASSERT_EQUAL(0, callbackCallCount);
+}
+
+/**
+ * @brief If the TIM overflowed but its interrupt is still pending, then the
+ *          overflow should be accounted when reading the elapsed time.
+ */
+void test_IfOverflowIsPendingThenElapsedTimeAccountsForIt(void)
+{
+  initTimer(myTimerMode_FreeRunning, myTimerRes_Dedicated);
+  myTimer_Start(timer, 0, NULL);
+
+  TIM3_Regs.SR = TIM_SR_UIF;
+  TIM3_Regs.CNT = 0;
+
+  /* 65536 counts at 35156.25 Hz is 1864.1 ms.                                */
+  TEST_ASSERT_EQUAL(1864, myTimer_GetElapsed(timer));
+}
+
+/**
+ * @brief Reading the elapsed time of a timer that is not free-running should
+ *          give zero.
+ */
+void test_IfTimerIsNotFreeRunningThenElapsedTimeIsZero(void)
+{
+  initTimer(myTimerMode_Periodic, myTimerRes_Dedicated);
+  myTimer_Start(timer, 10, timerCallback);
+
+  TEST_ASSERT_EQUAL(0, myTimer_GetElapsed(timer));
+}
+
+/**
+ * @brief When the clock changes, a running periodic timer should be restarted
+ *          with the prescaler and periods based on the new clock.
+ */
+void test_IfClockIsUpdatedThenRunningTimerIsRescaled(void)
+{
+  myPeriod_t expected;
+  uint32_t n;
+
+  initTimer(myTimerMode_Periodic, myTimerRes_Dedicated);
+  myTimer_Start(timer, 10, timerCallback);
+
+  HAL_RCC_GetPCLK1Freq_fake.return_val = 2 * TEST_CLOCK_FREQ;
+  myTimer_ClockUpdate();
+
+  /* 10 ms is now 720000 counts, which only fit in 16 bits if divided by 11.  */
+  /*  The first period is already loaded, and the second one is queued.       */
+  TEST_ASSERT_EQUAL(11 - 1, TIM3_Regs.PSC);
+  myPeriod_Init(&expected, 10ULL * 2 * TEST_CLOCK_FREQ, 1000 * 11);
+  myPeriod_Next(&expected);
+  TEST_ASSERT_EQUAL_UINT32(myPeriod_Next(&expected) - 1, TIM3_Regs.ARR);
+  for(n = 0; n < 8; n++)
+  {
+    HAL_TIM_PeriodElapsedCallback(HAL_TIM_Base_Start_IT_fake.arg0_val);
+    TEST_ASSERT_EQUAL_UINT32(myPeriod_Next(&expected) - 1, TIM3_Regs.ARR);
+  }
+}
+
+/**
+ * @brief When the clock changes, a running free-running timer should keep the
+ *          time it had counted, and count at the new clock from then on.
+ */
+void test_IfClockIsUpdatedThenFreeRunningTimerKeepsCounting(void)
+{
+  TIM_HandleTypeDef * handle;
+
+  initTimer(myTimerMode_FreeRunning, myTimerRes_Dedicated);
+  myTimer_Start(timer, 0, NULL);
+  handle = HAL_TIM_Base_Start_IT_fake.arg0_val;
+
+  /* (3 * 65536 + 12345) counts at 35156.25 Hz is 5943.7 ms.                  */
+  HAL_TIM_PeriodElapsedCallback(handle);
+  HAL_TIM_PeriodElapsedCallback(handle);
+  HAL_TIM_PeriodElapsedCallback(handle);
+  TIM3_Regs.CNT = 12345;
+
+  HAL_RCC_GetPCLK1Freq_fake.return_val = 2 * TEST_CLOCK_FREQ;
+  myTimer_ClockUpdate();
+
+  TIM3_Regs.CNT = 0;
+  TEST_ASSERT_EQUAL(5943, myTimer_GetElapsed(timer));
+
+  /* Then 65536 counts at 70312.5 Hz is 932.1 ms more.                        */
+  HAL_TIM_PeriodElapsedCallback(handle);
+  TEST_ASSERT_EQUAL(5943 + 932, myTimer_GetElapsed(timer));
+}
+
+/**
+ * @brief When the clock changes, a running one-shot timer should be restarted
+ *          for the time it had left, counted with the new clock.
+ */
+void test_IfClockIsUpdatedThenOneShotTimerCountsTheTimeLeft(void)
+{
+  myPeriod_t expected;
+
+  /* 1000 ms is 36000000000 cycles, which only fit in 16 bits if divided by   */
+  /*  550. Then 32400 counts are 495 ms, which leaves 505 ms.                 */
+  initTimer(myTimerMode_OneShot, myTimerRes_Dedicated);
+  myTimer_Start(timer, 1000, timerCallback);
+  TIM3_Regs.CNT = 32400;
+
+  HAL_RCC_GetPCLK1Freq_fake.return_val = 2 * TEST_CLOCK_FREQ;
+  myTimer_ClockUpdate();
+
+  /* 505 ms is now 36360000000 cycles, which are divided by 555.              */
+  TEST_ASSERT_EQUAL(555 - 1, TIM3_Regs.PSC);
+  myPeriod_Init(&expected, 505ULL * 2 * TEST_CLOCK_FREQ, 1000 * 555);
+  TEST_ASSERT_EQUAL_UINT32(myPeriod_Next(&expected) - 1, TIM3_Regs.ARR);
+  TEST_ASSERT_EQUAL(0, callbackCallCount);
+}
+
+/**
+ * @brief A virtual one-shot timer should expire only once.
+ */
+void test_IfVirtualTimerIsOneShotThenItExpiresOnce(void)
+{
+  TIM_HandleTypeDef * wheelHandle;
+  uint32_t tick;
+
+  initTimer(myTimerMode_OneShot, myTimerRes_Virtual);
+  wheelHandle = HAL_TIM_Base_Start_IT_fake.arg0_val;
+  myTimer_Start(timer, 10, timerCallback);
+
+  for(tick = 0; tick < 100; tick++) { HAL_TIM_PeriodElapsedCallback(wheelHandle); }
+
+  TEST_ASSERT_EQUAL(1, callbackCallCount);
+}
+
+/**
+ * @brief A virtual free-running timer should count the wheel's ticks since it
+ *          was started.
+ */
+void test_IfVirtualTimerIsFreeRunningThenElapsedTimeIsCounted(void)
+{
+  TIM_HandleTypeDef * wheelHandle;
+  uint32_t tick;
+
+  initTimer(myTimerMode_FreeRunning, myTimerRes_Virtual);
+  wheelHandle = HAL_TIM_Base_Start_IT_fake.arg0_val;
+  for(tick = 0; tick < 10; tick++) { HAL_TIM_PeriodElapsedCallback(wheelHandle); }
+
+  TEST_ASSERT_EQUAL(myRet_OK, myTimer_Start(timer, 0, NULL));
+  for(tick = 0; tick < 25; tick++) { HAL_TIM_PeriodElapsedCallback(wheelHandle); }
+
+  TEST_ASSERT_EQUAL(25, myTimer_GetElapsed(timer));
+  TEST_ASSERT_EQUAL(0, callbackCallCount);
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static void prepareMocks(void)
+{
+  HAL_RCC_GetPCLK1Freq_fake.return_val = TEST_CLOCK_FREQ;
+  HAL_TIM_Base_Init_fake.custom_fake = halTimBaseInitFake;
+  HAL_TIM_Base_Start_IT_fake.custom_fake = halTimBaseStartITFake;
+}
+
+static void initTimer(myTimerMode_t mode, myTimerRes_t resource)
+{
+  myTimerPars_t pars = { .mode = mode, .resource = resource };
+
+  TEST_ASSERT_EQUAL(myRet_OK, myTimer_Init(&timer, &pars));
+}
+
+static HAL_StatusTypeDef halTimBaseInitFake(TIM_HandleTypeDef * htim)
+{
+  /* Just as the HAL, force an update event, which raises the update flag.    */
+  lastInit = htim->Init;
+  htim->Instance->SR |= TIM_SR_UIF;
+  return HAL_OK;
+}
+
+static HAL_StatusTypeDef halTimBaseStartITFake(TIM_HandleTypeDef * htim)
+{
+  updateFlagAtStart = ((htim->Instance->SR & TIM_SR_UIF) != 0);
+  return HAL_OK;
+}
+
+static void timerCallback(void)
+{
+  callbackCallCount++;
+}
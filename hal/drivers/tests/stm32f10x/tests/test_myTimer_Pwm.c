@@ -0,0 +1,311 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file test_myTimer_Pwm.c
+ * @brief Test file for testing timer driver logic, operation of PWM timers.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+
+#include "myTimer.h"
+#include "myWheel.h"
+#include "myPeriod.h"
+#include "mySplit.h"
+#include "myRing.h"
+#include "myDriverDefs.h"
+
+#include "mock_stm32f1xx_hal.h"
+#include "mock_stm32f1xx_hal_tim.h"
+#include "mock_stm32f1xx_hal_rcc.h"
+#include "mock_stm32f1xx_hal_gpio.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_CLOCK_FREQ                                               (36000000)
+#define TEST_PERIOD_MS                                                       (1)
+#define TEST_PERIOD_COUNTS                                               (36000)
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static void initPwm(uint8_t channel);
+static void gpioInitFake(GPIO_TypeDef * GPIOx, GPIO_InitTypeDef * GPIO_Init);
+static HAL_StatusTypeDef configChannelFake(TIM_HandleTypeDef * htim, TIM_OC_InitTypeDef * sConfig, uint32_t Channel);
+static void timerCallback(void);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static myTimer_t timer = NULL;
+static GPIO_InitTypeDef gpioCfg;
+static TIM_OC_InitTypeDef ocCfg;
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  HAL_RCC_GetPCLK1Freq_fake.return_val = TEST_CLOCK_FREQ;
+  HAL_GPIO_Init_fake.custom_fake = gpioInitFake;
+  HAL_TIM_PWM_ConfigChannel_fake.custom_fake = configChannelFake;
+  myTimer_Reset();
+  timer = NULL;
+  gpioCfg = (GPIO_InitTypeDef) { 0 };
+  ocCfg = (TIM_OC_InitTypeDef) { 0 };
+  TIM3_Regs = (TIM_TypeDef) { 0 };
+  TIM4_Regs = (TIM_TypeDef) { 0 };
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief PWM timers are driven by the TIM itself, so a virtual one should
+ *          not be initialized.
+ */
+void test_IfPwmTimerIsVirtualThenInitFails(void)
+{
+  myTimerPars_t pars = { .mode = myTimerMode_Pwm, .resource = myTimerRes_Virtual };
+
+  TEST_ASSERT_EQUAL(myRet_Fail, myTimer_Init(&timer, &pars));
+}
+
+/**
+ * @brief A channel that the device doesn't have should make init fail.
+ */
+void test_IfOutputIsInvalidThenInitFails(void)
+{
+  myTimerPars_t pars = { .mode = myTimerMode_Pwm, .resource = myTimerRes_Dedicated, .channel = 0xFF };
+
+  TEST_ASSERT_EQUAL(myRet_Fail, myTimer_Init(&timer, &pars));
+}
+
+/**
+ * @brief The pin of the output should be set as an alternate function
+ *          output, and the clock of its TIM enabled.
+ */
+void test_IfOutputIsValidThenPinIsSet(void)
+{
+  initPwm(myDriverTimerCh_TIM4_CH3_PB8);
+
+  TEST_ASSERT_CALLED(__HAL_RCC_TIM4_CLK_ENABLE);
+  TEST_ASSERT_CALLED(__HAL_RCC_GPIOB_CLK_ENABLE);
+  TEST_ASSERT_EQUAL_PTR(GPIOB, HAL_GPIO_Init_fake.arg0_val);
+  TEST_ASSERT_EQUAL(GPIO_PIN_8, gpioCfg.Pin);
+  TEST_ASSERT_EQUAL(GPIO_MODE_AF_PP, gpioCfg.Mode);
+}
+
+/**
+ * @brief PWM timers never call back, so their TIM interrupt should not be
+ *          enabled.
+ */
+void test_PwmTimerDoesNotEnableInterrupts(void)
+{
+  initPwm(myDriverTimerCh_TIM3_CH1_PA6);
+  myTimer_Start(timer, TEST_PERIOD_MS, NULL);
+
+  TEST_ASSERT_NOT_CALLED(HAL_NVIC_EnableIRQ);
+  TEST_ASSERT_NOT_CALLED(HAL_TIM_Base_Start_IT);
+}
+
+/**
+ * @brief A PWM timer takes its TIM as a whole, so another channel of the same
+ *          TIM should not be initialized.
+ */
+void test_IfOutputTIMIsTakenThenInitFails(void)
+{
+  myTimerPars_t pars = { .mode = myTimerMode_Pwm, .resource = myTimerRes_Dedicated, .channel = myDriverTimerCh_TIM3_CH2_PA7 };
+
+  initPwm(myDriverTimerCh_TIM3_CH1_PA6);
+
+  TEST_ASSERT_EQUAL(myRet_Fail, myTimer_Init(&timer, &pars));
+}
+
+/**
+ * @brief Dedicated timers should skip the TIMs that PWM timers took.
+ */
+void test_IfPwmTimerTookTIMThenDedicatedTimerSkipsIt(void)
+{
+  myTimerPars_t pars = { .mode = myTimerMode_Periodic, .resource = myTimerRes_Dedicated };
+
+  initPwm(myDriverTimerCh_TIM3_CH1_PA6);
+
+  TEST_ASSERT_EQUAL(myRet_OK, myTimer_Init(&timer, &pars));
+  TEST_ASSERT_EQUAL(TIM4_IRQn, HAL_NVIC_EnableIRQ_fake.arg0_val);
+}
+
+/**
+ * @brief A PWM timer should be started without callback, with its channel
+ *          in PWM mode 1 and the whole period in a single overflow.
+ */
+void test_IfPwmTimerIsStartedThenChannelIsProgrammed(void)
+{
+  initPwm(myDriverTimerCh_TIM4_CH2_PB7);
+
+  TEST_ASSERT_EQUAL(myRet_OK, myTimer_Start(timer, TEST_PERIOD_MS, NULL));
+  TEST_ASSERT_CALLED(HAL_TIM_PWM_Init);
+  TEST_ASSERT_EQUAL_PTR(TIM4, HAL_TIM_PWM_Init_fake.arg0_val->Instance);
+  TEST_ASSERT_EQUAL(0, HAL_TIM_PWM_Init_fake.arg0_val->Init.Prescaler);
+  TEST_ASSERT_EQUAL(TEST_PERIOD_COUNTS - 1, HAL_TIM_PWM_Init_fake.arg0_val->Init.Period);
+  TEST_ASSERT_EQUAL(TIM_CHANNEL_2, HAL_TIM_PWM_ConfigChannel_fake.arg2_val);
+  TEST_ASSERT_EQUAL(TIM_OCMODE_PWM1, ocCfg.OCMode);
+  TEST_ASSERT_EQUAL(TIM_OCPOLARITY_HIGH, ocCfg.OCPolarity);
+  TEST_ASSERT_CALLED(HAL_TIM_PWM_Start);
+  TEST_ASSERT_EQUAL(TIM_CHANNEL_2, HAL_TIM_PWM_Start_fake.arg1_val);
+}
+
+/**
+ * @brief A PWM timer with no period should not be started.
+ */
+void test_IfPwmPeriodIsZeroThenStartFails(void)
+{
+  initPwm(myDriverTimerCh_TIM3_CH1_PA6);
+
+  TEST_ASSERT_EQUAL(myRet_Fail, myTimer_Start(timer, 0, NULL));
+  TEST_ASSERT_NOT_CALLED(HAL_TIM_PWM_Start);
+}
+
+/**
+ * @brief A PWM period that doesn't fit a single overflow, which is about
+ *          119 s at 36 MHz, should not be started.
+ */
+void test_IfPwmPeriodDoesNotFitOverflowThenStartFails(void)
+{
+  initPwm(myDriverTimerCh_TIM3_CH1_PA6);
+
+  TEST_ASSERT_EQUAL(myRet_OK, myTimer_Start(timer, 119304, NULL));
+  TEST_ASSERT_EQUAL(myRet_Fail, myTimer_Start(timer, 119305, NULL));
+}
+
+/**
+ * @brief The duty cycle should be scaled to the counts of the period and go
+ *          to the compare register of the channel, where the full one should
+ *          go above ARR, so that the output never goes inactive.
+ */
+void test_DutyIsScaledToPeriodCounts(void)
+{
+  initPwm(myDriverTimerCh_TIM3_CH3_PB0);
+  myTimer_Start(timer, TEST_PERIOD_MS, NULL);
+
+  myTimer_SetDuty(timer, 0x8000);
+  TEST_ASSERT_EQUAL(TEST_PERIOD_COUNTS / 2, TIM3_Regs.CCR3);
+
+  myTimer_SetDuty(timer, MY_TIMER_DUTY_MAX);
+  TEST_ASSERT_EQUAL(TEST_PERIOD_COUNTS, TIM3_Regs.CCR3);
+
+  myTimer_SetDuty(timer, 0);
+  TEST_ASSERT_EQUAL(0, TIM3_Regs.CCR3);
+  TEST_ASSERT_EQUAL(0, TIM3_Regs.CCR1);
+}
+
+/**
+ * @brief A duty cycle set while the timer is stopped should be kept and
+ *          programmed when it starts.
+ */
+void test_IfPwmTimerIsStoppedThenDutyIsSetAtStart(void)
+{
+  initPwm(myDriverTimerCh_TIM3_CH1_PA6);
+
+  TEST_ASSERT_EQUAL(myRet_OK, myTimer_SetDuty(timer, 0x4000));
+  TEST_ASSERT_EQUAL(0, TIM3_Regs.CCR1);
+
+  myTimer_Start(timer, TEST_PERIOD_MS, NULL);
+  TEST_ASSERT_EQUAL(TEST_PERIOD_COUNTS / 4, ocCfg.Pulse);
+}
+
+/**
+ * @brief Only PWM timers have a duty cycle to set.
+ */
+void test_IfTimerIsNotPwmThenSetDutyFails(void)
+{
+  myTimerPars_t pars = { .mode = myTimerMode_Periodic, .resource = myTimerRes_Dedicated };
+
+  myTimer_Init(&timer, &pars);
+  myTimer_Start(timer, TEST_PERIOD_MS, timerCallback);
+
+  TEST_ASSERT_EQUAL(myRet_Fail, myTimer_SetDuty(timer, 0x8000));
+  TEST_ASSERT_EQUAL(myRet_Fail, myTimer_SetDuty(NULL, 0x8000));
+  TEST_ASSERT_EQUAL(0, TIM3_Regs.CCR1);
+}
+
+/**
+ * @brief Stopping a PWM timer should stop its channel.
+ */
+void test_IfPwmTimerIsStoppedThenChannelIsStopped(void)
+{
+  initPwm(myDriverTimerCh_TIM3_CH4_PB1);
+  myTimer_Start(timer, TEST_PERIOD_MS, NULL);
+  RESET_FAKE(HAL_TIM_PWM_Stop);
+
+  myTimer_Stop(timer);
+
+  TEST_ASSERT_CALLED(HAL_TIM_PWM_Stop);
+  TEST_ASSERT_EQUAL(TIM_CHANNEL_4, HAL_TIM_PWM_Stop_fake.arg1_val);
+  TEST_ASSERT_NOT_CALLED(HAL_TIM_Base_Stop_IT);
+}
+
+/**
+ * @brief A running PWM timer should be restarted with the new clock, keeping
+ *          its period and duty cycle.
+ */
+void test_IfClockChangesThenPwmTimerIsRestarted(void)
+{
+  initPwm(myDriverTimerCh_TIM3_CH1_PA6);
+  myTimer_Start(timer, TEST_PERIOD_MS, NULL);
+  myTimer_SetDuty(timer, 0x8000);
+
+  HAL_RCC_GetPCLK1Freq_fake.return_val = TEST_CLOCK_FREQ / 2;
+  myTimer_ClockUpdate();
+
+  TEST_ASSERT_EQUAL((TEST_PERIOD_COUNTS / 2) - 1, HAL_TIM_PWM_Init_fake.arg0_val->Init.Period);
+  TEST_ASSERT_EQUAL(TEST_PERIOD_COUNTS / 4, ocCfg.Pulse);
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static void initPwm(uint8_t channel)
+{
+  myTimerPars_t pars = { .mode = myTimerMode_Pwm, .resource = myTimerRes_Dedicated, .channel = channel };
+
+  TEST_ASSERT_EQUAL(myRet_OK, myTimer_Init(&timer, &pars));
+}
+
+static void gpioInitFake(GPIO_TypeDef * GPIOx, GPIO_InitTypeDef * GPIO_Init)
+{
+  gpioCfg = *GPIO_Init;
+}
+
+static HAL_StatusTypeDef configChannelFake(TIM_HandleTypeDef * htim, TIM_OC_InitTypeDef * sConfig, uint32_t Channel)
+{
+  ocCfg = *sConfig;
+  return HAL_OK;
+}
+
+static void timerCallback(void)
+{
+}
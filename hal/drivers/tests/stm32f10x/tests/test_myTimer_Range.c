@@ -0,0 +1,271 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file test_myTimer_Range.c
+ * @brief Test file for testing timer driver logic, selection of the TIM
+ *          prescaler and split of the periods that don't fit the TIM, over
+ *          the whole range of periods.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+#include "myMacros.h"
+
+#include "myTimer.h"
+#include "myWheel.h"
+#include "myPeriod.h"
+#include "mySplit.h"
+#include "myRing.h"
+#include "myDriverDefs.h"
+
+#include "mock_stm32f1xx_hal.h"
+#include "mock_stm32f1xx_hal_tim.h"
+#include "mock_stm32f1xx_hal_rcc.h"
+#include "mock_stm32f1xx_hal_gpio.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_MAX_COUNTS                                                  (65536)
+#define TEST_MAX_PRESCALER                                               (65536)
+#define TEST_PERIODS_PER_CASE                                                (3)
+
+/* The structure below models the shadow registers of a TIM, which are loaded */
+/*  from the preload ones at each update event.                               */
+typedef struct
+{
+  uint32_t prescaler;
+  uint32_t counts;
+  uint64_t elapsed;
+} testTIM_t;
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static void prepareMocks(void);
+static void initTimer(myTimerMode_t mode);
+static uint32_t longestPeriodMs(uint32_t clockHz);
+static uint32_t expectedPrescaler(uint64_t num);
+static uint64_t expectedElapsed(uint64_t num, uint32_t periods);
+static bool isRunning(void);
+static void runOverflow(void);
+static HAL_StatusTypeDef halTimBaseInitFake(TIM_HandleTypeDef * htim);
+static HAL_StatusTypeDef halTimBaseStartITFake(TIM_HandleTypeDef * htim);
+static void timerCallback(void);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static myTimer_t timer = NULL;
+static testTIM_t tim;
+static uint32_t callbackCallCount;
+static uint64_t callbackElapsed[TEST_PERIODS_PER_CASE + 1];
+
+static const uint32_t testClocks[] =
+{
+  72000000,   /* APB1 timers clock, at full speed.                            */
+  36000000,
+  8000000,    /* HSI, or HSE without PLL.                                     */
+};
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  prepareMocks();
+  myTimer_Reset();
+  TIM3_Regs = (TIM_TypeDef) { 0 };
+  timer = NULL;
+  tim = (testTIM_t) { 0 };
+  callbackCallCount = 0;
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief From 1 ms to weeks, a periodic timer should count each period with
+ *          the smallest prescaler that fits it, never set the TIM beyond its
+ *          16 bits, and expire exactly at the ideal time of each period.
+ */
+void test_PeriodicTimerIsExactOverWholeRange(void)
+{
+  uint64_t periodMs;
+  uint32_t idx, n;
+
+  for(idx = 0; idx < MY_ARRAY_SIZE(testClocks); idx++)
+  {
+    const uint32_t clockHz = testClocks[idx];
+
+    for(periodMs = 1; periodMs <= longestPeriodMs(clockHz); periodMs += (periodMs / 3) + 1)
+    {
+      const uint64_t num = periodMs * clockHz;
+
+      setUp();
+      HAL_RCC_GetPCLK1Freq_fake.return_val = clockHz;
+      initTimer(myTimerMode_Periodic);
+      TEST_ASSERT_EQUAL(myRet_OK, myTimer_Start(timer, (uint32_t)periodMs, timerCallback));
+      TEST_ASSERT_EQUAL(expectedPrescaler(num), tim.prescaler);
+      TEST_ASSERT_BITS_LOW(TIM_CR1_OPM, TIM3_Regs.CR1);
+
+      while(callbackCallCount < TEST_PERIODS_PER_CASE) { runOverflow(); }
+
+      for(n = 1; n <= TEST_PERIODS_PER_CASE; n++)
+      {
+        TEST_ASSERT_TRUE(callbackElapsed[n] == expectedElapsed(num, n));
+      }
+    }
+  }
+}
+
+/**
+ * @brief From 1 ms to weeks, a one-shot timer should expire once, exactly at
+ *          the ideal time, and leave its TIM stopped.
+ */
+void test_OneShotTimerIsExactOverWholeRange(void)
+{
+  uint64_t periodMs;
+  uint32_t idx;
+
+  for(idx = 0; idx < MY_ARRAY_SIZE(testClocks); idx++)
+  {
+    const uint32_t clockHz = testClocks[idx];
+
+    for(periodMs = 1; periodMs <= longestPeriodMs(clockHz); periodMs += (periodMs / 3) + 1)
+    {
+      const uint64_t num = periodMs * clockHz;
+
+      setUp();
+      HAL_RCC_GetPCLK1Freq_fake.return_val = clockHz;
+      initTimer(myTimerMode_OneShot);
+      TEST_ASSERT_EQUAL(myRet_OK, myTimer_Start(timer, (uint32_t)periodMs, timerCallback));
+      TEST_ASSERT_EQUAL(expectedPrescaler(num), tim.prescaler);
+
+      while(isRunning()) { runOverflow(); }
+
+      TEST_ASSERT_EQUAL(1, callbackCallCount);
+      TEST_ASSERT_TRUE(callbackElapsed[1] == expectedElapsed(num, 1));
+    }
+  }
+}
+
+/**
+ * @brief A period whose counts don't fit in 32 bits even at the largest
+ *          prescaler should be refused, and the TIM left untouched.
+ */
+void test_IfPeriodIsTooLongThenStartFails(void)
+{
+  const uint32_t clockHz = testClocks[0];
+  const uint32_t longest = longestPeriodMs(clockHz);
+
+  HAL_RCC_GetPCLK1Freq_fake.return_val = clockHz;
+  initTimer(myTimerMode_Periodic);
+
+  TEST_ASSERT_EQUAL(myRet_Fail, myTimer_Start(timer, longest + 1, timerCallback));
+  TEST_ASSERT_NOT_CALLED(HAL_TIM_Base_Start_IT);
+  TEST_ASSERT_EQUAL(myRet_OK, myTimer_Start(timer, longest, timerCallback));
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static void prepareMocks(void)
+{
+  HAL_TIM_Base_Init_fake.custom_fake = halTimBaseInitFake;
+  HAL_TIM_Base_Start_IT_fake.custom_fake = halTimBaseStartITFake;
+}
+
+static void initTimer(myTimerMode_t mode)
+{
+  myTimerPars_t pars = { .mode = mode, .resource = myTimerRes_Dedicated };
+
+  TEST_ASSERT_EQUAL(myRet_OK, myTimer_Init(&timer, &pars));
+}
+
+static uint32_t longestPeriodMs(uint32_t clockHz)
+{
+  /* The counts of a period must fit in 32 bits at the largest prescaler.     */
+  const uint64_t longest = ((((1000ULL * TEST_MAX_PRESCALER) << 32) - 1) / clockHz);
+
+  return (longest < UINT32_MAX) ? (uint32_t)longest : UINT32_MAX;
+}
+
+static uint32_t expectedPrescaler(uint64_t num)
+{
+  uint64_t prescaler = (num / (1000ULL * TEST_MAX_COUNTS)) + 1;
+
+  return (prescaler < TEST_MAX_PRESCALER) ? (uint32_t)prescaler : TEST_MAX_PRESCALER;
+}
+
+static uint64_t expectedElapsed(uint64_t num, uint32_t periods)
+{
+  /* Ideal time of the given amount of periods, rounded down to the counts of */
+  /*  the prescaler in use, and given in clock cycles.                        */
+  return ((periods * num) / (1000ULL * tim.prescaler)) * tim.prescaler;
+}
+
+static bool isRunning(void)
+{
+  return ((TIM3_Regs.CR1 & TIM_CR1_CEN) != 0);
+}
+
+static void runOverflow(void)
+{
+  TEST_ASSERT_TRUE(TIM3_Regs.ARR < TEST_MAX_COUNTS);
+
+  tim.elapsed += (uint64_t)tim.counts * tim.prescaler;
+  tim.counts = TIM3_Regs.ARR + 1;
+  if((TIM3_Regs.CR1 & TIM_CR1_OPM) != 0) { TIM3_Regs.CR1 &= ~TIM_CR1_CEN; }
+  TIM3_Regs.SR |= TIM_SR_UIF;
+
+  TIM3_IRQHandler();
+}
+
+static HAL_StatusTypeDef halTimBaseInitFake(TIM_HandleTypeDef * htim)
+{
+  /* Just as the HAL, load the settings at once with an update event.         */
+  TEST_ASSERT_TRUE(htim->Init.Prescaler < TEST_MAX_PRESCALER);
+  TEST_ASSERT_TRUE(htim->Init.Period < TEST_MAX_COUNTS);
+
+  tim.prescaler = htim->Init.Prescaler + 1;
+  tim.counts = htim->Init.Period + 1;
+  htim->Instance->ARR = htim->Init.Period;
+  htim->Instance->PSC = htim->Init.Prescaler;
+  htim->Instance->SR |= TIM_SR_UIF;
+  return HAL_OK;
+}
+
+static HAL_StatusTypeDef halTimBaseStartITFake(TIM_HandleTypeDef * htim)
+{
+  htim->Instance->CR1 |= TIM_CR1_CEN;
+  return HAL_OK;
+}
+
+static void timerCallback(void)
+{
+  callbackCallCount++;
+  if(callbackCallCount < MY_ARRAY_SIZE(callbackElapsed)) { callbackElapsed[callbackCallCount] = tim.elapsed; }
+}
@@ -27,11 +27,16 @@
 #include "myTestDefs.h"
 
 #include "myTimer.h"
+#include "myWheel.h"
+#include "myPeriod.h"
+#include "mySplit.h"
+#include "myRing.h"
 #include "myDriverDefs.h"
 
 #include "mock_stm32f1xx_hal.h"
 #include "mock_stm32f1xx_hal_tim.h"
 #include "mock_stm32f1xx_hal_rcc.h"
+#include "mock_stm32f1xx_hal_gpio.h"
 
 /*******************************************************************************
  *  PRIVATE DEFINITIONS
@@ -0,0 +1,178 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test_myWave_Buffer.c
+ * @brief Test file for testing waveform engine logic, operation when
+ *          buffers are built.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+
+#include "myWave.h"
+#include "myDriverDefs.h"
+
+#include "mock_stm32f1xx_hal.h"
+#include "mock_stm32f1xx_hal_tim.h"
+#include "mock_stm32f1xx_hal_rcc.h"
+#include "mock_stm32f1xx_hal_dma.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_STEPS                                                           (8)
+
+/* Words that set and reset the pins in a mask.                               */
+#define TEST_SET(MASK)                                                    (MASK)
+#define TEST_RESET(MASK)                                          ((MASK) << 16)
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static uint32_t buf[TEST_STEPS];
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  uint32_t step;
+
+  myWave_Reset();
+  for(step = 0; step < TEST_STEPS; step++) { buf[step] = 0; }
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief A sequence should set, at each step, the pins in the mask that are
+ *          high in the levels, and reset the ones that are low.
+ */
+void test_IfSequenceIsBuiltThenEachStepWritesItsLevels(void)
+{
+  const uint16_t levels[TEST_STEPS] = { 0x0, 0x1, 0x2, 0x3, 0x3, 0x2, 0x1, 0x0 };
+  const uint32_t expected[TEST_STEPS] = { TEST_RESET(0x3), TEST_SET(0x1) | TEST_RESET(0x2),
+                                          TEST_SET(0x2) | TEST_RESET(0x1), TEST_SET(0x3),
+                                          TEST_SET(0x3), TEST_SET(0x2) | TEST_RESET(0x1),
+                                          TEST_SET(0x1) | TEST_RESET(0x2), TEST_RESET(0x3) };
+
+  myWave_Sequence(buf, TEST_STEPS, 0x3, levels);
+
+  TEST_ASSERT_EQUAL_HEX32_ARRAY(expected, buf, TEST_STEPS);
+}
+
+/**
+ * @brief Levels of pins outside the mask should not end up in the buffer.
+ */
+void test_IfSequenceHasLevelsOutsideMaskThenTheyAreIgnored(void)
+{
+  const uint16_t levels[TEST_STEPS] = { 0xFFFF, 0xFFFF, 0x0, 0x0, 0xFFFF, 0x0, 0xFFFF, 0x0 };
+  uint32_t step;
+
+  myWave_Sequence(buf, TEST_STEPS, 0x10, levels);
+
+  for(step = 0; step < TEST_STEPS; step++)
+  {
+    TEST_ASSERT_EQUAL_HEX32(0, buf[step] & ~(TEST_SET(0x10) | TEST_RESET(0x10)));
+  }
+}
+
+/**
+ * @brief A pulse should set the pins at its start, and reset them once its
+ *          width has elapsed, until the end of the buffer.
+ */
+void test_IfPulseIsBuiltThenPinsAreHighForItsWidth(void)
+{
+  const uint32_t expected[TEST_STEPS] = { TEST_RESET(0x4), TEST_SET(0x4), TEST_SET(0x4), TEST_SET(0x4),
+                                          TEST_RESET(0x4), TEST_RESET(0x4), TEST_RESET(0x4), TEST_RESET(0x4) };
+
+  myWave_Pulse(buf, TEST_STEPS, 0x4, 1, 3);
+
+  TEST_ASSERT_EQUAL_HEX32_ARRAY(expected, buf, TEST_STEPS);
+}
+
+/**
+ * @brief A pulse that goes past the end of the buffer should wrap around to
+ *          its beginning, as the buffer is meant to be played in a loop.
+ */
+void test_IfPulseGoesPastTheEndThenItWrapsAround(void)
+{
+  const uint32_t expected[TEST_STEPS] = { TEST_SET(0x1), TEST_RESET(0x1), TEST_RESET(0x1), TEST_RESET(0x1),
+                                          TEST_RESET(0x1), TEST_RESET(0x1), TEST_SET(0x1), TEST_SET(0x1) };
+
+  myWave_Pulse(buf, TEST_STEPS, 0x1, 6, 3);
+
+  TEST_ASSERT_EQUAL_HEX32_ARRAY(expected, buf, TEST_STEPS);
+}
+
+/**
+ * @brief Pulses with no width or with the whole buffer as width should keep
+ *          the pins low or high all the time.
+ */
+void test_IfPulseWidthIsZeroOrFullThenLevelIsConstant(void)
+{
+  uint32_t step;
+
+  myWave_Pulse(buf, TEST_STEPS, 0x1, 0, 0);
+  myWave_Pulse(buf, TEST_STEPS, 0x2, 5, TEST_STEPS);
+
+  for(step = 0; step < TEST_STEPS; step++)
+  {
+    TEST_ASSERT_EQUAL_HEX32(TEST_RESET(0x1) | TEST_SET(0x2), buf[step]);
+  }
+}
+
+/**
+ * @brief Patterns built for different pins should share the buffer, each one
+ *          leaving the pins of the other ones alone.
+ */
+void test_IfPatternsDriveDifferentPinsThenTheyAreCombined(void)
+{
+  const uint16_t levels[TEST_STEPS] = { 0x100, 0x0, 0x100, 0x0, 0x100, 0x0, 0x100, 0x0 };
+  const uint32_t expected[TEST_STEPS] = { TEST_SET(0x101), TEST_SET(0x1) | TEST_RESET(0x100),
+                                          TEST_SET(0x100) | TEST_RESET(0x1), TEST_RESET(0x101),
+                                          TEST_SET(0x100) | TEST_RESET(0x1), TEST_RESET(0x101),
+                                          TEST_SET(0x100) | TEST_RESET(0x1), TEST_RESET(0x101) };
+
+  myWave_Pulse(buf, TEST_STEPS, 0x1, 0, 2);
+  myWave_Sequence(buf, TEST_STEPS, 0x100, levels);
+
+  TEST_ASSERT_EQUAL_HEX32_ARRAY(expected, buf, TEST_STEPS);
+}
+
+/**
+ * @brief Building a pattern again for the same pins should replace the old
+ *          one, instead of mixing both of them.
+ */
+void test_IfPatternIsBuiltAgainThenItIsReplaced(void)
+{
+  const uint32_t expected[TEST_STEPS] = { TEST_RESET(0x8), TEST_RESET(0x8), TEST_RESET(0x8), TEST_RESET(0x8),
+                                          TEST_RESET(0x8), TEST_RESET(0x8), TEST_SET(0x8), TEST_SET(0x8) };
+
+  myWave_Pulse(buf, TEST_STEPS, 0x8, 0, 4);
+  myWave_Pulse(buf, TEST_STEPS, 0x8, 6, 2);
+
+  TEST_ASSERT_EQUAL_HEX32_ARRAY(expected, buf, TEST_STEPS);
+}
@@ -0,0 +1,285 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test_myWave_Start.c
+ * @brief Test file for testing waveform engine logic, operation when
+ *          waveforms are started and stopped.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+
+#include "myWave.h"
+#include "myDriverDefs.h"
+
+#include "mock_stm32f1xx_hal.h"
+#include "mock_stm32f1xx_hal_tim.h"
+#include "mock_stm32f1xx_hal_rcc.h"
+#include "mock_stm32f1xx_hal_dma.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_STEPS                                                           (4)
+#define TEST_CLOCK_HZ                                                 (72000000)
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static void halfCallback(void);
+static void doneCallback(void);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static const uint32_t buf[TEST_STEPS] = { 0x1, 0x10000, 0x1, 0x10000 };
+static myWavePars_t pars;
+static uint32_t halfCallCount;
+static uint32_t doneCallCount;
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  myWave_Reset();
+  TIM1_Regs = (TIM_TypeDef) { 0 };
+  HAL_RCC_GetPCLK2Freq_fake.return_val = TEST_CLOCK_HZ;
+
+  pars = (myWavePars_t) { .port = myDriverPort_PB, .stepUs = 1000, .circular = true };
+  halfCallCount = 0;
+  doneCallCount = 0;
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief myWave_Start logic should return fail if its arguments are invalid.
+ */
+void test_IfArgsAreInvalidThenItFails(void)
+{
+  TEST_ASSERT_EQUAL(myRet_Fail, myWave_Start(NULL, TEST_STEPS, &pars));
+  TEST_ASSERT_EQUAL(myRet_Fail, myWave_Start(buf, TEST_STEPS, NULL));
+  TEST_ASSERT_EQUAL(myRet_Fail, myWave_Start(buf, 0, &pars));
+
+  pars.port = myDriverPort_PE + 1;
+  TEST_ASSERT_EQUAL(myRet_Fail, myWave_Start(buf, TEST_STEPS, &pars));
+
+  TEST_ASSERT_NOT_CALLED(HAL_DMA_Init);
+}
+
+/**
+ * @brief myWave_Start logic should return fail if the step can't be counted
+ *          by the TIM, either for being too short or too long.
+ */
+void test_IfStepIsOutOfRangeThenItFails(void)
+{
+  pars.stepUs = 0;
+  TEST_ASSERT_EQUAL(myRet_Fail, myWave_Start(buf, TEST_STEPS, &pars));
+
+  pars.stepUs = 60000000;
+  TEST_ASSERT_EQUAL(myRet_Fail, myWave_Start(buf, TEST_STEPS, &pars));
+
+  TEST_ASSERT_FALSE(myWave_IsRunning());
+}
+
+/**
+ * @brief The DMA should move the buffer, word by word, to the BSRR register
+ *          of the port.
+ */
+void test_IfStartedThenBufferIsMovedToBSRR(void)
+{
+  TEST_ASSERT_EQUAL(myRet_OK, myWave_Start(buf, TEST_STEPS, &pars));
+
+  TEST_ASSERT_CALLED(HAL_DMA_Start);
+  TEST_ASSERT_EQUAL_PTR(DMA1_Channel5, HAL_DMA_Init_fake.arg0_val->Instance);
+  TEST_ASSERT_EQUAL(DMA_MEMORY_TO_PERIPH, HAL_DMA_Init_fake.arg0_val->Init.Direction);
+  TEST_ASSERT_EQUAL(DMA_PINC_DISABLE, HAL_DMA_Init_fake.arg0_val->Init.PeriphInc);
+  TEST_ASSERT_EQUAL(DMA_MINC_ENABLE, HAL_DMA_Init_fake.arg0_val->Init.MemInc);
+  TEST_ASSERT_EQUAL(DMA_PDATAALIGN_WORD, HAL_DMA_Init_fake.arg0_val->Init.PeriphDataAlignment);
+  TEST_ASSERT_EQUAL(DMA_MDATAALIGN_WORD, HAL_DMA_Init_fake.arg0_val->Init.MemDataAlignment);
+  TEST_ASSERT_EQUAL(DMA_CIRCULAR, HAL_DMA_Init_fake.arg0_val->Init.Mode);
+  TEST_ASSERT_EQUAL((uint32_t)(uintptr_t)buf, HAL_DMA_Start_fake.arg1_val);
+  TEST_ASSERT_EQUAL((uint32_t)(uintptr_t)&GPIOB->BSRR, HAL_DMA_Start_fake.arg2_val);
+  TEST_ASSERT_EQUAL(TEST_STEPS, HAL_DMA_Start_fake.arg3_val);
+}
+
+/**
+ * @brief A circular waveform with no callbacks should not enable any
+ *          interrupt at all.
+ */
+void test_IfCircularWithoutCallbacksThenNoInterruptIsUsed(void)
+{
+  myWave_Start(buf, TEST_STEPS, &pars);
+
+  TEST_ASSERT_NOT_CALLED(HAL_DMA_Start_IT);
+  TEST_ASSERT_NOT_CALLED(HAL_NVIC_EnableIRQ);
+  TEST_ASSERT_EQUAL(0, TIM1_Regs.DIER & TIM_DIER_UIE);
+}
+
+/**
+ * @brief The TIM should be set up to raise an update event at each step,
+ *          requesting the DMA instead of an interrupt.
+ */
+void test_IfStartedThenTIMRequestsDMAAtEachStep(void)
+{
+  myWave_Start(buf, TEST_STEPS, &pars);
+
+  TEST_ASSERT_CALLED(HAL_TIM_Base_Init);
+  TEST_ASSERT_CALLED(HAL_TIM_Base_Start);
+  TEST_ASSERT_NOT_CALLED(HAL_TIM_Base_Start_IT);
+  TEST_ASSERT_EQUAL_PTR(TIM1, HAL_TIM_Base_Init_fake.arg0_val->Instance);
+  TEST_ASSERT_EQUAL(TEST_CLOCK_HZ / 1000, (HAL_TIM_Base_Init_fake.arg0_val->Init.Prescaler + 1) *
+                                         (HAL_TIM_Base_Init_fake.arg0_val->Init.Period + 1));
+  TEST_ASSERT_EQUAL(TIM_DIER_UDE, TIM1_Regs.DIER & TIM_DIER_UDE);
+  TEST_ASSERT_TRUE(myWave_IsRunning());
+}
+
+/**
+ * @brief Short steps should be counted with no prescaler, for the best
+ *          resolution.
+ */
+void test_IfStepIsShortThenItIsNotPrescaled(void)
+{
+  pars.stepUs = 100;
+  myWave_Start(buf, TEST_STEPS, &pars);
+
+  TEST_ASSERT_EQUAL(0, HAL_TIM_Base_Init_fake.arg0_val->Init.Prescaler);
+  TEST_ASSERT_EQUAL((TEST_CLOCK_HZ / 10000) - 1, HAL_TIM_Base_Init_fake.arg0_val->Init.Period);
+}
+
+/**
+ * @brief Callbacks should be called from the DMA interrupts, at half and at
+ *          the end of the buffer.
+ */
+void test_IfCallbacksAreSetThenTheyAreCalledFromDMA(void)
+{
+  pars.halfCbk = halfCallback;
+  pars.doneCbk = doneCallback;
+  myWave_Start(buf, TEST_STEPS, &pars);
+
+  TEST_ASSERT_CALLED(HAL_DMA_Start_IT);
+  TEST_ASSERT_EQUAL(DMA1_Channel5_IRQn, HAL_NVIC_EnableIRQ_fake.arg0_val);
+
+  HAL_DMA_Start_IT_fake.arg0_val->XferHalfCpltCallback(HAL_DMA_Start_IT_fake.arg0_val);
+  TEST_ASSERT_EQUAL(1, halfCallCount);
+  TEST_ASSERT_EQUAL(0, doneCallCount);
+
+  HAL_DMA_Start_IT_fake.arg0_val->XferCpltCallback(HAL_DMA_Start_IT_fake.arg0_val);
+  TEST_ASSERT_EQUAL(1, doneCallCount);
+  TEST_ASSERT_TRUE(myWave_IsRunning());
+}
+
+/**
+ * @brief Only the callbacks that are set should take the DMA interrupts.
+ */
+void test_IfOnlyHalfCallbackIsSetThenCompleteIsNotTaken(void)
+{
+  pars.halfCbk = halfCallback;
+  myWave_Start(buf, TEST_STEPS, &pars);
+
+  TEST_ASSERT_NOT_NULL(HAL_DMA_Start_IT_fake.arg0_val->XferHalfCpltCallback);
+  TEST_ASSERT_NULL(HAL_DMA_Start_IT_fake.arg0_val->XferCpltCallback);
+}
+
+/**
+ * @brief A waveform that is not circular should stop the TIM by itself once
+ *          the whole buffer has been played.
+ */
+void test_IfNotCircularThenItStopsAtTheEnd(void)
+{
+  pars.circular = false;
+  myWave_Start(buf, TEST_STEPS, &pars);
+
+  TEST_ASSERT_EQUAL(DMA_NORMAL, HAL_DMA_Init_fake.arg0_val->Init.Mode);
+  TEST_ASSERT_CALLED(HAL_DMA_Start_IT);
+
+  HAL_DMA_Start_IT_fake.arg0_val->XferCpltCallback(HAL_DMA_Start_IT_fake.arg0_val);
+
+  TEST_ASSERT_CALLED(HAL_TIM_Base_Stop);
+  TEST_ASSERT_EQUAL(0, TIM1_Regs.DIER & TIM_DIER_UDE);
+  TEST_ASSERT_FALSE(myWave_IsRunning());
+}
+
+/**
+ * @brief Stopping a waveform should stop both the TIM and the DMA.
+ */
+void test_IfStoppedThenTIMAndDMAAreStopped(void)
+{
+  myWave_Start(buf, TEST_STEPS, &pars);
+  myWave_Stop();
+
+  TEST_ASSERT_CALLED(HAL_TIM_Base_Stop);
+  TEST_ASSERT_CALLED(HAL_DMA_Abort);
+  TEST_ASSERT_EQUAL(0, TIM1_Regs.DIER & TIM_DIER_UDE);
+  TEST_ASSERT_FALSE(myWave_IsRunning());
+}
+
+/**
+ * @brief Stopping when nothing is being played should do nothing.
+ */
+void test_IfNotRunningThenStopDoesNothing(void)
+{
+  myWave_Stop();
+
+  TEST_ASSERT_NOT_CALLED(HAL_TIM_Base_Stop);
+  TEST_ASSERT_NOT_CALLED(HAL_DMA_Abort);
+}
+
+/**
+ * @brief Starting while a waveform is being played should stop it first.
+ */
+void test_IfStartedWhileRunningThenOldOneIsStopped(void)
+{
+  myWave_Start(buf, TEST_STEPS, &pars);
+  myWave_Start(buf, TEST_STEPS, &pars);
+
+  TEST_ASSERT_CALLED_TIMES(1, HAL_DMA_Abort);
+  TEST_ASSERT_CALLED_TIMES(2, HAL_DMA_Start);
+  TEST_ASSERT_TRUE(myWave_IsRunning());
+}
+
+/**
+ * @brief DMA interrupt handler should be handled by the HAL.
+ */
+void test_IfDMAInterruptIsRaisedThenHALHandlesIt(void)
+{
+  DMA1_Channel5_IRQHandler();
+
+  TEST_ASSERT_CALLED(HAL_DMA_IRQHandler);
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static void halfCallback(void)
+{
+  halfCallCount++;
+}
+
+static void doneCallback(void)
+{
+  doneCallCount++;
+}
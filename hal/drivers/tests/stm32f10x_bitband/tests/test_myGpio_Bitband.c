@@ -0,0 +1,151 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test_myGpio_Bitband.c
+ * @brief Test file for testing gpio driver logic, operation when single pins
+ *          are accessed through their bit-band alias.
+ *
+ * The fake peripheral region puts the GPIO registers at their device offsets,
+ *  and has a fake bit-band region of its own, so the tests check that each
+ *  pin is reached through the word that aliases its bit. The host does not
+ *  map the alias onto the registers, which is the hardware's part.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+#include "myTestCode.h"
+
+#include "myGpio.h"
+#include "myDriverDefs.h"
+
+#include "mock_stm32f1xx_hal.h"
+#include "mock_stm32f1xx_hal_gpio.h"
+#include "mock_stm32f1xx_hal_rcc.h"
+
+#include <string.h>
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_MY_GPIO_PORT                                        myDriverPort_PB
+#define TEST_MY_GPIO_PIN                                          myDriverPin_09
+
+/* Offsets of IDR and ODR of GPIOB from the start of the peripheral region,   */
+/*  as the reference manual gives them.                                       */
+#define TEST_GPIOB_IDR_OFFSET                                          (0x10C08)
+#define TEST_GPIOB_ODR_OFFSET                                          (0x10C0C)
+
+/* Word of the fake bit-band region that aliases a bit of the register at a   */
+/*  given offset.                                                             */
+#define TEST_ALIAS(OFFSET, BIT)                  PERIPH_BB_Mem[((OFFSET) * 8) + (BIT)]
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static myGpioPin_t pin;
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  myGpioPars_t pars = { TEST_MY_GPIO_PORT, TEST_MY_GPIO_PIN, myGpioDir_Outp, myGpioPull_No };
+
+  memset(PERIPH_Mem, 0, sizeof(PERIPH_Mem));
+  memset(PERIPH_BB_Mem, 0, sizeof(PERIPH_BB_Mem));
+  myGpio_Reset();
+  myGpio_Init(&pin, &pars);
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief Setting a pin should store the level to the alias of its ODR bit,
+ *          and to no other register nor alias.
+ */
+void test_SetStoresToTheAliasOfODR(void)
+{
+  myGpio_Set(pin, myGpioLvl_Hi);
+  TEST_ASSERT_EQUAL(1, TEST_ALIAS(TEST_GPIOB_ODR_OFFSET, TEST_MY_GPIO_PIN));
+
+  myGpio_Set(pin, myGpioLvl_Lo);
+  TEST_ASSERT_EQUAL(0, TEST_ALIAS(TEST_GPIOB_ODR_OFFSET, TEST_MY_GPIO_PIN));
+
+  TEST_ASSERT_EQUAL_HEX32(0, GPIOB_Regs.BSRR);
+  TEST_ASSERT_EQUAL_HEX32(0, GPIOB_Regs.ODR);
+  TEST_ASSERT_NOT_CALLED(HAL_GPIO_WritePin);
+}
+
+/**
+ * @brief Getting a pin should load the alias of its IDR bit.
+ */
+void test_GetLoadsTheAliasOfIDR(void)
+{
+  GPIOB_Regs.IDR = 0xFFFF;
+  TEST_ASSERT_EQUAL(myGpioLvl_Lo, myGpio_Get(pin));
+
+  TEST_ALIAS(TEST_GPIOB_IDR_OFFSET, TEST_MY_GPIO_PIN) = 1;
+  TEST_ASSERT_EQUAL(myGpioLvl_Hi, myGpio_Get(pin));
+
+  TEST_ASSERT_NOT_CALLED(HAL_GPIO_ReadPin);
+}
+
+/**
+ * @brief Toggling a pin should write the other level to the alias of its ODR
+ *          bit.
+ */
+void test_ToggleFlipsTheAliasOfODR(void)
+{
+  myGpio_Toggle(pin);
+  TEST_ASSERT_EQUAL(1, TEST_ALIAS(TEST_GPIOB_ODR_OFFSET, TEST_MY_GPIO_PIN));
+
+  myGpio_Toggle(pin);
+  TEST_ASSERT_EQUAL(0, TEST_ALIAS(TEST_GPIOB_ODR_OFFSET, TEST_MY_GPIO_PIN));
+
+  TEST_ASSERT_NOT_CALLED(HAL_GPIO_TogglePin);
+}
+
+/**
+ * @brief Measures the code of a set and a toggle through the bit-band alias,
+ *          to compare with the HAL backend. Neither should call anything.
+ */
+void test_BenchmarkToggle(void)
+{
+  myTestCode_t set, toggle;
+
+  if((myTestCode_Inspect("myGpio_Set", &set) != myRet_OK) || (myTestCode_Inspect("myGpio_Toggle", &toggle) != myRet_OK))
+  {
+    TEST_IGNORE_MESSAGE("Cannot disassemble the test executable.");
+  }
+
+  printf("myGpio_Set over bit-band: %u instructions, %u calls\n", set.instructions, set.calls);
+  printf("myGpio_Toggle over bit-band: %u instructions, %u calls\n", toggle.instructions, toggle.calls);
+  TEST_ASSERT_EQUAL(0, set.calls);
+  TEST_ASSERT_EQUAL(0, toggle.calls);
+}
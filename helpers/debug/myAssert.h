@@ -18,7 +18,10 @@
  * @file myAssert.h
  * @brief Header file containing definitions for logic assertion.
  *
- * This file contains macros for asserting operations.
+ * This file contains macros for asserting operations. A failed assertion is
+ *  handed to myCrash_Assert, which the fault driver of the platform provides,
+ *  and which keeps a record of it, with the file and the line where it
+ *  failed, through the reset that follows.
  */
  
 #ifndef MY_ASSERT_H
@@ -28,10 +31,21 @@
  *  INCLUDES
  ******************************************************************************/
 #include "myDefs.h"
+#include "myCrash.h"
 
 /*******************************************************************************
  *  PUBLIC DEFINITIONS
  ******************************************************************************/
-#define myASSERT(EXP) if((EXP) == false) { while(1); }
+/**
+ * @brief Identifier of the file of an assertion. It is the address of the
+ *          name of the file by default, which is looked up in the ELF file of
+ *          the firmware, so each file costs the flash of its name. A file may
+ *          define its own number before including this header.
+ */
+#ifndef MY_FILE_ID
+  #define MY_FILE_ID                             ((uint32_t)(uintptr_t)__FILE__)
+#endif
+
+#define myASSERT(EXP) if((EXP) == false) { myCrash_Assert(MY_FILE_ID, __LINE__, __builtin_return_address(0)); }
 
 #endif
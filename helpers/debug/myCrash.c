@@ -0,0 +1,186 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file myCrash.c
+ * @brief Source file for the crash record, which keeps what went wrong
+ *          through the reset that follows a failed assertion or a fault.
+ *
+ * The CRC is the usual CRC-32 (the one of Ethernet and zlib), computed four
+ *  bits at a time from a table of 16 words. It is slower than the full table
+ *  of 256 words, but it only runs on a crash and once at boot.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "myCrash.h"
+
+#include <stddef.h>
+#include <string.h>
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+/* Amount of bytes covered by the CRC, which are all those before it.         */
+#define MY_CRASH_CRC_SIZE                         offsetof(myCrashRecord_t, crc)
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static uint32_t myCrash_Crc(const uint8_t * data, uint32_t size);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+/* Record kept through resets, never touched by the startup code.             */
+static myCrashRecord_t myCrash_Kept __attribute__((section(MY_CRASH_SECTION)));
+
+/* Copy of the record of the previous run, taken at boot.                     */
+static myCrashRecord_t myCrash_Last;
+static bool myCrash_HasLast = false;
+
+/* CRC-32 (reflected 0x04C11DB7) of each of the 16 values of a nibble.        */
+static const uint32_t myCrash_CrcTable[16] =
+{
+  0x00000000UL, 0x1DB71064UL, 0x3B6E20C8UL, 0x26D930ACUL,
+  0x76DC4190UL, 0x6B6B51F4UL, 0x4DB26158UL, 0x5005713CUL,
+  0xEDB88320UL, 0xF00F9344UL, 0xD6D6A3E8UL, 0xCB61B38CUL,
+  0x9B64C2B0UL, 0x86D3D2D4UL, 0xA00AE278UL, 0xBDBDF21CUL,
+};
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES
+ ******************************************************************************/
+/**
+ * @brief Seals a record, setting its magic word and its CRC.
+ * @param rec Record to seal, with all the other fields already set.
+ */
+void myCrash_Seal(myCrashRecord_t * rec)
+{
+  rec->magic = MY_CRASH_MAGIC;
+  rec->crc = myCrash_Crc((const uint8_t *)rec, MY_CRASH_CRC_SIZE);
+}
+
+/**
+ * @brief Tells if a record was sealed and left untouched since then.
+ * @param rec Record to check.
+ * @return True if both its magic word and its CRC match, false otherwise.
+ */
+bool myCrash_IsValid(const myCrashRecord_t * rec)
+{
+  bool result = false;
+
+  if(rec->magic == MY_CRASH_MAGIC)
+  {
+    result = (rec->crc == myCrash_Crc((const uint8_t *)rec, MY_CRASH_CRC_SIZE));
+  }
+
+  return result;
+}
+
+/**
+ * @brief Writes and seals the record that is kept through the next reset.
+ * @param cause What caused the crash.
+ * @param frame Registers at the moment of the crash. NULL to clear them.
+ * @param fileId Identifier of the file of a failed assertion, zero for faults.
+ * @param line Line of a failed assertion, zero for faults.
+ * @param status Fault status register, when the core has one.
+ * @param timestamp Time of the crash, in ms.
+ */
+void myCrash_Save(myCrashCause_t cause, const myCrashFrame_t * frame, uint32_t fileId, uint32_t line, uint32_t status, uint32_t timestamp)
+{
+  myCrash_Kept.cause = (uint32_t)cause;
+  myCrash_Kept.fileId = fileId;
+  myCrash_Kept.line = line;
+  myCrash_Kept.status = status;
+  myCrash_Kept.timestamp = timestamp;
+
+  if(frame != NULL) { myCrash_Kept.frame = *frame; }
+  else              { memset(&myCrash_Kept.frame, 0, sizeof(myCrashFrame_t)); }
+
+  myCrash_Seal(&myCrash_Kept);
+}
+
+/**
+ * @brief Takes the record left by the previous run, if it is valid, and
+ *          clears it.
+ */
+void myCrash_Init(void)
+{
+  myCrash_HasLast = myCrash_IsValid(&myCrash_Kept);
+  if(myCrash_HasLast == true) { myCrash_Last = myCrash_Kept; }
+
+  /* Clearing the magic word is enough for the next boot to ignore it.        */
+  myCrash_Kept.magic = 0;
+}
+
+/**
+ * @brief Gets the record taken by myCrash_Init.
+ * @return The record, or NULL if the previous run did not crash.
+ */
+const myCrashRecord_t * myCrash_GetLast(void)
+{
+  return (myCrash_HasLast == true) ? &myCrash_Last : NULL;
+}
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES - TEST PURPOSES
+ ******************************************************************************/
+#ifdef TEST
+/**
+ * @brief Resets crash's internal logic and its variables.
+ */
+void myCrash_Reset(void)
+{
+  memset(&myCrash_Kept, 0, sizeof(myCrashRecord_t));
+  memset(&myCrash_Last, 0, sizeof(myCrashRecord_t));
+  myCrash_HasLast = false;
+}
+
+/**
+ * @brief Gets the record kept through resets.
+ * @return The record kept through resets.
+ */
+myCrashRecord_t * myCrash_GetKept(void)
+{
+  return &myCrash_Kept;
+}
+#endif
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+/**
+ * @brief Computes the CRC-32 of a block of bytes.
+ * @param data Bytes to compute the CRC of.
+ * @param size Amount of bytes.
+ * @return The CRC-32 of the block.
+ */
+static uint32_t myCrash_Crc(const uint8_t * data, uint32_t size)
+{
+  uint32_t crc = 0xFFFFFFFFUL;
+
+  while(size-- > 0)
+  {
+    crc ^= *data++;
+    crc = (crc >> 4) ^ myCrash_CrcTable[crc & 0x0F];
+    crc = (crc >> 4) ^ myCrash_CrcTable[crc & 0x0F];
+  }
+
+  return ~crc;
+}
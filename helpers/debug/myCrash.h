@@ -0,0 +1,178 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file myCrash.h
+ * @brief Header file for the crash record, which keeps what went wrong
+ *          through the reset that follows a failed assertion or a fault.
+ *
+ * The record lives in a section that the startup code neither clears nor
+ *  loads, so it is still there after a warm reset. It is sealed with a magic
+ *  word and a CRC, which tell a record that was written on purpose apart from
+ *  the garbage found in RAM after a power up, or from one that was only half
+ *  written when the core locked up.
+ *
+ * At boot, myCrash_Init takes the record out of that section and clears it,
+ *  so that each crash is reported only once.
+ */
+
+#ifndef MY_CRASH_H
+#define MY_CRASH_H
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "myDefs.h"
+
+/*******************************************************************************
+ *  PUBLIC DEFINITIONS
+ ******************************************************************************/
+/**
+ * @brief Section where the record is kept. The linker script must place it
+ *          outside of the data and the zeroed data of the startup code.
+ */
+#ifndef MY_CRASH_SECTION
+  #define MY_CRASH_SECTION                                             ".noinit"
+#endif
+
+/**
+ * @brief Word that marks a sealed record.
+ */
+#define MY_CRASH_MAGIC                                              0xC4A5E7EDUL
+
+/**
+ * @brief What caused the crash. Faults take the number of their exception,
+ *          so that the routine that handles all of them can tell them apart
+ *          from IPSR alone.
+ */
+typedef enum
+{
+  myCrashCause_Assert = 0,
+  myCrashCause_Nmi = 2,
+  myCrashCause_HardFault = 3,
+  myCrashCause_MemManage = 4,
+  myCrashCause_BusFault = 5,
+  myCrashCause_UsageFault = 6,
+} myCrashCause_t;
+
+/**
+ * @brief Registers in the order the core stacks them when it takes an
+ *          exception. Failed assertions only fill the LR and the PC.
+ */
+typedef struct
+{
+  uint32_t r0;
+  uint32_t r1;
+  uint32_t r2;
+  uint32_t r3;
+  uint32_t r12;
+  uint32_t lr;
+  uint32_t pc;
+  uint32_t xpsr;
+} myCrashFrame_t;
+
+/**
+ * @brief Record of a crash. All its fields are 32-bit words, so that it has
+ *          the same layout on the target and on the host that decodes it.
+ */
+typedef struct
+{
+  uint32_t magic;
+  uint32_t cause;
+  uint32_t fileId;
+  uint32_t line;
+  myCrashFrame_t frame;
+  uint32_t status;
+  uint32_t timestamp;
+  uint32_t crc;
+} myCrashRecord_t;
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES
+ ******************************************************************************/
+/**
+ * @brief Seals a record, setting its magic word and its CRC over all the
+ *          fields before the latter.
+ * @param rec Record to seal, with all the other fields already set.
+ */
+void myCrash_Seal(myCrashRecord_t * rec);
+
+/**
+ * @brief Tells if a record was sealed and left untouched since then.
+ * @param rec Record to check.
+ * @return True if both its magic word and its CRC match, false otherwise.
+ */
+bool myCrash_IsValid(const myCrashRecord_t * rec);
+
+/**
+ * @brief Writes and seals the record that is kept through the next reset.
+ *          It is meant to be called once, right before the reset or the
+ *          hang that follows a crash.
+ * @param cause What caused the crash.
+ * @param frame Registers at the moment of the crash. NULL to clear them.
+ * @param fileId Identifier of the file of a failed assertion, zero for faults.
+ * @param line Line of a failed assertion, zero for faults.
+ * @param status Fault status register, when the core has one.
+ * @param timestamp Time of the crash, in ms.
+ */
+void myCrash_Save(myCrashCause_t cause, const myCrashFrame_t * frame, uint32_t fileId, uint32_t line, uint32_t status, uint32_t timestamp);
+
+/**
+ * @brief Takes the record left by the previous run, if it is valid, and
+ *          clears it. It should be called once at boot, before anything
+ *          that may crash again.
+ */
+void myCrash_Init(void);
+
+/**
+ * @brief Gets the record taken by myCrash_Init.
+ * @return The record, or NULL if the previous run did not crash.
+ */
+const myCrashRecord_t * myCrash_GetLast(void);
+
+/**
+ * @brief Handles a failed assertion. It never returns.
+ *
+ * It is meant to be called by myASSERT, which hands the caller of the routine
+ *  that failed so that the record tells which path led to it. It is not
+ *  defined here but by the fault driver of the platform, which knows how to
+ *  capture the registers, save the record and then hang or reset.
+ *
+ * @param fileId Identifier of the file of the assertion.
+ * @param line Line of the assertion.
+ * @param lr Return address of the routine where the assertion failed.
+ */
+void myCrash_Assert(uint32_t fileId, uint32_t line, void * lr) __attribute__((noreturn));
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES - TEST PURPOSES
+ ******************************************************************************/
+#ifdef TEST
+/**
+ * @brief Resets crash's internal logic and its variables.
+ */
+void myCrash_Reset(void);
+
+/**
+ * @brief Gets the record kept through resets, so that it can be corrupted
+ *          as it would be after a power up.
+ * @return The record kept through resets.
+ */
+myCrashRecord_t * myCrash_GetKept(void);
+#endif
+
+#endif
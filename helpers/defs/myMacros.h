@@ -39,4 +39,11 @@
  */
 #define MY_ARRAY_SIZE(ARR)                          (sizeof(ARR)/sizeof(ARR[0]))
 
+/**
+ * @brief Macro to get the position of the highest bit set in a 32-bit mask,
+ *          which must not be zero. It takes a constant time, as it counts
+ *          the leading zeros instead of scanning the bits.
+ */
+#define MY_HIGHEST_BIT(MASK)                          (31 - __builtin_clz(MASK))
+
 #endif
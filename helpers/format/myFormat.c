@@ -0,0 +1,292 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file myFormat.c
+ * @brief Source file for the conversion of numbers to digits, without
+ *          divisions.
+ *
+ * Dividing by 100 takes a multiplication by 5243 and a shift, which is exact
+ *  below 43699 and fits 32 bits, so a single MULS on the M0+. Dividing by
+ *  10000 takes a 32x32 to 64-bit multiplication, exact for any 32-bit number.
+ *  Both beat a library division by far, and each takes two or four digits at
+ *  once, while the digits of each pair come from a table.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "myFormat.h"
+
+#include <string.h>
+
+#include "myAssert.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define MY_FORMAT_DIV100(X)                               (((X) * 5243UL) >> 19)
+#define MY_FORMAT_DIV10000(X)         ((uint32_t) (((X) * 0xD1B71759ULL) >> 45))
+#define MY_FORMAT_1E9                                            (1000000000ULL)
+
+/* Set below the layout of an IEEE 754 double.                                */
+#define MY_FORMAT_MANTISSA_BITS                                               52
+#define MY_FORMAT_EXPONENT_MASK                                            0x7FF
+#define MY_FORMAT_EXPONENT_BIAS                                             1023
+#define MY_FORMAT_SIGN_SHIFT                                                  63
+
+/* Fractions are kept with up to 60 bits, so that ten times them fits 64.     */
+#define MY_FORMAT_FRACTION_BITS                                               60
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static void writePair(uint32_t pair, char * digits);
+static void writeQuad(uint32_t quad, char * digits);
+static uint32_t writeSmall(uint32_t value, char * digits);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static const char myFormat_Pairs[] =
+  "0001020304050607080910111213141516171819"
+  "2021222324252627282930313233343536373839"
+  "4041424344454647484950515253545556575859"
+  "6061626364656667686970717273747576777879"
+  "8081828384858687888990919293949596979899";
+
+static const char myFormat_Lower[] = "0123456789abcdef";
+static const char myFormat_Upper[] = "0123456789ABCDEF";
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES
+ ******************************************************************************/
+/**
+ * @brief Writes the decimal digits of a 32-bit number.
+ * @param value Number to convert.
+ * @param digits Written with the digits, least significant first. It must
+ *          fit 10 of them.
+ * @return Amount of digits written, at least one.
+ */
+uint32_t myFormat_Dec(uint32_t value, char * digits)
+{
+  uint32_t count = 0;
+
+  while(value >= 10000)
+  {
+    const uint32_t high = MY_FORMAT_DIV10000(value);
+
+    writeQuad(value - (high * 10000), &digits[count]);
+    count += 4;
+    value = high;
+  }
+
+  return count + writeSmall(value, &digits[count]);
+}
+
+/**
+ * @brief Writes the decimal digits of a 64-bit number.
+ * @param value Number to convert.
+ * @param digits Written with the digits, least significant first. It must
+ *          fit 20 of them.
+ * @return Amount of digits written, at least one.
+ */
+uint32_t myFormat_Dec64(uint64_t value, char * digits)
+{
+  uint32_t count = 0;
+
+  while(value > UINT32_MAX)
+  {
+    const uint64_t high = value / MY_FORMAT_1E9;
+    const uint32_t low = (uint32_t) (value - (high * MY_FORMAT_1E9));
+    const uint32_t mid = MY_FORMAT_DIV10000(low);
+    const uint32_t top = MY_FORMAT_DIV10000(mid);
+
+    writeQuad(low - (mid * 10000), &digits[count]);
+    writeQuad(mid - (top * 10000), &digits[count + 4]);
+    digits[count + 8] = (char) ('0' + top);
+    count += 9;
+    value = high;
+  }
+
+  return count + myFormat_Dec((uint32_t) value, &digits[count]);
+}
+
+/**
+ * @brief Writes the digits of a number in a power of two base: binary, octal
+ *          or hexadecimal.
+ * @param value Number to convert.
+ * @param shift Bits per digit, from 1 (binary) to 4 (hexadecimal).
+ * @param caps Whether hexadecimal digits are upper case.
+ * @param digits Written with the digits, least significant first. It must
+ *          fit MY_FORMAT_MAX_DIGITS of them.
+ * @return Amount of digits written, at least one.
+ */
+uint32_t myFormat_Pow2(uint64_t value, uint32_t shift, bool caps, char * digits)
+{
+  myASSERT((shift >= 1) && (shift <= 4));
+
+  const char * chars = caps ? myFormat_Upper : myFormat_Lower;
+  const uint32_t mask = (1UL << shift) - 1;
+  uint32_t count = 0;
+
+  /* Shifting 64 bits takes a few instructions on the M0+, so only do it      */
+  /*  while the upper half has anything left.                                 */
+  while((value >> 32) != 0)
+  {
+    digits[count++] = chars[(uint32_t) value & mask];
+    value >>= shift;
+  }
+
+  uint32_t low = (uint32_t) value;
+  do
+  {
+    digits[count++] = chars[low & mask];
+    low >>= shift;
+  } while(low != 0);
+
+  return count;
+}
+
+/**
+ * @brief Writes a floating point number in fixed-point, as the fractional
+ *          digits, a point and the integer digits, rounding half away from
+ *          zero.
+ * @param value Number to convert.
+ * @param precision Amount of fractional digits.
+ * @param digits Written with the digits, least significant first. It must
+ *          fit precision + 11 of them.
+ * @return Amount of digits written, point included.
+ */
+uint32_t myFormat_Fixed(double value, uint32_t precision, char * digits)
+{
+  uint64_t bits;
+  uint64_t integer = 0;
+  uint64_t fraction = 0;
+  uint32_t fractionBits = 0;
+
+  memcpy(&bits, &value, sizeof(bits));
+
+  const bool negative = (bits >> MY_FORMAT_SIGN_SHIFT) != 0;
+  const uint32_t biased = (uint32_t) (bits >> MY_FORMAT_MANTISSA_BITS) & MY_FORMAT_EXPONENT_MASK;
+  uint64_t mantissa = bits & ((1ULL << MY_FORMAT_MANTISSA_BITS) - 1);
+  int32_t exponent = (int32_t) biased - MY_FORMAT_EXPONENT_BIAS;
+
+  /* Set below the integer part, and the fraction as fractionBits bits.       */
+  if(biased == MY_FORMAT_EXPONENT_MASK)
+  {
+    integer = (mantissa != 0) ? 0 : UINT32_MAX;
+  }
+  else
+  {
+    if(biased != 0) { mantissa |= (1ULL << MY_FORMAT_MANTISSA_BITS); }
+    else            { exponent++; }
+
+    if(exponent >= 32)
+    {
+      integer = UINT32_MAX;
+    }
+    else if(exponent >= 0)
+    {
+      fractionBits = MY_FORMAT_MANTISSA_BITS - (uint32_t) exponent;
+      integer = mantissa >> fractionBits;
+      fraction = mantissa & ((1ULL << fractionBits) - 1);
+    }
+    else if((MY_FORMAT_MANTISSA_BITS - exponent) <= MY_FORMAT_FRACTION_BITS)
+    {
+      fractionBits = MY_FORMAT_MANTISSA_BITS - (uint32_t) exponent;
+      fraction = mantissa;
+    }
+    else
+    {
+      const uint32_t dropped = (MY_FORMAT_MANTISSA_BITS - (uint32_t) exponent) - MY_FORMAT_FRACTION_BITS;
+
+      fractionBits = MY_FORMAT_FRACTION_BITS;
+      fraction = (dropped < 64) ? (mantissa >> dropped) : 0;
+    }
+  }
+
+  /* The fractional digits come most significant first, so fill backwards.    */
+  const uint64_t fractionMask = (fractionBits > 0) ? ((1ULL << fractionBits) - 1) : 0;
+  for(uint32_t idx = precision; idx > 0; idx--)
+  {
+    fraction *= 10;
+    digits[idx - 1] = (char) ('0' + (uint32_t) (fraction >> fractionBits));
+    fraction &= fractionMask;
+  }
+
+  /* Round what is left, carrying over the nines and into the integer.        */
+  if((fractionBits > 0) && ((fraction >> (fractionBits - 1)) != 0))
+  {
+    uint32_t idx = 0;
+
+    while((idx < precision) && (digits[idx] == '9')) { digits[idx++] = '0'; }
+
+    if(idx < precision) { digits[idx]++; }
+    else                { integer++; }
+  }
+
+  digits[precision] = '.';
+
+  const uint64_t limit = negative ? (1ULL << 31) : INT32_MAX;
+  if(integer > limit) { integer = limit; }
+
+  return precision + 1 + myFormat_Dec((uint32_t) integer, &digits[precision + 1]);
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static void writePair(uint32_t pair, char * digits)
+{
+  digits[0] = myFormat_Pairs[(2 * pair) + 1];
+  digits[1] = myFormat_Pairs[2 * pair];
+}
+
+static void writeQuad(uint32_t quad, char * digits)
+{
+  const uint32_t high = MY_FORMAT_DIV100(quad);
+
+  writePair(quad - (high * 100), &digits[0]);
+  writePair(high, &digits[2]);
+}
+
+static uint32_t writeSmall(uint32_t value, char * digits)
+{
+  uint32_t count = 0;
+
+  while(value >= 100)
+  {
+    const uint32_t high = MY_FORMAT_DIV100(value);
+
+    writePair(value - (high * 100), &digits[count]);
+    count += 2;
+    value = high;
+  }
+
+  if(value >= 10)
+  {
+    writePair(value, &digits[count]);
+    count += 2;
+  }
+  else
+  {
+    digits[count++] = (char) ('0' + value);
+  }
+
+  return count;
+}
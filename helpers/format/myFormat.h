@@ -0,0 +1,105 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file myFormat.h
+ * @brief Header file for the conversion of numbers to digits, without
+ *          divisions.
+ *
+ * The M0+ has no divide instruction, so converting a number one division per
+ *  digit calls the library division for each of them. These routines take
+ *  the decimal digits two at a time from a table, dividing by 100 and 10000
+ *  with reciprocal multiplications instead, take the digits of the powers of
+ *  two with shifts, and print floating point numbers in fixed-point straight
+ *  from their bits, with integer math only.
+ *
+ * Digits are written least significant first, which is the order they come
+ *  out in, so the caller prints them backwards, as the SDK debug console
+ *  does. They are not terminated, and the routines return how many they
+ *  wrote. No sign is ever written.
+ */
+
+#ifndef MY_FORMAT_H
+#define MY_FORMAT_H
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "myDefs.h"
+
+/*******************************************************************************
+ *  PUBLIC DEFINITIONS
+ ******************************************************************************/
+/**
+ * @brief Maximum amount of digits written for a 64-bit number, which is in
+ *          binary.
+ */
+#define MY_FORMAT_MAX_DIGITS                                                  64
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES
+ ******************************************************************************/
+/**
+ * @brief Writes the decimal digits of a 32-bit number.
+ * @param value Number to convert.
+ * @param digits Written with the digits, least significant first. It must
+ *          fit 10 of them.
+ * @return Amount of digits written, at least one.
+ */
+uint32_t myFormat_Dec(uint32_t value, char * digits);
+
+/**
+ * @brief Writes the decimal digits of a 64-bit number. Numbers that fit 32
+ *          bits cost the same as with myFormat_Dec, and larger ones take a
+ *          64-bit division for every nine digits above them.
+ * @param value Number to convert.
+ * @param digits Written with the digits, least significant first. It must
+ *          fit 20 of them.
+ * @return Amount of digits written, at least one.
+ */
+uint32_t myFormat_Dec64(uint64_t value, char * digits);
+
+/**
+ * @brief Writes the digits of a number in a power of two base: binary, octal
+ *          or hexadecimal.
+ * @param value Number to convert.
+ * @param shift Bits per digit, from 1 (binary) to 4 (hexadecimal).
+ * @param caps Whether hexadecimal digits are upper case.
+ * @param digits Written with the digits, least significant first. It must
+ *          fit MY_FORMAT_MAX_DIGITS of them.
+ * @return Amount of digits written, at least one.
+ */
+uint32_t myFormat_Pow2(uint64_t value, uint32_t shift, bool caps, char * digits);
+
+/**
+ * @brief Writes a floating point number in fixed-point, as the fractional
+ *          digits, a point and the integer digits, rounding half away from
+ *          zero.
+ *
+ * The number is taken apart from its bits, so no floating point math is
+ *  done at all. The integer part saturates as a conversion to int32_t does,
+ *  and a NaN is written as zero. Bits below 2^-60 are ignored.
+ *
+ * @param value Number to convert.
+ * @param precision Amount of fractional digits.
+ * @param digits Written with the digits, least significant first. It must
+ *          fit precision + 11 of them.
+ * @return Amount of digits written, point included.
+ */
+uint32_t myFormat_Fixed(double value, uint32_t precision, char * digits);
+
+#endif
@@ -0,0 +1,220 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file myDebounce.c
+ * @brief Source file for the bit-sliced input debouncer.
+ *
+ * Instead of a state machine per input, each field of the debouncer holds
+ *  the same variable for all its inputs, one per bit, so every operation
+ *  below works on the 32 inputs at once (bit slicing).
+ *
+ * Debouncing uses a vertical counter: cnt0 and cnt1 are the two bits of a
+ *  counter per input, which is reset while the sample matches the debounced
+ *  state, and counts the ticks in a row with a different sample otherwise.
+ *  After four of them the state flips, which takes eight logic operations.
+ *
+ * Timing uses a wider vertical counter, whose bit N for all the inputs is in
+ *  ticks[N]. It is restarted whenever an input flips, and counts the ticks
+ *  that it is held, for long presses, or the ticks since it was released,
+ *  for double clicks. An input is armed while a second press would make a
+ *  double click, and reported while its press was already reported as a
+ *  long press or a double click, and so is not a click.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "myDebounce.h"
+
+#include "myAssert.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static void countTicks(myDebounce_t * deb, uint32_t inputs);
+static void clearTicks(myDebounce_t * deb, uint32_t inputs);
+static uint32_t ticksEqual(myDebounce_t * deb, uint32_t value);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES
+ ******************************************************************************/
+/**
+ * @brief Initializes a debouncer, with all its inputs released.
+ * @param deb Debouncer to initialize.
+ * @param pars Structure containing all the data required to initialize it.
+ * @return Success / Failure
+ */
+myRet_t myDebounce_Init(myDebounce_t * deb, myDebouncePars_t * pars)
+{
+  myRet_t result = myRet_Fail;
+
+  myASSERT(deb != NULL);
+  myASSERT(pars != NULL);
+
+  if((deb != NULL) && (pars != NULL))
+  {
+    myASSERT(pars->longTicks <= MY_DEBOUNCE_TICKS_MAX);
+    myASSERT(pars->doubleTicks <= MY_DEBOUNCE_TICKS_MAX);
+
+    if((pars->longTicks <= MY_DEBOUNCE_TICKS_MAX) && (pars->doubleTicks <= MY_DEBOUNCE_TICKS_MAX))
+    {
+      *deb = (myDebounce_t) { 0 };
+
+      /* Both bits set is the reset value of the debouncing counter.          */
+      deb->cnt0 = UINT32_MAX;
+      deb->cnt1 = UINT32_MAX;
+
+      deb->invert = pars->invert;
+      deb->longTicks = pars->longTicks;
+      deb->doubleTicks = pars->doubleTicks;
+      result = myRet_OK;
+    }
+  }
+
+  return result;
+}
+
+/**
+ * @brief Feeds a debouncer with a new sample of its inputs.
+ * @param deb Debouncer to feed.
+ * @param sample Levels of the inputs, one bit per input.
+ * @param evts Written with the events of this tick.
+ * @return True if any event was reported, false otherwise.
+ */
+bool myDebounce_Update(myDebounce_t * deb, uint32_t sample, myDebounceEvts_t * evts)
+{
+  uint32_t flip, press, release, running;
+
+  myASSERT(deb != NULL);
+  myASSERT(evts != NULL);
+
+  /* Debounce: inputs whose sample differs from their state count one tick,   */
+  /*  and the others are reset. The ones that reach four ticks flip.          */
+  flip = deb->state ^ (sample ^ deb->invert);
+  deb->cnt0 = ~(deb->cnt0 & flip);
+  deb->cnt1 = deb->cnt0 ^ (deb->cnt1 & flip);
+  flip &= deb->cnt0 & deb->cnt1;
+  deb->state ^= flip;
+
+  press = flip & deb->state;
+  release = flip & ~deb->state;
+
+  evts->press = press;
+  evts->release = release;
+  evts->longPress = 0;
+
+  /* A press of an armed input is the second click of a double click. A       */
+  /*  release arms the input, unless its press was not a click.               */
+  evts->doubleClick = press & deb->armed;
+  deb->armed &= ~press;
+  if(deb->doubleTicks != 0) { deb->armed |= release & ~deb->reported; }
+  deb->reported = (deb->reported & ~flip) | evts->doubleClick;
+
+  /* Flipped inputs restart their tick count. Nothing else is left to do if   */
+  /*  no input is pressed nor armed, which is most of the ticks.              */
+  if(flip != 0) { clearTicks(deb, flip); }
+
+  running = deb->state | deb->armed;
+  if(running != 0)
+  {
+    countTicks(deb, running);
+
+    if(deb->longTicks != 0)
+    {
+      evts->longPress = deb->state & ~deb->reported & ticksEqual(deb, deb->longTicks);
+      deb->reported |= evts->longPress;
+    }
+
+    if(deb->armed != 0) { deb->armed &= ~ticksEqual(deb, deb->doubleTicks); }
+  }
+
+  return ((flip | evts->longPress) != 0);
+}
+
+/**
+ * @brief Gets which inputs are currently pressed, after debouncing.
+ * @param deb Debouncer to check.
+ * @return One bit set per pressed input.
+ */
+uint32_t myDebounce_GetState(myDebounce_t * deb)
+{
+  myASSERT(deb != NULL);
+
+  return deb->state;
+}
+
+/**
+ * @brief Tells if a debouncer has nothing left to do until an input changes.
+ * @param deb Debouncer to check.
+ * @return True if it is idle, false otherwise.
+ */
+bool myDebounce_IsIdle(myDebounce_t * deb)
+{
+  myASSERT(deb != NULL);
+
+  return ((deb->state | deb->armed) == 0) && ((deb->cnt0 & deb->cnt1) == UINT32_MAX);
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static void countTicks(myDebounce_t * deb, uint32_t inputs)
+{
+  uint32_t carry, full, bit;
+
+  /* Inputs whose count has all its bits set stay there instead of wrapping.  */
+  full = UINT32_MAX;
+  for(bit = 0; bit < MY_DEBOUNCE_COUNTER_BITS; bit++) { full &= deb->ticks[bit]; }
+
+  /* Ripple carry adder, for all the inputs at once.                          */
+  carry = inputs & ~full;
+  for(bit = 0; (bit < MY_DEBOUNCE_COUNTER_BITS) && (carry != 0); bit++)
+  {
+    const uint32_t next = deb->ticks[bit] & carry;
+    deb->ticks[bit] ^= carry;
+    carry = next;
+  }
+}
+
+static void clearTicks(myDebounce_t * deb, uint32_t inputs)
+{
+  uint32_t bit;
+
+  for(bit = 0; bit < MY_DEBOUNCE_COUNTER_BITS; bit++) { deb->ticks[bit] &= ~inputs; }
+}
+
+static uint32_t ticksEqual(myDebounce_t * deb, uint32_t value)
+{
+  uint32_t equal = UINT32_MAX;
+  uint32_t bit;
+
+  for(bit = 0; bit < MY_DEBOUNCE_COUNTER_BITS; bit++)
+  {
+    if((value & (1UL << bit)) != 0) { equal &= deb->ticks[bit];  }
+    else                            { equal &= ~deb->ticks[bit]; }
+  }
+
+  return equal;
+}
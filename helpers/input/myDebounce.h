@@ -0,0 +1,146 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file myDebounce.h
+ * @brief Header file for the bit-sliced input debouncer.
+ *
+ * This header provides the types and routines for a debouncer that handles
+ *  up to 32 inputs at once, such as all the buttons of a port. It is fed
+ *  with one sample of all the inputs per tick, and reports the inputs that
+ *  were pressed, released, long pressed or double clicked on that tick.
+ *  The work per tick does not depend on how many inputs there are, as the
+ *  inputs are never visited one by one.
+ */
+
+#ifndef MY_DEBOUNCE_H
+#define MY_DEBOUNCE_H
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "myDefs.h"
+
+/*******************************************************************************
+ *  PUBLIC DEFINITIONS
+ ******************************************************************************/
+/**
+ * @brief Amount of bits of the tick counters, which sets the longest time
+ *          that can be set for long presses and double clicks.
+ */
+#ifndef MY_DEBOUNCE_COUNTER_BITS
+  #define MY_DEBOUNCE_COUNTER_BITS                                             8
+#endif
+
+/**
+ * @brief Highest amount of ticks that can be set for long presses and
+ *          double clicks.
+ */
+#define MY_DEBOUNCE_TICKS_MAX            ((1UL << MY_DEBOUNCE_COUNTER_BITS) - 2)
+
+/**
+ * @brief Structure containing all the info needed to initialize a debouncer.
+ */
+typedef struct
+{
+  uint32_t invert;
+  uint32_t longTicks;
+  uint32_t doubleTicks;
+} myDebouncePars_t;
+
+/**
+ * @brief Structure that represents a debouncer.
+ *
+ * The debouncer does not allocate anything, so the client provides its
+ *  storage. Each field holds one bit per input, and they are private to the
+ *  debouncer logic, so they should only be touched through the routines
+ *  below.
+ */
+typedef struct
+{
+  uint32_t invert;
+  uint32_t state;
+  uint32_t cnt0;
+  uint32_t cnt1;
+  uint32_t ticks[MY_DEBOUNCE_COUNTER_BITS];
+  uint32_t armed;
+  uint32_t reported;
+  uint32_t longTicks;
+  uint32_t doubleTicks;
+} myDebounce_t;
+
+/**
+ * @brief Structure with the events reported by a tick, one bit per input in
+ *          each of its fields.
+ */
+typedef struct
+{
+  uint32_t press;
+  uint32_t release;
+  uint32_t longPress;
+  uint32_t doubleClick;
+} myDebounceEvts_t;
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES
+ ******************************************************************************/
+/**
+ * @brief Initializes a debouncer, with all its inputs released.
+ * @param deb Debouncer to initialize.
+ * @param pars Structure containing all the data required to initialize it.
+ *          Its invert mask has a bit set for each input that is pressed when
+ *          its sample is zero. Its long and double ticks set how long an
+ *          input must be held to be long pressed, and the longest time from
+ *          a release to the next press of a double click. Zero disables each
+ *          event, and neither can be over MY_DEBOUNCE_TICKS_MAX.
+ * @return Success / Failure
+ */
+myRet_t myDebounce_Init(myDebounce_t * deb, myDebouncePars_t * pars);
+
+/**
+ * @brief Feeds a debouncer with a new sample of its inputs, which should be
+ *          called once per tick.
+ *
+ * An input changes after four ticks in a row with the same sample, which is
+ *  reported as a press or a release. A press is also reported as a double
+ *  click when it comes soon enough after a single click. Holding an input for
+ *  long enough is reported once as a long press, and such a press does not
+ *  count as a click.
+ *
+ * @param deb Debouncer to feed.
+ * @param sample Levels of the inputs, one bit per input.
+ * @param evts Written with the events of this tick.
+ * @return True if any event was reported, false otherwise.
+ */
+bool myDebounce_Update(myDebounce_t * deb, uint32_t sample, myDebounceEvts_t * evts);
+
+/**
+ * @brief Gets which inputs are currently pressed, after debouncing.
+ * @param deb Debouncer to check.
+ * @return One bit set per pressed input.
+ */
+uint32_t myDebounce_GetState(myDebounce_t * deb);
+
+/**
+ * @brief Tells if a debouncer has nothing left to do until an input changes,
+ *          so that ticking it can be stopped until then.
+ * @param deb Debouncer to check.
+ * @return True if all inputs are released and settled, and no double click
+ *          is pending, false otherwise.
+ */
+bool myDebounce_IsIdle(myDebounce_t * deb);
+
+#endif
@@ -0,0 +1,57 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file myGamma.c
+ * @brief Source file for the gamma correction of light levels.
+ *
+ * This file holds the table of duty cycles, built at compile time.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "myGamma.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+/* The table is expanded from the macro below, four levels at a time.         */
+#define MY_GAMMA_4(LVL)   MY_GAMMA(LVL), MY_GAMMA((LVL) + 1), MY_GAMMA((LVL) + 2), MY_GAMMA((LVL) + 3)
+#define MY_GAMMA_16(LVL)  MY_GAMMA_4(LVL), MY_GAMMA_4((LVL) + 4), MY_GAMMA_4((LVL) + 8), MY_GAMMA_4((LVL) + 12)
+#define MY_GAMMA_64(LVL)  MY_GAMMA_16(LVL), MY_GAMMA_16((LVL) + 16), MY_GAMMA_16((LVL) + 32), MY_GAMMA_16((LVL) + 48)
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static const uint16_t myGamma_Table[MY_GAMMA_LEVEL_MAX + 1] =
+{
+  MY_GAMMA_64(0), MY_GAMMA_64(64), MY_GAMMA_64(128), MY_GAMMA_64(192)
+};
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES
+ ******************************************************************************/
+/**
+ * @brief Gets the duty cycle of a light level, from a table built at compile
+ *          time.
+ * @param level Light level, from zero up to MY_GAMMA_LEVEL_MAX.
+ * @return Duty cycle, from zero up to MY_GAMMA_DUTY_MAX.
+ */
+uint16_t myGamma_Get(uint8_t level)
+{
+  return myGamma_Table[level];
+}
@@ -0,0 +1,84 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file myGamma.h
+ * @brief Header file for the gamma correction of light levels.
+ *
+ * The eye perceives brightness roughly as a power of the light output, so
+ *  light levels that go up in even steps look like they jump at the dark end
+ *  and barely change at the bright end. This header maps perceived levels to
+ *  PWM duty cycles that look evenly spaced instead.
+ *
+ * The curve is a blend of a square and a cube, which stays close to the
+ *  usual gamma of 2.2 with integer math only. Every duty cycle is computed
+ *  while building, so looking one up takes a single load.
+ */
+
+#ifndef MY_GAMMA_H
+#define MY_GAMMA_H
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "myDefs.h"
+
+/*******************************************************************************
+ *  PUBLIC DEFINITIONS
+ ******************************************************************************/
+/**
+ * @brief Share, in percent, of the cube in the curve. Zero gives a gamma of 2,
+ *          and 100 a gamma of 3. The default is close to a gamma of 2.2.
+ */
+#ifndef MY_GAMMA_CUBIC_SHARE
+  #define MY_GAMMA_CUBIC_SHARE                                                25
+#endif
+
+/**
+ * @brief Highest light level, which maps to the highest duty cycle.
+ */
+#define MY_GAMMA_LEVEL_MAX                                                   255
+
+/**
+ * @brief Highest duty cycle, for a light that is always on.
+ */
+#define MY_GAMMA_DUTY_MAX                                                 0xFFFF
+
+/**
+ * @brief Duty cycle of a light level, computed while building when the level
+ *          is a constant. It is rounded to the nearest duty cycle.
+ */
+#define MY_GAMMA(LVL)                                                          \
+  ((uint16_t)(((MY_GAMMA_DUTY_MAX * MY_GAMMA_CURVE(LVL)) + (50 * MY_GAMMA_CUBE)) / (100 * MY_GAMMA_CUBE)))
+
+/* Curve of a light level, scaled by 100 times the cube of the highest level. */
+#define MY_GAMMA_CURVE(LVL)                                                    \
+  (((100ULL - MY_GAMMA_CUBIC_SHARE) * MY_GAMMA_LEVEL_MAX * (LVL) * (LVL)) + (MY_GAMMA_CUBIC_SHARE * 1ULL * (LVL) * (LVL) * (LVL)))
+
+#define MY_GAMMA_CUBE                   (1ULL * MY_GAMMA_LEVEL_MAX * MY_GAMMA_LEVEL_MAX * MY_GAMMA_LEVEL_MAX)
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES
+ ******************************************************************************/
+/**
+ * @brief Gets the duty cycle of a light level, from a table built at compile
+ *          time.
+ * @param level Light level, from zero up to MY_GAMMA_LEVEL_MAX.
+ * @return Duty cycle, from zero up to MY_GAMMA_DUTY_MAX.
+ */
+uint16_t myGamma_Get(uint8_t level);
+
+#endif
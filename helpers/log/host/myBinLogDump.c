@@ -0,0 +1,222 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file myBinLogDump.c
+ * @brief Source file for the host tool that turns a binary log back into
+ *          text.
+ *
+ * The tool takes the firmware ELF and a file with the words drained from the
+ *  log ring, little-endian, as the target sent them. The format strings, and
+ *  any string given to %s, are read from the sections of the ELF that are
+ *  loaded on the target, so it must be the very ELF that was flashed.
+ *
+ * It is built and run on the host, for instance with:
+ *  gcc -I.. -I../../defs -I../../ring -o myBinLogDump myBinLogDump.c
+ *      ../myBinLogDecode.c
+ *  ./myBinLogDump blinky.axf log.bin
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "myBinLogDecode.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define DUMP_TEXT_SIZE                                                       512
+
+/* Set below the offsets and values of the ELF32 fields in use.               */
+#define DUMP_ELF_HEADER_SIZE                                                  52
+#define DUMP_ELF_CLASS                                                         4
+#define DUMP_ELF_DATA                                                          5
+#define DUMP_ELF_SHOFF                                                      0x20
+#define DUMP_ELF_SHENTSIZE                                                  0x2E
+#define DUMP_ELF_SHNUM                                                      0x30
+#define DUMP_ELF_SH_TYPE                                                       4
+#define DUMP_ELF_SH_FLAGS                                                      8
+#define DUMP_ELF_SH_ADDR                                                      12
+#define DUMP_ELF_SH_OFFSET                                                    16
+#define DUMP_ELF_SH_SIZE                                                      20
+#define DUMP_ELF_SHT_NOBITS                                                    8
+#define DUMP_ELF_SHF_ALLOC                                                     2
+
+/**
+ * @brief Structure that represents a section of the ELF loaded on the
+ *          target.
+ */
+typedef struct
+{
+  uint32_t addr;
+  uint32_t size;
+  const uint8_t * data;
+} dumpSection_t;
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static uint8_t * readFile(const char * path, uint32_t * size);
+static uint32_t readLe(const uint8_t * bytes, uint32_t size);
+static bool loadSections(const uint8_t * elf, uint32_t elfSize);
+static const char * resolve(uint32_t address);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static dumpSection_t * dump_Sections = NULL;
+static uint32_t dump_SectionCount = 0;
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES
+ ******************************************************************************/
+int main(int argc, char * argv[])
+{
+  uint32_t elfSize, logSize;
+
+  if(argc != 3)
+  {
+    fprintf(stderr, "usage: %s <firmware.elf> <log.bin>\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  uint8_t * elf = readFile(argv[1], &elfSize);
+  uint8_t * log = readFile(argv[2], &logSize);
+
+  if((elf == NULL) || (log == NULL) || !loadSections(elf, elfSize))
+  {
+    fprintf(stderr, "could not read the firmware or the log\n");
+    return EXIT_FAILURE;
+  }
+
+  /* Take the words from the bytes, whatever the endianness of the host.      */
+  const uint32_t count = logSize / sizeof(uint32_t);
+  uint32_t * words = malloc((count + 1) * sizeof(uint32_t));
+  for(uint32_t i = 0; i < count; i++) { words[i] = readLe(&log[i * sizeof(uint32_t)], sizeof(uint32_t)); }
+
+  myBinLogDecoder_t dec = { .resolve = resolve };
+  char text[DUMP_TEXT_SIZE];
+  uint32_t consumed, pos = 0;
+
+  while((consumed = myBinLogDecode_Record(&dec, &words[pos], count - pos, text, sizeof(text))) > 0)
+  {
+    if(text[0] != '\0') { printf("%s\n", text); }
+    pos += consumed;
+  }
+
+  if((pos < count) || (dec.lost > 0) || (dec.skipped > 0))
+  {
+    fprintf(stderr, "%u records lost, %u words skipped, %u words left over\n",
+            (unsigned int) dec.lost, (unsigned int) dec.skipped, (unsigned int) (count - pos));
+  }
+
+  free(words);
+  free(log);
+  free(elf);
+  free(dump_Sections);
+
+  return EXIT_SUCCESS;
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static uint8_t * readFile(const char * path, uint32_t * size)
+{
+  uint8_t * data = NULL;
+  FILE * file = fopen(path, "rb");
+
+  if(file == NULL) { return NULL; }
+
+  if((fseek(file, 0, SEEK_END) == 0) && (ftell(file) > 0))
+  {
+    *size = (uint32_t) ftell(file);
+    data = malloc(*size);
+    rewind(file);
+
+    if((data != NULL) && (fread(data, 1, *size, file) != *size))
+    {
+      free(data);
+      data = NULL;
+    }
+  }
+
+  fclose(file);
+  return data;
+}
+
+static uint32_t readLe(const uint8_t * bytes, uint32_t size)
+{
+  uint32_t value = 0;
+
+  while(size-- > 0) { value = (value << 8) | bytes[size]; }
+
+  return value;
+}
+
+static bool loadSections(const uint8_t * elf, uint32_t elfSize)
+{
+  /* Only 32-bit, little-endian ELF files, which is what both targets use.    */
+  if((elfSize < DUMP_ELF_HEADER_SIZE) || (memcmp(elf, "\177ELF", 4) != 0) ||
+     (elf[DUMP_ELF_CLASS] != 1) || (elf[DUMP_ELF_DATA] != 1)) { return false; }
+
+  const uint32_t shoff = readLe(&elf[DUMP_ELF_SHOFF], 4);
+  const uint32_t shentsize = readLe(&elf[DUMP_ELF_SHENTSIZE], 2);
+  const uint32_t shnum = readLe(&elf[DUMP_ELF_SHNUM], 2);
+
+  if(((uint64_t) shoff + ((uint64_t) shentsize * shnum)) > elfSize) { return false; }
+
+  dump_Sections = calloc(shnum, sizeof(dumpSection_t));
+  if(dump_Sections == NULL) { return false; }
+
+  for(uint32_t i = 0; i < shnum; i++)
+  {
+    const uint8_t * sh = &elf[shoff + (i * shentsize)];
+    const uint32_t offset = readLe(&sh[DUMP_ELF_SH_OFFSET], 4);
+    const uint32_t size = readLe(&sh[DUMP_ELF_SH_SIZE], 4);
+
+    if((readLe(&sh[DUMP_ELF_SH_TYPE], 4) == DUMP_ELF_SHT_NOBITS) ||
+       ((readLe(&sh[DUMP_ELF_SH_FLAGS], 4) & DUMP_ELF_SHF_ALLOC) == 0) ||
+       (((uint64_t) offset + size) > elfSize)) { continue; }
+
+    dump_Sections[dump_SectionCount++] = (dumpSection_t) {
+      .addr = readLe(&sh[DUMP_ELF_SH_ADDR], 4), .size = size, .data = &elf[offset] };
+  }
+
+  return true;
+}
+
+static const char * resolve(uint32_t address)
+{
+  for(uint32_t i = 0; i < dump_SectionCount; i++)
+  {
+    const dumpSection_t * sec = &dump_Sections[i];
+
+    if((address >= sec->addr) && ((address - sec->addr) < sec->size))
+    {
+      /* The string must end within its section to be taken.                  */
+      const uint32_t offset = address - sec->addr;
+      if(memchr(&sec->data[offset], '\0', sec->size - offset) != NULL) { return (const char *) &sec->data[offset]; }
+    }
+  }
+
+  return NULL;
+}
@@ -0,0 +1,148 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file myBinLog.c
+ * @brief Source file for the binary logger, which defers formatting to the
+ *          host.
+ *
+ * A record is only written if it fits the ring as a whole, so the host never
+ *  gets half of one. Checking for room and pushing the words has to happen
+ *  at once, which is what the client's lock is for when several contexts
+ *  log. The ring itself is lock-free, so draining it needs no lock at all.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "myBinLog.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static myRing_t * myBinLog_Ring = NULL;
+static myBinLogLock_t myBinLog_Lock = NULL;
+static myBinLogUnlock_t myBinLog_Unlock = NULL;
+static uint32_t myBinLog_Seq = 0;
+static uint32_t myBinLog_Dropped = 0;
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES
+ ******************************************************************************/
+/**
+ * @brief Initialization routine for the logger. Messages logged before it
+ *          are dropped.
+ * @param pars Structure containing all the data required to initialize the
+ *          logger.
+ * @return Success / Failure
+ */
+myRet_t myBinLog_Init(myBinLogPars_t * pars)
+{
+  myRet_t result = myRet_Fail;
+
+  if((pars != NULL) && (pars->ring != NULL) && (pars->ring->itemSize == sizeof(uint32_t)) &&
+     ((pars->lock == NULL) == (pars->unlock == NULL)))
+  {
+    myBinLog_Lock = pars->lock;
+    myBinLog_Unlock = pars->unlock;
+    myBinLog_Seq = 0;
+    myBinLog_Dropped = 0;
+    myBinLog_Ring = pars->ring;
+
+    result = myRet_OK;
+  }
+
+  return result;
+}
+
+/**
+ * @brief Writes a record into the ring, as a whole or not at all. It is
+ *          meant to be called through myBINLOG.
+ * @param words Address of the format string followed by the arguments.
+ * @param argCount Amount of arguments, which follow the address.
+ * @return Success / Failure. It fails if the record did not fit the ring.
+ */
+myRet_t myBinLog_Write(const uint32_t * words, uint32_t argCount)
+{
+  myRet_t result = myRet_Fail;
+  uint32_t state = 0;
+  uint32_t header;
+  uint32_t i;
+
+  if((myBinLog_Ring != NULL) && (words != NULL) && (argCount <= MY_BINLOG_MAX_ARGS))
+  {
+    if(myBinLog_Lock != NULL) { state = myBinLog_Lock(); }
+
+    header = (MY_BINLOG_SYNC << MY_BINLOG_SYNC_SHIFT) |
+             ((myBinLog_Seq & MY_BINLOG_SEQ_MASK) << MY_BINLOG_SEQ_SHIFT) | argCount;
+    myBinLog_Seq++;
+
+    if(myRing_GetFree(myBinLog_Ring) >= (MY_BINLOG_HEADER_WORDS + argCount))
+    {
+      (void) myRing_Push(myBinLog_Ring, &header);
+      for(i = 0; i <= argCount; i++) { (void) myRing_Push(myBinLog_Ring, &words[i]); }
+
+      result = myRet_OK;
+    }
+    else
+    {
+      myBinLog_Dropped++;
+    }
+
+    if(myBinLog_Unlock != NULL) { myBinLog_Unlock(state); }
+  }
+
+  return result;
+}
+
+/**
+ * @brief Gets how many records were dropped because the ring was full.
+ * @return Amount of records dropped since initialization.
+ */
+uint32_t myBinLog_GetDropped(void)
+{
+  return myBinLog_Dropped;
+}
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES - TEST PURPOSES
+ ******************************************************************************/
+#ifdef TEST
+/**
+ * @brief Resets logger's internal logic and its variables.
+ */
+void myBinLog_Reset(void)
+{
+  myBinLog_Ring = NULL;
+  myBinLog_Lock = NULL;
+  myBinLog_Unlock = NULL;
+  myBinLog_Seq = 0;
+  myBinLog_Dropped = 0;
+}
+#endif
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
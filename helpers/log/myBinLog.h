@@ -0,0 +1,175 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file myBinLog.h
+ * @brief Header file for the binary logger, which defers formatting to the
+ *          host.
+ *
+ * Formatting a message takes the printf parser and a division per digit,
+ *  which is most of what logging costs on the target. This logger skips it
+ *  altogether: each message is stored as the address of its format string
+ *  followed by its arguments, as raw 32-bit words, and the text is only
+ *  built on the host by myBinLogDecode, which reads the format strings from
+ *  the firmware ELF. Logging then costs about as much as copying a few words,
+ *  and sending the log takes far less bandwidth than its text.
+ *
+ * Arguments must fit in 32 bits: integers, characters and pointers. Strings
+ *  given to %s must be constant, as the host reads them from the ELF as well.
+ *  Floating point is not supported, so scale such values to integers.
+ *
+ * Each record is laid out as follows, all of it in 32-bit words:
+ *  - header: MY_BINLOG_SYNC in the top byte, a 16-bit sequence number, and
+ *    the amount of arguments in the low byte;
+ *  - address of the format string;
+ *  - one word per argument.
+ *  The sequence number goes up for every record, including the ones that
+ *  were dropped, so the host can tell that some are missing.
+ */
+
+#ifndef MY_BINLOG_H
+#define MY_BINLOG_H
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "myDefs.h"
+#include "myMacros.h"
+#include "myRing.h"
+
+/*******************************************************************************
+ *  PUBLIC DEFINITIONS
+ ******************************************************************************/
+/**
+ * @brief Value in the top byte of every record header, so that the host can
+ *          find the next record if some words were lost on the way.
+ */
+#define MY_BINLOG_SYNC                                                    0xB1UL
+
+/**
+ * @brief Maximum amount of arguments of a single message.
+ */
+#define MY_BINLOG_MAX_ARGS                                                     8
+
+/**
+ * @brief Amount of words taken by a record besides its arguments.
+ */
+#define MY_BINLOG_HEADER_WORDS                                                 2
+
+/**
+ * @brief Position and size of each field of a record header.
+ */
+#define MY_BINLOG_SYNC_SHIFT                                                  24
+#define MY_BINLOG_SEQ_SHIFT                                                    8
+#define MY_BINLOG_SEQ_MASK                                               0xFFFFU
+#define MY_BINLOG_ARGS_MASK                                                0xFFU
+
+/**
+ * @brief Routines used to serialize records written from different contexts,
+ *          usually myIrq_Lock and myIrq_Unlock.
+ */
+typedef uint32_t (*myBinLogLock_t)(void);
+typedef void (*myBinLogUnlock_t)(uint32_t state);
+
+/**
+ * @brief Structure containing all the info needed to initialize the logger.
+ *
+ * The ring holds uint32_t items and is drained by the client, which sends
+ *  its words to the host in whatever way suits it. The lock routines may be
+ *  NULL if messages are only logged from a single context.
+ */
+typedef struct
+{
+  myRing_t * ring;
+  myBinLogLock_t lock;
+  myBinLogUnlock_t unlock;
+} myBinLogPars_t;
+
+/*******************************************************************************
+ *  PUBLIC MACROS
+ ******************************************************************************/
+/**
+ * @brief Logs a message. The format string must be a string literal, or at
+ *          least constant, and take up to MY_BINLOG_MAX_ARGS arguments.
+ *
+ * Example: myBINLOG("Timer %u expired after %d us", timerId, elapsed);
+ */
+#define myBINLOG(FMT, ...)                                                     \
+  do                                                                           \
+  {                                                                            \
+    const uint32_t myBinLog_Words[] =                                          \
+      { MY_BINLOG_WORD(FMT) MY_BINLOG_ARGS(__VA_ARGS__) };                     \
+    myBinLog_Write(myBinLog_Words, MY_ARRAY_SIZE(myBinLog_Words) - 1);         \
+  } while(0)
+
+/* Set below the machinery that turns each argument into a word.              */
+#define MY_BINLOG_WORD(X)                             (uint32_t) (uintptr_t) (X)
+#define MY_BINLOG_CAT(A, B)                                               A ## B
+#define MY_BINLOG_EXPAND_CAT(A, B)                           MY_BINLOG_CAT(A, B)
+#define MY_BINLOG_COUNT(...)                                                   \
+  MY_BINLOG_COUNT_N(0, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define MY_BINLOG_COUNT_N(_0, _1, _2, _3, _4, _5, _6, _7, _8, N, ...)          N
+#define MY_BINLOG_ARGS(...)                                                    \
+  MY_BINLOG_EXPAND_CAT(MY_BINLOG_A, MY_BINLOG_COUNT(__VA_ARGS__))(__VA_ARGS__)
+#define MY_BINLOG_A0()
+#define MY_BINLOG_A1(A)                                      , MY_BINLOG_WORD(A)
+#define MY_BINLOG_A2(A, ...)       , MY_BINLOG_WORD(A) MY_BINLOG_A1(__VA_ARGS__)
+#define MY_BINLOG_A3(A, ...)       , MY_BINLOG_WORD(A) MY_BINLOG_A2(__VA_ARGS__)
+#define MY_BINLOG_A4(A, ...)       , MY_BINLOG_WORD(A) MY_BINLOG_A3(__VA_ARGS__)
+#define MY_BINLOG_A5(A, ...)       , MY_BINLOG_WORD(A) MY_BINLOG_A4(__VA_ARGS__)
+#define MY_BINLOG_A6(A, ...)       , MY_BINLOG_WORD(A) MY_BINLOG_A5(__VA_ARGS__)
+#define MY_BINLOG_A7(A, ...)       , MY_BINLOG_WORD(A) MY_BINLOG_A6(__VA_ARGS__)
+#define MY_BINLOG_A8(A, ...)       , MY_BINLOG_WORD(A) MY_BINLOG_A7(__VA_ARGS__)
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES
+ ******************************************************************************/
+/**
+ * @brief Initialization routine for the logger. Messages logged before it
+ *          are dropped.
+ * @param pars Structure containing all the data required to initialize the
+ *          logger.
+ * @return Success / Failure
+ */
+myRet_t myBinLog_Init(myBinLogPars_t * pars);
+
+/**
+ * @brief Writes a record into the ring, as a whole or not at all. It is
+ *          meant to be called through myBINLOG.
+ * @param words Address of the format string followed by the arguments.
+ * @param argCount Amount of arguments, which follow the address.
+ * @return Success / Failure. It fails if the record did not fit the ring.
+ */
+myRet_t myBinLog_Write(const uint32_t * words, uint32_t argCount);
+
+/**
+ * @brief Gets how many records were dropped because the ring was full.
+ * @return Amount of records dropped since initialization.
+ */
+uint32_t myBinLog_GetDropped(void);
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES - TEST PURPOSES
+ ******************************************************************************/
+#ifdef TEST
+/**
+ * @brief Resets logger's internal logic and its variables.
+ */
+void myBinLog_Reset(void);
+#endif
+
+#endif
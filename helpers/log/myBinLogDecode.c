@@ -0,0 +1,252 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file myBinLogDecode.c
+ * @brief Source file for the decoder of the binary log, which builds the
+ *          text of each record on the host.
+ *
+ * The format string is walked the way printf would, and each conversion is
+ *  handed to snprintf on its own, together with its argument word. Length
+ *  modifiers are dropped, as every argument was stored as 32 bits anyway.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "myBinLogDecode.h"
+
+#include <inttypes.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define MY_BINLOG_DECODE_SPEC_SIZE                                            16
+#define MY_BINLOG_DECODE_UNKNOWN                                           "(?)"
+
+/**
+ * @brief Structure that keeps track of the text being built.
+ */
+typedef struct
+{
+  char * text;
+  uint32_t size;
+  uint32_t used;
+} myBinLogText_t;
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static void formatRecord(myBinLogDecoder_t * dec, myBinLogText_t * out, const char * fmt, const uint32_t * args, uint32_t argCount);
+static const char * formatConversion(myBinLogDecoder_t * dec, myBinLogText_t * out, const char * fmt, uint32_t arg);
+static void appendText(myBinLogText_t * out, const char * fmt, ...);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES
+ ******************************************************************************/
+/**
+ * @brief Decodes the record at the start of the given words into text.
+ * @param dec Decoder state.
+ * @param words Words received so far and not consumed yet.
+ * @param count Amount of words given.
+ * @param text Written with the text of the record, always terminated. It is
+ *          left empty if a word was skipped.
+ * @param size Size of the text buffer, in bytes.
+ * @return Amount of words consumed. Zero if the record is not complete yet.
+ */
+uint32_t myBinLogDecode_Record(myBinLogDecoder_t * dec, const uint32_t * words, uint32_t count, char * text, uint32_t size)
+{
+  uint32_t consumed = 0;
+  uint32_t header;
+  uint32_t argCount;
+  uint32_t seq;
+  myBinLogText_t out = { .text = text, .size = size, .used = 0 };
+  const char * fmt;
+
+  if((dec != NULL) && (dec->resolve != NULL) && (words != NULL) && (text != NULL) && (size != 0))
+  {
+    text[0] = '\0';
+
+    if(count > 0)
+    {
+      header = words[0];
+      argCount = header & MY_BINLOG_ARGS_MASK;
+
+      if(((header >> MY_BINLOG_SYNC_SHIFT) != MY_BINLOG_SYNC) || (argCount > MY_BINLOG_MAX_ARGS))
+      {
+        dec->skipped++;
+        consumed = 1;
+      }
+      else if(count >= (MY_BINLOG_HEADER_WORDS + argCount))
+      {
+        /* Sequence numbers wrap around, so only their difference is          */
+        /*  meaningful.                                                       */
+        seq = (header >> MY_BINLOG_SEQ_SHIFT) & MY_BINLOG_SEQ_MASK;
+        if(dec->started) { dec->lost += (seq - dec->nextSeq) & MY_BINLOG_SEQ_MASK; }
+        dec->started = true;
+        dec->nextSeq = (seq + 1) & MY_BINLOG_SEQ_MASK;
+
+        fmt = dec->resolve(words[1]);
+        if(fmt != NULL)
+        {
+          formatRecord(dec, &out, fmt, &words[MY_BINLOG_HEADER_WORDS], argCount);
+        }
+        else
+        {
+          appendText(&out, "<no format at 0x%08" PRIX32 ">", words[1]);
+        }
+
+        consumed = MY_BINLOG_HEADER_WORDS + argCount;
+      }
+    }
+  }
+
+  return consumed;
+}
+
+/**
+ * @brief Gets how many records were missing from the log, either dropped on
+ *          the target or lost on the way, as told by the sequence numbers.
+ * @param dec Decoder state.
+ * @return Amount of records missing so far.
+ */
+uint32_t myBinLogDecode_GetLost(myBinLogDecoder_t * dec)
+{
+  return (dec != NULL) ? dec->lost : 0;
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static void formatRecord(myBinLogDecoder_t * dec, myBinLogText_t * out, const char * fmt, const uint32_t * args, uint32_t argCount)
+{
+  uint32_t argIdx = 0;
+
+  while(*fmt != '\0')
+  {
+    const char * percent = strchr(fmt, '%');
+
+    if(percent == NULL)
+    {
+      appendText(out, "%s", fmt);
+      break;
+    }
+
+    appendText(out, "%.*s", (int) (percent - fmt), fmt);
+
+    if(percent[1] == '%')
+    {
+      appendText(out, "%%");
+      fmt = &percent[2];
+    }
+    else if(argIdx < argCount)
+    {
+      fmt = formatConversion(dec, out, percent, args[argIdx++]);
+    }
+    else
+    {
+      /* The target stored fewer arguments than the format asks for.          */
+      appendText(out, MY_BINLOG_DECODE_UNKNOWN);
+      fmt = formatConversion(dec, NULL, percent, 0);
+    }
+  }
+}
+
+static const char * formatConversion(myBinLogDecoder_t * dec, myBinLogText_t * out, const char * fmt, uint32_t arg)
+{
+  char spec[MY_BINLOG_DECODE_SPEC_SIZE];
+  uint32_t len = 0;
+  char conversion;
+  const char * str;
+
+  /* Keep the flags, the width and the precision, and drop the length.        */
+  spec[len++] = *fmt++;
+  while((*fmt != '\0') && (strchr("-+ #0123456789.", *fmt) != NULL))
+  {
+    if(len < (sizeof(spec) - 2)) { spec[len++] = *fmt; }
+    fmt++;
+  }
+  while((*fmt != '\0') && (strchr("hljztL", *fmt) != NULL)) { fmt++; }
+
+  conversion = *fmt;
+  if(conversion != '\0') { fmt++; }
+
+  spec[len++] = conversion;
+  spec[len] = '\0';
+
+  /* Without an output the conversion is only skipped.                        */
+  if(out != NULL)
+  {
+    switch(conversion)
+    {
+      case 'd':
+      case 'i':
+        appendText(out, spec, (int) (int32_t) arg);
+        break;
+
+      case 'u':
+      case 'o':
+      case 'x':
+      case 'X':
+        appendText(out, spec, (unsigned int) arg);
+        break;
+
+      case 'c':
+        appendText(out, spec, (int) (uint8_t) arg);
+        break;
+
+      case 'p':
+        appendText(out, "0x%08" PRIx32, arg);
+        break;
+
+      case 's':
+        str = dec->resolve(arg);
+        appendText(out, spec, (str != NULL) ? str : MY_BINLOG_DECODE_UNKNOWN);
+        break;
+
+      default:
+        /* Floating point and anything else the target cannot store.          */
+        appendText(out, MY_BINLOG_DECODE_UNKNOWN);
+        break;
+    }
+  }
+
+  return fmt;
+}
+
+static void appendText(myBinLogText_t * out, const char * fmt, ...)
+{
+  va_list args;
+  const uint32_t room = out->size - out->used;
+  int written;
+
+  if(room > 1)
+  {
+    va_start(args, fmt);
+    written = vsnprintf(&out->text[out->used], room, fmt, args);
+    va_end(args);
+
+    if(written > 0) { out->used += ((uint32_t) written < room) ? (uint32_t) written : (room - 1); }
+  }
+}
@@ -0,0 +1,90 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file myBinLogDecode.h
+ * @brief Header file for the decoder of the binary log, which builds the
+ *          text of each record on the host.
+ *
+ * The decoder knows nothing about where the log comes from nor where the
+ *  format strings are. Its client hands it the words as they arrive, and a
+ *  routine that finds the string at a target address, usually by reading
+ *  the sections of the firmware ELF.
+ */
+
+#ifndef MY_BINLOG_DECODE_H
+#define MY_BINLOG_DECODE_H
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "myDefs.h"
+#include "myBinLog.h"
+
+/*******************************************************************************
+ *  PUBLIC DEFINITIONS
+ ******************************************************************************/
+/**
+ * @brief Routine that finds a string by its address on the target.
+ * @param address Address of the string on the target.
+ * @return The string, or NULL if there is none at that address.
+ */
+typedef const char * (*myBinLogResolve_t)(uint32_t address);
+
+/**
+ * @brief Structure that keeps the state of a decoder between records.
+ *
+ * The client provides the storage and sets the resolver. Its other fields
+ *  are private to the decoder logic and start zeroed.
+ */
+typedef struct
+{
+  myBinLogResolve_t resolve;
+  bool started;
+  uint32_t nextSeq;
+  uint32_t lost;
+  uint32_t skipped;
+} myBinLogDecoder_t;
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES
+ ******************************************************************************/
+/**
+ * @brief Decodes the record at the start of the given words into text.
+ *
+ * Words that do not start a record are skipped one at a time, so a stream
+ *  that lost some words gets back in sync at the next record.
+ *
+ * @param dec Decoder state.
+ * @param words Words received so far and not consumed yet.
+ * @param count Amount of words given.
+ * @param text Written with the text of the record, always terminated. It is
+ *          left empty if a word was skipped.
+ * @param size Size of the text buffer, in bytes.
+ * @return Amount of words consumed. Zero if the record is not complete yet.
+ */
+uint32_t myBinLogDecode_Record(myBinLogDecoder_t * dec, const uint32_t * words, uint32_t count, char * text, uint32_t size);
+
+/**
+ * @brief Gets how many records were missing from the log, either dropped on
+ *          the target or lost on the way, as told by the sequence numbers.
+ * @param dec Decoder state.
+ * @return Amount of records missing so far.
+ */
+uint32_t myBinLogDecode_GetLost(myBinLogDecoder_t * dec);
+
+#endif
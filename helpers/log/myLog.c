@@ -0,0 +1,91 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file myLog.c
+ * @brief Source file for the logging macros, with levels removed while
+ *          building and modules masked at run time.
+ *
+ * The mask is read from any context, but it should be changed from a single
+ *  one, such as a shell task, as changing a bit takes a read, a change and
+ *  a write that are not atomic on the M0+.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "myLog.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+volatile uint32_t myLog_Mask = MY_LOG_MASK_DEFAULT;
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES
+ ******************************************************************************/
+/**
+ * @brief Enables the messages of a module.
+ * @param mod Module to enable.
+ */
+void myLog_Enable(myLogMod_t mod)
+{
+  if(mod < myLogMod_Count) { myLog_Mask |= (1UL << mod); }
+}
+
+/**
+ * @brief Disables the messages of a module.
+ * @param mod Module to disable.
+ */
+void myLog_Disable(myLogMod_t mod)
+{
+  if(mod < myLogMod_Count) { myLog_Mask &= ~(1UL << mod); }
+}
+
+/**
+ * @brief Sets which modules are enabled, all at once.
+ * @param mask One bit per module, set for the ones to enable.
+ */
+void myLog_SetMask(uint32_t mask)
+{
+  myLog_Mask = mask;
+}
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES - TEST PURPOSES
+ ******************************************************************************/
+#ifdef TEST
+/**
+ * @brief Resets logging's internal logic and its variables.
+ */
+void myLog_Reset(void)
+{
+  myLog_Mask = MY_LOG_MASK_DEFAULT;
+}
+#endif
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
@@ -0,0 +1,185 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file myLog.h
+ * @brief Header file for the logging macros, with levels removed while
+ *          building and modules masked at run time.
+ *
+ * Each message has a level and a module. Levels above MY_LOG_LEVEL are
+ *  removed by the preprocessor, so their calls, arguments included, leave
+ *  no code behind at all. Messages of the remaining levels are only sent if
+ *  their module is enabled in a run-time mask, which costs a load and a bit
+ *  test, so verbose tracing may stay in production builds and be turned on
+ *  module by module when needed.
+ *
+ * Messages are sent through MY_LOG_OUTPUT, which is the binary logger unless
+ *  the project sets otherwise (PRINTF, for instance). Either way the format
+ *  must be a string literal, as the level tag is prepended to it.
+ */
+
+#ifndef MY_LOG_H
+#define MY_LOG_H
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "myDefs.h"
+#include "projConfig.h"
+
+/*******************************************************************************
+ *  PUBLIC DEFINITIONS
+ ******************************************************************************/
+/**
+ * @brief Log levels, from the most to the least important one.
+ */
+#define MY_LOG_LEVEL_NONE                                                      0
+#define MY_LOG_LEVEL_ERROR                                                     1
+#define MY_LOG_LEVEL_WARN                                                      2
+#define MY_LOG_LEVEL_INFO                                                      3
+#define MY_LOG_LEVEL_DEBUG                                                     4
+#define MY_LOG_LEVEL_TRACE                                                     5
+
+/**
+ * @brief Least important level that is kept while building. Messages of the
+ *          levels after it are removed.
+ */
+#ifndef MY_LOG_LEVEL
+  #define MY_LOG_LEVEL                                         MY_LOG_LEVEL_INFO
+#endif
+
+/**
+ * @brief Routine, or macro, that sends the messages that are kept and
+ *          enabled. It takes a format string and its arguments.
+ */
+#ifndef MY_LOG_OUTPUT
+  #include "myBinLog.h"
+  #define MY_LOG_OUTPUT                                                 myBINLOG
+#endif
+
+/**
+ * @brief Modules that log, each one a bit of the run-time mask.
+ */
+typedef enum
+{
+  myLogMod_Gpio = 0,
+  myLogMod_Timer,
+  myLogMod_AppLed,
+  myLogMod_AppButton,
+  myLogMod_Os,
+  myLogMod_Count,
+} myLogMod_t;
+
+/**
+ * @brief Modules enabled from the start, all of them by default.
+ */
+#ifndef MY_LOG_MASK_DEFAULT
+  #define MY_LOG_MASK_DEFAULT                      ((1UL << myLogMod_Count) - 1)
+#endif
+
+/**
+ * @brief Run-time mask of the enabled modules, one bit per module. It is
+ *          read straight by the macros below, so that checking it takes no
+ *          call, and should only be changed through the routines below,
+ *          from a single context.
+ */
+extern volatile uint32_t myLog_Mask;
+
+/*******************************************************************************
+ *  PUBLIC MACROS
+ ******************************************************************************/
+/**
+ * @brief Sends a message if its module is enabled. The level is only used
+ *          to pick the tag, so use the macros per level below instead.
+ */
+#define myLOG(TAG, MOD, FMT, ...)                                              \
+  do                                                                           \
+  {                                                                            \
+    if((myLog_Mask & (1UL << (MOD))) != 0)                                     \
+    {                                                                          \
+      MY_LOG_OUTPUT(TAG FMT, ##__VA_ARGS__);                                   \
+    }                                                                          \
+  } while(0)
+
+/**
+ * @brief Macros per level. Those of the levels removed while building expand
+ *          to nothing, their arguments included.
+ *
+ * Example: myLOG_DEBUG(myLogMod_Timer, "Timer %u started", timerId);
+ */
+#if MY_LOG_LEVEL >= MY_LOG_LEVEL_ERROR
+  #define myLOG_ERROR(MOD,  FMT, ...)       myLOG("E ", MOD, FMT, ##__VA_ARGS__)
+#else
+  #define myLOG_ERROR(MOD,   FMT, ...)                           do { } while(0)
+#endif
+
+#if MY_LOG_LEVEL >= MY_LOG_LEVEL_WARN
+  #define myLOG_WARN(MOD,  FMT, ...)        myLOG("W ", MOD, FMT, ##__VA_ARGS__)
+#else
+  #define myLOG_WARN(MOD,   FMT, ...)                            do { } while(0)
+#endif
+
+#if MY_LOG_LEVEL >= MY_LOG_LEVEL_INFO
+  #define myLOG_INFO(MOD,  FMT, ...)        myLOG("I ", MOD, FMT, ##__VA_ARGS__)
+#else
+  #define myLOG_INFO(MOD,   FMT, ...)                            do { } while(0)
+#endif
+
+#if MY_LOG_LEVEL >= MY_LOG_LEVEL_DEBUG
+  #define myLOG_DEBUG(MOD,  FMT, ...)       myLOG("D ", MOD, FMT, ##__VA_ARGS__)
+#else
+  #define myLOG_DEBUG(MOD,   FMT, ...)                           do { } while(0)
+#endif
+
+#if MY_LOG_LEVEL >= MY_LOG_LEVEL_TRACE
+  #define myLOG_TRACE(MOD,  FMT, ...)       myLOG("T ", MOD, FMT, ##__VA_ARGS__)
+#else
+  #define myLOG_TRACE(MOD,   FMT, ...)                           do { } while(0)
+#endif
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES
+ ******************************************************************************/
+/**
+ * @brief Enables the messages of a module.
+ * @param mod Module to enable.
+ */
+void myLog_Enable(myLogMod_t mod);
+
+/**
+ * @brief Disables the messages of a module.
+ * @param mod Module to disable.
+ */
+void myLog_Disable(myLogMod_t mod);
+
+/**
+ * @brief Sets which modules are enabled, all at once.
+ * @param mask One bit per module, set for the ones to enable.
+ */
+void myLog_SetMask(uint32_t mask);
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES - TEST PURPOSES
+ ******************************************************************************/
+#ifdef TEST
+/**
+ * @brief Resets logging's internal logic and its variables.
+ */
+void myLog_Reset(void);
+#endif
+
+#endif
@@ -0,0 +1,183 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file myRing.c
+ * @brief Source file for the single-producer, single-consumer ring buffer.
+ *
+ * The head counts the items pushed so far and the tail the ones popped, both
+ *  wrapping around at 2^32, so the amount of items in the ring is always
+ *  head - tail, and the ring is never ambiguous between full and empty. The
+ *  slot of an index is found by masking, as the ring size is a power of two.
+ *
+ * The producer only writes the head, and the consumer only the tail. Each
+ *  side copies its item before publishing its index, with a release store,
+ *  and reads the other side's index with an acquire load. On Cortex-M0+ and
+ *  M3 those are plain 32-bit loads and stores plus a barrier, with no
+ *  exclusive access nor critical section needed.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "myRing.h"
+
+#include <string.h>
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define MY_RING_LOAD_OWN(IDX)          __atomic_load_n(&(IDX), __ATOMIC_RELAXED)
+#define MY_RING_LOAD_OTHER(IDX)        __atomic_load_n(&(IDX), __ATOMIC_ACQUIRE)
+#define MY_RING_PUBLISH(IDX, VAL)    __atomic_store_n(&(IDX), (VAL), __ATOMIC_RELEASE)
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES
+ ******************************************************************************/
+/**
+ * @brief Initializes a ring buffer, empty.
+ * @param ring Ring to initialize.
+ * @param items Storage for the items, of itemSize * count bytes.
+ * @param itemSize Size, in bytes, of each item.
+ * @param count Amount of items that fit in the storage, a power of two.
+ * @return Success / Failure
+ */
+myRet_t myRing_Init(myRing_t * ring, void * items, uint32_t itemSize, uint32_t count)
+{
+  myRet_t result = myRet_Fail;
+
+  if((ring != NULL) && (items != NULL) && (itemSize != 0) && (count != 0) && ((count & (count - 1)) == 0))
+  {
+    ring->items = (uint8_t *) items;
+    ring->itemSize = itemSize;
+    ring->mask = count - 1;
+    ring->head = 0;
+    ring->tail = 0;
+
+    result = myRet_OK;
+  }
+
+  return result;
+}
+
+/**
+ * @brief Pushes an item into the ring. Only the producer may call it.
+ * @param ring Ring to push into.
+ * @param item Item to copy into the ring.
+ * @return Success / Failure. It fails if the ring is full.
+ */
+myRet_t myRing_Push(myRing_t * ring, const void * item)
+{
+  myRet_t result = myRet_Fail;
+  const uint32_t head = MY_RING_LOAD_OWN(ring->head);
+
+  if((head - MY_RING_LOAD_OTHER(ring->tail)) <= ring->mask)
+  {
+    memcpy(&ring->items[(head & ring->mask) * ring->itemSize], item, ring->itemSize);
+    MY_RING_PUBLISH(ring->head, head + 1);
+    result = myRet_OK;
+  }
+
+  return result;
+}
+
+/**
+ * @brief Pops the oldest item from the ring. Only the consumer may call it.
+ * @param ring Ring to pop from.
+ * @param item Written with the item.
+ * @return Success / Failure. It fails if the ring is empty.
+ */
+myRet_t myRing_Pop(myRing_t * ring, void * item)
+{
+  myRet_t result = myRet_Fail;
+  const uint32_t tail = MY_RING_LOAD_OWN(ring->tail);
+
+  if(MY_RING_LOAD_OTHER(ring->head) != tail)
+  {
+    memcpy(item, &ring->items[(tail & ring->mask) * ring->itemSize], ring->itemSize);
+    MY_RING_PUBLISH(ring->tail, tail + 1);
+    result = myRet_OK;
+  }
+
+  return result;
+}
+
+/**
+ * @brief Pops as many of the oldest items as there are in the ring, up to a
+ *          limit, at once. Only the consumer may call it.
+ * @param ring Ring to pop from.
+ * @param items Written with the items, in order. It must fit count items.
+ * @param count Maximum amount of items to pop.
+ * @return Amount of items popped. Zero if the ring is empty.
+ */
+uint32_t myRing_PopMany(myRing_t * ring, void * items, uint32_t count)
+{
+  const uint32_t tail = MY_RING_LOAD_OWN(ring->tail);
+  const uint32_t avail = MY_RING_LOAD_OTHER(ring->head) - tail;
+
+  if(count > avail) { count = avail; }
+
+  if(count > 0)
+  {
+    /* The items may wrap around the end of the storage, in which case they   */
+    /*  are copied in two blocks: up to the end, and then from the start.     */
+    const uint32_t first = tail & ring->mask;
+    const uint32_t toEnd = ring->mask + 1 - first;
+    const uint32_t block = (count < toEnd) ? count : toEnd;
+
+    memcpy(items, &ring->items[first * ring->itemSize], block * ring->itemSize);
+    memcpy((uint8_t *)items + (block * ring->itemSize), ring->items, (count - block) * ring->itemSize);
+    MY_RING_PUBLISH(ring->tail, tail + count);
+  }
+
+  return count;
+}
+
+/**
+ * @brief Gets how many items are in the ring.
+ * @param ring Ring to check.
+ * @return Amount of items in the ring.
+ */
+uint32_t myRing_GetCount(myRing_t * ring)
+{
+  /* The tail is read first: it can only grow up to the head, so the count    */
+  /*  never comes out negative, even if both move in between.                 */
+  const uint32_t tail = MY_RING_LOAD_OTHER(ring->tail);
+
+  return MY_RING_LOAD_OTHER(ring->head) - tail;
+}
+
+/**
+ * @brief Gets how many more items fit in the ring.
+ * @param ring Ring to check.
+ * @return Amount of items that can still be pushed.
+ */
+uint32_t myRing_GetFree(myRing_t * ring)
+{
+  return (ring->mask + 1) - myRing_GetCount(ring);
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
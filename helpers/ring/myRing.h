@@ -0,0 +1,118 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file myRing.h
+ * @brief Header file for the single-producer, single-consumer ring buffer.
+ *
+ * This header provides the types and routines for a ring buffer that passes
+ *  fixed-size items from one producer to one consumer, such as from an
+ *  interrupt routine to a task. Neither side ever waits for the other nor
+ *  masks interrupts: each one only writes its own index, so pushing and
+ *  popping are wait-free.
+ */
+
+#ifndef MY_RING_H
+#define MY_RING_H
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "myDefs.h"
+
+/*******************************************************************************
+ *  PUBLIC DEFINITIONS
+ ******************************************************************************/
+/**
+ * @brief Structure that represents a ring buffer.
+ *
+ * The ring does not allocate anything, so the client provides the storage
+ *  for the items. Its fields are private to the ring logic and should only
+ *  be touched through the routines below.
+ */
+typedef struct
+{
+  uint8_t * items;
+  uint32_t itemSize;
+  uint32_t mask;
+  volatile uint32_t head;
+  volatile uint32_t tail;
+} myRing_t;
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES
+ ******************************************************************************/
+/**
+ * @brief Initializes a ring buffer, empty. It must not be in use meanwhile.
+ * @param ring Ring to initialize.
+ * @param items Storage for the items, of itemSize * count bytes.
+ * @param itemSize Size, in bytes, of each item.
+ * @param count Amount of items that fit in the storage. It must be a power of
+ *          two, so that wrapping around takes no division.
+ * @return Success / Failure
+ */
+myRet_t myRing_Init(myRing_t * ring, void * items, uint32_t itemSize, uint32_t count);
+
+/**
+ * @brief Pushes an item into the ring. Only the producer may call it.
+ * @param ring Ring to push into.
+ * @param item Item to copy into the ring.
+ * @return Success / Failure. It fails if the ring is full.
+ */
+myRet_t myRing_Push(myRing_t * ring, const void * item);
+
+/**
+ * @brief Pops the oldest item from the ring. Only the consumer may call it.
+ * @param ring Ring to pop from.
+ * @param item Written with the item.
+ * @return Success / Failure. It fails if the ring is empty.
+ */
+myRet_t myRing_Pop(myRing_t * ring, void * item);
+
+/**
+ * @brief Pops as many of the oldest items as there are in the ring, up to a
+ *          limit, at once. Only the consumer may call it.
+ *
+ * The items are copied in at most two blocks, and handed back to the
+ *  producer all together, so draining a batch costs about the same as
+ *  popping a single item.
+ *
+ * @param ring Ring to pop from.
+ * @param items Written with the items, in order. It must fit count items.
+ * @param count Maximum amount of items to pop.
+ * @return Amount of items popped. Zero if the ring is empty.
+ */
+uint32_t myRing_PopMany(myRing_t * ring, void * items, uint32_t count);
+
+/**
+ * @brief Gets how many items are in the ring. Either side may call it, and
+ *          it is exact for the caller: the other side can only make it grow
+ *          for the consumer, and shrink for the producer.
+ * @param ring Ring to check.
+ * @return Amount of items in the ring.
+ */
+uint32_t myRing_GetCount(myRing_t * ring);
+
+/**
+ * @brief Gets how many more items fit in the ring. Either side may call it,
+ *          and it is exact for the producer, as the consumer can only make
+ *          it grow.
+ * @param ring Ring to check.
+ * @return Amount of items that can still be pushed.
+ */
+uint32_t myRing_GetFree(myRing_t * ring);
+
+#endif
@@ -0,0 +1,25 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file projConfig.h
+ * @brief Interface header file with project-specific definitions.
+ */
+
+#ifndef PROJ_CONFIG_H
+#define PROJ_CONFIG_H
+
+#endif
\ No newline at end of file
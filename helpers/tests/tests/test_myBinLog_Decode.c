@@ -0,0 +1,293 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file test_myBinLog_Decode.c
+ * @brief Test file for testing binary log decoder logic, turning records
+ *          logged on the host back into text.
+ *
+ * Messages are logged as the target would, and the format strings are
+ *  resolved from a table instead of an ELF. The decoded text must be the
+ *  very same that snprintf gives for the message.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+
+#include "myBinLog.h"
+#include "myBinLogDecode.h"
+#include "myRing.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_RING_SIZE                                                      (64)
+#define TEST_TEXT_SIZE                                                     (128)
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static void initLog(void);
+static uint32_t drainWords(void);
+static const char * decodeNext(void);
+static const char * resolveStub(uint32_t address);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static myRing_t ring;
+static uint32_t ringItems[TEST_RING_SIZE];
+static uint32_t words[TEST_RING_SIZE];
+static uint32_t wordCount;
+static uint32_t wordPos;
+static myBinLogDecoder_t dec;
+static char text[TEST_TEXT_SIZE];
+static char expected[TEST_TEXT_SIZE];
+
+static const char fmtPlain[] = "Boot done";
+static const char fmtInts[] = "Timer %u expired after %d us, flags 0x%08X";
+static const char fmtPadded[] = "[%-6s] %5d|%-4u|%03o|%c|%%";
+static const char fmtString[] = "Button %s is %s";
+static const char fmtFloat[] = "Ratio %f";
+static const char strLeft[] = "left";
+static const char strPressed[] = "pressed";
+static const char strTag[] = "gpio";
+
+static const char * const knownStrings[] = { fmtPlain, fmtInts, fmtPadded, fmtString, fmtFloat, strLeft, strPressed, strTag };
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  myBinLog_Reset();
+  dec = (myBinLogDecoder_t) { .resolve = resolveStub };
+  wordCount = 0;
+  wordPos = 0;
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief A message with no arguments should be decoded to its format string.
+ */
+void test_MessageWithNoArgumentsIsDecoded(void)
+{
+  initLog();
+  myBINLOG(fmtPlain);
+  drainWords();
+
+  TEST_ASSERT_EQUAL_STRING(fmtPlain, decodeNext());
+}
+
+/**
+ * @brief Integer conversions should be decoded as printf formats them,
+ *          including negative values and the widest unsigned ones.
+ */
+void test_IntegersAreDecodedAsPrintfFormatsThem(void)
+{
+  initLog();
+  myBINLOG(fmtInts, 4000000000U, -1234, 0xDEADBEEF);
+  drainWords();
+
+  snprintf(expected, sizeof(expected), fmtInts, 4000000000U, -1234, 0xDEADBEEF);
+  TEST_ASSERT_EQUAL_STRING(expected, decodeNext());
+}
+
+/**
+ * @brief Flags, widths, characters and escaped percent signs should be kept.
+ */
+void test_FlagsAndWidthsAreKept(void)
+{
+  initLog();
+  myBINLOG(fmtPadded, strTag, -42, 7U, 8U, 'k');
+  drainWords();
+
+  snprintf(expected, sizeof(expected), fmtPadded, strTag, -42, 7U, 8U, 'k');
+  TEST_ASSERT_EQUAL_STRING(expected, decodeNext());
+}
+
+/**
+ * @brief Strings given to %s should be resolved by their address as well.
+ */
+void test_StringArgumentsAreResolved(void)
+{
+  initLog();
+  myBINLOG(fmtString, strLeft, strPressed);
+  drainWords();
+
+  TEST_ASSERT_EQUAL_STRING("Button left is pressed", decodeNext());
+}
+
+/**
+ * @brief Several records in a row should be decoded in order, each taking
+ *          exactly its own words.
+ */
+void test_RecordsAreDecodedInOrder(void)
+{
+  initLog();
+  myBINLOG(fmtPlain);
+  myBINLOG(fmtString, strLeft, strPressed);
+  myBINLOG(fmtInts, 1, 2, 3);
+  TEST_ASSERT_EQUAL(2 + 4 + 5, drainWords());
+
+  TEST_ASSERT_EQUAL_STRING(fmtPlain, decodeNext());
+  TEST_ASSERT_EQUAL_STRING("Button left is pressed", decodeNext());
+  TEST_ASSERT_EQUAL_STRING("Timer 1 expired after 2 us, flags 0x00000003", decodeNext());
+  TEST_ASSERT_EQUAL(wordCount, wordPos);
+}
+
+/**
+ * @brief A record whose words did not all arrive yet should not be consumed.
+ */
+void test_IfRecordIsIncompleteThenNothingIsConsumed(void)
+{
+  initLog();
+  myBINLOG(fmtInts, 1, 2, 3);
+  drainWords();
+
+  TEST_ASSERT_EQUAL(0, myBinLogDecode_Record(&dec, words, wordCount - 1, text, sizeof(text)));
+  TEST_ASSERT_EQUAL_STRING("", text);
+}
+
+/**
+ * @brief Words that do not start a record should be skipped one at a time,
+ *          until the next record is found.
+ */
+void test_IfWordsAreLostThenDecoderGetsBackInSync(void)
+{
+  initLog();
+  myBINLOG(fmtString, strLeft, strPressed);
+  myBINLOG(fmtPlain);
+  drainWords();
+
+  /* Lose the header of the first record.                                     */
+  wordPos = 1;
+  while((wordPos < wordCount) && (decodeNext()[0] == '\0')) { }
+
+  TEST_ASSERT_EQUAL_STRING(fmtPlain, text);
+  TEST_ASSERT_EQUAL(3, dec.skipped);
+}
+
+/**
+ * @brief Records dropped on the target should be counted by the decoder,
+ *          thanks to the sequence numbers.
+ */
+void test_DroppedRecordsAreCountedAsLost(void)
+{
+  initLog();
+  myBINLOG(fmtPlain);
+  drainWords();
+  myBINLOG(fmtPlain);
+  myBINLOG(fmtPlain);
+  myRing_Init(&ring, ringItems, sizeof(uint32_t), TEST_RING_SIZE);
+  myBINLOG(fmtPlain);
+  drainWords();
+
+  decodeNext();
+  decodeNext();
+  TEST_ASSERT_EQUAL(2, myBinLogDecode_GetLost(&dec));
+}
+
+/**
+ * @brief An address that is not a known string should be reported, instead
+ *          of being read.
+ */
+void test_IfFormatIsUnknownThenAddressIsReported(void)
+{
+  const uint32_t record[] = { (MY_BINLOG_SYNC << MY_BINLOG_SYNC_SHIFT), 0x00001234 };
+
+  TEST_ASSERT_EQUAL(2, myBinLogDecode_Record(&dec, record, 2, text, sizeof(text)));
+  TEST_ASSERT_EQUAL_STRING("<no format at 0x00001234>", text);
+}
+
+/**
+ * @brief Floating point cannot be stored on the target, so it should be
+ *          shown as unknown.
+ */
+void test_FloatingPointIsShownAsUnknown(void)
+{
+  initLog();
+  myBINLOG(fmtFloat, 0);
+  drainWords();
+
+  TEST_ASSERT_EQUAL_STRING("Ratio (?)", decodeNext());
+}
+
+/**
+ * @brief The text should be cut to the buffer given, and still terminated.
+ */
+void test_TextIsCutToTheBufferSize(void)
+{
+  char small[8];
+
+  initLog();
+  myBINLOG(fmtString, strLeft, strPressed);
+  drainWords();
+
+  TEST_ASSERT_EQUAL(4, myBinLogDecode_Record(&dec, words, wordCount, small, sizeof(small)));
+  TEST_ASSERT_EQUAL_STRING("Button ", small);
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static void initLog(void)
+{
+  myBinLogPars_t pars = { .ring = &ring, .lock = NULL, .unlock = NULL };
+
+  myRing_Init(&ring, ringItems, sizeof(uint32_t), TEST_RING_SIZE);
+  TEST_ASSERT_EQUAL(myRet_OK, myBinLog_Init(&pars));
+}
+
+static uint32_t drainWords(void)
+{
+  uint32_t drained = myRing_PopMany(&ring, &words[wordCount], TEST_RING_SIZE - wordCount);
+
+  wordCount += drained;
+  return drained;
+}
+
+static const char * decodeNext(void)
+{
+  uint32_t consumed = myBinLogDecode_Record(&dec, &words[wordPos], wordCount - wordPos, text, sizeof(text));
+
+  TEST_ASSERT_NOT_EQUAL(0, consumed);
+  wordPos += consumed;
+  return text;
+}
+
+static const char * resolveStub(uint32_t address)
+{
+  for(uint32_t i = 0; i < (sizeof(knownStrings) / sizeof(knownStrings[0])); i++)
+  {
+    if((uint32_t) (uintptr_t) knownStrings[i] == address) { return knownStrings[i]; }
+  }
+
+  return NULL;
+}
@@ -0,0 +1,235 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file test_myBinLog_Write.c
+ * @brief Test file for testing binary logger logic, writing records into
+ *          the ring.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+
+#include "myBinLog.h"
+#include "myRing.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_RING_SIZE                                                      (16)
+#define TEST_LOCK_STATE                                                (0x1234U)
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static void initLog(void);
+static uint32_t popWord(void);
+static uint32_t lockStub(void);
+static void unlockStub(uint32_t state);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static myRing_t ring;
+static uint32_t ringItems[TEST_RING_SIZE];
+static uint32_t lockCallCount;
+static uint32_t unlockCallCount;
+static uint32_t unlockState;
+
+static const char fmtTwoArgs[] = "Timer %u expired after %d us";
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  myBinLog_Reset();
+  lockCallCount = 0;
+  unlockCallCount = 0;
+  unlockState = 0;
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief Initialization should fail without a ring of words, or with only
+ *          one of the lock routines.
+ */
+void test_IfParsAreInvalidThenInitFails(void)
+{
+  myBinLogPars_t pars = { .ring = &ring, .lock = lockStub, .unlock = NULL };
+
+  TEST_ASSERT_EQUAL(myRet_Fail, myBinLog_Init(NULL));
+  TEST_ASSERT_EQUAL(myRet_Fail, myBinLog_Init(&pars));
+
+  myRing_Init(&ring, ringItems, sizeof(uint8_t), TEST_RING_SIZE);
+  pars.unlock = unlockStub;
+  TEST_ASSERT_EQUAL(myRet_Fail, myBinLog_Init(&pars));
+}
+
+/**
+ * @brief Messages logged before the initialization should be dropped.
+ */
+void test_IfNotInitializedThenWriteFails(void)
+{
+  const uint32_t words[] = { 0 };
+
+  TEST_ASSERT_EQUAL(myRet_Fail, myBinLog_Write(words, 0));
+}
+
+/**
+ * @brief A record should be made of its header, the address of its format
+ *          string and its arguments as words.
+ */
+void test_RecordHoldsTheFormatAddressAndTheArguments(void)
+{
+  initLog();
+  myBINLOG(fmtTwoArgs, 7, -20);
+
+  TEST_ASSERT_EQUAL(4, myRing_GetCount(&ring));
+  TEST_ASSERT_EQUAL_HEX32((MY_BINLOG_SYNC << MY_BINLOG_SYNC_SHIFT) | 2, popWord());
+  TEST_ASSERT_EQUAL_HEX32((uint32_t) (uintptr_t) fmtTwoArgs, popWord());
+  TEST_ASSERT_EQUAL(7, popWord());
+  TEST_ASSERT_EQUAL_HEX32((uint32_t) -20, popWord());
+}
+
+/**
+ * @brief A message with no arguments should take only the header and the
+ *          address.
+ */
+void test_IfThereAreNoArgumentsThenRecordHasTwoWords(void)
+{
+  initLog();
+  myBINLOG("Boot");
+
+  TEST_ASSERT_EQUAL(MY_BINLOG_HEADER_WORDS, myRing_GetCount(&ring));
+  TEST_ASSERT_EQUAL(0, popWord() & MY_BINLOG_ARGS_MASK);
+}
+
+/**
+ * @brief All the arguments a message may take should be stored, in order.
+ */
+void test_MaximumAmountOfArgumentsIsStored(void)
+{
+  initLog();
+  myBINLOG("%u %u %u %u %u %u %u %u", 1, 2, 3, 4, 5, 6, 7, 8);
+
+  TEST_ASSERT_EQUAL(MY_BINLOG_MAX_ARGS, popWord() & MY_BINLOG_ARGS_MASK);
+  popWord();
+  for(uint32_t i = 1; i <= MY_BINLOG_MAX_ARGS; i++) { TEST_ASSERT_EQUAL(i, popWord()); }
+}
+
+/**
+ * @brief Records with too many arguments should be refused.
+ */
+void test_IfThereAreTooManyArgumentsThenWriteFails(void)
+{
+  const uint32_t words[MY_BINLOG_MAX_ARGS + 2] = { 0 };
+
+  initLog();
+
+  TEST_ASSERT_EQUAL(myRet_Fail, myBinLog_Write(words, MY_BINLOG_MAX_ARGS + 1));
+  TEST_ASSERT_EQUAL(0, myRing_GetCount(&ring));
+}
+
+/**
+ * @brief The sequence number should go up with each record.
+ */
+void test_SequenceNumberGoesUpWithEachRecord(void)
+{
+  initLog();
+  myBINLOG("A");
+  myBINLOG("B");
+
+  TEST_ASSERT_EQUAL(0, (popWord() >> MY_BINLOG_SEQ_SHIFT) & MY_BINLOG_SEQ_MASK);
+  popWord();
+  TEST_ASSERT_EQUAL(1, (popWord() >> MY_BINLOG_SEQ_SHIFT) & MY_BINLOG_SEQ_MASK);
+}
+
+/**
+ * @brief A record that does not fit should be dropped as a whole, counted,
+ *          and still take its sequence number, so the host notices the gap.
+ */
+void test_IfRecordDoesNotFitThenItIsDroppedAsAWhole(void)
+{
+  initLog();
+  for(uint32_t i = 0; i < 4; i++) { myBINLOG(fmtTwoArgs, i, i); }
+  myBINLOG(fmtTwoArgs, 4, 4);
+
+  TEST_ASSERT_EQUAL(TEST_RING_SIZE, myRing_GetCount(&ring));
+  TEST_ASSERT_EQUAL(1, myBinLog_GetDropped());
+
+  myRing_Init(&ring, ringItems, sizeof(uint32_t), TEST_RING_SIZE);
+  myBINLOG("A");
+  TEST_ASSERT_EQUAL(5, (popWord() >> MY_BINLOG_SEQ_SHIFT) & MY_BINLOG_SEQ_MASK);
+}
+
+/**
+ * @brief Each record should be written under the client's lock, released
+ *          with the state it returned.
+ */
+void test_RecordIsWrittenUnderTheLock(void)
+{
+  myBinLogPars_t pars = { .ring = &ring, .lock = lockStub, .unlock = unlockStub };
+
+  myRing_Init(&ring, ringItems, sizeof(uint32_t), TEST_RING_SIZE);
+  TEST_ASSERT_EQUAL(myRet_OK, myBinLog_Init(&pars));
+  myBINLOG(fmtTwoArgs, 1, 2);
+
+  TEST_ASSERT_EQUAL(1, lockCallCount);
+  TEST_ASSERT_EQUAL(1, unlockCallCount);
+  TEST_ASSERT_EQUAL_HEX32(TEST_LOCK_STATE, unlockState);
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static void initLog(void)
+{
+  myBinLogPars_t pars = { .ring = &ring, .lock = NULL, .unlock = NULL };
+
+  myRing_Init(&ring, ringItems, sizeof(uint32_t), TEST_RING_SIZE);
+  TEST_ASSERT_EQUAL(myRet_OK, myBinLog_Init(&pars));
+}
+
+static uint32_t popWord(void)
+{
+  uint32_t word = 0;
+
+  TEST_ASSERT_EQUAL(myRet_OK, myRing_Pop(&ring, &word));
+  return word;
+}
+
+static uint32_t lockStub(void)
+{
+  lockCallCount++;
+  return TEST_LOCK_STATE;
+}
+
+static void unlockStub(uint32_t state)
+{
+  unlockCallCount++;
+  unlockState = state;
+}
@@ -0,0 +1,257 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file test_myCrash_Record.c
+ * @brief Test file for testing crash record logic, sealing and validating
+ *          records and taking them through a reset.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+
+#include "myCrash.h"
+
+#include <string.h>
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_FILE_ID                                               (0x00012340U)
+#define TEST_LINE                                                          (123)
+#define TEST_STATUS                                                (0x00000400U)
+#define TEST_TIMESTAMP                                                  (98765U)
+#define TEST_RECORD_WORDS                                                   (15)
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static myCrashRecord_t makeRecord(void);
+static void saveAssert(void);
+static uint32_t refCrc32(const uint8_t * data, uint32_t size);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static const myCrashFrame_t testFrame =
+{
+  .r0 = 0x10U, .r1 = 0x11U, .r2 = 0x12U, .r3 = 0x13U, .r12 = 0x1CU,
+  .lr = 0x00001235U, .pc = 0x00004568U, .xpsr = 0x21000003U,
+};
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  myCrash_Reset();
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief The record should only have 32-bit words, so that it has the same
+ *          layout on the target and on the host.
+ */
+void test_RecordHasTheSameLayoutEverywhere(void)
+{
+  TEST_ASSERT_EQUAL(TEST_RECORD_WORDS * sizeof(uint32_t), sizeof(myCrashRecord_t));
+}
+
+/**
+ * @brief A sealed record should be valid, and its CRC should be the usual
+ *          CRC-32 of all the bytes before it.
+ */
+void test_IfRecordIsSealedThenItIsValid(void)
+{
+  myCrashRecord_t rec = makeRecord();
+
+  myCrash_Seal(&rec);
+
+  TEST_ASSERT_TRUE(myCrash_IsValid(&rec));
+  TEST_ASSERT_EQUAL_HEX32(MY_CRASH_MAGIC, rec.magic);
+  TEST_ASSERT_EQUAL_HEX32(refCrc32((const uint8_t *)&rec, sizeof(rec) - sizeof(rec.crc)), rec.crc);
+}
+
+/**
+ * @brief A record full of zeros, or of ones, as RAM may be after a power up,
+ *          should not be valid.
+ */
+void test_IfRecordWasNeverSealedThenItIsNotValid(void)
+{
+  myCrashRecord_t rec;
+
+  memset(&rec, 0x00, sizeof(rec));
+  TEST_ASSERT_FALSE(myCrash_IsValid(&rec));
+
+  memset(&rec, 0xFF, sizeof(rec));
+  TEST_ASSERT_FALSE(myCrash_IsValid(&rec));
+}
+
+/**
+ * @brief Flipping any single bit of a sealed record should make it invalid.
+ */
+void test_IfAnyBitOfRecordChangesThenItIsNotValid(void)
+{
+  myCrashRecord_t rec = makeRecord();
+  uint8_t * bytes = (uint8_t *)&rec;
+  uint32_t bit;
+
+  myCrash_Seal(&rec);
+
+  for(bit = 0; bit < (8 * sizeof(rec)); bit++)
+  {
+    bytes[bit / 8] ^= (uint8_t)(1U << (bit % 8));
+    TEST_ASSERT_FALSE(myCrash_IsValid(&rec));
+    bytes[bit / 8] ^= (uint8_t)(1U << (bit % 8));
+  }
+
+  TEST_ASSERT_TRUE(myCrash_IsValid(&rec));
+}
+
+/**
+ * @brief A record saved before a reset should be taken, as it was, at the
+ *          next boot.
+ */
+void test_IfRecordIsSavedThenItIsTakenAtBoot(void)
+{
+  const myCrashRecord_t * last;
+
+  myCrash_Save(myCrashCause_HardFault, &testFrame, 0, 0, TEST_STATUS, TEST_TIMESTAMP);
+  myCrash_Init();
+  last = myCrash_GetLast();
+
+  TEST_ASSERT_NOT_NULL(last);
+  TEST_ASSERT_EQUAL(myCrashCause_HardFault, last->cause);
+  TEST_ASSERT_EQUAL_MEMORY(&testFrame, &last->frame, sizeof(myCrashFrame_t));
+  TEST_ASSERT_EQUAL_HEX32(TEST_STATUS, last->status);
+  TEST_ASSERT_EQUAL(TEST_TIMESTAMP, last->timestamp);
+}
+
+/**
+ * @brief A failed assertion should keep its file and line, and clear the
+ *          registers when none is given.
+ */
+void test_IfAssertIsSavedThenFileAndLineAreKept(void)
+{
+  const myCrashRecord_t * last;
+  myCrashFrame_t zeros = { 0 };
+
+  myCrash_GetKept()->frame = testFrame;
+  saveAssert();
+  myCrash_Init();
+  last = myCrash_GetLast();
+
+  TEST_ASSERT_NOT_NULL(last);
+  TEST_ASSERT_EQUAL(myCrashCause_Assert, last->cause);
+  TEST_ASSERT_EQUAL_HEX32(TEST_FILE_ID, last->fileId);
+  TEST_ASSERT_EQUAL(TEST_LINE, last->line);
+  TEST_ASSERT_EQUAL_MEMORY(&zeros, &last->frame, sizeof(myCrashFrame_t));
+}
+
+/**
+ * @brief Without a crash in the previous run, there should be no record.
+ */
+void test_IfNothingWasSavedThenThereIsNoRecord(void)
+{
+  myCrash_Init();
+
+  TEST_ASSERT_NULL(myCrash_GetLast());
+}
+
+/**
+ * @brief A record should only be reported by the boot that follows the
+ *          crash, not by the ones after it.
+ */
+void test_IfRecordWasTakenThenNextBootHasNoRecord(void)
+{
+  saveAssert();
+  myCrash_Init();
+  myCrash_Init();
+
+  TEST_ASSERT_NULL(myCrash_GetLast());
+}
+
+/**
+ * @brief A record that was corrupted while kept, as by a power loss, should
+ *          be dropped at boot.
+ */
+void test_IfKeptRecordIsCorruptedThenThereIsNoRecord(void)
+{
+  saveAssert();
+  myCrash_GetKept()->line++;
+  myCrash_Init();
+
+  TEST_ASSERT_NULL(myCrash_GetLast());
+}
+
+/**
+ * @brief A new crash should replace the record of the previous one.
+ */
+void test_IfSavedTwiceThenLastRecordIsKept(void)
+{
+  saveAssert();
+  myCrash_Save(myCrashCause_BusFault, &testFrame, 0, 0, TEST_STATUS, TEST_TIMESTAMP);
+  myCrash_Init();
+
+  TEST_ASSERT_NOT_NULL(myCrash_GetLast());
+  TEST_ASSERT_EQUAL(myCrashCause_BusFault, myCrash_GetLast()->cause);
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static myCrashRecord_t makeRecord(void)
+{
+  myCrashRecord_t rec = { 0 };
+
+  rec.cause = myCrashCause_Assert;
+  rec.fileId = TEST_FILE_ID;
+  rec.line = TEST_LINE;
+  rec.frame = testFrame;
+  rec.timestamp = TEST_TIMESTAMP;
+
+  return rec;
+}
+
+static void saveAssert(void)
+{
+  myCrash_Save(myCrashCause_Assert, NULL, TEST_FILE_ID, TEST_LINE, 0, TEST_TIMESTAMP);
+}
+
+/* Bit by bit CRC-32, the reference for the table-driven one.                 */
+static uint32_t refCrc32(const uint8_t * data, uint32_t size)
+{
+  uint32_t crc = 0xFFFFFFFFUL;
+  uint32_t bit;
+
+  while(size-- > 0)
+  {
+    crc ^= *data++;
+    for(bit = 0; bit < 8; bit++) { crc = (crc >> 1) ^ ((crc & 1U) ? 0xEDB88320UL : 0); }
+  }
+
+  return ~crc;
+}
@@ -0,0 +1,177 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test_myDebounce_Events.c
+ * @brief Test file for testing debouncer logic, operation when inputs are
+ *          long pressed and double clicked.
+ *
+ * Waveforms are replayed as in test_myDebounce_Waveform.c, with long presses
+ *  after TEST_LONG_TICKS ticks and double clicks within TEST_DOUBLE_TICKS.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+
+#include "myDebounce.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_WAVE_MAX                                                       (64)
+#define TEST_LONG_TICKS                                                     (10)
+#define TEST_DOUBLE_TICKS                                                    (8)
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static const char * replay(const char * wave);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static myDebounce_t deb;
+static myDebouncePars_t pars;
+static char events[TEST_WAVE_MAX + 1];
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  pars = (myDebouncePars_t) { 0, TEST_LONG_TICKS, TEST_DOUBLE_TICKS };
+  myDebounce_Init(&deb, &pars);
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief Init should fail if any of the times cannot be counted.
+ */
+void test_IfTicksAreTooLongThenInitFails(void)
+{
+  pars.longTicks = MY_DEBOUNCE_TICKS_MAX + 1;
+  TEST_ASSERT_EQUAL(myRet_Fail, myDebounce_Init(&deb, &pars));
+
+  pars.longTicks = TEST_LONG_TICKS;
+  pars.doubleTicks = MY_DEBOUNCE_TICKS_MAX + 1;
+  TEST_ASSERT_EQUAL(myRet_Fail, myDebounce_Init(&deb, &pars));
+}
+
+/**
+ * @brief Holding an input should report a single long press, and its
+ *          release should not arm a double click.
+ */
+void test_IfInputIsHeldThenLongPressIsReportedOnce(void)
+{
+  TEST_ASSERT_EQUAL_STRING("...P .... .... L... .... ...R ...P",
+                    replay("1111 1111 1111 1111 1111 0000 1111"));
+}
+
+/**
+ * @brief A second press soon after a click should be a double click.
+ */
+void test_IfSecondPressIsSoonThenDoubleClickIsReported(void)
+{
+  TEST_ASSERT_EQUAL_STRING("...P ...R ...D ...R .... ....",
+                    replay("1111 0000 1111 0000 0000 0000"));
+}
+
+/**
+ * @brief A second press too late after a click should be a plain press.
+ */
+void test_IfSecondPressIsLateThenItIsAPlainPress(void)
+{
+  TEST_ASSERT_EQUAL_STRING("...P ...R .... .... ...P",
+                    replay("1111 0000 0000 0000 1111"));
+}
+
+/**
+ * @brief The press after a double click should start over, instead of
+ *          being another double click.
+ */
+void test_IfThirdPressIsSoonThenItIsAPlainPress(void)
+{
+  TEST_ASSERT_EQUAL_STRING("...P ...R ...D ...R ...P",
+                    replay("1111 0000 1111 0000 1111"));
+}
+
+/**
+ * @brief Zero ticks should disable long presses and double clicks.
+ */
+void test_IfTicksAreZeroThenEventsAreDisabled(void)
+{
+  pars.longTicks = 0;
+  pars.doubleTicks = 0;
+  myDebounce_Init(&deb, &pars);
+
+  TEST_ASSERT_EQUAL_STRING("...P ...R ...P .... .... .... ....",
+                    replay("1111 0000 1111 1111 1111 1111 1111"));
+}
+
+/**
+ * @brief The debouncer should only be idle when there is nothing to wait
+ *          for: no input pressed nor settling, and no double click pending.
+ */
+void test_IdleOnlyWhenNothingIsPending(void)
+{
+  TEST_ASSERT_TRUE(myDebounce_IsIdle(&deb));
+
+  replay("1");
+  TEST_ASSERT_FALSE(myDebounce_IsIdle(&deb));
+
+  replay("111");
+  TEST_ASSERT_FALSE(myDebounce_IsIdle(&deb));
+
+  replay("0000");
+  TEST_ASSERT_FALSE(myDebounce_IsIdle(&deb));
+
+  replay("0000 000");
+  TEST_ASSERT_TRUE(myDebounce_IsIdle(&deb));
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static const char * replay(const char * wave)
+{
+  myDebounceEvts_t evts;
+  uint32_t idx;
+
+  for(idx = 0; (wave[idx] != '\0') && (idx < TEST_WAVE_MAX); idx++)
+  {
+    if(wave[idx] == ' ') { events[idx] = ' '; continue; }
+
+    myDebounce_Update(&deb, (wave[idx] == '1') ? 0x01 : 0x00, &evts);
+
+    if     (evts.doubleClick & 0x01) { events[idx] = 'D'; }
+    else if(evts.press & 0x01)       { events[idx] = 'P'; }
+    else if(evts.release & 0x01)     { events[idx] = 'R'; }
+    else if(evts.longPress & 0x01)   { events[idx] = 'L'; }
+    else                             { events[idx] = '.'; }
+  }
+
+  events[idx] = '\0';
+  return events;
+}
@@ -0,0 +1,161 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test_myDebounce_Waveform.c
+ * @brief Test file for testing debouncer logic, operation when recorded
+ *          bouncing waveforms are replayed into it.
+ *
+ * Waveforms have one sample per character, one per tick, and the events are
+ *  recorded the same way, so that each event sits right below the sample
+ *  that caused it. Spaces just group the ticks, for readability.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+
+#include "myDebounce.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_WAVE_MAX                                                       (64)
+#define TEST_INPUTS                                                         (32)
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static const char * replay(const char * wave);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static myDebounce_t deb;
+static myDebouncePars_t pars;
+static char events[TEST_WAVE_MAX + 1];
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  pars = (myDebouncePars_t) { 0 };
+  myDebounce_Init(&deb, &pars);
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief A clean edge should be reported once it was stable for four ticks.
+ */
+void test_IfEdgeIsCleanThenPressIsReportedAfterFourTicks(void)
+{
+  TEST_ASSERT_EQUAL_STRING(".... ...P ..", replay("0000 1111 11"));
+  TEST_ASSERT_EQUAL_HEX32(0x01, myDebounce_GetState(&deb));
+}
+
+/**
+ * @brief A press that bounces should be reported a single time, once the
+ *          contact settles.
+ */
+void test_IfPressBouncesThenItIsReportedOnce(void)
+{
+  TEST_ASSERT_EQUAL_STRING(".... .... .... ...P .", replay("0000 1010 0110 1111 1"));
+}
+
+/**
+ * @brief A release that bounces should be reported a single time, once the
+ *          contact settles.
+ */
+void test_IfReleaseBouncesThenItIsReportedOnce(void)
+{
+  TEST_ASSERT_EQUAL_STRING("...P .... .... .... R...", replay("1111 1111 0101 1000 0000"));
+  TEST_ASSERT_EQUAL_HEX32(0x00, myDebounce_GetState(&deb));
+}
+
+/**
+ * @brief A glitch shorter than four ticks should be filtered out.
+ */
+void test_IfGlitchIsShortThenNothingIsReported(void)
+{
+  TEST_ASSERT_EQUAL_STRING(".... ... .... .... ...", replay("0000 111 0000 1101 000"));
+}
+
+/**
+ * @brief Inverted inputs should be pressed when their sample is low.
+ */
+void test_IfInputIsInvertedThenLowIsPressed(void)
+{
+  pars.invert = 0x01;
+  myDebounce_Init(&deb, &pars);
+
+  TEST_ASSERT_EQUAL_STRING(".... ...P ...R", replay("1111 0000 1111"));
+}
+
+/**
+ * @brief All the inputs should be debounced at once, each one on its own.
+ *          Input N is pressed on tick N, so it should be reported on tick
+ *          N + 3, alone.
+ */
+void test_AllInputsAreDebouncedInParallel(void)
+{
+  myDebounceEvts_t evts;
+  uint32_t tick, sample;
+
+  for(tick = 0; tick < TEST_INPUTS + 3; tick++)
+  {
+    sample = (tick >= TEST_INPUTS) ? UINT32_MAX : ((1UL << tick) - 1) | (1UL << tick);
+    myDebounce_Update(&deb, sample, &evts);
+
+    if(tick < 3) { TEST_ASSERT_EQUAL_HEX32(0, evts.press); }
+    else         { TEST_ASSERT_EQUAL_HEX32(1UL << (tick - 3), evts.press); }
+  }
+
+  TEST_ASSERT_EQUAL_HEX32(UINT32_MAX, myDebounce_GetState(&deb));
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static const char * replay(const char * wave)
+{
+  myDebounceEvts_t evts;
+  uint32_t idx;
+
+  for(idx = 0; (wave[idx] != '\0') && (idx < TEST_WAVE_MAX); idx++)
+  {
+    if(wave[idx] == ' ') { events[idx] = ' '; continue; }
+
+    myDebounce_Update(&deb, (wave[idx] == '1') ? 0x01 : 0x00, &evts);
+
+    if     (evts.doubleClick & 0x01) { events[idx] = 'D'; }
+    else if(evts.press & 0x01)       { events[idx] = 'P'; }
+    else if(evts.release & 0x01)     { events[idx] = 'R'; }
+    else if(evts.longPress & 0x01)   { events[idx] = 'L'; }
+    else                             { events[idx] = '.'; }
+  }
+
+  events[idx] = '\0';
+  return events;
+}
@@ -0,0 +1,334 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file test_myFormat_Benchmark.c
+ * @brief Test file for checking that the number conversions give the very
+ *          same digits as the ones of the SDK debug console, over random
+ *          numbers.
+ *
+ * The SDK conversions are copied below as the reference, with one division
+ *  per digit and double math for floating point. The host time per
+ *  conversion is printed for reference only, side by side with them: the
+ *  host divides and handles doubles in hardware, so the gap on the M0+,
+ *  which calls the library for both, is much wider.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "unity.h"
+#include "myTestDefs.h"
+
+#include "myFormat.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_CONVERSIONS                                                (200000)
+#define TEST_RANDOM_SEED                                                  (1234)
+#define TEST_DIGITS_SIZE                                                   (128)
+#define TEST_MAX_PRECISION                                                   (9)
+
+/**
+ * @brief Kinds of numbers converted, each one with its own reference.
+ */
+typedef enum
+{
+  testKind_Dec = 0,
+  testKind_Dec64,
+  testKind_Hex,
+  testKind_Fixed,
+} testKind_t;
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static void compareConversions(testKind_t kind, const char * name);
+static void makeInputs(testKind_t kind);
+static uint32_t convertFast(testKind_t kind, uint32_t idx, char * digits);
+static uint32_t convertSdk(testKind_t kind, uint32_t idx, char * digits);
+static uint64_t random64(void);
+static uint64_t getTimeNs(void);
+
+static uint32_t sdkRadix32(char * numstr, uint32_t ua, uint32_t radix, bool use_caps);
+static uint32_t sdkRadix64(char * numstr, uint64_t ua, uint64_t radix, bool use_caps);
+static uint32_t sdkFloat(char * numstr, double r, uint32_t precision_width);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static uint64_t inputs[TEST_CONVERSIONS];
+static volatile uint32_t decRadix = 10;
+static volatile uint32_t hexRadix = 16;
+static double floatInputs[TEST_CONVERSIONS];
+static uint32_t precisions[TEST_CONVERSIONS];
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  srand(TEST_RANDOM_SEED);
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief 32-bit decimal digits should match the SDK ones.
+ */
+void test_DecimalMatchesTheSdk(void)
+{
+  compareConversions(testKind_Dec, "dec32");
+}
+
+/**
+ * @brief 64-bit decimal digits should match the SDK ones.
+ */
+void test_Decimal64MatchesTheSdk(void)
+{
+  compareConversions(testKind_Dec64, "dec64");
+}
+
+/**
+ * @brief Hexadecimal digits should match the SDK ones.
+ */
+void test_HexadecimalMatchesTheSdk(void)
+{
+  compareConversions(testKind_Hex, "hex");
+}
+
+/**
+ * @brief Fixed-point digits should match the SDK ones, for numbers whose
+ *          integer part fits an int32_t.
+ */
+void test_FixedPointMatchesTheSdk(void)
+{
+  compareConversions(testKind_Fixed, "fixed");
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static void compareConversions(testKind_t kind, const char * name)
+{
+  char fast[TEST_DIGITS_SIZE];
+  char sdk[TEST_DIGITS_SIZE];
+  uint64_t fastNs, sdkNs;
+  uint32_t idx, count;
+  volatile uint32_t sink = 0;
+
+  makeInputs(kind);
+
+  for(idx = 0; idx < TEST_CONVERSIONS; idx++)
+  {
+    count = convertFast(kind, idx, fast);
+
+    TEST_ASSERT_EQUAL(convertSdk(kind, idx, sdk), count);
+    TEST_ASSERT_EQUAL_MEMORY(sdk, fast, count);
+  }
+
+  fastNs = getTimeNs();
+  for(idx = 0; idx < TEST_CONVERSIONS; idx++) { sink += convertFast(kind, idx, fast); }
+  fastNs = getTimeNs() - fastNs;
+
+  sdkNs = getTimeNs();
+  for(idx = 0; idx < TEST_CONVERSIONS; idx++) { sink += convertSdk(kind, idx, sdk); }
+  sdkNs = getTimeNs() - sdkNs;
+
+  printf("%-6s %u conversions: fast %6.1f ns/conversion, sdk %6.1f ns/conversion\n",
+         name, (unsigned) TEST_CONVERSIONS,
+         (double) fastNs / TEST_CONVERSIONS, (double) sdkNs / TEST_CONVERSIONS);
+  (void) sink;
+}
+
+static void makeInputs(testKind_t kind)
+{
+  uint32_t idx;
+
+  for(idx = 0; idx < TEST_CONVERSIONS; idx++)
+  {
+    /* Shift by a random amount, so that every length of number shows up.     */
+    const uint64_t value = random64() >> ((uint32_t) rand() % 64);
+
+    inputs[idx] = (kind == testKind_Dec64) ? value : (uint32_t) value;
+
+    /* Integer parts below 2^31, as the SDK overflows on larger ones.         */
+    floatInputs[idx] = ldexp((double) (random64() >> 11), -(int) (22 + ((uint32_t) rand() % 62)));
+    if((rand() & 1) != 0) { floatInputs[idx] = -floatInputs[idx]; }
+    precisions[idx] = (uint32_t) rand() % (TEST_MAX_PRECISION + 1);
+  }
+}
+
+static uint32_t convertFast(testKind_t kind, uint32_t idx, char * digits)
+{
+  switch(kind)
+  {
+    case testKind_Dec:   return myFormat_Dec((uint32_t) inputs[idx], digits);
+    case testKind_Dec64: return myFormat_Dec64(inputs[idx], digits);
+    case testKind_Hex:   return myFormat_Pow2(inputs[idx], 4, true, digits);
+    default:             return myFormat_Fixed(floatInputs[idx], precisions[idx], digits);
+  }
+}
+
+static uint32_t convertSdk(testKind_t kind, uint32_t idx, char * digits)
+{
+  /* The radix is not known while building, as in the SDK, so the host does   */
+  /*  real divisions, much like the M0+ calling the library for each digit.   */
+  switch(kind)
+  {
+    case testKind_Dec:   return sdkRadix32(digits, (uint32_t) inputs[idx], decRadix, false);
+    case testKind_Dec64: return sdkRadix64(digits, inputs[idx], decRadix, false);
+    case testKind_Hex:   return sdkRadix32(digits, (uint32_t) inputs[idx], hexRadix, true);
+    default:             return sdkFloat(digits, floatInputs[idx], precisions[idx]);
+  }
+}
+
+static uint64_t random64(void)
+{
+  return ((uint64_t) (rand() & 0xFFFF) << 48) | ((uint64_t) (rand() & 0xFFFF) << 32) |
+         ((uint64_t) (rand() & 0xFFFF) << 16) | (uint64_t) (rand() & 0xFFFF);
+}
+
+static uint64_t getTimeNs(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return ((uint64_t) now.tv_sec * 1000000000ULL) + (uint64_t) now.tv_nsec;
+}
+
+/* Set below the conversions of the SDK debug console, unsigned paths only,   */
+/*  with the digits written straight at numstr instead of after a terminator. */
+static uint32_t sdkRadix32(char * numstr, uint32_t ua, uint32_t radix, bool use_caps)
+{
+  uint32_t ub, uc;
+  uint32_t nlen = 0;
+
+  if(ua == 0)
+  {
+    numstr[nlen++] = '0';
+    return nlen;
+  }
+  while(ua != 0)
+  {
+    ub = ua / radix;
+    uc = ua - (ub * radix);
+    uc = (uc < 10) ? (uc + '0') : (uc - 10 + (use_caps ? 'A' : 'a'));
+    ua = ub;
+    numstr[nlen++] = (char) uc;
+  }
+  return nlen;
+}
+
+static uint32_t sdkRadix64(char * numstr, uint64_t ua, uint64_t radix, bool use_caps)
+{
+  uint64_t ub, uc;
+  uint32_t nlen = 0;
+
+  if(ua == 0)
+  {
+    numstr[nlen++] = '0';
+    return nlen;
+  }
+  while(ua != 0)
+  {
+    ub = ua / radix;
+    uc = ua - (ub * radix);
+    uc = (uc < 10) ? (uc + '0') : (uc - 10 + (use_caps ? 'A' : 'a'));
+    ua = ub;
+    numstr[nlen++] = (char) uc;
+  }
+  return nlen;
+}
+
+static uint32_t sdkFloat(char * numstr, double r, uint32_t precision_width)
+{
+  int32_t a, b, c, i;
+  uint32_t uc;
+  double fa, dc, fb, fractpart, intpart, scale = 1;
+  uint32_t nlen = 0;
+
+  /* Same as the SDK, but the power of ten is built along with the fraction,  */
+  /*  as Ceedling doesn't link the tests with libm.                           */
+  fractpart = modf(r, &intpart);
+  for(i = 0; i < (int32_t) precision_width; i++) { fractpart *= 10; scale *= 10; }
+  if(r >= 0)
+  {
+    fa = fractpart + (double) 0.5;
+    if(fa >= scale) { intpart++; }
+  }
+  else
+  {
+    fa = fractpart - (double) 0.5;
+    if(fa <= -scale) { intpart--; }
+  }
+  for(i = 0; i < (int32_t) precision_width; i++)
+  {
+    fb = fa / 10;
+    dc = (fa - (int64_t) fb * 10);
+    c = (int32_t) dc;
+    if(c < 0)
+    {
+      uc = (uint32_t) c;
+      c = (int32_t) (~uc) + 1 + '0';
+    }
+    else
+    {
+      c = c + '0';
+    }
+    fa = fb;
+    numstr[nlen++] = (char) c;
+  }
+  numstr[nlen++] = '.';
+  a = (int32_t) intpart;
+  if(a == 0)
+  {
+    numstr[nlen++] = '0';
+  }
+  else
+  {
+    while(a != 0)
+    {
+      b = a / 10;
+      c = a - (b * 10);
+      if(c < 0)
+      {
+        uc = (uint32_t) c;
+        c = (int32_t) (~uc) + 1 + '0';
+      }
+      else
+      {
+        c = c + '0';
+      }
+      a = b;
+      numstr[nlen++] = (char) c;
+    }
+  }
+  return nlen;
+}
@@ -0,0 +1,163 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file test_myFormat_Digits.c
+ * @brief Test file for testing number conversion logic, digits written for
+ *          boundary values.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+
+#include "myFormat.h"
+
+#include <math.h>
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_TEXT_SIZE                                                     (128)
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static const char * toText(uint32_t count);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static char digits[TEST_TEXT_SIZE];
+static char text[TEST_TEXT_SIZE];
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief Decimal digits should be right around every pair and quad boundary.
+ */
+void test_DecimalDigitsAroundBoundaries(void)
+{
+  TEST_ASSERT_EQUAL_STRING("0", toText(myFormat_Dec(0, digits)));
+  TEST_ASSERT_EQUAL_STRING("9", toText(myFormat_Dec(9, digits)));
+  TEST_ASSERT_EQUAL_STRING("10", toText(myFormat_Dec(10, digits)));
+  TEST_ASSERT_EQUAL_STRING("99", toText(myFormat_Dec(99, digits)));
+  TEST_ASSERT_EQUAL_STRING("100", toText(myFormat_Dec(100, digits)));
+  TEST_ASSERT_EQUAL_STRING("9999", toText(myFormat_Dec(9999, digits)));
+  TEST_ASSERT_EQUAL_STRING("10000", toText(myFormat_Dec(10000, digits)));
+  TEST_ASSERT_EQUAL_STRING("100000009", toText(myFormat_Dec(100000009, digits)));
+  TEST_ASSERT_EQUAL_STRING("4294967295", toText(myFormat_Dec(UINT32_MAX, digits)));
+}
+
+/**
+ * @brief 64-bit decimal digits should be right, with and without the upper
+ *          half in use.
+ */
+void test_Decimal64DigitsAroundBoundaries(void)
+{
+  TEST_ASSERT_EQUAL_STRING("0", toText(myFormat_Dec64(0, digits)));
+  TEST_ASSERT_EQUAL_STRING("4294967295", toText(myFormat_Dec64(UINT32_MAX, digits)));
+  TEST_ASSERT_EQUAL_STRING("4294967296", toText(myFormat_Dec64(1ULL << 32, digits)));
+  TEST_ASSERT_EQUAL_STRING("1000000000000000000", toText(myFormat_Dec64(1000000000000000000ULL, digits)));
+  TEST_ASSERT_EQUAL_STRING("18446744073709551615", toText(myFormat_Dec64(UINT64_MAX, digits)));
+}
+
+/**
+ * @brief Digits of the power of two bases should follow the case asked for.
+ */
+void test_PowerOfTwoDigits(void)
+{
+  TEST_ASSERT_EQUAL_STRING("0", toText(myFormat_Pow2(0, 4, false, digits)));
+  TEST_ASSERT_EQUAL_STRING("deadbeef", toText(myFormat_Pow2(0xDEADBEEF, 4, false, digits)));
+  TEST_ASSERT_EQUAL_STRING("DEADBEEF", toText(myFormat_Pow2(0xDEADBEEF, 4, true, digits)));
+  TEST_ASSERT_EQUAL_STRING("123456789ABCDEF0", toText(myFormat_Pow2(0x123456789ABCDEF0ULL, 4, true, digits)));
+  TEST_ASSERT_EQUAL_STRING("777", toText(myFormat_Pow2(0777, 3, false, digits)));
+  TEST_ASSERT_EQUAL_STRING("1000000000000000000000", toText(myFormat_Pow2(1ULL << 63, 3, false, digits)));
+  TEST_ASSERT_EQUAL_STRING("101", toText(myFormat_Pow2(5, 1, false, digits)));
+}
+
+/**
+ * @brief Fixed-point digits should be rounded half away from zero, carrying
+ *          over into the integer part when needed.
+ */
+void test_FixedPointIsRounded(void)
+{
+  TEST_ASSERT_EQUAL_STRING("3.14", toText(myFormat_Fixed(3.14159, 2, digits)));
+  TEST_ASSERT_EQUAL_STRING("3.142", toText(myFormat_Fixed(3.14159, 3, digits)));
+  TEST_ASSERT_EQUAL_STRING("10.00", toText(myFormat_Fixed(9.999, 2, digits)));
+  TEST_ASSERT_EQUAL_STRING("1.", toText(myFormat_Fixed(0.5, 0, digits)));
+  TEST_ASSERT_EQUAL_STRING("3.", toText(myFormat_Fixed(-2.5, 0, digits)));
+  TEST_ASSERT_EQUAL_STRING("0.125000", toText(myFormat_Fixed(0.125, 6, digits)));
+}
+
+/**
+ * @brief Fixed-point digits should not carry the sign, which is the caller's.
+ */
+void test_FixedPointHasNoSign(void)
+{
+  TEST_ASSERT_EQUAL_STRING("42.75", toText(myFormat_Fixed(-42.75, 2, digits)));
+}
+
+/**
+ * @brief Tiny numbers, subnormals included, should be written as zero.
+ */
+void test_TinyNumbersAreZero(void)
+{
+  TEST_ASSERT_EQUAL_STRING("0.000000", toText(myFormat_Fixed(1e-30, 6, digits)));
+  TEST_ASSERT_EQUAL_STRING("0.000000", toText(myFormat_Fixed(4.9e-324, 6, digits)));
+  TEST_ASSERT_EQUAL_STRING("0.000001", toText(myFormat_Fixed(0.00000075, 6, digits)));
+  TEST_ASSERT_EQUAL_STRING("0.000000", toText(myFormat_Fixed(0.0000004, 6, digits)));
+}
+
+/**
+ * @brief Integer parts that do not fit an int32_t should saturate, as a
+ *          conversion to int32_t does, and a NaN should be zero.
+ */
+void test_LargeNumbersSaturate(void)
+{
+  TEST_ASSERT_EQUAL_STRING("2147483647.00", toText(myFormat_Fixed(1e12, 2, digits)));
+  TEST_ASSERT_EQUAL_STRING("2147483648.00", toText(myFormat_Fixed(-1e12, 2, digits)));
+  TEST_ASSERT_EQUAL_STRING("2147483647.00", toText(myFormat_Fixed(INFINITY, 2, digits)));
+  TEST_ASSERT_EQUAL_STRING("0.00", toText(myFormat_Fixed(NAN, 2, digits)));
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static const char * toText(uint32_t count)
+{
+  TEST_ASSERT_LESS_THAN(TEST_TEXT_SIZE, count);
+
+  for(uint32_t idx = 0; idx < count; idx++) { text[idx] = digits[count - 1 - idx]; }
+  text[count] = '\0';
+
+  return text;
+}
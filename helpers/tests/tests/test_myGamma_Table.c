@@ -0,0 +1,127 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test_myGamma_Table.c
+ * @brief Test file for testing gamma correction logic, operation when light
+ *          levels are mapped to duty cycles.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+
+#include "myGamma.h"
+
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+/* Duty cycles of a gamma of 2.2 at a quarter, half and three quarters of the */
+/*  levels, and how far the curve may be from them. That is half a percent of */
+/*  the highest duty cycle.                                                   */
+#define TEST_DUTY_QUARTER                                                 (3131)
+#define TEST_DUTY_HALF                                                   (14386)
+#define TEST_DUTY_3QUARTERS                                              (35103)
+#define TEST_TOLERANCE                                                     (328)
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief The lowest level should be fully off, and the highest fully on.
+ */
+void test_IfLevelIsAtTheEndsThenDutyIsOffOrOn(void)
+{
+  TEST_ASSERT_EQUAL(0, myGamma_Get(0));
+  TEST_ASSERT_EQUAL(MY_GAMMA_DUTY_MAX, myGamma_Get(MY_GAMMA_LEVEL_MAX));
+}
+
+/**
+ * @brief A brighter level should never have a lower duty cycle.
+ */
+void test_IfLevelGoesUpThenDutyNeverGoesDown(void)
+{
+  uint32_t level;
+
+  for(level = 1; level <= MY_GAMMA_LEVEL_MAX; level++)
+  {
+    TEST_ASSERT_TRUE(myGamma_Get(level) >= myGamma_Get(level - 1));
+  }
+}
+
+/**
+ * @brief The duty cycles should lie between a gamma of 2 and a gamma of 3.
+ */
+void test_IfLevelIsMappedThenDutyIsBetweenSquareAndCube(void)
+{
+  const uint64_t max = MY_GAMMA_LEVEL_MAX;
+  uint64_t level;
+
+  for(level = 0; level <= MY_GAMMA_LEVEL_MAX; level++)
+  {
+    const uint64_t square = (MY_GAMMA_DUTY_MAX * level * level) / (max * max);
+    const uint64_t cube = (MY_GAMMA_DUTY_MAX * level * level * level) / (max * max * max);
+
+    TEST_ASSERT_TRUE(myGamma_Get(level) <= (square + 1));
+    TEST_ASSERT_TRUE(myGamma_Get(level) >= cube);
+  }
+}
+
+/**
+ * @brief The duty cycles should follow a gamma of 2.2 closely, which is what
+ *          makes even steps of level look even.
+ */
+void test_IfLevelIsMappedThenDutyFollowsTheGamma(void)
+{
+  TEST_ASSERT_UINT32_WITHIN(TEST_TOLERANCE, TEST_DUTY_QUARTER, myGamma_Get(64));
+  TEST_ASSERT_UINT32_WITHIN(TEST_TOLERANCE, TEST_DUTY_HALF, myGamma_Get(128));
+  TEST_ASSERT_UINT32_WITHIN(TEST_TOLERANCE, TEST_DUTY_3QUARTERS, myGamma_Get(192));
+}
+
+/**
+ * @brief The table should hold exactly what the macro computes, so that
+ *          constant levels can skip the table altogether.
+ */
+void test_IfLevelIsConstantThenMacroMatchesTable(void)
+{
+  TEST_ASSERT_EQUAL(MY_GAMMA(1), myGamma_Get(1));
+  TEST_ASSERT_EQUAL(MY_GAMMA(64), myGamma_Get(64));
+  TEST_ASSERT_EQUAL(MY_GAMMA(128), myGamma_Get(128));
+  TEST_ASSERT_EQUAL(MY_GAMMA(200), myGamma_Get(200));
+}
+
+/**
+ * @brief Dim levels should still light up, instead of being rounded down to
+ *          fully off.
+ */
+void test_IfLevelIsDimThenDutyIsNotZero(void)
+{
+  TEST_ASSERT_NOT_EQUAL(0, myGamma_Get(1));
+}
@@ -0,0 +1,205 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file test_myLog_Levels.c
+ * @brief Test file for testing logging logic, levels removed while building
+ *          and modules masked at run time.
+ *
+ * Levels after INFO are removed here, and messages are sent to a stub that
+ *  formats them. Removed calls are checked on their expansion itself, which
+ *  must be empty, so that they leave no code whatever the optimization.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+
+#define MY_LOG_LEVEL                                           MY_LOG_LEVEL_INFO
+#define MY_LOG_OUTPUT(FMT, ...)                 outputStub(FMT, ##__VA_ARGS__)
+#include "myLog.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_TEXT_SIZE                                                      (64)
+#define TEST_EMPTY_EXPANSION                                   "do { } while(0)"
+
+/* Set below the macros that turn an expansion into a string.                 */
+#define TEST_STRINGIFY(X)                                                     #X
+#define TEST_EXPANSION(X)                                      TEST_STRINGIFY(X)
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static void outputStub(const char * fmt, ...);
+static uint32_t sideEffect(void);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static uint32_t outputCallCount;
+static uint32_t sideEffectCallCount;
+static char text[TEST_TEXT_SIZE];
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  myLog_Reset();
+  outputCallCount = 0;
+  sideEffectCallCount = 0;
+  text[0] = '\0';
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief Messages of the levels kept should be sent, tagged with their
+ *          level.
+ */
+void test_KeptLevelsAreSentWithTheirTag(void)
+{
+  myLOG_ERROR(myLogMod_Gpio, "error %u", 1);
+  TEST_ASSERT_EQUAL_STRING("E error 1", text);
+
+  myLOG_WARN(myLogMod_Timer, "warn %u", 2);
+  TEST_ASSERT_EQUAL_STRING("W warn 2", text);
+
+  myLOG_INFO(myLogMod_Os, "info");
+  TEST_ASSERT_EQUAL_STRING("I info", text);
+
+  TEST_ASSERT_EQUAL(3, outputCallCount);
+}
+
+/**
+ * @brief Calls of the levels removed should expand to an empty statement,
+ *          so that they generate no code at all.
+ */
+void test_RemovedLevelsExpandToNothing(void)
+{
+  TEST_ASSERT_EQUAL_STRING(TEST_EMPTY_EXPANSION, TEST_EXPANSION(myLOG_DEBUG(myLogMod_Gpio, "debug %u", sideEffect())));
+  TEST_ASSERT_EQUAL_STRING(TEST_EMPTY_EXPANSION, TEST_EXPANSION(myLOG_TRACE(myLogMod_Gpio, "trace %u", sideEffect())));
+}
+
+/**
+ * @brief The arguments of the levels removed should never be evaluated.
+ */
+void test_RemovedLevelsDoNotEvaluateArguments(void)
+{
+  myLOG_DEBUG(myLogMod_Gpio, "debug %u", sideEffect());
+  myLOG_TRACE(myLogMod_Gpio, "trace %u", sideEffect());
+
+  TEST_ASSERT_EQUAL(0, sideEffectCallCount);
+  TEST_ASSERT_EQUAL(0, outputCallCount);
+}
+
+/**
+ * @brief Every module should be enabled from the start.
+ */
+void test_AllModulesAreEnabledByDefault(void)
+{
+  for(uint32_t mod = 0; mod < myLogMod_Count; mod++)
+  {
+    myLOG_INFO(mod, "module %u", mod);
+  }
+
+  TEST_ASSERT_EQUAL(myLogMod_Count, outputCallCount);
+}
+
+/**
+ * @brief Messages of a disabled module should not be sent, nor have their
+ *          arguments evaluated, while the other modules go on.
+ */
+void test_IfModuleIsDisabledThenItsMessagesAreNotSent(void)
+{
+  myLog_Disable(myLogMod_AppLed);
+
+  myLOG_ERROR(myLogMod_AppLed, "led %u", sideEffect());
+  TEST_ASSERT_EQUAL(0, outputCallCount);
+  TEST_ASSERT_EQUAL(0, sideEffectCallCount);
+
+  myLOG_ERROR(myLogMod_AppButton, "button %u", sideEffect());
+  TEST_ASSERT_EQUAL(1, outputCallCount);
+}
+
+/**
+ * @brief A module enabled again should have its messages sent again.
+ */
+void test_IfModuleIsEnabledAgainThenItsMessagesAreSent(void)
+{
+  myLog_Disable(myLogMod_Timer);
+  myLog_Enable(myLogMod_Timer);
+
+  myLOG_WARN(myLogMod_Timer, "timer");
+  TEST_ASSERT_EQUAL(1, outputCallCount);
+}
+
+/**
+ * @brief Setting the whole mask should enable only the modules in it.
+ */
+void test_MaskSetsEnabledModulesAtOnce(void)
+{
+  myLog_SetMask(1UL << myLogMod_Os);
+
+  myLOG_INFO(myLogMod_Gpio, "gpio");
+  myLOG_INFO(myLogMod_Os, "os");
+
+  TEST_ASSERT_EQUAL(1, outputCallCount);
+  TEST_ASSERT_EQUAL_STRING("I os", text);
+  TEST_ASSERT_EQUAL_HEX32(1UL << myLogMod_Os, myLog_Mask);
+}
+
+/**
+ * @brief Modules that do not exist should leave the mask as it was.
+ */
+void test_IfModuleIsInvalidThenMaskIsKept(void)
+{
+  myLog_Disable(myLogMod_Count);
+
+  TEST_ASSERT_EQUAL_HEX32(MY_LOG_MASK_DEFAULT, myLog_Mask);
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static void outputStub(const char * fmt, ...)
+{
+  va_list args;
+
+  va_start(args, fmt);
+  vsnprintf(text, sizeof(text), fmt, args);
+  va_end(args);
+
+  outputCallCount++;
+}
+
+static uint32_t sideEffect(void)
+{
+  return ++sideEffectCallCount;
+}
@@ -0,0 +1,148 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file test_myPeriod_Next.c
+ * @brief Test file for testing period accumulator logic, operation when the
+ *          counts of the next periods are requested.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+#include "myMacros.h"
+
+#include "myPeriod.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_LONG_RUN_PERIODS                                          (5000000)
+
+/* A period given as a time, in ms, and the frequency, in Hz, of the timer    */
+/*  that counts it. The frequency is also given as a fraction, as timers use  */
+/*  prescaled clocks.                                                         */
+typedef struct
+{
+  uint32_t periodMs;
+  uint32_t clockHz;
+  uint32_t prescaler;
+} testPeriod_t;
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static void initPeriod(const testPeriod_t * test);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static myPeriod_t period;
+
+static const testPeriod_t testPeriods[] =
+{
+  {    1,  8000000,  128 },   /* KL25 TPM, 62.5 counts per period.            */
+  {    1, 72000000, 1024 },   /* STM32 TIM, 70.3125 counts per period.        */
+  {    7,    32768,    1 },   /* 32 kHz crystal, 229.376 counts per period.   */
+  {  333, 48000000,  128 },   /* 124875 counts per period, exact.             */
+  { 1000, 20971520,  100 },   /* 209715.2 counts per period.                  */
+  {    3,     1000,    3 },   /* Exactly one count per period.                */
+};
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  period = (myPeriod_t) { 0 };
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief A period that is a whole amount of counts should always be returned
+ *          as-is.
+ */
+void test_IfPeriodIsWholeThenItIsAlwaysReturned(void)
+{
+  uint32_t idx;
+
+  myPeriod_Init(&period, 1000, 10);
+
+  for(idx = 0; idx < 1000; idx++) { TEST_ASSERT_EQUAL(100, myPeriod_Next(&period)); }
+}
+
+/**
+ * @brief A period with a half count should alternate between its floor and
+ *          ceil.
+ */
+void test_IfPeriodHasHalfCountThenItAlternates(void)
+{
+  myPeriod_Init(&period, 125, 2);
+
+  TEST_ASSERT_EQUAL(62, myPeriod_GetWhole(&period));
+  TEST_ASSERT_EQUAL(62, myPeriod_Next(&period));
+  TEST_ASSERT_EQUAL(63, myPeriod_Next(&period));
+  TEST_ASSERT_EQUAL(62, myPeriod_Next(&period));
+  TEST_ASSERT_EQUAL(63, myPeriod_Next(&period));
+}
+
+/**
+ * @brief Over millions of periods, the sum of all the returned counts should
+ *          never be more than one count away from the ideal time, meaning
+ *          that there is no cumulative drift at all.
+ */
+void test_LongRunsHaveNoCumulativeDrift(void)
+{
+  uint32_t idx, n;
+
+  for(idx = 0; idx < MY_ARRAY_SIZE(testPeriods); idx++)
+  {
+    const testPeriod_t * const test = &testPeriods[idx];
+    const uint64_t num = (uint64_t) test->periodMs * test->clockHz;
+    const uint64_t den = 1000ULL * test->prescaler;
+    uint64_t sum = 0;
+
+    initPeriod(test);
+
+    for(n = 1; n <= TEST_LONG_RUN_PERIODS; n++)
+    {
+      const uint32_t counts = myPeriod_Next(&period);
+
+      TEST_ASSERT_TRUE((counts == (num / den)) || (counts == ((num / den) + 1)));
+      sum += counts;
+
+      /* The sum is the ideal amount of counts, rounded down.                 */
+      if(sum != ((n * num) / den)) { TEST_FAIL_MESSAGE("Drift detected"); }
+    }
+  }
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static void initPeriod(const testPeriod_t * test)
+{
+  myPeriod_Init(&period, (uint64_t) test->periodMs * test->clockHz, 1000 * test->prescaler);
+}
@@ -0,0 +1,209 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file test_myPeriod_Scale.c
+ * @brief Test file for testing period accumulator logic, operation when the
+ *          period is set up from a cached scale or prescaled, instead of
+ *          being divided.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+#include "myMacros.h"
+
+#include "myPeriod.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_RANDOM_CASES                                              (2000000)
+#define TEST_PERIODS_PER_CASE                                               (16)
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static void checkScaled(uint32_t mul, uint32_t den, uint32_t units);
+static uint32_t nextRandom(void);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static uint32_t randomState;
+
+/* Scales met by the drivers: timer clock in Hz over 1000 ms times prescaler. */
+static const uint32_t testScales[][2] =
+{
+  {  8000000, 1000 *  128 },
+  { 20971520, 1000 *  128 },
+  { 48000000, 1000 *  128 },
+  { 36000000, 1000 * 1024 },
+  { 72000000, 1000 * 1024 },
+  {    32768, 1000 *    1 },
+  {        1, 0x7FFFFFFF  },
+  { 0xFFFFFFFF, 0x7FFFFFFF },
+  { 0xFFFFFFFF, 1         },
+};
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  randomState = 0x12345678;
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief A scale built at compile time should be the same as one built at
+ *          run time.
+ */
+void test_ConstantScaleIsTheSameAsRuntimeOne(void)
+{
+  const myPeriodScale_t constant = MY_PERIOD_SCALE(48000000, 1000 * 128);
+  myPeriodScale_t runtime;
+
+  myPeriod_InitScale(&runtime, 48000000, 1000 * 128);
+
+  TEST_ASSERT_EQUAL_MEMORY(&constant, &runtime, sizeof(runtime));
+}
+
+/**
+ * @brief Periods from the driver's scales should be bit-exact with the ones
+ *          set up by dividing, for every period up to a minute.
+ */
+void test_DriverScalesAreBitExact(void)
+{
+  uint32_t idx, units;
+
+  for(idx = 0; idx < MY_ARRAY_SIZE(testScales); idx++)
+  {
+    const uint64_t maxUnits = ((uint64_t)testScales[idx][1] << 32) / testScales[idx][0];
+    const uint32_t lastUnits = (maxUnits < 60000) ? (uint32_t)maxUnits : 60000;
+
+    for(units = 0; units < lastUnits; units++)
+    {
+      checkScaled(testScales[idx][0], testScales[idx][1], units);
+    }
+  }
+}
+
+/**
+ * @brief Periods right below the 32 bits limit of the whole part should still
+ *          be bit-exact.
+ */
+void test_LargestPeriodsAreBitExact(void)
+{
+  uint32_t idx, back;
+
+  for(idx = 0; idx < MY_ARRAY_SIZE(testScales); idx++)
+  {
+    uint64_t maxUnits = (((uint64_t)testScales[idx][1] << 32) - 1) / testScales[idx][0];
+
+    if(maxUnits > 0xFFFFFFFF) { maxUnits = 0xFFFFFFFF; }
+    for(back = 0; (back < 1000) && (back <= maxUnits); back++)
+    {
+      checkScaled(testScales[idx][0], testScales[idx][1], (uint32_t)(maxUnits - back));
+    }
+  }
+}
+
+/**
+ * @brief Periods from random scales should be bit-exact with the ones set up
+ *          by dividing.
+ */
+void test_RandomScalesAreBitExact(void)
+{
+  uint32_t n;
+
+  for(n = 0; n < TEST_RANDOM_CASES; n++)
+  {
+    const uint32_t mul = nextRandom() >> (nextRandom() & 31);
+    const uint32_t den = (nextRandom() >> (1 + (nextRandom() & 31))) | 1;
+    uint64_t maxUnits = (((uint64_t)den << 32) - 1) / ((mul != 0) ? mul : 1);
+
+    if(maxUnits > 0xFFFFFFFF) { maxUnits = 0xFFFFFFFF; }
+    checkScaled(mul, den, (uint32_t)(nextRandom() % (maxUnits + 1)));
+  }
+}
+
+/**
+ * @brief A prescaled period should be bit-exact with the one set up with a
+ *          denominator that many times larger.
+ */
+void test_PrescaledPeriodsAreBitExact(void)
+{
+  uint32_t n, shift;
+
+  for(n = 0; n < TEST_RANDOM_CASES / 8; n++)
+  {
+    const uint64_t num = ((uint64_t)nextRandom() << 16) | (nextRandom() & 0xFFFF);
+    const uint32_t den = (nextRandom() >> (8 + (nextRandom() & 15))) | 1;
+
+    for(shift = 0; (den << shift) < 0x80000000UL; shift++)
+    {
+      myPeriod_t expected, prescaled;
+
+      if((num / den) > 0xFFFFFFFFULL) { break; }
+
+      myPeriod_Init(&expected, num, den << shift);
+      myPeriod_Init(&prescaled, num, den);
+      myPeriod_Prescale(&prescaled, shift);
+
+      TEST_ASSERT_EQUAL_MEMORY(&expected, &prescaled, sizeof(prescaled));
+    }
+  }
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static void checkScaled(uint32_t mul, uint32_t den, uint32_t units)
+{
+  myPeriodScale_t scale;
+  myPeriod_t expected, scaled;
+  uint32_t n;
+
+  myPeriod_InitScale(&scale, mul, den);
+  myPeriod_Init(&expected, (uint64_t)units * mul, den);
+  myPeriod_InitScaled(&scaled, &scale, units);
+
+  TEST_ASSERT_EQUAL_MEMORY(&expected, &scaled, sizeof(scaled));
+
+  for(n = 0; n < TEST_PERIODS_PER_CASE; n++)
+  {
+    TEST_ASSERT_EQUAL_UINT32(myPeriod_Next(&expected), myPeriod_Next(&scaled));
+  }
+}
+
+static uint32_t nextRandom(void)
+{
+  /* Xorshift, so that the cases are the same on every run.                   */
+  randomState ^= randomState << 13;
+  randomState ^= randomState >> 17;
+  randomState ^= randomState << 5;
+  return randomState;
+}
@@ -0,0 +1,135 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file test_myRing_Batch.c
+ * @brief Test file for testing ring buffer logic, operation when items are
+ *          popped in batches.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+
+#include "myRing.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_RING_SIZE                                                       (8)
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static void pushItems(uint32_t first, uint32_t count);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static myRing_t ring;
+static uint32_t storage[TEST_RING_SIZE];
+static uint32_t batch[TEST_RING_SIZE + 1];
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  uint32_t idx;
+
+  myRing_Init(&ring, storage, sizeof(uint32_t), TEST_RING_SIZE);
+  for(idx = 0; idx < (TEST_RING_SIZE + 1); idx++) { batch[idx] = UINT32_MAX; }
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief Nothing can be popped from an empty ring, and nothing should be
+ *          written then.
+ */
+void test_IfRingIsEmptyThenNothingIsPopped(void)
+{
+  TEST_ASSERT_EQUAL(0, myRing_PopMany(&ring, batch, TEST_RING_SIZE));
+  TEST_ASSERT_EQUAL_HEX32(UINT32_MAX, batch[0]);
+}
+
+/**
+ * @brief A batch should take no more items than asked for, in order, and
+ *          leave the rest in the ring.
+ */
+void test_IfLimitIsLowerThanCountThenOnlyLimitIsPopped(void)
+{
+  pushItems(0, 5);
+
+  TEST_ASSERT_EQUAL(3, myRing_PopMany(&ring, batch, 3));
+  TEST_ASSERT_EQUAL(0, batch[0]);
+  TEST_ASSERT_EQUAL(2, batch[2]);
+  TEST_ASSERT_EQUAL_HEX32(UINT32_MAX, batch[3]);
+  TEST_ASSERT_EQUAL(2, myRing_GetCount(&ring));
+}
+
+/**
+ * @brief A batch should take all the items there are, up to the limit.
+ */
+void test_IfLimitIsHigherThanCountThenAllArePopped(void)
+{
+  pushItems(0, TEST_RING_SIZE);
+
+  TEST_ASSERT_EQUAL(TEST_RING_SIZE, myRing_PopMany(&ring, batch, TEST_RING_SIZE + 1));
+  TEST_ASSERT_EQUAL(TEST_RING_SIZE - 1, batch[TEST_RING_SIZE - 1]);
+  TEST_ASSERT_EQUAL_HEX32(UINT32_MAX, batch[TEST_RING_SIZE]);
+  TEST_ASSERT_EQUAL(0, myRing_GetCount(&ring));
+}
+
+/**
+ * @brief Items that wrap around the end of the storage should still come out
+ *          in order, and the slots they free should be usable again.
+ */
+void test_IfItemsWrapAroundStorageThenTheyArePoppedInOrder(void)
+{
+  uint32_t idx;
+
+  pushItems(0, 6);
+  myRing_PopMany(&ring, batch, 6);
+  pushItems(6, TEST_RING_SIZE);
+
+  TEST_ASSERT_EQUAL(TEST_RING_SIZE, myRing_PopMany(&ring, batch, TEST_RING_SIZE));
+  for(idx = 0; idx < TEST_RING_SIZE; idx++) { TEST_ASSERT_EQUAL(6 + idx, batch[idx]); }
+
+  pushItems(0, TEST_RING_SIZE);
+  TEST_ASSERT_EQUAL(TEST_RING_SIZE, myRing_GetCount(&ring));
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static void pushItems(uint32_t first, uint32_t count)
+{
+  uint32_t idx;
+
+  for(idx = first; idx < (first + count); idx++)
+  {
+    TEST_ASSERT_EQUAL(myRet_OK, myRing_Push(&ring, &idx));
+  }
+}
@@ -0,0 +1,200 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test_myRing_Push.c
+ * @brief Test file for testing ring buffer logic, operation when items are
+ *          pushed and popped.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+
+#include "myRing.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_RING_SIZE                                                       (8)
+
+/* Items are larger than a word, to check that they are copied as a whole.    */
+typedef struct
+{
+  uint32_t seq;
+  uint8_t data[5];
+} testItem_t;
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static testItem_t makeItem(uint32_t seq);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static myRing_t ring;
+static testItem_t storage[TEST_RING_SIZE];
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  myRing_Init(&ring, storage, sizeof(testItem_t), TEST_RING_SIZE);
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief The ring takes any power of two as its size, and nothing else, so
+ *          that wrapping around is just a mask.
+ */
+void test_IfSizeIsNotPowerOfTwoThenInitFails(void)
+{
+  TEST_ASSERT_EQUAL(myRet_OK, myRing_Init(&ring, storage, sizeof(testItem_t), 1));
+  TEST_ASSERT_EQUAL(myRet_OK, myRing_Init(&ring, storage, sizeof(testItem_t), 4));
+  TEST_ASSERT_EQUAL(myRet_Fail, myRing_Init(&ring, storage, sizeof(testItem_t), 0));
+  TEST_ASSERT_EQUAL(myRet_Fail, myRing_Init(&ring, storage, sizeof(testItem_t), 6));
+  TEST_ASSERT_EQUAL(myRet_Fail, myRing_Init(&ring, storage, 0, 4));
+  TEST_ASSERT_EQUAL(myRet_Fail, myRing_Init(&ring, NULL, sizeof(testItem_t), 4));
+}
+
+/**
+ * @brief A new ring is empty, so nothing can be popped from it.
+ */
+void test_IfRingIsEmptyThenPopFails(void)
+{
+  testItem_t item;
+
+  TEST_ASSERT_EQUAL(0, myRing_GetCount(&ring));
+  TEST_ASSERT_EQUAL(myRet_Fail, myRing_Pop(&ring, &item));
+}
+
+/**
+ * @brief Items should come out whole and in the same order they went in.
+ */
+void test_IfItemsArePushedThenTheyArePoppedInOrder(void)
+{
+  testItem_t item, expected;
+  uint32_t idx;
+
+  for(idx = 0; idx < TEST_RING_SIZE; idx++)
+  {
+    item = makeItem(idx);
+    TEST_ASSERT_EQUAL(myRet_OK, myRing_Push(&ring, &item));
+  }
+  TEST_ASSERT_EQUAL(TEST_RING_SIZE, myRing_GetCount(&ring));
+
+  for(idx = 0; idx < TEST_RING_SIZE; idx++)
+  {
+    expected = makeItem(idx);
+    TEST_ASSERT_EQUAL(myRet_OK, myRing_Pop(&ring, &item));
+    TEST_ASSERT_EQUAL_MEMORY(&expected, &item, sizeof(testItem_t));
+  }
+  TEST_ASSERT_EQUAL(0, myRing_GetCount(&ring));
+}
+
+/**
+ * @brief A full ring should refuse new items, and keep the ones it has.
+ */
+void test_IfRingIsFullThenPushFails(void)
+{
+  testItem_t item;
+  uint32_t idx;
+
+  for(idx = 0; idx < TEST_RING_SIZE; idx++)
+  {
+    item = makeItem(idx);
+    myRing_Push(&ring, &item);
+  }
+  item = makeItem(TEST_RING_SIZE);
+  TEST_ASSERT_EQUAL(myRet_Fail, myRing_Push(&ring, &item));
+  TEST_ASSERT_EQUAL(TEST_RING_SIZE, myRing_GetCount(&ring));
+
+  myRing_Pop(&ring, &item);
+  TEST_ASSERT_EQUAL(0, item.seq);
+  item = makeItem(TEST_RING_SIZE);
+  TEST_ASSERT_EQUAL(myRet_OK, myRing_Push(&ring, &item));
+}
+
+/**
+ * @brief The free room should be whatever the items in the ring leave, also
+ *          once the indexes wrap around.
+ */
+void test_FreeRoomIsWhatTheItemsLeave(void)
+{
+  testItem_t item = makeItem(0);
+
+  TEST_ASSERT_EQUAL(TEST_RING_SIZE, myRing_GetFree(&ring));
+
+  myRing_Push(&ring, &item);
+  TEST_ASSERT_EQUAL(TEST_RING_SIZE - 1, myRing_GetFree(&ring));
+
+  ring.head = UINT32_MAX;
+  ring.tail = UINT32_MAX - 2;
+  TEST_ASSERT_EQUAL(TEST_RING_SIZE - 2, myRing_GetFree(&ring));
+
+  ring.head = ring.tail + TEST_RING_SIZE;
+  TEST_ASSERT_EQUAL(0, myRing_GetFree(&ring));
+}
+
+/**
+ * @brief The indexes run freely and wrap around at 2^32, which should not be
+ *          noticed from outside.
+ */
+void test_IfIndexesWrapAroundThenItemsAreKept(void)
+{
+  testItem_t item;
+  uint32_t idx;
+
+  ring.head = UINT32_MAX - 2;
+  ring.tail = UINT32_MAX - 2;
+  for(idx = 0; idx < TEST_RING_SIZE; idx++)
+  {
+    item = makeItem(idx);
+    TEST_ASSERT_EQUAL(myRet_OK, myRing_Push(&ring, &item));
+  }
+  TEST_ASSERT_EQUAL(TEST_RING_SIZE, myRing_GetCount(&ring));
+  TEST_ASSERT_EQUAL(myRet_Fail, myRing_Push(&ring, &item));
+
+  for(idx = 0; idx < TEST_RING_SIZE; idx++)
+  {
+    TEST_ASSERT_EQUAL(myRet_OK, myRing_Pop(&ring, &item));
+    TEST_ASSERT_EQUAL(idx, item.seq);
+  }
+  TEST_ASSERT_EQUAL(myRet_Fail, myRing_Pop(&ring, &item));
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static testItem_t makeItem(uint32_t seq)
+{
+  testItem_t item = { .seq = seq };
+  uint32_t idx;
+
+  for(idx = 0; idx < sizeof(item.data); idx++) { item.data[idx] = (uint8_t)(seq + idx); }
+
+  return item;
+}
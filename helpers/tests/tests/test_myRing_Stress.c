@@ -0,0 +1,126 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test_myRing_Stress.c
+ * @brief Test file for testing ring buffer logic, operation when a producer
+ *          and a consumer run at the same time, each on its own thread.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+
+#include "myRing.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+/* A small ring keeps it wrapping around and hitting full and empty often.    */
+/*  Each side yields whenever it finds the ring so, since the host may have   */
+/*  a single core to run both threads.                                        */
+#define TEST_RING_SIZE                                                      (64)
+#define TEST_ITEMS                                                     (2000000)
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static void * producer(void * arg);
+static uint64_t nowUs(void);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static myRing_t ring;
+static uint32_t storage[TEST_RING_SIZE];
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  myRing_Init(&ring, storage, sizeof(uint32_t), TEST_RING_SIZE);
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief With the producer and the consumer racing each other, every item
+ *          should get through, once and in order. It also measures how many
+ *          items per second get through on the host, which only gives a
+ *          rough idea of the cost on target, so the result is just printed.
+ */
+void test_IfBothSidesRunConcurrentlyThenEveryItemGetsThroughInOrder(void)
+{
+  pthread_t thread;
+  uint32_t item, expected = 0, outOfOrder = 0;
+  uint64_t start, elapsedUs;
+
+  start = nowUs();
+  TEST_ASSERT_EQUAL(0, pthread_create(&thread, NULL, producer, NULL));
+  while(expected < TEST_ITEMS)
+  {
+    if(myRing_Pop(&ring, &item) == myRet_OK)
+    {
+      if(item != expected) { outOfOrder++; }
+      expected++;
+    }
+    else { sched_yield(); }
+  }
+  pthread_join(thread, NULL);
+  elapsedUs = nowUs() - start;
+
+  printf("myRing: %.2f M items/s\n", (double)TEST_ITEMS / (double)elapsedUs);
+  TEST_ASSERT_EQUAL(0, outOfOrder);
+  TEST_ASSERT_EQUAL(0, myRing_GetCount(&ring));
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static void * producer(void * arg)
+{
+  uint32_t item = 0;
+
+  (void) arg;
+  while(item < TEST_ITEMS)
+  {
+    if(myRing_Push(&ring, &item) == myRet_OK) { item++; }
+    else { sched_yield(); }
+  }
+
+  return NULL;
+}
+
+static uint64_t nowUs(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return ((uint64_t) now.tv_sec * 1000000) + ((uint64_t) now.tv_nsec / 1000);
+}
@@ -0,0 +1,165 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file test_mySplit.c
+ * @brief Test file for testing period splitter logic, operation when periods
+ *          are split into segments that fit a counter.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+#include "myMacros.h"
+
+#include "mySplit.h"
+#include "myPeriod.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_MAX_COUNTS                                                (0x10000)
+#define TEST_PERIODS_PER_CASE                                               (16)
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static void checkSplit(uint64_t num, uint32_t den);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static mySplit_t split;
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  mySplit_Init(&split, TEST_MAX_COUNTS);
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief A period that fits the counter should not be split, so each of its
+ *          segments should end a period.
+ */
+void test_IfPeriodFitsThenEachSegmentIsAPeriod(void)
+{
+  myPeriod_t period;
+  uint32_t n;
+
+  myPeriod_Init(&period, 1000, 3);
+
+  for(n = 0; n < 10; n++)
+  {
+    const uint32_t counts = mySplit_Next(&split, &period);
+
+    TEST_ASSERT_TRUE((counts == 333) || (counts == 334));
+    TEST_ASSERT_FALSE(mySplit_IsPending(&split));
+    TEST_ASSERT_TRUE(mySplit_Expired(&split));
+  }
+}
+
+/**
+ * @brief A period that doesn't fit the counter should be split, and only its
+ *          last segment should end it.
+ */
+void test_IfPeriodDoesNotFitThenItIsSplit(void)
+{
+  myPeriod_t period;
+
+  myPeriod_Init(&period, 3 * TEST_MAX_COUNTS + 10, 1);
+
+  TEST_ASSERT_EQUAL(TEST_MAX_COUNTS, mySplit_Next(&split, &period));
+  TEST_ASSERT_TRUE(mySplit_IsPending(&split));
+  TEST_ASSERT_EQUAL(TEST_MAX_COUNTS, mySplit_Next(&split, &period));
+  TEST_ASSERT_EQUAL((TEST_MAX_COUNTS + 10) / 2, mySplit_Next(&split, &period));
+  TEST_ASSERT_EQUAL((TEST_MAX_COUNTS + 10) / 2, mySplit_Next(&split, &period));
+  TEST_ASSERT_FALSE(mySplit_IsPending(&split));
+
+  TEST_ASSERT_FALSE(mySplit_Expired(&split));
+  TEST_ASSERT_FALSE(mySplit_Expired(&split));
+  TEST_ASSERT_FALSE(mySplit_Expired(&split));
+  TEST_ASSERT_TRUE(mySplit_Expired(&split));
+}
+
+/**
+ * @brief Sweeping periods from a single count up to the 32 bits limit, the
+ *          segments should always fit the counter, never be shorter than half
+ *          of it unless the period is, and add up to each period exactly.
+ */
+void test_SweepOfPeriodsIsSplitExactly(void)
+{
+  uint64_t num;
+
+  for(num = 1; num < (0xFFFFFFFFULL * 7); num = (num * 9 / 8) + 1)
+  {
+    checkSplit(num, 7);
+  }
+
+  for(num = TEST_MAX_COUNTS - 2; num < (TEST_MAX_COUNTS + 2); num++)
+  {
+    checkSplit(num, 1);
+    checkSplit(2 * num, 1);
+  }
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static void checkSplit(uint64_t num, uint32_t den)
+{
+  myPeriod_t period, expected;
+  uint32_t queue[2];
+  uint32_t n;
+
+  myPeriod_Init(&period, num, den);
+  myPeriod_Init(&expected, num, den);
+  mySplit_Init(&split, TEST_MAX_COUNTS);
+
+  /* As on a counter with a buffered period, one segment runs while the next */
+  /*  one is queued.                                                          */
+  queue[1] = mySplit_Next(&split, &period);
+  for(n = 0; n < TEST_PERIODS_PER_CASE; n++)
+  {
+    const uint32_t periodCounts = myPeriod_Next(&expected);
+    uint64_t sum = 0;
+    bool ended = false;
+
+    while(!ended)
+    {
+      queue[0] = queue[1];
+      queue[1] = mySplit_Next(&split, &period);
+      ended = mySplit_Expired(&split);
+
+      TEST_ASSERT_TRUE(queue[0] <= TEST_MAX_COUNTS);
+      TEST_ASSERT_TRUE((queue[0] >= TEST_MAX_COUNTS / 2) || (periodCounts <= TEST_MAX_COUNTS));
+      sum += queue[0];
+    }
+
+    TEST_ASSERT_EQUAL_UINT64(periodCounts, sum);
+  }
+}
@@ -0,0 +1,185 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file test_myWheel_Benchmark.c
+ * @brief Test file for checking that the work done by the timing wheel on
+ *          each tick does not grow with the amount of running timers.
+ *
+ * The work is measured by the amount of timer visits, which is deterministic,
+ *  and the host time per tick is printed for reference only, side by side with
+ *  a naive timer list that checks every timer on every tick.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "unity.h"
+#include "myTestDefs.h"
+#include "myMacros.h"
+
+#include "myWheel.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_MAX_TIMERS                                                    (512)
+#define TEST_TICKS                                                      (100000)
+#define TEST_MAX_PERIOD                                                   (1000)
+#define TEST_RANDOM_SEED                                                  (4321)
+
+/* A timer is visited once when it expires, plus once for each level it gets  */
+/*  cascaded through. With the default wheel (4 levels) and periods that fit  */
+/*  on the second level, this means at most 2 visits per expiration.          */
+#define TEST_MAX_VISITS_PER_EXPIRY                                           (2)
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static void startTimers(uint32_t amount);
+static uint64_t getTimeNs(void);
+static void timerCallback(void);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static myWheelNode_t nodes[TEST_MAX_TIMERS];
+static uint32_t periods[TEST_MAX_TIMERS];
+static uint32_t callbackCallCount;
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  uint32_t idx;
+
+  myWheel_Reset();
+  for(idx = 0; idx < TEST_MAX_TIMERS; idx++) { nodes[idx] = (myWheelNode_t) { 0 }; }
+  callbackCallCount = 0;
+  srand(TEST_RANDOM_SEED);
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief The work per expiration should stay bounded, whatever the amount of
+ *          running timers is.
+ */
+void test_WorkPerExpirationDoesNotDependOnTimerAmount(void)
+{
+  const uint32_t amounts[] = { 8, 64, TEST_MAX_TIMERS };
+  uint32_t idx, tick;
+
+  for(idx = 0; idx < MY_ARRAY_SIZE(amounts); idx++)
+  {
+    uint64_t wheelNs, naiveNs;
+    uint32_t naiveCount = 0;
+    uint32_t naiveExpiry[TEST_MAX_TIMERS];
+    uint32_t timer;
+
+    setUp();
+    startTimers(amounts[idx]);
+
+    wheelNs = getTimeNs();
+    for(tick = 0; tick < TEST_TICKS; tick++) { myWheel_Tick(); }
+    wheelNs = getTimeNs() - wheelNs;
+
+    TEST_ASSERT_TRUE(callbackCallCount >= amounts[idx] * (TEST_TICKS / TEST_MAX_PERIOD));
+    TEST_ASSERT_TRUE(myWheel_GetVisits() <= (callbackCallCount * TEST_MAX_VISITS_PER_EXPIRY));
+
+    /* Same timers, but every one of them is checked on every tick.           */
+    for(timer = 0; timer < amounts[idx]; timer++) { naiveExpiry[timer] = periods[timer]; }
+    naiveNs = getTimeNs();
+    for(tick = 1; tick <= TEST_TICKS; tick++)
+    {
+      for(timer = 0; timer < amounts[idx]; timer++)
+      {
+        if(naiveExpiry[timer] == tick)
+        {
+          naiveExpiry[timer] += periods[timer];
+          naiveCount++;
+        }
+      }
+    }
+    naiveNs = getTimeNs() - naiveNs;
+
+    TEST_ASSERT_EQUAL(naiveCount, callbackCallCount);
+
+    printf("%4u timers: %7u expirations, %.2f visits/expiration, "
+           "wheel %6.1f ns/tick, naive %6.1f ns/tick\n",
+           (unsigned) amounts[idx], (unsigned) callbackCallCount,
+           (double) myWheel_GetVisits() / callbackCallCount,
+           (double) wheelNs / TEST_TICKS, (double) naiveNs / TEST_TICKS);
+  }
+}
+
+/**
+ * @brief Ticks on which no timer expires nor cascades should not visit any
+ *          timer at all.
+ */
+void test_IdleTicksDoNotVisitAnyTimer(void)
+{
+  uint32_t idx;
+
+  /* All timers sit on the same far away slot of the upper levels.            */
+  for(idx = 0; idx < TEST_MAX_TIMERS; idx++)
+  {
+    myWheel_Start(&nodes[idx], 1000000, 0, timerCallback);
+  }
+
+  for(idx = 0; idx < TEST_TICKS; idx++) { myWheel_Tick(); }
+
+  TEST_ASSERT_EQUAL(0, myWheel_GetVisits());
+  TEST_ASSERT_EQUAL(0, callbackCallCount);
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static void startTimers(uint32_t amount)
+{
+  uint32_t idx;
+
+  for(idx = 0; idx < amount; idx++)
+  {
+    periods[idx] = 1 + ((uint32_t)rand() % TEST_MAX_PERIOD);
+    myWheel_Start(&nodes[idx], periods[idx], periods[idx], timerCallback);
+  }
+}
+
+static uint64_t getTimeNs(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return ((uint64_t) now.tv_sec * 1000000000ULL) + (uint64_t) now.tv_nsec;
+}
+
+static void timerCallback(void)
+{
+  callbackCallCount++;
+}
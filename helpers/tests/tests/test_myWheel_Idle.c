@@ -0,0 +1,195 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file test_myWheel_Idle.c
+ * @brief Test file for testing timing wheel logic, finding the next tick
+ *          with work to do and skipping the idle ticks before it.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity.h"
+#include "myTestDefs.h"
+
+#include "myWheel.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_TIMER_AMOUNT                                                   (16)
+#define TEST_EXPIRATIONS                                                  (2000)
+#define TEST_RANDOM_SEED                                                  (4321)
+
+/* Expiration times that fall on each of the wheel levels and beyond them.    */
+#define TEST_SHORT_TICKS                                                    (10)
+#define TEST_MEDIUM_TICKS                                                 (1000)
+#define TEST_HUGE_TICKS                                               (20000000)
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static void startRandomTimers(void);
+static uint32_t randomTicks(void);
+static void timerCallback(void);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static myWheelNode_t nodes[TEST_TIMER_AMOUNT];
+static uint32_t expirations[TEST_EXPIRATIONS];
+static uint32_t callbackCallCount;
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  uint32_t idx;
+
+  myWheel_Reset();
+  for(idx = 0; idx < TEST_TIMER_AMOUNT; idx++) { nodes[idx] = (myWheelNode_t) { 0 }; }
+  callbackCallCount = 0;
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief With no timer running, there should be no next event.
+ */
+void test_IfNoTimerIsRunningThenThereIsNoNextEvent(void)
+{
+  TEST_ASSERT_EQUAL_HEX32(MY_WHEEL_NO_EVENT, myWheel_GetNextEvent());
+}
+
+/**
+ * @brief A timer on level zero should be the next event at its expiration.
+ */
+void test_NextEventIsTheExpirationOfANearTimer(void)
+{
+  myWheel_Start(&nodes[0], TEST_SHORT_TICKS, 0, timerCallback);
+
+  TEST_ASSERT_EQUAL(TEST_SHORT_TICKS, myWheel_GetNextEvent());
+}
+
+/**
+ * @brief A timer on an upper level should make its cascade the next event,
+ *          which is never later than its expiration.
+ */
+void test_NextEventIsTheCascadeOfAFarTimer(void)
+{
+  uint32_t event;
+
+  myWheel_Start(&nodes[0], TEST_MEDIUM_TICKS, 0, timerCallback);
+  event = myWheel_GetNextEvent();
+
+  TEST_ASSERT_TRUE(event <= TEST_MEDIUM_TICKS);
+  TEST_ASSERT_TRUE(event > TEST_MEDIUM_TICKS - 64);
+}
+
+/**
+ * @brief The closest of several timers should be the next event.
+ */
+void test_NextEventIsTheClosestOfAllTimers(void)
+{
+  myWheel_Start(&nodes[0], TEST_HUGE_TICKS, 0, timerCallback);
+  myWheel_Start(&nodes[1], TEST_MEDIUM_TICKS, 0, timerCallback);
+  myWheel_Start(&nodes[2], TEST_SHORT_TICKS, 0, timerCallback);
+
+  TEST_ASSERT_EQUAL(TEST_SHORT_TICKS, myWheel_GetNextEvent());
+}
+
+/**
+ * @brief Skipping ticks should advance the tick count without expiring
+ *          anything.
+ */
+void test_SkippedTicksAreCountedButNotProcessed(void)
+{
+  myWheel_Start(&nodes[0], TEST_SHORT_TICKS, 0, timerCallback);
+  myWheel_Skip(TEST_SHORT_TICKS - 1);
+
+  TEST_ASSERT_EQUAL(TEST_SHORT_TICKS - 1, myWheel_GetTicks());
+  TEST_ASSERT_EQUAL(0, callbackCallCount);
+  TEST_ASSERT_EQUAL(1, myWheel_GetNextEvent());
+}
+
+/**
+ * @brief Jumping from event to event should expire the timers at exactly the
+ *          same ticks as ticking the wheel on every single tick.
+ */
+void test_SkippingToEventsIsTheSameAsTickingEveryTick(void)
+{
+  uint32_t reference[TEST_EXPIRATIONS];
+  uint32_t event;
+
+  srand(TEST_RANDOM_SEED);
+  startRandomTimers();
+  while(callbackCallCount < TEST_EXPIRATIONS) { myWheel_Tick(); }
+  memcpy(reference, expirations, sizeof(reference));
+
+  setUp();
+  srand(TEST_RANDOM_SEED);
+  startRandomTimers();
+  while(callbackCallCount < TEST_EXPIRATIONS)
+  {
+    event = myWheel_GetNextEvent();
+    TEST_ASSERT_NOT_EQUAL(MY_WHEEL_NO_EVENT, event);
+
+    myWheel_Skip(event - 1);
+    myWheel_Tick();
+  }
+
+  TEST_ASSERT_EQUAL_UINT32_ARRAY(reference, expirations, TEST_EXPIRATIONS);
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static void startRandomTimers(void)
+{
+  uint32_t idx;
+
+  for(idx = 0; idx < TEST_TIMER_AMOUNT; idx++)
+  {
+    const uint32_t ticks = randomTicks();
+
+    myWheel_Start(&nodes[idx], ticks, ((idx % 4) != 0) ? ticks : 0, timerCallback);
+  }
+}
+
+static uint32_t randomTicks(void)
+{
+  /* Mostly short and medium timers, with a few that go over the whole wheel. */
+  static const uint32_t ranges[] = { TEST_SHORT_TICKS * 10, TEST_MEDIUM_TICKS * 100, TEST_HUGE_TICKS };
+
+  return 1 + ((uint32_t)rand() % ranges[rand() % 3]);
+}
+
+static void timerCallback(void)
+{
+  if(callbackCallCount < TEST_EXPIRATIONS) { expirations[callbackCallCount] = myWheel_GetTicks(); }
+  callbackCallCount++;
+}
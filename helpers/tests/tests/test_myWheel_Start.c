@@ -0,0 +1,200 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file test_myWheel_Start.c
+ * @brief Test file for testing timing wheel logic, operation when timers
+ *          are started and stopped.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+
+#include "myWheel.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_TICKS                                                          (10)
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static void runTicks(uint32_t ticks);
+static void runUntilExpired(void);
+static void timerCallback(void);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static myWheelNode_t node;
+static uint32_t callbackCallCount;
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  myWheel_Reset();
+  node = (myWheelNode_t) { 0 };
+  callbackCallCount = 0;
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief A timer that was never started should not be reported as running.
+ */
+void test_IfTimerWasNotStartedThenItIsNotRunning(void)
+{
+  TEST_ASSERT_FALSE(myWheel_IsRunning(&node));
+}
+
+/**
+ * @brief Once started, a timer should be reported as running.
+ */
+void test_IfTimerIsStartedThenItIsRunning(void)
+{
+  myWheel_Start(&node, TEST_TICKS, 0, timerCallback);
+
+  TEST_ASSERT_TRUE(myWheel_IsRunning(&node));
+}
+
+/**
+ * @brief A stopped timer should not be reported as running.
+ */
+void test_IfTimerIsStoppedThenItIsNotRunning(void)
+{
+  myWheel_Start(&node, TEST_TICKS, 0, timerCallback);
+  myWheel_Stop(&node);
+
+  TEST_ASSERT_FALSE(myWheel_IsRunning(&node));
+}
+
+/**
+ * @brief A stopped timer should never have its callback called.
+ */
+void test_IfTimerIsStoppedThenCallbackIsNotCalled(void)
+{
+  myWheel_Start(&node, TEST_TICKS, 0, timerCallback);
+  myWheel_Stop(&node);
+  runTicks(2 * TEST_TICKS);
+
+  TEST_ASSERT_EQUAL(0, callbackCallCount);
+}
+
+/**
+ * @brief Stopping a timer that is not running should do nothing.
+ */
+void test_IfTimerIsNotRunningThenStopDoesNothing(void)
+{
+  myWheel_Stop(&node);
+
+  TEST_ASSERT_FALSE(myWheel_IsRunning(&node));
+}
+
+/**
+ * @brief Starting a timer that is already running should reschedule it
+ *          from the current tick instead of adding it twice.
+ */
+void test_IfTimerIsRestartedThenItIsRescheduled(void)
+{
+  myWheel_Start(&node, TEST_TICKS, 0, timerCallback);
+  runTicks(TEST_TICKS - 1);
+  myWheel_Start(&node, TEST_TICKS, 0, timerCallback);
+
+  runTicks(TEST_TICKS - 1);
+  TEST_ASSERT_EQUAL(0, callbackCallCount);
+
+  runTicks(TEST_TICKS);
+  TEST_ASSERT_EQUAL(1, callbackCallCount);
+}
+
+/**
+ * @brief A timer started with zero ticks should expire on the next tick.
+ */
+void test_IfTicksIsZeroThenTimerExpiresOnNextTick(void)
+{
+  myWheel_Start(&node, 0, 0, timerCallback);
+  runTicks(1);
+
+  TEST_ASSERT_EQUAL(1, callbackCallCount);
+}
+
+/**
+ * @brief A timer started with the longest delay should expire right then,
+ *          not on the next tick as if it was already late.
+ */
+void test_IfTicksIsTheMaximumThenTimerExpiresThen(void)
+{
+  myWheel_Start(&node, MY_WHEEL_TICKS_MAX, 0, timerCallback);
+  runTicks(1);
+  TEST_ASSERT_EQUAL(0, callbackCallCount);
+
+  runUntilExpired();
+  TEST_ASSERT_EQUAL(1, callbackCallCount);
+  TEST_ASSERT_EQUAL_HEX32(MY_WHEEL_TICKS_MAX, myWheel_GetTicks());
+}
+
+/**
+ * @brief A timer started beyond the longest delay should be clamped to it.
+ */
+void test_IfTicksIsAboveTheMaximumThenItIsClamped(void)
+{
+  myWheel_Start(&node, UINT32_MAX, 0, timerCallback);
+  runTicks(1);
+  TEST_ASSERT_EQUAL(0, callbackCallCount);
+
+  runUntilExpired();
+  TEST_ASSERT_EQUAL(1, callbackCallCount);
+  TEST_ASSERT_EQUAL_HEX32(MY_WHEEL_TICKS_MAX, myWheel_GetTicks());
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static void runTicks(uint32_t ticks)
+{
+  while(ticks-- > 0) { myWheel_Tick(); }
+}
+
+static void timerCallback(void)
+{
+  callbackCallCount++;
+}
+
+/* Skips the idle ticks between events, as a tickless time base would do.     */
+static void runUntilExpired(void)
+{
+  uint32_t events = 0;
+
+  while((callbackCallCount == 0) && (events++ < 1000))
+  {
+    const uint32_t next = myWheel_GetNextEvent();
+
+    if(next == MY_WHEEL_NO_EVENT) { break; }
+    myWheel_Skip(next - 1);
+    myWheel_Tick();
+  }
+}
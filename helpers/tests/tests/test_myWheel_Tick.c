@@ -0,0 +1,242 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file test_myWheel_Tick.c
+ * @brief Test file for testing timing wheel logic, operation when the wheel
+ *          is ticked and timers expire.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include <stdlib.h>
+
+#include "unity.h"
+#include "myTestDefs.h"
+#include "myMacros.h"
+
+#include "myWheel.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_TIMER_AMOUNT                                                   (32)
+#define TEST_RANDOM_TICKS                                               (200000)
+#define TEST_RANDOM_SEED                                                  (1234)
+
+/* Expiration times that fall on each of the wheel levels and beyond them.    */
+#define TEST_SHORT_TICKS                                                     (5)
+#define TEST_MEDIUM_TICKS                                                  (300)
+#define TEST_LONG_TICKS                                                 (100000)
+#define TEST_HUGE_TICKS                                               (20000000)
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static void runTicks(uint32_t ticks);
+static uint32_t randomTicks(void);
+static void timerCallback(void);
+static void stopOtherCallback(void);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static myWheelNode_t nodes[TEST_TIMER_AMOUNT];
+static uint32_t callbackCallCount;
+static uint32_t lastCallbackTick;
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  uint32_t idx;
+
+  myWheel_Reset();
+  for(idx = 0; idx < TEST_TIMER_AMOUNT; idx++) { nodes[idx] = (myWheelNode_t) { 0 }; }
+  callbackCallCount = 0;
+  lastCallbackTick = 0;
+  srand(TEST_RANDOM_SEED);
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief Each tick should advance the wheel's tick count by one.
+ */
+void test_EachTickAdvancesTickCount(void)
+{
+  runTicks(TEST_MEDIUM_TICKS);
+
+  TEST_ASSERT_EQUAL(TEST_MEDIUM_TICKS, myWheel_GetTicks());
+}
+
+/**
+ * @brief A timer should expire exactly at the requested tick, no matter on
+ *          which level of the wheel it was placed.
+ */
+void test_TimerExpiresExactlyOnItsTick(void)
+{
+  const uint32_t ticks[] = { TEST_SHORT_TICKS, TEST_MEDIUM_TICKS, TEST_LONG_TICKS, TEST_HUGE_TICKS };
+  uint32_t idx;
+
+  for(idx = 0; idx < MY_ARRAY_SIZE(ticks); idx++)
+  {
+    myWheel_Reset();
+    callbackCallCount = 0;
+    myWheel_Start(&nodes[0], ticks[idx], 0, timerCallback);
+
+    runTicks(ticks[idx] - 1);
+    TEST_ASSERT_EQUAL(0, callbackCallCount);
+
+    runTicks(1);
+    TEST_ASSERT_EQUAL(1, callbackCallCount);
+    TEST_ASSERT_EQUAL(ticks[idx], lastCallbackTick);
+  }
+}
+
+/**
+ * @brief A one-shot timer should expire only once and then stop.
+ */
+void test_IfPeriodIsZeroThenTimerExpiresOnlyOnce(void)
+{
+  myWheel_Start(&nodes[0], TEST_SHORT_TICKS, 0, timerCallback);
+  runTicks(TEST_LONG_TICKS);
+
+  TEST_ASSERT_EQUAL(1, callbackCallCount);
+  TEST_ASSERT_FALSE(myWheel_IsRunning(&nodes[0]));
+}
+
+/**
+ * @brief A periodic timer should keep expiring on multiples of its period,
+ *          without accumulating any drift.
+ */
+void test_IfPeriodIsSetThenTimerExpiresWithoutDrift(void)
+{
+  myWheel_Start(&nodes[0], TEST_MEDIUM_TICKS, TEST_MEDIUM_TICKS, timerCallback);
+  runTicks(TEST_LONG_TICKS * 10);
+
+  TEST_ASSERT_EQUAL((TEST_LONG_TICKS * 10) / TEST_MEDIUM_TICKS, callbackCallCount);
+  TEST_ASSERT_EQUAL(((TEST_LONG_TICKS * 10) / TEST_MEDIUM_TICKS) * TEST_MEDIUM_TICKS, lastCallbackTick);
+  TEST_ASSERT_TRUE(myWheel_IsRunning(&nodes[0]));
+}
+
+/**
+ * @brief A callback should be able to stop a timer that expires on the same
+ *          tick and was not processed yet.
+ */
+void test_IfCallbackStopsOtherTimerThenItIsNotCalled(void)
+{
+  myWheel_Start(&nodes[1], TEST_SHORT_TICKS, 0, timerCallback);
+  myWheel_Start(&nodes[0], TEST_SHORT_TICKS, 0, stopOtherCallback);
+  runTicks(TEST_SHORT_TICKS);
+
+  TEST_ASSERT_EQUAL(0, callbackCallCount);
+  TEST_ASSERT_FALSE(myWheel_IsRunning(&nodes[1]));
+}
+
+/**
+ * @brief Random sequences of starts, stops and ticks should produce the same
+ *          expirations as a brute force reference that checks every timer on
+ *          every tick.
+ */
+void test_RandomOperationMatchesReferenceModel(void)
+{
+  uint32_t refExpiry[TEST_TIMER_AMOUNT];
+  uint32_t refPeriod[TEST_TIMER_AMOUNT];
+  bool refRunning[TEST_TIMER_AMOUNT] = { false };
+  uint32_t refCount = 0;
+  uint32_t tick, idx;
+
+  for(tick = 0; tick < TEST_RANDOM_TICKS; tick++)
+  {
+    /* Once in a while, start or stop a random timer.                         */
+    if((rand() % 16) == 0)
+    {
+      idx = (uint32_t)rand() % TEST_TIMER_AMOUNT;
+
+      if((rand() % 4) == 0)
+      {
+        myWheel_Stop(&nodes[idx]);
+        refRunning[idx] = false;
+      }
+      else
+      {
+        const uint32_t ticks = randomTicks();
+        const uint32_t period = ((rand() % 2) == 0) ? 0 : (randomTicks() + 1);
+
+        myWheel_Start(&nodes[idx], ticks, period, timerCallback);
+        refExpiry[idx] = myWheel_GetTicks() + ((ticks == 0) ? 1 : ticks);
+        refPeriod[idx] = period;
+        refRunning[idx] = true;
+      }
+    }
+
+    myWheel_Tick();
+
+    for(idx = 0; idx < TEST_TIMER_AMOUNT; idx++)
+    {
+      if(refRunning[idx] && (refExpiry[idx] == myWheel_GetTicks()))
+      {
+        refCount++;
+        refRunning[idx] = (refPeriod[idx] != 0);
+        refExpiry[idx] += refPeriod[idx];
+      }
+
+      TEST_ASSERT_EQUAL(refRunning[idx], myWheel_IsRunning(&nodes[idx]));
+    }
+
+    TEST_ASSERT_EQUAL(refCount, callbackCallCount);
+  }
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static void runTicks(uint32_t ticks)
+{
+  while(ticks-- > 0) { myWheel_Tick(); }
+}
+
+static uint32_t randomTicks(void)
+{
+  /* Mostly short timers, with some that land on the upper levels.            */
+  switch(rand() % 4)
+  {
+    case 0:  return (uint32_t)rand() % 64;
+    case 1:  return (uint32_t)rand() % 4096;
+    case 2:  return (uint32_t)rand() % 50000;
+    default: return (uint32_t)rand() % 200;
+  }
+}
+
+static void timerCallback(void)
+{
+  callbackCallCount++;
+  lastCallbackTick = myWheel_GetTicks();
+}
+
+static void stopOtherCallback(void)
+{
+  myWheel_Stop(&nodes[1]);
+}
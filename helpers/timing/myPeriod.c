@@ -0,0 +1,173 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file myPeriod.c
+ * @brief Source file for the drift-free period accumulator.
+ *
+ * This is the Bresenham line algorithm applied to time: the fractional part
+ *  of the period is accumulated and, each time it adds up to a whole count,
+ *  that count is inserted into the next period.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "myPeriod.h"
+
+#include "myAssert.h"
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES
+ ******************************************************************************/
+/**
+ * @brief Sets up an accumulator for a period of num / den counts.
+ * @param period Accumulator to set up.
+ * @param num Numerator of the period, in counts.
+ * @param den Denominator of the period. Must not be zero and must fit in 31
+ *          bits.
+ */
+void myPeriod_Init(myPeriod_t * period, uint64_t num, uint32_t den)
+{
+  myASSERT(period != NULL);
+  myASSERT((den != 0) && (den < 0x80000000UL));
+  myASSERT((num / den) < 0xFFFFFFFFULL);
+
+  if((period != NULL) && (den != 0))
+  {
+    period->whole = (uint32_t)(num / den);
+    period->rem = (uint32_t)(num % den);
+    period->den = den;
+    period->acc = 0;
+  }
+}
+
+/**
+ * @brief Sets up a scale of mul / den counts per unit. This is where the
+ *          only division takes place, so it should be done once per clock
+ *          configuration instead of once per period.
+ * @param scale Scale to set up.
+ * @param mul Numerator of the scale.
+ * @param den Denominator of the scale. Must not be zero and must fit in 31
+ *          bits.
+ */
+void myPeriod_InitScale(myPeriodScale_t * scale, uint32_t mul, uint32_t den)
+{
+  myASSERT(scale != NULL);
+  myASSERT((den != 0) && (den < 0x80000000UL));
+
+  if((scale != NULL) && (den != 0))
+  {
+    *scale = (myPeriodScale_t) MY_PERIOD_SCALE(mul, den);
+  }
+}
+
+/**
+ * @brief Sets up an accumulator for a period given in units of a scale. The
+ *          result is exactly the same as myPeriod_Init(units * mul, den), but
+ *          it is obtained with multiplications only.
+ * @param period Accumulator to set up.
+ * @param scale Scale from units to counts.
+ * @param units Period, in units of the scale.
+ */
+void myPeriod_InitScaled(myPeriod_t * period, const myPeriodScale_t * scale, uint32_t units)
+{
+  myASSERT((period != NULL) && (scale != NULL));
+
+  if((period != NULL) && (scale != NULL))
+  {
+    const uint64_t num = (uint64_t)units * scale->mul;
+    uint32_t whole;
+    uint64_t rem;
+
+    /* The whole part must fit in 32 bits, which also keeps the product below */
+    /*  from overflowing.                                                     */
+    myASSERT(num < ((uint64_t)scale->den << 32));
+
+    /* The reciprocal is rounded down by less than one, so for units below    */
+    /*  2^32 the estimate falls short of the exact quotient by one at most.   */
+    whole = (uint32_t)(((uint64_t)units * scale->recip) >> 32);
+    rem = num - ((uint64_t)whole * scale->den);
+    if(rem >= scale->den)
+    {
+      rem -= scale->den;
+      whole++;
+    }
+
+    period->whole = whole;
+    period->rem = (uint32_t)rem;
+    period->den = scale->den;
+    period->acc = 0;
+  }
+}
+
+/**
+ * @brief Divides the period by 2^shift, as a power of two prescaler would.
+ *          Nothing is lost, so the result is exactly the same as setting up
+ *          the period with a denominator 2^shift times larger.
+ * @param period Accumulator to divide. It must not have been used yet.
+ * @param shift Power of two to divide by. The resulting denominator must
+ *          still fit in 31 bits.
+ */
+void myPeriod_Prescale(myPeriod_t * period, uint32_t shift)
+{
+  myASSERT(period != NULL);
+  myASSERT((shift < 31) && (period->den < (0x80000000UL >> shift)));
+
+  if(period != NULL)
+  {
+    /* The bits shifted out of the whole part go into the remainder.          */
+    const uint32_t lowBits = period->whole & ((1UL << shift) - 1);
+
+    period->rem += lowBits * period->den;
+    period->whole >>= shift;
+    period->den <<= shift;
+  }
+}
+
+/**
+ * @brief Gets the amount of counts of the next period.
+ * @param period Accumulator to use.
+ * @return Counts of the next period. It is either the whole part of the
+ *          period or one more than that.
+ */
+uint32_t myPeriod_Next(myPeriod_t * period)
+{
+  uint32_t counts = period->whole;
+
+  /* rem < den, so acc never gets to 2 * den and never overflows 32 bits      */
+  /*  as long as den fits in 31 bits.                                         */
+  period->acc += period->rem;
+  if(period->acc >= period->den)
+  {
+    period->acc -= period->den;
+    counts++;
+  }
+
+  return counts;
+}
+
+/**
+ * @brief Gets the whole part of the period, which is the shortest amount of
+ *          counts that myPeriod_Next will ever return.
+ * @param period Accumulator to use.
+ * @return Whole part of the period, in counts.
+ */
+uint32_t myPeriod_GetWhole(myPeriod_t * period)
+{
+  return period->whole;
+}
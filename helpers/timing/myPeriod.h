@@ -0,0 +1,134 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file myPeriod.h
+ * @brief Header file for the drift-free period accumulator.
+ *
+ * A period that is not a whole amount of timer counts can't be programmed
+ *  as-is into a timer, and rounding it on every period makes the error add up
+ *  over time. This module splits such a period into a sequence of whole
+ *  counts, alternating between its floor and ceil, so that the sum of the
+ *  first N periods is always the exact value rounded down.
+ *
+ * Periods can also be given in some unit (ms, for instance) together with a
+ *  scale from that unit to counts. The scale caches a fixed-point reciprocal,
+ *  so setting up a period from it takes no division at all, which matters on
+ *  cores without a hardware divider.
+ */
+
+#ifndef MY_PERIOD_H
+#define MY_PERIOD_H
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "myDefs.h"
+
+/*******************************************************************************
+ *  PUBLIC DEFINITIONS
+ ******************************************************************************/
+/**
+ * @brief Structure that holds the state of a period accumulator. Its fields
+ *          are private and should only be touched through the routines below.
+ */
+typedef struct
+{
+  uint32_t whole;
+  uint32_t rem;
+  uint32_t den;
+  uint32_t acc;
+} myPeriod_t;
+
+/**
+ * @brief Structure that holds a scale of mul / den counts per unit. Its fields
+ *          are private and should only be touched through the routines and
+ *          the macro below.
+ */
+typedef struct
+{
+  uint32_t mul;
+  uint32_t den;
+  uint64_t recip;
+} myPeriodScale_t;
+
+/**
+ * @brief Initializer for a constant scale of MUL / DEN counts per unit. The
+ *          reciprocal is then computed at compile time.
+ */
+#define MY_PERIOD_SCALE(MUL, DEN)  { (MUL), (DEN), (((uint64_t)(MUL) << 32) / (DEN)) }
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES
+ ******************************************************************************/
+/**
+ * @brief Sets up an accumulator for a period of num / den counts.
+ * @param period Accumulator to set up.
+ * @param num Numerator of the period, in counts.
+ * @param den Denominator of the period. Must not be zero and must fit in 31
+ *          bits.
+ */
+void myPeriod_Init(myPeriod_t * period, uint64_t num, uint32_t den);
+
+/**
+ * @brief Sets up a scale of mul / den counts per unit. This is where the
+ *          only division takes place, so it should be done once per clock
+ *          configuration instead of once per period.
+ * @param scale Scale to set up.
+ * @param mul Numerator of the scale.
+ * @param den Denominator of the scale. Must not be zero and must fit in 31
+ *          bits.
+ */
+void myPeriod_InitScale(myPeriodScale_t * scale, uint32_t mul, uint32_t den);
+
+/**
+ * @brief Sets up an accumulator for a period given in units of a scale. The
+ *          result is exactly the same as myPeriod_Init(units * mul, den), but
+ *          it is obtained with multiplications only.
+ * @param period Accumulator to set up.
+ * @param scale Scale from units to counts.
+ * @param units Period, in units of the scale.
+ */
+void myPeriod_InitScaled(myPeriod_t * period, const myPeriodScale_t * scale, uint32_t units);
+
+/**
+ * @brief Divides the period by 2^shift, as a power of two prescaler would.
+ *          Nothing is lost, so the result is exactly the same as setting up
+ *          the period with a denominator 2^shift times larger.
+ * @param period Accumulator to divide. It must not have been used yet.
+ * @param shift Power of two to divide by. The resulting denominator must
+ *          still fit in 31 bits.
+ */
+void myPeriod_Prescale(myPeriod_t * period, uint32_t shift);
+
+/**
+ * @brief Gets the amount of counts of the next period.
+ * @param period Accumulator to use.
+ * @return Counts of the next period. It is either the whole part of the
+ *          period or one more than that.
+ */
+uint32_t myPeriod_Next(myPeriod_t * period);
+
+/**
+ * @brief Gets the whole part of the period, which is the shortest amount of
+ *          counts that myPeriod_Next will ever return.
+ * @param period Accumulator to use.
+ * @return Whole part of the period, in counts.
+ */
+uint32_t myPeriod_GetWhole(myPeriod_t * period);
+
+#endif
@@ -0,0 +1,116 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file mySplit.c
+ * @brief Source file for the period splitter.
+ *
+ * A period that doesn't fit the counter is cut into full-range segments,
+ *  except for the last two, which share what is left. This way no segment is
+ *  shorter than half the range, so the interrupt always has plenty of time to
+ *  queue the next one.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "mySplit.h"
+
+#include "myAssert.h"
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES
+ ******************************************************************************/
+/**
+ * @brief Sets up a splitter, with no segment queued.
+ * @param split Splitter to set up.
+ * @param max Longest segment that the counter can handle, in counts.
+ */
+void mySplit_Init(mySplit_t * split, uint32_t max)
+{
+  myASSERT(split != NULL);
+  myASSERT(max >= 2);
+
+  if(split != NULL)
+  {
+    split->max = max;
+    split->pending = 0;
+    split->ends = 0;
+    split->queued = 0;
+  }
+}
+
+/**
+ * @brief Gets the counts of the next segment to be queued. A new period is
+ *          taken from the accumulator when the previous one is all queued.
+ * @param split Splitter to use.
+ * @param period Accumulator that gives the counts of each period.
+ * @return Counts of the next segment. Never more than the maximum set at init
+ *          and, unless the period itself is shorter, never less than half
+ *          of it.
+ */
+uint32_t mySplit_Next(mySplit_t * split, myPeriod_t * period)
+{
+  uint32_t counts;
+
+  /* The ends of the queued segments are kept as a bit queue, oldest first.   */
+  myASSERT(split->queued < 32);
+
+  if(split->pending == 0) { split->pending = myPeriod_Next(period); }
+
+  if(split->pending <= split->max)           { counts = split->pending;      }
+  else if((split->pending / 2) < split->max) { counts = split->pending / 2;  }
+  else                                       { counts = split->max;          }
+
+  split->pending -= counts;
+  if(split->pending == 0) { split->ends |= (1UL << split->queued); }
+  split->queued++;
+
+  return counts;
+}
+
+/**
+ * @brief Tells the splitter that the oldest queued segment has elapsed.
+ * @param split Splitter to use.
+ * @return True if that segment was the last one of a period.
+ */
+bool mySplit_Expired(mySplit_t * split)
+{
+  bool ended = false;
+
+  myASSERT(split->queued != 0);
+
+  if(split->queued != 0)
+  {
+    ended = ((split->ends & 1) != 0);
+    split->ends >>= 1;
+    split->queued--;
+  }
+
+  return ended;
+}
+
+/**
+ * @brief Tells if the period of the last queued segment still has counts
+ *          that were not queued yet.
+ * @param split Splitter to use.
+ * @return True if there are counts left to queue.
+ */
+bool mySplit_IsPending(mySplit_t * split)
+{
+  return (split->pending != 0);
+}
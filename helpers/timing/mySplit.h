@@ -0,0 +1,92 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file mySplit.h
+ * @brief Header file for the period splitter.
+ *
+ * Hardware counters are only so wide, so periods longer than their range are
+ *  split into segments that fit, and the overflows in between are counted in
+ *  software. This module decides the length of each segment and tells, at
+ *  each overflow, whether a whole period has elapsed.
+ *
+ * It is meant for counters with a buffered period register, where the period
+ *  of the next segment is queued while the current one runs. So the module
+ *  keeps track of which of the queued segments end a period.
+ */
+
+#ifndef MY_SPLIT_H
+#define MY_SPLIT_H
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "myDefs.h"
+#include "myPeriod.h"
+
+/*******************************************************************************
+ *  PUBLIC DEFINITIONS
+ ******************************************************************************/
+/**
+ * @brief Structure that holds the state of a period splitter. Its fields are
+ *          private and should only be touched through the routines below.
+ */
+typedef struct
+{
+  uint32_t max;
+  uint32_t pending;
+  uint32_t ends;
+  uint32_t queued;
+} mySplit_t;
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES
+ ******************************************************************************/
+/**
+ * @brief Sets up a splitter, with no segment queued.
+ * @param split Splitter to set up.
+ * @param max Longest segment that the counter can handle, in counts.
+ */
+void mySplit_Init(mySplit_t * split, uint32_t max);
+
+/**
+ * @brief Gets the counts of the next segment to be queued. A new period is
+ *          taken from the accumulator when the previous one is all queued.
+ * @param split Splitter to use.
+ * @param period Accumulator that gives the counts of each period.
+ * @return Counts of the next segment. Never more than the maximum set at init
+ *          and, unless the period itself is shorter, never less than half
+ *          of it.
+ */
+uint32_t mySplit_Next(mySplit_t * split, myPeriod_t * period);
+
+/**
+ * @brief Tells the splitter that the oldest queued segment has elapsed.
+ * @param split Splitter to use.
+ * @return True if that segment was the last one of a period.
+ */
+bool mySplit_Expired(mySplit_t * split);
+
+/**
+ * @brief Tells if the period of the last queued segment still has counts
+ *          that were not queued yet.
+ * @param split Splitter to use.
+ * @return True if there are counts left to queue.
+ */
+bool mySplit_IsPending(mySplit_t * split);
+
+#endif
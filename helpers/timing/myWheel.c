@@ -0,0 +1,377 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file myWheel.c
+ * @brief Source file for the hierarchical timing wheel.
+ *
+ * The wheel is made of MY_WHEEL_LEVELS levels of 2^MY_WHEEL_LEVEL_BITS slots.
+ *  Level zero has one slot per tick, and each slot of the level N covers a
+ *  whole turn of the level N-1. A timer is always put on the lowest level
+ *  that can hold its expiration, and it is moved one level down each time the
+ *  level below completes a turn (cascading). This way a tick only touches the
+ *  timers that expire on it, plus the ones being cascaded, and each timer is
+ *  cascaded at most MY_WHEEL_LEVELS - 1 times during its life.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "myWheel.h"
+#include "projConfig.h"
+
+#include "myAssert.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+/* Set below the amount of levels and slots that the wheel will have. The     */
+/*  default allows timers up to 2^24 ticks (~4.6 hours at 1 ms) to be put     */
+/*  directly on the wheel. Longer ones are parked and rescheduled.            */
+#ifndef MY_WHEEL_LEVELS
+  #define MY_WHEEL_LEVELS                                                      4
+#endif
+
+#ifndef MY_WHEEL_LEVEL_BITS
+  #define MY_WHEEL_LEVEL_BITS                                                  6
+#endif
+
+#define MY_WHEEL_SLOTS                                (1UL << MY_WHEEL_LEVEL_BITS)
+#define MY_WHEEL_SLOT_MASK                                   (MY_WHEEL_SLOTS - 1)
+#define MY_WHEEL_RANGE                (1ULL << (MY_WHEEL_LEVELS * MY_WHEEL_LEVEL_BITS))
+
+/* Macros to get the slot of a given tick on a given level, and the mask of   */
+/*  the tick bits that are handled by the levels below a given one.           */
+#define MY_WHEEL_SLOT(TICK, LVL)   (((TICK) >> ((LVL) * MY_WHEEL_LEVEL_BITS)) & MY_WHEEL_SLOT_MASK)
+#define MY_WHEEL_LOWER_MASK(LVL)            ((1UL << ((LVL) * MY_WHEEL_LEVEL_BITS)) - 1)
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static void addNode(myWheelNode_t * node);
+static void linkNode(myWheelNode_t ** head, myWheelNode_t * node);
+static void unlinkNode(myWheelNode_t * node);
+static myWheelNode_t * detachSlot(myWheelNode_t ** head);
+static void cascadeSlot(uint32_t level, uint32_t slot);
+static void expireSlot(uint32_t slot);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static myWheelNode_t * myWheel_Slots[MY_WHEEL_LEVELS][MY_WHEEL_SLOTS];
+static uint32_t myWheel_Now = 0;
+
+#ifdef TEST
+static uint32_t myWheel_Visits = 0;
+  #define MY_WHEEL_COUNT_VISIT()                                 myWheel_Visits++
+#else
+  #define MY_WHEEL_COUNT_VISIT()
+#endif
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES
+ ******************************************************************************/
+/**
+ * @brief Starts (or restarts) a timer on the wheel.
+ * @param node Timer to start. If it is already running, it is rescheduled.
+ * @param ticks Amount of ticks until the first expiration. Zero is handled
+ *          as one, the next tick. It is clamped to MY_WHEEL_TICKS_MAX.
+ * @param period Amount of ticks between expirations after the first one. Zero
+ *          means that the timer expires only once. It is clamped to
+ *          MY_WHEEL_TICKS_MAX as well.
+ * @param cbk Callback to be called, from the tick context, on expiration.
+ */
+void myWheel_Start(myWheelNode_t * node, uint32_t ticks, uint32_t period, myCbk_t cbk)
+{
+  myASSERT(node != NULL);
+  myASSERT((ticks <= MY_WHEEL_TICKS_MAX) && (period <= MY_WHEEL_TICKS_MAX));
+
+  if(node != NULL)
+  {
+    if(node->pprev != NULL) { unlinkNode(node); }
+
+    /* Longer delays would look late, and expire on the next tick.            */
+    if(ticks > MY_WHEEL_TICKS_MAX)  { ticks = MY_WHEEL_TICKS_MAX; }
+    if(period > MY_WHEEL_TICKS_MAX) { period = MY_WHEEL_TICKS_MAX; }
+
+    /* A timer can't expire on the tick that is already being handled.        */
+    node->expiry = myWheel_Now + ((ticks == 0) ? 1 : ticks);
+    node->period = period;
+    node->cbk = cbk;
+
+    addNode(node);
+  }
+}
+
+/**
+ * @brief Stops a timer. Nothing happens if it was not running.
+ * @param node Timer to stop.
+ */
+void myWheel_Stop(myWheelNode_t * node)
+{
+  myASSERT(node != NULL);
+
+  if((node != NULL) && (node->pprev != NULL)) { unlinkNode(node); }
+}
+
+/**
+ * @brief Tells if a timer is currently scheduled on the wheel.
+ * @param node Timer to check.
+ * @return True if it is running, false otherwise.
+ */
+bool myWheel_IsRunning(myWheelNode_t * node)
+{
+  return ((node != NULL) && (node->pprev != NULL));
+}
+
+/**
+ * @brief Advances the wheel by one tick, expiring all the due timers.
+ *
+ * This routine should be called periodically by the time base that drives
+ *  the wheel, usually from a timer interrupt.
+ */
+void myWheel_Tick(void)
+{
+  const uint32_t now = ++myWheel_Now;
+  uint32_t level;
+
+  /* Each time a level completes a turn, the next slot of the level above is  */
+  /*  emptied into the lower levels.                                          */
+  for(level = 1; level < MY_WHEEL_LEVELS; level++)
+  {
+    if((now & MY_WHEEL_LOWER_MASK(level)) != 0) { break; }
+    cascadeSlot(level, MY_WHEEL_SLOT(now, level));
+  }
+
+  expireSlot(MY_WHEEL_SLOT(now, 0));
+}
+
+/**
+ * @brief Gets the current tick count of the wheel.
+ * @return Ticks elapsed since the wheel started. It wraps around at 2^32.
+ */
+uint32_t myWheel_GetTicks(void)
+{
+  return myWheel_Now;
+}
+
+/**
+ * @brief Gets how many ticks away is the next tick that has any work to do,
+ *          which is either expiring timers or cascading them.
+ *
+ * All the ticks before it do nothing, so they can be skipped, which is what
+ *  lets the time base stop ticking while the system is idle. The next event
+ *  may come before the next expiration, as cascading does not expire timers.
+ *
+ * @return Ticks until the next event, at least one. MY_WHEEL_NO_EVENT if no
+ *          timer is running.
+ */
+uint32_t myWheel_GetNextEvent(void)
+{
+  uint32_t result = MY_WHEEL_NO_EVENT;
+  uint32_t level, slot;
+
+  /* Level zero is handled on every tick, so its slots are looked at in the   */
+  /*  order the next ticks will visit them.                                   */
+  for(slot = 1; slot <= MY_WHEEL_SLOTS; slot++)
+  {
+    if(myWheel_Slots[0][MY_WHEEL_SLOT(myWheel_Now + slot, 0)] != NULL)
+    {
+      result = slot;
+      break;
+    }
+  }
+
+  /* Upper levels are only handled when the level below completes a turn, so  */
+  /*  the first slot found on each one is the first to cascade from it. Each  */
+  /*  level can only get closer events than the levels above, but level zero  */
+  /*  may be followed by a closer cascade, so all of them are looked at.      */
+  for(level = 1; level < MY_WHEEL_LEVELS; level++)
+  {
+    const uint32_t turn = MY_WHEEL_LOWER_MASK(level) + 1;
+    const uint32_t first = (myWheel_Now | MY_WHEEL_LOWER_MASK(level)) + 1;
+
+    for(slot = 0; slot < MY_WHEEL_SLOTS; slot++)
+    {
+      const uint32_t tick = first + (slot * turn);
+
+      if((tick - myWheel_Now) >= result) { break; }
+      if(myWheel_Slots[level][MY_WHEEL_SLOT(tick, level)] != NULL)
+      {
+        result = tick - myWheel_Now;
+        break;
+      }
+    }
+  }
+
+  return result;
+}
+
+/**
+ * @brief Advances the wheel by some ticks at once, without processing them.
+ * @param ticks Amount of ticks to skip. It must be lower than what
+ *          myWheel_GetNextEvent returns, so that nothing is missed.
+ */
+void myWheel_Skip(uint32_t ticks)
+{
+  myWheel_Now += ticks;
+}
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES - TEST PURPOSES
+ ******************************************************************************/
+#ifdef TEST
+/**
+ * @brief Resets wheel's internal logic and its variables.
+ */
+void myWheel_Reset(void)
+{
+  uint32_t level, slot;
+
+  for(level = 0; level < MY_WHEEL_LEVELS; level++)
+  {
+    for(slot = 0; slot < MY_WHEEL_SLOTS; slot++)
+    {
+      myWheelNode_t * list = detachSlot(&myWheel_Slots[level][slot]);
+
+      while(list != NULL)
+      {
+        myWheelNode_t * const node = list;
+        list = node->next;
+        node->next = NULL;
+        node->pprev = NULL;
+      }
+    }
+  }
+
+  myWheel_Now = 0;
+  myWheel_Visits = 0;
+}
+
+/**
+ * @brief Gets how many times a timer was visited by the tick logic, which
+ *          is the measure of work the wheel has performed so far.
+ * @return Amount of visits since last reset.
+ */
+uint32_t myWheel_GetVisits(void)
+{
+  return myWheel_Visits;
+}
+#endif
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static void addNode(myWheelNode_t * node)
+{
+  const int32_t delta = (int32_t)(node->expiry - myWheel_Now);
+  uint32_t level;
+
+  /* Late timers go to the next tick to be processed. Timers due right now    */
+  /*  only come from cascading, and go to the slot about to be expired.       */
+  if(delta < 0)
+  {
+    linkNode(&myWheel_Slots[0][MY_WHEEL_SLOT(myWheel_Now + 1, 0)], node);
+    return;
+  }
+
+  for(level = 0; level < MY_WHEEL_LEVELS; level++)
+  {
+    if((uint64_t)delta < (1ULL << ((level + 1) * MY_WHEEL_LEVEL_BITS)))
+    {
+      linkNode(&myWheel_Slots[level][MY_WHEEL_SLOT(node->expiry, level)], node);
+      return;
+    }
+  }
+
+  /* Too far in the future: park it at the farthest slot. It will be put back */
+  /*  when that slot gets cascaded, closer to its expiration.                 */
+  level = MY_WHEEL_LEVELS - 1;
+  linkNode(&myWheel_Slots[level][MY_WHEEL_SLOT(myWheel_Now + (uint32_t)(MY_WHEEL_RANGE - 1), level)], node);
+}
+
+static void linkNode(myWheelNode_t ** head, myWheelNode_t * node)
+{
+  node->next = *head;
+  if(node->next != NULL) { node->next->pprev = &node->next; }
+  node->pprev = head;
+  *head = node;
+}
+
+static void unlinkNode(myWheelNode_t * node)
+{
+  *node->pprev = node->next;
+  if(node->next != NULL) { node->next->pprev = node->pprev; }
+  node->next = NULL;
+  node->pprev = NULL;
+}
+
+static myWheelNode_t * detachSlot(myWheelNode_t ** head)
+{
+  myWheelNode_t * const list = *head;
+
+  *head = NULL;
+  return list;
+}
+
+static void cascadeSlot(uint32_t level, uint32_t slot)
+{
+  myWheelNode_t * list = detachSlot(&myWheel_Slots[level][slot]);
+
+  while(list != NULL)
+  {
+    myWheelNode_t * const node = list;
+    list = node->next;
+
+    MY_WHEEL_COUNT_VISIT();
+    addNode(node);
+  }
+}
+
+static void expireSlot(uint32_t slot)
+{
+  myWheelNode_t * pending = detachSlot(&myWheel_Slots[0][slot]);
+
+  /* The list is moved to a local head so that callbacks can safely start or  */
+  /*  stop any timer, including the ones still waiting to be processed here.  */
+  if(pending != NULL) { pending->pprev = &pending; }
+
+  while(pending != NULL)
+  {
+    myWheelNode_t * const node = pending;
+    myCbk_t cbk;
+
+    MY_WHEEL_COUNT_VISIT();
+    unlinkNode(node);
+
+    if((int32_t)(myWheel_Now - node->expiry) < 0)
+    {
+      addNode(node);
+      continue;
+    }
+
+    /* Periodic timers are rescheduled from their ideal deadline, not from   */
+    /*  the current tick, so that their expirations never drift.              */
+    cbk = node->cbk;
+    if(node->period != 0)
+    {
+      node->expiry += node->period;
+      addNode(node);
+    }
+
+    if(cbk != NULL) { cbk(); }
+  }
+}
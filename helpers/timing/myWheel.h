@@ -0,0 +1,146 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file myWheel.h
+ * @brief Header file for the hierarchical timing wheel.
+ *
+ * This header provides the types and routines for a timing wheel, which
+ *  multiplexes any amount of software timers over a single periodic tick.
+ *  Starting, stopping and expiring a timer are all O(1) operations, no matter
+ *    how many timers are running.
+ */
+
+#ifndef MY_WHEEL_H
+#define MY_WHEEL_H
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "myDefs.h"
+
+/*******************************************************************************
+ *  PUBLIC DEFINITIONS
+ ******************************************************************************/
+/**
+ * @brief Structure that represents a timer handled by the wheel.
+ *
+ * The wheel does not allocate anything, so the client provides the storage
+ *  for each timer. Its fields are private to the wheel logic and should only
+ *  be touched through the routines below.
+ */
+typedef struct myWheelNode_t
+{
+  struct myWheelNode_t * next;
+  struct myWheelNode_t ** pprev;
+  uint32_t expiry;
+  uint32_t period;
+  myCbk_t cbk;
+} myWheelNode_t;
+
+/**
+ * @brief Longest delay, in ticks, of a timer. Expirations are told from the
+ *          current tick by the sign of their 32-bit difference, so anything
+ *          longer would look like it is already late.
+ */
+#define MY_WHEEL_TICKS_MAX                                          0x7FFFFFFFUL
+
+/**
+ * @brief Value returned by myWheel_GetNextEvent when no timer is running.
+ */
+#define MY_WHEEL_NO_EVENT                                             UINT32_MAX
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES
+ ******************************************************************************/
+/**
+ * @brief Starts (or restarts) a timer on the wheel.
+ * @param node Timer to start. If it is already running, it is rescheduled.
+ * @param ticks Amount of ticks until the first expiration. Zero is handled
+ *          as one, the next tick. It must not exceed MY_WHEEL_TICKS_MAX, and
+ *          it is clamped to it if it does.
+ * @param period Amount of ticks between expirations after the first one. Zero
+ *          means that the timer expires only once. It has the same limit as
+ *          ticks.
+ * @param cbk Callback to be called, from the tick context, on expiration.
+ */
+void myWheel_Start(myWheelNode_t * node, uint32_t ticks, uint32_t period, myCbk_t cbk);
+
+/**
+ * @brief Stops a timer. Nothing happens if it was not running.
+ * @param node Timer to stop.
+ */
+void myWheel_Stop(myWheelNode_t * node);
+
+/**
+ * @brief Tells if a timer is currently scheduled on the wheel.
+ * @param node Timer to check.
+ * @return True if it is running, false otherwise.
+ */
+bool myWheel_IsRunning(myWheelNode_t * node);
+
+/**
+ * @brief Advances the wheel by one tick, expiring all the due timers.
+ *
+ * This routine should be called periodically by the time base that drives
+ *  the wheel, usually from a timer interrupt.
+ */
+void myWheel_Tick(void);
+
+/**
+ * @brief Gets the current tick count of the wheel.
+ * @return Ticks elapsed since the wheel started. It wraps around at 2^32.
+ */
+uint32_t myWheel_GetTicks(void);
+
+/**
+ * @brief Gets how many ticks away is the next tick that has any work to do,
+ *          which is either expiring timers or cascading them.
+ *
+ * All the ticks before it do nothing, so they can be skipped, which is what
+ *  lets the time base stop ticking while the system is idle. The next event
+ *  may come before the next expiration, as cascading does not expire timers.
+ *
+ * @return Ticks until the next event, at least one. MY_WHEEL_NO_EVENT if no
+ *          timer is running.
+ */
+uint32_t myWheel_GetNextEvent(void);
+
+/**
+ * @brief Advances the wheel by some ticks at once, without processing them.
+ * @param ticks Amount of ticks to skip. It must be lower than what
+ *          myWheel_GetNextEvent returns, so that nothing is missed.
+ */
+void myWheel_Skip(uint32_t ticks);
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES - TEST PURPOSES
+ ******************************************************************************/
+#ifdef TEST
+/**
+ * @brief Resets wheel's internal logic and its variables.
+ */
+void myWheel_Reset(void);
+
+/**
+ * @brief Gets how many times a timer was visited by the tick logic, which
+ *          is the measure of work the wheel has performed so far.
+ * @return Amount of visits since last reset.
+ */
+uint32_t myWheel_GetVisits(void);
+#endif
+
+#endif
@@ -22,6 +22,14 @@
  *  to use the CMSIS-OS logic.
  * This is a temporary source file. As the proper libraries are added to the
  *  repository, the correct files will replace the temporary ones.
+ *
+ * The kernel runs tasks to completion, one event at a time, always picking
+ *  the highest priority task with events pending. Tasks never block, so they
+ *  all share the one stack, and events can be posted from interrupts so that
+ *  the work is done out of them. With no event pending, the kernel keeps the
+ *  core sleeping. Each sleep stops the tick of the virtual timers until the
+ *  next one with work to do, so the core only wakes up when there is
+ *  something to run.
  */
 
 /*******************************************************************************
@@ -29,17 +37,49 @@
  ******************************************************************************/
 #include "cmsis_os.h"
 
+#include "myIrq.h"
+#include "myPower.h"
+#include "myTimer.h"
+#include "myTime.h"
+
 /*******************************************************************************
  *  PRIVATE DEFINITIONS
  ******************************************************************************/
+/* The kernel loop never ends, except on tests, which set how many passes it  */
+/*  runs so that they can check what it did.                                  */
+#ifndef TEST
+  #define OS_KERNEL_LOOP()                                              while(1)
+#else
+  #define OS_KERNEL_LOOP()                          while(osKernel_Passes-- > 0)
+#endif
+
+/* Finds the highest priority in the ready set, which must not be empty.      */
+/*  Cortex-M3 counts the leading zeros in a single instruction. Cortex-M0+    */
+/*  has no such instruction, so GCC calls a routine from its runtime library  */
+/*  instead, which still takes a constant time.                               */
+#define OS_KERNEL_HIGHEST(READY)                     (31 - __builtin_clz(READY))
 
 /*******************************************************************************
  *  PRIVATE PROTOTYPES
  ******************************************************************************/
+static bool osKernel_Dispatch(void);
+static void osKernel_Idle(void);
 
 /*******************************************************************************
  *  PRIVATE VARIABLES
  ******************************************************************************/
+/* Each priority has at most one task. The ready set has a bit set for each   */
+/*  priority whose task has events pending, so that the next task to run is   */
+/*  found at once, no matter how many tasks there are.                        */
+static osTask_t * osKernel_Tasks[OS_TASK_PRIORITIES];
+static volatile uint32_t osKernel_Ready = 0;
+
+static osIdleStats_t osKernel_Stats;
+static uint64_t osKernel_StartUs;
+
+#ifdef TEST
+static uint32_t osKernel_Passes;
+#endif
 
 /*******************************************************************************
  *  PUBLIC FUNCTIONS / ROUTINES
@@ -50,11 +90,251 @@
  */
 osStatus osKernelStart(void)
 {
-  /* Simply keep itself running an infinite loop.                             */
-  while(1);
+  osKernel_StartUs = myTime_Now();
+
+  OS_KERNEL_LOOP()
+  {
+    if(!osKernel_Dispatch()) { osKernel_Idle(); }
+  }
+
   return osOK;
 }
 
+/**
+ * @brief Creates a task, which runs to completion for each event posted to it.
+ * @param task Task to create. Its storage must last as long as the kernel.
+ * @param priority Priority of the task, up to OS_TASK_PRIORITIES - 1, higher
+ *          values running first. Each task must have a priority of its own.
+ * @param handler Routine to call with each event of the task.
+ * @param events Storage for the events that are pending on the task.
+ * @param size Amount of events that fit in the storage. It must be a power of
+ *          two.
+ * @return Status code that indicates the execution status of the function.
+ */
+osStatus osTaskCreate(osTask_t * task, uint32_t priority, osTaskHandler_t handler, uint32_t * events, uint32_t size)
+{
+  osStatus result = osErrorParameter;
+
+  if((task != NULL) && (priority < OS_TASK_PRIORITIES) && (handler != NULL) && (events != NULL) && (size != 0) && ((size & (size - 1)) == 0))
+  {
+    result = osErrorResource;
+
+    if(osKernel_Tasks[priority] == NULL)
+    {
+      task->handler = handler;
+      task->events = events;
+      task->mask = size - 1;
+      task->head = 0;
+      task->count = 0;
+      task->priority = priority;
+      osKernel_Tasks[priority] = task;
+
+      result = osOK;
+    }
+  }
+
+  return result;
+}
+
+/**
+ * @brief Posts an event to a task. It can be called from interrupts, so that
+ *          a callback, such as a timer's, hands its work to a task instead of
+ *          doing it right there.
+ * @param task Task to post the event to.
+ * @param event Event to post, whose meaning is up to the task.
+ * @return Status code that indicates the execution status of the function.
+ *          If the events of the task are full, the event is dropped.
+ */
+osStatus osTaskPost(osTask_t * task, uint32_t event)
+{
+  osStatus result = osErrorParameter;
+
+  if((task != NULL) && (task->handler != NULL))
+  {
+    const uint32_t state = myIrq_Lock();
+
+    result = osErrorResource;
+    if(task->count <= task->mask)
+    {
+      task->events[(task->head + task->count) & task->mask] = event;
+      task->count++;
+      osKernel_Ready |= (1UL << task->priority);
+      result = osOK;
+    }
+    myIrq_Unlock(state);
+  }
+
+  return result;
+}
+
+/**
+ * @brief Creates a message queue.
+ * @param queue Queue to create.
+ * @param storage Storage for the messages, of msgSize * msgCount bytes.
+ * @param msgSize Size, in bytes, of each message.
+ * @param msgCount Amount of messages that fit in the storage, a power of two.
+ * @return Status code that indicates the execution status of the function.
+ */
+osStatus osMessageQueueCreate(osMessageQueue_t * queue, void * storage, uint32_t msgSize, uint32_t msgCount)
+{
+  return (myRing_Init(queue, storage, msgSize, msgCount) == myRet_OK) ? osOK : osErrorParameter;
+}
+
+/**
+ * @brief Puts a message into a queue. Only its sender may call it.
+ * @param queue Queue to put the message into.
+ * @param msg Message to copy into the queue.
+ * @return Status code that indicates the execution status of the function.
+ */
+osStatus osMessageQueuePut(osMessageQueue_t * queue, const void * msg)
+{
+  osStatus result = osErrorParameter;
+
+  if((queue != NULL) && (msg != NULL))
+  {
+    result = (myRing_Push(queue, msg) == myRet_OK) ? osOK : osErrorResource;
+  }
+
+  return result;
+}
+
+/**
+ * @brief Gets the oldest message from a queue. Only its receiver may call it.
+ * @param queue Queue to get the message from.
+ * @param msg Written with the message.
+ * @return Status code that indicates the execution status of the function.
+ */
+osStatus osMessageQueueGet(osMessageQueue_t * queue, void * msg)
+{
+  osStatus result = osErrorParameter;
+
+  if((queue != NULL) && (msg != NULL))
+  {
+    result = (myRing_Pop(queue, msg) == myRet_OK) ? osOK : osErrorResource;
+  }
+
+  return result;
+}
+
+/**
+ * @brief Gets how many messages are in a queue.
+ * @param queue Queue to check.
+ * @return Amount of messages in the queue.
+ */
+uint32_t osMessageQueueGetCount(osMessageQueue_t * queue)
+{
+  return (queue != NULL) ? myRing_GetCount(queue) : 0;
+}
+
+/**
+ * @brief Gets the idle statistics of the kernel.
+ * @param stats Written with the statistics since the kernel was started.
+ * @return Status code that indicates the execution status of the function.
+ */
+osStatus osKernelGetIdleStats(osIdleStats_t * stats)
+{
+  osStatus result = osErrorParameter;
+
+  if(stats != NULL)
+  {
+    /* The statistics are only written with interrupts masked, so they can be */
+    /*  read at once from any context but the kernel loop, which is this one. */
+    *stats = osKernel_Stats;
+    stats->totalUs = myTime_Now() - osKernel_StartUs;
+    result = osOK;
+  }
+
+  return result;
+}
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES - TEST PURPOSES
+ ******************************************************************************/
+#ifdef TEST
+/**
+ * @brief Resets kernel's internal logic and its variables.
+ * @param passes Amount of passes that osKernelStart runs before returning.
+ */
+void osKernel_Reset(uint32_t passes)
+{
+  uint32_t priority;
+
+  for(priority = 0; priority < OS_TASK_PRIORITIES; priority++) { osKernel_Tasks[priority] = NULL; }
+  osKernel_Ready = 0;
+  osKernel_Stats = (osIdleStats_t) { 0 };
+  osKernel_StartUs = 0;
+  osKernel_Passes = passes;
+}
+#endif
+
 /*******************************************************************************
  *  PRIVATE FUNCTIONS / ROUTINES
  ******************************************************************************/
+static bool osKernel_Dispatch(void)
+{
+  osTask_t * task = NULL;
+  uint32_t event = 0;
+  uint32_t state;
+
+  /* The event is taken with interrupts masked, as they may post to the same  */
+  /*  task, but the handler runs with them unmasked.                          */
+  state = myIrq_Lock();
+  if(osKernel_Ready != 0)
+  {
+    task = osKernel_Tasks[OS_KERNEL_HIGHEST(osKernel_Ready)];
+    event = task->events[task->head];
+    task->head = (task->head + 1) & task->mask;
+    task->count--;
+    if(task->count == 0) { osKernel_Ready &= ~(1UL << task->priority); }
+  }
+  myIrq_Unlock(state);
+
+  if(task != NULL) { task->handler(event); }
+
+  return (task != NULL);
+}
+
+static void osKernel_Idle(void)
+{
+  uint64_t sleepStart, sleepEnd;
+  uint32_t wakeupUs;
+
+  /* Interrupts are masked from before the tick is checked until after it is  */
+  /*  brought back, so none of them can start a timer in between, nor run     */
+  /*  with the tick stopped. They still wake the core up, and run right after */
+  /*  the idle period ends. An interrupt may have posted an event since the   */
+  /*  last dispatch, in which case there is no sleep at all.                  */
+  myPower_IdleEnter();
+  if(osKernel_Ready == 0)
+  {
+    wakeupUs = myTimer_IdleEnter();
+    sleepStart = myTime_Now();
+    myPower_Sleep();
+    sleepEnd = myTime_Now();
+    myTimer_IdleExit();
+
+    osKernel_Stats.sleeps++;
+    osKernel_Stats.sleepUs += sleepEnd - sleepStart;
+
+    /* Without the tick, the core should only wake up at the programmed time. */
+    /*  Waking up before it means that some other interrupt had work to do.   */
+    if(wakeupUs != 0)
+    {
+      const uint64_t wakeup = sleepStart + wakeupUs;
+
+      osKernel_Stats.tickless++;
+      if(sleepEnd < wakeup)
+      {
+        osKernel_Stats.earlyWakes++;
+      }
+      else
+      {
+        const uint32_t latency = (uint32_t)(sleepEnd - wakeup);
+
+        if(latency > osKernel_Stats.maxLatencyUs) { osKernel_Stats.maxLatencyUs = latency; }
+        osKernel_Stats.sumLatencyUs += latency;
+      }
+    }
+  }
+  myPower_IdleExit();
+}
@@ -31,6 +31,7 @@
  *  INCLUDES
  ******************************************************************************/
 #include "myDefs.h"
+#include "myRing.h"
 
 /*******************************************************************************
  *  PUBLIC DEFINITIONS
@@ -40,9 +41,62 @@
  */
 typedef enum
 {
-  osOK,
+  osOK = 0,
+  osErrorParameter = 0x80,
+  osErrorResource = 0x81,
 } osStatus;
 
+/**
+ * @brief Amount of task priorities. Not part of CMSIS-RTOS.
+ */
+#define OS_TASK_PRIORITIES                                                    32
+
+/**
+ * @brief Routine of a task, called once for each event posted to it. It runs
+ *          to completion, so it must return instead of waiting for anything.
+ *          Not part of CMSIS-RTOS.
+ */
+typedef void (*osTaskHandler_t)(uint32_t event);
+
+/**
+ * @brief Structure that represents a task. Not part of CMSIS-RTOS.
+ *
+ * The kernel does not allocate anything, so the client provides the storage
+ *  for each task and its events. Its fields are private to the kernel logic
+ *  and should only be touched through the routines below.
+ */
+typedef struct
+{
+  osTaskHandler_t handler;
+  uint32_t * events;
+  uint32_t mask;
+  uint32_t head;
+  uint32_t count;
+  uint32_t priority;
+} osTask_t;
+
+/**
+ * @brief Statistics of how the kernel spent its time while idle, since it was
+ *          started. Not part of CMSIS-RTOS.
+ */
+typedef struct
+{
+  uint64_t totalUs;       /* Time since the kernel was started.               */
+  uint64_t sleepUs;       /* Time that the core spent sleeping.               */
+  uint32_t sleeps;        /* Times that the core went to sleep.               */
+  uint32_t tickless;      /* Sleeps in which the timer tick was stopped.      */
+  uint32_t earlyWakes;    /* Tickless sleeps ended before their wakeup.       */
+  uint32_t maxLatencyUs;  /* Longest delay from a wakeup until running again. */
+  uint64_t sumLatencyUs;  /* Sum of the delays, to get their average.         */
+} osIdleStats_t;
+
+/**
+ * @brief Structure that represents a message queue, with room for one sender
+ *          and one receiver, such as an interrupt and a task. Neither of them
+ *          ever waits for the other nor masks interrupts.
+ */
+typedef myRing_t osMessageQueue_t;
+
 /*******************************************************************************
  *  PUBLIC PROTOTYPES
  ******************************************************************************/
@@ -52,4 +106,89 @@ typedef enum
  */
 osStatus osKernelStart(void);
 
+/**
+ * @brief Gets the idle statistics of the kernel. Not part of CMSIS-RTOS.
+ * @param stats Written with the statistics since the kernel was started.
+ * @return Status code that indicates the execution status of the function.
+ */
+osStatus osKernelGetIdleStats(osIdleStats_t * stats);
+
+/**
+ * @brief Creates a task, which runs to completion for each event posted to it.
+ *          Not part of CMSIS-RTOS.
+ * @param task Task to create. Its storage must last as long as the kernel.
+ * @param priority Priority of the task, up to OS_TASK_PRIORITIES - 1, higher
+ *          values running first. Each task must have a priority of its own.
+ * @param handler Routine to call with each event of the task.
+ * @param events Storage for the events that are pending on the task.
+ * @param size Amount of events that fit in the storage. It must be a power of
+ *          two.
+ * @return Status code that indicates the execution status of the function.
+ */
+osStatus osTaskCreate(osTask_t * task, uint32_t priority, osTaskHandler_t handler, uint32_t * events, uint32_t size);
+
+/**
+ * @brief Posts an event to a task. It can be called from interrupts, so that
+ *          a callback, such as a timer's, hands its work to a task instead of
+ *          doing it right there. Not part of CMSIS-RTOS.
+ * @param task Task to post the event to.
+ * @param event Event to post, whose meaning is up to the task.
+ * @return Status code that indicates the execution status of the function.
+ *          If the events of the task are full, the event is dropped.
+ */
+osStatus osTaskPost(osTask_t * task, uint32_t event);
+
+/**
+ * @brief Creates a message queue. It is built on the same lines as the
+ *          CMSIS-RTOS2 one, but the client provides its storage, and the
+ *          queue takes a single sender and a single receiver.
+ * @param queue Queue to create.
+ * @param storage Storage for the messages, of msgSize * msgCount bytes.
+ * @param msgSize Size, in bytes, of each message.
+ * @param msgCount Amount of messages that fit in the storage. It must be a
+ *          power of two.
+ * @return Status code that indicates the execution status of the function.
+ */
+osStatus osMessageQueueCreate(osMessageQueue_t * queue, void * storage, uint32_t msgSize, uint32_t msgCount);
+
+/**
+ * @brief Puts a message into a queue. Only the sender of the queue may call
+ *          it, which can be an interrupt. It does not wake up the receiver:
+ *          to have a task handle the message, post an event to it as well.
+ * @param queue Queue to put the message into.
+ * @param msg Message to copy into the queue.
+ * @return Status code that indicates the execution status of the function.
+ *          If the queue is full, the message is dropped.
+ */
+osStatus osMessageQueuePut(osMessageQueue_t * queue, const void * msg);
+
+/**
+ * @brief Gets the oldest message from a queue. Only the receiver of the queue
+ *          may call it. It never waits for a message to come.
+ * @param queue Queue to get the message from.
+ * @param msg Written with the message.
+ * @return Status code that indicates the execution status of the function.
+ *          If the queue is empty, osErrorResource is returned.
+ */
+osStatus osMessageQueueGet(osMessageQueue_t * queue, void * msg);
+
+/**
+ * @brief Gets how many messages are in a queue.
+ * @param queue Queue to check.
+ * @return Amount of messages in the queue.
+ */
+uint32_t osMessageQueueGetCount(osMessageQueue_t * queue);
+
+/*******************************************************************************
+ *  PUBLIC PROTOTYPES - TEST PURPOSES
+ ******************************************************************************/
+#ifdef TEST
+/**
+ * @brief Resets kernel's internal logic and its variables.
+ * @param passes Amount of passes that osKernelStart runs before returning,
+ *          instead of running forever.
+ */
+void osKernel_Reset(uint32_t passes);
+#endif
+
 #endif
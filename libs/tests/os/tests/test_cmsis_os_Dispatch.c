@@ -0,0 +1,281 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file test_cmsis_os_Dispatch.c
+ * @brief Test file for testing the kernel logic, operation when events are
+ *          posted to tasks and dispatched to them.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+
+#include "cmsis_os.h"
+#include "myIrq.h"
+#include "myRing.h"
+#include "myTime.h"
+
+#include "mock_myPower.h"
+#include "mock_myTimer.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_EVENTS_SIZE                                                     (8)
+#define TEST_LOW_PRIORITY                                                    (3)
+#define TEST_HIGH_PRIORITY                                                  (20)
+#define TEST_EVENT                                                     (0xCAFEU)
+
+/* The benchmark keeps some events in flight over several tasks, each one     */
+/*  posting a new event to the next task as it handles one.                   */
+#define TEST_BENCH_TASKS                                                     (8)
+#define TEST_BENCH_IN_FLIGHT                                                (16)
+#define TEST_BENCH_EVENTS                                              (2000000)
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static void lowHandler(uint32_t event);
+static void highHandler(uint32_t event);
+static void postingHandler(uint32_t event);
+static void benchHandler(uint32_t event);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static osTask_t lowTask, highTask;
+static uint32_t lowEvents[TEST_EVENTS_SIZE], highEvents[TEST_EVENTS_SIZE];
+
+/* Record of the events handled, high priority ones with the bit 31 set.      */
+static uint32_t handled[4 * TEST_EVENTS_SIZE];
+static uint32_t handledCnt;
+
+static osTask_t benchTasks[TEST_BENCH_TASKS];
+static uint32_t benchEvents[TEST_BENCH_TASKS][TEST_BENCH_IN_FLIGHT];
+static uint32_t benchHandled;
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  osKernel_Reset(0);
+  handledCnt = 0;
+  benchHandled = 0;
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief Creating a task with invalid parameters should fail.
+ */
+void test_IfParametersAreInvalidThenCreateFails(void)
+{
+  TEST_ASSERT_EQUAL(osErrorParameter, osTaskCreate(NULL, TEST_LOW_PRIORITY, lowHandler, lowEvents, TEST_EVENTS_SIZE));
+  TEST_ASSERT_EQUAL(osErrorParameter, osTaskCreate(&lowTask, OS_TASK_PRIORITIES, lowHandler, lowEvents, TEST_EVENTS_SIZE));
+  TEST_ASSERT_EQUAL(osErrorParameter, osTaskCreate(&lowTask, TEST_LOW_PRIORITY, NULL, lowEvents, TEST_EVENTS_SIZE));
+  TEST_ASSERT_EQUAL(osErrorParameter, osTaskCreate(&lowTask, TEST_LOW_PRIORITY, lowHandler, NULL, TEST_EVENTS_SIZE));
+  TEST_ASSERT_EQUAL(osErrorParameter, osTaskCreate(&lowTask, TEST_LOW_PRIORITY, lowHandler, lowEvents, 0));
+  TEST_ASSERT_EQUAL(osErrorParameter, osTaskCreate(&lowTask, TEST_LOW_PRIORITY, lowHandler, lowEvents, TEST_EVENTS_SIZE - 1));
+}
+
+/**
+ * @brief Each priority should take a single task.
+ */
+void test_IfPriorityIsTakenThenCreateFails(void)
+{
+  TEST_ASSERT_EQUAL(osOK, osTaskCreate(&lowTask, TEST_LOW_PRIORITY, lowHandler, lowEvents, TEST_EVENTS_SIZE));
+  TEST_ASSERT_EQUAL(osErrorResource, osTaskCreate(&highTask, TEST_LOW_PRIORITY, highHandler, highEvents, TEST_EVENTS_SIZE));
+}
+
+/**
+ * @brief Posting to a task that was never created should fail.
+ */
+void test_IfTaskWasNotCreatedThenPostFails(void)
+{
+  osTask_t task = { 0 };
+
+  TEST_ASSERT_EQUAL(osErrorParameter, osTaskPost(&task, TEST_EVENT));
+  TEST_ASSERT_EQUAL(osErrorParameter, osTaskPost(NULL, TEST_EVENT));
+}
+
+/**
+ * @brief A posted event should be handed to its task by the kernel.
+ */
+void test_IfEventIsPostedThenTaskHandlesIt(void)
+{
+  osKernel_Reset(1);
+  osTaskCreate(&lowTask, TEST_LOW_PRIORITY, lowHandler, lowEvents, TEST_EVENTS_SIZE);
+
+  TEST_ASSERT_EQUAL(osOK, osTaskPost(&lowTask, TEST_EVENT));
+  osKernelStart();
+
+  TEST_ASSERT_EQUAL(1, handledCnt);
+  TEST_ASSERT_EQUAL_HEX32(TEST_EVENT, handled[0]);
+}
+
+/**
+ * @brief Events of a single task should be handled in the order they were
+ *          posted.
+ */
+void test_IfSeveralEventsArePostedThenTheyAreHandledInOrder(void)
+{
+  uint32_t event;
+
+  osKernel_Reset(TEST_EVENTS_SIZE);
+  osTaskCreate(&lowTask, TEST_LOW_PRIORITY, lowHandler, lowEvents, TEST_EVENTS_SIZE);
+  for(event = 0; event < TEST_EVENTS_SIZE; event++) { osTaskPost(&lowTask, event); }
+  osKernelStart();
+
+  TEST_ASSERT_EQUAL(TEST_EVENTS_SIZE, handledCnt);
+  for(event = 0; event < TEST_EVENTS_SIZE; event++) { TEST_ASSERT_EQUAL(event, handled[event]); }
+}
+
+/**
+ * @brief Once the events of a task are full, further posts should fail and
+ *          not disturb the ones already pending.
+ */
+void test_IfEventsAreFullThenPostFails(void)
+{
+  uint32_t event;
+
+  osKernel_Reset(2 * TEST_EVENTS_SIZE);
+  osTaskCreate(&lowTask, TEST_LOW_PRIORITY, lowHandler, lowEvents, TEST_EVENTS_SIZE);
+  for(event = 0; event < TEST_EVENTS_SIZE; event++) { osTaskPost(&lowTask, event); }
+
+  TEST_ASSERT_EQUAL(osErrorResource, osTaskPost(&lowTask, TEST_EVENT));
+
+  osKernelStart();
+  TEST_ASSERT_EQUAL(TEST_EVENTS_SIZE, handledCnt);
+  TEST_ASSERT_EQUAL(TEST_EVENTS_SIZE - 1, handled[TEST_EVENTS_SIZE - 1]);
+}
+
+/**
+ * @brief The highest priority task with events pending should always run
+ *          first, no matter the order in which they were posted.
+ */
+void test_IfTasksHaveEventsThenHighestPriorityRunsFirst(void)
+{
+  osKernel_Reset(4);
+  osTaskCreate(&lowTask, TEST_LOW_PRIORITY, lowHandler, lowEvents, TEST_EVENTS_SIZE);
+  osTaskCreate(&highTask, TEST_HIGH_PRIORITY, highHandler, highEvents, TEST_EVENTS_SIZE);
+  osTaskPost(&lowTask, 1);
+  osTaskPost(&lowTask, 2);
+  osTaskPost(&highTask, 3);
+  osTaskPost(&highTask, 4);
+  osKernelStart();
+
+  TEST_ASSERT_EQUAL(4, handledCnt);
+  TEST_ASSERT_EQUAL_HEX32((1UL << 31) | 3, handled[0]);
+  TEST_ASSERT_EQUAL_HEX32((1UL << 31) | 4, handled[1]);
+  TEST_ASSERT_EQUAL_HEX32(1, handled[2]);
+  TEST_ASSERT_EQUAL_HEX32(2, handled[3]);
+}
+
+/**
+ * @brief An event posted by a running task to a higher priority one should be
+ *          handled before the pending events of the former.
+ */
+void test_IfTaskPostsToHigherPriorityThenItRunsNext(void)
+{
+  osKernel_Reset(3);
+  osTaskCreate(&lowTask, TEST_LOW_PRIORITY, postingHandler, lowEvents, TEST_EVENTS_SIZE);
+  osTaskCreate(&highTask, TEST_HIGH_PRIORITY, highHandler, highEvents, TEST_EVENTS_SIZE);
+  osTaskPost(&lowTask, 1);
+  osTaskPost(&lowTask, 2);
+  osKernelStart();
+
+  TEST_ASSERT_EQUAL(3, handledCnt);
+  TEST_ASSERT_EQUAL_HEX32(1, handled[0]);
+  TEST_ASSERT_EQUAL_HEX32((1UL << 31) | 1, handled[1]);
+  TEST_ASSERT_EQUAL_HEX32(2, handled[2]);
+}
+
+/**
+ * @brief The kernel should only sleep once there are no events pending.
+ */
+void test_IfEventsArePendingThenKernelDoesNotSleep(void)
+{
+  osKernel_Reset(3);
+  osTaskCreate(&lowTask, TEST_LOW_PRIORITY, lowHandler, lowEvents, TEST_EVENTS_SIZE);
+  osTaskPost(&lowTask, 1);
+  osTaskPost(&lowTask, 2);
+  osKernelStart();
+
+  TEST_ASSERT_EQUAL(2, handledCnt);
+  TEST_ASSERT_CALLED(myPower_Sleep);
+}
+
+/**
+ * @brief Measures how many events per second the kernel posts and dispatches
+ *          on the host. Host timings only give a rough idea of the cost on
+ *          target, so the result is just printed.
+ */
+void test_BenchmarkDispatch(void)
+{
+  uint64_t start, elapsedUs;
+  uint32_t idx;
+
+  osKernel_Reset(TEST_BENCH_EVENTS);
+  for(idx = 0; idx < TEST_BENCH_TASKS; idx++)
+  {
+    osTaskCreate(&benchTasks[idx], 2 * idx, benchHandler, benchEvents[idx], TEST_BENCH_IN_FLIGHT);
+  }
+  for(idx = 0; idx < TEST_BENCH_IN_FLIGHT; idx++) { osTaskPost(&benchTasks[idx % TEST_BENCH_TASKS], idx); }
+
+  start = myTime_Now();
+  osKernelStart();
+  elapsedUs = myTime_Now() - start;
+
+  printf("osKernel: %.2f M events/s over %u tasks\n",
+         (double)benchHandled / (double)elapsedUs, TEST_BENCH_TASKS);
+  TEST_ASSERT_EQUAL(TEST_BENCH_EVENTS, benchHandled);
+  TEST_ASSERT_NOT_CALLED(myPower_Sleep);
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static void lowHandler(uint32_t event)
+{
+  handled[handledCnt++] = event;
+}
+
+static void highHandler(uint32_t event)
+{
+  handled[handledCnt++] = (1UL << 31) | event;
+}
+
+static void postingHandler(uint32_t event)
+{
+  handled[handledCnt++] = event;
+  osTaskPost(&highTask, event);
+}
+
+static void benchHandler(uint32_t event)
+{
+  benchHandled++;
+  osTaskPost(&benchTasks[(event + benchHandled) % TEST_BENCH_TASKS], event);
+}
@@ -0,0 +1,207 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file test_cmsis_os_Idle.c
+ * @brief Test file for testing the kernel logic, operation when the system is
+ *          idle. The time base and the sleeps are simulated on the host, so
+ *          that the idle statistics can be checked.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+
+#include "cmsis_os.h"
+#include "myMacros.h"
+#include "myIrq.h"
+#include "myRing.h"
+
+#include "mock_myPower.h"
+#include "mock_myTimer.h"
+#include "mock_myTime.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_WAKEUP_US                                                   (10000)
+#define TEST_AWAKE_US                                                      (100)
+#define TEST_PASSES                                                        (100)
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static void prepareMocks(void);
+static uint64_t simTimeNow(void);
+static void simSleep(void);
+static void simIdleExit(void);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+/* Simulated time, and how long each sleep lasts, one after the other. The    */
+/*  last one is repeated once the others are used up.                         */
+static uint64_t simNowUs;
+static const uint32_t * simSleepsUs;
+static uint32_t simSleepsCnt;
+
+static osIdleStats_t stats;
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  static const uint32_t sleepsUs[] = { TEST_WAKEUP_US };
+
+  prepareMocks();
+  simNowUs = 0;
+  simSleepsUs = sleepsUs;
+  simSleepsCnt = 1;
+  stats = (osIdleStats_t) { 0 };
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief Each pass of the kernel should mask the interrupts, stop the tick,
+ *          sleep, and bring everything back in reverse order.
+ */
+void test_IfKernelIsIdleThenItSleepsWithTickStopped(void)
+{
+  osKernel_Reset(1);
+  osKernelStart();
+
+  TEST_ASSERT_CALLED_IN_ORDER(1, myPower_IdleEnter);
+  TEST_ASSERT_CALLED_IN_ORDER(2, myTimer_IdleEnter);
+  TEST_ASSERT_CALLED_IN_ORDER(4, myPower_Sleep);
+  TEST_ASSERT_CALLED_IN_ORDER(6, myTimer_IdleExit);
+  TEST_ASSERT_CALLED_IN_ORDER(7, myPower_IdleExit);
+}
+
+/**
+ * @brief The time spent sleeping should be accounted apart from the time
+ *          spent awake.
+ */
+void test_IfKernelIsIdleThenResidencyIsAccounted(void)
+{
+  osKernel_Reset(TEST_PASSES);
+  osKernelStart();
+
+  TEST_ASSERT_EQUAL(osOK, osKernelGetIdleStats(&stats));
+  TEST_ASSERT_EQUAL(TEST_PASSES, stats.sleeps);
+  TEST_ASSERT_EQUAL(TEST_PASSES, stats.tickless);
+  TEST_ASSERT_EQUAL(TEST_PASSES * TEST_WAKEUP_US, stats.sleepUs);
+  TEST_ASSERT_EQUAL(TEST_PASSES * (TEST_WAKEUP_US + TEST_AWAKE_US), stats.totalUs);
+}
+
+/**
+ * @brief Waking up after the programmed time should be accounted as latency.
+ */
+void test_IfWakeupIsLateThenLatencyIsAccounted(void)
+{
+  static const uint32_t sleepsUs[] = { TEST_WAKEUP_US + 5, TEST_WAKEUP_US + 20, TEST_WAKEUP_US + 10 };
+
+  simSleepsUs = sleepsUs;
+  simSleepsCnt = MY_ARRAY_SIZE(sleepsUs);
+  osKernel_Reset(simSleepsCnt);
+  osKernelStart();
+
+  osKernelGetIdleStats(&stats);
+  TEST_ASSERT_EQUAL(0, stats.earlyWakes);
+  TEST_ASSERT_EQUAL(20, stats.maxLatencyUs);
+  TEST_ASSERT_EQUAL(35, stats.sumLatencyUs);
+}
+
+/**
+ * @brief Waking up before the programmed time should be accounted as an early
+ *          wake, which has no latency.
+ */
+void test_IfWakeupIsEarlyThenEarlyWakeIsAccounted(void)
+{
+  static const uint32_t sleepsUs[] = { TEST_WAKEUP_US / 4, TEST_WAKEUP_US };
+
+  simSleepsUs = sleepsUs;
+  simSleepsCnt = MY_ARRAY_SIZE(sleepsUs);
+  osKernel_Reset(simSleepsCnt);
+  osKernelStart();
+
+  osKernelGetIdleStats(&stats);
+  TEST_ASSERT_EQUAL(1, stats.earlyWakes);
+  TEST_ASSERT_EQUAL(0, stats.maxLatencyUs);
+  TEST_ASSERT_EQUAL((TEST_WAKEUP_US * 5) / 4, stats.sleepUs);
+}
+
+/**
+ * @brief Sleeps in which the tick could not be stopped should still be
+ *          accounted, but not as tickless ones.
+ */
+void test_IfTickIsNotStoppedThenSleepIsNotTickless(void)
+{
+  myTimer_IdleEnter_fake.return_val = 0;
+  osKernel_Reset(TEST_PASSES);
+  osKernelStart();
+
+  osKernelGetIdleStats(&stats);
+  TEST_ASSERT_EQUAL(TEST_PASSES, stats.sleeps);
+  TEST_ASSERT_EQUAL(0, stats.tickless);
+  TEST_ASSERT_EQUAL(0, stats.earlyWakes);
+}
+
+/**
+ * @brief Getting the statistics without a place to write them should fail.
+ */
+void test_IfStatsAreNullThenGetFails(void)
+{
+  TEST_ASSERT_EQUAL(osErrorParameter, osKernelGetIdleStats(NULL));
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static void prepareMocks(void)
+{
+  myTime_Now_fake.custom_fake = simTimeNow;
+  myPower_Sleep_fake.custom_fake = simSleep;
+  myPower_IdleExit_fake.custom_fake = simIdleExit;
+  myTimer_IdleEnter_fake.return_val = TEST_WAKEUP_US;
+}
+
+static uint64_t simTimeNow(void)
+{
+  return simNowUs;
+}
+
+static void simSleep(void)
+{
+  const uint32_t sleep = myPower_Sleep_fake.call_count - 1;
+
+  simNowUs += simSleepsUs[(sleep < simSleepsCnt) ? sleep : (simSleepsCnt - 1)];
+}
+
+static void simIdleExit(void)
+{
+  /* The interrupt that woke the core up runs as soon as it is unmasked.      */
+  simNowUs += TEST_AWAKE_US;
+}
@@ -0,0 +1,163 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file test_cmsis_os_MessageQueue.c
+ * @brief Test file for testing the kernel logic, operation when messages are
+ *          passed through queues.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "unity.h"
+#include "myTestDefs.h"
+
+#include "cmsis_os.h"
+#include "myIrq.h"
+#include "myRing.h"
+#include "myTime.h"
+
+#include "mock_myPower.h"
+#include "mock_myTimer.h"
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define TEST_QUEUE_SIZE                                                      (4)
+#define TEST_EVENTS_SIZE                                                     (4)
+#define TEST_PRIORITY                                                        (5)
+#define TEST_EVENT_RX                                                        (1)
+
+typedef struct
+{
+  uint16_t id;
+  uint32_t value;
+} testMsg_t;
+
+/*******************************************************************************
+ *  PRIVATE PROTOTYPES
+ ******************************************************************************/
+static void rxInterrupt(uint16_t id, uint32_t value);
+static void rxHandler(uint32_t event);
+
+/*******************************************************************************
+ *  PRIVATE VARIABLES
+ ******************************************************************************/
+static osMessageQueue_t queue;
+static testMsg_t queueStorage[TEST_QUEUE_SIZE];
+
+static osTask_t rxTask;
+static uint32_t rxEvents[TEST_EVENTS_SIZE];
+
+static testMsg_t received[TEST_QUEUE_SIZE];
+static uint32_t receivedCnt;
+
+/*******************************************************************************
+ *  SET UP / TEAR DOWN
+ ******************************************************************************/
+void setUp(void)
+{
+  osKernel_Reset(0);
+  osMessageQueueCreate(&queue, queueStorage, sizeof(testMsg_t), TEST_QUEUE_SIZE);
+  receivedCnt = 0;
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *  TESTS
+ ******************************************************************************/
+/**
+ * @brief Creating a queue with invalid parameters should fail.
+ */
+void test_IfParametersAreInvalidThenCreateFails(void)
+{
+  TEST_ASSERT_EQUAL(osErrorParameter, osMessageQueueCreate(NULL, queueStorage, sizeof(testMsg_t), TEST_QUEUE_SIZE));
+  TEST_ASSERT_EQUAL(osErrorParameter, osMessageQueueCreate(&queue, NULL, sizeof(testMsg_t), TEST_QUEUE_SIZE));
+  TEST_ASSERT_EQUAL(osErrorParameter, osMessageQueueCreate(&queue, queueStorage, 0, TEST_QUEUE_SIZE));
+  TEST_ASSERT_EQUAL(osErrorParameter, osMessageQueueCreate(&queue, queueStorage, sizeof(testMsg_t), TEST_QUEUE_SIZE - 1));
+}
+
+/**
+ * @brief Getting from an empty queue should not wait, but fail right away.
+ */
+void test_IfQueueIsEmptyThenGetFails(void)
+{
+  testMsg_t msg;
+
+  TEST_ASSERT_EQUAL(osErrorResource, osMessageQueueGet(&queue, &msg));
+  TEST_ASSERT_EQUAL(osErrorParameter, osMessageQueueGet(NULL, &msg));
+  TEST_ASSERT_EQUAL(0, osMessageQueueGetCount(&queue));
+}
+
+/**
+ * @brief Putting into a full queue should drop the message.
+ */
+void test_IfQueueIsFullThenPutFails(void)
+{
+  testMsg_t msg = { 0 };
+  uint32_t idx;
+
+  for(idx = 0; idx < TEST_QUEUE_SIZE; idx++)
+  {
+    TEST_ASSERT_EQUAL(osOK, osMessageQueuePut(&queue, &msg));
+  }
+  TEST_ASSERT_EQUAL(osErrorResource, osMessageQueuePut(&queue, &msg));
+  TEST_ASSERT_EQUAL(TEST_QUEUE_SIZE, osMessageQueueGetCount(&queue));
+}
+
+/**
+ * @brief Messages put by an interrupt should reach the task that it posts
+ *          an event to, whole and in order.
+ */
+void test_IfInterruptPutsMessagesThenTaskGetsThem(void)
+{
+  uint32_t idx;
+
+  osKernel_Reset(1);
+  osTaskCreate(&rxTask, TEST_PRIORITY, rxHandler, rxEvents, TEST_EVENTS_SIZE);
+  for(idx = 0; idx < TEST_QUEUE_SIZE; idx++) { rxInterrupt(idx, 0x12345678UL * idx); }
+  osKernelStart();
+
+  TEST_ASSERT_EQUAL(TEST_QUEUE_SIZE, receivedCnt);
+  for(idx = 0; idx < TEST_QUEUE_SIZE; idx++)
+  {
+    TEST_ASSERT_EQUAL(idx, received[idx].id);
+    TEST_ASSERT_EQUAL(0x12345678UL * idx, received[idx].value);
+  }
+  TEST_ASSERT_EQUAL(0, osMessageQueueGetCount(&queue));
+}
+
+/*******************************************************************************
+ *  PRIVATE FUNCTIONS / ROUTINES
+ ******************************************************************************/
+static void rxInterrupt(uint16_t id, uint32_t value)
+{
+  testMsg_t msg = { .id = id, .value = value };
+
+  if(osMessageQueuePut(&queue, &msg) == osOK) { osTaskPost(&rxTask, TEST_EVENT_RX); }
+}
+
+/* One event may stand for several messages, so the task drains them all.     */
+static void rxHandler(uint32_t event)
+{
+  (void) event;
+  while(osMessageQueueGet(&queue, &received[receivedCnt]) == osOK) { receivedCnt++; }
+}
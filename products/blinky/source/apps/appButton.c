@@ -20,24 +20,115 @@
  *
  * This module provides the routines that external parties can call in order
  *  to interact with the Button application.
+ *
+ * All the buttons are pins of a single port, which is sampled as a whole on
+ *  every tick of a virtual timer and fed to a bit-sliced debouncer, so the
+ *  work per tick does not grow with the amount of buttons. The ticks are
+ *  stopped whenever the debouncer is idle, and an edge on any button starts
+ *  them again, so the buttons take no processing time while untouched.
+ *
+ * Button events are found on the tick, from the timer interrupt, and handed
+ *  to the task of this application, which reacts to them:
+ *    - press: the LED blinks faster, wrapping around to the slowest rate.
+ *    - double click: the LED blinks at the slowest rate.
+ *    - long press: the LED blinks at the default rate.
+ *  A double click is also a press, so the LED is briefly faster before it
+ *    slows down.
  */
 
 /*******************************************************************************
  *  INCLUDES
  ******************************************************************************/
 #include "appButton.h"
+#include "appLed.h"
+#include "projConfig.h"
+
+#include "myGpio.h"
+#include "myTimer.h"
+#include "myIrq.h"
+#include "myDebounce.h"
+#include "cmsis_os.h"
+
+#include "myMacros.h"
 
 /*******************************************************************************
  *  PRIVATE DEFINITIONS
  ******************************************************************************/
+/* Set below the port of the buttons, and a mask with one bit for each pin    */
+/*  of that port with a button. Buttons are wired to ground, with a pull-up.  */
+#ifndef APP_BUTTON_PORT
+  #define APP_BUTTON_PORT                                                      0
+#endif
+
+#ifndef APP_BUTTON_MASK
+  #define APP_BUTTON_MASK                                             0x00000030
+#endif
+
+/* Set below the sampling period of the buttons, and the times for a long     */
+/*  press and for the second press of a double click, all in ms.              */
+#ifndef APP_BUTTON_TICK_MS
+  #define APP_BUTTON_TICK_MS                                                   5
+#endif
+
+#ifndef APP_BUTTON_LONG_MS
+  #define APP_BUTTON_LONG_MS                                                1000
+#endif
+
+#ifndef APP_BUTTON_DOUBLE_MS
+  #define APP_BUTTON_DOUBLE_MS                                               300
+#endif
+
+/* Set below the priority of the task of the application.                     */
+#ifndef APP_BUTTON_PRIORITY
+  #define APP_BUTTON_PRIORITY                                                  1
+#endif
+
+/* Set below how many events can be pending on the task. Power of two.        */
+#define APP_BUTTON_EVENTS                                                      8
+
+/* Each event posted to the task has its kind in the upper half, and the pin  */
+/*  of the button in the lower half.                                          */
+typedef enum
+{
+  appButtonEvt_Press = 0,
+  appButtonEvt_Release,
+  appButtonEvt_LongPress,
+  appButtonEvt_DoubleClick,
+} appButtonEvt_t;
+
+#define APP_BUTTON_EVENT(EVT, PIN)                       (((EVT) << 16) | (PIN))
+#define APP_BUTTON_EVENT_KIND(EVENT)                             ((EVENT) >> 16)
+
+/* Blinking periods, in ms, from the slowest to the fastest, and the index    */
+/*  of the default one.                                                       */
+#define APP_BUTTON_PERIOD_DEFAULT                                              1
 
 /*******************************************************************************
  *  PRIVATE PROTOTYPES
  ******************************************************************************/
+static void appButton_Tick(void);
+static void appButton_Wake(void);
+static void appButton_Post(uint32_t buttons, appButtonEvt_t evt);
+static void appButton_Handler(uint32_t event);
 
 /*******************************************************************************
  *  PRIVATE VARIABLES
  ******************************************************************************/
+static const uint32_t appButton_Periods[] = { 2000, 1000, 500, 250, 125 };
+
+static myGpioPort_t appButton_Port;
+static myTimer_t appButton_Timer;
+static myDebounce_t appButton_Debounce;
+
+static osTask_t appButton_Task;
+static uint32_t appButton_Events[APP_BUTTON_EVENTS];
+
+/* Whether the ticks are running, and whether they are allowed to stop, which */
+/*  requires an edge interrupt on every button.                               */
+static volatile bool appButton_Ticking = false;
+static bool appButton_CanStop = false;
+
+static uint32_t appButton_Period = APP_BUTTON_PERIOD_DEFAULT;
 
 /*******************************************************************************
  *  PUBLIC FUNCTIONS / ROUTINES
@@ -53,10 +144,119 @@
  */
 myRet_t appButton_Init(void)
 {
-  /* Not implemented yet.                                                     */
-  return myRet_OK;
+  myRet_t result = myRet_Fail;
+  myGpioPortPars_t portPars = { APP_BUTTON_PORT, APP_BUTTON_MASK, myGpioDir_Inpt, myGpioPull_Up };
+  myTimerPars_t timerPars = { .mode = myTimerMode_Periodic, .resource = myTimerRes_Virtual };
+  myDebouncePars_t debouncePars = { APP_BUTTON_MASK, APP_BUTTON_LONG_MS / APP_BUTTON_TICK_MS,
+                                    APP_BUTTON_DOUBLE_MS / APP_BUTTON_TICK_MS };
+
+  if( (myGpio_InitPort(&appButton_Port, &portPars) == myRet_OK) &&
+      (myTimer_Init(&appButton_Timer, &timerPars) == myRet_OK) &&
+      (myDebounce_Init(&appButton_Debounce, &debouncePars) == myRet_OK) &&
+      (osTaskCreate(&appButton_Task, APP_BUTTON_PRIORITY, appButton_Handler, appButton_Events, APP_BUTTON_EVENTS) == osOK) )
+  {
+    uint32_t pins = APP_BUTTON_MASK;
+
+    /* Each button also interrupts on its edges, so that the ticks can stop.  */
+    /*  If any of them cannot, the buttons are just sampled all the time.     */
+    appButton_CanStop = true;
+    while(pins != 0)
+    {
+      myGpioPin_t pin;
+      const uint32_t pinNumber = MY_HIGHEST_BIT(pins);
+      myGpioPars_t pinPars = { APP_BUTTON_PORT, pinNumber, myGpioDir_Inpt, myGpioPull_Up, myGpioIrq_Both, appButton_Wake };
+
+      pins &= ~(1UL << pinNumber);
+      if(myGpio_Init(&pin, &pinPars) != myRet_OK) { appButton_CanStop = false; }
+    }
+
+    appButton_Wake();
+    result = myRet_OK;
+  }
+
+  return result;
 }
 
 /*******************************************************************************
  *  PRIVATE FUNCTIONS / ROUTINES
  ******************************************************************************/
+static void appButton_Tick(void)
+{
+  myDebounceEvts_t evts;
+  uint32_t irqState;
+
+  if(myDebounce_Update(&appButton_Debounce, myGpio_GetPort(appButton_Port), &evts))
+  {
+    appButton_Post(evts.press & ~evts.doubleClick, appButtonEvt_Press);
+    appButton_Post(evts.release, appButtonEvt_Release);
+    appButton_Post(evts.longPress, appButtonEvt_LongPress);
+    appButton_Post(evts.doubleClick, appButtonEvt_DoubleClick);
+  }
+
+  /* Stopping is masked so that an edge cannot come between the check and     */
+  /*  the stop. An edge that came since the sample above found the ticks      */
+  /*  still running and did nothing, so the pins are read again, and the      */
+  /*  ticks only stop if they still match the debounced state.                */
+  if(appButton_CanStop && myDebounce_IsIdle(&appButton_Debounce))
+  {
+    irqState = myIrq_Lock();
+    if((myGpio_GetPort(appButton_Port) ^ APP_BUTTON_MASK) == myDebounce_GetState(&appButton_Debounce))
+    {
+      myTimer_Stop(appButton_Timer);
+      appButton_Ticking = false;
+    }
+    myIrq_Unlock(irqState);
+  }
+}
+
+static void appButton_Wake(void)
+{
+  const uint32_t irqState = myIrq_Lock();
+
+  if(!appButton_Ticking)
+  {
+    appButton_Ticking = true;
+    myTimer_Start(appButton_Timer, APP_BUTTON_TICK_MS, appButton_Tick);
+  }
+
+  myIrq_Unlock(irqState);
+}
+
+static void appButton_Post(uint32_t buttons, appButtonEvt_t evt)
+{
+  while(buttons != 0)
+  {
+    const uint32_t pin = MY_HIGHEST_BIT(buttons);
+
+    buttons &= ~(1UL << pin);
+    osTaskPost(&appButton_Task, APP_BUTTON_EVENT(evt, pin));
+  }
+}
+
+static void appButton_Handler(uint32_t event)
+{
+  switch(APP_BUTTON_EVENT_KIND(event))
+  {
+    case appButtonEvt_Press:
+    {
+      appButton_Period = (appButton_Period + 1) % MY_ARRAY_SIZE(appButton_Periods);
+      appLed_SetBlinkingPeriod(appButton_Periods[appButton_Period]);
+    } break;
+
+    case appButtonEvt_DoubleClick:
+    {
+      appButton_Period = 0;
+      appLed_SetBlinkingPeriod(appButton_Periods[appButton_Period]);
+    } break;
+
+    case appButtonEvt_LongPress:
+    {
+      appButton_Period = APP_BUTTON_PERIOD_DEFAULT;
+      appLed_SetBlinkingPeriod(appButton_Periods[appButton_Period]);
+    } break;
+
+    default:
+    {
+    } break;
+  }
+}
@@ -20,32 +20,75 @@
  *
  * This module provides the routines that external parties can call in order
  *  to interact with the LED application.
+ *
+ * The LED is driven by a PWM timer, so its brightness is kept by the timer
+ *  hardware alone, without any interrupt. Instead of blinking, the LED fades
+ *  in and out: on every tick of a virtual timer the brightness takes one more
+ *  step of a triangle wave that lasts the blinking period. Each brightness
+ *  level is gamma-corrected, so that the fade looks even to the eye.
  */
 
 /*******************************************************************************
  *  INCLUDES
  ******************************************************************************/
 #include "appLed.h"
+#include "projConfig.h"
+
+#include "myTimer.h"
+#include "myIrq.h"
+#include "myGamma.h"
 
 /*******************************************************************************
  *  PRIVATE DEFINITIONS
  ******************************************************************************/
+/* Set below the timer channel of the LED, a myDriverTimerCh_t value, and     */
+/*  whether the LED lights up with it low, as the ones of the boards do.      */
+#ifndef APP_LED_CHANNEL
+  #define APP_LED_CHANNEL                                                      0
+#endif
+
+#ifndef APP_LED_ACTIVE_LOW
+  #define APP_LED_ACTIVE_LOW                                                   1
+#endif
+
+/* Set below the period of the PWM output and of the brightness steps, and    */
+/*  the blinking period that the LED starts with, all in ms.                  */
+#ifndef APP_LED_PWM_MS
+  #define APP_LED_PWM_MS                                                       1
+#endif
+
+#ifndef APP_LED_STEP_MS
+  #define APP_LED_STEP_MS                                                     20
+#endif
+
+#ifndef APP_LED_PERIOD_MS
+  #define APP_LED_PERIOD_MS                                                 1000
+#endif
 
 /*******************************************************************************
  *  PRIVATE PROTOTYPES
  ******************************************************************************/
+static void appLed_Step(void);
+static uint8_t appLed_GetLevel(uint32_t phase, uint32_t period);
 
 /*******************************************************************************
  *  PRIVATE VARIABLES
  ******************************************************************************/
+static myTimer_t appLed_Pwm;
+static myTimer_t appLed_Timer;
+
+/* Blinking period and the time into it, in ms. Both are used by the steps,   */
+/*  from the timer interrupt, so they are only changed with it masked.        */
+static uint32_t appLed_Period = APP_LED_PERIOD_MS;
+static uint32_t appLed_Phase = 0;
 
 /*******************************************************************************
  *  PUBLIC FUNCTIONS / ROUTINES
  ******************************************************************************/
 /**
- * @brief Initialization routine for the Button Application
+ * @brief Initialization routine for the LED Application
  *
- * This routine should be called by your initializer logic so that the Button
+ * This routine should be called by your initializer logic so that the LED
  *  application can start.
  * It should be called only once. After it is called, the module will handle
  *  its initialization by itself.
@@ -53,23 +96,74 @@
  */
 myRet_t appLed_Init(void)
 {
-  /* Not implemented yet.                                                     */
-  return myRet_OK;
-}
+  myRet_t result = myRet_Fail;
+  myTimerPars_t pwmPars = { .mode = myTimerMode_Pwm, .resource = myTimerRes_Dedicated, .channel = APP_LED_CHANNEL };
+  myTimerPars_t timerPars = { .mode = myTimerMode_Periodic, .resource = myTimerRes_Virtual };
+
+  if( (myTimer_Init(&appLed_Pwm, &pwmPars) == myRet_OK) &&
+      (myTimer_Init(&appLed_Timer, &timerPars) == myRet_OK) )
+  {
+    /* The LED starts off, and the first step lights it up from there.        */
+    myTimer_SetDuty(appLed_Pwm, APP_LED_ACTIVE_LOW ? MY_TIMER_DUTY_MAX : 0);
 
+    if( (myTimer_Start(appLed_Pwm, APP_LED_PWM_MS, NULL) == myRet_OK) &&
+        (myTimer_Start(appLed_Timer, APP_LED_STEP_MS, appLed_Step) == myRet_OK) )
+    {
+      result = myRet_OK;
+    }
+  }
+
+  return result;
+}
 
 /**
  * @brief Request application to change the LED blinking period.
  *
- * @param period New period value, in [ms]
+ * @param period New period value, in [ms]. It must take at least two steps,
+ *          one to light the LED up and one to dim it down.
  * @return Success / Failure
  */
 myRet_t appLed_SetBlinkingPeriod(uint32_t period)
 {
-  /* Not implemented yet.                                                     */
-  return myRet_OK;
+  myRet_t result = myRet_Fail;
+
+  if(period >= (2 * APP_LED_STEP_MS))
+  {
+    const uint32_t irqState = myIrq_Lock();
+
+    /* The LED carries on from where it is into the new period.               */
+    appLed_Phase = appLed_Phase % period;
+    appLed_Period = period;
+
+    myIrq_Unlock(irqState);
+    result = myRet_OK;
+  }
+
+  return result;
 }
 
 /*******************************************************************************
  *  PRIVATE FUNCTIONS / ROUTINES
  ******************************************************************************/
+static void appLed_Step(void)
+{
+  uint16_t duty;
+
+  appLed_Phase += APP_LED_STEP_MS;
+  if(appLed_Phase >= appLed_Period) { appLed_Phase -= appLed_Period; }
+
+  /* The PWM timer buffers the new duty cycle until its period ends, so the   */
+  /*  LED never shows a period with a mix of two brightness levels.           */
+  duty = myGamma_Get(appLed_GetLevel(appLed_Phase, appLed_Period));
+  myTimer_SetDuty(appLed_Pwm, APP_LED_ACTIVE_LOW ? (MY_TIMER_DUTY_MAX - duty) : duty);
+}
+
+static uint8_t appLed_GetLevel(uint32_t phase, uint32_t period)
+{
+  /* The brightness rises during the first half of the period and falls       */
+  /*  during the second one.                                                  */
+  const uint32_t half = period / 2;
+  const uint32_t rise = (phase < half) ? phase : (period - phase);
+
+  return (rise >= half) ? MY_GAMMA_LEVEL_MAX : (uint8_t)((rise * MY_GAMMA_LEVEL_MAX) / half);
+}
@@ -23,6 +23,8 @@
  *  INCLUDES
  ******************************************************************************/
 #include "myBoard.h"
+#include "myTime.h"
+#include "myCrash.h"
 #include "cmsis_os.h"
 
 #include "appButton.h"
@@ -45,8 +47,13 @@
  ******************************************************************************/
 int main(void)
 {
+  /* Take the record of the crash of the previous run, if any, before any     */
+  /*  chance to crash again. The applications get it with myCrash_GetLast.    */
+  myCrash_Init();
+
   /* Start by initializing all that is required by the board.                 */
   myBoard_Init();
+  myTime_Init();
 
   /* Now start all the required applications.                                 */
   appLed_Init();
@@ -0,0 +1,87 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file myTestCode.c
+ * @brief Source file containing routines for inspecting the code generated
+ *          for the unit tests.
+ */
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "myTestCode.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+/*******************************************************************************
+ *  PRIVATE DEFINITIONS
+ ******************************************************************************/
+#define MY_TEST_CODE_PATH_SIZE                                             (512)
+#define MY_TEST_CODE_LINE_SIZE                                             (256)
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES
+ ******************************************************************************/
+/**
+ * @brief Disassembles a routine of the running executable and counts its
+ *          instructions.
+ * @param symbol Name of the routine.
+ * @param code Written with the summary of the code of the routine.
+ * @return Success / Failure
+ */
+myRet_t myTestCode_Inspect(const char * symbol, myTestCode_t * code)
+{
+  myRet_t result = myRet_Fail;
+  char path[MY_TEST_CODE_PATH_SIZE];
+  char line[MY_TEST_CODE_LINE_SIZE + MY_TEST_CODE_PATH_SIZE];
+  ssize_t pathLen;
+  FILE * pipe;
+
+  *code = (myTestCode_t) { 0 };
+
+  /* The command runs on a shell, so the executable is named by its path.     */
+  pathLen = readlink("/proc/self/exe", path, sizeof(path) - 1);
+  if(pathLen > 0)
+  {
+    path[pathLen] = '\0';
+    snprintf(line, sizeof(line), "objdump -d --no-show-raw-insn --disassemble=%s '%s' 2>/dev/null", symbol, path);
+
+    pipe = popen(line, "r");
+    if(pipe != NULL)
+    {
+      /* Instruction lines start with their address, followed by a colon and  */
+      /*  a tab. Anything else is a header or a label.                        */
+      while(fgets(line, sizeof(line), pipe) != NULL)
+      {
+        unsigned long address;
+        char separator;
+
+        if((sscanf(line, " %lx%c", &address, &separator) == 2) && (separator == ':') && (strchr(line, '\t') != NULL))
+        {
+          code->instructions++;
+          if(strstr(line, "\tcall") != NULL) { code->calls++; }
+        }
+      }
+
+      if((pclose(pipe) == 0) && (code->instructions > 0)) { result = myRet_OK; }
+    }
+  }
+
+  return result;
+}
@@ -0,0 +1,60 @@
+/**
+ * Copyright (c) 2020 by Andre F. N. Dainese
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file myTestCode.h
+ * @brief Header file containing routines for inspecting the code generated
+ *          for the unit tests.
+ *
+ * The routines below disassemble the running test executable, so that tests
+ *  can check how many instructions a routine was compiled into. Host code is
+ *  not target code, so the counts only compare paths with each other.
+ */
+
+#ifndef MY_TEST_CODE_H
+#define MY_TEST_CODE_H
+
+/*******************************************************************************
+ *  INCLUDES
+ ******************************************************************************/
+#include "myDefs.h"
+
+/*******************************************************************************
+ *  PUBLIC DEFINITIONS
+ ******************************************************************************/
+/**
+ * @brief Summary of the code of a routine.
+ */
+typedef struct
+{
+  uint32_t instructions;  /* Instructions, including the return.              */
+  uint32_t calls;         /* Calls to other routines.                         */
+} myTestCode_t;
+
+/*******************************************************************************
+ *  PUBLIC FUNCTIONS / ROUTINES
+ ******************************************************************************/
+/**
+ * @brief Disassembles a routine of the running executable and counts its
+ *          instructions. It requires objdump on the host.
+ * @param symbol Name of the routine. It must not be inlined.
+ * @param code Written with the summary of the code of the routine.
+ * @return Success / Failure. It fails if the routine could not be found or
+ *          disassembled.
+ */
+myRet_t myTestCode_Inspect(const char * symbol, myTestCode_t * code);
+
+#endif